@@ -0,0 +1,265 @@
+
+/**
+ * Microbenchmarks for the hot functions of the energy, accessibility, seed
+ * and hybridization computations.
+ *
+ * For each window size, a target and a query sequence of this length are
+ * generated via a fixed pseudo random number generator, such that the
+ * benchmarks are identical on all systems. The accessibilities and energy
+ * handlers are set up once per window size (not measured). Each benchmark is
+ * run for a number of warm-up rounds (not measured) followed by the measured
+ * repetitions. The median time of the repetitions and the number of
+ * (function) calls or cells per second are reported in CSV format.
+ *
+ * Usage: microBench [--warmup=N] [--repeat=N] [--windows=W1,W2,..] [--bench=NAME]
+ */
+
+#include "IntaRNA/general.h"
+
+#include "IntaRNA/AccessibilityVrna.h"
+#include "IntaRNA/InteractionEnergyVrna.h"
+#include "IntaRNA/OutputHandlerInteractionList.h"
+#include "IntaRNA/PredictorMfe2dHeuristic.h"
+#include "IntaRNA/ReverseAccessibility.h"
+#include "IntaRNA/RnaSequence.h"
+#include "IntaRNA/SeedConstraint.h"
+#include "IntaRNA/SeedHandlerMfe.h"
+#include "IntaRNA/VrnaHandler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+
+// initialize logging for binary
+INITIALIZE_EASYLOGGINGPP
+
+using namespace IntaRNA;
+
+/////////////////////////////////////////////////////////////////////
+/**
+ * Generates a random RNA sequence via a linear congruential generator.
+ *
+ * @param length the length of the sequence
+ * @param state the generator state to be updated
+ * @return the random sequence
+ */
+std::string
+randomSequence( const size_t length, unsigned long & state )
+{
+	const char nt[] = "ACGU";
+	std::string seq( length, 'N' );
+	for (size_t i=0; i<length; i++) {
+		state = (1103515245UL * state + 12345UL) % 2147483648UL;
+		seq[i] = nt[ (state >> 16) % 4 ];
+	}
+	return seq;
+}
+
+/////////////////////////////////////////////////////////////////////
+/**
+ * Setup of all data structures needed for the benchmarks of a window size.
+ */
+class BenchSetup {
+public:
+	//! the target sequence
+	RnaSequence seq1;
+	//! the query sequence
+	RnaSequence seq2;
+	//! target accessibility
+	AccessibilityVrna acc1;
+	//! query accessibility
+	AccessibilityVrna acc2;
+	//! reversed query accessibility
+	ReverseAccessibility acc2rev;
+	//! energy handler
+	InteractionEnergyVrna energy;
+
+	/**
+	 * Construction
+	 * @param s1 the target sequence
+	 * @param s2 the query sequence
+	 * @param vrnaHandler the VRNA parameter handler
+	 */
+	BenchSetup( const std::string & s1, const std::string & s2, VrnaHandler & vrnaHandler )
+	 :	seq1("target",s1)
+		, seq2("query",s2)
+		, acc1(seq1, std::min<size_t>(150,seq1.size()), NULL, vrnaHandler, 150)
+		, acc2(seq2, std::min<size_t>(150,seq2.size()), NULL, vrnaHandler, 150)
+		, acc2rev(acc2)
+		, energy(acc1, acc2rev, vrnaHandler, 16, 16)
+	{}
+};
+
+/////////////////////////////////////////////////////////////////////
+/**
+ * Runs one round of a benchmark.
+ *
+ * @param name the name of the benchmark
+ * @param setup the data of the window size
+ * @param sum accumulated results to avoid the removal of the calls
+ * @return the number of calls or cells computed
+ */
+size_t
+runBench( const std::string & name, BenchSetup & setup, double & sum )
+{
+	const InteractionEnergy & energy = setup.energy;
+	const size_t n1 = energy.size1(), n2 = energy.size2();
+	size_t calls = 0;
+
+	if (name == "getE_interLeft") {
+		// all interior loops of the hybridization recursion
+		for (size_t i1=0; i1<n1; i1++) {
+		for (size_t i2=0; i2<n2; i2++) {
+			if (!energy.areComplementary(i1,i2)) continue;
+			for (size_t j1=i1+1; j1<n1 && j1-i1-1 <= energy.getMaxInternalLoopSize1(); j1++) {
+			for (size_t j2=i2+1; j2<n2 && j2-i2-1 <= energy.getMaxInternalLoopSize2(); j2++) {
+				const E_type e = energy.getE_interLeft(i1,j1,i2,j2);
+				if (E_isNotINF(e)) { sum += e; }
+				calls++;
+			}}
+		}}
+	} else
+	if (name == "getE_dangling") {
+		// left and right dangling ends of all base pairs
+		for (size_t i1=0; i1<n1; i1++) {
+		for (size_t i2=0; i2<n2; i2++) {
+			if (!energy.areComplementary(i1,i2)) continue;
+			sum += energy.getE_danglingLeft(i1,i2) + energy.getE_danglingRight(i1,i2);
+			calls += 2;
+		}}
+	} else
+	if (name == "getED_reverse") {
+		// ED values of all query subsequences via the reversed accessibility
+		const size_t maxLength = setup.acc2rev.getMaxLength();
+		for (size_t i2=0; i2<n2; i2++) {
+		for (size_t j2=i2; j2<n2 && j2-i2 < maxLength; j2++) {
+			sum += energy.getED2(i2,j2);
+			calls++;
+		}}
+	} else
+	if (name == "fillSeed") {
+		SeedConstraint seedConstraint( 7, 0, 0, 0, 0, Accessibility::ED_UPPER_BOUND, IndexRangeList(), IndexRangeList(), "" );
+		SeedHandlerMfe seedHandler( energy, seedConstraint );
+		sum += seedHandler.fillSeed( 0, n1-1, 0, n2-1 );
+		calls = n1*n2;
+	} else
+	if (name == "predictMfe2dHeuristic") {
+		// fillHybridE() and traceback of the heuristic predictor
+		OutputHandlerInteractionList out(1);
+		PredictorMfe2dHeuristic predictor( energy, out, NULL );
+		predictor.predict( IndexRange(0,n1-1), IndexRange(0,n2-1), OutputConstraint(1,OutputConstraint::OVERLAP_BOTH,E_INF) );
+		if (!out.empty()) { sum += (*out.begin())->energy; }
+		calls = n1*n2;
+	} else {
+		throw std::runtime_error("unknown benchmark '"+name+"'");
+	}
+	return calls;
+}
+
+/////////////////////////////////////////////////////////////////////
+/**
+ * program main entry
+ *
+ * @param argc number of program arguments
+ * @param argv array of program arguments of length argc
+ */
+int main(int argc, char **argv){
+
+	try {
+
+		// no logging besides errors
+		el::Loggers::reconfigureAllLoggers(el::ConfigurationType::Format, std::string("# %level : %msg"));
+		el::Loggers::reconfigureAllLoggers(el::ConfigurationType::ToFile, std::string("false"));
+		el::Loggers::addFlag(el::LoggingFlag::DisableApplicationAbortOnFatalLog);
+
+		// parse arguments
+		size_t warmup = 1, repeat = 5;
+		std::vector< size_t > windows;
+		std::vector< std::string > benchmarks;
+		for (int a=1; a<argc; a++) {
+			const std::string arg(argv[a]);
+			if (boost::starts_with(arg,"--warmup=")) {
+				warmup = boost::lexical_cast<size_t>(arg.substr(9));
+			} else if (boost::starts_with(arg,"--repeat=")) {
+				repeat = std::max<size_t>(1,boost::lexical_cast<size_t>(arg.substr(9)));
+			} else if (boost::starts_with(arg,"--windows=")) {
+				std::vector< std::string > w;
+				boost::split( w, arg.substr(10), boost::is_any_of(",") );
+				for (size_t i=0; i<w.size(); i++) {
+					windows.push_back( boost::lexical_cast<size_t>(w.at(i)) );
+				}
+			} else if (boost::starts_with(arg,"--bench=")) {
+				benchmarks.push_back( arg.substr(8) );
+			} else {
+				std::cerr <<"Usage: microBench [--warmup=N] [--repeat=N] [--windows=W1,W2,..] [--bench=NAME]\n"
+						<<"  benchmarks : getE_interLeft, getE_dangling, getED_reverse, fillSeed, predictMfe2dHeuristic\n";
+				return arg == "--help" || arg == "-h" ? 0 : -1;
+			}
+		}
+		if (windows.empty()) {
+			windows.push_back(50);
+			windows.push_back(100);
+			windows.push_back(200);
+			windows.push_back(400);
+		}
+		if (benchmarks.empty()) {
+			benchmarks.push_back("getE_interLeft");
+			benchmarks.push_back("getE_dangling");
+			benchmarks.push_back("getED_reverse");
+			benchmarks.push_back("fillSeed");
+			benchmarks.push_back("predictMfe2dHeuristic");
+		}
+
+		VrnaHandler vrnaHandler;
+		double sum = 0;
+
+		std::cout <<"benchmark;window;warmup;repeat;medianSeconds;calls;callsPerSecond\n";
+		for (size_t w=0; w<windows.size(); w++) {
+			// fixed sequences for each window size
+			unsigned long state = windows.at(w);
+			const std::string s1 = randomSequence( windows.at(w), state );
+			const std::string s2 = randomSequence( windows.at(w), state );
+			BenchSetup setup( s1, s2, vrnaHandler );
+
+			for (size_t b=0; b<benchmarks.size(); b++) {
+				for (size_t r=0; r<warmup; r++) {
+					runBench( benchmarks.at(b), setup, sum );
+				}
+				std::vector< double > times;
+				size_t calls = 0;
+				for (size_t r=0; r<repeat; r++) {
+					const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+					calls = runBench( benchmarks.at(b), setup, sum );
+					times.push_back( std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count() );
+				}
+				std::sort( times.begin(), times.end() );
+				const double median = times.at( (times.size()-1)/2 );
+				std::cout <<benchmarks.at(b)
+						<<';' <<windows.at(w)
+						<<';' <<warmup
+						<<';' <<repeat
+						<<';' <<median
+						<<';' <<calls
+						<<';' <<(median > 0 ? (double)calls/median : 0)
+						<<'\n';
+			}
+		}
+		// ensure the computations are not optimized away
+		if (sum == 0.123456789) {
+			std::cerr <<sum <<std::endl;
+		}
+
+	} catch (std::exception & e) {
+		LOG(ERROR) <<"Exception raised : " <<e.what() <<"\n\n"
+			<<"  ==> Please report (including input) to the IntaRNA development team! Thanks!\n";
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,221 @@
+#!/usr/bin/env perl
+
+############################################################################
+#
+# IntaRNA-benchmark
+#
+# Runs a fixed set of benchmark workloads with an IntaRNA binary and reports
+# for each workload and prediction mode the median wall time, the number of
+# computed matrix cells, the cells per second and the peak memory in CSV or
+# JSON format for regression tracking.
+#
+# The sequences of the workloads are generated by a fixed pseudo random
+# number generator, such that the workloads are identical on all systems.
+# The cells and peak memory are taken from the telemetry output of IntaRNA
+# (--out=telemetry:FILE).
+#
+############################################################################
+
+use strict;
+use Getopt::Std;
+use File::Temp qw(tempdir);
+use Time::HiRes qw(time);
+
+my %args;
+
+# setup default values for input arguments
+my $defB = "IntaRNA";
+my $defR = 3;
+my $defT = 1;
+my $defF = "csv";
+my $defW = ".";
+
+# check if arguments ok
+if (!getopts("hb:r:t:f:w:", \%args) or (defined $args{h} && $args{h}==1) or $#ARGV >= 0) {
+	print "Usage: IntaRNA-benchmark.pl [-b IntaRNA] [-r n] [-t n] [-f csv|json] [-w regex]\n"
+	."Available arguments:\n"
+	."  -b\t(opt) IntaRNA binary to benchmark (def=$defB)\n"
+	."  -r\t(opt) number of repetitions per workload (def=$defR)\n"
+	."  -t\t(opt) number of threads to be used by IntaRNA (def=$defT)\n"
+	."  -f\t(opt) output format, either 'csv' or 'json' (def=$defF)\n"
+	."  -w\t(opt) regular expression to select workloads by name (def=$defW, i.e. all)\n"
+	."  -h\t(opt) parameter list\n"
+	;
+	if (defined $args{h} && $args{h}==1) {
+		exit 0;
+	}
+	exit -1; # error in input arguments
+}
+
+# fill optional arguments if missing
+if (!defined $args{b}) { $args{b} = $defB; };
+if (!defined $args{r}) { $args{r} = $defR; };
+if (!defined $args{t}) { $args{t} = $defT; };
+if (!defined $args{f}) { $args{f} = $defF; };
+if (!defined $args{w}) { $args{w} = $defW; };
+if ($args{r} !~ /^[1-9]\d*$/) { die "ERROR: -r has to be a positive integer"; };
+if ($args{t} !~ /^\d+$/) { die "ERROR: -t has to be a non-negative integer"; };
+if ($args{f} ne "csv" and $args{f} ne "json") { die "ERROR: -f has to be either 'csv' or 'json'"; };
+
+###########################################################################
+# deterministic sequence generation
+###########################################################################
+
+# state of the linear congruential generator
+my $rngState = 0;
+
+# (re)sets the generator state
+sub setSeed {
+	$rngState = shift;
+}
+
+# generates a random RNA sequence of the given length
+sub randomSequence {
+	my $length = shift;
+	my @nt = ("A","C","G","U");
+	my $seq = "";
+	for (my $i=0; $i<$length; $i++) {
+		$rngState = (1103515245 * $rngState + 12345) % 2147483648;
+		$seq .= $nt[ ($rngState >> 16) % 4 ];
+	}
+	return $seq;
+}
+
+# provides the reverse complement of an RNA sequence
+sub reverseComplement {
+	my $seq = reverse shift;
+	$seq =~ tr/ACGU/UGCA/;
+	return $seq;
+}
+
+# generates target sequences of the given length that contain a site
+# complementary to the given subsequence of the query in their middle
+sub targetsWithSite {
+	my ($number, $length, $query, $siteFrom, $siteLength) = @_;
+	my $site = reverseComplement( substr( $query, $siteFrom, $siteLength ) );
+	my @targets;
+	for (my $i=0; $i<$number; $i++) {
+		my $flank = int(($length - $siteLength)/2);
+		push @targets, randomSequence($flank) . $site . randomSequence($length - $siteLength - $flank);
+	}
+	return @targets;
+}
+
+###########################################################################
+# workloads
+###########################################################################
+
+setSeed(1);
+# sRNA with 5'UTRs of mRNAs (sites in the seed region of the sRNA)
+my $sRNA = randomSequence(90);
+my @utrs = targetsWithSite( 20, 200, $sRNA, 10, 12 );
+# sRNA with a subset of a transcriptome
+my @transcripts = targetsWithSite( 200, 1500, $sRNA, 10, 12 );
+# long lncRNA pairs
+my @lncQueries = ( randomSequence(2000), randomSequence(2000) );
+my @lncTargets = ( targetsWithSite( 1, 3000, $lncQueries[0], 500, 20 ), targetsWithSite( 1, 3000, $lncQueries[1], 1200, 20 ) );
+
+# prediction mode arguments
+my %modeArgs = (
+	"H" => "--mode=H",
+	"M" => "--mode=M",
+	"E" => "--mode=E",
+	"P" => "--mode=E --pred=P",
+	"A" => "--mode=A",
+);
+
+# workload name, queries, targets, modes and additional arguments
+my @workloads = (
+	{ name => "sRNA_5utr", queries => [$sRNA], targets => \@utrs, modes => ["H","M","E","P"]
+		, args => "--tIntLenMax=60 --qIntLenMax=60" },
+	{ name => "sRNA_5utr_noSeed", queries => [$sRNA], targets => \@utrs, modes => ["H","M","E","P"]
+		, args => "--tIntLenMax=60 --qIntLenMax=60 --noSeed" },
+	{ name => "sRNA_transcriptome", queries => [$sRNA], targets => \@transcripts, modes => ["H","M","A"]
+		, args => "" },
+	{ name => "lncRNA_pairs", queries => \@lncQueries, targets => \@lncTargets, modes => ["H"]
+		, args => "--tIntLenMax=150 --qIntLenMax=150" },
+	{ name => "lncRNA_pairs_windowed", queries => \@lncQueries, targets => \@lncTargets, modes => ["H"]
+		, args => "--tIntLenMax=150 --qIntLenMax=150 --windowWidth=500 --windowOverlap=150" },
+);
+
+###########################################################################
+# run workloads
+###########################################################################
+
+my $tmpDir = tempdir( "IntaRNA-benchmark-XXXXXX", TMPDIR => 1, CLEANUP => 1 );
+
+# writes the given sequences to a FASTA file
+sub writeFasta {
+	my ($fileName, $prefix, @seqs) = @_;
+	open(my $out, ">", $fileName) or die "ERROR: could not write '$fileName'";
+	for (my $i=0; $i<=$#seqs; $i++) {
+		print $out ">$prefix".($i+1)."\n".$seqs[$i]."\n";
+	}
+	close($out);
+}
+
+# provides the median of a list of values
+sub median {
+	my @sorted = sort { $a <=> $b } @_;
+	return $sorted[ int($#sorted/2) ];
+}
+
+# benchmark results
+my @results;
+
+for my $workload (@workloads) {
+	if ($workload->{name} !~ /$args{w}/) { next; }
+	my $queryFile = "$tmpDir/$workload->{name}.query.fa";
+	my $targetFile = "$tmpDir/$workload->{name}.target.fa";
+	writeFasta( $queryFile, "q", @{$workload->{queries}} );
+	writeFasta( $targetFile, "t", @{$workload->{targets}} );
+
+	for my $mode (@{$workload->{modes}}) {
+		my @wallTimes;
+		my $cells = 0;
+		my $peakMemory = 0;
+		for (my $r=0; $r<$args{r}; $r++) {
+			my $telemetryFile = "$tmpDir/telemetry.json";
+			my $cmd = "$args{b} -q $queryFile -t $targetFile $modeArgs{$mode} $workload->{args}"
+					." --threads=$args{t} --out=$tmpDir/out.txt --out=telemetry:$telemetryFile";
+			my $start = time();
+			system($cmd) == 0 or die "ERROR: call failed : $cmd";
+			push @wallTimes, time() - $start;
+			# parse telemetry summary
+			$cells = 0;
+			open(my $telemetry, "<", $telemetryFile) or die "ERROR: could not read telemetry output of : $cmd";
+			while (my $line = <$telemetry>) {
+				if ($line =~ /"peakMemoryKb":\s*(\d+)/) {
+					if ($1 > $peakMemory) { $peakMemory = $1; }
+				}
+				if ($line =~ /"calls":.*"cells":\s*(\d+)/) {
+					$cells += $1;
+				}
+			}
+			close($telemetry);
+		}
+		my $wallTime = median( @wallTimes );
+		push @results, { workload => $workload->{name}, mode => $mode, wallTime => sprintf("%.3f",$wallTime)
+						, cells => $cells, cellsPerSecond => sprintf("%.0f",($wallTime > 0 ? $cells / $wallTime : 0))
+						, peakMemoryKb => $peakMemory };
+	}
+}
+
+###########################################################################
+# report results
+###########################################################################
+
+my @cols = ("workload","mode","wallTime","cells","cellsPerSecond","peakMemoryKb");
+if ($args{f} eq "csv") {
+	print join(";",@cols)."\n";
+	for my $result (@results) {
+		print join(";", map { $result->{$_} } @cols)."\n";
+	}
+} else {
+	print "[\n";
+	for (my $i=0; $i<=$#results; $i++) {
+		print "  { ".join(", ", map { "\"$_\": ".($_ eq "workload" || $_ eq "mode" ? "\"$results[$i]->{$_}\"" : $results[$i]->{$_}) } @cols)
+			." }".($i < $#results ? "," : "")."\n";
+	}
+	print "]\n";
+}
@@ -0,0 +1,104 @@
+#!/usr/bin/env perl
+
+############################################################################
+#
+# IntaRNA-shardMerge
+#
+# Merges the CSV output (--outMode=C) of IntaRNA runs on different shards of
+# the same target input (--tShardCount, --tShardIndex) into one CSV table.
+# For each query (column 'id2'), the interactions of all shards are sorted by
+# energy (column 'E') to provide a global list of the best interactions,
+# which can be restricted to the k best interactions per query.
+# Since each target is processed by exactly one shard, the non-overlapping
+# constraints (--outOverlap) applied within each run are preserved.
+#
+############################################################################
+
+use strict;
+use Getopt::Std;
+
+my %args;
+
+# setup default values for input arguments
+my $defN = 0;
+
+# check if arguments ok
+if (!getopts("hn:", \%args) or (defined $args{h} && $args{h}==1) or $#ARGV < 0) {
+	print "Usage: IntaRNA-shardMerge.pl [-n k] SHARD1.csv SHARD2.csv ...\n"
+	."Available arguments:\n"
+	."  -n\t(opt) max. number of interactions per query over all shards (def=$defN, i.e. all)\n"
+	."  -h\t(opt) parameter list\n"
+	;
+	if (defined $args{h} && $args{h}==1) {
+		exit 0;
+	}
+	exit -1; # error in input arguments
+}
+
+# fill optional arguments if missing
+if (!defined $args{n}) { $args{n} = $defN; };
+if ($args{n} !~ /^\d+$/) { die "ERROR: -n has to be a non-negative integer"; };
+
+###########################################################################
+# read all shard outputs
+###########################################################################
+
+my $header = undef;
+my $colE = undef;
+my $colQuery = undef;
+# query ids in order of first appearance
+my @queries;
+# query id -> list of [energy, input position, CSV line]
+my %query2rows;
+my $rowNumber = 0;
+
+for my $shardFile (@ARGV) {
+	open(my $shard, "<", $shardFile) or die "ERROR: could not open shard output '$shardFile'";
+	my $shardHeader = <$shard>;
+	if (!defined $shardHeader) { close($shard); next; }
+	chomp $shardHeader;
+	# check header compatibility
+	if (!defined $header) {
+		$header = $shardHeader;
+		# mapping of col names to col number
+		my @dataHdr = split /;/, $header;
+		for ( my $i=0; $i <= $#dataHdr; $i++ ) {
+			my $tmpC = $dataHdr[$i];
+			$tmpC =~ s/^\s+|\s+$//g; # trim 
+			if ($tmpC eq "E") { $colE = $i; }
+			if ($tmpC eq "id2") { $colQuery = $i; }
+		}
+		if (!defined $colE) { die "ERROR: CSV column 'E' not present in '$shardFile'"; }
+	} elsif ($shardHeader ne $header) {
+		die "ERROR: CSV header of '$shardFile' differs from the first shard output";
+	}
+	# read interactions
+	while (my $line = <$shard>) {
+		chomp $line;
+		# skip empty and comment lines
+		if ($line =~ /^\s*$/ or $line =~ /^#/) { next; }
+		my @data = split /;/, $line;
+		my $queryId = defined $colQuery ? $data[$colQuery] : "";
+		if (!exists $query2rows{$queryId}) {
+			push @queries, $queryId;
+			$query2rows{$queryId} = [];
+		}
+		push @{$query2rows{$queryId}}, [ $data[$colE], $rowNumber++, $line ];
+	}
+	close($shard);
+}
+
+if (!defined $header) { die "ERROR: no CSV header found in the shard outputs"; }
+
+###########################################################################
+# print k best interactions per query
+###########################################################################
+
+print $header."\n";
+for my $queryId (@queries) {
+	my @rows = sort { $a->[0] <=> $b->[0] or $a->[1] <=> $b->[1] } @{$query2rows{$queryId}};
+	my $last = ($args{n} > 0 && $args{n} <= $#rows) ? $args{n}-1 : $#rows;
+	for ( my $r=0; $r <= $last; $r++ ) {
+		print $rows[$r]->[2]."\n";
+	}
+}
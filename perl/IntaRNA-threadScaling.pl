@@ -0,0 +1,233 @@
+#!/usr/bin/env perl
+
+############################################################################
+#
+# IntaRNA-threadScaling
+#
+# Runs a fixed set of input shapes (a single long pair, one query vs. many
+# targets, many queries vs. one target and many queries vs. many targets)
+# with an IntaRNA binary for increasing numbers of threads (1,2,4,.. up to
+# the maximal number) and reports for each shape and number of threads the
+# median wall time, the speedup and the parallel efficiency (speedup per
+# thread) in CSV or JSON format.
+#
+# The sequences of the shapes are generated by a fixed pseudo random number
+# generator, such that the shapes are identical on all systems.
+#
+# If the parallel efficiency of any shape drops below its minimal efficiency,
+# the failing shapes are listed on STDERR and the script exits with a
+# non-zero exit code, such that scaling regressions can be detected.
+#
+############################################################################
+
+use strict;
+use Getopt::Std;
+use File::Temp qw(tempdir);
+use Time::HiRes qw(time);
+
+my %args;
+
+# setup default values for input arguments
+my $defB = "IntaRNA";
+my $defR = 3;
+my $defF = "csv";
+my $defS = ".";
+
+# number of CPUs available
+sub numberOfCpus {
+	my $cpus = 0;
+	if (open(my $cpuinfo, "<", "/proc/cpuinfo")) {
+		while (my $line = <$cpuinfo>) {
+			if ($line =~ /^processor\s*:/) { $cpus++; }
+		}
+		close($cpuinfo);
+	}
+	if ($cpus == 0) {
+		my $nproc = `nproc 2>/dev/null`;
+		if ($nproc =~ /^(\d+)/) { $cpus = $1; }
+	}
+	return ($cpus > 0 ? $cpus : 1);
+}
+my $defM = numberOfCpus();
+
+# check if arguments ok
+if (!getopts("hb:r:m:e:f:s:", \%args) or (defined $args{h} && $args{h}==1) or $#ARGV >= 0) {
+	print "Usage: IntaRNA-threadScaling.pl [-b IntaRNA] [-r n] [-m n] [-e x] [-f csv|json] [-s regex]\n"
+	."Available arguments:\n"
+	."  -b\t(opt) IntaRNA binary to run (def=$defB)\n"
+	."  -r\t(opt) number of repetitions per shape and number of threads (def=$defR)\n"
+	."  -m\t(opt) maximal number of threads (def=$defM, i.e. number of CPUs)\n"
+	."  -e\t(opt) minimal parallel efficiency in (0,1] for all shapes (def=shape specific)\n"
+	."  -f\t(opt) output format, either 'csv' or 'json' (def=$defF)\n"
+	."  -s\t(opt) regular expression to select shapes by name (def=$defS, i.e. all)\n"
+	."  -h\t(opt) parameter list\n"
+	;
+	if (defined $args{h} && $args{h}==1) {
+		exit 0;
+	}
+	exit -1; # error in input arguments
+}
+
+# fill optional arguments if missing
+if (!defined $args{b}) { $args{b} = $defB; };
+if (!defined $args{r}) { $args{r} = $defR; };
+if (!defined $args{m}) { $args{m} = $defM; };
+if (!defined $args{f}) { $args{f} = $defF; };
+if (!defined $args{s}) { $args{s} = $defS; };
+if ($args{r} !~ /^[1-9]\d*$/) { die "ERROR: -r has to be a positive integer"; };
+if ($args{m} !~ /^[1-9]\d*$/) { die "ERROR: -m has to be a positive integer"; };
+if (defined $args{e} and ($args{e} !~ /^(\d+\.?\d*|\.\d+)$/ or $args{e} <= 0 or $args{e} > 1)) { die "ERROR: -e has to be within (0,1]"; };
+if ($args{f} ne "csv" and $args{f} ne "json") { die "ERROR: -f has to be either 'csv' or 'json'"; };
+
+###########################################################################
+# deterministic sequence generation
+###########################################################################
+
+# state of the linear congruential generator
+my $rngState = 0;
+
+# (re)sets the generator state
+sub setSeed {
+	$rngState = shift;
+}
+
+# generates a random RNA sequence of the given length
+sub randomSequence {
+	my $length = shift;
+	my @nt = ("A","C","G","U");
+	my $seq = "";
+	for (my $i=0; $i<$length; $i++) {
+		$rngState = (1103515245 * $rngState + 12345) % 2147483648;
+		$seq .= $nt[ ($rngState >> 16) % 4 ];
+	}
+	return $seq;
+}
+
+# generates the given number of random sequences of the given length
+sub randomSequences {
+	my ($number, $length) = @_;
+	my @seqs;
+	for (my $i=0; $i<$number; $i++) {
+		push @seqs, randomSequence($length);
+	}
+	return @seqs;
+}
+
+###########################################################################
+# input shapes
+###########################################################################
+
+setSeed(1);
+# a single long pair (parallelized within the prediction only)
+my @longQuery = ( randomSequence(1000) );
+my @longTarget = ( randomSequence(2000) );
+# sRNA-like queries and mRNA-like targets
+my @queries = randomSequences( 32, 100 );
+my @targets = randomSequences( 32, 400 );
+
+# shape name, queries, targets, additional arguments and the default minimal
+# parallel efficiency
+my @shapes = (
+	{ name => "1x1_long", queries => \@longQuery, targets => \@longTarget
+		, args => "--mode=H --tIntLenMax=150 --qIntLenMax=150", minEfficiency => 0.3 },
+	{ name => "1xN", queries => [$queries[0]], targets => \@targets
+		, args => "--mode=H", minEfficiency => 0.6 },
+	{ name => "Nx1", queries => \@queries, targets => [$targets[0]]
+		, args => "--mode=H", minEfficiency => 0.6 },
+	{ name => "NxM", queries => [@queries[0..7]], targets => [@targets[0..7]]
+		, args => "--mode=H", minEfficiency => 0.6 },
+);
+
+# numbers of threads to run: powers of two up to the maximum and the maximum
+my @threads;
+for (my $t=1; $t<$args{m}; $t*=2) {
+	push @threads, $t;
+}
+push @threads, $args{m};
+
+###########################################################################
+# run shapes
+###########################################################################
+
+my $tmpDir = tempdir( "IntaRNA-threadScaling-XXXXXX", TMPDIR => 1, CLEANUP => 1 );
+
+# writes the given sequences to a FASTA file
+sub writeFasta {
+	my ($fileName, $prefix, @seqs) = @_;
+	open(my $out, ">", $fileName) or die "ERROR: could not write '$fileName'";
+	for (my $i=0; $i<=$#seqs; $i++) {
+		print $out ">$prefix".($i+1)."\n".$seqs[$i]."\n";
+	}
+	close($out);
+}
+
+# provides the median of a list of values
+sub median {
+	my @sorted = sort { $a <=> $b } @_;
+	return $sorted[ int($#sorted/2) ];
+}
+
+# scaling results
+my @results;
+# shapes and numbers of threads below the minimal efficiency
+my @failed;
+
+for my $shape (@shapes) {
+	if ($shape->{name} !~ /$args{s}/) { next; }
+	my $queryFile = "$tmpDir/$shape->{name}.query.fa";
+	my $targetFile = "$tmpDir/$shape->{name}.target.fa";
+	writeFasta( $queryFile, "q", @{$shape->{queries}} );
+	writeFasta( $targetFile, "t", @{$shape->{targets}} );
+	my $minEfficiency = (defined $args{e} ? $args{e} : $shape->{minEfficiency});
+
+	my $serialTime = 0;
+	for my $t (@threads) {
+		my @wallTimes;
+		for (my $r=0; $r<$args{r}; $r++) {
+			my $cmd = "$args{b} -q $queryFile -t $targetFile $shape->{args}"
+					." --threads=$t --out=$tmpDir/out.txt";
+			my $start = time();
+			system($cmd) == 0 or die "ERROR: call failed : $cmd";
+			push @wallTimes, time() - $start;
+		}
+		my $wallTime = median( @wallTimes );
+		if ($t == 1) { $serialTime = $wallTime; }
+		my $speedup = ($wallTime > 0 ? $serialTime / $wallTime : 1);
+		my $efficiency = $speedup / $t;
+		my $status = ($efficiency >= $minEfficiency ? "ok" : "FAIL");
+		if ($status ne "ok") {
+			push @failed, "$shape->{name} with $t threads : efficiency ".sprintf("%.2f",$efficiency)." < $minEfficiency";
+		}
+		push @results, { shape => $shape->{name}, threads => $t, wallTime => sprintf("%.3f",$wallTime)
+						, speedup => sprintf("%.2f",$speedup), efficiency => sprintf("%.2f",$efficiency)
+						, minEfficiency => $minEfficiency, status => $status };
+	}
+}
+
+###########################################################################
+# report results
+###########################################################################
+
+my @cols = ("shape","threads","wallTime","speedup","efficiency","minEfficiency","status");
+if ($args{f} eq "csv") {
+	print join(";",@cols)."\n";
+	for my $result (@results) {
+		print join(";", map { $result->{$_} } @cols)."\n";
+	}
+} else {
+	print "[\n";
+	for (my $i=0; $i<=$#results; $i++) {
+		print "  { ".join(", ", map { "\"$_\": ".($_ eq "shape" || $_ eq "status" ? "\"$results[$i]->{$_}\"" : $results[$i]->{$_}) } @cols)
+			." }".($i < $#results ? "," : "")."\n";
+	}
+	print "]\n";
+}
+
+# report scaling regressions
+if ($#failed >= 0) {
+	print STDERR "ERROR: parallel efficiency below the minimum for\n";
+	for my $fail (@failed) {
+		print STDERR "  $fail\n";
+	}
+	exit 1;
+}
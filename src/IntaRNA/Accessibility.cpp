@@ -2,6 +2,9 @@
 
 #include "IntaRNA/Accessibility.h"
 
+#include <cstdint>
+#include <vector>
+
 namespace IntaRNA {
 
 ////////////////////////////////////////////////////////////////////
@@ -10,6 +13,10 @@ const E_type Accessibility::ED_UPPER_BOUND = (E_type) E_INF;
 
 ////////////////////////////////////////////////////////////////////
 
+const std::string Accessibility::ED_binaryHeader = "IntaRNA-ED-bin1\n";
+
+////////////////////////////////////////////////////////////////////
+
 std::ostream&
 operator<<(std::ostream& out, const Accessibility& acc)
 {
@@ -114,6 +121,54 @@ writeRNAplfold_text( std::ostream& out, const E_type RT, const bool writeProbs )
 
 ////////////////////////////////////////////////////////////////////
 
+void
+Accessibility::
+writeED_binary( std::ostream& out, const E_type RT ) const
+{
+	const size_t maxL = std::min(getSequence().size(),getMaxLength());
+
+	// header
+	const uint64_t dim[3] = { getSequence().size(), maxL, sizeof(E_type) };
+	const double rt = RT;
+	out.write( ED_binaryHeader.c_str(), ED_binaryHeader.size() );
+	out.write( (const char*)dim, sizeof(dim) );
+	out.write( (const char*)&rt, sizeof(rt) );
+
+	// write one record for each possible window end j
+	std::vector<E_type> record( maxL, ED_UPPER_BOUND );
+	for (size_t j=0; j<getSequence().size(); j++) {
+		// for each (increasing) window length, store value
+		for ( size_t l = 1; l <= std::min(j+1,maxL); l++ ) {
+			record[l-1] = getED(j+1-l, j);
+		}
+		out.write( (const char*)&(record[0]), record.size()*sizeof(E_type) );
+	}
+	// flush output stream
+	out.flush();
+}
+
+////////////////////////////////////////////////////////////////////
+
+/**
+ * Selects the window with the higher ED value; if both are equal, the
+ * window with the smaller start index is selected.
+ * @param winED the ED values of all windows
+ * @param a the start index of the first window
+ * @param b the start index of the second window
+ * @return the start index of the selected window
+ */
+static inline
+size_t
+getMaxEdWindow( const std::vector<E_type> & winED, const size_t a, const size_t b )
+{
+	if (winED[a] < winED[b] || (!(winED[b] < winED[a]) && b < a)) {
+		return b;
+	}
+	return a;
+}
+
+////////////////////////////////////////////////////////////////////
+
 IndexRangeList
 Accessibility::
 decomposeByMaxED( const size_t maxRangeLength, const size_t winSize, const size_t minRangeLength ) const
@@ -129,6 +184,23 @@ decomposeByMaxED( const size_t maxRangeLength, const size_t winSize, const size_
 	const size_t seqLastIdx = getSequence().size()-1;
 	accessibleRanges.push_back( IndexRange(0,seqLastIdx) );
 
+	// ED values of all windows, computed once for all ranges
+	const size_t winNumber = (seqLastIdx+1 >= winSize) ? seqLastIdx+2-winSize : 0;
+	std::vector<E_type> winED( winNumber );
+	for (size_t i = 0; i < winNumber; i++) {
+		winED[i] = getED(i,i+winSize-1);
+	}
+	// segment tree of the window with highest ED within ranges of window
+	// starts, such that the recursive decomposition takes only a logarithmic
+	// number of steps per range instead of rescanning all its windows
+	std::vector<size_t> maxEdWindow( 2*winNumber );
+	for (size_t i = 0; i < winNumber; i++) {
+		maxEdWindow[winNumber+i] = i;
+	}
+	for (size_t i = winNumber-1; i > 0 && i < winNumber; i--) {
+		maxEdWindow[i] = getMaxEdWindow( winED, maxEdWindow[2*i], maxEdWindow[2*i+1] );
+	}
+
 	for (size_t rIdx = 0; rIdx < accessibleRanges.size(); /*increment in loop*/) {
 		// access to current range
 		IndexRange & curRange = accessibleRanges.get(rIdx);
@@ -148,17 +220,14 @@ decomposeByMaxED( const size_t maxRangeLength, const size_t winSize, const size_
 			// get boundaries for window-screening
 			const size_t minIdx = curRange.from;
 			const size_t maxIdx = curRange.to - winSize + 1;
-			// find window with highest ED
-			size_t maxEdIdx = curRange.from;
-			E_type maxEd = getED(maxEdIdx,maxEdIdx+winSize-1);
-			for (size_t i = minIdx; i <= maxIdx; i++ ) {
-				const size_t winSizeEnd = i+winSize-1;
-				// check if we found window with higher ED
-				if (getED(i,winSizeEnd) > maxEd) {
-					// set to middle of window
-					maxEdIdx = i;
-					// update maximum found so far
-					maxEd = getED(i,winSizeEnd);
+			// find (first) window with highest ED
+			size_t maxEdIdx = minIdx;
+			for (size_t l = minIdx+winNumber, r = maxIdx+winNumber+1; l < r; l /= 2, r /= 2) {
+				if (l % 2 == 1) {
+					maxEdIdx = getMaxEdWindow( winED, maxEdIdx, maxEdWindow[l++] );
+				}
+				if (r % 2 == 1) {
+					maxEdIdx = getMaxEdWindow( winED, maxEdIdx, maxEdWindow[--r] );
 				}
 			}
 			// decompose
@@ -209,7 +278,8 @@ decomposeByMinPu( IndexRangeList & ranges, const double minPu, const E_type RT )
 
 		size_t lastStart = range->to +1;
 		for (size_t i= range->from; i <= range->to; i++) {
-			if (E_isINF(getED(i,i)) || (getED(i,i) > maxED && !E_equal(getED(i,i),maxED))) {
+			const E_type curED = getED(i,i);
+			if (E_isINF(curED) || (curED > maxED && !E_equal(curED,maxED))) {
 				// check if end of range found and to be stored
 				if (lastStart < i) {
 					out.push_back(IndexRange(lastStart,i));
@@ -27,6 +27,9 @@ public:
 	//! upper bound for all ED return values
 	const static E_type ED_UPPER_BOUND;
 
+	//! identifier at the beginning of ED values in binary format
+	const static std::string ED_binaryHeader;
+
 public:
 
 	/**
@@ -108,6 +111,28 @@ public:
 	void
 	writeRNAplfold_ED_text( std::ostream& out ) const;
 
+	/**
+	 * Writes the ED values in binary format to stream, which is the binary
+	 * counterpart of writeRNAplfold_ED_text() that can be read without
+	 * parsing. The format is
+	 *
+	 *  - the 16 characters of ED_binaryHeader
+	 *  - sequence length, maximal window length and sizeof(E_type)
+	 *    (each as unsigned 64-bit integer)
+	 *  - RT used for the ED computation (double)
+	 *  - one record for each window end j (in increasing order) with the ED
+	 *    values for the window lengths 1..maximal window length (E_type),
+	 *    where unavailable windows are filled with ED_UPPER_BOUND
+	 *
+	 * using native byte order. Since all records have the same size, the
+	 * value for window end j and length l is found at a fixed offset.
+	 *
+	 * @param out the output stream to write to
+	 * @param RT the scaled temperature value used for ED computation
+	 */
+	void
+	writeED_binary( std::ostream& out, const E_type RT ) const;
+
 	/**
 	 * Prints the accessibility values to stream as upper triangular matrix
 	 * @param out the ostream to write to
@@ -0,0 +1,131 @@
+
+#ifndef INTARNA_ACCESSIBILITYALIAS_H_
+#define INTARNA_ACCESSIBILITYALIAS_H_
+
+#include "IntaRNA/Accessibility.h"
+
+
+namespace IntaRNA {
+
+/**
+ * Provides the accessibility data of another accessibility object for an
+ * identical sequence (e.g. a copy of the sequence with another identifier),
+ * i.e. all ED values are forwarded to the original object without the need
+ * to recompute them.
+ *
+ */
+class AccessibilityAlias: public Accessibility {
+
+public:
+
+	/**
+	 * Construction
+	 * @param sequence the sequence the accessibility data is provided for,
+	 *          which has to be identical to the sequence of origAcc
+	 * @param origAcc the accessibility object that provides the ED values
+	 *
+	 * @throw std::runtime_error if the sequences differ
+	 */
+	AccessibilityAlias( const RnaSequence& sequence
+						, const Accessibility & origAcc
+						);
+
+	/**
+	 * destruction
+	 */
+	virtual ~AccessibilityAlias();
+
+	/**
+	 * Returns the ED value of the original accessibility object.
+	 *
+	 * @param from the start index of the regions (from <= to)
+	 * @param to the end index of the regions (to <= seq.length())
+	 *
+	 * @return the ED value of the original accessibility object
+	 */
+	virtual
+	E_type
+	getED( const size_t from, const size_t to ) const;
+
+	/**
+	 * Access to the maximal length of accessible regions of the original
+	 * accessibility object.
+	 *
+	 * @return the maximal length of accessible regions considered
+	 */
+	virtual
+	size_t
+	getMaxLength() const;
+
+	/**
+	 * Access to the original accessibility object.
+	 * @return the accessibility object that provides the ED values
+	 */
+	const Accessibility &
+	getAccessibilityOrigin() const;
+
+protected:
+
+	//! the accessibility object that provides the ED values
+	const Accessibility & origAcc;
+
+};
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+inline
+AccessibilityAlias::AccessibilityAlias( const RnaSequence& seq
+				, const Accessibility & origAcc )
+ :
+	Accessibility(seq, origAcc.getMaxLength(), &(origAcc.getAccConstraint()))
+	, origAcc(origAcc)
+{
+	if (seq.asString() != origAcc.getSequence().asString()) {
+		throw std::runtime_error("AccessibilityAlias : sequence '"+seq.getId()+"' differs from the sequence '"+origAcc.getSequence().getId()+"' of the original accessibility");
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+inline
+AccessibilityAlias::~AccessibilityAlias()
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+inline
+E_type
+AccessibilityAlias::
+getED( const size_t from, const size_t to ) const
+{
+	return origAcc.getED( from, to );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+AccessibilityAlias::
+getMaxLength() const
+{
+	return origAcc.getMaxLength();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+inline
+const Accessibility &
+AccessibilityAlias::
+getAccessibilityOrigin() const
+{
+	return origAcc;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_ACCESSIBILITYALIAS_H_ */
@@ -12,11 +12,11 @@ AccessibilityBasePair::AccessibilityBasePair(const RnaSequence& seq,
     const size_t maxLength, const AccessibilityConstraint * const accConstr_,
     const E_type bpEnergy, const E_type _RT, const size_t minLoopLen) :
       Accessibility(seq, maxLength, accConstr_),
-      logPu(seq.size(), seq.size()),
       basePairEnergy(bpEnergy),
       RT(_RT),
       basePairWeight( _RT == 0.0 ? 0.0 : std::exp(-bpEnergy / _RT) ),
-      minLoopLength(minLoopLen)
+      minLoopLength(minLoopLen),
+      logPu()
 {
 	if (accConstr_ != NULL && !accConstr_->isEmpty()) {
 		INTARNA_NOT_IMPLEMENTED("AccessibilityBasePair: accessibility constraints not supported");
@@ -25,27 +25,17 @@ AccessibilityBasePair::AccessibilityBasePair(const RnaSequence& seq,
 		throw std::runtime_error("AccessibilityBasePair: RT == 0.0");
 	}
   const size_t N = seq.size();
-  // create temporary matrices for ED computation
-  NussinovHandler::E2dMatrix Q(N, N);
-  NussinovHandler::E2dMatrix Qb(N, N);
-  NussinovHandler::P2dMatrix Pbp(N, N);
-  NussinovHandler::P2dMatrix Pu(N, N);
+  const size_t L = getMaxLength();
 
-  logPu.resize(N, N);
+  // compute unpaired probabilities of all regions up to the maximal length
+  std::vector<NussinovHandler::P_type> Pu;
+  NussinovHandler::getPuBand(seq, basePairWeight, minLoopLength, L, Pu);
 
-  // init temporary matrices
-  for (size_t i = 0u; i < N; ++i) {
-    for (size_t j = i; j < N; ++j) {
-      Q(i, j) = -1.0;
-      Qb(i, j) = -1.0;
-      Pbp(i, j) = -1.0;
-      Pu(i, j) = -1.0;
-    }
-  }
   // compute ED values
+  logPu.resize(N, L);
   for (size_t i = 0u; i < N; ++i) {
-    for (size_t j = i; j < N; ++j) {
-      logPu(i, j) = -RT * std::log(NussinovHandler::getPu(i, j, seq, basePairWeight, minLoopLength, Q, Qb, Pbp, Pu));
+    for (size_t j = i; j < N && j - i < L; ++j) {
+      logPu.set(i, j, -RT * std::log(Pu[i * L + (j - i)]));
     }
   }
 }
@@ -66,7 +56,11 @@ AccessibilityBasePair::getED( const size_t from, const size_t to ) const
     throw std::runtime_error( "AccessibilityBasePair::getED("+toString(from)+","+toString(to)
                              +") : Arguments must satisfy 0 <= from <= to < seq.length" );
   }
-  return logPu(from, to);
+  if (to - from + 1 > getMaxLength()) {
+    // region length exceeds maximally allowed length -> no value
+    return ED_UPPER_BOUND;
+  }
+  return logPu.get(from, to);
 };
 
 }  // namespace IntaRNA
@@ -7,6 +7,7 @@
 #include "IntaRNA/Accessibility.h"
 #include "IntaRNA/AccessibilityConstraint.h"
 #include "IntaRNA/NussinovHandler.h"
+#include "IntaRNA/EdBandMatrix.h"
 
 
 namespace IntaRNA {
@@ -55,7 +56,7 @@ public:
    * @param from The start index of the region
    * @param to The end index of the region
    *
-   * @return The ED Value 
+   * @return The ED Value if (to-from+1) <= maxLength or ED_UPPER_BOUND otherwise
    *
    * @throw std::runtime_error in case it does not hold 0 <= from <= to < seq.length
    */
@@ -73,9 +74,9 @@ protected:
   const size_t minLoopLength;
 
   /***
-   * Results of getED lookup table
+   * Results of getED lookup table (band of width maxLength)
    */
-  NussinovHandler::E2dMatrix logPu;
+  EdBandMatrix logPu;
 
 };
 
@@ -0,0 +1,214 @@
+
+#include "IntaRNA/AccessibilityCache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#if INTARNA_HAVE_MMAP
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace IntaRNA {
+
+////////////////////////////////////////////////////////////////////////////
+
+const std::string AccessibilityCache::fileHeader = "IntaRNA-ED-cache-3\n";
+
+const size_t AccessibilityCache::dataAlignment = 8;
+
+////////////////////////////////////////////////////////////////////////////
+
+#if INTARNA_HAVE_MMAP
+
+/**
+ * Unmaps a memory mapped cache entry when its last user is gone
+ */
+class AccessibilityCacheUnmapper {
+public:
+	//! the size of the mapping
+	const size_t size;
+	AccessibilityCacheUnmapper( const size_t size ) : size(size) {}
+	void operator()( const char * map ) const {
+		munmap( const_cast<char*>(map), size );
+	}
+};
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+
+AccessibilityCache::
+AccessibilityCache( const std::string & cacheDir, const bool mapEntries )
+ :	store( cacheDir, fileHeader, ".ed", "accessibility cache" )
+#if INTARNA_HAVE_MMAP
+	, mapEntries(mapEntries)
+#else
+	, mapEntries(false)
+#endif
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+AccessibilityCache::
+~AccessibilityCache()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+std::string
+AccessibilityCache::
+getKey( const RnaSequence & sequence
+		, const AccessibilityConstraint & accConstraint
+		, const size_t maxLength
+		, const size_t plFoldW
+		, const VrnaHandler & vrnaHandler )
+{
+	std::stringstream key;
+	key <<"seq=" <<sequence.asString()
+		<<"\nmaxLength=" <<maxLength
+		<<"\nplFoldW=" <<plFoldW
+		<<"\nplFoldL=" <<accConstraint.getMaxBpSpan()
+		<<"\nconstraint=";
+	for (size_t i=0; i<sequence.size(); i++) {
+		key <<accConstraint.getVrnaDotBracket(i);
+	}
+	key <<"\nshape=";
+	if (!accConstraint.getShapeFile().empty()) {
+		key <<accConstraint.getShapeMethod()
+			<<';' <<accConstraint.getShapeConversion()
+			<<';' <<KeyedFileStore::getFileContent( accConstraint.getShapeFile() );
+	}
+	key <<"\ntemperature=" <<std::setprecision(10) <<vrnaHandler.getTemperature()
+		<<"\nparameters=";
+	if (!vrnaHandler.getParamFile().empty()) {
+		key <<KeyedFileStore::getFileContent( vrnaHandler.getParamFile() );
+	}
+	key <<"\nE_type=" <<sizeof(E_type)
+		<<'\n';
+	return key.str();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+AccessibilityCache::
+read( const std::string & key, EdMatrix & edValues ) const
+{
+	std::ifstream in;
+	if (!store.open( key, in )) {
+		return false;
+	}
+	const std::string fileName = getFileName( key );
+
+	// check matrix dimensions
+	uint64_t dim[4] = {0,0,0,0};
+	in.read( (char*)dim, sizeof(dim) );
+	// skip the padding in front of the aligned matrix storage
+	const size_t dataOffset = getDataOffset( key );
+	in.seekg( dataOffset );
+	if (!in.good()
+		|| dim[0] != edValues.getSeqLength()
+		|| dim[1] != edValues.getMaxLength()
+		|| dim[2] != (edValues.isReducedPrecision() ? 1 : 0)
+		|| dim[3] != edValues.getDataSize() )
+	{
+#if INTARNA_MULITHREADING
+			#pragma omp critical(intarna_omp_logOutput)
+#endif
+		{ VLOG(2) <<"accessibility cache : ignoring entry "<<fileName<<" of different dimensions"; }
+		return false;
+	}
+
+#if INTARNA_HAVE_MMAP
+	// share the matrix storage of the file among all processes mapping it
+	if (mapEntries) {
+		in.close();
+		const int fd = open( fileName.c_str(), O_RDONLY );
+		struct stat fileStat;
+		void * map = MAP_FAILED;
+		if (fd >= 0 && fstat( fd, &fileStat ) == 0 && (size_t)fileStat.st_size >= dataOffset+edValues.getDataSize()) {
+			map = mmap( NULL, (size_t)fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+		}
+		if (fd >= 0) {
+			close( fd );
+		}
+		if (map == MAP_FAILED) {
+#if INTARNA_MULITHREADING
+			#pragma omp critical(intarna_omp_logOutput)
+#endif
+			{ VLOG(2) <<"accessibility cache : could not map entry "<<fileName; }
+			return false;
+		}
+		// the matrix refers to the storage within the mapping, which is
+		// unmapped with the last matrix using it
+		const std::shared_ptr<const char> mapping( static_cast<const char*>(map), AccessibilityCacheUnmapper( (size_t)fileStat.st_size ) );
+		edValues.setData( edValues.getSeqLength(), edValues.getMaxLength(), edValues.isReducedPrecision()
+				, std::shared_ptr<const char>( mapping, mapping.get()+dataOffset ) );
+#if INTARNA_MULITHREADING
+		#pragma omp critical(intarna_omp_logOutput)
+#endif
+		{ VLOG(2) <<"accessibility cache : mapped ED values of "<<fileName; }
+		return true;
+	}
+#endif
+
+	// read raw matrix storage
+	std::vector<char> data( edValues.getDataSize() );
+	in.read( data.data(), data.size() );
+	if ((size_t)in.gcount() != data.size()) {
+#if INTARNA_MULITHREADING
+			#pragma omp critical(intarna_omp_logOutput)
+#endif
+		{ VLOG(2) <<"accessibility cache : ignoring incomplete entry "<<fileName; }
+		return false;
+	}
+	std::copy( data.begin(), data.end(), edValues.getData() );
+
+#if INTARNA_MULITHREADING
+		#pragma omp critical(intarna_omp_logOutput)
+#endif
+	{ VLOG(2) <<"accessibility cache : read ED values from "<<fileName; }
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+AccessibilityCache::
+write( const std::string & key, const EdMatrix & edValues ) const
+{
+	// matrix dimensions
+	const uint64_t dim[4] = { edValues.getSeqLength(), edValues.getMaxLength(), (edValues.isReducedPrecision() ? 1u : 0u), edValues.getDataSize() };
+	// padding to align the matrix storage within the file
+	const std::string padding( getDataOffset( key ) - (store.getDataOffset( key ) + sizeof(dim)), '\0' );
+	KeyedFileStore::DataBlocks data;
+	data.push_back( std::make_pair( (const char*)dim, sizeof(dim) ) );
+	data.push_back( std::make_pair( padding.c_str(), padding.size() ) );
+	// raw matrix storage
+	data.push_back( std::make_pair( edValues.getData(), edValues.getDataSize() ) );
+	store.write( key, data );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+size_t
+AccessibilityCache::
+getDataOffset( const std::string & key ) const
+{
+	// header, key and matrix dimensions
+	const size_t headerSize = store.getDataOffset( key ) + 4*sizeof(uint64_t);
+	return ((headerSize + dataAlignment - 1) / dataAlignment) * dataAlignment;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
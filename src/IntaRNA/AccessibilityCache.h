@@ -0,0 +1,167 @@
+
+#ifndef INTARNA_ACCESSIBILITYCACHE_H_
+#define INTARNA_ACCESSIBILITYCACHE_H_
+
+#include "IntaRNA/general.h"
+#include "IntaRNA/RnaSequence.h"
+#include "IntaRNA/AccessibilityConstraint.h"
+#include "IntaRNA/VrnaHandler.h"
+#include "IntaRNA/EdBandMatrix.h"
+#include "IntaRNA/KeyedFileStore.h"
+
+#include <string>
+
+namespace IntaRNA {
+
+/**
+ * Persistent on-disk cache of computed ED values to avoid their recomputation
+ * for sequences that are used repeatedly (e.g. the same targets over
+ * different runs).
+ *
+ * The entries are kept in a KeyedFileStore, where each entry's key describes
+ * the sequence and all settings the ED values depend on (see getKey()).
+ *
+ * Entries are stored in a binary format, i.e. the matrix dimensions followed
+ * by the raw storage of the ED matrix, which is directly read into memory.
+ *
+ * Optionally, entries are memory mapped read-only instead of read. Thus,
+ * processes on the same machine that use the same entries share their
+ * memory (e.g. if the cache directory is located in a shared memory file
+ * system like /dev/shm), such that an entry is only computed by the first
+ * process and held in memory only once.
+ *
+ */
+class AccessibilityCache {
+
+public:
+
+	//! type for the ED value matrix (band of width maxLength)
+	typedef EdBandMatrix EdMatrix;
+
+public:
+
+	/**
+	 * Construction
+	 * @param cacheDir the (existing) directory to store the cache entries in
+	 * @param mapEntries whether or not entries are memory mapped read-only
+	 *        instead of read into the ED matrix (if supported by the system)
+	 */
+	AccessibilityCache( const std::string & cacheDir
+						, const bool mapEntries = false );
+
+	/**
+	 * destruction
+	 */
+	virtual ~AccessibilityCache();
+
+	/**
+	 * Generates the key of an entry, i.e. a description of the sequence and
+	 * all settings the ED values depend on. SHAPE data and VRNA parameter
+	 * files are described by their content.
+	 *
+	 * @param sequence the sequence the ED values are about
+	 * @param accConstraint the accessibility constraint used for computation
+	 * @param maxLength the maximal length of accessible regions
+	 * @param plFoldW the sliding window size used for computation
+	 * @param vrnaHandler the VRNA handler used for computation
+	 * @return the key of the entry
+	 *
+	 * @throw std::runtime_error if a SHAPE or parameter file can not be read
+	 */
+	static
+	std::string
+	getKey( const RnaSequence & sequence
+			, const AccessibilityConstraint & accConstraint
+			, const size_t maxLength
+			, const size_t plFoldW
+			, const VrnaHandler & vrnaHandler );
+
+	/**
+	 * Whether or not entries are memory mapped instead of read
+	 * @return true if read() maps entries; false otherwise
+	 */
+	bool
+	isMappingEntries() const;
+
+	/**
+	 * Reads the ED values of an entry if available. If entries are mapped,
+	 * edValues provides the values of the mapped entry read-only
+	 * afterwards (see EdBandMatrix::setData()).
+	 *
+	 * @param key the key of the entry
+	 * @param edValues the ED matrix to fill, whose dimensions, band
+	 *        size and precision have to match the entry's
+	 * @return true if the entry was found and read; false otherwise, where
+	 *         edValues is not altered
+	 */
+	bool
+	read( const std::string & key, EdMatrix & edValues ) const;
+
+	/**
+	 * Stores the ED values of an entry. Write failures are logged but
+	 * otherwise ignored, since the cache is not mandatory for computation.
+	 *
+	 * @param key the key of the entry
+	 * @param edValues the ED values to store
+	 */
+	void
+	write( const std::string & key, const EdMatrix & edValues ) const;
+
+	/**
+	 * Provides the name of the file that holds an entry.
+	 * @param key the key of the entry
+	 * @return the full file name of the entry
+	 */
+	std::string
+	getFileName( const std::string & key ) const;
+
+protected:
+
+	//! the store of the entries
+	const KeyedFileStore store;
+
+	//! whether or not entries are memory mapped instead of read
+	const bool mapEntries;
+
+	//! identifier at the beginning of each entry file
+	static const std::string fileHeader;
+
+	//! alignment of the matrix storage within an entry file
+	static const size_t dataAlignment;
+
+	/**
+	 * Provides the position of the matrix storage within an entry file
+	 * @param key the key of the entry
+	 * @return the aligned position after the entry's header, key and
+	 *         matrix dimensions
+	 */
+	size_t
+	getDataOffset( const std::string & key ) const;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+AccessibilityCache::
+isMappingEntries() const
+{
+	return mapEntries;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+std::string
+AccessibilityCache::
+getFileName( const std::string & key ) const
+{
+	return store.getFileName( key );
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_ACCESSIBILITYCACHE_H_ */
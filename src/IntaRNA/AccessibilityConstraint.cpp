@@ -70,7 +70,8 @@ AccessibilityConstraint(
 	shapeConversion(shapeFile_.empty() ? "" : shapeConversion_),
 	blocked(),
 	accessible(),
-	paired()
+	paired(),
+	positionMarks()
 {
 #if INTARNA_IN_DEBUG_MODE
 	if (!boost::regex_match( stringEncoding, AccessibilityConstraint::regex, boost::match_perl )) {
@@ -136,6 +137,43 @@ AccessibilityConstraint(
 		}
 	}
 
+	// compile position-wise data
+	initPositionMarks();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void
+AccessibilityConstraint::
+initPositionMarks()
+{
+	positionMarks.clear();
+	// check if anything to mark
+	if (blocked.empty() && accessible.empty() && paired.empty()) {
+		return;
+	}
+	positionMarks.resize( length, 0 );
+	// mark all positions of the given ranges
+	const IndexRangeList * ranges[3] = { &blocked, &accessible, &paired };
+	const unsigned char marks[3] = { MARK_BLOCKED, MARK_ACCESSIBLE, MARK_PAIRED };
+	for (size_t l=0; l<3; l++) {
+		for (IndexRangeList::const_iterator r = ranges[l]->begin(); r != ranges[l]->end(); r++) {
+			for (size_t i = r->from; i <= r->to && i < length; i++) {
+				positionMarks[i] |= marks[l];
+			}
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void
+AccessibilityConstraint::
+addBlocked( const IndexRange & range )
+{
+	blocked.insert( range );
+	// update position-wise data
+	initPositionMarks();
 }
 
 ////////////////////////////////////////////////////////////////////////
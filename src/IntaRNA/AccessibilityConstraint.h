@@ -201,6 +201,15 @@ public:
 	 */
 	AccessibilityConstraint & operator= ( const AccessibilityConstraint & c );
 
+	/**
+	 * Additionally marks a range of positions as blocked, e.g. to exclude an
+	 * already formed interaction site from further interactions.
+	 *
+	 * @param range the range of positions to be blocked
+	 */
+	void
+	addBlocked( const IndexRange & range );
+
 
 	friend std::ostream& operator<<(std::ostream& out, const AccessibilityConstraint& c);
 
@@ -230,8 +239,36 @@ protected:
 	//! sorted list of ranges that are marked as paired (intramolecular)
 	IndexRangeList paired;
 
+	//! bit flags of the position-wise constraint marks
+	enum PositionMark {
+		MARK_BLOCKED = 1, //!< position is marked blocked
+		MARK_ACCESSIBLE = 2, //!< position is marked accessible
+		MARK_PAIRED = 4 //!< position is marked paired
+	};
+
+	//! the PositionMark flags of each position compiled from the range lists
+	//! to answer position queries by array lookup; empty if no position is
+	//! constrained
+	std::vector<unsigned char> positionMarks;
+
 protected:
 
+	/**
+	 * Compiles the range lists blocked, accessible and paired into
+	 * positionMarks.
+	 */
+	void
+	initPositionMarks();
+
+	/**
+	 * Checks whether or not the given position carries any of the given marks
+	 * @param i the position of interest
+	 * @param marks the PositionMark flags of interest
+	 * @return true if any of the marks is set for position i
+	 */
+	bool
+	hasMark( const size_t i, const unsigned char marks ) const;
+
 	/**
 	 * screens the given dot-bracket string for consecutive regions of
 	 * marker characters and pushes the according regions to the storage
@@ -277,7 +314,8 @@ AccessibilityConstraint( const size_t length_
 	shapeConversion(shapeFile_.empty() ? "" : shapeConversion_),
 	blocked(),
 	accessible(),
-	paired()
+	paired(),
+	positionMarks()
 {
 #if INTARNA_IN_DEBUG_MODE
 	if (!shapeFile.empty()) {
@@ -306,6 +344,7 @@ AccessibilityConstraint( const AccessibilityConstraint& toCopy
 	, blocked(toCopy.blocked)
 	, accessible(toCopy.accessible)
 	, paired(toCopy.paired)
+	, positionMarks(toCopy.positionMarks)
 {
 
 	if (reverseIndices) {
@@ -319,6 +358,8 @@ AccessibilityConstraint( const AccessibilityConstraint& toCopy
 		// reverse accessible
 		paired.reverse(length);
 
+		// update position data
+		initPositionMarks();
 	}
 }
 
@@ -336,7 +377,7 @@ bool
 AccessibilityConstraint::
 isMarkedBlocked(const size_t i) const
 {
-	return blocked.covers(i);
+	return hasMark( i, MARK_BLOCKED );
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -346,7 +387,7 @@ bool
 AccessibilityConstraint::
 isMarkedAccessible(const size_t i) const
 {
-	return accessible.covers(i);
+	return hasMark( i, MARK_ACCESSIBLE );
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -356,7 +397,7 @@ bool
 AccessibilityConstraint::
 isMarkedPaired(const size_t i) const
 {
-	return paired.covers(i);
+	return hasMark( i, MARK_PAIRED );
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -366,8 +407,7 @@ bool
 AccessibilityConstraint::
 isUnconstrained( const size_t i ) const
 {
-	return isEmpty()
-			|| !(isMarkedAccessible(i) || isMarkedBlocked(i) || isMarkedPaired(i));
+	return !hasMark( i, MARK_ACCESSIBLE | MARK_BLOCKED | MARK_PAIRED );
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -377,8 +417,7 @@ bool
 AccessibilityConstraint::
 isAccessible( const size_t i ) const
 {
-	return isEmpty()
-			|| !(isMarkedBlocked(i) || isMarkedPaired(i));
+	return !hasMark( i, MARK_BLOCKED | MARK_PAIRED );
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -400,7 +439,7 @@ AccessibilityConstraint::
 getVrnaDotBracket(const size_t i) const
 {
 	// check if to be accessible or blocked (==unstructured)
-	if (isMarkedAccessible(i) || isMarkedBlocked(i)) {
+	if (hasMark( i, MARK_ACCESSIBLE | MARK_BLOCKED )) {
 		return 'x';
 	}
 
@@ -414,6 +453,16 @@ getVrnaDotBracket(const size_t i) const
 
 ////////////////////////////////////////////////////////////////////////
 
+inline
+bool
+AccessibilityConstraint::
+hasMark( const size_t i, const unsigned char marks ) const
+{
+	return i < positionMarks.size() && (positionMarks[i] & marks) != 0;
+}
+
+////////////////////////////////////////////////////////////////////////
+
 inline
 size_t
 AccessibilityConstraint::
@@ -468,6 +517,7 @@ operator= ( const AccessibilityConstraint & c )
 	blocked = c.blocked;
 	accessible = c.accessible;
 	paired = c.paired;
+	positionMarks = c.positionMarks;
 
 	return *this;
 }
@@ -1,8 +1,12 @@
 
 #include "IntaRNA/AccessibilityFromStream.h"
 
+#include <cstdint>
+#include <vector>
+
 #include <boost/lexical_cast.hpp>
 #include <boost/regex.hpp>
+#include <boost/spirit/include/qi.hpp>
 
 namespace IntaRNA {
 
@@ -16,9 +20,11 @@ AccessibilityFromStream(
 		, std::istream & inStream
 		, const InStreamType inStreamType
 		, const E_type RT
+		, const bool reducedPrecision
 		)
  :	Accessibility( sequence, maxLength, accConstraint )
 	, edValues()
+	, reducedPrecision(reducedPrecision)
 	, availMaxLength( Accessibility::getMaxLength() )
 {
 	if (accConstraint != NULL && !accConstraint->isEmpty()) {
@@ -34,6 +40,10 @@ AccessibilityFromStream(
 		parseED_RNAplfold_text( inStream );
 		break;
 
+	case ED_IntaRNA_Binary :
+		parseED_binary( inStream, RT );
+		break;
+
 	}
 }
 
@@ -96,81 +106,177 @@ parseRNAplfold_text( std::istream & inStream, const E_type RT, const bool parseP
 	}
 
 	// resize data structure to fill
-	edValues.resize( getSequence().size(), getSequence().size(), 0, getMaxLength() );
-
-	// TODO rewrite to support "nan" and "inf" parsing via boost::spirit::qi
-	// http://stackoverflow.com/questions/11420263/is-it-possible-to-read-infinity-or-nan-values-using-input-streams
-
-	// end of ED window (= first column in file)
-	size_t j = 0, lastJ = 0;
-	while ( ! inStream.fail() && j < edValues.size2() ) {
-		// read first column = end of window = j
-		if ( inStream >> j ) {
-			// check if lines are consecutive
-			if ( j != lastJ+1 ) {
-				throw std::runtime_error("AccessibilityFromStream::parseRNAplfold_text() : non-consecutive line i="+toString(j)+" was preceeded by "+toString(lastJ));
-			}
-			// check if we line exceeds targeted length
-			if ( j > getSequence().size() ) {
+	edValues.resize( getSequence().size(), getMaxLength(), reducedPrecision );
+
+	// read all lines for the sequence at once (empty lines are ignored)
+	std::vector< std::string > lines;
+	lines.reserve( edValues.getSeqLength() );
+	while ( lines.size() < edValues.getSeqLength() && std::getline( inStream, line ) ) {
+		if (line.find_first_not_of(" \t\r") != std::string::npos) {
+			lines.push_back( line );
+		}
+	}
+	if (lines.size() < edValues.getSeqLength()) {
+		throw std::runtime_error("AccessibilityFromStream::parseRNAplfold_text() : could only parse "
+				+toString(lines.size())+" lines, but "+toString(edValues.getSeqLength())
+				+" expected (length of sequence "+getSequence().getId()+")");
+	}
+
+	// parse lines in parallel, i.e. each line j (window end) is converted
+	// independently and stored within the ED matrix
+	// - error message for each line (empty if parsed successfully)
+	std::vector< std::string > lineError( lines.size() );
 #if INTARNA_MULITHREADING
-				#pragma omp critical(intarna_omp_logOutput)
+	#pragma omp parallel for schedule(static)
 #endif
-				{ LOG(INFO) <<"AccessibilityFromStream::parseRNAplfold_text() : more lines found than sequence is long.. sure this is the correct file for this sequence?"; }
-				// stop parsing
-				break;
-			}
-			if ( j == lastJ ) {
-				throw std::runtime_error("AccessibilityFromStream::parseRNAplfold_text() : duplicate for i="
-						+ toString(lastJ));
-			}
-		} else {
-			throw std::runtime_error("AccessibilityFromStream::parseRNAplfold_text() : could not read next line start (integer i) after parsing "
-					+ toString(lastJ)+" lines of values");
+	for (size_t l=0; l<lines.size(); l++) {
+		lineError[l] = parseRNAplfold_textLine( lines[l], l+1, RT, parseProbs );
+	}
+	// report first parsing error
+	for (size_t l=0; l<lineError.size(); l++) {
+		if (!lineError[l].empty()) {
+			throw std::runtime_error("AccessibilityFromStream::parseRNAplfold_text() : "+lineError[l]);
 		}
+	}
+
+}
+
+/////////////////////////////////////////////////////////////////////////
+
+std::string
+AccessibilityFromStream::
+parseRNAplfold_textLine( const std::string & line
+					, const size_t j
+					, const E_type RT
+					, const bool parseProbs )
+{
+	namespace qi = boost::spirit::qi;
+
+	std::string::const_iterator it = line.begin();
+	const std::string::const_iterator end = line.end();
 
-		// parse probabilities for this line and store
-		double curVal;
-		size_t minI = j - std::min( j, getMaxLength() );
-		for ( size_t i = j; i>minI; i--) {
-			if ( inStream >>curVal ) {
-				// check if we parse probabilities
-				if (parseProbs) {
-					if (curVal < 0.0 || curVal > 1.0) {
-						throw std::runtime_error("AccessibilityFromStream::parseRNAplfold_Text(Pu) : in line i="+toString(j)
-								+" : the "+toString(j+1-i)+". value = "+toString(curVal)+" is no probability in [0,1]");
-					}
-					edValues( i-1, j-1 ) = curVal > 0
-											? std::min<E_type>(ED_UPPER_BOUND, - RT * std::log( curVal ))
-											: ED_UPPER_BOUND;
-				}
-				// or ED values
-				else {
-					if (curVal < 0.0) {
-						throw std::runtime_error("AccessibilityFromStream::parseRNAplfold_Text(ED) : in line i="+toString(j)
-								+" : the "+toString(j+1-i)+". value = "+toString(curVal)+" is no ED value >= 0");
-					}
-					edValues( i-1, j-1 ) = std::min<E_type>(ED_UPPER_BOUND, curVal);
-				}
-			} else {
-				throw std::runtime_error("AccessibilityFromStream::parseRNAplfold_text() : in line i="+toString(j)
-						+" : could not parse the "+toString(j+1-i)+". probability");
+	// read first column = end of window = j
+	size_t lineJ = 0;
+	if ( !qi::phrase_parse( it, end, qi::uint_parser<size_t>(), qi::ascii::space, lineJ ) ) {
+		return "could not read next line start (integer i) after parsing "+toString(j-1)+" lines of values";
+	}
+	// check if lines are consecutive
+	if ( lineJ != j ) {
+		return "non-consecutive line i="+toString(lineJ)+" was preceeded by "+toString(j-1);
+	}
+
+	// parse values for all window lengths (locale independent)
+	std::vector<double> values( std::min( j, getMaxLength() ) );
+	for (size_t l=0; l<values.size(); l++) {
+		if ( !qi::phrase_parse( it, end, qi::double_, qi::ascii::space, values[l] ) ) {
+			return "in line i="+toString(j)+" : could not parse the "+toString(l+1)+". probability";
+		}
+		// check value range (NaN values are rejected too)
+		if (parseProbs) {
+			if ( !(values[l] >= 0.0 && values[l] <= 1.0) ) {
+				return "in line i="+toString(j)+" : the "+toString(l+1)+". value = "+toString(values[l])+" is no probability in [0,1]";
+			}
+		} else {
+			if ( !(values[l] >= 0.0) ) {
+				return "in line i="+toString(j)+" : the "+toString(l+1)+". value = "+toString(values[l])+" is no ED value >= 0";
 			}
 		}
-		// check if full line was already parsed
-		if (j < maxAvailLength || minI > 0) {
-			// skip rest till end of line
-			inStream.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+	}
+
+	// convert to ED values within a separate loop to enable vectorization
+	if (parseProbs) {
+		for (size_t l=0; l<values.size(); l++) {
+			values[l] = values[l] > 0 ? (- RT * std::log( values[l] )) : ED_UPPER_BOUND;
 		}
+	}
 
-		// update parsing information for next run
-		lastJ = j;
+	// store ED values of window [j-l,j-1] (0-based) for each window length l+1
+	for (size_t l=0; l<values.size(); l++) {
+		edValues.set( j-1-l, j-1, std::min<E_type>( ED_UPPER_BOUND, values[l] ) );
 	}
 
-	// check if all needed data was parsed
-	if (lastJ < edValues.size2()) {
-		throw std::runtime_error("AccessibilityFromStream::parseRNAplfold_text() : could only parse "
-				+toString(lastJ)+" lines, but "+toString(edValues.size2())
-				+" expected (length of sequence "+getSequence().getId()+")");
+	return "";
+}
+
+/////////////////////////////////////////////////////////////////////////
+
+void
+AccessibilityFromStream::
+parseED_binary( std::istream & inStream, const E_type RT )
+{
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_logOutput)
+#endif
+	{ VLOG(2) <<"reading accessibility values from binary input ..."; }
+	// time logging
+	TIMED_FUNC_IF(timerObj, VLOG_IS_ON(9));
+
+	// check header
+	std::string header( ED_binaryHeader.size(), '\0' );
+	inStream.read( &(header[0]), header.size() );
+	if ( !inStream.good() || header != ED_binaryHeader ) {
+		throw std::runtime_error("AccessibilityFromStream::parseED_binary() : input does not start with the binary ED header");
+	}
+	uint64_t dim[3] = {0,0,0};
+	double rt = 0;
+	inStream.read( (char*)dim, sizeof(dim) );
+	inStream.read( (char*)&rt, sizeof(rt) );
+	if ( !inStream.good() ) {
+		throw std::runtime_error("AccessibilityFromStream::parseED_binary() : incomplete header");
+	}
+	if ( dim[2] != sizeof(E_type) ) {
+		throw std::runtime_error("AccessibilityFromStream::parseED_binary() : ED values of "+toString(dim[2])
+				+" bytes not compatible with this build ("+toString(sizeof(E_type))+" bytes)");
+	}
+	if ( dim[1] == 0 ) {
+		throw std::runtime_error("AccessibilityFromStream::parseED_binary() : maximal window length 0 in header");
+	}
+	if ( dim[0] != getSequence().size() ) {
+		throw std::runtime_error("AccessibilityFromStream::parseED_binary() : ED values for sequence length "+toString(dim[0])
+				+" but sequence "+getSequence().getId()+" is of length "+toString(getSequence().size()));
+	}
+	if ( std::abs( rt - RT ) > 1e-6 ) {
+#if INTARNA_MULITHREADING
+		#pragma omp critical(intarna_omp_logOutput)
+#endif
+		{ LOG(WARNING) <<"initializing ED data for sequence '"<<getSequence().getId()<<" : ED values were computed for RT "
+				<<rt<<" but RT "<<RT<<" is used, i.e. for a different temperature"; }
+	}
+	// check if maxLength <= max available length
+	const size_t maxAvailLength = dim[1];
+	if (maxAvailLength < getMaxLength()) {
+#if INTARNA_MULITHREADING
+		#pragma omp critical(intarna_omp_logOutput)
+#endif
+		{ LOG(INFO) <<"initializing ED data for sequence '"<<getSequence().getId()<<" : available maximal window length "
+				<<maxAvailLength<<" is smaller than maximal interaction length "<<getMaxLength()
+				<<" : reducing maximal interaction length to "<<maxAvailLength;}
+		// reducing maximal interaction length
+		availMaxLength = maxAvailLength;
+		assert( getMaxLength() == maxAvailLength ); // ensure overwrite is working
+	}
+
+	// resize data structure to fill
+	edValues.resize( getSequence().size(), getMaxLength(), reducedPrecision );
+
+	// read one record for each window end j
+	std::vector<E_type> record( maxAvailLength );
+	const std::streamsize recordSize = record.size()*sizeof(E_type);
+	for (size_t j=0; j<edValues.getSeqLength(); j++) {
+		inStream.read( (char*)&(record[0]), recordSize );
+		if (inStream.gcount() != recordSize) {
+			throw std::runtime_error("AccessibilityFromStream::parseED_binary() : could only read "
+					+toString(j)+" records, but "+toString(edValues.getSeqLength())
+					+" expected (length of sequence "+getSequence().getId()+")");
+		}
+		// store values for each window length
+		for ( size_t l = 1; l <= std::min(j+1,getMaxLength()); l++ ) {
+			if (record[l-1] < 0.0) {
+				throw std::runtime_error("AccessibilityFromStream::parseED_binary() : for window end "+toString(j+1)
+						+" : the "+toString(l)+". value = "+toString(record[l-1])+" is no ED value >= 0");
+			}
+			edValues.set( j+1-l, j, std::min<E_type>(ED_UPPER_BOUND, record[l-1]) );
+		}
 	}
 
 }
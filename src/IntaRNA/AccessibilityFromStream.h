@@ -4,9 +4,9 @@
 
 #include "IntaRNA/Accessibility.h"
 
-#include <iostream>
+#include "IntaRNA/EdBandMatrix.h"
 
-#include <boost/numeric/ublas/banded.hpp>
+#include <iostream>
 
 namespace IntaRNA {
 
@@ -21,6 +21,7 @@ public:
 	enum InStreamType {
 		Pu_RNAplfold_Text //! Pu values in RNAplfold text format
 		, ED_RNAplfold_Text //!< ED values in RNAplfold text Pu format
+		, ED_IntaRNA_Binary //!< ED values in binary format (see Accessibility::writeED_binary())
 	};
 
 public:
@@ -36,7 +37,10 @@ public:
 	 * @param inStream the input stream to read the accessibility data from
 	 * @param inStreamType inStream data type to be expected
 	 * @param RT the RT constant to be used to transform the probabilities to
-	 *        ED values
+	 *        ED values; for binary input it is compared to the RT used for
+	 *        the stored values
+	 * @param reducedPrecision whether or not ED values are stored in reduced
+	 *        precision (see EdBandMatrix) to lower the memory consumption
 	 */
 	AccessibilityFromStream(
 			const RnaSequence& sequence
@@ -45,6 +49,7 @@ public:
 			, std::istream & inStream
 			, const InStreamType inStreamType
 			, const E_type RT
+			, const bool reducedPrecision = false
 			);
 
 
@@ -84,12 +89,15 @@ public:
 
 protected:
 
-	//! type for the ED value matrix (upper triangular matrix banded by maxLength)
-	typedef boost::numeric::ublas::banded_matrix<E_type> EdMatrix;
+	//! type for the ED value matrix (band of width maxLength)
+	typedef EdBandMatrix EdMatrix;
 
 	//! the ED values for the given sequence
 	EdMatrix edValues;
 
+	//! whether or not edValues are stored in reduced precision
+	const bool reducedPrecision;
+
 	//! maximal available window size
 	size_t availMaxLength;
 
@@ -126,6 +134,36 @@ protected:
 						, const E_type RT
 						, const bool parseProbs );
 
+	/**
+	 * Parses a single value line of RNAplfold-styled input, i.e. the values
+	 * for window end j, and stores the according ED values. Different lines
+	 * can be parsed concurrently.
+	 *
+	 * @param line the line to parse
+	 * @param j the window end (index starting with 1) expected for the line
+	 * @param RT the RT constant to be used to transform the probabilities to
+	 *        ED values
+	 * @param parseProbs whether or not to expect unpaired probabilities (true)
+	 *        or ED values within the line
+	 * @return an error message or an empty string if parsing was successful
+	 */
+	std::string
+	parseRNAplfold_textLine( const std::string & line
+						, const size_t j
+						, const E_type RT
+						, const bool parseProbs );
+
+	/**
+	 * Reads ED values in binary format as written by
+	 * Accessibility::writeED_binary(). Each record is read as a whole without
+	 * any parsing.
+	 *
+	 * @param inStream the stream to read the ED values from
+	 * @param RT the RT constant expected for the stored ED values
+	 */
+	void
+	parseED_binary( std::istream & inStream, const E_type RT );
+
 
 };
 
@@ -146,7 +184,7 @@ getED( const size_t from, const size_t to ) const
 			return ED_UPPER_BOUND;
 		}
 		// return according ED value from the precomputed matrix
-		return edValues (from,to);
+		return edValues.get(from,to);
 	} else {
 		// region length exceeds maximally allowed length -> no value
 		return ED_UPPER_BOUND;
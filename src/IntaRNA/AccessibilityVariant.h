@@ -0,0 +1,194 @@
+
+#ifndef INTARNA_ACCESSIBILITYVARIANT_H_
+#define INTARNA_ACCESSIBILITYVARIANT_H_
+
+#include "IntaRNA/Accessibility.h"
+#include "IntaRNA/IndexRange.h"
+
+
+namespace IntaRNA {
+
+/**
+ * Provides the accessibility data of a sequence variant (e.g. a point
+ * mutation) of a reference sequence, for which accessibility data is already
+ * available.
+ *
+ * The ED values of all regions within the affected range, i.e. the range
+ * whose ED values might be altered by the variation, are taken from a
+ * variant-specific accessibility object. The latter has to provide correct
+ * values only for the affected range and can thus be computed locally. All
+ * other ED values are forwarded to the reference's accessibility object.
+ *
+ */
+class AccessibilityVariant: public Accessibility {
+
+public:
+
+	/**
+	 * Construction
+	 *
+	 * @param referenceAcc the accessibility object of the reference sequence
+	 *          that provides the ED values outside of the affected range
+	 * @param variantAcc the accessibility object of the variant sequence that
+	 *          provides the ED values within the affected range; this object
+	 *          is deleted on destruction
+	 * @param affected the range whose sequence and ED values might differ
+	 *          from the reference
+	 *
+	 * @throw std::runtime_error if the sequences are incompatible, i.e. they
+	 *          differ in length, maximal region length or outside of the
+	 *          affected range
+	 */
+	AccessibilityVariant( const Accessibility & referenceAcc
+						, const Accessibility * variantAcc
+						, const IndexRange & affected
+						);
+
+	/**
+	 * destruction
+	 */
+	virtual ~AccessibilityVariant();
+
+	/**
+	 * Returns the ED value of the variant-specific accessibility object if
+	 * the region is within the affected range or the ED value of the
+	 * reference otherwise.
+	 *
+	 * @param from the start index of the regions (from <= to)
+	 * @param to the end index of the regions (to <= seq.length())
+	 *
+	 * @return the ED value of the region for the variant sequence
+	 */
+	virtual
+	E_type
+	getED( const size_t from, const size_t to ) const;
+
+	/**
+	 * Access to the maximal length of accessible regions of the reference.
+	 *
+	 * @return the maximal length of accessible regions considered
+	 */
+	virtual
+	size_t
+	getMaxLength() const;
+
+	/**
+	 * Access to the range whose ED values (and sequence) might differ from
+	 * the reference.
+	 * @return the affected range
+	 */
+	const IndexRange &
+	getAffectedRange() const;
+
+	/**
+	 * Access to the accessibility object of the reference sequence.
+	 * @return the accessibility object of the reference
+	 */
+	const Accessibility &
+	getAccessibilityReference() const;
+
+protected:
+
+	//! the accessibility object of the reference sequence
+	const Accessibility & referenceAcc;
+
+	//! the (local) accessibility object of the variant sequence
+	const Accessibility * variantAcc;
+
+	//! the range whose ED values are taken from variantAcc
+	const IndexRange affected;
+
+};
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+inline
+AccessibilityVariant::AccessibilityVariant( const Accessibility & referenceAcc
+				, const Accessibility * variantAcc
+				, const IndexRange & affected )
+ :
+	Accessibility( variantAcc->getSequence(), referenceAcc.getMaxLength(), &(variantAcc->getAccConstraint()) )
+	, referenceAcc(referenceAcc)
+	, variantAcc(variantAcc)
+	, affected(affected)
+{
+	// check compatibility (variantAcc is owned from now on)
+	std::string error;
+	const std::string & refSeq = referenceAcc.getSequence().asString();
+	const std::string & varSeq = variantAcc->getSequence().asString();
+	if (refSeq.size() != varSeq.size()) {
+		error = "differs in length from the reference";
+	} else
+	if (!affected.isAscending() || affected.to >= varSeq.size()
+		|| refSeq.compare( 0, affected.from, varSeq, 0, affected.from ) != 0
+		|| refSeq.compare( affected.to+1, std::string::npos, varSeq, affected.to+1, std::string::npos ) != 0 )
+	{
+		error = "differs from the reference outside of the affected range "+toString(affected);
+	} else
+	if (variantAcc->getMaxLength() != referenceAcc.getMaxLength()) {
+		error = "differs in the maximal region length from the reference";
+	}
+	if (!error.empty()) {
+		INTARNA_CLEANUP(this->variantAcc);
+		throw std::runtime_error("AccessibilityVariant : sequence '"+getSequence().getId()+"' "+error+" '"+referenceAcc.getSequence().getId()+"'");
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+inline
+AccessibilityVariant::~AccessibilityVariant()
+{
+	INTARNA_CLEANUP(variantAcc);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+inline
+E_type
+AccessibilityVariant::
+getED( const size_t from, const size_t to ) const
+{
+	if (affected.from <= from && to <= affected.to) {
+		return variantAcc->getED( from, to );
+	}
+	return referenceAcc.getED( from, to );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+AccessibilityVariant::
+getMaxLength() const
+{
+	return referenceAcc.getMaxLength();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+inline
+const IndexRange &
+AccessibilityVariant::
+getAffectedRange() const
+{
+	return affected;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+inline
+const Accessibility &
+AccessibilityVariant::
+getAccessibilityReference() const
+{
+	return referenceAcc;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_ACCESSIBILITYVARIANT_H_ */
@@ -1,5 +1,6 @@
 
 #include "IntaRNA/AccessibilityVrna.h"
+#include "IntaRNA/AsyncLog.h"
 
 #include <cmath>
 #include <cassert>
@@ -13,6 +14,9 @@ extern "C" {
 	#include <ViennaRNA/fold.h>
 	#include <ViennaRNA/model.h>
 	#include <ViennaRNA/constraints/SHAPE.h>
+	#include <ViennaRNA/constraints/hard.h>
+	#include <ViennaRNA/constraints/soft.h>
+	#include <ViennaRNA/io/file_formats.h>
 }
 
 // RNAup-like ED filling
@@ -38,24 +42,80 @@ namespace IntaRNA {
 
 /////////////////////////////////////////////////////////////////////////////
 
+const size_t AccessibilityVrna::plFoldChunkLength = 10000;
+const size_t AccessibilityVrna::plFoldChunkWindows = 20;
+
+std::map< std::string, std::shared_ptr< const AccessibilityVrna::ShapeData > > AccessibilityVrna::shapeDataRead;
+
+/////////////////////////////////////////////////////////////////////////////
+
 AccessibilityVrna::AccessibilityVrna(
 			const RnaSequence& seq
 			, const size_t maxLength
 			, const AccessibilityConstraint * const accConstraint
 			, const VrnaHandler & vrnaHandler
 			, const size_t plFoldW
+			, const AccessibilityCache * const accCache
+			, const bool reducedPrecision
+			, const IndexRangeList * const computeRanges
 		)
  :
 	Accessibility( seq, maxLength, accConstraint ),
-	edValues( getSequence().size(), getSequence().size(), 0, getMaxLength() )
+	edValues(),
+	edRangeStart(),
+	edRangeValues()
 {
+	const size_t windowSize = (plFoldW==0? getSequence().size() : std::min(plFoldW,getSequence().size()));
+
+	// restrict computation to the padded ranges if SHAPE data is not to be
+	// used. since only windows overlapping a range contribute to its ED
+	// values, a padding by the window size yields the same values as a
+	// computation for the whole sequence (including the direct neighbors)
+	if (computeRanges != NULL && !computeRanges->empty() && getAccConstraint().getShapeFile().empty()) {
+		initRanges( *computeRanges, windowSize, reducedPrecision );
+	}
+	if (!edRangeStart.empty()) {
+		ASYNC_VLOG(2) <<"restricting accessibility computation to "<<edRangeStart.size()<<" ranges";
+		for (size_t r=0; r<edRangeStart.size(); r++) {
+			fillByRNAplfold(vrnaHandler
+					, windowSize
+					, getAccConstraint().getMaxBpSpan()
+					, IndexRange( edRangeStart[r], edRangeStart[r]+edRangeValues[r].getSeqLength()-1 )
+					, edRangeValues[r]
+					);
+		}
+		return;
+	}
+
+	// storage for the whole sequence
+	edValues.resize( getSequence().size(), getMaxLength(), reducedPrecision );
+
+	// check for ED values computed in former runs
+	std::string cacheKey;
+	if (accCache != NULL) {
+		cacheKey = AccessibilityCache::getKey( getSequence(), getAccConstraint(), getMaxLength(), windowSize, vrnaHandler );
+		if (accCache->read( cacheKey, edValues )) {
+			return;
+		}
+	}
 
 	// window-based accessibility computation
 	fillByRNAplfold(vrnaHandler
-			, (plFoldW==0? getSequence().size() : std::min(plFoldW,getSequence().size()))
+			, windowSize
 			, getAccConstraint().getMaxBpSpan()
+			, IndexRange( 0, getSequence().size()-1 )
+			, edValues
 			);
 
+	// store for later runs
+	if (accCache != NULL) {
+		accCache->write( cacheKey, edValues );
+		// use the storage shared with other processes instead of the own copy
+		if (accCache->isMappingEntries()) {
+			accCache->read( cacheKey, edValues );
+		}
+	}
+
 // fillByRNAplfold computation not threadsafe
 //#if INTARNA_MULITHREADING
 //		#pragma omp critical(intarna_omp_callingVRNA)
@@ -72,12 +132,43 @@ AccessibilityVrna::~AccessibilityVrna()
 {
 }
 
+/////////////////////////////////////////////////////////////////////////////
+
+void
+AccessibilityVrna::
+initRanges( const IndexRangeList & computeRanges, const size_t padding, const bool reducedPrecision )
+{
+	const size_t seqLength = getSequence().size();
+	// padded ranges, where overlapping or adjacent ranges are merged
+	std::vector< IndexRange > padded;
+	for (IndexRangeList::const_iterator r = computeRanges.begin(); r != computeRanges.end(); r++) {
+		const IndexRange cur( r->from > padding ? r->from - padding : 0
+							, std::min( seqLength-1, r->to + padding ) );
+		if (!padded.empty() && cur.from <= padded.rbegin()->to+1) {
+			padded.rbegin()->to = std::max( padded.rbegin()->to, cur.to );
+		} else {
+			padded.push_back( cur );
+		}
+	}
+	// check if the whole sequence is covered
+	if (padded.size() == 1 && padded.begin()->from == 0 && padded.begin()->to+1 == seqLength) {
+		return;
+	}
+	// setup storage
+	edRangeStart.resize( padded.size() );
+	edRangeValues.resize( padded.size() );
+	for (size_t r=0; r<padded.size(); r++) {
+		edRangeStart[r] = padded[r].from;
+		edRangeValues[r].resize( padded[r].to - padded[r].from + 1, getMaxLength(), reducedPrecision );
+	}
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 
 E_type
 AccessibilityVrna::
-calc_ensemble_free_energy( const int start_unfold, const int end_unfold, vrna_exp_param_s * partFoldParams )
+calc_ensemble_free_energy( const int start_unfold, const int end_unfold, vrna_fold_compound_t * foldCompound )
 {
 #if INTARNA_IN_DEBUG_MODE
 	if (start_unfold >= 0 && end_unfold >= 0) {
@@ -119,18 +210,15 @@ calc_ensemble_free_energy( const int start_unfold, const int end_unfold, vrna_ex
 
 	}
 
-	// Vienna RNA : get free energy of structure ensemble via partition function
-	// while applying the structure constraint for the unstructured region
-	const double energy = pf_fold_par(	getSequence().asString().c_str()
-										, c_structure
-										, partFoldParams
-										, 0
-										, (start_unfold==-1?0:1)
-										, 0
-									);
+	// reset constraints of former calls
+	vrna_hc_init( foldCompound );
+	// apply the structure constraint for the unstructured region
+	if (start_unfold != -1) {
+		vrna_constraints_add( foldCompound, c_structure, VRNA_CONSTRAINT_DB_DEFAULT );
+	}
 
-	// memory cleanup
-	free_pf_arrays();
+	// Vienna RNA : get free energy of structure ensemble via partition function
+	const double energy = vrna_pf( foldCompound, NULL );
 
 	return (E_type)energy;
 }
@@ -159,23 +247,20 @@ getPfScale( const RnaSequence & seq, const VrnaHandler & vrnaHandler
 	vrna_md_t curModel = vrnaHandler.getModel( plFoldL, seq.size() );
 
 	// Vienna RNA : get final folding parameters
-	paramT * foldParams = get_scaled_parameters( curModel.temperature, curModel );
+	std::shared_ptr<vrna_param_t> foldParams = vrnaHandler.getParams( plFoldL, seq.size() );
 
 	// Vienna RNA : get mfe value
 	char structure[len+1];
 	strncpy(structure, c_structure, len+1);
 	const double min_en = fold_par(	getSequence().asString().c_str()
 									, structure
-									, foldParams
+									, foldParams.get()
 									, 0
 									, 0
 								);
 	// memory cleanup
 	free_arrays();
 
-	// garbage collection
-	free(foldParams);
-
 	// compute a scaling factor to avoid overflow in partition function
 	return std::exp(-(curModel.sfact*min_en)/ vrnaHandler.getRT() /(double)len);
 
@@ -189,10 +274,7 @@ AccessibilityVrna::
 fillByConstraints( const VrnaHandler &vrnaHandler
 		, const size_t plFoldL )
 {
-#if INTARNA_MULITHREADING
-	#pragma omp critical(intarna_omp_logOutput)
-#endif
-	{ VLOG(2) <<"computing accessibility via n^2 fold calls..."; }
+	ASYNC_VLOG(2) <<"computing accessibility via n^2 fold calls...";
 	// time logging
 	TIMED_FUNC_IF(timerObj, VLOG_IS_ON(9));
 
@@ -203,17 +285,17 @@ fillByConstraints( const VrnaHandler &vrnaHandler
 	vrna_md_t curModel = vrnaHandler.getModel( plFoldL, seq.size() );
 
 	// Vienna RNA : get final partition function folding parameters
-	vrna_exp_param_s* partFoldParams
-		= get_boltzmann_factors( curModel.temperature
-								, curModel.betaScale
-								, curModel
-								, pfScale);
+	std::shared_ptr<vrna_exp_param_t> partFoldParams = vrnaHandler.getExpParams( plFoldL, seq.size(), pfScale );
+
+	const int seq_len = (int)getSequence().size();
+
+	// Vienna RNA : partition function setup
+	vrna_fold_compound_t * foldCompound = vrna_fold_compound( getSequence().asString().c_str(), &curModel, VRNA_OPTION_PF );
+	vrna_exp_params_subst( foldCompound, partFoldParams.get() );
 
 	// compute free energy of whole structure ensemble
-	E_type E_all = calc_ensemble_free_energy(-1, -1, partFoldParams);
+	E_type E_all = calc_ensemble_free_energy(-1, -1, foldCompound);
 
-	int count=0;
-	const int seq_len = (int)getSequence().size();
 	// compute ED values for _all_ regions [i,j]
 	for(int i=0; i<seq_len; i++)
 	{
@@ -224,15 +306,18 @@ fillByConstraints( const VrnaHandler &vrnaHandler
 			// check if ends are blocked
 			if (leftSideBlocked || getAccConstraint().isMarkedBlocked(j)) {
 				// region covers constrained elements --> set to upper bound
-				edValues(i,j) = ED_UPPER_BOUND;
+				edValues.set(i,j, ED_UPPER_BOUND);
 			} else {
 				// compute ED value = E(unstructured in [i,j]) - E_all
-				edValues(i,j) = std::max<E_type>(0.,(calc_ensemble_free_energy(i,j, partFoldParams) - E_all));
+				edValues.set(i,j, std::max<E_type>(0.,(calc_ensemble_free_energy(i,j, foldCompound) - E_all)));
 			}
 
 		}
 	}
 
+	// garbage collection
+	vrna_fold_compound_free( foldCompound );
+
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -250,16 +335,24 @@ callbackForStorage(FLT_OR_DBL   *pr,
 	if (type & (VRNA_PROBS_WINDOW_UP | VRNA_ANY_LOOP)) {
 
 		// access the storage data
-		std::pair< AccessibilityVrna*, double > storageRT = *((std::pair< AccessibilityVrna*, double >*)data);
+		const CallbackData & storage = *((const CallbackData*)data);
 		// direct data access for computation
-	    const double RT = storageRT.second;
-	    EdMatrix & edValues = storageRT.first->edValues;
-	    const AccessibilityConstraint & accConstr = storageRT.first->getAccConstraint();
+	    const double RT = storage.RT;
+	    EdMatrix & edValues = *(storage.edValues);
+	    const AccessibilityConstraint & accConstr = storage.acc->getAccConstraint();
+	    const size_t offset = storage.offset;
+
+	    // store only the regions ending within the requested range
+	    if (offset+j-1 < storage.storeFrom || offset+j-1 > storage.storeTo) {
+	    	return;
+	    }
+	    // index shift from the folded sequence to the ED matrix
+	    const size_t shift = offset - storage.edOffset;
 
 	    // copy unpaired data for all available interval lengths
 	    // but ensure interval does not contain blocked positions
-	    const bool rightEndBlocked = accConstr.isMarkedBlocked(j-1);
-	    for (int l = std::min(j,std::min(pr_size,std::min(max,(int)storageRT.first->getMaxLength()))); l>=1; l--) {
+	    const bool rightEndBlocked = accConstr.isMarkedBlocked(offset+j-1);
+	    for (int l = std::min(j,std::min(pr_size,std::min(max,(int)storage.acc->getMaxLength()))); l>=1; l--) {
 			// get unpaired probability
 			double prob_unpaired = pr[l];
 //			TODO: check for [0,1] range and correct if needed (print WARNING)
@@ -267,12 +360,12 @@ callbackForStorage(FLT_OR_DBL   *pr,
 			int i = j - l + 1;
 			// check if interval ends are blocked positions
 			// check if zero before computing its log-value
-			if (rightEndBlocked || accConstr.isMarkedBlocked(i-1) || (prob_unpaired == 0.0) ) {
+			if (rightEndBlocked || accConstr.isMarkedBlocked(offset+i-1) || (prob_unpaired == 0.0) ) {
 				// ED value = ED_UPPER_BOUND
-				edValues(i-1,j-1) = ED_UPPER_BOUND;
+				edValues.set(shift+i-1,shift+j-1, ED_UPPER_BOUND);
 			} else {
 				// compute ED value = E(unstructured in [i,j]) - E_all
-				edValues(i-1,j-1) = std::max<E_type>( 0., -RT*std::log(prob_unpaired));
+				edValues.set(shift+i-1,shift+j-1, std::max<E_type>( 0., -RT*std::log(prob_unpaired)));
 			}
 	    }
 
@@ -291,12 +384,11 @@ void
 AccessibilityVrna::
 fillByRNAplfold( const VrnaHandler &vrnaHandler
 		, const size_t plFoldW
-		, const size_t plFoldL )
+		, const size_t plFoldL
+		, const IndexRange & range
+		, EdMatrix & edToFill )
 {
-#if INTARNA_MULITHREADING
-	#pragma omp critical(intarna_omp_logOutput)
-#endif
-	{ VLOG(2) <<"computing accessibility via plfold routines...";}
+	ASYNC_VLOG(2) <<"computing accessibility via plfold routines...";
 	// time logging
 	TIMED_FUNC_IF(timerObj, VLOG_IS_ON(9));
 
@@ -306,18 +398,64 @@ fillByRNAplfold( const VrnaHandler &vrnaHandler
 	}
 #endif
 
+	const size_t length = range.to - range.from + 1;
+	const size_t windowSize = std::min( plFoldW, length );
+
 	// add maximal BP span
-	vrna_md_t curModel = vrnaHandler.getModel( plFoldL, plFoldW );
+	vrna_md_t curModel = vrnaHandler.getModel( plFoldL, windowSize );
+
+	// number of chunks folded independently; SHAPE data is given for the
+	// whole sequence and thus can not be applied to chunks
+	const size_t minChunkLength = std::max( plFoldChunkLength, plFoldChunkWindows*windowSize );
+	const size_t chunks = getAccConstraint().getShapeFile().empty()
+			? std::max( (size_t)1, length / minChunkLength )
+			: 1;
+	const size_t chunkLength = (length + chunks - 1) / chunks;
+
+	// fold the chunks extended by the window size on both sides, since only
+	// windows overlapping a region contribute to its ED values
+	size_t c;
+	for (c=0; c<chunks; c++) {
+#if INTARNA_MULITHREADING
+		#pragma omp task shared(curModel,range,edToFill) firstprivate(c) if(chunks > 1)
+#endif
+		{
+		const IndexRange store( range.from + c*chunkLength, std::min( range.to, range.from + (c+1)*chunkLength - 1 ) );
+		const IndexRange fold( store.from > range.from + windowSize ? store.from - windowSize : range.from
+							, std::min( range.to, store.to + windowSize ) );
+		fillByRNAplfold( vrnaHandler.getRT(), curModel, windowSize, fold, store, range.from, edToFill );
+		}
+	}
+#if INTARNA_MULITHREADING
+	#pragma omp taskwait
+#endif
+
+}
+
+///////////////////////////////////////////////////////////////////////////////
 
-	const int length = getSequence().size();
+void
+AccessibilityVrna::
+fillByRNAplfold( const double RT
+		, const vrna_md_t & model
+		, const size_t windowSize
+		, const IndexRange & fold
+		, const IndexRange & store
+		, const size_t edOffset
+		, EdMatrix & edToFill ) const
+{
+	const int length = fold.to - fold.from + 1;
 
 	// copy sequence into C data structure
 	char * sequence = (char *) vrna_alloc(sizeof(char) * (length + 1));
 	for (int i=0; i<length; i++) {
-		sequence[i] = getSequence().asString().at(i);
+		sequence[i] = getSequence().asString().at(fold.from+i);
 	}
 	sequence[length] = '\0';
 
+	// local copy since the fold compound setup takes a non-const model
+	vrna_md_t curModel = model;
+
     // setup folding data
     vrna_fold_compound_t * fold_compound = vrna_fold_compound( sequence, &curModel, VRNA_OPTION_PF | VRNA_OPTION_WINDOW );
 
@@ -327,7 +465,7 @@ fillByRNAplfold( const VrnaHandler &vrnaHandler
 		char * structure = structure = (char *) vrna_alloc(sizeof(char) * (length + 1));
 		for (int i=0; i<length; i++) {
 		// copy accessibility constraint
-		structure[i] = getAccConstraint().getVrnaDotBracket(i);
+		structure[i] = getAccConstraint().getVrnaDotBracket(fold.from+i);
 		}
 		// set array end indicator
 		structure[length] = '\0';
@@ -346,26 +484,40 @@ fillByRNAplfold( const VrnaHandler &vrnaHandler
 		// check if SHAPE reactivity data available
 		if (!getAccConstraint().getShapeFile().empty()) {
 
-			// add SHAPE reactivity data
-			// add SHAPE data as soft constraints
-			vrna_constraints_add_SHAPE(fold_compound,
-			                           getAccConstraint().getShapeFile().c_str(),
-			                           getAccConstraint().getShapeMethod().c_str(), // shape_method,
-			                           getAccConstraint().getShapeConversion().c_str(), // shape_conversion,
-			                           0, // verbose,
-			                           VRNA_OPTION_PF | VRNA_OPTION_WINDOW );
-
+			// add SHAPE data as soft constraints (as done by
+			// vrna_constraints_add_SHAPE() but using the data read once)
+			const std::shared_ptr< const ShapeData > shapeData = getShapeData();
+			const unsigned int shapeOptions = VRNA_OPTION_PF | VRNA_OPTION_WINDOW;
+			switch (shapeData->method) {
+			case 'D' :
+				vrna_sc_add_SHAPE_deigan( fold_compound, shapeData->reactivities.data()
+						, shapeData->param1, shapeData->param2, shapeOptions );
+				break;
+			case 'Z' :
+				vrna_sc_add_SHAPE_zarringhalam( fold_compound, shapeData->reactivities.data()
+						, shapeData->param1, 0.5, getAccConstraint().getShapeConversion().c_str(), shapeOptions );
+				break;
+			default : { // 'W'
+				// reactivities are directly used as pseudo energies
+				FLT_OR_DBL * pseudoE = (FLT_OR_DBL *) vrna_alloc(sizeof(FLT_OR_DBL) * (length + 1));
+				for (int i=0; i<length; i++) {
+					pseudoE[i] = shapeData->reactivities.at(i);
+				}
+				vrna_sc_set_up( fold_compound, pseudoE, shapeOptions );
+				free(pseudoE);
+				} break;
+			}
 
 		}
 	}
 
 
-    // provide access to this object to be filled by the callback
+    // provide access to the matrix to be filled by the callback
     // and the normalized temperature for the Boltzmann weight computation
-    std::pair< AccessibilityVrna*, double > storageRT(this, vrnaHandler.getRT());
+    CallbackData storage = { this, &edToFill, fold.from, edOffset, store.from, store.to, RT };
 
 	// call folding and unpaired prob calculation
-    vrna_probs_window( fold_compound, plFoldW, VRNA_PROBS_WINDOW_UP, &callbackForStorage, (void*)(&storageRT));
+    vrna_probs_window( fold_compound, (int)windowSize, VRNA_PROBS_WINDOW_UP, &callbackForStorage, (void*)(&storage));
 
 
     // garbage collection
@@ -375,6 +527,55 @@ fillByRNAplfold( const VrnaHandler &vrnaHandler
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+
+std::shared_ptr< const AccessibilityVrna::ShapeData >
+AccessibilityVrna::
+getShapeData() const
+{
+	const std::string & shapeFile = getAccConstraint().getShapeFile();
+	const std::string & shapeMethod = getAccConstraint().getShapeMethod();
+	const std::string key = shapeFile + '\n' + shapeMethod + '\n' + toString(getSequence().size());
+
+	std::shared_ptr< const ShapeData > shapeData;
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_shapeDataRead)
+#endif
+	{
+		auto known = shapeDataRead.find( key );
+		if (known != shapeDataRead.end()) {
+			shapeData = known->second;
+		}
+	} // omp critical(intarna_omp_shapeDataRead)
+	if (shapeData) {
+		return shapeData;
+	}
+
+	// parse method
+	ShapeData * newData = new ShapeData();
+	if (!vrna_sc_SHAPE_parse_method( shapeMethod.c_str(), &(newData->method), &(newData->param1), &(newData->param2) )) {
+		delete newData;
+		throw std::runtime_error("AccessibilityVrna : SHAPE method '"+shapeMethod+"' not recognized");
+	}
+	// read reactivities; missing values are ignored by all but method 'W',
+	// where they are used as pseudo energies
+	const int length = (int)getSequence().size();
+	newData->reactivities.resize( length+1, 0 );
+	char * sequence = (char *) vrna_alloc(sizeof(char) * (length + 1));
+	vrna_file_SHAPE_read( shapeFile.c_str(), length, newData->method == 'W' ? 0 : -1, sequence, newData->reactivities.data() );
+	free(sequence);
+	shapeData.reset( newData );
+
+	// store for reuse; keep data of a concurrent reader if any
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_shapeDataRead)
+#endif
+	{
+		shapeData = shapeDataRead.insert( std::make_pair( key, shapeData ) ).first->second;
+	} // omp critical(intarna_omp_shapeDataRead)
+	return shapeData;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 
@@ -383,10 +584,7 @@ AccessibilityVrna::
 fillByRNAup( const VrnaHandler &vrnaHandler
 			, const size_t plFoldL )
 {
-#if INTARNA_MULITHREADING
-	#pragma omp critical(intarna_omp_logOutput)
-#endif
-	{ VLOG(2) <<"computing accessibility via RNAup routines..."; }
+	ASYNC_VLOG(2) <<"computing accessibility via RNAup routines...";
 	// time logging
 	TIMED_FUNC_IF(timerObj, VLOG_IS_ON(9));
 
@@ -444,7 +642,7 @@ fillByRNAup( const VrnaHandler &vrnaHandler
 			// check if region ends are blocked
 			if (leftSideBlocked || getAccConstraint().isMarkedBlocked(j-1)) {
 				// region ends blocked --> set to upper bound
-				edValues(i-1,j-1) = ED_UPPER_BOUND;
+				edValues.set(i-1,j-1, ED_UPPER_BOUND);
 			} else {
 				// compute overall unpaired probability
 				double prob_unpaired =
@@ -455,10 +653,10 @@ fillByRNAup( const VrnaHandler &vrnaHandler
 				// check if zero before computing its log-value
 				if ( prob_unpaired == 0.0 ) {
 					// ED value = ED_UPPER_BOUND
-					edValues(i-1,j-1) = ED_UPPER_BOUND;
+					edValues.set(i-1,j-1, ED_UPPER_BOUND);
 				} else {
 					// compute ED value = E(unstructured in [i,j]) - E_all
-					edValues(i-1,j-1) = std::max<E_type>( 0., -RT*std::log(prob_unpaired));
+					edValues.set(i-1,j-1, std::max<E_type>( 0., -RT*std::log(prob_unpaired)));
 				}
 			}
 		}
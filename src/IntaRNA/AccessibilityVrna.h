@@ -4,10 +4,16 @@
 
 #include "IntaRNA/Accessibility.h"
 #include "IntaRNA/VrnaHandler.h"
+#include "IntaRNA/AccessibilityCache.h"
+#include "IntaRNA/EdBandMatrix.h"
+#include "IntaRNA/IndexRangeList.h"
 
-#include <boost/numeric/ublas/banded.hpp>
-
+#include <algorithm>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
 
 
 extern "C" {
@@ -39,12 +45,23 @@ public:
 	 *        to be unstructured both in sequence and interaction
 	 * @param vrnaHandler the VRNA parameter handler to be used
 	 * @param plFoldW the sliding window size to be used for plFold computations
+	 * @param accCache if not NULL, the ED values are read from this cache if
+	 *        available; otherwise the computed values are stored within it
+	 * @param reducedPrecision whether or not ED values are stored in reduced
+	 *        precision (see EdBandMatrix) to lower the memory consumption
+	 * @param computeRanges if not NULL, ED values are only computed and
+	 *        stored for these (sorted) ranges padded by the window size; for
+	 *        all other regions ED_UPPER_BOUND is returned. Not applicable
+	 *        for SHAPE data and not supported by the accessibility cache.
 	 */
 	AccessibilityVrna( const RnaSequence& sequence
 			, const size_t maxLength
 			, const AccessibilityConstraint * const accConstraint
 			, const VrnaHandler & vrnaHandler
 			, const size_t plFoldW = 0
+			, const AccessibilityCache * const accCache = NULL
+			, const bool reducedPrecision = false
+			, const IndexRangeList * const computeRanges = NULL
 			);
 
 	/**
@@ -69,12 +86,98 @@ public:
 
 protected:
 
-	//! type for the ED value matrix (upper triangular matrix banded by maxLength)
-	typedef boost::numeric::ublas::banded_matrix<E_type> EdMatrix;
+	//! type for the ED value matrix (band of width maxLength)
+	typedef EdBandMatrix EdMatrix;
 
-	//! the ED values for the given sequence
+	//! the ED values for the given sequence (empty if edRangeValues used)
 	EdMatrix edValues;
 
+	//! (sorted) start indices of the ranges with restricted ED computation
+	std::vector< size_t > edRangeStart;
+
+	//! the ED values of each restricted range (relative to its start index)
+	std::vector< EdMatrix > edRangeValues;
+
+	//! minimal length of the sequence chunks folded independently by
+	//! fillByRNAplfold()
+	static const size_t plFoldChunkLength;
+
+	//! minimal length of the sequence chunks folded independently by
+	//! fillByRNAplfold() in multiples of the window size
+	static const size_t plFoldChunkWindows;
+
+	//! SHAPE reactivity data of a sequence as read from file
+	struct ShapeData {
+		//! the method to convert the reactivities into pseudo energies
+		char method;
+		//! first parameter of the method
+		float param1;
+		//! second parameter of the method
+		float param2;
+		//! the (1-based) reactivity values for each sequence position
+		std::vector<double> reactivities;
+	};
+
+	//! the SHAPE data read so far, indexed by file name, method and sequence
+	//! length, which is shared by all accessibility computations
+	static std::map< std::string, std::shared_ptr< const ShapeData > > shapeDataRead;
+
+	/**
+	 * Provides the SHAPE data of the accessibility constraint. The data file is
+	 * only read and parsed by the first call for a file, method and sequence
+	 * length; all later calls (e.g. for sequence variants) share the data.
+	 *
+	 * @return the SHAPE data
+	 *
+	 * @throw std::runtime_error if the method is not supported
+	 */
+	std::shared_ptr< const ShapeData >
+	getShapeData() const;
+
+	//! data provided to callbackForStorage()
+	struct CallbackData {
+		//! the accessibility object the ED values are computed for
+		const AccessibilityVrna * acc;
+		//! the ED matrix to fill
+		EdMatrix * edValues;
+		//! the sequence index of the first nucleotide of the folded sequence
+		size_t offset;
+		//! the sequence index of the first nucleotide of the ED matrix
+		size_t edOffset;
+		//! the sequence index range of the region ends to be stored
+		size_t storeFrom;
+		size_t storeTo;
+		//! the normalized temperature for the Boltzmann weight computation
+		double RT;
+	};
+
+	/**
+	 * Sets up the padded and merged ranges for restricted ED computation.
+	 * If they cover the whole sequence, no ranges are set up.
+	 *
+	 * @param computeRanges the sorted ranges ED values are needed for
+	 * @param padding the number of positions to extend each range on both
+	 *        sides (clipped at the sequence boundaries)
+	 * @param reducedPrecision whether or not ED values are stored in reduced
+	 *        precision
+	 */
+	void
+	initRanges( const IndexRangeList & computeRanges
+				, const size_t padding
+				, const bool reducedPrecision );
+
+	/**
+	 * Access to the ED value of a region in restricted computation mode.
+	 *
+	 * @param from the start index of the regions (from <= to)
+	 * @param to the end index of the regions (to < seq.length)
+	 *
+	 * @return the ED value if the region is within a computed range;
+	 *         ED_UPPER_BOUND otherwise
+	 */
+	E_type
+	getRangeED( const size_t from, const size_t to ) const;
+
 	/**
 	 * Computes the free energy of the structure ensemble that is unstructured
 	 * in the region [start_unfold,end_unfold] including the boundaries.
@@ -85,7 +188,9 @@ protected:
 	 * structure constraint is to be set
 	 * @param end_unfold last position to be unstructured, or -1 if no
 	 * structure constraint is to be set
-	 * @param partFoldParams the folding parameters to be used
+	 * @param foldCompound the VRNA fold compound (setup for partition
+	 *        function computation) to be used; its hard constraints are
+	 *        overwritten. Has to be exclusive to the calling thread.
 	 *
 	 * @return the energy of the structure ensemble
 	 */
@@ -93,7 +198,7 @@ protected:
 	calc_ensemble_free_energy(
 			const int start_unfold
 			, const int end_unfold
-			, vrna_exp_param_s * partFoldParams
+			, vrna_fold_compound_t * foldCompound
 			);
 
 	/**
@@ -133,14 +238,48 @@ protected:
 	/**
 	 * Use RNAplfold-like style to fill ED-values
 	 *
+	 * Long ranges are cut into chunks (see plFoldChunkLength) that are
+	 * extended by the window size on both sides and folded independently
+	 * (as parallel tasks if compiled with multi-threading support). Since
+	 * only windows overlapping a region contribute to its ED value, this
+	 * yields the same values as a single fold of the whole range.
+	 *
 	 * @param vrnaHandler the VRNA handler to be used
 	 * @param plFoldW the sliding window size to be used or 0 for full length
 	 * @param plFoldL the maximal base pair span to be used or 0 for plFoldW
+	 * @param range the sequence range to be folded
+	 * @param edToFill the ED matrix to fill for the range (indexed relative
+	 *        to range.from)
 	 */
 	void
 	fillByRNAplfold( const VrnaHandler &vrnaHandler
 						, const size_t plFoldW
-						, const size_t plFoldL );
+						, const size_t plFoldL
+						, const IndexRange & range
+						, EdMatrix & edToFill );
+
+	/**
+	 * Folds a sequence range via vrna_probs_window() and stores the ED
+	 * values of all regions ending within a given subrange.
+	 *
+	 * @param RT the normalized temperature for the Boltzmann weights
+	 * @param model the VRNA model to be used
+	 * @param windowSize the sliding window size to be used
+	 * @param fold the sequence range to be folded
+	 * @param store the sequence range of the region ends to be stored
+	 *        (within fold)
+	 * @param edOffset the sequence index of the first position of edToFill
+	 *        (at most fold.from)
+	 * @param edToFill the ED matrix to fill
+	 */
+	void
+	fillByRNAplfold( const double RT
+						, const vrna_md_t & model
+						, const size_t windowSize
+						, const IndexRange & fold
+						, const IndexRange & store
+						, const size_t edOffset
+						, EdMatrix & edToFill ) const;
 
 	/**
 	 * callback function used when calling vrna_probs_window()
@@ -157,7 +296,7 @@ protected:
 	 * @param j       The j-position (3'-end) of the probability intervals (indexing starting with 1)
 	 * @param max     The (theoretical) maximum length of the probability array
 	 * @param type    The type of probability that is passed to this function
-	 * @param storageRT    Auxiliary data: should hold a pair(AccessibilityVrna*,double RT)
+	 * @param storageRT    Auxiliary data: should hold a CallbackData object
 	 *
 	 */
 	static
@@ -191,7 +330,10 @@ getED( const size_t from, const size_t to ) const
 			return ED_UPPER_BOUND;
 		}
 		// return according ED value from the precomputed matrix
-		return edValues (from,to);
+		if (edRangeStart.empty()) {
+			return edValues.get(from,to);
+		}
+		return getRangeED(from,to);
 	} else {
 		// region length exceeds maximally allowed length -> no value
 		return ED_UPPER_BOUND;
@@ -200,6 +342,26 @@ getED( const size_t from, const size_t to ) const
 
 /////////////////////////////////////////////////////////////////////////////
 
+inline
+E_type
+AccessibilityVrna::
+getRangeED( const size_t from, const size_t to ) const
+{
+	// find last range starting at or before from
+	const std::vector< size_t >::const_iterator start = std::upper_bound( edRangeStart.begin(), edRangeStart.end(), from );
+	if (start == edRangeStart.begin()) {
+		return ED_UPPER_BOUND;
+	}
+	const size_t r = (size_t)(start - edRangeStart.begin()) - 1;
+	// check if region ends within the range
+	if (to - edRangeStart[r] >= edRangeValues[r].getSeqLength()) {
+		return ED_UPPER_BOUND;
+	}
+	return edRangeValues[r].get( from-edRangeStart[r], to-edRangeStart[r] );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 } // namespace
 
 #endif /* ACCESSIBILITYVIENNA_H_ */
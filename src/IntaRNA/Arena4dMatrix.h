@@ -0,0 +1,429 @@
+
+#ifndef INTARNA_ARENA4DMATRIX_H_
+#define INTARNA_ARENA4DMATRIX_H_
+
+#include "IntaRNA/general.h"
+#include "IntaRNA/HugePageAllocator.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace IntaRNA {
+
+/**
+ * 4D matrix that provides for each index combination (i1,i2) an optional
+ * 2D block of individual dimensions. All blocks are stored within one
+ * contiguous arena, which is allocated once via allocate() after all block
+ * dimensions have been registered via reserveBlock(). The arena's memory is
+ * kept and reused by subsequent resize() and allocate() calls.
+ *
+ * Access to a block is given via operator()(i1,i2), which returns NULL if
+ * no block was reserved for (i1,i2), e.g.
+ *
+ *   if (matrix(i1,i2) != NULL) { (*matrix(i1,i2))(w1,w2) = value; }
+ *
+ */
+template < typename T >
+class Arena4dMatrix {
+
+public:
+
+	/**
+	 * A 2D block of the matrix that refers to a part of the arena
+	 */
+	class Block {
+
+		//! the matrix manages the data reference
+		friend class Arena4dMatrix;
+
+	public:
+
+		/**
+		 * Construction of an empty block
+		 */
+		Block();
+
+		/**
+		 * Access to the first dimension of the block
+		 * @return the number of rows
+		 */
+		size_t
+		size1() const;
+
+		/**
+		 * Access to the second dimension of the block
+		 * @return the number of columns
+		 */
+		size_t
+		size2() const;
+
+		/**
+		 * Access to an element of the block
+		 * @param w1 the row index
+		 * @param w2 the column index
+		 * @return the according element
+		 */
+		T &
+		operator()( const size_t w1, const size_t w2 );
+
+		/**
+		 * Access to an element of the block
+		 * @param w1 the row index
+		 * @param w2 the column index
+		 * @return the according element
+		 */
+		const T &
+		operator()( const size_t w1, const size_t w2 ) const;
+
+	protected:
+
+		//! offset of the block within the arena
+		size_t offset;
+
+		//! the first element of the block (NULL if not allocated)
+		T * data;
+
+		//! number of rows
+		size_t rows;
+
+		//! number of columns
+		size_t cols;
+
+	};
+
+public:
+
+	/**
+	 * Construction of an empty matrix
+	 */
+	Arena4dMatrix();
+
+	/**
+	 * Resizes the first two dimensions of the matrix. All blocks are removed,
+	 * while the memory of the arena is kept for reuse.
+	 * @param size1 the first dimension
+	 * @param size2 the second dimension
+	 */
+	void
+	resize( const size_t size1, const size_t size2 );
+
+	/**
+	 * Removes all blocks and resets the dimensions to 0 but keeps the memory
+	 * of the arena for reuse.
+	 */
+	void
+	clear();
+
+	/**
+	 * Access to the first dimension
+	 * @return the first dimension
+	 */
+	size_t
+	size1() const;
+
+	/**
+	 * Access to the second dimension
+	 * @return the second dimension
+	 */
+	size_t
+	size2() const;
+
+	/**
+	 * Registers a block for (i1,i2) with the given dimensions. The block can
+	 * be accessed after the next call of allocate().
+	 *
+	 * @param i1 the first index
+	 * @param i2 the second index
+	 * @param w1 the number of rows of the block (>0)
+	 * @param w2 the number of columns of the block (>0)
+	 *
+	 * @throw std::runtime_error if a block for (i1,i2) was already reserved
+	 *        or the blocks are already allocated
+	 */
+	void
+	reserveBlock( const size_t i1, const size_t i2, const size_t w1, const size_t w2 );
+
+	/**
+	 * Allocates the arena for all reserved blocks via a single allocation
+	 * (if the memory of previous calls is not sufficient). All block
+	 * elements are (re)set to T(), i.e. no values of previous calls remain.
+	 */
+	void
+	allocate();
+
+	/**
+	 * Access to the number of elements of all reserved blocks
+	 * @return the overall number of block elements
+	 */
+	size_t
+	getBlockCells() const;
+
+	/**
+	 * Access to the block for (i1,i2)
+	 * @param i1 the first index
+	 * @param i2 the second index
+	 * @return the block or NULL if no block was reserved
+	 */
+	Block *
+	operator()( const size_t i1, const size_t i2 );
+
+	/**
+	 * Access to the block for (i1,i2)
+	 * @param i1 the first index
+	 * @param i2 the second index
+	 * @return the block or NULL if no block was reserved
+	 */
+	const Block *
+	operator()( const size_t i1, const size_t i2 ) const;
+
+protected:
+
+	//! first dimension
+	size_t rows;
+
+	//! second dimension
+	size_t cols;
+
+	//! the blocks for all (i1,i2) in row-major order
+	std::vector<Block> blocks;
+
+	//! the overall number of elements of all reserved blocks
+	size_t blockCells;
+
+	//! whether or not the arena has been assigned to the blocks
+	bool allocated;
+
+	//! the arena holding the elements of all blocks
+	typename HugePageAllocator<T>::vector arena;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+
+template < typename T >
+inline
+Arena4dMatrix<T>::Block::
+Block()
+ :	offset(0)
+	, data(NULL)
+	, rows(0)
+	, cols(0)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < typename T >
+inline
+size_t
+Arena4dMatrix<T>::Block::
+size1() const
+{
+	return rows;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < typename T >
+inline
+size_t
+Arena4dMatrix<T>::Block::
+size2() const
+{
+	return cols;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < typename T >
+inline
+T &
+Arena4dMatrix<T>::Block::
+operator()( const size_t w1, const size_t w2 )
+{
+#if INTARNA_IN_DEBUG_MODE
+	if (w1 >= rows || w2 >= cols) {
+		throw std::runtime_error("Arena4dMatrix::Block("+toString(w1)+","+toString(w2)+") is out of range");
+	}
+#endif
+	return data[w1*cols+w2];
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < typename T >
+inline
+const T &
+Arena4dMatrix<T>::Block::
+operator()( const size_t w1, const size_t w2 ) const
+{
+#if INTARNA_IN_DEBUG_MODE
+	if (w1 >= rows || w2 >= cols) {
+		throw std::runtime_error("Arena4dMatrix::Block("+toString(w1)+","+toString(w2)+") is out of range");
+	}
+#endif
+	return data[w1*cols+w2];
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < typename T >
+inline
+Arena4dMatrix<T>::
+Arena4dMatrix()
+ :	rows(0)
+	, cols(0)
+	, blocks()
+	, blockCells(0)
+	, allocated(false)
+	, arena()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < typename T >
+inline
+void
+Arena4dMatrix<T>::
+resize( const size_t size1, const size_t size2 )
+{
+	rows = size1;
+	cols = size2;
+	blocks.assign( size1*size2, Block() );
+	blockCells = 0;
+	allocated = false;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < typename T >
+inline
+void
+Arena4dMatrix<T>::
+clear()
+{
+	resize( 0, 0 );
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < typename T >
+inline
+size_t
+Arena4dMatrix<T>::
+size1() const
+{
+	return rows;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < typename T >
+inline
+size_t
+Arena4dMatrix<T>::
+size2() const
+{
+	return cols;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < typename T >
+inline
+void
+Arena4dMatrix<T>::
+reserveBlock( const size_t i1, const size_t i2, const size_t w1, const size_t w2 )
+{
+#if INTARNA_IN_DEBUG_MODE
+	if (i1 >= rows || i2 >= cols) {
+		throw std::runtime_error("Arena4dMatrix::reserveBlock("+toString(i1)+","+toString(i2)+") is out of range");
+	}
+#endif
+	Block & block = blocks[i1*cols+i2];
+	if (allocated || block.rows > 0) {
+		throw std::runtime_error("Arena4dMatrix::reserveBlock("+toString(i1)+","+toString(i2)+") : block already reserved or allocated");
+	}
+	block.offset = blockCells;
+	block.rows = w1;
+	block.cols = w2;
+	blockCells += w1*w2;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < typename T >
+inline
+void
+Arena4dMatrix<T>::
+allocate()
+{
+	// single (re)allocation if the current arena is not sufficient
+	if (arena.size() < blockCells) {
+		arena.resize( blockCells );
+	}
+	// reset the memory of the blocks (might hold data of previous calls)
+	std::fill( arena.begin(), arena.begin()+blockCells, T() );
+	// assign memory to all reserved blocks
+	for (typename std::vector<Block>::iterator b = blocks.begin(); b != blocks.end(); b++) {
+		if (b->rows > 0) {
+			b->data = &(arena[b->offset]);
+		}
+	}
+	allocated = true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < typename T >
+inline
+size_t
+Arena4dMatrix<T>::
+getBlockCells() const
+{
+	return blockCells;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < typename T >
+inline
+typename Arena4dMatrix<T>::Block *
+Arena4dMatrix<T>::
+operator()( const size_t i1, const size_t i2 )
+{
+#if INTARNA_IN_DEBUG_MODE
+	if (i1 >= rows || i2 >= cols) {
+		throw std::runtime_error("Arena4dMatrix("+toString(i1)+","+toString(i2)+") is out of range");
+	}
+#endif
+	Block & block = blocks[i1*cols+i2];
+	return block.data == NULL ? NULL : &block;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < typename T >
+inline
+const typename Arena4dMatrix<T>::Block *
+Arena4dMatrix<T>::
+operator()( const size_t i1, const size_t i2 ) const
+{
+#if INTARNA_IN_DEBUG_MODE
+	if (i1 >= rows || i2 >= cols) {
+		throw std::runtime_error("Arena4dMatrix("+toString(i1)+","+toString(i2)+") is out of range");
+	}
+#endif
+	const Block & block = blocks[i1*cols+i2];
+	return block.data == NULL ? NULL : &block;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_ARENA4DMATRIX_H_ */
@@ -0,0 +1,239 @@
+
+#include "IntaRNA/AsyncLog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace IntaRNA {
+
+////////////////////////////////////////////////////////////////////////////
+
+std::deque< AsyncLog::Buffer > AsyncLog::buffers;
+
+std::mutex AsyncLog::buffersMutex;
+
+std::atomic< bool > AsyncLog::running( false );
+
+bool AsyncLog::stopping = false;
+
+std::condition_variable AsyncLog::stopRequested;
+
+std::thread AsyncLog::writer;
+
+std::atomic< uint64_t > AsyncLog::issued( 0 );
+
+std::atomic< size_t > AsyncLog::written( 0 );
+
+//! the message buffer of the current thread or NULL if not registered yet
+static thread_local void * currentBuffer = NULL;
+
+////////////////////////////////////////////////////////////////////////////
+
+AsyncLog::Message::
+Message( const el::Level level, const int verboseLevel )
+ :	level(level)
+	, verboseLevel(verboseLevel)
+	, message()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+AsyncLog::Message::
+~Message()
+{
+	AsyncLog::log( level, verboseLevel, message.str() );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+std::ostream &
+AsyncLog::Message::
+stream()
+{
+	return message;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+AsyncLog::
+start( const size_t flushInterval )
+{
+#if INTARNA_MULITHREADING
+	std::lock_guard<std::mutex> lock(buffersMutex);
+	if (running) {
+		return;
+	}
+	stopping = false;
+	writer = std::thread( &AsyncLog::writeMessages, std::max((size_t)1,flushInterval) );
+	running = true;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+AsyncLog::
+stop()
+{
+#if INTARNA_MULITHREADING
+	{
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		if (!running) {
+			return;
+		}
+		// direct output of further messages
+		running = false;
+		stopping = true;
+	}
+	stopRequested.notify_one();
+	if (writer.joinable()) {
+		writer.join();
+	}
+	// write messages buffered meanwhile
+	flush();
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+AsyncLog::
+isRunning()
+{
+	return running;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+size_t
+AsyncLog::
+getWritten()
+{
+	return written;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+AsyncLog::
+log( const el::Level level, const int verboseLevel, const std::string & message )
+{
+	if (!running) {
+		// direct output
+#if INTARNA_MULITHREADING
+		#pragma omp critical(intarna_omp_logOutput)
+#endif
+		{ write( level, verboseLevel, message ); }
+		return;
+	}
+
+	// register buffer of this thread if needed
+	if (currentBuffer == NULL) {
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		buffers.emplace_back();
+		buffers.back().last = NULL;
+		currentBuffer = (void*)&(buffers.back());
+	}
+	Buffer & buffer = *((Buffer*)currentBuffer);
+
+	// prepend message to the list of the thread
+	Entry * entry = new Entry();
+	entry->level = level;
+	entry->verboseLevel = verboseLevel;
+	entry->number = issued++;
+	entry->message = message;
+	entry->next = buffer.last.load();
+	// only the background thread might have taken the list meanwhile
+	while (!buffer.last.compare_exchange_weak( entry->next, entry )) {}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+AsyncLog::
+writeMessages( const size_t flushInterval )
+{
+	std::unique_lock<std::mutex> lock(buffersMutex);
+	while (!stopping) {
+		stopRequested.wait_for( lock, std::chrono::milliseconds(flushInterval) );
+		lock.unlock();
+		flush();
+		lock.lock();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+AsyncLog::
+flush()
+{
+	// take the lists of all threads
+	std::vector< Entry * > entries;
+	{
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		for (auto b = buffers.begin(); b != buffers.end(); b++) {
+			for (Entry * e = b->last.exchange( NULL ); e != NULL; e = e->next) {
+				entries.push_back( e );
+			}
+		}
+	}
+	if (entries.empty()) {
+		return;
+	}
+
+	// restore order of issuing
+	std::sort( entries.begin(), entries.end(), &AsyncLog::issuedBefore );
+
+	// write messages
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_logOutput)
+#endif
+	{
+		for (auto e = entries.begin(); e != entries.end(); e++) {
+			write( (*e)->level, (*e)->verboseLevel, (*e)->message );
+		}
+	}
+	for (auto e = entries.begin(); e != entries.end(); e++) {
+		delete *e;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+AsyncLog::
+issuedBefore( const Entry * a, const Entry * b )
+{
+	return a->number < b->number;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+AsyncLog::
+write( const el::Level level, const int verboseLevel, const std::string & message )
+{
+	switch (level) {
+	case el::Level::Verbose :
+		VLOG(verboseLevel) <<message;
+		break;
+	case el::Level::Info :
+		LOG(INFO) <<message;
+		break;
+	case el::Level::Warning :
+		LOG(WARNING) <<message;
+		break;
+	default :
+		LOG(ERROR) <<message;
+		break;
+	}
+	written++;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
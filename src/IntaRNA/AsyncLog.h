@@ -0,0 +1,229 @@
+
+#ifndef INTARNA_ASYNCLOG_H_
+#define INTARNA_ASYNCLOG_H_
+
+#include "IntaRNA/general.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace IntaRNA {
+
+/**
+ * Asynchronous logging back end for log messages issued within parallel
+ * computations.
+ *
+ * Messages are formatted by the issuing thread into a message buffer of its
+ * own. Buffers are lists that are extended without locking and that are
+ * emptied by a background thread (started via start()), which writes the
+ * collected messages (ordered by their issuing) via easylogging++. Thus,
+ * threads neither wait for each other nor for the log formatting and output
+ * of easylogging++.
+ *
+ * If the background thread is not running, messages are written directly
+ * (synchronized via omp critical(intarna_omp_logOutput) as all other log
+ * output).
+ *
+ * Use the ASYNC_LOG(LEVEL) and ASYNC_VLOG(vlevel) macros instead of LOG()
+ * and VLOG(), where LEVEL is one of INFO, WARNING or ERROR.
+ *
+ * All static member functions are thread-safe.
+ *
+ */
+class AsyncLog {
+
+public:
+
+	/**
+	 * A log message that is handed over to the message buffer of the
+	 * current thread on destruction.
+	 */
+	class Message {
+
+	public:
+
+		/**
+		 * Construction
+		 * @param level the log level of the message
+		 * @param verboseLevel the verbose level if level is el::Level::Verbose
+		 */
+		Message( const el::Level level, const int verboseLevel = 0 );
+
+		/**
+		 * Destruction; hands over the message.
+		 */
+		~Message();
+
+		/**
+		 * Access to the stream to compose the message
+		 * @return the message stream
+		 */
+		std::ostream &
+		stream();
+
+	protected:
+
+		//! the log level
+		const el::Level level;
+
+		//! the verbose level
+		const int verboseLevel;
+
+		//! the composed message
+		std::ostringstream message;
+
+	};
+
+public:
+
+	/**
+	 * Starts the background thread that writes the buffered messages, if not
+	 * already running. Without multi-threading support, messages are always
+	 * written directly.
+	 *
+	 * @param flushInterval the maximal time (in milliseconds) buffered
+	 *        messages wait for their output
+	 */
+	static
+	void
+	start( const size_t flushInterval = 100 );
+
+	/**
+	 * Writes all buffered messages and stops the background thread, if
+	 * running. Afterwards, messages are written directly.
+	 */
+	static
+	void
+	stop();
+
+	/**
+	 * Whether or not the background thread is running
+	 * @return true if messages are buffered; false if written directly
+	 */
+	static
+	bool
+	isRunning();
+
+	/**
+	 * Provides the number of messages written so far.
+	 * @return the number of written messages
+	 */
+	static
+	size_t
+	getWritten();
+
+	/**
+	 * Hands over a message for output.
+	 * @param level the log level of the message
+	 * @param verboseLevel the verbose level if level is el::Level::Verbose
+	 * @param message the message to log
+	 */
+	static
+	void
+	log( const el::Level level, const int verboseLevel, const std::string & message );
+
+protected:
+
+	//! a buffered message
+	struct Entry {
+		//! the log level
+		el::Level level;
+		//! the verbose level
+		int verboseLevel;
+		//! the position of the message in the order of issuing
+		uint64_t number;
+		//! the message
+		std::string message;
+		//! the previously buffered message of the same thread or NULL
+		Entry * next;
+	};
+
+	//! the message buffer of a thread, i.e. a list of its messages
+	struct Buffer {
+		//! the most recently buffered message or NULL
+		std::atomic< Entry * > last;
+	};
+
+	//! the message buffers of all threads (deque to keep the buffers in place)
+	static std::deque< Buffer > buffers;
+
+	//! guards the registration of buffers and the start and stop
+	static std::mutex buffersMutex;
+
+	//! whether or not the background thread is running
+	static std::atomic< bool > running;
+
+	//! whether or not the background thread is to be stopped
+	static bool stopping;
+
+	//! signals the stop to the background thread
+	static std::condition_variable stopRequested;
+
+	//! the background thread
+	static std::thread writer;
+
+	//! the number of messages issued so far
+	static std::atomic< uint64_t > issued;
+
+	//! the number of messages written so far
+	static std::atomic< size_t > written;
+
+	/**
+	 * Main loop of the background thread, i.e. writes the buffered messages
+	 * in the given interval until stopped.
+	 * @param flushInterval the interval in milliseconds
+	 */
+	static
+	void
+	writeMessages( const size_t flushInterval );
+
+	/**
+	 * Takes all messages from the buffers and writes them in the order of
+	 * their issuing.
+	 */
+	static
+	void
+	flush();
+
+	/**
+	 * Order of messages by their issuing
+	 * @param a the first message
+	 * @param b the second message
+	 * @return true if a was issued before b
+	 */
+	static
+	bool
+	issuedBefore( const Entry * a, const Entry * b );
+
+	/**
+	 * Writes a message via easylogging++ (not synchronized).
+	 * @param level the log level of the message
+	 * @param verboseLevel the verbose level if level is el::Level::Verbose
+	 * @param message the message to log
+	 */
+	static
+	void
+	write( const el::Level level, const int verboseLevel, const std::string & message );
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+//! log message of a given LEVEL (INFO, WARNING or ERROR) via AsyncLog
+#define ASYNC_LOG(LEVEL) ASYNC_LOG_##LEVEL
+#define ASYNC_LOG_INFO IntaRNA::AsyncLog::Message( el::Level::Info ).stream()
+#define ASYNC_LOG_WARNING IntaRNA::AsyncLog::Message( el::Level::Warning ).stream()
+#define ASYNC_LOG_ERROR IntaRNA::AsyncLog::Message( el::Level::Error ).stream()
+
+//! verbose log message of a given level via AsyncLog
+#define ASYNC_VLOG(vlevel) if (!VLOG_IS_ON(vlevel)) {} else IntaRNA::AsyncLog::Message( el::Level::Verbose, vlevel ).stream()
+
+#endif /* INTARNA_ASYNCLOG_H_ */
@@ -0,0 +1,256 @@
+
+#include "IntaRNA/AsyncOutputStream.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace IntaRNA {
+
+////////////////////////////////////////////////////////////////////////////
+
+const size_t AsyncOutputBuffer::defaultChunkSize = 1 << 20;
+const size_t AsyncOutputBuffer::defaultMaxQueued = 16;
+
+////////////////////////////////////////////////////////////////////////////
+
+AsyncOutputBuffer::
+AsyncOutputBuffer( std::ostream & sink
+			, const size_t chunkSize
+			, const size_t maxQueued )
+ :	std::streambuf()
+	, sink(sink)
+	, chunkSize(std::max((size_t)1,chunkSize))
+	, maxQueued(std::max((size_t)1,maxQueued))
+	, chunk(this->chunkSize)
+	, queue()
+	, pool()
+	, handedOver(0)
+	, closed(false)
+	, failed(false)
+	, mutex()
+	, queueFilled()
+	, queueDrained()
+	, writer()
+{
+	// set put area
+	setp( chunk.data(), chunk.data()+chunk.size() );
+	// start writer thread
+	writer = std::thread( &AsyncOutputBuffer::writeChunks, this );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+AsyncOutputBuffer::
+~AsyncOutputBuffer()
+{
+	close();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+AsyncOutputBuffer::
+close()
+{
+	// hand over pending output
+	handOver();
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		closed = true;
+	}
+	queueFilled.notify_one();
+	// wait until all is written
+	if (writer.joinable()) {
+		writer.join();
+	}
+	// no further output accepted
+	setp( NULL, NULL );
+	return !failed;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+AsyncOutputBuffer::
+handOver()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (closed || failed) {
+		return false;
+	}
+	const size_t filled = pptr()-pbase();
+	if (filled == 0) {
+		return true;
+	}
+	// wait for space in the queue
+	while (queue.size() >= maxQueued && !failed) {
+		queueDrained.wait( lock );
+	}
+	if (failed) {
+		return false;
+	}
+	// hand over filled part of the chunk
+	chunk.resize( filled );
+	queue.push_back( std::vector<char>() );
+	queue.back().swap( chunk );
+	handedOver += filled;
+	// reuse a written chunk if available
+	if (!pool.empty()) {
+		chunk.swap( pool.back() );
+		pool.pop_back();
+	}
+	lock.unlock();
+	queueFilled.notify_one();
+
+	// set up next chunk
+	chunk.resize( chunkSize );
+	setp( chunk.data(), chunk.data()+chunk.size() );
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+AsyncOutputBuffer::
+writeChunks()
+{
+	std::vector<char> toWrite;
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		// wait for next chunk
+		while (queue.empty() && !closed) {
+			queueFilled.wait( lock );
+		}
+		if (queue.empty()) {
+			// closed and all written
+			break;
+		}
+		toWrite.swap( queue.front() );
+		queue.pop_front();
+		lock.unlock();
+
+		// write outside of the lock
+		sink.write( toWrite.data(), toWrite.size() );
+		toWrite.clear();
+
+		lock.lock();
+		// flush if nothing else to be written
+		if (queue.empty()) {
+			lock.unlock();
+			sink.flush();
+			lock.lock();
+		}
+		if (!sink.good()) {
+			failed = true;
+		}
+		// store chunk for reuse
+		if (pool.size() < maxQueued) {
+			pool.push_back( std::vector<char>() );
+			pool.back().swap( toWrite );
+		}
+		queueDrained.notify_all();
+		if (failed) {
+			break;
+		}
+	}
+	// ensure everything is flushed
+	if (!failed) {
+		lock.unlock();
+		sink.flush();
+		lock.lock();
+		failed = !sink.good();
+	}
+	queueDrained.notify_all();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+AsyncOutputBuffer::int_type
+AsyncOutputBuffer::
+overflow( int_type c )
+{
+	if (!handOver()) {
+		return traits_type::eof();
+	}
+	if (!traits_type::eq_int_type( c, traits_type::eof() )) {
+		*pptr() = traits_type::to_char_type( c );
+		pbump( 1 );
+	}
+	return traits_type::not_eof( c );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+std::streamsize
+AsyncOutputBuffer::
+xsputn( const char * s, std::streamsize n )
+{
+	std::streamsize stored = 0;
+	while (stored < n) {
+		// hand over full chunk
+		if (pptr() == epptr() && !handOver()) {
+			break;
+		}
+		// copy as much as fits into the current chunk
+		const std::streamsize toCopy = std::min( n-stored, (std::streamsize)(epptr()-pptr()) );
+		std::memcpy( pptr(), s+stored, toCopy );
+		pbump( (int)toCopy );
+		stored += toCopy;
+	}
+	return stored;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+int
+AsyncOutputBuffer::
+sync()
+{
+	return handOver() ? 0 : -1;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+AsyncOutputBuffer::pos_type
+AsyncOutputBuffer::
+seekoff( off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which )
+{
+	// only the current position can be reported
+	if (off != 0 || dir != std::ios_base::cur || !(which & std::ios_base::out)) {
+		return pos_type(off_type(-1));
+	}
+	return pos_type( off_type( handedOver + (pptr()-pbase()) ) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+AsyncOutputStream::
+AsyncOutputStream( std::ostream * sink
+			, const bool deleteSink
+			, const size_t chunkSize
+			, const size_t maxQueued )
+ :	std::ostream( NULL )
+	, sink(sink)
+	, deleteSink(deleteSink)
+	, buffer( *sink, chunkSize, maxQueued )
+{
+	rdbuf( &buffer );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+AsyncOutputStream::
+~AsyncOutputStream()
+{
+	// write all pending output
+	buffer.close();
+	if (deleteSink) {
+		// closes file streams
+		INTARNA_CLEANUP(sink);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
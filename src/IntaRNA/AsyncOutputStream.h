@@ -0,0 +1,240 @@
+
+#ifndef INTARNA_ASYNCOUTPUTSTREAM_H_
+#define INTARNA_ASYNCOUTPUTSTREAM_H_
+
+#include "IntaRNA/general.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+namespace IntaRNA {
+
+/**
+ * Stream buffer that collects the written output in chunks of fixed size
+ * and hands full chunks over to a dedicated writer thread that writes them
+ * to the underlying (sink) stream. Thus, writing threads do not block on
+ * (potentially slow) I/O of the sink, e.g. on network file systems, but
+ * only copy the output into the current chunk.
+ *
+ * The number of chunks queued for writing is bounded; if the queue is
+ * full, writing threads wait until the writer thread has written a chunk
+ * (backpressure). Written chunks are reused to avoid reallocations.
+ *
+ * sync() (i.e. flushing the according stream) only hands over the current
+ * chunk without waiting for the write, which is done by close() or the
+ * destruction.
+ *
+ * Note, the buffer itself is not thread-safe, i.e. concurrent writes have to
+ * be synchronized as done for any other output stream.
+ *
+ */
+class AsyncOutputBuffer : public std::streambuf {
+
+public:
+
+	//! default size of the chunks handed over to the writer thread
+	static const size_t defaultChunkSize;
+
+	//! default maximal number of chunks queued for writing
+	static const size_t defaultMaxQueued;
+
+public:
+
+	/**
+	 * Construction; starts the writer thread.
+	 *
+	 * @param sink the stream to write to (not deleted by the buffer)
+	 * @param chunkSize the size of the chunks handed over for writing
+	 * @param maxQueued the maximal number of chunks queued for writing
+	 */
+	AsyncOutputBuffer( std::ostream & sink
+				, const size_t chunkSize = defaultChunkSize
+				, const size_t maxQueued = defaultMaxQueued );
+
+	/**
+	 * Destruction; writes all pending output (see close())
+	 */
+	virtual ~AsyncOutputBuffer();
+
+	/**
+	 * Hands over the pending output and waits until it is written and the
+	 * sink is flushed. Afterwards, the writer thread is stopped and no
+	 * further output is accepted.
+	 *
+	 * @return true if all output was successfully written; false otherwise
+	 */
+	bool
+	close();
+
+protected:
+
+	/**
+	 * Hands over the current chunk and stores the given character in the
+	 * next one.
+	 * @param c the character to store
+	 * @return c on success; traits_type::eof() otherwise
+	 */
+	virtual
+	int_type
+	overflow( int_type c );
+
+	/**
+	 * Copies the given characters to the current chunk(s).
+	 * @param s the characters to store
+	 * @param n the number of characters to store
+	 * @return the number of characters stored
+	 */
+	virtual
+	std::streamsize
+	xsputn( const char * s, std::streamsize n );
+
+	/**
+	 * Hands over the current chunk for writing without waiting for the write.
+	 * @return 0 on success; -1 if the output is closed or writing failed
+	 */
+	virtual
+	int
+	sync();
+
+	/**
+	 * Provides the number of characters handed to the buffer so far (only
+	 * for the current position of the output sequence).
+	 */
+	virtual
+	pos_type
+	seekoff( off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which );
+
+protected:
+
+	//! the stream to write to
+	std::ostream & sink;
+
+	//! the size of the chunks
+	const size_t chunkSize;
+
+	//! the maximal number of chunks queued for writing
+	const size_t maxQueued;
+
+	//! the chunk currently filled (put area of the stream buffer)
+	std::vector<char> chunk;
+
+	//! the chunks handed over for writing
+	std::deque< std::vector<char> > queue;
+
+	//! written chunks to be reused
+	std::vector< std::vector<char> > pool;
+
+	//! the number of characters handed over for writing so far
+	size_t handedOver;
+
+	//! whether or not no further output is accepted
+	bool closed;
+
+	//! whether or not writing to the sink failed
+	bool failed;
+
+	//! guards queue, pool, closed and failed
+	std::mutex mutex;
+
+	//! signals queued chunks or closing to the writer thread
+	std::condition_variable queueFilled;
+
+	//! signals written chunks to waiting writing threads
+	std::condition_variable queueDrained;
+
+	//! the writer thread
+	std::thread writer;
+
+	/**
+	 * Hands over the filled part of the current chunk to the writer thread
+	 * and sets up a new chunk. Waits if the queue is full.
+	 * @return false if the output is closed or writing failed; true otherwise
+	 */
+	bool
+	handOver();
+
+	/**
+	 * Main loop of the writer thread, i.e. writes queued chunks to the sink
+	 * until the buffer is closed and the queue is empty.
+	 */
+	void
+	writeChunks();
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+/**
+ * Output stream that writes via an AsyncOutputBuffer to a sink stream
+ * using a dedicated writer thread.
+ *
+ * Note, flush() only hands over the pending output without waiting for
+ * it to be written. All output is written when the stream is destructed.
+ *
+ */
+class AsyncOutputStream : public std::ostream {
+
+public:
+
+	/**
+	 * Construction
+	 *
+	 * @param sink the stream to write to
+	 * @param deleteSink whether or not the sink is to be deleted on
+	 *        destruction
+	 * @param chunkSize the size of the chunks handed over for writing
+	 * @param maxQueued the maximal number of chunks queued for writing
+	 */
+	AsyncOutputStream( std::ostream * sink
+				, const bool deleteSink
+				, const size_t chunkSize = AsyncOutputBuffer::defaultChunkSize
+				, const size_t maxQueued = AsyncOutputBuffer::defaultMaxQueued );
+
+	/**
+	 * Destruction; writes all pending output and deletes the sink if
+	 * requested.
+	 */
+	virtual ~AsyncOutputStream();
+
+	/**
+	 * Access to the stream written to
+	 * @return the sink
+	 */
+	std::ostream &
+	getSink() const;
+
+protected:
+
+	//! the stream to write to
+	std::ostream * sink;
+
+	//! whether or not the sink is to be deleted on destruction
+	const bool deleteSink;
+
+	//! the buffer handing the output to the writer thread
+	AsyncOutputBuffer buffer;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+
+inline
+std::ostream &
+AsyncOutputStream::
+getSink() const
+{
+	return *sink;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_ASYNCOUTPUTSTREAM_H_ */
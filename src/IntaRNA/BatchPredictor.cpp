@@ -0,0 +1,605 @@
+
+#include "IntaRNA/BatchPredictor.h"
+
+#include "IntaRNA/AccessibilityBasePair.h"
+#include "IntaRNA/AccessibilityConstraint.h"
+#include "IntaRNA/AccessibilityDisabled.h"
+#include "IntaRNA/AccessibilityVrna.h"
+#include "IntaRNA/InteractionEnergyBasePair.h"
+#include "IntaRNA/InteractionEnergyVrna.h"
+#include "IntaRNA/PredictorMfe2d.h"
+#include "IntaRNA/PredictorMfe2dHeuristic.h"
+#include "IntaRNA/PredictorMfe2dHeuristicSeed.h"
+#include "IntaRNA/PredictorMfe2dHeuristicSeedSparse.h"
+#include "IntaRNA/PredictorMfe2dSeed.h"
+#include "IntaRNA/PredictorMfe4d.h"
+#include "IntaRNA/PredictorMfe4dSeed.h"
+#include "IntaRNA/SeedHandlerMfe.h"
+
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#if INTARNA_MULITHREADING
+	#include <omp.h>
+#endif
+
+namespace IntaRNA {
+
+////////////////////////////////////////////////////////////////////////////
+
+BatchPredictor::Parameters::
+Parameters()
+ :	energy('V')
+	, temperature(37.0)
+	, energyFile("")
+	, tAcc('C')
+	, qAcc('C')
+	, tAccW(150)
+	, qAccW(150)
+	, tAccL(100)
+	, qAccL(100)
+	, tIntLenMax(0)
+	, qIntLenMax(0)
+	, tIntLoopMax(16)
+	, qIntLoopMax(16)
+	, noSeedRequired(false)
+	, seedBP(7)
+	, seedMaxUP(0)
+	, seedMaxE(0)
+	, predMode('H')
+	, outConstraint( 1, OutputConstraint::OVERLAP_SEQ2, 0.0, 100.0 )
+	, threads(1)
+	, targetBatchSize(0)
+	, queryPackSize(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+BatchPredictor::
+BatchPredictor( const Parameters & parameters_ )
+ :	parameters(parameters_)
+	, vrnaHandler( parameters_.temperature, parameters_.energyFile.empty() ? NULL : &(parameters_.energyFile) )
+	, seedConstraint( parameters_.seedBP
+					, parameters_.seedMaxUP
+					, parameters_.seedMaxUP
+					, parameters_.seedMaxUP
+					, parameters_.seedMaxE
+					, Accessibility::ED_UPPER_BOUND
+					, IndexRangeList()
+					, IndexRangeList()
+					, "" )
+#if INTARNA_MULITHREADING
+	, threads( parameters_.threads == 0 ? (size_t)omp_get_max_threads() : parameters_.threads )
+#else
+	, threads( 1 )
+#endif
+{
+	// check setup
+	if (std::string("VB").find(parameters.energy) == std::string::npos) {
+		throw std::runtime_error("BatchPredictor() : energy = '"+toString(parameters.energy)+"' is not supported");
+	}
+	if (std::string("CN").find(parameters.tAcc) == std::string::npos) {
+		throw std::runtime_error("BatchPredictor() : tAcc = '"+toString(parameters.tAcc)+"' is not supported");
+	}
+	if (std::string("CN").find(parameters.qAcc) == std::string::npos) {
+		throw std::runtime_error("BatchPredictor() : qAcc = '"+toString(parameters.qAcc)+"' is not supported");
+	}
+	if (std::string("HMEA").find(parameters.predMode) == std::string::npos
+		|| (parameters.noSeedRequired && parameters.predMode == 'A'))
+	{
+		throw std::runtime_error("BatchPredictor() : predMode = '"+toString(parameters.predMode)+"' is not supported");
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+BatchPredictor::
+~BatchPredictor()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+BatchPredictor::
+predict( const std::vector< RnaSequence > & targets
+		, const std::vector< RnaSequence > & queries
+		, ResultHandler & results )
+{
+	const size_t batchSize = parameters.targetBatchSize == 0 ? threads : parameters.targetBatchSize;
+
+	// compute query accessibilities and energy data once for all targets
+	std::vector< ReverseAccessibility * > queryAcc;
+	std::vector< InteractionEnergyVrna::SequenceData * > queryData;
+	try {
+		initQueryAccessibilities( queries, queryAcc );
+		initQueryEnergyData( queryAcc, queryData );
+
+		// process targets batch-wise to limit the number of target
+		// accessibilities held in memory
+		for (size_t t=0; t<targets.size(); t+=batchSize) {
+			const std::vector< RnaSequence > batch( targets.begin()+t, targets.begin()+std::min(t+batchSize,targets.size()) );
+			predictTargets( batch, t, queryAcc, queryData, results );
+		}
+	} catch (...) {
+		clearQueryEnergyData( queryData );
+		clearQueryAccessibilities( queryAcc );
+		throw;
+	}
+	clearQueryEnergyData( queryData );
+	clearQueryAccessibilities( queryAcc );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+BatchPredictor::
+predict( SequenceProducer & targets
+		, const std::vector< RnaSequence > & queries
+		, ResultHandler & results )
+{
+	const size_t batchSize = parameters.targetBatchSize == 0 ? threads : parameters.targetBatchSize;
+
+	// compute query accessibilities and energy data once for all targets
+	std::vector< ReverseAccessibility * > queryAcc;
+	std::vector< InteractionEnergyVrna::SequenceData * > queryData;
+	try {
+		initQueryAccessibilities( queries, queryAcc );
+		initQueryEnergyData( queryAcc, queryData );
+
+		// process targets batch-wise
+		size_t targetOffset = 0;
+		std::vector< RnaSequence > batch;
+		batch.reserve( batchSize );
+		for (RnaSequence * target = targets.next(); target != NULL; target = targets.next()) {
+			batch.push_back( *target );
+			INTARNA_CLEANUP( target );
+			if (batch.size() == batchSize) {
+				predictTargets( batch, targetOffset, queryAcc, queryData, results );
+				targetOffset += batch.size();
+				batch.clear();
+			}
+		}
+		// handle remaining targets
+		if (!batch.empty()) {
+			predictTargets( batch, targetOffset, queryAcc, queryData, results );
+		}
+	} catch (...) {
+		clearQueryEnergyData( queryData );
+		clearQueryAccessibilities( queryAcc );
+		throw;
+	}
+	clearQueryEnergyData( queryData );
+	clearQueryAccessibilities( queryAcc );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+Accessibility *
+BatchPredictor::
+getAccessibility( const RnaSequence & seq
+				, const char accMode
+				, const size_t accW
+				, const size_t accL
+				, const size_t intLenMax )
+{
+	// create temporary constraint object (will be copied)
+	const AccessibilityConstraint accConstraint( seq.size(), accL, "", "", "" );
+
+	switch (accMode) {
+	case 'N' : // no accessibility
+		return new AccessibilityDisabled( seq, intLenMax, &accConstraint );
+	case 'C' : { // computed accessibility
+		const size_t maxLength = std::min( intLenMax == 0 ? seq.size() : intLenMax
+										, accW == 0 ? seq.size() : accW );
+		switch (parameters.energy) {
+		case 'B' : return new AccessibilityBasePair( seq, maxLength, &accConstraint );
+		case 'V' : return new AccessibilityVrna( seq, maxLength, &accConstraint, vrnaHandler, accW );
+		}
+		} break;
+	}
+	INTARNA_NOT_IMPLEMENTED("BatchPredictor::getAccessibility : accessibility mode '"+toString(accMode)+"' is not supported");
+	return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+InteractionEnergy *
+BatchPredictor::
+getEnergyHandler( const Accessibility & accTarget
+				, const ReverseAccessibility & accQuery
+				, const InteractionEnergyVrna::SequenceData * queryData )
+{
+	switch (parameters.energy) {
+	case 'B' : return new InteractionEnergyBasePair( accTarget, accQuery, parameters.tIntLoopMax, parameters.qIntLoopMax );
+	case 'V' : return new InteractionEnergyVrna( accTarget, accQuery, vrnaHandler, parameters.tIntLoopMax, parameters.qIntLoopMax, false, queryData );
+	}
+	INTARNA_NOT_IMPLEMENTED("BatchPredictor::getEnergyHandler : energy = '"+toString(parameters.energy)+"' is not supported");
+	return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+Predictor *
+BatchPredictor::
+getPredictor( const InteractionEnergy & energy
+			, OutputHandler & output ) const
+{
+	if (parameters.noSeedRequired) {
+		switch (parameters.predMode) {
+		case 'H' : return new PredictorMfe2dHeuristic( energy, output, NULL );
+		case 'M' : return new PredictorMfe2d( energy, output, NULL );
+		case 'E' : return new PredictorMfe4d( energy, output, NULL );
+		}
+	} else {
+		switch (parameters.predMode) {
+		case 'H' : return new PredictorMfe2dHeuristicSeed( energy, output, NULL, new SeedHandlerMfe( energy, seedConstraint ) );
+		case 'M' : return new PredictorMfe2dSeed( energy, output, NULL, new SeedHandlerMfe( energy, seedConstraint ) );
+		case 'E' : return new PredictorMfe4dSeed( energy, output, NULL, new SeedHandlerMfe( energy, seedConstraint ) );
+		case 'A' : return new PredictorMfe2dHeuristicSeedSparse( energy, output, NULL, new SeedHandlerMfe( energy, seedConstraint ) );
+		}
+	}
+	INTARNA_NOT_IMPLEMENTED("BatchPredictor::getPredictor : mode "+toString(parameters.predMode)+" not implemented");
+	return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+BatchPredictor::
+initQueryAccessibilities( const std::vector< RnaSequence > & queries
+						, std::vector< ReverseAccessibility * > & queryAcc )
+{
+	queryAcc.assign( queries.size(), NULL );
+
+#if INTARNA_MULITHREADING
+	// OMP shared variables to enable exception forwarding from within OMP parallelized for loop
+	bool threadAborted = false;
+	std::exception_ptr exceptionPtrDuringOmp = NULL;
+	std::stringstream exceptionInfoDuringOmp;
+
+	# pragma omp parallel for schedule(dynamic) num_threads( threads ) shared(queries,queryAcc,threadAborted,exceptionPtrDuringOmp,exceptionInfoDuringOmp)
+#endif
+	for (size_t q=0; q<queries.size(); q++) {
+#if INTARNA_MULITHREADING
+		#pragma omp flush (threadAborted)
+		// explicit try-catch-block due to missing OMP exception forwarding
+		if (!threadAborted) {
+			try {
+#endif
+				Accessibility * acc = getAccessibility( queries.at(q), parameters.qAcc, parameters.qAccW, parameters.qAccL, parameters.qIntLenMax );
+				INTARNA_CHECK_NOT_NULL(acc,"query accessibility initialization failed");
+				queryAcc[q] = new ReverseAccessibility( *acc );
+#if INTARNA_MULITHREADING
+			} catch (std::exception & e) {
+				// ensure exception handling for first failed thread only
+				#pragma omp critical(intarna_omp_exception)
+				{
+					if (!threadAborted) {
+						// store exception information
+						exceptionPtrDuringOmp = std::make_exception_ptr(e);
+						exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #query "<<q <<" : "<<e.what();
+						// trigger abortion of all threads
+						threadAborted = true;
+						#pragma omp flush (threadAborted)
+					}
+				} // omp critical(intarna_omp_exception)
+			} catch (...) {
+				// ensure exception handling for first failed thread only
+				#pragma omp critical(intarna_omp_exception)
+				{
+					if (!threadAborted) {
+						// store exception information
+						exceptionPtrDuringOmp = std::current_exception();
+						exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #query "<<q;
+						// trigger abortion of all threads
+						threadAborted = true;
+						#pragma omp flush (threadAborted)
+					}
+				} // omp critical(intarna_omp_exception)
+			}
+		} // if not threadAborted
+#endif
+	}
+
+#if INTARNA_MULITHREADING
+	// forward exceptions thrown within the parallel region
+	if (threadAborted) {
+		if (!exceptionInfoDuringOmp.str().empty()) {
+			LOG(WARNING) <<"Exception raised for : "<<exceptionInfoDuringOmp.str();
+		}
+		if (exceptionPtrDuringOmp != NULL) {
+			std::rethrow_exception(exceptionPtrDuringOmp);
+		}
+	}
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+BatchPredictor::
+clearQueryAccessibilities( std::vector< ReverseAccessibility * > & queryAcc )
+{
+	for (size_t q=0; q<queryAcc.size(); q++) {
+		if (queryAcc.at(q) != NULL) {
+			// cleanup the original accessibility object
+			Accessibility * accOrig = &(const_cast<Accessibility&>(queryAcc.at(q)->getAccessibilityOrigin()));
+			INTARNA_CLEANUP( accOrig );
+			INTARNA_CLEANUP( queryAcc[q] );
+		}
+	}
+	queryAcc.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+BatchPredictor::
+initQueryEnergyData( const std::vector< ReverseAccessibility * > & queryAcc
+					, std::vector< InteractionEnergyVrna::SequenceData * > & queryData ) const
+{
+	queryData.assign( queryAcc.size(), NULL );
+	// only the VRNA-based energy model has sequence-specific data
+	if (parameters.energy != 'V') {
+		return;
+	}
+	for (size_t q=0; q<queryAcc.size(); q++) {
+		queryData[q] = new InteractionEnergyVrna::SequenceData( *(queryAcc.at(q)), vrnaHandler, false );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+BatchPredictor::
+clearQueryEnergyData( std::vector< InteractionEnergyVrna::SequenceData * > & queryData )
+{
+	for (size_t q=0; q<queryData.size(); q++) {
+		INTARNA_CLEANUP( queryData[q] );
+	}
+	queryData.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+size_t
+BatchPredictor::
+getQueryPackSize( const size_t targetNumber, const size_t queryNumber ) const
+{
+	if (parameters.queryPackSize > 0) {
+		return parameters.queryPackSize;
+	}
+	if (targetNumber == 0 || queryNumber == 0) {
+		return 1;
+	}
+	// split the queries into enough packs to keep all threads busy even
+	// for a single target
+	const size_t packsPerTarget = std::min( queryNumber, std::max<size_t>( 1, (2*threads + targetNumber-1) / targetNumber ) );
+	return (queryNumber + packsPerTarget-1) / packsPerTarget;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+BatchPredictor::
+predictTargets( const std::vector< RnaSequence > & targets
+				, const size_t targetOffset
+				, const std::vector< ReverseAccessibility * > & queryAcc
+				, const std::vector< InteractionEnergyVrna::SequenceData * > & queryData
+				, ResultHandler & results )
+{
+	// target accessibilities shared by all query packs
+	std::vector< Accessibility * > targetAcc( targets.size(), NULL );
+
+	// jobs : (target, first query) of each query pack
+	const size_t packSize = getQueryPackSize( targets.size(), queryAcc.size() );
+	std::vector< std::pair< size_t, size_t > > packs;
+	// process expensive packs first (longest job first), such that no long
+	// job is started last and computed by a single thread at the end;
+	// equally expensive packs are processed in input order
+	std::vector< std::pair< size_t, size_t > > packOrder;
+	for (size_t t=0; t<targets.size(); t++) {
+		for (size_t q=0; q<queryAcc.size(); q+=packSize) {
+			size_t packLength = 0;
+			for (size_t p=q; p<std::min(q+packSize,queryAcc.size()); p++) {
+				packLength += queryAcc.at(p)->getSequence().size();
+			}
+			packOrder.push_back( std::make_pair( std::numeric_limits<size_t>::max() - targets.at(t).size()*packLength, packs.size() ) );
+			packs.push_back( std::make_pair( t, q ) );
+		}
+	}
+	std::sort( packOrder.begin(), packOrder.end() );
+
+	try {
+		initTargetAccessibilities( targets, targetOffset, targetAcc );
+
+#if INTARNA_MULITHREADING
+		// OMP shared variables to enable exception forwarding from within OMP parallelized for loop
+		bool threadAborted = false;
+		std::exception_ptr exceptionPtrDuringOmp = NULL;
+		std::stringstream exceptionInfoDuringOmp;
+
+		# pragma omp parallel for schedule(dynamic) num_threads( threads ) shared(targetAcc,packs,packOrder,queryAcc,queryData,results,threadAborted,exceptionPtrDuringOmp,exceptionInfoDuringOmp)
+#endif
+		for (size_t o=0; o<packOrder.size(); o++) {
+			const size_t t = packs.at(packOrder.at(o).second).first;
+			const size_t qFirst = packs.at(packOrder.at(o).second).second;
+#if INTARNA_MULITHREADING
+			#pragma omp flush (threadAborted)
+			// explicit try-catch-block due to missing OMP exception forwarding
+			if (!threadAborted) {
+				try {
+#endif
+					InteractionEnergy * energy = NULL;
+					Predictor * predictor = NULL;
+					try {
+						for (size_t q=qFirst; q<std::min(qFirst+packSize,queryAcc.size()); q++) {
+							energy = getEnergyHandler( *(targetAcc.at(t)), *(queryAcc.at(q)), queryData.at(q) );
+							INTARNA_CHECK_NOT_NULL(energy,"energy initialization failed");
+
+							// collect the interactions to be reported
+							OutputHandlerInteractionList interactions( parameters.outConstraint.reportMax );
+							predictor = getPredictor( *energy, interactions );
+							INTARNA_CHECK_NOT_NULL(predictor,"predictor initialization failed");
+
+							// predict for the full sequences
+							predictor->predict( IndexRange(0,RnaSequence::lastPos)
+											, IndexRange(0,RnaSequence::lastPos)
+											, parameters.outConstraint );
+							INTARNA_CLEANUP( predictor );
+
+							// forward results
+#if INTARNA_MULITHREADING
+							#pragma omp critical(intarna_omp_batchPredictorResult)
+#endif
+							{ results.handle( targetOffset+t, q, *energy, interactions ); }
+
+							INTARNA_CLEANUP( energy );
+						}
+					} catch (...) {
+						INTARNA_CLEANUP( predictor );
+						INTARNA_CLEANUP( energy );
+						throw;
+					}
+#if INTARNA_MULITHREADING
+				} catch (std::exception & e) {
+					// ensure exception handling for first failed thread only
+					#pragma omp critical(intarna_omp_exception)
+					{
+						if (!threadAborted) {
+							// store exception information
+							exceptionPtrDuringOmp = std::make_exception_ptr(e);
+							exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #target "<<(targetOffset+t) <<" #query "<<qFirst <<" : "<<e.what();
+							// trigger abortion of all threads
+							threadAborted = true;
+							#pragma omp flush (threadAborted)
+						}
+					} // omp critical(intarna_omp_exception)
+				} catch (...) {
+					// ensure exception handling for first failed thread only
+					#pragma omp critical(intarna_omp_exception)
+					{
+						if (!threadAborted) {
+							// store exception information
+							exceptionPtrDuringOmp = std::current_exception();
+							exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #target "<<(targetOffset+t) <<" #query "<<qFirst;
+							// trigger abortion of all threads
+							threadAborted = true;
+							#pragma omp flush (threadAborted)
+						}
+					} // omp critical(intarna_omp_exception)
+				}
+			} // if not threadAborted
+#endif
+		}
+
+#if INTARNA_MULITHREADING
+		// forward exceptions thrown within the parallel region
+		if (threadAborted) {
+			if (!exceptionInfoDuringOmp.str().empty()) {
+				LOG(WARNING) <<"Exception raised for : "<<exceptionInfoDuringOmp.str();
+			}
+			if (exceptionPtrDuringOmp != NULL) {
+				std::rethrow_exception(exceptionPtrDuringOmp);
+			}
+		}
+#endif
+	} catch (...) {
+		for (size_t t=0; t<targetAcc.size(); t++) {
+			INTARNA_CLEANUP( targetAcc[t] );
+		}
+		throw;
+	}
+	for (size_t t=0; t<targetAcc.size(); t++) {
+		INTARNA_CLEANUP( targetAcc[t] );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+BatchPredictor::
+initTargetAccessibilities( const std::vector< RnaSequence > & targets
+						, const size_t targetOffset
+						, std::vector< Accessibility * > & targetAcc )
+{
+#if INTARNA_MULITHREADING
+	// OMP shared variables to enable exception forwarding from within OMP parallelized for loop
+	bool threadAborted = false;
+	std::exception_ptr exceptionPtrDuringOmp = NULL;
+	std::stringstream exceptionInfoDuringOmp;
+#endif
+
+	// compute long targets first (longest job first)
+	std::vector< std::pair< size_t, size_t > > targetOrder( targets.size() );
+	for (size_t t=0; t<targets.size(); t++) {
+		targetOrder[t] = std::make_pair( std::numeric_limits<size_t>::max() - targets.at(t).size(), t );
+	}
+	std::sort( targetOrder.begin(), targetOrder.end() );
+
+#if INTARNA_MULITHREADING
+	# pragma omp parallel for schedule(dynamic) num_threads( threads ) shared(targets,targetOrder,targetAcc,threadAborted,exceptionPtrDuringOmp,exceptionInfoDuringOmp)
+#endif
+	for (size_t o=0; o<targetOrder.size(); o++) {
+		const size_t t = targetOrder.at(o).second;
+#if INTARNA_MULITHREADING
+		#pragma omp flush (threadAborted)
+		// explicit try-catch-block due to missing OMP exception forwarding
+		if (!threadAborted) {
+			try {
+#endif
+				targetAcc[t] = getAccessibility( targets.at(t), parameters.tAcc, parameters.tAccW, parameters.tAccL, parameters.tIntLenMax );
+				INTARNA_CHECK_NOT_NULL(targetAcc.at(t),"target accessibility initialization failed");
+#if INTARNA_MULITHREADING
+			} catch (std::exception & e) {
+				// ensure exception handling for first failed thread only
+				#pragma omp critical(intarna_omp_exception)
+				{
+					if (!threadAborted) {
+						// store exception information
+						exceptionPtrDuringOmp = std::make_exception_ptr(e);
+						exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #target "<<(targetOffset+t) <<" : "<<e.what();
+						// trigger abortion of all threads
+						threadAborted = true;
+						#pragma omp flush (threadAborted)
+					}
+				} // omp critical(intarna_omp_exception)
+			} catch (...) {
+				// ensure exception handling for first failed thread only
+				#pragma omp critical(intarna_omp_exception)
+				{
+					if (!threadAborted) {
+						// store exception information
+						exceptionPtrDuringOmp = std::current_exception();
+						exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #target "<<(targetOffset+t);
+						// trigger abortion of all threads
+						threadAborted = true;
+						#pragma omp flush (threadAborted)
+					}
+				} // omp critical(intarna_omp_exception)
+			}
+		} // if not threadAborted
+#endif
+	}
+
+#if INTARNA_MULITHREADING
+	// forward exceptions thrown within the parallel region
+	if (threadAborted) {
+		if (!exceptionInfoDuringOmp.str().empty()) {
+			LOG(WARNING) <<"Exception raised for : "<<exceptionInfoDuringOmp.str();
+		}
+		if (exceptionPtrDuringOmp != NULL) {
+			std::rethrow_exception(exceptionPtrDuringOmp);
+		}
+	}
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
@@ -0,0 +1,389 @@
+
+#ifndef INTARNA_BATCHPREDICTOR_H_
+#define INTARNA_BATCHPREDICTOR_H_
+
+#include "IntaRNA/general.h"
+
+#include "IntaRNA/Accessibility.h"
+#include "IntaRNA/InteractionEnergy.h"
+#include "IntaRNA/InteractionEnergyVrna.h"
+#include "IntaRNA/OutputConstraint.h"
+#include "IntaRNA/OutputHandler.h"
+#include "IntaRNA/OutputHandlerInteractionList.h"
+#include "IntaRNA/Predictor.h"
+#include "IntaRNA/ReverseAccessibility.h"
+#include "IntaRNA/RnaSequence.h"
+#include "IntaRNA/SeedConstraint.h"
+#include "IntaRNA/VrnaHandler.h"
+
+#include <string>
+#include <vector>
+
+namespace IntaRNA {
+
+/**
+ * Embeddable batch prediction of RNA-RNA interactions for all pairs of a set
+ * of target and query sequences without the need of the IntaRNA binary's
+ * command line handling.
+ *
+ * The predictor is configured once via Parameters (defaults as for the
+ * IntaRNA binary) and sets up the accessibility, energy and prediction
+ * handlers for each target-query combination. The query accessibilities are
+ * computed once per predict() call and reused for all targets, while the
+ * targets are processed batch-wise: the accessibilities of a batch of targets
+ * are computed in parallel (if compiled with multi-threading support) and
+ * the queries are predicted for each target in packs in parallel. The
+ * target accessibilities are released once all queries are handled.
+ *
+ * The predicted interactions are not formatted but forwarded to a
+ * ResultHandler, e.g.
+ *
+ *   class MyHandler : public BatchPredictor::ResultHandler {
+ *   public:
+ *     void handle( const size_t t, const size_t q
+ *                  , const InteractionEnergy & energy
+ *                  , const OutputHandlerInteractionList & interactions )
+ *     {
+ *       BOOST_FOREACH( const Interaction * i, interactions ) { ... }
+ *     }
+ *   };
+ *
+ *   BatchPredictor::Parameters params;
+ *   params.threads = 4;
+ *   BatchPredictor batch( params );
+ *   MyHandler handler;
+ *   batch.predict( targets, queries, handler );
+ *
+ */
+class BatchPredictor {
+
+public:
+
+	/**
+	 * Configuration of a BatchPredictor; the members correspond to the
+	 * according IntaRNA program arguments and default to the same values.
+	 */
+	class Parameters {
+	public:
+		//! energy model : 'V' = VRNA-based, 'B' = base pair maximization
+		char energy;
+		//! temperature in Celsius
+		double temperature;
+		//! if non-empty: VRNA parameter file to be used
+		std::string energyFile;
+		//! target accessibility : 'C' = computed, 'N' = disabled
+		char tAcc;
+		//! query accessibility : 'C' = computed, 'N' = disabled
+		char qAcc;
+		//! target accessibility window size (0 = sequence length)
+		size_t tAccW;
+		//! query accessibility window size (0 = sequence length)
+		size_t qAccW;
+		//! maximal base pair span for target accessibility (0 = sequence length)
+		size_t tAccL;
+		//! maximal base pair span for query accessibility (0 = sequence length)
+		size_t qAccL;
+		//! maximal interaction length within targets (0 = sequence length)
+		size_t tIntLenMax;
+		//! maximal interaction length within queries (0 = sequence length)
+		size_t qIntLenMax;
+		//! maximal interior loop length within targets
+		size_t tIntLoopMax;
+		//! maximal interior loop length within queries
+		size_t qIntLoopMax;
+		//! whether or not interactions are not required to contain a seed
+		bool noSeedRequired;
+		//! number of base pairs within a seed
+		size_t seedBP;
+		//! maximal number of unpaired bases within a seed
+		size_t seedMaxUP;
+		//! maximal energy of a seed
+		E_type seedMaxE;
+		//! prediction mode : 'H' = heuristic, 'M' = exact, 'E' = exact with
+		//! less memory, 'A' = heuristic with sparse seed handling
+		char predMode;
+		//! constraints for the interactions reported per target-query pair
+		OutputConstraint outConstraint;
+		//! number of threads to be used (0 = all available)
+		size_t threads;
+		//! number of targets processed at once, i.e. with accessibilities
+		//! held in memory (0 = number of threads)
+		size_t targetBatchSize;
+		//! number of queries predicted one after another for a target by a
+		//! single thread (0 = split the queries such that all threads are
+		//! busy even for a single target)
+		size_t queryPackSize;
+
+		/**
+		 * Construction with the defaults of the IntaRNA program.
+		 */
+		Parameters();
+	};
+
+	/**
+	 * Receives the predicted interactions of a target-query combination.
+	 *
+	 * Calls are serialized by the BatchPredictor, i.e. implementations do
+	 * not have to be thread-safe. Combinations are not reported in input
+	 * order if multiple threads are used.
+	 */
+	class ResultHandler {
+	public:
+		virtual ~ResultHandler() {}
+		/**
+		 * Handles the interactions predicted for a target-query combination.
+		 * Both the interactions and the energy handler are only valid during
+		 * the call.
+		 *
+		 * @param targetNumber the index of the target sequence
+		 * @param queryNumber the index of the query sequence
+		 * @param energy the energy handler used for the prediction
+		 * @param interactions the interactions predicted (sorted by energy;
+		 *        empty if no interaction satisfies the constraints)
+		 */
+		virtual
+		void
+		handle( const size_t targetNumber
+				, const size_t queryNumber
+				, const InteractionEnergy & energy
+				, const OutputHandlerInteractionList & interactions ) = 0;
+	};
+
+	/**
+	 * Provides target sequences one after another, e.g. while reading them
+	 * from a stream, to avoid holding all targets in memory.
+	 *
+	 * Calls are done by the calling thread of predict() only.
+	 */
+	class SequenceProducer {
+	public:
+		virtual ~SequenceProducer() {}
+		/**
+		 * Provides the next sequence.
+		 *
+		 * @return a newly allocated sequence that is deleted by the
+		 *         BatchPredictor, or NULL if no sequence is left
+		 */
+		virtual
+		RnaSequence *
+		next() = 0;
+	};
+
+public:
+
+	/**
+	 * Construction
+	 *
+	 * @param parameters the prediction setup to be used for all predictions
+	 */
+	BatchPredictor( const Parameters & parameters );
+
+	/**
+	 * destruction
+	 */
+	virtual ~BatchPredictor();
+
+	/**
+	 * Predicts the interactions of all target-query combinations and
+	 * forwards them to the result handler.
+	 *
+	 * @param targets the target sequences
+	 * @param queries the query sequences
+	 * @param results the handler receiving the interactions of each
+	 *        target-query combination
+	 *
+	 * @throws std::runtime_error if the setup is not supported or any
+	 *         prediction failed
+	 */
+	void
+	predict( const std::vector< RnaSequence > & targets
+			, const std::vector< RnaSequence > & queries
+			, ResultHandler & results );
+
+	/**
+	 * Predicts the interactions of all target-query combinations and
+	 * forwards them to the result handler, where the targets are pulled
+	 * in batches from the producer. The target numbers reported follow
+	 * the order the targets are provided.
+	 *
+	 * @param targets the producer of the target sequences
+	 * @param queries the query sequences
+	 * @param results the handler receiving the interactions of each
+	 *        target-query combination
+	 *
+	 * @throws std::runtime_error if the setup is not supported or any
+	 *         prediction failed
+	 */
+	void
+	predict( SequenceProducer & targets
+			, const std::vector< RnaSequence > & queries
+			, ResultHandler & results );
+
+	/**
+	 * Access to the prediction setup
+	 * @return the parameters used for all predictions
+	 */
+	const Parameters &
+	getParameters() const;
+
+protected:
+
+	//! the prediction setup
+	const Parameters parameters;
+
+	//! VRNA parameter handling
+	VrnaHandler vrnaHandler;
+
+	//! the seed constraint used by all predictions
+	const SeedConstraint seedConstraint;
+
+	//! the number of threads to be used
+	const size_t threads;
+
+	/**
+	 * Creates the accessibility handler for a sequence.
+	 *
+	 * @param seq the sequence of interest
+	 * @param accMode the accessibility mode (see Parameters::tAcc)
+	 * @param accW the accessibility window size
+	 * @param accL the maximal base pair span
+	 * @param intLenMax the maximal interaction length
+	 * @return the new accessibility handler (to be deleted by the caller)
+	 */
+	Accessibility *
+	getAccessibility( const RnaSequence & seq
+					, const char accMode
+					, const size_t accW
+					, const size_t accL
+					, const size_t intLenMax );
+
+	/**
+	 * Creates the energy handler for a target-query combination.
+	 *
+	 * @param accTarget the target's accessibility
+	 * @param accQuery the query's (reversed) accessibility
+	 * @param queryData if not NULL, the precomputed energy data of the query
+	 *        (see initQueryEnergyData())
+	 * @return the new energy handler (to be deleted by the caller)
+	 */
+	InteractionEnergy *
+	getEnergyHandler( const Accessibility & accTarget
+					, const ReverseAccessibility & accQuery
+					, const InteractionEnergyVrna::SequenceData * queryData = NULL );
+
+	/**
+	 * Creates the predictor for a target-query combination.
+	 *
+	 * @param energy the energy handler to be used
+	 * @param output the output handler to report to
+	 * @return the new predictor (to be deleted by the caller)
+	 */
+	Predictor *
+	getPredictor( const InteractionEnergy & energy
+				, OutputHandler & output ) const;
+
+	/**
+	 * Computes the (reversed) accessibilities of all queries in parallel.
+	 *
+	 * @param queries the query sequences
+	 * @param queryAcc the container to fill with the according
+	 *        accessibilities (to be released via clearQueryAccessibilities())
+	 */
+	void
+	initQueryAccessibilities( const std::vector< RnaSequence > & queries
+							, std::vector< ReverseAccessibility * > & queryAcc );
+
+	/**
+	 * Releases the accessibilities of all queries.
+	 *
+	 * @param queryAcc the accessibilities to release (cleared)
+	 */
+	static
+	void
+	clearQueryAccessibilities( std::vector< ReverseAccessibility * > & queryAcc );
+
+	/**
+	 * Computes the sequence-specific energy data of all queries that is
+	 * independent of the target (only for the VRNA-based energy model).
+	 *
+	 * @param queryAcc the accessibilities of all queries
+	 * @param queryData the container to fill with the according data or
+	 *        NULL if not available (to be released via
+	 *        clearQueryEnergyData())
+	 */
+	void
+	initQueryEnergyData( const std::vector< ReverseAccessibility * > & queryAcc
+						, std::vector< InteractionEnergyVrna::SequenceData * > & queryData ) const;
+
+	/**
+	 * Releases the energy data of all queries.
+	 *
+	 * @param queryData the data to release (cleared)
+	 */
+	static
+	void
+	clearQueryEnergyData( std::vector< InteractionEnergyVrna::SequenceData * > & queryData );
+
+	/**
+	 * Provides the number of queries predicted one after another for a
+	 * target by a single thread.
+	 *
+	 * @param targetNumber the number of targets predicted at once
+	 * @param queryNumber the number of queries
+	 * @return the number of queries per pack (> 0)
+	 */
+	size_t
+	getQueryPackSize( const size_t targetNumber, const size_t queryNumber ) const;
+
+	/**
+	 * Computes the accessibilities of the given targets in parallel.
+	 *
+	 * @param targets the target sequences
+	 * @param targetOffset the number of the first target (for error reports)
+	 * @param targetAcc the container to fill with the according
+	 *        accessibilities (sized as targets)
+	 */
+	void
+	initTargetAccessibilities( const std::vector< RnaSequence > & targets
+							, const size_t targetOffset
+							, std::vector< Accessibility * > & targetAcc );
+
+	/**
+	 * Predicts the interactions of the given targets with all queries
+	 * in parallel.
+	 *
+	 * The target accessibilities are computed first. Afterwards, the queries
+	 * are predicted for each target in packs of getQueryPackSize() queries,
+	 * such that the target data is shared by all queries of a pack and many
+	 * short queries against few targets keep all threads busy.
+	 *
+	 * @param targets the target sequences
+	 * @param targetOffset the number of the first target to be reported
+	 * @param queryAcc the accessibilities of all queries
+	 * @param queryData the energy data of all queries
+	 * @param results the handler receiving the interactions
+	 */
+	void
+	predictTargets( const std::vector< RnaSequence > & targets
+					, const size_t targetOffset
+					, const std::vector< ReverseAccessibility * > & queryAcc
+					, const std::vector< InteractionEnergyVrna::SequenceData * > & queryData
+					, ResultHandler & results );
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+const BatchPredictor::Parameters &
+BatchPredictor::
+getParameters() const
+{
+	return parameters;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_BATCHPREDICTOR_H_ */
@@ -0,0 +1,110 @@
+
+#include "IntaRNA/CheckpointJournal.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+
+namespace IntaRNA {
+
+////////////////////////////////////////////////////////////////////////////
+
+CheckpointJournal::
+CheckpointJournal( const std::string & fileName, const bool resume )
+ :	fileName(fileName)
+	, journal()
+	, finished()
+	, outputSize(0)
+{
+	// read entries of the run to be resumed
+	if (resume) {
+		read();
+	}
+	// (re)write journal to remove incomplete lines of the resumed run
+	journal.open( fileName.c_str(), std::ios_base::out | std::ios_base::trunc );
+	if (!journal.is_open()) {
+		throw std::runtime_error("CheckpointJournal : could not open journal file '"+fileName+"' for writing");
+	}
+	journal <<"# IntaRNA checkpoint journal : index of finished combination and output size\n";
+	for (auto entry = finished.begin(); entry != finished.end(); entry++) {
+		journal <<entry->first <<'\t' <<entry->second <<'\n';
+	}
+	journal.flush();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+CheckpointJournal::
+~CheckpointJournal()
+{
+	journal.close();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+CheckpointJournal::
+read()
+{
+	std::ifstream in( fileName.c_str() );
+	// nothing to resume if no journal available
+	if (!in.is_open()) {
+		return;
+	}
+	std::string line;
+	while( std::getline( in, line ) ) {
+		// ignore last line if incomplete (no line break)
+		if (in.eof()) {
+			break;
+		}
+		// skip empty and comment lines
+		if (line.empty() || line.at(0) == '#') {
+			continue;
+		}
+		// parse entry
+		std::istringstream entry( line );
+		size_t index = 0, size = 0;
+		if ( !(entry >>index >>size) ) {
+			throw std::runtime_error("CheckpointJournal : could not parse line '"+line+"' of journal file '"+fileName+"'");
+		}
+		finished[index] = size;
+		outputSize = std::max( outputSize, size );
+	}
+	in.close();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+CheckpointJournal::
+isFinished( const size_t from, const size_t to ) const
+{
+	// check if enough entries available
+	if (to > from && finished.size() < to-from) {
+		return false;
+	}
+	for (size_t index = from; index < to; index++) {
+		if (!isFinished(index)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+CheckpointJournal::
+add( const size_t index, const size_t size )
+{
+	// ignore combinations of the resumed run
+	if (isFinished(index)) {
+		return;
+	}
+	journal <<index <<'\t' <<size <<'\n';
+	journal.flush();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
@@ -0,0 +1,159 @@
+
+#ifndef INTARNA_CHECKPOINTJOURNAL_H_
+#define INTARNA_CHECKPOINTJOURNAL_H_
+
+#include "IntaRNA/general.h"
+
+#include <fstream>
+#include <string>
+#include <map>
+
+namespace IntaRNA {
+
+/**
+ * Journal of the query-target combinations whose output has been completely
+ * written, to enable the resume of an interrupted run.
+ *
+ * For each finished combination, one line holding the combination's index
+ * and the size of the output written so far (including the combination's
+ * output) is appended to the journal file, i.e.
+ *
+ *   index<TAB>outputSize
+ *
+ * Lines starting with '#' are comments. An incomplete last line (e.g. due to
+ * an interrupted write) is ignored when resuming.
+ *
+ * When resuming, the output beyond the largest recorded output size is not
+ * covered by the journal and has to be discarded, since the according
+ * combinations are predicted again.
+ *
+ */
+class CheckpointJournal {
+
+public:
+
+	/**
+	 * Construction; opens the journal file for writing.
+	 *
+	 * @param fileName the name of the journal file
+	 * @param resume if true, the combinations recorded in an existing journal
+	 *        file are read and kept; otherwise the journal file is
+	 *        (re)initialized
+	 *
+	 * @throws std::runtime_error if the file could not be opened
+	 */
+	CheckpointJournal( const std::string & fileName, const bool resume );
+
+	/**
+	 * Destruction, closes the journal file.
+	 */
+	virtual ~CheckpointJournal();
+
+	/**
+	 * Whether or not the combination was finished by the resumed run.
+	 *
+	 * @param index the index of the combination
+	 * @return true if the combination was recorded by the resumed journal
+	 */
+	bool
+	isFinished( const size_t index ) const;
+
+	/**
+	 * Whether or not all combinations within an index interval were finished
+	 * by the resumed run.
+	 *
+	 * @param from the first index of the interval
+	 * @param to the index after the last index of the interval
+	 * @return true if all combinations in [from,to) were recorded by the
+	 *         resumed journal
+	 */
+	bool
+	isFinished( const size_t from, const size_t to ) const;
+
+	/**
+	 * Access to the number of combinations finished by the resumed run.
+	 * @return the number of combinations read from the resumed journal
+	 */
+	size_t
+	getFinished() const;
+
+	/**
+	 * Access to the output size covered by the resumed run, i.e. the output
+	 * to be kept.
+	 * @return the largest output size recorded by the resumed journal
+	 */
+	size_t
+	getOutputSize() const;
+
+	/**
+	 * Records a finished combination and flushes the journal. Combinations
+	 * already finished by the resumed run are ignored.
+	 *
+	 * Note, this function is not thread-safe.
+	 *
+	 * @param index the index of the combination
+	 * @param size the size of the output written so far including the
+	 *        output of the combination
+	 */
+	void
+	add( const size_t index, const size_t size );
+
+protected:
+
+	//! the name of the journal file
+	const std::string fileName;
+
+	//! the journal file stream
+	std::ofstream journal;
+
+	//! the finished combinations of the resumed run (index -> output size)
+	std::map< size_t, size_t > finished;
+
+	//! the largest output size recorded by the resumed run
+	size_t outputSize;
+
+	/**
+	 * Reads all complete entries from the journal file.
+	 */
+	void
+	read();
+
+};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+CheckpointJournal::
+isFinished( const size_t index ) const
+{
+	return finished.find(index) != finished.end();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+CheckpointJournal::
+getFinished() const
+{
+	return finished.size();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+CheckpointJournal::
+getOutputSize() const
+{
+	return outputSize;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_CHECKPOINTJOURNAL_H_ */
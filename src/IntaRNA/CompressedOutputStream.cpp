@@ -0,0 +1,250 @@
+
+#include "IntaRNA/CompressedOutputStream.h"
+
+#include <stdexcept>
+
+#include <boost/algorithm/string.hpp>
+
+#if INTARNA_HAVE_ZLIB
+	#include <zlib.h>
+#endif
+#if INTARNA_HAVE_ZSTD
+	#include <zstd.h>
+#endif
+
+namespace IntaRNA {
+
+////////////////////////////////////////////////////////////////////////////
+
+const size_t CompressedOutputBuffer::bufferSize = 1 << 18;
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+CompressedOutputBuffer::
+isSupported( const Format format )
+{
+	switch (format) {
+	case GZIP : return INTARNA_HAVE_ZLIB;
+	case ZSTD : return INTARNA_HAVE_ZSTD;
+	}
+	return false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+CompressedOutputBuffer::
+getFormat( const std::string & fileName, Format & format )
+{
+	if (boost::iends_with( fileName, ".gz" )) {
+		format = GZIP;
+		return true;
+	}
+	if (boost::iends_with( fileName, ".zst" )) {
+		format = ZSTD;
+		return true;
+	}
+	return false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+CompressedOutputBuffer::
+CompressedOutputBuffer( std::ostream & sink, const Format format )
+ :	std::streambuf()
+	, sink(sink)
+	, format(format)
+	, compressor(NULL)
+	, in(bufferSize)
+	, out(bufferSize)
+	, closed(false)
+{
+	if (!isSupported(format)) {
+		throw std::runtime_error("CompressedOutputBuffer() : compression format not supported by this build");
+	}
+	switch (format) {
+	case GZIP : {
+#if INTARNA_HAVE_ZLIB
+		z_stream * zs = new z_stream();
+		zs->zalloc = Z_NULL;
+		zs->zfree = Z_NULL;
+		zs->opaque = Z_NULL;
+		// windowBits 15+16 = maximal window with gzip header
+		if (deflateInit2( zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15+16, 8, Z_DEFAULT_STRATEGY ) != Z_OK) {
+			delete zs;
+			throw std::runtime_error("CompressedOutputBuffer() : could not initialize gzip compression");
+		}
+		compressor = zs;
+#endif
+		} break;
+	case ZSTD : {
+#if INTARNA_HAVE_ZSTD
+		ZSTD_CStream * zs = ZSTD_createCStream();
+		if (zs == NULL || ZSTD_isError( ZSTD_initCStream( zs, 3 ) )) {
+			if (zs != NULL) { ZSTD_freeCStream( zs ); }
+			throw std::runtime_error("CompressedOutputBuffer() : could not initialize zstd compression");
+		}
+		compressor = zs;
+#endif
+		} break;
+	}
+	// set put area
+	setp( in.data(), in.data()+in.size() );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+CompressedOutputBuffer::
+~CompressedOutputBuffer()
+{
+	close();
+	// free compressor
+	if (compressor != NULL) {
+		switch (format) {
+		case GZIP : {
+#if INTARNA_HAVE_ZLIB
+			z_stream * zs = static_cast<z_stream*>(compressor);
+			deflateEnd( zs );
+			delete zs;
+#endif
+			} break;
+		case ZSTD : {
+#if INTARNA_HAVE_ZSTD
+			ZSTD_freeCStream( static_cast<ZSTD_CStream*>(compressor) );
+#endif
+			} break;
+		}
+		compressor = NULL;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+CompressedOutputBuffer::
+close()
+{
+	if (closed) {
+		return false;
+	}
+	const bool success = compress( true ) && sink.flush().good();
+	closed = true;
+	setp( NULL, NULL );
+	return success;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+CompressedOutputBuffer::int_type
+CompressedOutputBuffer::
+overflow( int_type c )
+{
+	if (closed || !compress( false )) {
+		return traits_type::eof();
+	}
+	if (!traits_type::eq_int_type( c, traits_type::eof() )) {
+		*pptr() = traits_type::to_char_type( c );
+		pbump( 1 );
+	}
+	return traits_type::not_eof( c );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+int
+CompressedOutputBuffer::
+sync()
+{
+	if (closed || !compress( false ) || !sink.flush().good()) {
+		return -1;
+	}
+	return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+CompressedOutputBuffer::
+compress( const bool finish )
+{
+	const size_t toCompress = pptr()-pbase();
+	bool success = true;
+
+	switch (format) {
+	case GZIP : {
+#if INTARNA_HAVE_ZLIB
+		z_stream * zs = static_cast<z_stream*>(compressor);
+		zs->next_in = reinterpret_cast<Bytef*>(pbase());
+		zs->avail_in = (uInt)toCompress;
+		int ret = Z_OK;
+		do {
+			zs->next_out = reinterpret_cast<Bytef*>(out.data());
+			zs->avail_out = (uInt)out.size();
+			ret = deflate( zs, finish ? Z_FINISH : Z_NO_FLUSH );
+			if (ret == Z_STREAM_ERROR) {
+				success = false;
+				break;
+			}
+			sink.write( out.data(), out.size()-zs->avail_out );
+		// continue until all input is consumed (and the stream is finished)
+		} while (zs->avail_out == 0 || (finish && ret != Z_STREAM_END));
+#endif
+		} break;
+	case ZSTD : {
+#if INTARNA_HAVE_ZSTD
+		ZSTD_CStream * zs = static_cast<ZSTD_CStream*>(compressor);
+		ZSTD_inBuffer inBuf = { pbase(), toCompress, 0 };
+		while (success && inBuf.pos < inBuf.size) {
+			ZSTD_outBuffer outBuf = { out.data(), out.size(), 0 };
+			success = !ZSTD_isError( ZSTD_compressStream( zs, &outBuf, &inBuf ) );
+			sink.write( out.data(), outBuf.pos );
+		}
+		if (success && finish) {
+			size_t remaining = 0;
+			do {
+				ZSTD_outBuffer outBuf = { out.data(), out.size(), 0 };
+				remaining = ZSTD_endStream( zs, &outBuf );
+				success = !ZSTD_isError( remaining );
+				sink.write( out.data(), outBuf.pos );
+			} while (success && remaining > 0);
+		}
+#endif
+		} break;
+	}
+
+	// reset put area
+	setp( in.data(), in.data()+in.size() );
+
+	return success && sink.good();
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+CompressedOutputStream::
+CompressedOutputStream( const std::string & fileName
+					, const CompressedOutputBuffer::Format format )
+ :	std::ostream( NULL )
+	, file( fileName.c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc )
+	, buffer( file, format )
+{
+	rdbuf( &buffer );
+	if (!file.is_open()) {
+		setstate( std::ios_base::badbit );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+CompressedOutputStream::
+~CompressedOutputStream()
+{
+	// finish compressed stream before the file is closed
+	buffer.close();
+	file.close();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
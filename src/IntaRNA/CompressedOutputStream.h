@@ -0,0 +1,192 @@
+
+#ifndef INTARNA_COMPRESSEDOUTPUTSTREAM_H_
+#define INTARNA_COMPRESSEDOUTPUTSTREAM_H_
+
+#include "IntaRNA/general.h"
+
+#include <fstream>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace IntaRNA {
+
+/**
+ * Stream buffer that compresses all written output (gzip or zstd format)
+ * and writes the compressed data to a sink stream.
+ *
+ * The supported formats depend on the libraries available at build time
+ * (see isSupported()).
+ *
+ * sync() (i.e. flushing the according stream) compresses the buffered
+ * output without finishing the compressed stream; the compressed stream is
+ * finished by close() or the destruction.
+ */
+class CompressedOutputBuffer : public std::streambuf {
+
+public:
+
+	//! supported compression formats
+	enum Format {
+		GZIP, //!< gzip format via zlib
+		ZSTD //!< zstd format via libzstd
+	};
+
+	//! size of the input and output buffers
+	static const size_t bufferSize;
+
+	/**
+	 * Whether or not the given format is supported by this build
+	 * @param format the format of interest
+	 * @return true if output can be compressed in this format
+	 */
+	static
+	bool
+	isSupported( const Format format );
+
+	/**
+	 * Identifies the compression format from the file name extension, i.e.
+	 * '.gz' for GZIP and '.zst' for ZSTD (case insensitive).
+	 * @param fileName the name of the file to be written
+	 * @param format OUT the identified format
+	 * @return true if the file name has a compression extension; false
+	 *         otherwise (format not changed)
+	 */
+	static
+	bool
+	getFormat( const std::string & fileName, Format & format );
+
+public:
+
+	/**
+	 * Construction
+	 * @param sink the stream to write the compressed data to
+	 *        (not deleted by the buffer)
+	 * @param format the compression format to be used
+	 * @throws std::runtime_error if the format is not supported or
+	 *         the compressor could not be initialized
+	 */
+	CompressedOutputBuffer( std::ostream & sink, const Format format );
+
+	/**
+	 * Destruction; finishes the compressed stream (see close())
+	 */
+	virtual ~CompressedOutputBuffer();
+
+	/**
+	 * Compresses all pending output and finishes the compressed stream.
+	 * Afterwards, no further output is accepted.
+	 * @return true if all output was successfully written; false otherwise
+	 */
+	bool
+	close();
+
+protected:
+
+	/**
+	 * Compresses the buffered output and stores the given character.
+	 * @param c the character to store
+	 * @return c on success; traits_type::eof() otherwise
+	 */
+	virtual
+	int_type
+	overflow( int_type c );
+
+	/**
+	 * Compresses the buffered output and flushes the sink.
+	 * @return 0 on success; -1 otherwise
+	 */
+	virtual
+	int
+	sync();
+
+protected:
+
+	//! the stream to write the compressed data to
+	std::ostream & sink;
+
+	//! the compression format
+	const Format format;
+
+	//! the compressor state (format specific)
+	void * compressor;
+
+	//! the uncompressed output (put area)
+	std::vector<char> in;
+
+	//! buffer for the compressed data
+	std::vector<char> out;
+
+	//! whether or not the stream was finished or an error occurred
+	bool closed;
+
+	/**
+	 * Compresses the buffered output and writes the compressed data
+	 * available to the sink.
+	 * @param finish whether or not the compressed stream is to be finished
+	 * @return true on success; false otherwise
+	 */
+	bool
+	compress( const bool finish );
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+/**
+ * Output file stream whose content is compressed via a
+ * CompressedOutputBuffer.
+ */
+class CompressedOutputStream : public std::ostream {
+
+public:
+
+	/**
+	 * Construction; opens the file for writing
+	 * @param fileName the name of the file to write
+	 * @param format the compression format to be used
+	 * @throws std::runtime_error if the format is not supported
+	 */
+	CompressedOutputStream( const std::string & fileName
+						, const CompressedOutputBuffer::Format format );
+
+	/**
+	 * Destruction; finishes the compressed stream and closes the file
+	 */
+	virtual ~CompressedOutputStream();
+
+	/**
+	 * Whether or not the file was successfully opened
+	 * @return true if the file is open
+	 */
+	bool
+	is_open() const;
+
+protected:
+
+	//! the compressed file
+	std::ofstream file;
+
+	//! the compressing buffer
+	CompressedOutputBuffer buffer;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+CompressedOutputStream::
+is_open() const
+{
+	return file.is_open();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_COMPRESSEDOUTPUTSTREAM_H_ */
@@ -0,0 +1,155 @@
+
+#include "IntaRNA/EdBandMatrix.h"
+
+#include <limits>
+
+namespace IntaRNA {
+
+/////////////////////////////////////////////////////////////////////////////
+
+const E_type EdBandMatrix::fixedPointResolution = (E_type)0.01;
+
+const uint16_t EdBandMatrix::fixedPointINF = std::numeric_limits<uint16_t>::max();
+
+/////////////////////////////////////////////////////////////////////////////
+
+EdBandMatrix::
+EdBandMatrix()
+ :	seqLength(0)
+	, maxLength(0)
+	, reducedPrecision(false)
+	, values()
+	, fixedPointValues()
+	, externalData()
+	, valuesData(NULL)
+	, fixedPointData(NULL)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+EdBandMatrix::
+EdBandMatrix( const size_t seqLength
+			, const size_t maxLength
+			, const bool reducedPrecision )
+ :	seqLength(0)
+	, maxLength(0)
+	, reducedPrecision(false)
+	, values()
+	, fixedPointValues()
+	, externalData()
+	, valuesData(NULL)
+	, fixedPointData(NULL)
+{
+	resize( seqLength, maxLength, reducedPrecision );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+EdBandMatrix::
+EdBandMatrix( const EdBandMatrix & toCopy )
+ :	seqLength(toCopy.seqLength)
+	, maxLength(toCopy.maxLength)
+	, reducedPrecision(toCopy.reducedPrecision)
+	, values(toCopy.values)
+	, fixedPointValues(toCopy.fixedPointValues)
+	, externalData(toCopy.externalData)
+	, valuesData(NULL)
+	, fixedPointData(NULL)
+{
+	updateDataAccess();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+EdBandMatrix &
+EdBandMatrix::
+operator=( const EdBandMatrix & toCopy )
+{
+	if (this != &toCopy) {
+		seqLength = toCopy.seqLength;
+		maxLength = toCopy.maxLength;
+		reducedPrecision = toCopy.reducedPrecision;
+		values = toCopy.values;
+		fixedPointValues = toCopy.fixedPointValues;
+		externalData = toCopy.externalData;
+		updateDataAccess();
+	}
+	return *this;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void
+EdBandMatrix::
+resize( const size_t seqLength
+		, const size_t maxLength
+		, const bool reducedPrecision )
+{
+	this->seqLength = seqLength;
+	this->maxLength = maxLength;
+	this->reducedPrecision = reducedPrecision;
+	// drop old values
+	values.clear();
+	fixedPointValues.clear();
+	externalData.reset();
+	// allocate one row for each region start
+	if (reducedPrecision) {
+		fixedPointValues.resize( seqLength*maxLength, 0 );
+		HugePageAllocator<E_type>::vector().swap( values );
+	} else {
+		values.resize( seqLength*maxLength, 0 );
+		HugePageAllocator<uint16_t>::vector().swap( fixedPointValues );
+	}
+	updateDataAccess();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void
+EdBandMatrix::
+setData( const size_t seqLength
+		, const size_t maxLength
+		, const bool reducedPrecision
+		, const std::shared_ptr<const char> & data )
+{
+	this->seqLength = seqLength;
+	this->maxLength = maxLength;
+	this->reducedPrecision = reducedPrecision;
+	// drop own storage
+	HugePageAllocator<E_type>::vector().swap( values );
+	HugePageAllocator<uint16_t>::vector().swap( fixedPointValues );
+	externalData = data;
+	updateDataAccess();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void
+EdBandMatrix::
+updateDataAccess()
+{
+	if (isReadOnly()) {
+		valuesData = reducedPrecision ? NULL : reinterpret_cast<const E_type*>(externalData.get());
+		fixedPointData = reducedPrecision ? reinterpret_cast<const uint16_t*>(externalData.get()) : NULL;
+	} else {
+		valuesData = values.empty() ? NULL : &(values[0]);
+		fixedPointData = fixedPointValues.empty() ? NULL : &(fixedPointValues[0]);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+size_t
+EdBandMatrix::
+getMemoryEstimate( const size_t seqLength
+				, const size_t maxLength
+				, const bool reducedPrecision )
+{
+	return seqLength * std::min( seqLength, maxLength )
+			* (reducedPrecision ? sizeof(uint16_t) : sizeof(E_type));
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
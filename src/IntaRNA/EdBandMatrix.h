@@ -0,0 +1,379 @@
+
+#ifndef INTARNA_EDBANDMATRIX_H_
+#define INTARNA_EDBANDMATRIX_H_
+
+#include "IntaRNA/general.h"
+#include "IntaRNA/HugePageAllocator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace IntaRNA {
+
+/**
+ * Storage of the ED values of all regions [from,to] of a sequence with a
+ * length (to-from+1) of at most maxLength.
+ *
+ * The values are stored row-wise for each region start 'from' within one
+ * contiguous block, where each row holds the maxLength values for all
+ * region ends to = from..from+maxLength-1. Thus, the access to the value of
+ * a region is given by the index from*maxLength+(to-from).
+ *
+ * Optionally, values are stored in a reduced precision 16-bit fixed-point
+ * encoding with a resolution of fixedPointResolution, which halves the
+ * memory consumption. Infinite values (E_INF) are stored explicitly, finite
+ * values exceeding the representable range are set to the maximal
+ * representable finite value.
+ *
+ * Instead of an own storage, the matrix can provide the values of an
+ * external read-only storage (see setData()), e.g. a memory mapped file
+ * shared by several processes.
+ *
+ */
+class EdBandMatrix {
+
+public:
+
+	//! the resolution of ED values in reduced precision mode
+	static const E_type fixedPointResolution;
+
+public:
+
+	/**
+	 * Construction of an empty matrix
+	 */
+	EdBandMatrix();
+
+	/**
+	 * Construction of a matrix with all values set to 0
+	 *
+	 * @param seqLength the length of the sequence
+	 * @param maxLength the maximal length of regions to be stored
+	 * @param reducedPrecision whether or not to store the values in the
+	 *        reduced precision fixed-point encoding
+	 */
+	EdBandMatrix( const size_t seqLength
+				, const size_t maxLength
+				, const bool reducedPrecision = false );
+
+	/**
+	 * Copy construction; an external storage is shared with the copy
+	 * @param toCopy the matrix to copy
+	 */
+	EdBandMatrix( const EdBandMatrix & toCopy );
+
+	/**
+	 * Assignment; an external storage is shared with the copy
+	 * @param toCopy the matrix to copy
+	 * @return this matrix
+	 */
+	EdBandMatrix &
+	operator=( const EdBandMatrix & toCopy );
+
+	/**
+	 * Resizes the matrix and resets all values to 0
+	 *
+	 * @param seqLength the length of the sequence
+	 * @param maxLength the maximal length of regions to be stored
+	 * @param reducedPrecision whether or not to store the values in the
+	 *        reduced precision fixed-point encoding
+	 */
+	void
+	resize( const size_t seqLength
+			, const size_t maxLength
+			, const bool reducedPrecision = false );
+
+	/**
+	 * Uses an external read-only storage for the values instead of an own
+	 * storage. The values are not copied; the matrix keeps a reference to
+	 * the storage until it is resized or destroyed.
+	 *
+	 * @param seqLength the length of the sequence
+	 * @param maxLength the maximal length of regions stored
+	 * @param reducedPrecision whether or not the values are stored in the
+	 *        reduced precision fixed-point encoding
+	 * @param data the value storage of getMemoryEstimate() bytes in the
+	 *        layout of getData(), suitably aligned for the value type
+	 */
+	void
+	setData( const size_t seqLength
+			, const size_t maxLength
+			, const bool reducedPrecision
+			, const std::shared_ptr<const char> & data );
+
+	/**
+	 * Whether or not the values are provided by an external read-only
+	 * storage (see setData())
+	 * @return true if the values can not be altered; false otherwise
+	 */
+	bool
+	isReadOnly() const;
+
+	/**
+	 * Access to the length of the sequence
+	 * @return the sequence length
+	 */
+	size_t
+	getSeqLength() const;
+
+	/**
+	 * Access to the maximal length of stored regions
+	 * @return the maximal region length
+	 */
+	size_t
+	getMaxLength() const;
+
+	/**
+	 * Whether or not values are stored in reduced precision
+	 * @return true if the fixed-point encoding is used; false otherwise
+	 */
+	bool
+	isReducedPrecision() const;
+
+	/**
+	 * Access to the ED value of a region
+	 *
+	 * @param from the start index of the region
+	 * @param to the end index of the region with (to-from+1) <= maxLength
+	 * @return the stored ED value
+	 *
+	 * @throw std::runtime_error in debug mode if the region is not covered
+	 */
+	E_type
+	get( const size_t from, const size_t to ) const;
+
+	/**
+	 * Sets the ED value of a region
+	 *
+	 * @param from the start index of the region
+	 * @param to the end index of the region with (to-from+1) <= maxLength
+	 * @param ed the ED value to store (>= 0)
+	 *
+	 * @throw std::runtime_error in debug mode if the region is not covered
+	 */
+	void
+	set( const size_t from, const size_t to, const E_type ed );
+
+	/**
+	 * Access to the raw storage, e.g. for direct file input
+	 * @return the first byte of the value storage (NULL if read-only)
+	 */
+	char *
+	getData();
+
+	/**
+	 * Access to the raw storage, e.g. for direct file output
+	 * @return the first byte of the value storage
+	 */
+	const char *
+	getData() const;
+
+	/**
+	 * Size of the raw storage
+	 * @return the number of bytes of the value storage
+	 */
+	size_t
+	getDataSize() const;
+
+	/**
+	 * Computes the memory needed for the values of a matrix of the given
+	 * dimensions (see resize()).
+	 *
+	 * @param seqLength the length of the sequence
+	 * @param maxLength the maximal length of regions to be stored
+	 * @param reducedPrecision whether or not the values are stored in the
+	 *        reduced precision fixed-point encoding
+	 * @return the estimated number of bytes
+	 */
+	static
+	size_t
+	getMemoryEstimate( const size_t seqLength
+					, const size_t maxLength
+					, const bool reducedPrecision = false );
+
+
+protected:
+
+	//! fixed-point encoding of infinite values
+	static const uint16_t fixedPointINF;
+
+	//! the length of the sequence
+	size_t seqLength;
+
+	//! the maximal length of stored regions, i.e. the row stride
+	size_t maxLength;
+
+	//! whether or not fixedPointValues is used instead of values
+	bool reducedPrecision;
+
+	//! the values in full precision (if !reducedPrecision)
+	HugePageAllocator<E_type>::vector values;
+
+	//! the values in fixed-point encoding (if reducedPrecision)
+	HugePageAllocator<uint16_t>::vector fixedPointValues;
+
+	//! the external read-only storage (NULL if the own storage is used)
+	std::shared_ptr<const char> externalData;
+
+	//! the full precision values accessed (own or external storage)
+	const E_type * valuesData;
+
+	//! the fixed-point values accessed (own or external storage)
+	const uint16_t * fixedPointData;
+
+	/**
+	 * Updates the value access after a storage change
+	 */
+	void
+	updateDataAccess();
+
+	/**
+	 * Checks the region boundaries in debug mode
+	 * @param from the start index of the region
+	 * @param to the end index of the region
+	 * @throw std::runtime_error if the region is not covered
+	 */
+	void
+	checkIndices( const size_t from, const size_t to ) const;
+
+};
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+EdBandMatrix::
+getSeqLength() const
+{
+	return seqLength;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+EdBandMatrix::
+isReadOnly() const
+{
+	return externalData.get() != NULL;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+EdBandMatrix::
+getMaxLength() const
+{
+	return maxLength;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+EdBandMatrix::
+isReducedPrecision() const
+{
+	return reducedPrecision;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+inline
+void
+EdBandMatrix::
+checkIndices( const size_t from, const size_t to ) const
+{
+#if INTARNA_IN_DEBUG_MODE
+	if (from > to || to >= seqLength || (to-from) >= maxLength) {
+		throw std::runtime_error("EdBandMatrix::checkIndices : region ["+toString(from)+","+toString(to)+"] is not covered");
+	}
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+inline
+E_type
+EdBandMatrix::
+get( const size_t from, const size_t to ) const
+{
+	checkIndices( from, to );
+	if (reducedPrecision) {
+		const uint16_t ed = fixedPointData[ from*maxLength + (to-from) ];
+		return ed == fixedPointINF ? E_INF : (E_type)ed * fixedPointResolution;
+	}
+	return valuesData[ from*maxLength + (to-from) ];
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+inline
+void
+EdBandMatrix::
+set( const size_t from, const size_t to, const E_type ed )
+{
+	checkIndices( from, to );
+#if INTARNA_IN_DEBUG_MODE
+	if (isReadOnly()) {
+		throw std::runtime_error("EdBandMatrix::set() : read-only storage");
+	}
+#endif
+	if (reducedPrecision) {
+		fixedPointValues[ from*maxLength + (to-from) ] = E_isINF(ed)
+				? fixedPointINF
+				: (uint16_t)std::min<E_type>( (E_type)(fixedPointINF-1), std::floor( std::max<E_type>( 0, ed ) / fixedPointResolution + 0.5 ) );
+	} else {
+		values[ from*maxLength + (to-from) ] = ed;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+inline
+char *
+EdBandMatrix::
+getData()
+{
+	if (getDataSize() == 0 || isReadOnly()) { return NULL; }
+	return reducedPrecision ? (char*)&(fixedPointValues[0]) : (char*)&(values[0]);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+inline
+const char *
+EdBandMatrix::
+getData() const
+{
+	if (getDataSize() == 0) { return NULL; }
+	return reducedPrecision ? (const char*)fixedPointData : (const char*)valuesData;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+EdBandMatrix::
+getDataSize() const
+{
+	if (isReadOnly()) {
+		return seqLength*maxLength*(reducedPrecision ? sizeof(uint16_t) : sizeof(E_type));
+	}
+	return reducedPrecision
+			? fixedPointValues.size()*sizeof(uint16_t)
+			: values.size()*sizeof(E_type);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_EDBANDMATRIX_H_ */
@@ -0,0 +1,256 @@
+
+#include "IntaRNA/FastaReader.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+#if INTARNA_HAVE_MMAP
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace IntaRNA {
+
+////////////////////////////////////////////////////////////////////////////
+
+FastaReader::
+FastaReader( const std::string & fileName )
+ :	data(NULL)
+	, dataSize(0)
+	, mapped(false)
+	, buffer()
+	, records()
+	, faiIndexed(false)
+{
+#if INTARNA_HAVE_MMAP
+	// try to map the file
+	const int fd = open( fileName.c_str(), O_RDONLY );
+	if (fd < 0) {
+		throw std::runtime_error("FastaReader() : could not open FASTA file '"+fileName+"'");
+	}
+	struct stat fileStat;
+	if (fstat( fd, &fileStat ) == 0 && fileStat.st_size > 0) {
+		void * map = mmap( NULL, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+		if (map != MAP_FAILED) {
+			data = static_cast<const char*>(map);
+			dataSize = (size_t)fileStat.st_size;
+			mapped = true;
+		}
+	}
+	close( fd );
+#endif
+	// read the whole file if not mapped
+	if (!mapped) {
+		std::ifstream in( fileName.c_str(), std::ios_base::in | std::ios_base::binary );
+		if (!in.good()) {
+			throw std::runtime_error("FastaReader() : could not open FASTA file '"+fileName+"'");
+		}
+		buffer.assign( std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() );
+		data = buffer.empty() ? NULL : &(buffer[0]);
+		dataSize = buffer.size();
+	}
+
+	// setup record index
+	faiIndexed = readFai( fileName+".fai" );
+	if (!faiIndexed) {
+		scanRecords();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+FastaReader::
+~FastaReader()
+{
+#if INTARNA_HAVE_MMAP
+	if (mapped) {
+		munmap( const_cast<char*>(data), dataSize );
+	}
+#endif
+	data = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+size_t
+FastaReader::
+getLineEnd( const size_t pos, const size_t end ) const
+{
+	const void * lineEnd = std::memchr( data+pos, '\n', end-pos );
+	return lineEnd == NULL ? end : (size_t)(static_cast<const char*>(lineEnd) - data);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+FastaReader::
+scanRecords()
+{
+	records.clear();
+	for (size_t pos = 0; pos < dataSize; ) {
+		const size_t lineEnd = getLineEnd( pos, dataSize );
+		if (data[pos] == '>') {
+			// close last record
+			if (!records.empty()) {
+				records.rbegin()->end = pos;
+			}
+			// start new record
+			Record record;
+			record.header = pos;
+			record.begin = std::min( lineEnd+1, dataSize );
+			record.end = dataSize;
+			record.length = std::string::npos;
+			records.push_back( record );
+		} else
+		// sequence data without leading header
+		if (records.empty()) {
+			for (size_t p = pos; p < lineEnd; p++) {
+				if (!std::isspace( (unsigned char)data[p] )) {
+					throw std::runtime_error("FastaReader() : found sequence data without leading ID");
+				}
+			}
+		}
+		pos = lineEnd+1;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+FastaReader::
+readFai( const std::string & faiName )
+{
+	records.clear();
+	std::ifstream fai( faiName.c_str() );
+	if (!fai.good()) {
+		return false;
+	}
+	std::string line, name;
+	while (std::getline( fai, line )) {
+		if (line.empty()) {
+			continue;
+		}
+		// parse : name, length, offset, line bases, line width
+		std::istringstream lineIn( line );
+		Record record;
+		size_t lineBases = 0, lineWidth = 0;
+		if (!(std::getline( lineIn, name, '\t' ) >> record.length >> record.begin >> lineBases >> lineWidth)
+			|| lineBases == 0 || lineWidth < lineBases
+			|| record.begin == 0 || record.begin > dataSize
+			|| data[record.begin-1] != '\n')
+		{
+			records.clear();
+			return false;
+		}
+		record.end = record.begin + (record.length/lineBases)*lineWidth + (record.length%lineBases);
+		// find header line start
+		record.header = record.begin-1;
+		while (record.header > 0 && data[record.header-1] != '\n') {
+			record.header--;
+		}
+		// check consistency with the data (first word of the header)
+		if (record.end > dataSize
+			|| data[record.header] != '>'
+			|| record.header+1+name.size() >= record.begin
+			|| name.compare( 0, name.size(), data+record.header+1, name.size() ) != 0
+			|| !std::isspace( (unsigned char)data[record.header+1+name.size()] ))
+		{
+			records.clear();
+			return false;
+		}
+		records.push_back( record );
+	}
+	return !records.empty();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+std::string
+FastaReader::
+getId( const size_t i ) const
+{
+	const Record & record = records.at(i);
+	// trim leading '>' plus successive and trailing whitespaces
+	size_t idStart = record.header+1;
+	size_t idEnd = getLineEnd( record.header, record.begin );
+	while (idStart < idEnd && std::isspace( (unsigned char)data[idStart] )) {
+		idStart++;
+	}
+	while (idEnd > idStart && std::isspace( (unsigned char)data[idEnd-1] )) {
+		idEnd--;
+	}
+	return std::string( data+idStart, idEnd-idStart );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+FastaReader::
+getSequence( const size_t i, std::string & sequence ) const
+{
+	const Record & record = records.at(i);
+	sequence.clear();
+	sequence.reserve( record.length == std::string::npos ? record.end-record.begin : record.length );
+	for (size_t pos = record.begin; pos < record.end; ) {
+		size_t lineEnd = getLineEnd( pos, record.end );
+		const size_t nextPos = lineEnd+1;
+		// trim leading/trailing whitespaces
+		while (pos < lineEnd && std::isspace( (unsigned char)data[pos] )) {
+			pos++;
+		}
+		while (lineEnd > pos && std::isspace( (unsigned char)data[lineEnd-1] )) {
+			lineEnd--;
+		}
+		// check for enclosed whitespaces
+		if (std::memchr( data+pos, ' ', lineEnd-pos ) != NULL) {
+			throw std::runtime_error("FastaReader::getSequence() : sequence for ID '"+getId(i)+"' contains spaces");
+		}
+		sequence.append( data+pos, lineEnd-pos );
+		pos = nextPos;
+	}
+	// check consistency with index
+	if (record.length != std::string::npos && sequence.size() != record.length) {
+		throw std::runtime_error("FastaReader::getSequence() : sequence length of ID '"+getId(i)+"' differs from the .fai index");
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+size_t
+FastaReader::
+appendSequence( const size_t i
+				, size_t & filePos
+				, const size_t length
+				, std::string & sequence ) const
+{
+	const Record & record = records.at(i);
+	size_t pos = std::max( filePos, record.begin );
+	size_t appended = 0;
+	while (pos < record.end && appended < length) {
+		const size_t lineEnd = getLineEnd( pos, record.end );
+		// copy all non-whitespace characters of the line up to the length
+		for (; pos < lineEnd && appended < length; pos++) {
+			if (!std::isspace( (unsigned char)data[pos] )) {
+				sequence.push_back( data[pos] );
+				appended++;
+			}
+		}
+		// skip line break
+		if (pos == lineEnd) {
+			pos = lineEnd+1;
+		}
+	}
+	filePos = std::min( pos, record.end );
+	return appended;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
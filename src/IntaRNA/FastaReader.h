@@ -0,0 +1,185 @@
+
+#ifndef INTARNA_FASTAREADER_H_
+#define INTARNA_FASTAREADER_H_
+
+#include "IntaRNA/general.h"
+
+#include <string>
+#include <vector>
+
+namespace IntaRNA {
+
+/**
+ * Random access reader for FASTA files.
+ *
+ * The file is memory mapped (if supported by the system; otherwise it is
+ * read into memory at once) and the records are located via an index. If a
+ * '.fai' index (as generated by 'samtools faidx') is present next to the
+ * file, it is used and only the headers and sequence data of records that
+ * are accessed are read. Otherwise, the index is set up by scanning the
+ * line starts of the file once.
+ *
+ * The ID of a record is its full header line without the leading '>' and
+ * surrounding whitespace. The sequence of a record is the concatenation of
+ * its lines without surrounding whitespace.
+ */
+class FastaReader {
+
+public:
+
+	/**
+	 * Maps the file and sets up the record index.
+	 *
+	 * @param fileName the FASTA file to read
+	 * @throws std::runtime_error if the file can not be read or contains
+	 *         sequence data without leading header
+	 */
+	FastaReader( const std::string & fileName );
+
+	/**
+	 * Destruction; unmaps the file
+	 */
+	virtual ~FastaReader();
+
+	/**
+	 * Number of records within the file
+	 * @return the number of records
+	 */
+	size_t
+	size() const;
+
+	/**
+	 * Whether or not the record index was read from a '.fai' file
+	 * @return true if the '.fai' index is used; false otherwise
+	 */
+	bool
+	isFaiIndexed() const;
+
+	/**
+	 * Provides the ID of the given record
+	 * @param i the index of the record (0-based)
+	 * @return the ID of the record
+	 */
+	std::string
+	getId( const size_t i ) const;
+
+	/**
+	 * Provides the sequence of the given record. The sequence is copied
+	 * directly from the mapped file without intermediate line copies.
+	 *
+	 * @param i the index of the record (0-based)
+	 * @param sequence OUT the container to fill with the sequence
+	 * @throws std::runtime_error if a line contains enclosed spaces or the
+	 *         sequence length does not match the '.fai' index
+	 */
+	void
+	getSequence( const size_t i, std::string & sequence ) const;
+
+	/**
+	 * Appends the next part of the sequence of the given record, such that
+	 * long sequences can be read piecewise without copying them at once.
+	 * Whitespaces and line breaks are skipped.
+	 *
+	 * @param i the index of the record (0-based)
+	 * @param filePos IN/OUT the file position to continue reading from
+	 *        (0 = start of the record); updated to the position after the
+	 *        last base appended
+	 * @param length the maximal number of bases to append
+	 * @param sequence IN/OUT the container to append the bases to
+	 * @return the number of bases appended (0 if the end of the record is
+	 *         reached)
+	 */
+	size_t
+	appendSequence( const size_t i
+					, size_t & filePos
+					, const size_t length
+					, std::string & sequence ) const;
+
+protected:
+
+	/**
+	 * Location of a record within the file
+	 */
+	class Record {
+	public:
+		//! position of the header line (i.e. of its '>')
+		size_t header;
+		//! first position of the sequence data
+		size_t begin;
+		//! position after the sequence data
+		size_t end;
+		//! sequence length as given by the '.fai' index;
+		//! std::string::npos if not known
+		size_t length;
+	};
+
+	//! start of the file content
+	const char * data;
+
+	//! length of the file content
+	size_t dataSize;
+
+	//! whether or not data is memory mapped
+	bool mapped;
+
+	//! file content if it could not be memory mapped
+	std::vector<char> buffer;
+
+	//! the records of the file
+	std::vector<Record> records;
+
+	//! whether or not the record index was read from a '.fai' file
+	bool faiIndexed;
+
+	/**
+	 * Sets up the record index by scanning the line starts of the file
+	 */
+	void
+	scanRecords();
+
+	/**
+	 * Sets up the record index from a '.fai' index file
+	 * @param faiName the '.fai' file name
+	 * @return true if the index was read and is consistent with the data;
+	 *         false otherwise (records empty)
+	 */
+	bool
+	readFai( const std::string & faiName );
+
+	/**
+	 * Provides the position after the line starting at the given position
+	 * (without its line break)
+	 * @param pos the line start
+	 * @param end the position after the region of interest
+	 * @return the position of the next '\n' or end if there is none
+	 */
+	size_t
+	getLineEnd( const size_t pos, const size_t end ) const;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+FastaReader::
+size() const
+{
+	return records.size();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+FastaReader::
+isFaiIndexed() const
+{
+	return faiIndexed;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_FASTAREADER_H_ */
@@ -0,0 +1,341 @@
+
+#include "IntaRNA/GenomeScanner.h"
+
+#include <algorithm>
+#include <exception>
+#include <sstream>
+#include <stdexcept>
+
+#if INTARNA_MULITHREADING
+	#include <omp.h>
+#endif
+
+namespace IntaRNA {
+
+////////////////////////////////////////////////////////////////////////////
+
+GenomeScanner::FastaStream::
+FastaStream( const FastaReader & reader_, const size_t record_ )
+ :	reader(reader_)
+	, record(record_)
+	, filePos(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+size_t
+GenomeScanner::FastaStream::
+read( const size_t length, std::string & sequence )
+{
+	return reader.appendSequence( record, filePos, length, sequence );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+GenomeScanner::Chunk::
+Chunk()
+ :	sequence(NULL)
+	, accessibility(NULL)
+	, offset(0)
+	, from(0)
+	, to(0)
+	, isLast(false)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+GenomeScanner::Chunk::
+~Chunk()
+{
+	INTARNA_CLEANUP( accessibility );
+	INTARNA_CLEANUP( sequence );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+GenomeScanner::
+GenomeScanner( const Parameters & parameters_, const size_t chunkLength_ )
+ :	BatchPredictor( parameters_ )
+	, chunkLength( chunkLength_ )
+	, chunkOverlap( parameters_.tIntLenMax )
+	, chunkContext( parameters_.tAcc == 'C' ? parameters_.tAccW : 0 )
+{
+	// check setup
+	if (parameters.tIntLenMax == 0) {
+		throw std::runtime_error("GenomeScanner() : tIntLenMax has to be positive");
+	}
+	if (chunkLength <= chunkOverlap) {
+		throw std::runtime_error("GenomeScanner() : chunkLength = "+toString(chunkLength)+" has to exceed tIntLenMax = "+toString(chunkOverlap));
+	}
+	if (parameters.tAcc == 'C' && parameters.tAccW == 0) {
+		throw std::runtime_error("GenomeScanner() : tAccW has to be positive for computed target accessibility");
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+GenomeScanner::
+~GenomeScanner()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+GenomeScanner::
+scan( const FastaReader & targetFile
+		, const size_t targetRecord
+		, const std::vector< RnaSequence > & queries
+		, HitHandler & hits )
+{
+	FastaStream target( targetFile, targetRecord );
+	scan( targetFile.getId( targetRecord ), target, queries, hits );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+GenomeScanner::
+scan( const std::string & targetId
+		, SequenceStream & target
+		, const std::vector< RnaSequence > & queries
+		, HitHandler & hits )
+{
+	// compute query accessibilities once for all chunks
+	std::vector< ReverseAccessibility * > queryAcc;
+	// target bases read but not yet dropped
+	std::string buffer;
+	size_t bufferOffset = 0;
+	// the chunk predicted for and the chunk prepared in parallel
+	Chunk * current = NULL;
+	Chunk * next = NULL;
+	// interactions of the current chunk per query
+	std::vector< OutputHandlerInteractionList * > results( queries.size(), NULL );
+	std::vector< InteractionEnergy * > energies( queries.size(), NULL );
+	// interactions of the previous chunk within the overlap with the current
+	std::set< HitKey > reported;
+
+	try {
+		initQueryAccessibilities( queries, queryAcc );
+
+		current = readChunk( targetId, target, 0, buffer, bufferOffset );
+		if (current != NULL) {
+			current->accessibility = getAccessibility( *(current->sequence), parameters.tAcc, parameters.tAccW, parameters.tAccL, parameters.tIntLenMax );
+			INTARNA_CHECK_NOT_NULL(current->accessibility,"chunk accessibility initialization failed");
+		}
+
+		while (current != NULL) {
+			const size_t nextFrom = current->to - chunkOverlap;
+			if (!current->isLast) {
+				next = readChunk( targetId, target, nextFrom, buffer, bufferOffset );
+			}
+
+#if INTARNA_MULITHREADING
+			// OMP shared variables to enable exception forwarding from within OMP parallelized for loop
+			bool threadAborted = false;
+			std::exception_ptr exceptionPtrDuringOmp = NULL;
+			std::stringstream exceptionInfoDuringOmp;
+
+			// job 0 : accessibility of the next chunk (the longest job first)
+			// job q+1 : prediction of the current chunk with query q
+			# pragma omp parallel for schedule(dynamic) num_threads( threads ) shared(current,next,queryAcc,results,energies,threadAborted,exceptionPtrDuringOmp,exceptionInfoDuringOmp)
+#endif
+			for (size_t job=0; job<=queryAcc.size(); job++) {
+#if INTARNA_MULITHREADING
+				#pragma omp flush (threadAborted)
+				// explicit try-catch-block due to missing OMP exception forwarding
+				if (!threadAborted) {
+					try {
+#endif
+						if (job == 0) {
+							if (next != NULL) {
+								next->accessibility = getAccessibility( *(next->sequence), parameters.tAcc, parameters.tAccW, parameters.tAccL, parameters.tIntLenMax );
+								INTARNA_CHECK_NOT_NULL(next->accessibility,"chunk accessibility initialization failed");
+							}
+						} else {
+							results[job-1] = predictChunk( *current, *(queryAcc.at(job-1)), energies[job-1] );
+						}
+#if INTARNA_MULITHREADING
+					} catch (std::exception & e) {
+						// ensure exception handling for first failed thread only
+						#pragma omp critical(intarna_omp_exception)
+						{
+							if (!threadAborted) {
+								// store exception information
+								exceptionPtrDuringOmp = std::make_exception_ptr(e);
+								exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #chunk "<<current->from <<" #job "<<job <<" : "<<e.what();
+								// trigger abortion of all threads
+								threadAborted = true;
+								#pragma omp flush (threadAborted)
+							}
+						} // omp critical(intarna_omp_exception)
+					} catch (...) {
+						// ensure exception handling for first failed thread only
+						#pragma omp critical(intarna_omp_exception)
+						{
+							if (!threadAborted) {
+								// store exception information
+								exceptionPtrDuringOmp = std::current_exception();
+								exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #chunk "<<current->from <<" #job "<<job;
+								// trigger abortion of all threads
+								threadAborted = true;
+								#pragma omp flush (threadAborted)
+							}
+						} // omp critical(intarna_omp_exception)
+					}
+				} // if not threadAborted
+#endif
+			}
+
+#if INTARNA_MULITHREADING
+			// forward exceptions thrown within the parallel region
+			if (threadAborted) {
+				if (!exceptionInfoDuringOmp.str().empty()) {
+					LOG(WARNING) <<"Exception raised for : "<<exceptionInfoDuringOmp.str();
+				}
+				if (exceptionPtrDuringOmp != NULL) {
+					std::rethrow_exception(exceptionPtrDuringOmp);
+				}
+			}
+#endif
+
+			// forward the new interactions of the current chunk
+			reportChunk( *current, nextFrom, results, energies, reported, hits );
+
+			// release the current chunk
+			for (size_t q=0; q<results.size(); q++) {
+				INTARNA_CLEANUP( results[q] );
+				INTARNA_CLEANUP( energies[q] );
+			}
+			INTARNA_CLEANUP( current );
+			current = next;
+			next = NULL;
+		}
+	} catch (...) {
+		for (size_t q=0; q<results.size(); q++) {
+			INTARNA_CLEANUP( results[q] );
+			INTARNA_CLEANUP( energies[q] );
+		}
+		INTARNA_CLEANUP( current );
+		INTARNA_CLEANUP( next );
+		clearQueryAccessibilities( queryAcc );
+		throw;
+	}
+	clearQueryAccessibilities( queryAcc );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+GenomeScanner::Chunk *
+GenomeScanner::
+readChunk( const std::string & targetId
+			, SequenceStream & target
+			, const size_t from
+			, std::string & buffer
+			, size_t & bufferOffset )
+{
+	// drop the bases left of the accessibility context of the chunk
+	const size_t offset = from > chunkContext ? from-chunkContext : 0;
+	if (offset > bufferOffset) {
+		buffer.erase( 0, std::min( buffer.size(), offset-bufferOffset ) );
+		bufferOffset = offset;
+	}
+
+	// read up to the end of the accessibility context of the chunk
+	const size_t chunkEnd = from + chunkLength + chunkContext;
+	bool targetEnd = false;
+	while (!targetEnd && bufferOffset+buffer.size() < chunkEnd) {
+		targetEnd = target.read( chunkEnd-(bufferOffset+buffer.size()), buffer ) == 0;
+	}
+	const size_t bufferEnd = bufferOffset+buffer.size();
+	if (bufferEnd <= from) {
+		return NULL;
+	}
+
+	Chunk * chunk = new Chunk();
+	chunk->offset = bufferOffset;
+	chunk->from = from;
+	chunk->to = std::min( from+chunkLength, bufferEnd );
+	// check whether the target continues after the chunk
+	chunk->isLast = chunk->to == bufferEnd && (targetEnd || target.read( 1, buffer ) == 0);
+	chunk->sequence = new RnaSequence( targetId, buffer.substr( 0, chunk->to+chunkContext-bufferOffset ) );
+
+	return chunk;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+OutputHandlerInteractionList *
+GenomeScanner::
+predictChunk( const Chunk & chunk
+			, const ReverseAccessibility & queryAcc
+			, InteractionEnergy * & energy )
+{
+	energy = getEnergyHandler( *(chunk.accessibility), queryAcc );
+	INTARNA_CHECK_NOT_NULL(energy,"energy initialization failed");
+
+	// collect the interactions to be reported
+	OutputHandlerInteractionList * interactions = new OutputHandlerInteractionList( parameters.outConstraint.reportMax );
+	Predictor * predictor = NULL;
+	try {
+		predictor = getPredictor( *energy, *interactions );
+		INTARNA_CHECK_NOT_NULL(predictor,"predictor initialization failed");
+
+		// predict for the chunk without its accessibility context
+		predictor->predict( IndexRange( chunk.from-chunk.offset, chunk.to-chunk.offset-1 )
+						, IndexRange(0,RnaSequence::lastPos)
+						, parameters.outConstraint );
+	} catch (...) {
+		INTARNA_CLEANUP( predictor );
+		INTARNA_CLEANUP( interactions );
+		throw;
+	}
+	INTARNA_CLEANUP( predictor );
+
+	return interactions;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+GenomeScanner::
+reportChunk( const Chunk & chunk
+			, const size_t nextFrom
+			, const std::vector< OutputHandlerInteractionList * > & results
+			, const std::vector< InteractionEnergy * > & energies
+			, std::set< HitKey > & reported
+			, HitHandler & hits ) const
+{
+	std::set< HitKey > reportedNext;
+	for (size_t q=0; q<results.size(); q++) {
+		if (results.at(q) == NULL) {
+			continue;
+		}
+		for (OutputHandlerInteractionList::const_iterator i = results.at(q)->begin(); i != results.at(q)->end(); i++) {
+			const Interaction & interaction = **i;
+			if (interaction.basePairs.empty()) {
+				continue;
+			}
+			// boundary base pairs in genome coordinates
+			const HitKey key( q, std::make_pair(
+					Interaction::BasePair( interaction.basePairs.begin()->first + chunk.offset, interaction.basePairs.begin()->second )
+					, Interaction::BasePair( interaction.basePairs.rbegin()->first + chunk.offset, interaction.basePairs.rbegin()->second ) ) );
+			// remember interactions within the overlap with the next chunk
+			if (!chunk.isLast && key.second.first.first >= nextFrom) {
+				reportedNext.insert( key );
+			}
+			// skip interactions already reported for the previous chunk
+			if (reported.find( key ) != reported.end()) {
+				continue;
+			}
+			hits.handle( q, chunk.offset, *(energies.at(q)), interaction );
+		}
+	}
+	reported.swap( reportedNext );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
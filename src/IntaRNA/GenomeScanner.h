@@ -0,0 +1,293 @@
+
+#ifndef INTARNA_GENOMESCANNER_H_
+#define INTARNA_GENOMESCANNER_H_
+
+#include "IntaRNA/general.h"
+
+#include "IntaRNA/BatchPredictor.h"
+#include "IntaRNA/FastaReader.h"
+#include "IntaRNA/Interaction.h"
+
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace IntaRNA {
+
+/**
+ * Scans a single long target sequence (e.g. a bacterial chromosome) for
+ * interactions with a set of queries without holding the full target or its
+ * accessibility in memory.
+ *
+ * The target is read piecewise from a SequenceStream and processed in
+ * overlapping chunks of a given length. Successive chunks overlap by the
+ * maximal interaction length within the target (tIntLenMax), such that each
+ * interaction is fully contained in at least one chunk. The accessibility of
+ * a chunk is computed for the chunk extended by tAccW positions on both
+ * sides (if available), such that the accessibility of the chunk's positions
+ * is computed with the same folding context as for the full target.
+ * Predictions are restricted to the (non-extended) chunk.
+ *
+ * Interactions are reported in genome coordinates, i.e. with the offset of
+ * the chunk within the target. Interactions found in two successive chunks
+ * (i.e. within their overlap) with the same boundary base pairs in genome
+ * coordinates are reported only once (for the first chunk).
+ *
+ * At most two chunks are resident at a time : while the interactions of the
+ * current chunk are predicted for all queries, the accessibility of the next
+ * chunk is computed (in parallel if compiled with multi-threading support).
+ *
+ *   GenomeScanner scanner( params, 100000 );
+ *   FastaReader genome( "chromosome.fa" );
+ *   MyHitHandler handler;
+ *   scanner.scan( genome, 0, queries, handler );
+ *
+ */
+class GenomeScanner : public BatchPredictor {
+
+public:
+
+	/**
+	 * Receives the interactions found while scanning a target.
+	 *
+	 * Calls are done by the calling thread of scan() only, chunk by chunk
+	 * in target order and for each chunk in query order.
+	 */
+	class HitHandler {
+	public:
+		virtual ~HitHandler() {}
+		/**
+		 * Handles an interaction found within a chunk of the target. The
+		 * interaction and the energy handler are only valid during the call.
+		 *
+		 * @param queryNumber the index of the query sequence
+		 * @param targetOffset the position of the chunk within the target,
+		 *        i.e. the genome position of a target index i of the
+		 *        interaction is (i + targetOffset)
+		 * @param energy the energy handler used for the chunk prediction
+		 * @param interaction the interaction found (indices relative to
+		 *        the chunk)
+		 */
+		virtual
+		void
+		handle( const size_t queryNumber
+				, const size_t targetOffset
+				, const InteractionEnergy & energy
+				, const Interaction & interaction ) = 0;
+	};
+
+	/**
+	 * Provides the bases of a long sequence piecewise in sequence order.
+	 *
+	 * Calls are done by the calling thread of scan() only.
+	 */
+	class SequenceStream {
+	public:
+		virtual ~SequenceStream() {}
+		/**
+		 * Appends the next bases of the sequence.
+		 *
+		 * @param length the maximal number of bases to append
+		 * @param sequence IN/OUT the container to append to
+		 * @return the number of bases appended (0 if the end of the
+		 *         sequence is reached)
+		 */
+		virtual
+		size_t
+		read( const size_t length, std::string & sequence ) = 0;
+	};
+
+	/**
+	 * Streams the sequence of a record of a FASTA file.
+	 */
+	class FastaStream : public SequenceStream {
+	public:
+		/**
+		 * Construction
+		 * @param reader the FASTA file to read from
+		 * @param record the index of the record to stream
+		 */
+		FastaStream( const FastaReader & reader, const size_t record );
+		virtual ~FastaStream() {}
+		virtual
+		size_t
+		read( const size_t length, std::string & sequence );
+	protected:
+		//! the FASTA file to read from
+		const FastaReader & reader;
+		//! the index of the record to stream
+		const size_t record;
+		//! the file position to continue reading from
+		size_t filePos;
+	};
+
+public:
+
+	/**
+	 * Construction
+	 *
+	 * @param parameters the prediction setup to be used for all chunks;
+	 *        tIntLenMax has to be positive and, if accessibility is
+	 *        computed, also tAccW
+	 * @param chunkLength the length of the chunks the target is scanned in;
+	 *        has to exceed tIntLenMax
+	 *
+	 * @throws std::runtime_error if the setup is not supported
+	 */
+	GenomeScanner( const Parameters & parameters, const size_t chunkLength );
+
+	/**
+	 * destruction
+	 */
+	virtual ~GenomeScanner();
+
+	/**
+	 * Scans a target for interactions with all queries and forwards them
+	 * to the hit handler.
+	 *
+	 * @param targetId the ID of the target
+	 * @param target the stream providing the target sequence
+	 * @param queries the query sequences
+	 * @param hits the handler receiving the interactions
+	 *
+	 * @throws std::runtime_error if any prediction failed
+	 */
+	void
+	scan( const std::string & targetId
+			, SequenceStream & target
+			, const std::vector< RnaSequence > & queries
+			, HitHandler & hits );
+
+	/**
+	 * Scans a target of a FASTA file for interactions with all queries and
+	 * forwards them to the hit handler.
+	 *
+	 * @param targetFile the FASTA file providing the target
+	 * @param targetRecord the index of the target within the file
+	 * @param queries the query sequences
+	 * @param hits the handler receiving the interactions
+	 *
+	 * @throws std::runtime_error if any prediction failed
+	 */
+	void
+	scan( const FastaReader & targetFile
+			, const size_t targetRecord
+			, const std::vector< RnaSequence > & queries
+			, HitHandler & hits );
+
+	/**
+	 * Access to the chunk length
+	 * @return the length of the chunks the target is scanned in
+	 */
+	size_t
+	getChunkLength() const;
+
+protected:
+
+	/**
+	 * A resident chunk of the target
+	 */
+	class Chunk {
+	public:
+		//! the chunk sequence including the accessibility context
+		RnaSequence * sequence;
+		//! the accessibility of the chunk sequence
+		Accessibility * accessibility;
+		//! target position of the first base of the chunk sequence
+		size_t offset;
+		//! target position of the first base to predict for
+		size_t from;
+		//! target position after the last base to predict for
+		size_t to;
+		//! whether or not this is the last chunk of the target
+		bool isLast;
+
+		Chunk();
+		~Chunk();
+	};
+
+	//! (query, genome positions of the boundary base pairs) of an interaction
+	typedef std::pair< size_t, std::pair< Interaction::BasePair, Interaction::BasePair > > HitKey;
+
+	//! the length of the chunks the target is scanned in
+	const size_t chunkLength;
+
+	//! the number of positions successive chunks overlap
+	const size_t chunkOverlap;
+
+	//! the number of context positions added on both sides of a chunk for
+	//! the accessibility computation
+	const size_t chunkContext;
+
+	/**
+	 * Reads the sequence of the next chunk from the target stream.
+	 *
+	 * @param targetId the ID of the target
+	 * @param target the stream providing the target sequence
+	 * @param from the target position of the first base to predict for
+	 * @param buffer IN/OUT the target bases read so far but not yet
+	 *        dropped; bases not needed for later chunks are removed
+	 * @param bufferOffset IN/OUT the target position of the first base
+	 *        within buffer
+	 * @return the new chunk (without accessibility) or NULL if the target
+	 *        does not contain the given position
+	 */
+	Chunk *
+	readChunk( const std::string & targetId
+				, SequenceStream & target
+				, const size_t from
+				, std::string & buffer
+				, size_t & bufferOffset );
+
+	/**
+	 * Predicts the interactions of a chunk with a query.
+	 *
+	 * @param chunk the chunk (with accessibility) to predict for
+	 * @param queryAcc the query's accessibility
+	 * @param energy OUT the energy handler used (to be deleted by the caller)
+	 * @return the interactions found (to be deleted by the caller)
+	 */
+	OutputHandlerInteractionList *
+	predictChunk( const Chunk & chunk
+				, const ReverseAccessibility & queryAcc
+				, InteractionEnergy * & energy );
+
+	/**
+	 * Forwards the interactions of a chunk to the hit handler, unless they
+	 * were already reported for the previous chunk.
+	 *
+	 * @param chunk the chunk predicted for
+	 * @param nextFrom the first position to predict for of the next chunk
+	 * @param results the interactions of the chunk per query
+	 * @param energies the energy handlers of the chunk per query
+	 * @param reported IN/OUT the interactions of the previous chunk within
+	 *        the overlap with this chunk; replaced by the interactions
+	 *        of this chunk within the overlap with the next chunk
+	 * @param hits the handler receiving the interactions
+	 */
+	void
+	reportChunk( const Chunk & chunk
+				, const size_t nextFrom
+				, const std::vector< OutputHandlerInteractionList * > & results
+				, const std::vector< InteractionEnergy * > & energies
+				, std::set< HitKey > & reported
+				, HitHandler & hits ) const;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+GenomeScanner::
+getChunkLength() const
+{
+	return chunkLength;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_GENOMESCANNER_H_ */
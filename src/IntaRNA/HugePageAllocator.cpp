@@ -0,0 +1,298 @@
+
+#include "IntaRNA/HugePageAllocator.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+
+#if INTARNA_HAVE_MMAP
+	#include <sys/mman.h>
+#endif
+
+namespace IntaRNA {
+
+////////////////////////////////////////////////////////////////////////////
+
+const size_t HugePageMemory::alignment = 64;
+
+const size_t HugePageMemory::hugePageSize = 2 << 20;
+
+////////////////////////////////////////////////////////////////////////////
+
+//! the way a block was allocated
+enum HugePageBlockType {
+	//! cache-line aligned via malloc
+	BLOCK_MALLOC,
+	//! huge page aligned via posix_memalign with transparent huge pages
+	BLOCK_TRANSPARENT,
+	//! explicit huge pages via mmap
+	BLOCK_EXPLICIT
+};
+
+/**
+ * Information of an allocated block that is stored in the cache line
+ * preceding the storage handed out.
+ */
+struct HugePageBlock {
+	//! the start of the allocated memory
+	void * memory;
+	//! the number of bytes allocated starting at memory
+	size_t memorySize;
+	//! the number of bytes usable after the header
+	size_t capacity;
+	//! how the memory was allocated
+	HugePageBlockType type;
+};
+
+/**
+ * Freed large blocks of a thread for reuse.
+ */
+struct HugePageCache {
+	//! the cached blocks in the order of their release
+	std::vector< HugePageBlock * > blocks;
+	//! the overall capacity of the cached blocks
+	size_t size;
+	//! construction
+	HugePageCache() : blocks(), size(0) {}
+	//! releases all cached blocks
+	~HugePageCache();
+};
+
+//! the maximal number of bytes cached per thread
+static std::atomic< size_t > hugePageCacheLimit( 64 << 20 );
+
+//! whether or not explicit huge pages could be allocated so far
+static std::atomic< bool > explicitHugePagesAvailable( true );
+
+//! the freed large blocks of the current thread
+static thread_local HugePageCache hugePageCache;
+
+//! whether or not hugePageCache was already destroyed on thread exit, i.e.
+//! blocks released afterwards (e.g. by static objects) are not cached
+static thread_local bool hugePageCacheDestroyed = false;
+
+////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Access to the header of a block handed out by HugePageMemory::allocate()
+ * @param block the storage handed out
+ * @return the header of the block
+ */
+static
+HugePageBlock *
+getHugePageBlock( void * block )
+{
+	return reinterpret_cast<HugePageBlock*>( static_cast<char*>(block) - HugePageMemory::alignment );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Releases the memory of a block
+ * @param header the header of the block to release
+ */
+static
+void
+releaseHugePageBlock( HugePageBlock * header )
+{
+	void * memory = header->memory;
+	switch (header->type) {
+#if INTARNA_HAVE_MMAP
+	case BLOCK_EXPLICIT :
+		munmap( memory, header->memorySize );
+		break;
+#endif
+	default :
+		free( memory );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+HugePageCache::
+~HugePageCache()
+{
+	for (auto b = blocks.begin(); b != blocks.end(); b++) {
+		releaseHugePageBlock( *b );
+	}
+	hugePageCacheDestroyed = true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Allocates a block backed by huge pages
+ * @param bytes the number of bytes needed after the header
+ * @return the header of the allocated block or NULL if not possible
+ */
+static
+HugePageBlock *
+allocateHugePageBlock( const size_t bytes )
+{
+#if INTARNA_HAVE_MMAP
+	// whole huge pages including the header
+	const size_t memorySize = ((bytes + HugePageMemory::alignment + HugePageMemory::hugePageSize - 1)
+								/ HugePageMemory::hugePageSize) * HugePageMemory::hugePageSize;
+	void * memory = NULL;
+	HugePageBlockType type = BLOCK_TRANSPARENT;
+#ifdef MAP_HUGETLB
+	// explicit huge pages if reserved by the system
+	if (explicitHugePagesAvailable) {
+		memory = mmap( NULL, memorySize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0 );
+		if (memory == MAP_FAILED) {
+			// avoid further attempts
+			explicitHugePagesAvailable = false;
+			memory = NULL;
+		} else {
+			type = BLOCK_EXPLICIT;
+		}
+	}
+#endif
+	// transparent huge pages otherwise
+	if (memory == NULL) {
+		if (posix_memalign( &memory, HugePageMemory::hugePageSize, memorySize ) != 0) {
+			return NULL;
+		}
+#ifdef MADV_HUGEPAGE
+		madvise( memory, memorySize, MADV_HUGEPAGE );
+#endif
+	}
+	HugePageBlock * header = static_cast<HugePageBlock*>( memory );
+	header->memory = memory;
+	header->memorySize = memorySize;
+	header->capacity = memorySize - HugePageMemory::alignment;
+	header->type = type;
+	return header;
+#else
+	return NULL;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void *
+HugePageMemory::
+allocate( const size_t bytes )
+{
+	HugePageBlock * header = NULL;
+
+	if (bytes >= hugePageSize && !hugePageCacheDestroyed) {
+		// reuse the smallest cached block that is not much larger
+		HugePageCache & cache = hugePageCache;
+		auto best = cache.blocks.end();
+		for (auto b = cache.blocks.begin(); b != cache.blocks.end(); b++) {
+			if ((*b)->capacity >= bytes && (*b)->capacity/2 <= bytes
+				&& (best == cache.blocks.end() || (*b)->capacity < (*best)->capacity))
+			{
+				best = b;
+			}
+		}
+		if (best != cache.blocks.end()) {
+			header = *best;
+			cache.size -= header->capacity;
+			cache.blocks.erase( best );
+		} else {
+			header = allocateHugePageBlock( bytes );
+		}
+	}
+
+	// cache-line aligned block otherwise
+	if (header == NULL) {
+		if (bytes > std::numeric_limits<size_t>::max() - 2*alignment) {
+			throw std::bad_alloc();
+		}
+		void * memory = malloc( bytes + 2*alignment );
+		if (memory == NULL) {
+			throw std::bad_alloc();
+		}
+		// header within the cache line preceding the aligned storage
+		char * block = static_cast<char*>(memory) + alignment;
+		block += (alignment - (reinterpret_cast<uintptr_t>(block) % alignment)) % alignment;
+		header = reinterpret_cast<HugePageBlock*>( block - alignment );
+		header->memory = memory;
+		header->memorySize = bytes + 2*alignment;
+		header->capacity = bytes;
+		header->type = BLOCK_MALLOC;
+	}
+
+	return reinterpret_cast<char*>(header) + alignment;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+HugePageMemory::
+deallocate( void * block, const size_t bytes )
+{
+	if (block == NULL) {
+		return;
+	}
+	HugePageBlock * header = getHugePageBlock( block );
+
+	// cache huge page blocks for reuse
+	const size_t limit = hugePageCacheLimit;
+	if (header->type != BLOCK_MALLOC && header->capacity <= limit && !hugePageCacheDestroyed) {
+		HugePageCache & cache = hugePageCache;
+		// release the oldest blocks if needed
+		size_t released = 0;
+		while (cache.size + header->capacity > limit) {
+			cache.size -= cache.blocks.at(released)->capacity;
+			releaseHugePageBlock( cache.blocks.at(released) );
+			released++;
+		}
+		cache.blocks.erase( cache.blocks.begin(), cache.blocks.begin()+released );
+		cache.blocks.push_back( header );
+		cache.size += header->capacity;
+		return;
+	}
+
+	releaseHugePageBlock( header );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+HugePageMemory::
+setCacheLimit( const size_t bytes )
+{
+	hugePageCacheLimit = bytes;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+size_t
+HugePageMemory::
+getCacheLimit()
+{
+	return hugePageCacheLimit;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+size_t
+HugePageMemory::
+getCacheSize()
+{
+	return hugePageCacheDestroyed ? 0 : hugePageCache.size;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+HugePageMemory::
+clearCache()
+{
+	if (hugePageCacheDestroyed) {
+		return;
+	}
+	HugePageCache & cache = hugePageCache;
+	for (auto b = cache.blocks.begin(); b != cache.blocks.end(); b++) {
+		releaseHugePageBlock( *b );
+	}
+	cache.blocks.clear();
+	cache.size = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
@@ -0,0 +1,192 @@
+
+#ifndef INTARNA_HUGEPAGEALLOCATOR_H_
+#define INTARNA_HUGEPAGEALLOCATOR_H_
+
+#include "IntaRNA/general.h"
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <vector>
+
+namespace IntaRNA {
+
+/**
+ * Memory management for large buffers, e.g. DP matrices and accessibility
+ * bands, that are frequently accessed in random order.
+ *
+ * All blocks are aligned to cache lines (see alignment). Blocks of at least
+ * hugePageSize bytes are backed by huge pages to reduce TLB misses, i.e.
+ * explicit huge pages (if reserved by the system) or transparent huge pages
+ * otherwise (via madvise). Freed large blocks are kept in a cache of the
+ * releasing thread and reused by its subsequent allocations of similar size,
+ * such that DP matrices of successive predictions do not repeatedly map and
+ * fault in fresh memory.
+ *
+ * Huge page support is only available if memory mapping is supported
+ * (INTARNA_HAVE_MMAP); otherwise, blocks are only cache-line aligned.
+ *
+ * All static member functions are thread-safe.
+ *
+ */
+class HugePageMemory {
+
+public:
+
+	//! alignment of all blocks in bytes (cache line size)
+	static const size_t alignment;
+
+	//! the size of a huge page in bytes, i.e. the minimal size of blocks
+	//! that are backed by huge pages
+	static const size_t hugePageSize;
+
+	/**
+	 * Allocates a block of memory aligned to cache lines.
+	 *
+	 * @param bytes the number of bytes needed
+	 * @return the allocated block
+	 * @throws std::bad_alloc if no memory is available
+	 */
+	static
+	void *
+	allocate( const size_t bytes );
+
+	/**
+	 * Releases a block allocated via allocate(). Large blocks are cached
+	 * for reuse by the calling thread (see setCacheLimit()).
+	 *
+	 * @param block the block to release (NULL is ignored)
+	 * @param bytes the number of bytes requested on allocation
+	 */
+	static
+	void
+	deallocate( void * block, const size_t bytes );
+
+	/**
+	 * Sets the maximal number of bytes of freed large blocks that are cached
+	 * per thread for reuse. Blocks exceeding the limit are released.
+	 *
+	 * @param bytes the maximal cache size per thread (0 disables the reuse)
+	 */
+	static
+	void
+	setCacheLimit( const size_t bytes );
+
+	/**
+	 * Access to the maximal number of bytes cached per thread.
+	 * @return the maximal cache size per thread
+	 */
+	static
+	size_t
+	getCacheLimit();
+
+	/**
+	 * Provides the number of bytes currently cached by the calling thread.
+	 * @return the cache size of the calling thread
+	 */
+	static
+	size_t
+	getCacheSize();
+
+	/**
+	 * Releases all blocks cached by the calling thread.
+	 */
+	static
+	void
+	clearCache();
+
+};
+
+////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Allocator for standard containers that uses HugePageMemory, i.e. provides
+ * cache-line aligned storage that is backed by huge pages and reused among
+ * successive allocations of a thread if large.
+ *
+ * Use HugePageAllocator<T>::vector as a replacement for std::vector<T>.
+ *
+ */
+template < typename T >
+class HugePageAllocator {
+
+public:
+
+	//! the type of the allocated values
+	typedef T value_type;
+	typedef T * pointer;
+	typedef const T * const_pointer;
+	typedef T & reference;
+	typedef const T & const_reference;
+	typedef size_t size_type;
+	typedef std::ptrdiff_t difference_type;
+
+	//! vector type using this allocator
+	typedef std::vector< T, HugePageAllocator<T> > vector;
+
+	//! allocator for a different value type
+	template < typename U >
+	struct rebind {
+		typedef HugePageAllocator<U> other;
+	};
+
+	/**
+	 * construction
+	 */
+	HugePageAllocator() {}
+
+	/**
+	 * construction from an allocator of a different value type
+	 */
+	template < typename U >
+	HugePageAllocator( const HugePageAllocator<U> & ) {}
+
+	/**
+	 * Allocates storage for n values (uninitialized)
+	 * @param n the number of values
+	 * @return the allocated storage
+	 */
+	T *
+	allocate( const size_t n ) {
+		if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+			throw std::bad_alloc();
+		}
+		return static_cast<T*>( HugePageMemory::allocate( n * sizeof(T) ) );
+	}
+
+	/**
+	 * Releases storage allocated via allocate()
+	 * @param p the storage to release
+	 * @param n the number of values requested on allocation
+	 */
+	void
+	deallocate( T * p, const size_t n ) {
+		HugePageMemory::deallocate( p, n * sizeof(T) );
+	}
+
+	/**
+	 * Maximal number of values that can be allocated
+	 * @return the maximal number of values
+	 */
+	size_t
+	max_size() const {
+		return std::numeric_limits<size_t>::max() / sizeof(T);
+	}
+
+};
+
+//! all HugePageAllocator instances are interchangeable
+template < typename T, typename U >
+inline
+bool operator == ( const HugePageAllocator<T> &, const HugePageAllocator<U> & ) { return true; }
+
+//! all HugePageAllocator instances are interchangeable
+template < typename T, typename U >
+inline
+bool operator != ( const HugePageAllocator<T> &, const HugePageAllocator<U> & ) { return false; }
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_HUGEPAGEALLOCATOR_H_ */
@@ -172,10 +172,7 @@ get( const size_t idx )
 	if (idx >= size()) {
 		throw std::runtime_error("IndexRangeList::get() : index "+toString(idx)+" out of range (>= "+toString(size())+")");
 	}
-	// access according element via iterator and return
-	iterator idxIter = list.begin();
-	std::advance( idxIter, idx );
-	return *(idxIter);
+	return list[idx];
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -187,10 +184,7 @@ get( const size_t idx ) const
 	if (idx >= size()) {
 		throw std::runtime_error("IndexRangeList::get() : index "+toString(idx)+" out of range (>= "+toString(size())+")");
 	}
-	// access according element via iterator and return
-	const_iterator idxIter = list.begin();
-	std::advance( idxIter, idx );
-	return *(idxIter);
+	return list[idx];
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -219,6 +213,30 @@ shift( const int indexShift, const size_t indexMax ) const
 
 //////////////////////////////////////////////////////////////////////
 
+IndexRangeList
+IndexRangeList::
+intersect( const IndexRangeList & other ) const
+{
+	IndexRangeList l;
+	// both lists are sorted and non-overlapping
+	IndexRangeList::const_iterator r1 = begin(), r2 = other.begin();
+	while (r1 != end() && r2 != other.end()) {
+		// store overlap if any
+		if (r1->from <= r2->to && r2->from <= r1->to) {
+			l.push_back( IndexRange( std::max(r1->from,r2->from), std::min(r1->to,r2->to) ) );
+		}
+		// proceed with the range ending first
+		if (r1->to < r2->to) {
+			r1++;
+		} else {
+			r2++;
+		}
+	}
+	return l;
+}
+
+//////////////////////////////////////////////////////////////////////
+
 IndexRangeList &
 IndexRangeList::
 reverse( const size_t seqLength )
@@ -234,7 +252,7 @@ reverse( const size_t seqLength )
 		r->to = seqLength -1 - tmpFrom;
 	}
 	// reverse order of list entries
-	list.reverse();
+	std::reverse( list.begin(), list.end() );
 	// return access to altered element
 	return *this;
 }
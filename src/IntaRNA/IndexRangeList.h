@@ -4,7 +4,7 @@
 
 #include "IntaRNA/IndexRange.h"
 
-#include <list>
+#include <vector>
 
 #include <boost/regex.hpp>
 
@@ -13,6 +13,9 @@ namespace IntaRNA {
 /**
  * Sorted list of non-overlapping ascending ranges.
  *
+ * The ranges are stored in a contiguous sorted vector, such that coverage
+ * and overlap checks are binary searches and indexed access is constant time.
+ *
  * TODO add support for overlapping ranges
  *
  * @author Martin Mann
@@ -23,7 +26,7 @@ class IndexRangeList
 protected:
 
 	//! List of ranges
-	typedef std::list< IndexRange > List;
+	typedef std::vector< IndexRange > List;
 
 public:
 
@@ -229,6 +232,14 @@ public:
 	IndexRangeList
 	shift( const int indexShift, const size_t indexMax ) const;
 
+	/**
+	 * Computes the intersection with another range list.
+	 * @param other the range list to intersect with
+	 * @return a new range list covering all indices covered by both lists
+	 */
+	IndexRangeList
+	intersect( const IndexRangeList & other ) const;
+
 	/**
 	 * Reverses all indices for the given sequence length, i.e.
 	 * (newIdx = seqLength-1-oldIdx)
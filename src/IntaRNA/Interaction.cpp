@@ -96,6 +96,37 @@ operator= ( const Interaction & toCopy )
 
 ////////////////////////////////////////////////////////////////////////////
 
+Interaction &
+Interaction::
+operator= ( Interaction && toMove )
+{
+	if (this == &toMove) {
+		return *this;
+	}
+#if INTARNA_IN_DEBUG_MODE
+	if (!toMove.isValid())
+		throw std::runtime_error("Interaction::=("+toString(toMove)+") not valid!");
+#endif
+	// copy sequence handles
+	s1 = toMove.s1;
+	s2 = toMove.s2;
+
+	// take over base pairs
+	basePairs.swap( toMove.basePairs );
+	toMove.basePairs.clear();
+
+	// copy energy value
+	energy = toMove.energy;
+
+	// take over seed data
+	std::swap( seed, toMove.seed );
+	 INTARNA_CLEANUP(toMove.seed);
+
+	return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 Interaction &
 Interaction::
 operator= ( const InteractionRange & range )
@@ -72,6 +72,14 @@ public:
 	 */
 	Interaction( const Interaction & toCopy );
 
+	/**
+	 * move construction from interaction, i.e. base pair and seed storage
+	 * are taken over without copying.
+	 *
+	 * @param toMove the interaction to move (left empty)
+	 */
+	Interaction( Interaction && toMove );
+
 	/**
 	 * construction from interaction range, ie. forming base pairs at the
 	 * beginning and end of the interaction range.
@@ -139,6 +147,16 @@ public:
 	Interaction &
 	operator= ( const Interaction & toCopy );
 
+	/**
+	 * Takes over the base pair and seed storage of the given interaction
+	 * without copying.
+	 *
+	 * @param toMove the interaction to move (left empty)
+	 * @return the altered object (*this)
+	 */
+	Interaction &
+	operator= ( Interaction && toMove );
+
 	/**
 	 * Creates an interaction with one base pair for each interaction range
 	 * boundary.
@@ -286,6 +304,22 @@ Interaction::Interaction( const Interaction & toCopy )
 
 ////////////////////////////////////////////////////////////////////////////
 
+inline
+Interaction::Interaction( Interaction && toMove )
+:
+	s1(toMove.s1)
+	, s2(toMove.s2)
+	, basePairs( std::move(toMove.basePairs) )
+	, energy( toMove.energy )
+	, seed( toMove.seed )
+{
+	// seed is owned by this object now
+	toMove.seed = NULL;
+	toMove.basePairs.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 inline
 Interaction::Interaction( const InteractionRange & range )
 :
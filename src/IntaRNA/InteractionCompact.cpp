@@ -0,0 +1,288 @@
+
+#include "IntaRNA/InteractionCompact.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace IntaRNA {
+
+////////////////////////////////////////////////////////////////////////////
+
+const size_t InteractionCompact::maxRunUnpaired = std::numeric_limits<boost::uint8_t>::max();
+
+const size_t InteractionCompact::maxRunStack = std::numeric_limits<boost::uint16_t>::max();
+
+////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Ordering of interactions as done by Interaction::operator<(), i.e. by
+ * energy, boundaries, number of base pairs and seed energy.
+ *
+ * @return true if interaction a is to be reported before interaction b
+ */
+static
+bool
+isLessInteraction( const E_type energyA
+				, const Interaction::BasePair & firstA
+				, const Interaction::BasePair & lastA
+				, const size_t sizeA
+				, const bool hasSeedA
+				, const E_type seedEA
+				, const E_type energyB
+				, const Interaction::BasePair & firstB
+				, const Interaction::BasePair & lastB
+				, const size_t sizeB
+				, const bool hasSeedB
+				, const E_type seedEB )
+{
+	if (!E_equal(energyA, energyB)) {
+		return energyA < energyB;
+	}
+	if (firstA.first != firstB.first) {
+		return firstA.first < firstB.first;
+	}
+	if (firstA.second != firstB.second) {
+		return firstA.second < firstB.second;
+	}
+	if (lastA.first != lastB.first) {
+		return lastA.first < lastB.first;
+	}
+	if (lastA.second != lastB.second) {
+		return lastA.second < lastB.second;
+	}
+	if (sizeA != sizeB) {
+		return sizeA > sizeB;
+	}
+	return hasSeedA && hasSeedB && seedEA < seedEB;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+InteractionCompact::
+InteractionCompact()
+ :
+	s1(NULL)
+	, s2(NULL)
+	, energy( std::numeric_limits<E_type>::signaling_NaN() )
+	, bpCount(0)
+	, first1(0), first2(0)
+	, last1(0), last2(0)
+	, runs()
+	, explicitPairs()
+	, hasSeed(false)
+	, seedI1(0), seedI2(0)
+	, seedJ1(0), seedJ2(0)
+	, seedE(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+InteractionCompact::
+InteractionCompact( const Interaction & interaction )
+ :
+	s1(NULL)
+	, s2(NULL)
+	, energy( std::numeric_limits<E_type>::signaling_NaN() )
+	, bpCount(0)
+	, first1(0), first2(0)
+	, last1(0), last2(0)
+	, runs()
+	, explicitPairs()
+	, hasSeed(false)
+	, seedI1(0), seedI2(0)
+	, seedJ1(0), seedJ2(0)
+	, seedE(0)
+{
+	assign( interaction );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+InteractionCompact::
+assign( const Interaction & interaction )
+{
+	s1 = interaction.s1;
+	s2 = interaction.s2;
+	energy = interaction.energy;
+	bpCount = interaction.basePairs.size();
+	runs.clear();
+	explicitPairs.clear();
+
+	if (bpCount > 0) {
+		first1 = interaction.basePairs.begin()->first;
+		first2 = interaction.basePairs.begin()->second;
+		last1 = interaction.basePairs.rbegin()->first;
+		last2 = interaction.basePairs.rbegin()->second;
+		// store explicitly if not encodable
+		if ( !encodeRuns( interaction.basePairs ) ) {
+			runs.clear();
+			explicitPairs = interaction.basePairs;
+		}
+	} else {
+		first1 = first2 = last1 = last2 = 0;
+	}
+
+	hasSeed = interaction.seed != NULL;
+	if (hasSeed) {
+		seedI1 = interaction.seed->bp_i.first;
+		seedI2 = interaction.seed->bp_i.second;
+		seedJ1 = interaction.seed->bp_j.first;
+		seedJ2 = interaction.seed->bp_j.second;
+		seedE = interaction.seed->energy;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+InteractionCompact::
+encodeRuns( const Interaction::PairingVec & basePairs )
+{
+	const size_t maxIndex = std::numeric_limits<boost::uint32_t>::max();
+	if (basePairs.begin()->first > maxIndex || basePairs.begin()->second > maxIndex) {
+		return false;
+	}
+	for (auto prev = basePairs.begin(), bp = prev+1; bp != basePairs.end(); prev++, bp++) {
+		// ensure sorted and nested base pairs
+		if (bp->first <= prev->first || bp->second >= prev->second || bp->first > maxIndex) {
+			return false;
+		}
+		const size_t u1 = bp->first - prev->first - 1;
+		const size_t u2 = prev->second - bp->second - 1;
+		// extend current run if stacked
+		if (u1 == 0 && u2 == 0 && !runs.empty() && runs.rbegin()->stack < maxRunStack) {
+			runs.rbegin()->stack++;
+			continue;
+		}
+		if (u1 > maxRunUnpaired || u2 > maxRunUnpaired) {
+			return false;
+		}
+		// start new run
+		Run run;
+		run.u1 = (boost::uint8_t)u1;
+		run.u2 = (boost::uint8_t)u2;
+		run.stack = 1;
+		runs.push_back( run );
+	}
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+InteractionCompact::
+expand( Interaction & interaction ) const
+{
+	interaction.s1 = s1;
+	interaction.s2 = s2;
+	interaction.energy = energy;
+	interaction.basePairs.resize( bpCount );
+	size_t i = 0;
+	for (const_iterator bp = begin(); bp != end(); bp++, i++) {
+		interaction.basePairs[i] = *bp;
+	}
+	if (hasSeed) {
+		interaction.setSeedRange( BasePair(seedI1,seedI2), BasePair(seedJ1,seedJ2), seedE );
+	} else {
+		INTARNA_CLEANUP( interaction.seed );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+InteractionCompact::
+hasSameBasePairs( const InteractionCompact & i ) const
+{
+	if (bpCount != i.bpCount
+		|| getFirstBasePair() != i.getFirstBasePair()
+		|| getLastBasePair() != i.getLastBasePair())
+	{
+		return false;
+	}
+	// compare encodings directly if possible
+	if (!isExplicit() && !i.isExplicit()) {
+		if (runs.size() != i.runs.size()) {
+			return false;
+		}
+		for (size_t r = 0; r < runs.size(); r++) {
+			if (runs[r].u1 != i.runs[r].u1 || runs[r].u2 != i.runs[r].u2 || runs[r].stack != i.runs[r].stack) {
+				return false;
+			}
+		}
+		return true;
+	}
+	return std::equal( begin(), end(), i.begin() );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+InteractionCompact::
+operator < ( const InteractionCompact & i ) const
+{
+	return isLessInteraction( energy, getFirstBasePair(), getLastBasePair(), bpCount, hasSeed, seedE
+			, i.energy, i.getFirstBasePair(), i.getLastBasePair(), i.bpCount, i.hasSeed, i.seedE );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+InteractionCompact::
+isLess( const Interaction & a, const InteractionCompact & b )
+{
+	return isLessInteraction( a.energy, *(a.basePairs.begin()), *(a.basePairs.rbegin()), a.basePairs.size()
+				, a.seed != NULL, a.seed == NULL ? 0 : a.seed->energy
+			, b.energy, b.getFirstBasePair(), b.getLastBasePair(), b.bpCount, b.hasSeed, b.seedE );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+InteractionCompact::const_iterator::
+const_iterator( const InteractionCompact & interaction, const bool atEnd )
+ :
+	interaction( &interaction )
+	, pos( atEnd ? interaction.bpCount : 0 )
+	, bp( interaction.getFirstBasePair() )
+	, nextRun(0)
+	, leftInRun(0)
+{
+	if (!atEnd && interaction.isExplicit()) {
+		bp = interaction.explicitPairs.at(0);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+InteractionCompact::const_iterator &
+InteractionCompact::const_iterator::
+operator++()
+{
+	pos++;
+	// check if end reached
+	if (pos >= interaction->bpCount) {
+		pos = interaction->bpCount;
+		return *this;
+	}
+	if (interaction->isExplicit()) {
+		bp = interaction->explicitPairs[pos];
+	} else if (leftInRun > 0) {
+		// stacked base pair
+		bp.first++;
+		bp.second--;
+		leftInRun--;
+	} else {
+		// first base pair of the next run
+		const Run & run = interaction->runs[nextRun++];
+		bp.first += run.u1 + 1;
+		bp.second -= run.u2 + 1;
+		leftInRun = run.stack - 1;
+	}
+	return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
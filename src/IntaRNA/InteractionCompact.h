@@ -0,0 +1,393 @@
+
+#ifndef INTARNA_INTERACTIONCOMPACT_H_
+#define INTARNA_INTERACTIONCOMPACT_H_
+
+#include "IntaRNA/general.h"
+#include "IntaRNA/Interaction.h"
+
+#include <iterator>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+namespace IntaRNA {
+
+/**
+ * Compact storage of an Interaction for collecting many (suboptimal)
+ * interactions.
+ *
+ * Instead of all base pairs, only the left-most base pair is stored along
+ * with a sequence of helix runs. Each run encodes an interior loop, i.e. the
+ * number of unpaired positions in both sequences preceding the next base
+ * pair, followed by the number of base pairs stacked from there on. Thus, a
+ * run takes 4 bytes, while a base pair within Interaction takes 16.
+ *
+ * The base pairs are available via const_iterator without expansion, and
+ * expand() fills an Interaction (reusing its storage) when the explicit
+ * base pairs are needed, e.g. for output.
+ *
+ * Interactions whose base pairs can not be encoded as runs (e.g. if unsorted
+ * or with interior loops exceeding 255 unpaired positions) are stored
+ * explicitly.
+ *
+ */
+class InteractionCompact {
+
+public:
+
+	//! type of a base pair index encoding
+	typedef Interaction::BasePair BasePair;
+
+	/**
+	 * A stretch of stacked base pairs preceded by an interior loop
+	 */
+	class Run {
+	public:
+		//! number of unpaired positions in seq1 preceding the run
+		boost::uint8_t u1;
+		//! number of unpaired positions in seq2 preceding the run
+		boost::uint8_t u2;
+		//! number of stacked base pairs of the run
+		boost::uint16_t stack;
+	};
+
+	/**
+	 * Constant forward iterator over the base pairs of an InteractionCompact
+	 * that decodes the runs on the fly.
+	 */
+	class const_iterator : public std::iterator< std::forward_iterator_tag, const BasePair > {
+	public:
+		/**
+		 * construction
+		 * @param interaction the interaction to iterate
+		 * @param atEnd whether or not to point after the last base pair
+		 */
+		const_iterator( const InteractionCompact & interaction, const bool atEnd );
+		//! access to the current base pair
+		const BasePair & operator*() const { return bp; }
+		//! access to the current base pair
+		const BasePair * operator->() const { return &bp; }
+		//! move to the next base pair
+		const_iterator & operator++();
+		//! move to the next base pair
+		const_iterator operator++(int) { const_iterator tmp(*this); ++(*this); return tmp; }
+		//! equality check
+		bool operator==( const const_iterator & i ) const { return pos == i.pos && interaction == i.interaction; }
+		//! inequality check
+		bool operator!=( const const_iterator & i ) const { return !(*this == i); }
+	protected:
+		//! the interaction iterated
+		const InteractionCompact * interaction;
+		//! index of the current base pair
+		size_t pos;
+		//! the current base pair
+		BasePair bp;
+		//! index of the next run to decode
+		size_t nextRun;
+		//! number of stacked base pairs left in the current run
+		size_t leftInRun;
+	};
+
+public:
+
+	/**
+	 * Construction of an empty interaction
+	 */
+	InteractionCompact();
+
+	/**
+	 * Construction from an interaction
+	 * @param interaction the interaction to encode
+	 */
+	explicit
+	InteractionCompact( const Interaction & interaction );
+
+	/**
+	 * Encodes the given interaction, reusing the available storage.
+	 * @param interaction the interaction to encode
+	 */
+	void
+	assign( const Interaction & interaction );
+
+	/**
+	 * Decodes all base pairs and the seed information into the given
+	 * interaction, reusing its storage.
+	 * @param interaction the interaction to overwrite
+	 */
+	void
+	expand( Interaction & interaction ) const;
+
+	/**
+	 * Access to the first interaction partner
+	 * @return the first sequence
+	 */
+	const RnaSequence *
+	getS1() const;
+
+	/**
+	 * Access to the second interaction partner
+	 * @return the second sequence
+	 */
+	const RnaSequence *
+	getS2() const;
+
+	/**
+	 * Access to the energy of the interaction
+	 * @return the energy
+	 */
+	E_type
+	getEnergy() const;
+
+	/**
+	 * Number of base pairs of the interaction
+	 * @return the number of base pairs
+	 */
+	size_t
+	size() const;
+
+	/**
+	 * Checks whether or not the interaction contains no base pairs.
+	 * @return true if no base pair is encoded; false otherwise
+	 */
+	bool
+	isEmpty() const;
+
+	/**
+	 * Access to the left-most base pair (not for empty interactions)
+	 * @return the first base pair
+	 */
+	BasePair
+	getFirstBasePair() const;
+
+	/**
+	 * Access to the right-most base pair (not for empty interactions)
+	 * @return the last base pair
+	 */
+	BasePair
+	getLastBasePair() const;
+
+	/**
+	 * Whether or not the base pairs are stored explicitly rather than as runs
+	 * @return true if stored explicitly; false otherwise
+	 */
+	bool
+	isExplicit() const;
+
+	/**
+	 * Access to the helix runs (empty for explicitly stored interactions)
+	 * @return the runs following the first base pair
+	 */
+	const std::vector< Run > &
+	getRuns() const;
+
+	/**
+	 * Iterator to the first base pair
+	 * @return begin of the base pairs
+	 */
+	const_iterator
+	begin() const;
+
+	/**
+	 * Iterator after the last base pair
+	 * @return end of the base pairs
+	 */
+	const_iterator
+	end() const;
+
+	/**
+	 * Checks whether or not both interactions encode the same base pairs
+	 * @param i the interaction to compare to
+	 * @return true if all base pairs are equal; false otherwise
+	 */
+	bool
+	hasSameBasePairs( const InteractionCompact & i ) const;
+
+	/**
+	 * Ordering of interactions (see Interaction::operator<())
+	 * @param i the interaction to compare to
+	 * @return true if this interaction is to be reported before i
+	 */
+	bool
+	operator < ( const InteractionCompact & i ) const;
+
+	/**
+	 * Ordering of interactions (see Interaction::operator<())
+	 * @param a the interaction to compare
+	 * @param b the encoded interaction to compare to
+	 * @return true if a is to be reported before b
+	 */
+	static
+	bool
+	isLess( const Interaction & a, const InteractionCompact & b );
+
+protected:
+
+	//! maximal number of unpaired positions of a run
+	static const size_t maxRunUnpaired;
+
+	//! maximal number of stacked base pairs of a run
+	static const size_t maxRunStack;
+
+	//! the first interaction partner
+	const RnaSequence * s1;
+
+	//! the second interaction partner
+	const RnaSequence * s2;
+
+	//! energy of the interaction (can be NaN)
+	E_type energy;
+
+	//! number of base pairs
+	boost::uint32_t bpCount;
+
+	//! left-most base pair
+	boost::uint32_t first1, first2;
+
+	//! right-most base pair
+	boost::uint32_t last1, last2;
+
+	//! the runs following the first base pair
+	std::vector< Run > runs;
+
+	//! the base pairs if they can not be encoded via runs
+	Interaction::PairingVec explicitPairs;
+
+	//! whether or not seed information is present
+	bool hasSeed;
+
+	//! left-most seed base pair
+	boost::uint32_t seedI1, seedI2;
+
+	//! right-most seed base pair
+	boost::uint32_t seedJ1, seedJ2;
+
+	//! overall energy of the seed
+	E_type seedE;
+
+	/**
+	 * Tries to encode the base pairs of the given interaction as runs.
+	 * @param basePairs the base pairs to encode
+	 * @return true if all base pairs could be encoded; false otherwise
+	 */
+	bool
+	encodeRuns( const Interaction::PairingVec & basePairs );
+
+};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+inline
+const RnaSequence *
+InteractionCompact::
+getS1() const
+{
+	return s1;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+const RnaSequence *
+InteractionCompact::
+getS2() const
+{
+	return s2;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+E_type
+InteractionCompact::
+getEnergy() const
+{
+	return energy;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+InteractionCompact::
+size() const
+{
+	return bpCount;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+InteractionCompact::
+isEmpty() const
+{
+	return bpCount == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+InteractionCompact::BasePair
+InteractionCompact::
+getFirstBasePair() const
+{
+	return isExplicit() ? *(explicitPairs.begin()) : BasePair( first1, first2 );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+InteractionCompact::BasePair
+InteractionCompact::
+getLastBasePair() const
+{
+	return isExplicit() ? *(explicitPairs.rbegin()) : BasePair( last1, last2 );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+InteractionCompact::
+isExplicit() const
+{
+	return !explicitPairs.empty();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+const std::vector< InteractionCompact::Run > &
+InteractionCompact::
+getRuns() const
+{
+	return runs;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+InteractionCompact::const_iterator
+InteractionCompact::
+begin() const
+{
+	return const_iterator( *this, false );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+InteractionCompact::const_iterator
+InteractionCompact::
+end() const
+{
+	return const_iterator( *this, true );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_INTERACTIONCOMPACT_H_ */
@@ -2,6 +2,8 @@
 #include "IntaRNA/InteractionEnergy.h"
 
 #include <cmath>
+#include <vector>
+#include <algorithm>
 
 #include <iostream>
 
@@ -9,6 +11,14 @@ namespace IntaRNA {
 
 ////////////////////////////////////////////////////////////////////////////
 
+const int InteractionEnergy::boltzmannWeightsMaxE;
+
+std::shared_ptr< const std::vector<E_type> > InteractionEnergy::lastBoltzmannWeights;
+
+E_type InteractionEnergy::lastBoltzmannWeightsRT = 0;
+
+////////////////////////////////////////////////////////////////////////////
+
 InteractionEnergy::
 EnergyContributions
 InteractionEnergy::
@@ -47,5 +57,103 @@ getE_contributions( const Interaction & interaction ) const
 
 ////////////////////////////////////////////////////////////////////////////
 
+InteractionEnergy::
+EnergyContributions
+InteractionEnergy::
+getED_contributions( const Interaction & interaction ) const
+{
+	EnergyContributions contr;
+	contr.loops = 0;
+	contr.init = 0;
+	contr.ED1 = getED1( interaction.basePairs.begin()->first, interaction.basePairs.rbegin()->first );
+	contr.ED2 = getED2( getAccessibility2().getReversedIndex(interaction.basePairs.begin()->second)
+						, getAccessibility2().getReversedIndex(interaction.basePairs.rbegin()->second) );
+	contr.dangleLeft = 0;
+	contr.dangleRight = 0;
+	contr.endLeft = 0;
+	contr.endRight = 0;
+	return contr;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+E_type
+InteractionEnergy::
+getBestE( const IndexRange & r1, const IndexRange & r2 ) const
+{
+	// check if ranges are within the sequences
+	if (r1.from > r1.to || r2.from > r2.to || r1.from >= size1() || r2.from >= size2()) {
+		return E_INF;
+	}
+	const size_t to1 = std::min( r1.to, size1()-1 );
+	const size_t to2 = std::min( r2.to, size2()-1 );
+
+	// maximal interaction widths within the ranges
+	const size_t maxW1 = std::min( to1-r1.from+1, getAccessibility1().getMaxLength() );
+	const size_t maxW2 = std::min( to2-r2.from+1, getAccessibility2().getMaxLength() );
+
+	// minimal ED value for each interaction width (index = width-1)
+	std::vector<E_type> minED1( maxW1, E_INF );
+	for (size_t i=r1.from; i<=to1; i++) {
+		for (size_t w=1; w<=maxW1 && i+w-1<=to1; w++) {
+			minED1[w-1] = std::min( minED1[w-1], getED1( i, i+w-1 ) );
+		}
+	}
+	std::vector<E_type> minED2( maxW2, E_INF );
+	for (size_t i=r2.from; i<=to2; i++) {
+		for (size_t w=1; w<=maxW2 && i+w-1<=to2; w++) {
+			minED2[w-1] = std::min( minED2[w-1], getED2( i, i+w-1 ) );
+		}
+	}
+
+	// best energy gain of a single intermolecular loop
+	const E_type bestLoopE = std::min( (E_type)0, getBestE_interLoop() );
+
+	// minimize over all interaction width combinations, where the number of
+	// intermolecular loops is bounded by the smaller width
+	E_type bestE = E_INF;
+	for (size_t w1=1; w1<=maxW1; w1++) {
+		if (E_isINF(minED1[w1-1])) { continue; }
+		for (size_t w2=1; w2<=maxW2; w2++) {
+			if (E_isINF(minED2[w2-1])) { continue; }
+			bestE = std::min( bestE, minED1[w1-1] + minED2[w2-1] + ((E_type)(std::min(w1,w2)-1))*bestLoopE );
+		}
+	}
+
+	// check if any interaction possible
+	if (E_isINF(bestE)) {
+		return E_INF;
+	}
+
+	// add initiation, dangling end and interaction end contributions
+	return bestE + getE_init() + 2.0*std::min( (E_type)0, getBestE_dangling() ) + 2.0*std::min( (E_type)0, getBestE_end() );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+InteractionEnergy::
+initBoltzmannWeights()
+{
+	const E_type RT = getRT();
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_boltzmannWeights)
+#endif
+	{
+		// check if the last table can be reused
+		if (!lastBoltzmannWeights || lastBoltzmannWeightsRT != RT) {
+			std::vector<E_type> * weights = new std::vector<E_type>( 2*boltzmannWeightsMaxE+1 );
+			for (int k=-boltzmannWeightsMaxE; k<=boltzmannWeightsMaxE; k++) {
+				(*weights)[k+boltzmannWeightsMaxE] = std::exp( - ((E_type)k/(E_type)100) / RT );
+			}
+			lastBoltzmannWeights.reset( weights );
+			lastBoltzmannWeightsRT = RT;
+		}
+		boltzmannWeights = lastBoltzmannWeights;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 
 } // namespace
@@ -5,9 +5,14 @@
 
 #include "IntaRNA/general.h"
 #include "IntaRNA/Interaction.h"
+#include "IntaRNA/IndexRange.h"
 #include "IntaRNA/Accessibility.h"
+#include "IntaRNA/AccessibilityDisabled.h"
 #include "IntaRNA/ReverseAccessibility.h"
 
+#include <memory>
+#include <vector>
+
 namespace IntaRNA {
 
 /**
@@ -109,6 +114,35 @@ public:
 			, const size_t i2, const size_t j2
 			, const E_type hybridE ) const;
 
+	/**
+	 * Provides the overall energy for an interaction (see getE()) computed
+	 * by the given energy handler. If EnergyType is a final energy class, all
+	 * calls are bound at compile time and can be inlined, e.g. within the
+	 * recursions of energy-model-specific predictor kernels.
+	 *
+	 * @param energy the energy handler to use
+	 * @param i1 the index of the first sequence interacting with i2
+	 * @param j1 the index of the first sequence interacting with j2 with i1<=j1
+	 * @param i2 the index of the second sequence interacting with i1
+	 * @param j2 the index of the second sequence interacting with j1 with i2<=j2
+	 * @param hybridE the hybridization energy for the interaction
+	 *
+	 * @return the overall energy as provided by energy.getE()
+	 *
+	 * @tparam AccDisabled whether or not the accessibility terms are to be
+	 *        taken from getED1_disabled() and getED2_disabled(), i.e. without
+	 *        virtual ED lookups and Boltzmann weights of ED differences; only
+	 *        valid if energy.isAccessibilityDisabled() and if EnergyType
+	 *        does not shift indices (as InteractionEnergyIdxOffset does)
+	 */
+	template < class EnergyType, bool AccDisabled = false >
+	static
+	E_type
+	getE( const EnergyType & energy
+			, const size_t i1, const size_t j1
+			, const size_t i2, const size_t j2
+			, const E_type hybridE );
+
 	/**
 	 * Provides the ensemble energy for a given partition function Z.
 	 *
@@ -131,6 +165,19 @@ public:
 	EnergyContributions
 	getE_contributions( const Interaction & interaction ) const;
 
+	/**
+	 * Provides the accessibility penalties (ED1, ED2) for the given
+	 * interaction only, which is cheaper than getE_contributions() if no
+	 * other contribution is needed.
+	 *
+	 * @param interaction the interaction of interest
+	 *
+	 * @return the energy contributions with ED1 and ED2 set and all other
+	 *         contributions set to 0
+	 */
+	EnergyContributions
+	getED_contributions( const Interaction & interaction ) const;
+
 	/**
 	 * Checks whether or not two positions can form a base pair
 	 * @param i1 index in first sequence
@@ -180,6 +227,40 @@ public:
 	E_type
 	getED2( const size_t i2, const size_t j2 ) const;
 
+	/**
+	 * Whether or not both accessibilities are of type AccessibilityDisabled,
+	 * i.e. all ED values are either 0 or ED_UPPER_BOUND (for blocked end
+	 * positions or regions exceeding the maximal length).
+	 *
+	 * @return true if the accessibility of both sequences is disabled
+	 */
+	bool
+	isAccessibilityDisabled() const;
+
+	/**
+	 * Provides the ED penalty for making a region with sequence 1 accessible
+	 * (see getED1()) without virtual calls. Only to be called if
+	 * isAccessibilityDisabled() holds.
+	 *
+	 * @param i1 the start of the accessible region
+	 * @param j1 the end of the accessible region
+	 * @return the ED value for [i1,j1], i.e. either 0 or ED_UPPER_BOUND
+	 */
+	E_type
+	getED1_disabled( const size_t i1, const size_t j1 ) const;
+
+	/**
+	 * Provides the ED penalty for making a region with (the reversed)
+	 * sequence 2 accessible (see getED2()) without virtual calls. Only to be
+	 * called if isAccessibilityDisabled() holds.
+	 *
+	 * @param i2 the start of the accessible region
+	 * @param j2 the end of the accessible region
+	 * @return the ED value for [i2,j2], i.e. either 0 or ED_UPPER_BOUND
+	 */
+	E_type
+	getED2_disabled( const size_t i2, const size_t j2 ) const;
+
 	/**
 	 * Whether or not position i is accessible for interaction in sequence 1
 	 * @param i the position of interest in sequence 1
@@ -486,9 +567,28 @@ public:
 	E_type
 	getBestE_end() const = 0;
 
+	/**
+	 * Provides a lower bound of the energy of any interaction within the
+	 * given index ranges, i.e. of the energy any prediction restricted to
+	 * these ranges can yield. The bound combines the minimal ED values for
+	 * each interaction width with the best stacking, dangling end,
+	 * interaction end and initiation energies.
+	 *
+	 * @param r1 the index range of the first sequence
+	 * @param r2 the index range of the second sequence (reversed indexing)
+	 * @return a lower bound of the energy of any interaction within the
+	 *         ranges or E_INF if no interaction is possible
+	 */
+	virtual
+	E_type
+	getBestE( const IndexRange & r1, const IndexRange & r2 ) const;
+
 
 	/**
 	 * Provides the Boltzmann weight for a given energy.
+	 * Energies at the 0.01 kcal/mol resolution of the energy parameters are
+	 * looked up from a precomputed table (see initBoltzmannWeights()), all
+	 * others are computed explicitly.
 	 * @param energy the energy the Boltzmann weight is to be computed for
 	 * @return the Boltzmann weight, i.e. exp( - energy / RT );
 	 */
@@ -534,6 +634,12 @@ protected:
 	//! accessibility values for sequence S2 (reversed index order)
 	const ReverseAccessibility & accS2;
 
+	//! the sequence S1 (of accS1)
+	const RnaSequence & seq1;
+
+	//! the sequence S2 (of accS2, i.e. reversed)
+	const RnaSequence & seq2;
+
 	//! maximally allowed unpaired range between two base pairs in sequence S1
 	//! forming an intermolecular internal loop
 	const size_t maxInternalLoopSize1;
@@ -542,6 +648,32 @@ protected:
 	//! forming an intermolecular internal loop
 	const size_t maxInternalLoopSize2;
 
+	//! whether or not both accessibilities are of type AccessibilityDisabled
+	const bool accessibilityDisabled;
+
+	//! table of Boltzmann weights of integer energies k (in 0.01 kcal/mol)
+	//! within [-boltzmannWeightsMaxE,+boltzmannWeightsMaxE] at index
+	//! (k+boltzmannWeightsMaxE) or NULL if not initialized
+	std::shared_ptr< const std::vector<E_type> > boltzmannWeights;
+
+	//! maximal absolute energy (in 0.01 kcal/mol) covered by boltzmannWeights
+	static const int boltzmannWeightsMaxE = 10000;
+
+	//! the Boltzmann weight table generated last (shared among all
+	//! energy handlers with the same RT)
+	static std::shared_ptr< const std::vector<E_type> > lastBoltzmannWeights;
+
+	//! the RT value of lastBoltzmannWeights
+	static E_type lastBoltzmannWeightsRT;
+
+	/**
+	 * Initializes the Boltzmann weight table used by getBoltzmannWeight().
+	 * Since getRT() is not available within the constructor of this class,
+	 * it has to be called at the end of the constructors of the subclasses.
+	 */
+	void
+	initBoltzmannWeights();
+
 	/**
 	 * Checks whether or not the given indices are valid index region within the
 	 * sequence for an intermolecular loop and do not violate the maximal
@@ -597,8 +729,13 @@ InteractionEnergy::InteractionEnergy( const Accessibility & accS1
   :
 	accS1(accS1)
 	, accS2(accS2)
+	, seq1(accS1.getSequence())
+	, seq2(accS2.getSequence())
 	, maxInternalLoopSize1(maxInternalLoopSize1)
 	, maxInternalLoopSize2(maxInternalLoopSize2)
+	, accessibilityDisabled( dynamic_cast<const AccessibilityDisabled*>(&accS1) != NULL
+			&& dynamic_cast<const AccessibilityDisabled*>(&(accS2.getAccessibilityOrigin())) != NULL )
+	, boltzmannWeights()
 
 {
 }
@@ -634,7 +771,7 @@ bool
 InteractionEnergy::
 areComplementary( const size_t i1, const size_t i2 ) const
 {
-	return RnaSequence::areComplementary( accS1.getSequence(), accS2.getSequence(), i1, i2);
+	return RnaSequence::areComplementary( seq1, seq2, i1, i2);
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -644,7 +781,7 @@ size_t
 InteractionEnergy::
 size1() const
 {
-	return getAccessibility1().getSequence().size();
+	return seq1.size();
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -654,7 +791,7 @@ size_t
 InteractionEnergy::
 size2() const
 {
-	return getAccessibility2().getSequence().size();
+	return seq2.size();
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -668,8 +805,8 @@ isValidInternalLoop( const size_t i1, const size_t j1, const size_t i2, const si
 		   (j1-i1>0 && j2-i2>0)
 		&& areComplementary( i1, i2)
 		&& areComplementary( j1, j2)
-		&& InteractionEnergy::isAllowedLoopRegion(accS1.getSequence(), i1, j1, maxInternalLoopSize1)
-		&& InteractionEnergy::isAllowedLoopRegion(accS2.getSequence(), i2, j2, maxInternalLoopSize2)
+		&& InteractionEnergy::isAllowedLoopRegion(seq1, i1, j1, maxInternalLoopSize1)
+		&& InteractionEnergy::isAllowedLoopRegion(seq2, i2, j2, maxInternalLoopSize2)
 		;
 }
 
@@ -700,7 +837,18 @@ E_type
 InteractionEnergy::
 getBoltzmannWeight( const E_type e ) const
 {
-	// TODO can be optimized when using exp-energies from VRNA
+	// check if the energy is covered by the table
+	if (boltzmannWeights) {
+		const E_type scaledE = e * (E_type)100;
+		if (scaledE > -(E_type)boltzmannWeightsMaxE && scaledE < (E_type)boltzmannWeightsMaxE) {
+			const int k = (int)std::floor( scaledE + (E_type)0.5 );
+			// check if the energy is at the resolution of the table
+			if (std::abs( scaledE - (E_type)k ) < (E_type)0.001) {
+				return (*boltzmannWeights)[ k + boltzmannWeightsMaxE ];
+			}
+		}
+	}
+	// compute weight explicitly
 	return std::exp( - e / getRT() );
 }
 
@@ -751,7 +899,41 @@ E_type
 InteractionEnergy::
 getED2( const size_t i2, const size_t j2 ) const
 {
-	return getAccessibility2().getED( i2, j2 );
+	// non-virtual call to enable inlining of materialized ED access
+	return getAccessibility2().ReverseAccessibility::getED( i2, j2 );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+InteractionEnergy::
+isAccessibilityDisabled() const
+{
+	return accessibilityDisabled;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+E_type
+InteractionEnergy::
+getED1_disabled( const size_t i1, const size_t j1 ) const
+{
+	// non-virtual call to enable inlining
+	return static_cast<const AccessibilityDisabled&>(accS1).AccessibilityDisabled::getED( i1, j1 );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+E_type
+InteractionEnergy::
+getED2_disabled( const size_t i2, const size_t j2 ) const
+{
+	// non-virtual call to enable inlining (reversed index access)
+	return static_cast<const AccessibilityDisabled&>(accS2.getAccessibilityOrigin())
+			.AccessibilityDisabled::getED( seq2.size()-j2-1, seq2.size()-i2-1 );
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -762,7 +944,7 @@ InteractionEnergy::
 isAccessible1( const size_t i ) const
 {
 	return
-			(!getAccessibility1().getSequence().isAmbiguous(i))
+			(!seq1.isAmbiguous(i))
 			&& getAccessibility1().getAccConstraint().isAccessible(i)
 			;
 }
@@ -775,7 +957,7 @@ InteractionEnergy::
 isAccessible2( const size_t i ) const
 {
 	return
-			(!getAccessibility2().getSequence().isAmbiguous(i))
+			(!seq2.isAmbiguous(i))
 			&& getAccessibility2().getAccConstraint().isAccessible(i);
 }
 
@@ -862,20 +1044,65 @@ getE( const size_t i1, const size_t j1
 		, const size_t i2, const size_t j2
 		, const E_type hybridE ) const
 {
+	// skip accessibility lookups if disabled
+	if (accessibilityDisabled) {
+		return getE< InteractionEnergy, true >( *this, i1, j1, i2, j2, hybridE );
+	}
+	return getE( *this, i1, j1, i2, j2, hybridE );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+template < class EnergyType, bool AccDisabled >
+inline
+E_type
+InteractionEnergy::
+getE( const EnergyType & energy
+		, const size_t i1, const size_t j1
+		, const size_t i2, const size_t j2
+		, const E_type hybridE )
+{
+	if (AccDisabled) {
+		if ( !E_isNotINF(hybridE) ) {
+			return E_INF;
+		}
+		// all ED values are either 0 or ED_UPPER_BOUND (infinite), such that
+		// the probability of an unpaired dangling end is either 0 or 1
+		const E_type ED1 = energy.getED1_disabled( i1, j1 );
+		const E_type ED2 = energy.getED2_disabled( i2, j2 );
+		const E_type prLeft =
+				( (i1==0 || energy.getED1_disabled( i1-1, j1 ) <= ED1)
+				&& (i2==0 || energy.getED2_disabled( i2-1, j2 ) <= ED2) )
+				? (E_type)1.0 : (E_type)0.0;
+		const E_type prRight =
+				( (j1+1>=energy.size1() || energy.getED1_disabled( i1, j1+1 ) <= ED1)
+				&& (j2+1>=energy.size2() || energy.getED2_disabled( i2, j2+1 ) <= ED2) )
+				? (E_type)1.0 : (E_type)0.0;
+		// compute overall interaction energy (same as below)
+		return hybridE
+				+ ED1
+				+ ED2
+				+ (energy.getE_danglingLeft( i1, i2 )*prLeft)
+				+ (energy.getE_danglingRight( j1, j2 )*prRight)
+				+ energy.getE_endLeft( i1, i2 )
+				+ energy.getE_endRight( j1, j2 )
+				;
+	}
+
 	// check if hybridization energy is not infinite
 	if ( E_isNotINF(hybridE) ) {
 		// compute overall interaction energy
 		return hybridE
 				// accessibility penalty
-				+ getED1( i1, j1 )
-				+ getED2( i2, j2 )
+				+ energy.getED1( i1, j1 )
+				+ energy.getED2( i2, j2 )
 				// dangling end penalty
 				// weighted by the probability that ends are unpaired
-				+ (getE_danglingLeft( i1, i2 )*getPr_danglingLeft(i1,j1,i2,j2))
-				+ (getE_danglingRight( j1, j2 )*getPr_danglingRight(i1,j1,i2,j2))
+				+ (energy.getE_danglingLeft( i1, i2 )*energy.getPr_danglingLeft(i1,j1,i2,j2))
+				+ (energy.getE_danglingRight( j1, j2 )*energy.getPr_danglingRight(i1,j1,i2,j2))
 				// helix closure penalty
-				+ getE_endLeft( i1, i2 )
-				+ getE_endRight( j1, j2 )
+				+ energy.getE_endLeft( i1, i2 )
+				+ energy.getE_endRight( j1, j2 )
 				;
 	} else {
 		// hybridE is infinite, thus overall energy is infinity as well
@@ -17,7 +17,7 @@ namespace IntaRNA {
  *
  * @author Martin Mann 2014
  */
-class InteractionEnergyBasePair: public InteractionEnergy {
+class InteractionEnergyBasePair final : public InteractionEnergy {
 
 public:
 
@@ -309,9 +309,12 @@ InteractionEnergyBasePair::InteractionEnergyBasePair(
   logQ1(),
   logQ2()
 {
+	// get tabulated Boltzmann weights
+	initBoltzmannWeights();
+
 	if (initES) {
-   	 computeES(accS1.getSequence(), logQ1);
-   	 computeES(accS2.getSequence(), logQ2);
+   	 computeES(seq1, logQ1);
+   	 computeES(seq2, logQ2);
 	}
 }
 
@@ -59,6 +59,30 @@ public:
 
 	///////////////  OVERWRITTEN MEMBERS USING OFFSET  /////////////////
 
+	/**
+	 * Provides the overall energy for an interaction (see
+	 * InteractionEnergy::getE()) via the original energy handler, such that
+	 * its accessibility handling (e.g. for disabled accessibility) is used.
+	 *
+	 * Note, the indices are shifted by an offset for computation.
+	 *
+	 * @param i1 the index of the first sequence interacting with i2
+	 * @param j1 the index of the first sequence interacting with j2 with i1<=j1
+	 * @param i2 the index of the second sequence interacting with i1
+	 * @param j2 the index of the second sequence interacting with j1 with i2<=j2
+	 * @param hybridE the hybridization energy for the interaction
+	 *
+	 * @return the overall energy of the interaction
+	 */
+	virtual
+	E_type
+	getE( const size_t i1, const size_t j1
+			, const size_t i2, const size_t j2
+			, const E_type hybridE ) const;
+
+	// the ensemble energy conversion of the super class is still used
+	using InteractionEnergy::getE;
+
 	/**
 	 * Provides the ED penalty for making a region with sequence 1 accessible
 	 *
@@ -516,6 +540,18 @@ setOffset2(size_t offset2)
 
 //////////////////////////////////////////////////////////////////////////
 
+inline
+E_type
+InteractionEnergyIdxOffset::
+getE( const size_t i1, const size_t j1
+		, const size_t i2, const size_t j2
+		, const E_type hybridE ) const
+{
+	return energyOriginal.getE( i1+offset1, j1+offset1, i2+offset2, j2+offset2, hybridE );
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 inline
 E_type
 InteractionEnergyIdxOffset::
@@ -1,8 +1,11 @@
 
 #include "IntaRNA/InteractionEnergyVrna.h"
+#include "IntaRNA/Telemetry.h"
 
 #include <cassert>
+#include <iomanip>
 #include <set>
+#include <sstream>
 
 // ES computation
 extern "C" {
@@ -17,6 +20,20 @@ namespace IntaRNA {
 
 ////////////////////////////////////////////////////////////////////////////
 
+const size_t InteractionEnergyVrna::interLoopTableMaxSize = 16777216;
+
+const size_t InteractionEnergyVrna::boundaryTableMaxSize = 4194304;
+
+const size_t InteractionEnergyVrna::InterLoopTable::numCodes = 5;
+
+std::shared_ptr<InteractionEnergyVrna::InterLoopTable> InteractionEnergyVrna::lastInterLoopTable;
+
+std::string InteractionEnergyVrna::lastInterLoopTableKey;
+
+std::map< std::string, std::shared_ptr<const InteractionEnergyVrna::EsMatrix> > InteractionEnergyVrna::esCache;
+
+////////////////////////////////////////////////////////////////////////////
+
 InteractionEnergyVrna::InteractionEnergyVrna(
 		const Accessibility & accS1
 		, const ReverseAccessibility & accS2
@@ -24,20 +41,43 @@ InteractionEnergyVrna::InteractionEnergyVrna(
 		, const size_t maxInternalLoopSize1
 		, const size_t maxInternalLoopSize2
 		, const bool initES
+		, const SequenceData * dataS2
 	)
  :
 	InteractionEnergy(accS1, accS2, maxInternalLoopSize1, maxInternalLoopSize2)
 // get final VRNA folding parameters
 	, foldModel( vrnaHandler.getModel() )
-	, foldParams( vrna_params( &foldModel ) )
+	, foldParamsShared( vrnaHandler.getParams() )
+	, foldParams( foldParamsShared.get() )
 	, RT(vrnaHandler.getRT())
 	, bpCG( BP_pair[RnaSequence::getCodeForChar('C')][RnaSequence::getCodeForChar('G')] )
 	, bpGC( BP_pair[RnaSequence::getCodeForChar('G')][RnaSequence::getCodeForChar('C')] )
-	, esValues1(NULL)
-	, esValues2(NULL)
+	, esValues1()
+	, esValues2()
+	, interLoopTable()
+	, boundaryTablesFeasible( size1()*size2() <= boundaryTableMaxSize )
+	, boundaryLeft()
+	, boundaryRight()
+	, boundaryTablesReady( false )
+	, boundaryTablesInit()
 {
 	vrna_md_defaults_reset( &foldModel );
 
+	// check if precomputed data matches (by content, since accS2 might be a
+	// copy of the accessibility the data was computed for)
+	if (dataS2 != NULL && dataS2->sequence.asString() != accS2.getSequence().asString()) {
+		throw std::runtime_error("InteractionEnergyVrna() : precomputed data of sequence 2 does not match its accessibility");
+	}
+
+	// get tabulated interior loop energies
+	interLoopTable = getInterLoopTable( vrnaHandler, dataS2 );
+
+	// get tabulated Boltzmann weights
+	initBoltzmannWeights();
+
+	// tabulated dangling end and helix closure energies are computed on
+	// first use (see hasBoundaryTables())
+
 	// init ES values if needed
 	if (initES) {
 //	23.11.2017 : should not be relevant anymore
@@ -45,12 +85,13 @@ InteractionEnergyVrna::InteractionEnergyVrna(
 //		#pragma omp critical(intarna_omp_callingVRNA)
 //#endif
 //		{
-		// create ES container to be filled
-		esValues1 = new EsMatrix();
-		esValues2 = new EsMatrix();
-		// fill ES container
-		computeES( accS1, *esValues1 );
-		computeES( accS2, *esValues2 );
+		// measure ES computation
+		Telemetry::Timer telemetryTimer( Telemetry::ES );
+		// get ES values (computed only once per sequence)
+		size_t computedCells = 0;
+		esValues1 = getES( accS1, vrnaHandler, computedCells );
+		esValues2 = (dataS2 != NULL && dataS2->esValues) ? dataS2->esValues : getES( accS2, vrnaHandler, computedCells );
+		telemetryTimer.addCells( computedCells );
 //		} // omp critical(intarna_omp_callingVRNA)
 	}
 }
@@ -59,14 +100,26 @@ InteractionEnergyVrna::InteractionEnergyVrna(
 
 InteractionEnergyVrna::~InteractionEnergyVrna()
 {
-	// garbage collection
-	if (foldParams != NULL) {
-		free(foldParams);
-		foldParams = NULL;
-	}
-	 INTARNA_CLEANUP(esValues1);
-	 INTARNA_CLEANUP(esValues2);
+}
 
+////////////////////////////////////////////////////////////////////////////
+
+InteractionEnergyVrna::SequenceData::
+SequenceData( const Accessibility & acc
+			, const VrnaHandler & vrnaHandler
+			, const bool initES )
+ :
+	sequence( acc.getSequence() )
+	, esValues()
+	, dinucleotides( getDinucleotides( acc.getSequence() ) )
+{
+	if (initES) {
+		// measure ES computation
+		Telemetry::Timer telemetryTimer( Telemetry::ES );
+		size_t computedCells = 0;
+		esValues = getES( acc, vrnaHandler, computedCells );
+		telemetryTimer.addCells( computedCells );
+	}
 }
 
 
@@ -158,7 +211,7 @@ getBestE_dangling() const
 
 void
 InteractionEnergyVrna::
-computeES( const Accessibility & acc, InteractionEnergyVrna::EsMatrix & esToFill )
+computeES( const Accessibility & acc, const VrnaHandler & vrnaHandler, InteractionEnergyVrna::EsMatrix & esToFill )
 {
 
 	// prepare container
@@ -166,7 +219,8 @@ computeES( const Accessibility & acc, InteractionEnergyVrna::EsMatrix & esToFill
 
 	// sequence length
 	const int seqLength = (int)acc.getSequence().size();
-	const E_type RT = getRT();
+	const E_type RT = vrnaHandler.getRT();
+	vrna_md_t foldModel = vrnaHandler.getModel();
 
 	// VRNA compatible data structures
 	char * sequence = (char *) vrna_alloc(sizeof(char) * (seqLength + 1));
@@ -241,5 +295,207 @@ computeES( const Accessibility & acc, InteractionEnergyVrna::EsMatrix & esToFill
 
 ////////////////////////////////////////////////////////////////////////////
 
+std::shared_ptr<const InteractionEnergyVrna::EsMatrix>
+InteractionEnergyVrna::
+getES( const Accessibility & acc, const VrnaHandler & vrnaHandler, size_t & computedCells )
+{
+	// description of all data the ES values depend on
+	std::stringstream key;
+	key <<"temperature=" <<std::setprecision(10) <<vrnaHandler.getTemperature()
+		<<"\nparameters=" <<vrnaHandler.getParamFile()
+		<<"\nmaxBpSpan=" <<acc.getAccConstraint().getMaxBpSpan()
+		<<"\nsequence=" <<acc.getSequence().asString()
+		<<"\nconstraint=";
+	for (size_t i=0; i<acc.getSequence().size(); i++) {
+		key <<acc.getAccConstraint().getVrnaDotBracket(i);
+	}
+
+	std::shared_ptr<const EsMatrix> esValues;
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_esCache)
+#endif
+	{
+		auto cached = esCache.find( key.str() );
+		if (cached != esCache.end()) {
+			esValues = cached->second;
+		}
+	}
+	// compute if not available yet
+	if (!esValues) {
+		EsMatrix * esToFill = new EsMatrix();
+		computeES( acc, vrnaHandler, *esToFill );
+		computedCells += esToFill->size1()*(esToFill->size1()+1)/2;
+		esValues.reset( esToFill );
+#if INTARNA_MULITHREADING
+		#pragma omp critical(intarna_omp_esCache)
+#endif
+		{ esCache[key.str()] = esValues; }
+	}
+	return esValues;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+std::shared_ptr<InteractionEnergyVrna::InterLoopTable>
+InteractionEnergyVrna::
+getInterLoopTable( const VrnaHandler & vrnaHandler, const SequenceData * dataS2 )
+{
+	// description of all settings the energies depend on
+	std::stringstream key;
+	key <<"temperature=" <<std::setprecision(10) <<vrnaHandler.getTemperature()
+		<<"\nparameters=" <<vrnaHandler.getParamFile()
+		<<"\nmaxInternalLoopSize1=" <<getMaxInternalLoopSize1()
+		<<"\nmaxInternalLoopSize2=" <<getMaxInternalLoopSize2();
+
+	// loop contexts of both sequences
+	const DinucleotideList dinuc1 = getDinucleotides( accS1.getSequence() );
+	const DinucleotideList dinuc2 = dataS2 != NULL ? dataS2->dinucleotides : getDinucleotides( accS2.getSequence() );
+
+	std::shared_ptr<InterLoopTable> table;
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_interLoopTable)
+#endif
+	{
+		// create new table if not available for this setup
+		if (!lastInterLoopTable || lastInterLoopTableKey != key.str()) {
+			lastInterLoopTable.reset( new InterLoopTable( getMaxInternalLoopSize1(), getMaxInternalLoopSize2() ) );
+			lastInterLoopTableKey = key.str();
+		}
+		// check if table size is feasible
+		if ( (lastInterLoopTable->maxInternalLoopSize1+1)*(lastInterLoopTable->maxInternalLoopSize2+1)
+				*lastInterLoopTable->numPairContexts*lastInterLoopTable->numPairContexts <= interLoopTableMaxSize )
+		{
+			// ensure energies for the contexts of the sequences are available
+			lastInterLoopTable->ensureBlocks( dinuc1, dinuc2, foldParams );
+			table = lastInterLoopTable;
+		}
+	}
+	return table;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+InteractionEnergyVrna::
+initBoundaryTables() const
+{
+	BoundaryTable left( size1()*size2() ), right( size1()*size2() );
+	for (size_t i1=0; i1<size1(); i1++) {
+	for (size_t i2=0; i2<size2(); i2++) {
+		const size_t idx = i1*size2()+i2;
+		left[idx].dangling = computeE_danglingLeft(i1,i2);
+		left[idx].end = computeE_end(i1,i2);
+		right[idx].dangling = computeE_danglingRight(i1,i2);
+		right[idx].end = left[idx].end;
+	}
+	}
+	// enable lookup
+	boundaryLeft.swap( left );
+	boundaryRight.swap( right );
+	boundaryTablesReady.store( true, std::memory_order_release );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+InteractionEnergyVrna::DinucleotideList
+InteractionEnergyVrna::
+getDinucleotides( const RnaSequence & seq )
+{
+	std::set< std::pair<RnaSequence::Code_type,RnaSequence::Code_type> > dinuc;
+	for (size_t i=0; i+1<seq.size(); i++) {
+		dinuc.insert( std::make_pair( seq.asCodes().at(i), seq.asCodes().at(i+1) ) );
+	}
+	return DinucleotideList( dinuc.begin(), dinuc.end() );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+InteractionEnergyVrna::InterLoopTable::
+InterLoopTable( const size_t maxInternalLoopSize1
+			, const size_t maxInternalLoopSize2 )
+ :
+	maxInternalLoopSize1(maxInternalLoopSize1)
+	, maxInternalLoopSize2(maxInternalLoopSize2)
+	, numPairContexts(0)
+	, pairContext( numCodes*numCodes*numCodes*numCodes, 0 )
+	, block( pairContext.size() )
+{
+	// check encoding of the alphabet
+	const RnaSequence::CodeSeq_type alphabet = RnaSequence::getCodeForString(RnaSequence::SequenceAlphabet);
+	for (size_t i=0; i<alphabet.size(); i++) {
+		if (alphabet.at(i) < 0 || (size_t)alphabet.at(i) >= numCodes) {
+			throw std::runtime_error("InteractionEnergyVrna::InterLoopTable() : unsupported encoding of nucleotide "+toString(RnaSequence::SequenceAlphabet.at(i)));
+		}
+	}
+	// enumerate the contexts with a valid base pair
+	for (size_t bp1=0; bp1<numCodes; bp1++) {
+	for (size_t bp2=0; bp2<numCodes; bp2++) {
+	for (size_t mm1=0; mm1<numCodes; mm1++) {
+	for (size_t mm2=0; mm2<numCodes; mm2++) {
+		pairContext[getContext(bp1,bp2,mm1,mm2)] = (BP_pair[bp1][bp2] > 0) ? numPairContexts++ : pairContext.size();
+	}
+	}
+	}
+	}
+	// mark invalid contexts
+	for (size_t c=0; c<pairContext.size(); c++) {
+		if (pairContext[c] == pairContext.size()) {
+			pairContext[c] = numPairContexts;
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+InteractionEnergyVrna::InterLoopTable::
+ensureBlocks( const DinucleotideList & dinuc1, const DinucleotideList & dinuc2
+			, vrna_param_t * foldParams )
+{
+	// combine the dinucleotides of both sequences, i.e. all left context halves
+	for (DinucleotideList::const_iterator d1 = dinuc1.begin(); d1 != dinuc1.end(); d1++) {
+	for (DinucleotideList::const_iterator d2 = dinuc2.begin(); d2 != dinuc2.end(); d2++) {
+		const size_t left = getContext( d1->first, d2->first, d1->second, d2->second );
+		// skip invalid or already computed contexts
+		if (pairContext[left] == numPairContexts || !block[left].empty()) {
+			continue;
+		}
+		// compute energies for all loop sizes and right contexts
+		std::vector<E_type> & leftBlock = block[left];
+		leftBlock.resize( (maxInternalLoopSize1+1)*(maxInternalLoopSize2+1)*numPairContexts );
+		for (size_t right=0; right<pairContext.size(); right++) {
+			if (pairContext[right] == numPairContexts) {
+				continue;
+			}
+			// decode right context
+			const int rMm2 = (int)(right % numCodes);
+			const int rMm1 = (int)((right / numCodes) % numCodes);
+			const int rBp2 = (int)((right / numCodes / numCodes) % numCodes);
+			const int rBp1 = (int)(right / numCodes / numCodes / numCodes);
+			for (size_t u1=0; u1<=maxInternalLoopSize1; u1++) {
+			for (size_t u2=0; u2<=maxInternalLoopSize2; u2++) {
+				// Vienna RNA : compute internal loop / stacking energy
+				leftBlock[ (u1*(maxInternalLoopSize2+1)+u2)*numPairContexts + pairContext[right] ]
+					= (E_type)E_IntLoop( (int)u1	// unpaired region 1
+							, (int)u2	// unpaired region 2
+							, BP_pair[d1->first][d2->first]	// type BP (i1,i2)
+							, BP_pair[rBp1][rBp2]	// type BP (j2,j1)
+							, d1->second
+							, d2->second
+							, rMm1
+							, rMm2
+							, foldParams)
+						// correct from dcal/mol to kcal/mol
+						/ (E_type)100.0
+						;
+			}
+			}
+		}
+	}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 
 } // namespace
@@ -2,6 +2,7 @@
 #ifndef INTARNA_INTERACTIONENERGYVIENNA_H_
 #define INTARNA_INTERACTIONENERGYVIENNA_H_
 
+#include "IntaRNA/HugePageAllocator.h"
 #include "IntaRNA/InteractionEnergy.h"
 #include "IntaRNA/VrnaHandler.h"
 
@@ -21,6 +22,13 @@ extern "C" {
 
 #include <boost/numeric/ublas/triangular.hpp>
 
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
 namespace IntaRNA {
 
 // http://www.tbi.univie.ac.at/RNA/ViennaRNA/doc/RNAlib-2.3.0.pdf
@@ -31,11 +39,48 @@ namespace IntaRNA {
  *
  * @author Martin Mann 2014
  */
-class InteractionEnergyVrna: public InteractionEnergy {
+class InteractionEnergyVrna final : public InteractionEnergy {
 
 public:
 
+	//! matrix to store ES values (upper triangular matrix)
+	typedef boost::numeric::ublas::triangular_matrix<E_type, boost::numeric::ublas::upper> EsMatrix;
+
+	//! list of distinct dinucleotides (codes) of a sequence
+	typedef std::vector< std::pair< RnaSequence::Code_type, RnaSequence::Code_type > > DinucleotideList;
 
+	/**
+	 * Sequence-specific data of the energy computation that is independent
+	 * of the interaction partner, i.e. the ES values and the dinucleotides
+	 * (loop contexts) of the sequence. It is computed once per sequence and
+	 * given to the constructor of all energy objects of the sequence (e.g. a
+	 * query screened against many targets) to avoid its recomputation for
+	 * each sequence pair.
+	 */
+	class SequenceData {
+	public:
+
+		/**
+		 * Computes the sequence-specific data.
+		 *
+		 * @param acc the accessibility of the sequence (reversed for the
+		 *        second sequence of the energy objects)
+		 * @param vrnaHandler the VRNA parameter handler to be used
+		 * @param initES whether or not ES values are to be computed
+		 */
+		SequenceData( const Accessibility & acc
+					, const VrnaHandler & vrnaHandler
+					, const bool initES );
+
+		//! the sequence the data was computed for
+		const RnaSequence & sequence;
+
+		//! the ES values of the sequence (NULL if not computed)
+		std::shared_ptr<const EsMatrix> esValues;
+
+		//! the distinct dinucleotides of the sequence
+		const DinucleotideList dinucleotides;
+	};
 
 	/**
 	 * Construct energy utility object given the accessibility ED values for
@@ -53,6 +98,10 @@ public:
 	 *          for an intermolecular loop closed by base pairs (i1,i2) and
 	 *          (j1,j2) : (j2-i2+1) <= maxInternalLoopSize
 	 * @param initES whether or not ES values are to be computed
+	 * @param dataS2 if not NULL, the precomputed data of the second sequence
+	 *          (computed for accS2 or a copy of it with the same vrnaHandler
+	 *          and initES)
+	 *          that is used instead of its recomputation
 	 *
 	 */
 	InteractionEnergyVrna( const Accessibility & accS1
@@ -61,6 +110,7 @@ public:
 					, const size_t maxInternalLoopSize1 = 16
 					, const size_t maxInternalLoopSize2 = 16
 					, const bool initES = false
+					, const SequenceData * dataS2 = NULL
 				);
 
 	virtual ~InteractionEnergyVrna();
@@ -265,15 +315,135 @@ public:
 	E_type
 	getBestE_end() const;
 
+	/**
+	 * Maximal number of entries of the interior loop energy table. If the
+	 * maximal internal loop sizes would require a larger table, interior
+	 * loop energies are computed by VRNA calls instead.
+	 */
+	static const size_t interLoopTableMaxSize;
+
+	/**
+	 * Maximal number of base pairs (i.e. size1()*size2()) for which the
+	 * boundary energy tables are computed. For larger sequence pairs, the
+	 * dangling end and helix closure energies are computed on demand.
+	 */
+	static const size_t boundaryTableMaxSize;
+
 protected:
 
+	/**
+	 * Tabulated VRNA interior loop energies (in kcal/mol) for all loop sizes
+	 * up to the maximal internal loop sizes and all loop contexts, i.e.
+	 * closing base pair and adjacent mismatch nucleotides.
+	 *
+	 * The energies are stored in one block for each left context (i1,i2)
+	 * that holds the energies for all loop sizes (u1,u2) and all right
+	 * contexts (j1,j2). Blocks are only computed for left contexts that
+	 * occur within the sequences (see ensureBlocks()) and are not altered
+	 * afterwards. Thus, a table can be shared among all energy objects that
+	 * use the same parameter set (see getInterLoopTable()).
+	 */
+	class InterLoopTable {
+	public:
+
+		/**
+		 * Construction of an empty table
+		 * @param maxInternalLoopSize1 the maximal loop size in sequence 1
+		 * @param maxInternalLoopSize2 the maximal loop size in sequence 2
+		 */
+		InterLoopTable( const size_t maxInternalLoopSize1
+					, const size_t maxInternalLoopSize2 );
+
+		/**
+		 * Computes all blocks of left contexts that can occur for the given
+		 * sequences and that are not computed yet.
+		 *
+		 * NOTE: not thread-safe, i.e. has to be called within a critical
+		 * section if the table is shared.
+		 *
+		 * @param dinuc1 the dinucleotides of the first sequence
+		 * @param dinuc2 the dinucleotides of the second (reversed) sequence
+		 * @param foldParams the VRNA energy parameters to be used
+		 */
+		void
+		ensureBlocks( const DinucleotideList & dinuc1, const DinucleotideList & dinuc2
+					, vrna_param_t * foldParams );
+
+		/**
+		 * Provides the index of a loop context
+		 * @param bp1 the code of the first nucleotide of the base pair
+		 * @param bp2 the code of the second nucleotide of the base pair
+		 * @param mm1 the code of the mismatch nucleotide adjacent to bp1
+		 * @param mm2 the code of the mismatch nucleotide adjacent to bp2
+		 * @return the context index
+		 */
+		static
+		size_t
+		getContext( const RnaSequence::Code_type bp1, const RnaSequence::Code_type bp2
+				, const RnaSequence::Code_type mm1, const RnaSequence::Code_type mm2 );
+
+		//! the number of distinct nucleotide codes
+		static const size_t numCodes;
+
+		//! the maximal loop size in sequence 1
+		const size_t maxInternalLoopSize1;
+
+		//! the maximal loop size in sequence 2
+		const size_t maxInternalLoopSize2;
+
+		//! the number of loop contexts with a valid base pair
+		size_t numPairContexts;
+
+		//! for each loop context its index within a block (or numPairContexts
+		//! if the base pair is not valid)
+		std::vector<size_t> pairContext;
+
+		//! for each left loop context the computed block of energies
+		//! (empty if not computed yet) indexed by
+		//! (u1*(maxInternalLoopSize2+1)+u2)*numPairContexts+pairContext[right]
+		std::vector< std::vector<E_type> > block;
+
+	};
+
+	/**
+	 * Provides the interior loop energy table for the given parameter
+	 * setup, which is shared among all energy objects of the same setup.
+	 * The table's blocks for the sequences of this object are computed if
+	 * needed.
+	 *
+	 * @param vrnaHandler the VRNA parameter handler used
+	 * @param dataS2 the precomputed data of the second sequence or NULL
+	 * @return the table to be used or NULL if too large
+	 */
+	std::shared_ptr<InterLoopTable>
+	getInterLoopTable( const VrnaHandler & vrnaHandler, const SequenceData * dataS2 );
+
+	/**
+	 * Provides the distinct dinucleotides of a sequence, i.e. all left
+	 * context halves of interior loops.
+	 * @param seq the sequence of interest
+	 * @return the sorted list of distinct dinucleotides
+	 */
+	static
+	DinucleotideList
+	getDinucleotides( const RnaSequence & seq );
+
+	//! the interior loop energy table of the last parameter setup used
+	static std::shared_ptr<InterLoopTable> lastInterLoopTable;
+
+	//! the parameter setup description of lastInterLoopTable
+	static std::string lastInterLoopTableKey;
+
 
 	//! Vienna RNA package : folding model to be used for the energy computation
 	vrna_md_t foldModel;
 
 	//! Vienna RNA package : folding parameters to be used for the energy
-	//! computation
-	vrna_param_t * foldParams;
+	//! computation (shared among all energy handlers of the same setup)
+	const std::shared_ptr<vrna_param_t> foldParamsShared;
+
+	//! Vienna RNA package : direct access to foldParamsShared
+	vrna_param_t * const foldParams;
 
 	//! the RT constant to be used for Boltzmann weight computations
 	E_type RT;
@@ -284,14 +454,99 @@ protected:
 	//! base pair code for (G,C)
 	const int bpGC;
 
-	//! matrix to store ES values (upper triangular matrix)
-	typedef boost::numeric::ublas::triangular_matrix<E_type, boost::numeric::ublas::upper> EsMatrix;
-
 	//! the ES values for seq1 if computed (otherwise NULL)
-	EsMatrix * esValues1;
+	std::shared_ptr<const EsMatrix> esValues1;
 
 	//! the ES values for seq2 if computed (otherwise NULL)
-	EsMatrix * esValues2;
+	std::shared_ptr<const EsMatrix> esValues2;
+
+	//! the ES values of all sequences computed so far, indexed by a
+	//! description of the sequence, its constraint and the energy setup
+	static std::map< std::string, std::shared_ptr<const EsMatrix> > esCache;
+
+	//! the tabulated interior loop energies (NULL if not available)
+	std::shared_ptr<InterLoopTable> interLoopTable;
+
+	/**
+	 * Energy contributions of an interaction boundary that only depend on
+	 * the closing intermolecular base pair
+	 */
+	class BoundaryE {
+	public:
+		//! the dangling end energy (see getE_danglingLeft/Right())
+		E_type dangling;
+		//! the helix closure penalty (see getE_endLeft/Right())
+		E_type end;
+	};
+
+	//! container of boundary energies indexed by i1*size2()+i2
+	typedef HugePageAllocator<BoundaryE>::vector BoundaryTable;
+
+	//! whether or not the sequences do not exceed boundaryTableMaxSize,
+	//! i.e. the boundary energy tables are computed on first use
+	const bool boundaryTablesFeasible;
+
+	//! the boundary energies of all left interaction ends (i1,i2)
+	//! (empty until first use or if not boundaryTablesFeasible)
+	mutable BoundaryTable boundaryLeft;
+
+	//! the boundary energies of all right interaction ends (j1,j2)
+	//! (empty until first use or if not boundaryTablesFeasible)
+	mutable BoundaryTable boundaryRight;
+
+	//! whether or not boundaryLeft and boundaryRight are computed
+	mutable std::atomic<bool> boundaryTablesReady;
+
+	//! ensures the boundary tables are computed only once among all threads
+	mutable std::once_flag boundaryTablesInit;
+
+	/**
+	 * Checks whether or not the boundary energy tables are available and
+	 * computes them on first use, such that energy objects that never
+	 * evaluate interaction boundaries (e.g. for seed or accessibility
+	 * checks) do not pay for them.
+	 * @return true if boundaryLeft and boundaryRight can be used;
+	 *         false if the energies have to be computed on demand
+	 */
+	bool
+	hasBoundaryTables() const;
+
+	/**
+	 * Computes the boundary energy tables boundaryLeft and boundaryRight.
+	 * To be called only once via boundaryTablesInit (see hasBoundaryTables()).
+	 */
+	void
+	initBoundaryTables() const;
+
+	/**
+	 * Computes the dangling end energy for the left side of the
+	 * interaction closed by (i1,i2) via VRNA (see getE_danglingLeft())
+	 * @param i1 the index of the first sequence interacting with i2
+	 * @param i2 the index of the second sequence interacting with i1
+	 * @return the dangling end penalty for the left side of the interaction
+	 */
+	E_type
+	computeE_danglingLeft( const size_t i1, const size_t i2 ) const;
+
+	/**
+	 * Computes the dangling end energy for the right side of the
+	 * interaction closed by (j1,j2) via VRNA (see getE_danglingRight())
+	 * @param j1 the index of the first sequence interacting with j2
+	 * @param j2 the index of the second sequence interacting with j1
+	 * @return the dangling end penalty for the right side of the interaction
+	 */
+	E_type
+	computeE_danglingRight( const size_t j1, const size_t j2 ) const;
+
+	/**
+	 * Computes the helix closure penalty for a closing base pair
+	 * (see getE_endLeft())
+	 * @param i1 the index in the first sequence
+	 * @param i2 the index in the second sequence
+	 * @return the VRNA non-GC penalty for (i1,i2)
+	 */
+	E_type
+	computeE_end( const size_t i1, const size_t i2 ) const;
 
 	/**
 	 * Checks whether or not a given base pair is a GC base pair
@@ -305,10 +560,26 @@ protected:
 	/**
 	 * Computes the ES values and fills esValues container
 	 * @param acc the accessibility object for the sequence to compute the ES values for
+	 * @param vrnaHandler the VRNA handler the energy setup is taken from
 	 * @param esToFill the container to write the ES values to
 	 */
+	static
 	void
-	computeES( const Accessibility & acc, EsMatrix & esToFill );
+	computeES( const Accessibility & acc, const VrnaHandler & vrnaHandler, EsMatrix & esToFill );
+
+	/**
+	 * Provides the ES values for the given sequence, which are computed only
+	 * once per sequence, constraint and energy setup and shared among all
+	 * energy handlers.
+	 * @param acc the accessibility object for the sequence to get the ES values for
+	 * @param vrnaHandler the VRNA handler the energy setup is taken from
+	 * @param computedCells IN/OUT increased by the number of ES values
+	 *        computed if not available from the cache
+	 * @return the ES values of the sequence
+	 */
+	static
+	std::shared_ptr<const EsMatrix>
+	getES( const Accessibility & acc, const VrnaHandler & vrnaHandler, size_t & computedCells );
 
 };
 
@@ -328,13 +599,34 @@ getE_init() const
 
 ////////////////////////////////////////////////////////////////////////////
 
+inline
+bool
+InteractionEnergyVrna::
+hasBoundaryTables() const
+{
+	if (boundaryTablesReady.load( std::memory_order_acquire )) {
+		return true;
+	}
+	if (!boundaryTablesFeasible) {
+		return false;
+	}
+	// compute tables on first use (other threads wait for completion)
+	std::call_once( boundaryTablesInit, &InteractionEnergyVrna::initBoundaryTables, this );
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 inline
 E_type
 InteractionEnergyVrna::
 getE_endLeft( const size_t i1, const size_t i2 ) const
 {
-	// VRNA non-GC penalty
-	return isGC(i1,i2) ? 0.0 : (E_type)foldParams->TerminalAU/(E_type)100.0;
+	// lookup of the tabulated energy if available
+	if (hasBoundaryTables()) {
+		return boundaryLeft[i1*size2()+i2].end;
+	}
+	return computeE_end(i1,i2);
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -343,9 +635,23 @@ inline
 E_type
 InteractionEnergyVrna::
 getE_endRight( const size_t j1, const size_t j2 ) const
+{
+	// lookup of the tabulated energy if available
+	if (hasBoundaryTables()) {
+		return boundaryRight[j1*size2()+j2].end;
+	}
+	return computeE_end(j1,j2);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+E_type
+InteractionEnergyVrna::
+computeE_end( const size_t i1, const size_t i2 ) const
 {
 	// VRNA non-GC penalty
-	return isGC(j1,j2) ? 0.0 : (E_type)foldParams->TerminalAU/(E_type)100.0;
+	return isGC(i1,i2) ? 0.0 : (E_type)foldParams->TerminalAU/(E_type)100.0;
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -378,15 +684,23 @@ getE_interLeft( const size_t i1, const size_t j1, const size_t i2, const size_t
 	// if valid internal loop
 	if ( isValidInternalLoop(i1,j1,i2,j2) ) {
 		assert( i1!=j1 && i2!=j2 );
+		if (interLoopTable) {
+			// lookup of the tabulated energy
+			const RnaSequence::CodeSeq_type & codes1 = seq1.asCodes();
+			const RnaSequence::CodeSeq_type & codes2 = seq2.asCodes();
+			return interLoopTable->block[ InterLoopTable::getContext( codes1[i1], codes2[i2], codes1[i1+1], codes2[i2+1] ) ]
+						[ ((j1-i1-1)*(interLoopTable->maxInternalLoopSize2+1)+(j2-i2-1))*interLoopTable->numPairContexts
+						  + interLoopTable->pairContext[ InterLoopTable::getContext( codes2[j2], codes1[j1], codes1[j1-1], codes2[j2-1] ) ] ];
+		}
 		// Vienna RNA : compute internal loop / stacking energy for base pair [i1,i2]
 		return (E_type)E_IntLoop(	(int)j1-i1-1	// unpaired region 1
 							, (int)j2-i2-1	// unpaired region 2
-							, BP_pair[accS1.getSequence().asCodes().at(i1)][accS2.getSequence().asCodes().at(i2)]	// type BP (i1,i2)
-							, BP_pair[accS2.getSequence().asCodes().at(j2)][accS1.getSequence().asCodes().at(j1)]	// type BP (j2,j1)
-							, accS1.getSequence().asCodes().at(i1+1)
-							, accS2.getSequence().asCodes().at(i2+1)
-							, accS1.getSequence().asCodes().at(j1-1)
-							, accS2.getSequence().asCodes().at(j2-1)
+							, BP_pair[seq1.asCodes().at(i1)][seq2.asCodes().at(i2)]	// type BP (i1,i2)
+							, BP_pair[seq2.asCodes().at(j2)][seq1.asCodes().at(j1)]	// type BP (j2,j1)
+							, seq1.asCodes().at(i1+1)
+							, seq2.asCodes().at(i2+1)
+							, seq1.asCodes().at(j1-1)
+							, seq2.asCodes().at(j2-1)
 							, foldParams)
 				// correct from dcal/mol to kcal/mol
 				/ (E_type)100.0
@@ -402,18 +716,32 @@ inline
 E_type
 InteractionEnergyVrna::
 getE_danglingLeft( const size_t i1, const size_t i2 ) const
+{
+	// lookup of the tabulated energy if available
+	if (hasBoundaryTables()) {
+		return boundaryLeft[i1*size2()+i2].dangling;
+	}
+	return computeE_danglingLeft(i1,i2);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+E_type
+InteractionEnergyVrna::
+computeE_danglingLeft( const size_t i1, const size_t i2 ) const
 {
 	// Vienna RNA : dangling end contribution
-	return (E_type) E_Stem( BP_pair[accS1.getSequence().asCodes().at(i1)][accS2.getSequence().asCodes().at(i2)]
-							  , ( i1==0 ? -1 : accS1.getSequence().asCodes().at(i1-1) )
-							  , ( i2==0 ? -1 : accS2.getSequence().asCodes().at(i2-1) )
+	return (E_type) E_Stem( BP_pair[seq1.asCodes().at(i1)][seq2.asCodes().at(i2)]
+							  , ( i1==0 ? -1 : seq1.asCodes().at(i1-1) )
+							  , ( i2==0 ? -1 : seq2.asCodes().at(i2-1) )
 							  , 1 // is an external loop
 							  , foldParams
 							  )
 					// correct from dcal/mol to kcal/mol
 							  /(E_type)100.0
 			// substract closing penalty
-			- getE_endLeft(i1,i2);
+			- computeE_end(i1,i2);
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -422,18 +750,32 @@ inline
 E_type
 InteractionEnergyVrna::
 getE_danglingRight( const size_t j1, const size_t j2 ) const
+{
+	// lookup of the tabulated energy if available
+	if (hasBoundaryTables()) {
+		return boundaryRight[j1*size2()+j2].dangling;
+	}
+	return computeE_danglingRight(j1,j2);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+E_type
+InteractionEnergyVrna::
+computeE_danglingRight( const size_t j1, const size_t j2 ) const
 {
 	// Vienna RNA : dangling end contribution (reverse base pair to be sequence end conform)
-	return (E_type) E_Stem( BP_pair[accS2.getSequence().asCodes().at(j2)][accS1.getSequence().asCodes().at(j1)]
-							  , ( j2+1>=accS2.getSequence().size() ? -1 : accS2.getSequence().asCodes().at(j2+1) )
-							  , ( j1+1>=accS1.getSequence().size() ? -1 : accS1.getSequence().asCodes().at(j1+1) )
+	return (E_type) E_Stem( BP_pair[seq2.asCodes().at(j2)][seq1.asCodes().at(j1)]
+							  , ( j2+1>=seq2.size() ? -1 : seq2.asCodes().at(j2+1) )
+							  , ( j1+1>=seq1.size() ? -1 : seq1.asCodes().at(j1+1) )
 							  , 1 // is an external loop
 							  , foldParams
 							  )
 					// correct from dcal/mol to kcal/mol
 							  /(E_type)100.0
 			// substract closing penalty
-			- getE_endRight(j1,j2);
+			- computeE_end(j1,j2);
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -447,7 +789,7 @@ getES1( const size_t i1, const size_t j1 ) const
 	// sanity check
 	if (i1>j1) throw std::runtime_error("InteractionEnergy::getES1(i1="+toString(i1)+" > j1="+toString(j1));
 	if (j1>=size1()) throw std::runtime_error("InteractionEnergy::getES1() : j1="+toString(j1)+" >= size1()="+toString(size1()));
-	if (esValues1 == NULL) throw std::runtime_error("InteractionEnergy::getES1() : ES values not initialized");
+	if (!esValues1) throw std::runtime_error("InteractionEnergy::getES1() : ES values not initialized");
 #endif
 
 	// return computed value
@@ -465,7 +807,7 @@ getES2( const size_t i2, const size_t j2 ) const
 	// sanity check
 	if (i2>j2) throw std::runtime_error("InteractionEnergy::getES2(i2="+toString(i2)+" > j2="+toString(j2));
 	if (j2>=size2()) throw std::runtime_error("InteractionEnergy::getES2() : j2="+toString(j2)+" >= size2()="+toString(size2()));
-	if (esValues2 == NULL) throw std::runtime_error("InteractionEnergy::getES2() : ES values not initialized");
+	if (!esValues2) throw std::runtime_error("InteractionEnergy::getES2() : ES values not initialized");
 #endif
 
 	// return computed value
@@ -479,7 +821,7 @@ bool
 InteractionEnergyVrna::
 isGC( const size_t i1, const size_t i2 ) const
 {
-	const int bpType = BP_pair[accS1.getSequence().asCodes().at(i1)][accS2.getSequence().asCodes().at(i2)];
+	const int bpType = BP_pair[seq1.asCodes().at(i1)][seq2.asCodes().at(i2)];
 	return (bpType==bpCG || bpType==bpGC);
 }
 
@@ -501,8 +843,8 @@ InteractionEnergyVrna::
 getE_multiHelix( const size_t j1, const size_t j2 ) const
 {
 	return ((E_type)foldParams->MLintern[
-	                                     BP_pair[accS2.getSequence().asCodes().at(j2)]
-	                                             [accS1.getSequence().asCodes().at(j1)]
+	                                     BP_pair[seq2.asCodes().at(j2)]
+	                                             [seq1.asCodes().at(j1)]
 	                                    ]) / (E_type)100.0;
 }
 
@@ -518,6 +860,17 @@ getE_multiClosing() const
 
 ////////////////////////////////////////////////////////////////////////////
 
+inline
+size_t
+InteractionEnergyVrna::InterLoopTable::
+getContext( const RnaSequence::Code_type bp1, const RnaSequence::Code_type bp2
+		, const RnaSequence::Code_type mm1, const RnaSequence::Code_type mm2 )
+{
+	return ((bp1*numCodes + bp2)*numCodes + mm1)*numCodes + mm2;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 
 } // namespace
 
@@ -0,0 +1,172 @@
+
+#include "IntaRNA/KeyedFileStore.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace IntaRNA {
+
+////////////////////////////////////////////////////////////////////////////
+
+KeyedFileStore::
+KeyedFileStore( const std::string & storeDir
+				, const std::string & fileHeader
+				, const std::string & fileExtension
+				, const std::string & storeName )
+ :	storeDir(storeDir)
+	, fileHeader(fileHeader)
+	, fileExtension(fileExtension)
+	, storeName(storeName)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+KeyedFileStore::
+~KeyedFileStore()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+std::string
+KeyedFileStore::
+getFileName( const std::string & key ) const
+{
+	return storeDir + '/' + getHash( key ) + fileExtension;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+size_t
+KeyedFileStore::
+getDataOffset( const std::string & key ) const
+{
+	// header, key size and key
+	return fileHeader.size() + sizeof(uint64_t) + key.size();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+KeyedFileStore::
+open( const std::string & key, std::ifstream & in ) const
+{
+	const std::string fileName = getFileName( key );
+	in.open( fileName.c_str(), std::ios_base::in | std::ios_base::binary );
+	if (!in.is_open()) {
+		return false;
+	}
+
+	// check header and key
+	std::string header( fileHeader.size(), '\0' );
+	in.read( &(header[0]), header.size() );
+	uint64_t keySize = 0;
+	in.read( (char*)&keySize, sizeof(keySize) );
+	if (!in.good() || header != fileHeader || keySize != key.size()) {
+#if INTARNA_MULITHREADING
+			#pragma omp critical(intarna_omp_logOutput)
+#endif
+		{ VLOG(2) <<storeName <<" : ignoring invalid entry "<<fileName; }
+		in.close();
+		return false;
+	}
+	std::string entryKey( key.size(), '\0' );
+	in.read( &(entryKey[0]), entryKey.size() );
+	if (!in.good() || entryKey != key) {
+		// hash collision or corrupt entry
+#if INTARNA_MULITHREADING
+			#pragma omp critical(intarna_omp_logOutput)
+#endif
+		{ VLOG(2) <<storeName <<" : entry "<<fileName<<" is about another key"; }
+		in.close();
+		return false;
+	}
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+KeyedFileStore::
+write( const std::string & key, const DataBlocks & data ) const
+{
+	const std::string fileName = getFileName( key );
+
+	// unique temporary file name for this thread and call
+	std::stringstream tmpFileName;
+	tmpFileName <<fileName <<".tmp"
+			<<std::hash<std::thread::id>()( std::this_thread::get_id() )
+			<<'_' <<std::chrono::steady_clock::now().time_since_epoch().count();
+
+	std::ofstream out( tmpFileName.str().c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc );
+	if (!out.is_open()) {
+#if INTARNA_MULITHREADING
+			#pragma omp critical(intarna_omp_logOutput)
+#endif
+		{ LOG(WARNING) <<storeName <<" : could not write entry "<<fileName; }
+		return;
+	}
+
+	// header and key
+	const uint64_t keySize = key.size();
+	out.write( fileHeader.c_str(), fileHeader.size() );
+	out.write( (const char*)&keySize, sizeof(keySize) );
+	out.write( key.c_str(), key.size() );
+	// data
+	for (DataBlocks::const_iterator block = data.begin(); block != data.end(); block++) {
+		out.write( block->first, block->second );
+	}
+	out.close();
+
+	// publish entry
+	if (out.fail() || std::rename( tmpFileName.str().c_str(), fileName.c_str() ) != 0) {
+#if INTARNA_MULITHREADING
+			#pragma omp critical(intarna_omp_logOutput)
+#endif
+		{ LOG(WARNING) <<storeName <<" : could not write entry "<<fileName; }
+		std::remove( tmpFileName.str().c_str() );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+std::string
+KeyedFileStore::
+getHash( const std::string & data )
+{
+	// 64-bit FNV-1a hash
+	uint64_t hash = 14695981039346656037ULL;
+	for (std::string::const_iterator c = data.begin(); c != data.end(); c++) {
+		hash ^= (uint64_t)(unsigned char)(*c);
+		hash *= 1099511628211ULL;
+	}
+	std::stringstream hashString;
+	hashString <<std::hex <<std::setw(16) <<std::setfill('0') <<hash;
+	return hashString.str();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+std::string
+KeyedFileStore::
+getFileContent( const std::string & fileName )
+{
+	std::ifstream in( fileName.c_str(), std::ios_base::in | std::ios_base::binary );
+	if (!in.is_open()) {
+		throw std::runtime_error("KeyedFileStore : could not read file '"+fileName+"'");
+	}
+	std::stringstream content;
+	content <<in.rdbuf();
+	return content.str();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
@@ -0,0 +1,151 @@
+
+#ifndef INTARNA_KEYEDFILESTORE_H_
+#define INTARNA_KEYEDFILESTORE_H_
+
+#include "IntaRNA/general.h"
+
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace IntaRNA {
+
+/**
+ * Persistent on-disk store of binary entries that are identified by a key,
+ * i.e. a description of everything the entry's data depends on. It is the
+ * common base of the on-disk caches (accessibility cache, result store,
+ * VRNA parameter cache), which define the keys and the data layout.
+ *
+ * Each entry is stored in its own file within the store directory. The file
+ * name is given by a hash of the entry's key. Each entry file starts with a
+ * store-specific header and the key, such that outdated formats and hash
+ * collisions are detected, followed by the entry's data.
+ *
+ * Entries are written to a temporary file that is renamed afterwards. Thus,
+ * the store can be shared by threads and concurrent runs.
+ *
+ */
+class KeyedFileStore {
+
+public:
+
+	//! list of (pointer,size) memory blocks that form the data of an entry
+	typedef std::vector< std::pair<const char*,size_t> > DataBlocks;
+
+public:
+
+	/**
+	 * Construction
+	 * @param storeDir the (existing) directory to store the entries in
+	 * @param fileHeader identifier at the beginning of each entry file
+	 * @param fileExtension the extension of the entry file names
+	 * @param storeName the name of the store used for log messages
+	 */
+	KeyedFileStore( const std::string & storeDir
+					, const std::string & fileHeader
+					, const std::string & fileExtension
+					, const std::string & storeName );
+
+	/**
+	 * destruction
+	 */
+	virtual ~KeyedFileStore();
+
+	/**
+	 * Provides the name of the file that holds an entry.
+	 * @param key the key of the entry
+	 * @return the full file name of the entry
+	 */
+	std::string
+	getFileName( const std::string & key ) const;
+
+	/**
+	 * Provides the position of the entry's data within its file
+	 * @param key the key of the entry
+	 * @return the position after the entry's header and key
+	 */
+	size_t
+	getDataOffset( const std::string & key ) const;
+
+	/**
+	 * Opens an entry for reading if available and checks its header and key.
+	 *
+	 * @param key the key of the entry
+	 * @param in the stream to open, which is positioned at the entry's data
+	 *        afterwards (see getDataOffset())
+	 * @return true if the entry was found and is about the key;
+	 *         false otherwise
+	 */
+	bool
+	open( const std::string & key, std::ifstream & in ) const;
+
+	/**
+	 * Stores an entry. Write failures are logged but otherwise ignored,
+	 * since the store is not mandatory for computation.
+	 *
+	 * @param key the key of the entry
+	 * @param data the memory blocks to be written consecutively as the
+	 *        entry's data
+	 */
+	void
+	write( const std::string & key, const DataBlocks & data ) const;
+
+	/**
+	 * Provides the name of the store used for log messages
+	 * @return the store name
+	 */
+	const std::string &
+	getName() const;
+
+	/**
+	 * Computes the 64-bit FNV-1a hash of some data.
+	 * @param data the data to hash
+	 * @return the hexadecimal encoding of the hash
+	 */
+	static
+	std::string
+	getHash( const std::string & data );
+
+	/**
+	 * Reads the full content of a file, e.g. to describe input files
+	 * within keys.
+	 * @param fileName the file to read
+	 * @return the file's content
+	 * @throw std::runtime_error if the file can not be read
+	 */
+	static
+	std::string
+	getFileContent( const std::string & fileName );
+
+protected:
+
+	//! the directory where the entries are stored
+	std::string storeDir;
+
+	//! identifier at the beginning of each entry file
+	std::string fileHeader;
+
+	//! the extension of the entry file names
+	std::string fileExtension;
+
+	//! the name of the store used for log messages
+	std::string storeName;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+const std::string &
+KeyedFileStore::
+getName() const
+{
+	return storeName;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_KEYEDFILESTORE_H_ */
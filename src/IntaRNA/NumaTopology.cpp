@@ -0,0 +1,129 @@
+
+#include "IntaRNA/NumaTopology.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#if INTARNA_HAVE_SCHED_GETCPU
+	#include <sched.h>
+#endif
+
+namespace IntaRNA {
+
+////////////////////////////////////////////////////////////////////////////
+
+size_t
+NumaTopology::
+getNodeNumber()
+{
+	const std::vector<size_t> & cpuNodes = getCpuNodes();
+	if (cpuNodes.empty()) {
+		return 1;
+	}
+	return *std::max_element( cpuNodes.begin(), cpuNodes.end() ) + 1;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+size_t
+NumaTopology::
+getCurrentNode()
+{
+#if INTARNA_HAVE_SCHED_GETCPU
+	const int cpu = sched_getcpu();
+	if (cpu >= 0) {
+		return getNode( (size_t)cpu );
+	}
+#endif
+	return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+size_t
+NumaTopology::
+getNode( const size_t cpu )
+{
+	const std::vector<size_t> & cpuNodes = getCpuNodes();
+	return cpu < cpuNodes.size() ? cpuNodes.at(cpu) : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+std::vector<size_t>
+NumaTopology::
+parseCpuList( const std::string & cpuList )
+{
+	std::vector<size_t> cpus;
+	std::stringstream list( cpuList );
+	std::string range;
+	while (std::getline( list, range, ',' )) {
+		// trim whitespace (e.g. the trailing newline of the sysfs file)
+		range.erase( std::remove_if( range.begin(), range.end(), ::isspace ), range.end() );
+		if (range.empty()) {
+			continue;
+		}
+		const size_t sep = range.find('-');
+		char * end = NULL;
+		const size_t from = std::strtoul( range.c_str(), &end, 10 );
+		if (end == range.c_str() || (sep == std::string::npos && *end != '\0')) {
+			return std::vector<size_t>();
+		}
+		size_t to = from;
+		if (sep != std::string::npos) {
+			const char * toStr = range.c_str()+sep+1;
+			to = std::strtoul( toStr, &end, 10 );
+			if (end == toStr || *end != '\0' || to < from) {
+				return std::vector<size_t>();
+			}
+		}
+		for (size_t cpu = from; cpu <= to; cpu++) {
+			cpus.push_back( cpu );
+		}
+	}
+	return cpus;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+const std::vector<size_t> &
+NumaTopology::
+getCpuNodes()
+{
+	// read once (thread-safe initialization of local statics)
+	static const std::vector<size_t> cpuNodes = readCpuNodes();
+	return cpuNodes;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+std::vector<size_t>
+NumaTopology::
+readCpuNodes()
+{
+	std::vector<size_t> cpuNodes;
+	// read the CPU list of each node until the first missing one
+	for (size_t node = 0; ; node++) {
+		std::ifstream in( ("/sys/devices/system/node/node"+toString(node)+"/cpulist").c_str() );
+		if (!in.is_open()) {
+			break;
+		}
+		std::string cpuList;
+		std::getline( in, cpuList );
+		const std::vector<size_t> cpus = parseCpuList( cpuList );
+		for (std::vector<size_t>::const_iterator cpu = cpus.begin(); cpu != cpus.end(); cpu++) {
+			if (*cpu >= cpuNodes.size()) {
+				cpuNodes.resize( *cpu+1, 0 );
+			}
+			cpuNodes[*cpu] = node;
+		}
+	}
+	return cpuNodes;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
@@ -0,0 +1,88 @@
+
+#ifndef INTARNA_NUMATOPOLOGY_H_
+#define INTARNA_NUMATOPOLOGY_H_
+
+#include "IntaRNA/general.h"
+
+#include <string>
+#include <vector>
+
+namespace IntaRNA {
+
+/**
+ * Provides the NUMA (non-uniform memory access) node layout of the machine,
+ * i.e. which CPUs share a local memory, to place read-mostly data in the
+ * memory local to the threads using it.
+ *
+ * The layout is read once from the Linux sysfs (/sys/devices/system/node).
+ * If not available (other systems or no NUMA support), a single node
+ * containing all CPUs is assumed.
+ *
+ * All static member functions are thread-safe.
+ *
+ */
+class NumaTopology {
+
+public:
+
+	/**
+	 * Access to the number of NUMA nodes of the machine.
+	 * @return the number of nodes (1 if unknown)
+	 */
+	static
+	size_t
+	getNodeNumber();
+
+	/**
+	 * Access to the NUMA node of the CPU currently executing the calling
+	 * thread. Unless threads are bound to CPUs (e.g. via OMP_PROC_BIND), the
+	 * node might change anytime.
+	 * @return the node index (< getNodeNumber()) or 0 if unknown
+	 */
+	static
+	size_t
+	getCurrentNode();
+
+	/**
+	 * Access to the NUMA node of a CPU.
+	 * @param cpu the index of the CPU
+	 * @return the node index (< getNodeNumber()) or 0 if unknown
+	 */
+	static
+	size_t
+	getNode( const size_t cpu );
+
+	/**
+	 * Parses a CPU list in sysfs format (e.g. "0-3,8,10-11").
+	 * @param cpuList the list to parse
+	 * @return the CPU indices listed (empty if the list is not well formed)
+	 */
+	static
+	std::vector<size_t>
+	parseCpuList( const std::string & cpuList );
+
+protected:
+
+	/**
+	 * Access to the NUMA node of each CPU, read on first access.
+	 * @return the node index per CPU index (empty if unknown)
+	 */
+	static
+	const std::vector<size_t> &
+	getCpuNodes();
+
+	/**
+	 * Reads the NUMA node of each CPU from sysfs.
+	 * @return the node index per CPU index (empty if not available)
+	 */
+	static
+	std::vector<size_t>
+	readCpuNodes();
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_NUMATOPOLOGY_H_ */
@@ -179,6 +179,102 @@ NussinovHandler::getPu(const size_t i, const size_t j, const RnaSequence &seq,
   return ret;
 }
 
+/**
+ * Index of the element (i,j) with i <= j within the row-wise storage of an
+ * upper triangular N x N matrix, i.e. the elements of each row are adjacent.
+ */
+static inline
+size_t
+triangularIndex( const size_t i, const size_t j, const size_t N )
+{
+  return i * N - (i * (i - 1)) / 2 + (j - i);
+}
+
+void
+NussinovHandler::getPuBand(const RnaSequence &seq,
+    const E_type bpWeight, const size_t minLoopLength,
+    const size_t maxLength, std::vector<P_type> &Pu)
+{
+  const size_t N = seq.size();
+  Pu.assign(N * maxLength, 0.0);
+  if (N == 0) {
+    return;
+  }
+  const size_t triSize = triangularIndex(N - 1, N - 1, N) + 1;
+
+  // partition functions Q(i,j) and Qb(i,j) (Q(i,j) = 1 for i > j)
+  std::vector<P_type> Q(triSize, 0.0);
+  std::vector<P_type> Qb(triSize, 0.0);
+
+  // bottom-up computation of all rows with decreasing start index i, where
+  //   Q(i,j) = Q(i,j-1) + sum_{k>=i} Q(i,k-1) * Qb(k,j)
+  // the contributions of k > i are added to row i as soon as Q(i,k-1) is known
+  for (size_t i = N; i-- > 0; ) {
+    P_type * const Qi = &(Q[triangularIndex(i, i, N)]);
+    P_type * const Qbi = &(Qb[triangularIndex(i, i, N)]);
+    // base pairs (i,j)
+    for (size_t j = i + minLoopLength + 1; j < N; ++j) {
+      if (RnaSequence::areComplementary(seq, seq, i, j)) {
+        Qbi[j - i] = bpWeight * (i + 1 <= j - 1 ? Q[triangularIndex(i + 1, j - 1, N)] : 1.0);
+      }
+    }
+    for (size_t j = i; j < N; ++j) {
+      // j unpaired or paired with k = i (Qi[j-i] holds the sum for k > i)
+      const P_type qij = (j > i ? Qi[j - 1 - i] : 1.0) + Qbi[j - i] + Qi[j - i];
+      Qi[j - i] = qij;
+      // add Q(i,j) * Qb(j+1,l) for all l
+      if (j + 1 < N) {
+        const P_type * const Qbk = &(Qb[triangularIndex(j + 1, j + 1, N)]);
+        for (size_t l = j + minLoopLength + 2; l < N; ++l) {
+          Qi[l - i] += qij * Qbk[l - j - 1];
+        }
+      }
+    }
+  }
+  const P_type Qtotal = Q[triangularIndex(0, N - 1, N)];
+
+  // outside values Out(i,j), i.e. the unpaired probability of region (i,j),
+  // with increasing start index i
+  //   Out(i,j) = Q(0,i-1) * Q(j+1,N-1) / Qtotal + sum_{p<i} Q(p+1,i-1) * R(p,j)
+  //   R(p,j) = sum_{q>j} Ph(p,q) * Q(j+1,q-1)
+  // where Ph(p,q) = bpWeight * Out(p,q) if (p,q) can form a base pair
+  // (the base pair probability of (p,q) is Qb(p,q) * Out(p,q))
+  std::vector<P_type> R(triSize, 0.0);
+  std::vector<P_type> out(N, 0.0);
+  std::vector<P_type> Ph(N, 0.0);
+  for (size_t i = 0; i < N; ++i) {
+    const P_type left = (i > 0 ? Q[triangularIndex(0, i - 1, N)] : 1.0);
+    for (size_t j = i; j < N; ++j) {
+      out[j] = left * (j + 1 < N ? Q[triangularIndex(j + 1, N - 1, N)] : 1.0) / Qtotal;
+    }
+    // add enclosing base pairs (p,q) with p < i
+    for (size_t p = 0; p < i; ++p) {
+      const P_type Qinner = (p + 1 <= i - 1 ? Q[triangularIndex(p + 1, i - 1, N)] : 1.0);
+      const P_type * const Rp = &(R[triangularIndex(p, p, N)]);
+      for (size_t j = i; j < N; ++j) {
+        out[j] += Qinner * Rp[j - p];
+      }
+    }
+    // store unpaired probabilities and base pair weights of row i
+    for (size_t j = i; j < N; ++j) {
+      if (j - i < maxLength) {
+        Pu[i * maxLength + (j - i)] = out[j];
+      }
+      Ph[j] = (i + minLoopLength < j && RnaSequence::areComplementary(seq, seq, i, j)) ? bpWeight * out[j] : 0.0;
+    }
+    // R(i,j) for all j (q = j+1 with Q(j+1,j) = 1)
+    P_type * const Ri = &(R[triangularIndex(i, i, N)]);
+    for (size_t j = i; j + 1 < N; ++j) {
+      P_type r = Ph[j + 1];
+      const P_type * const Qr = &(Q[triangularIndex(j + 1, j + 1, N)]);
+      for (size_t q = j + 2; q < N; ++q) {
+        r += Ph[q] * Qr[q - j - 2];
+      }
+      Ri[j - i] = r;
+    }
+  }
+}
+
 void
 NussinovHandler::
 printMatrix( std::ostream & out, const NussinovHandler::E2dMatrix &M)
@@ -90,6 +90,23 @@ public:
       const E_type basePairWeight, const size_t minLoopLength,
       E2dMatrix &Q, E2dMatrix &Qb, P2dMatrix &Ppb, P2dMatrix &Pu);
 
+  /***
+   * Computes the unpaired probabilities of all regions (from, to) of the
+   * sequence with a length of at most maxLength via bottom-up dynamic
+   * programming in O(n^3) time, i.e. without the memoized recursions of
+   * getPu().
+   * All matrices are stored in contiguous memory such that the inner sums
+   * run over adjacent elements (and can thus be vectorized).
+   * @param seq The RNA Sequence
+   * @param basePairWeight The Boltzmann weight for energy distribution
+   * @param minLoopLength The minimum length of loops
+   * @param maxLength The maximal length of regions (>0) to compute
+   * @param Pu The unpaired probabilities to fill, where the probability of
+   *           region (from, to) is stored at index from*maxLength+(to-from)
+   */
+  static void getPuBand(const RnaSequence &seq,
+      const E_type basePairWeight, const size_t minLoopLength,
+      const size_t maxLength, std::vector<P_type> &Pu);
 
   /***
    * Get the dotBracket corresponding to the nussinov of the subsequence (from, to)
@@ -43,6 +43,11 @@ public:
 	//! the maximal energy difference to the mfe of a reported interaction
 	const E_type deltaE;
 
+	//! whether or not both sequences (and their accessibilities) are
+	//! identical, such that of two symmetric interactions (i.e. with swapped
+	//! roles of the sequences) only one has to be reported
+	const bool symmetric;
+
 public:
 
 	/**
@@ -54,11 +59,14 @@ public:
 	 *            sites are allowed for reporting
 	 * @param maxE maximal energy of a reported interaction (<= 0.0)
 	 * @param deltaE maximal energy difference of a reported interaction to mfe
+	 * @param symmetric whether or not both sequences are identical and only
+	 *            one of two symmetric interactions is to be reported
 	 */
 	OutputConstraint(	  const size_t reportMax = 1
 						, const ReportOverlap reportOverlap = OVERLAP_BOTH
 						, const E_type maxE = 0.0
-						, const E_type deltaE = E_INF );
+						, const E_type deltaE = E_INF
+						, const bool symmetric = false );
 
 	//! destruction
 	virtual ~OutputConstraint();
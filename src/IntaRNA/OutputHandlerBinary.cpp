@@ -0,0 +1,433 @@
+
+#include "IntaRNA/OutputHandlerBinary.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+#if INTARNA_MULITHREADING
+	#include <omp.h>
+#endif
+
+namespace IntaRNA {
+
+////////////////////////////////////////////////////////////////////////
+
+const uint32_t OutputHandlerBinary::formatVersion = 1;
+const uint32_t OutputHandlerBinary::byteOrderMark = 0x01020304;
+const uint32_t OutputHandlerBinary::batchMarker = 0x48435442;
+const size_t OutputHandlerBinary::defaultMaxBatchRows = 1 << 16;
+
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * Writes the binary representation of a value to a stream
+ * @param out the stream to write to
+ * @param value the value to write
+ */
+template < typename T >
+inline
+void
+writeBinary( std::ostream & out, const T & value )
+{
+	out.write( reinterpret_cast<const char*>(&value), sizeof(T) );
+}
+
+/**
+ * Writes the binary representation of all values to a stream
+ * @param out the stream to write to
+ * @param values the values to write
+ */
+template < typename T >
+inline
+void
+writeBinary( std::ostream & out, const std::vector<T> & values )
+{
+	if (!values.empty()) {
+		out.write( reinterpret_cast<const char*>(values.data()), values.size()*sizeof(T) );
+	}
+}
+
+/**
+ * Writes a string prefixed by its length to a stream
+ * @param out the stream to write to
+ * @param str the string to write
+ */
+inline
+void
+writeBinaryString( std::ostream & out, const std::string & str )
+{
+	writeBinary( out, (uint32_t)str.size() );
+	out.write( str.c_str(), str.size() );
+}
+
+////////////////////////////////////////////////////////////////////////
+
+OutputHandlerBinary::OutputHandlerBinary(
+		  std::ostream & out
+		, const InteractionEnergy & energy
+		, const ColTypeList colOrder
+		, const size_t maxBatchRows
+		)
+ :	out(out)
+	, energy(energy)
+	, colOrder(colOrder.begin(), colOrder.end())
+	, needContributions(OutputHandlerCsv::needsContributions(colOrder))
+	, needEDs(OutputHandlerCsv::needsEDs(colOrder))
+	, maxBatchRows(std::max((size_t)1,maxBatchRows))
+	, rows(0)
+	, intCols(colOrder.size())
+	, floatCols(colOrder.size())
+	, stringCols(colOrder.size())
+{
+}
+
+////////////////////////////////////////////////////////////////////////
+
+OutputHandlerBinary::~OutputHandlerBinary()
+{
+	// write remaining rows
+	writeBatch();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+OutputHandlerBinary::ValueType
+OutputHandlerBinary::
+getValueType( const ColType col )
+{
+	switch (col) {
+	case OutputHandlerCsv::id1 :
+	case OutputHandlerCsv::id2 :
+	case OutputHandlerCsv::seq1 :
+	case OutputHandlerCsv::seq2 :
+	case OutputHandlerCsv::subseq1 :
+	case OutputHandlerCsv::subseq2 :
+	case OutputHandlerCsv::subseqDP :
+	case OutputHandlerCsv::subseqDB :
+	case OutputHandlerCsv::hybridDP :
+	case OutputHandlerCsv::hybridDB :
+		return DICT_STRING;
+	case OutputHandlerCsv::start1 :
+	case OutputHandlerCsv::end1 :
+	case OutputHandlerCsv::start2 :
+	case OutputHandlerCsv::end2 :
+	case OutputHandlerCsv::seedStart1 :
+	case OutputHandlerCsv::seedEnd1 :
+	case OutputHandlerCsv::seedStart2 :
+	case OutputHandlerCsv::seedEnd2 :
+		return INT32;
+	default :
+		return FLOAT32;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////
+
+std::string
+OutputHandlerBinary::
+getHeader( const ColTypeList & colTypes )
+{
+	std::stringstream header;
+	header.write( "IntaRNAB", 8 );
+	writeBinary( header, byteOrderMark );
+	writeBinary( header, formatVersion );
+	writeBinary( header, (uint32_t)colTypes.size() );
+	for (auto col = colTypes.begin(); col != colTypes.end(); col++) {
+		writeBinary( header, (uint8_t)getValueType(*col) );
+		writeBinaryString( header, OutputHandlerCsv::list2string( ColTypeList(1,*col) ) );
+	}
+	return header.str();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void
+OutputHandlerBinary::
+add( const Interaction & i )
+{
+#if INTARNA_IN_DEBUG_MODE
+	// debug checks
+	if ( i.basePairs.size() > 0 && ! i.isValid() ) {
+		throw std::runtime_error("OutputHandlerBinary::add() : given interaction is not valid : "+toString(i));
+	}
+#endif
+
+	// special handling if no base pairs present
+	if (i.basePairs.size() == 0) {
+		return;
+	}
+
+	// get interaction start/end per sequence
+	const size_t i1 = i.basePairs.begin()->first;
+	const size_t j1 = i.basePairs.rbegin()->first;
+	const size_t i2 = i.basePairs.begin()->second;
+	const size_t j2 = i.basePairs.rbegin()->second;
+
+	// get individual energy contributions if needed
+	InteractionEnergy::EnergyContributions contr;
+	if (needContributions) {
+		contr = energy.getE_contributions(i);
+	} else if (needEDs) {
+		contr = energy.getED_contributions(i);
+	}
+
+	const RnaSequence & rna1 = energy.getAccessibility1().getSequence();
+	const RnaSequence & rna2 = energy.getAccessibility2().getAccessibilityOrigin().getSequence();
+	const float NaN = std::numeric_limits<float>::quiet_NaN();
+
+	// ensure buffers are not altered concurrently
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_outputHandlerBinary)
+#endif
+	{
+	for (size_t c=0; c<colOrder.size(); c++) {
+		switch ( colOrder[c] ) {
+
+		case OutputHandlerCsv::id1:
+			stringCols[c].add( rna1.getId() );
+			break;
+
+		case OutputHandlerCsv::id2:
+			stringCols[c].add( rna2.getId() );
+			break;
+
+		case OutputHandlerCsv::seq1:
+			stringCols[c].add( rna1.asString() );
+			break;
+
+		case OutputHandlerCsv::seq2:
+			stringCols[c].add( rna2.asString() );
+			break;
+
+		case OutputHandlerCsv::subseq1:
+			stringCols[c].add( rna1.asString().substr(i1, j1-i1+1) );
+			break;
+
+		case OutputHandlerCsv::subseq2:
+			stringCols[c].add( rna2.asString().substr(j2, i2-j2+1) );
+			break;
+
+		case OutputHandlerCsv::subseqDP:
+			stringCols[c].add( rna1.asString().substr(i1, j1-i1+1)
+					+'&'
+					+rna2.asString().substr(j2, i2-j2+1) );
+			break;
+
+		case OutputHandlerCsv::subseqDB:
+			stringCols[c].add( toString(i1+1)
+					+rna1.asString().substr(i1, j1-i1+1)
+					+'&'
+					+toString(j2+1)
+					+rna2.asString().substr(j2, i2-j2+1) );
+			break;
+
+		case OutputHandlerCsv::start1:
+			intCols[c].push_back( (int32_t)(i1+1) );
+			break;
+
+		case OutputHandlerCsv::end1:
+			intCols[c].push_back( (int32_t)(j1+1) );
+			break;
+
+		case OutputHandlerCsv::start2:
+			intCols[c].push_back( (int32_t)(j2+1) );
+			break;
+
+		case OutputHandlerCsv::end2:
+			intCols[c].push_back( (int32_t)(i2+1) );
+			break;
+
+		case OutputHandlerCsv::hybridDP:
+			stringCols[c].add( Interaction::dotBracket( i ) );
+			break;
+
+		case OutputHandlerCsv::hybridDB:
+			stringCols[c].add( Interaction::dotBar( i ) );
+			break;
+
+		case OutputHandlerCsv::E:
+			floatCols[c].push_back( i.energy );
+			break;
+
+		case OutputHandlerCsv::ED1:
+			floatCols[c].push_back( contr.ED1 );
+			break;
+
+		case OutputHandlerCsv::ED2:
+			floatCols[c].push_back( contr.ED2 );
+			break;
+
+		case OutputHandlerCsv::Pu1:
+			floatCols[c].push_back( std::exp( - contr.ED1 / energy.getRT() ) );
+			break;
+
+		case OutputHandlerCsv::Pu2:
+			floatCols[c].push_back( std::exp( - contr.ED2 / energy.getRT() ) );
+			break;
+
+		case OutputHandlerCsv::E_init:
+			floatCols[c].push_back( contr.init );
+			break;
+
+		case OutputHandlerCsv::E_loops:
+			floatCols[c].push_back( contr.loops );
+			break;
+
+		case OutputHandlerCsv::E_dangleL:
+			floatCols[c].push_back( contr.dangleLeft );
+			break;
+
+		case OutputHandlerCsv::E_dangleR:
+			floatCols[c].push_back( contr.dangleRight );
+			break;
+
+		case OutputHandlerCsv::E_endL:
+			floatCols[c].push_back( contr.endLeft );
+			break;
+
+		case OutputHandlerCsv::E_endR:
+			floatCols[c].push_back( contr.endRight );
+			break;
+
+		case OutputHandlerCsv::E_hybrid:
+			floatCols[c].push_back( i.energy - contr.ED1 - contr.ED2 );
+			break;
+
+		case OutputHandlerCsv::E_norm:
+			floatCols[c].push_back( i.energy / std::log( energy.size1() * energy.size2() ) );
+			break;
+
+		case OutputHandlerCsv::E_hybridNorm:
+			floatCols[c].push_back( (i.energy - contr.ED1 - contr.ED2) / std::log( energy.size1() * energy.size2() ) );
+			break;
+
+		case OutputHandlerCsv::seedStart1:
+			intCols[c].push_back( i.seed == NULL ? 0 : (int32_t)(i.seed->bp_i.first+1) );
+			break;
+
+		case OutputHandlerCsv::seedEnd1:
+			intCols[c].push_back( i.seed == NULL ? 0 : (int32_t)(i.seed->bp_j.first+1) );
+			break;
+
+		case OutputHandlerCsv::seedStart2:
+			intCols[c].push_back( i.seed == NULL ? 0 : (int32_t)(i.seed->bp_j.second+1) );
+			break;
+
+		case OutputHandlerCsv::seedEnd2:
+			intCols[c].push_back( i.seed == NULL ? 0 : (int32_t)(i.seed->bp_i.second+1) );
+			break;
+
+		case OutputHandlerCsv::seedE:
+			floatCols[c].push_back( i.seed == NULL ? NaN : i.seed->energy );
+			break;
+
+		case OutputHandlerCsv::seedED1:
+			floatCols[c].push_back( i.seed == NULL ? NaN
+					: energy.getED1( i.seed->bp_i.first, i.seed->bp_j.first ) );
+			break;
+
+		case OutputHandlerCsv::seedED2:
+			floatCols[c].push_back( i.seed == NULL ? NaN
+					: energy.getAccessibility2().getAccessibilityOrigin().getED( i.seed->bp_j.second, i.seed->bp_i.second ) );
+			break;
+
+		case OutputHandlerCsv::seedPu1:
+			floatCols[c].push_back( i.seed == NULL ? NaN
+					: std::exp( - energy.getED1( i.seed->bp_i.first, i.seed->bp_j.first ) / energy.getRT() ) );
+			break;
+
+		case OutputHandlerCsv::seedPu2:
+			floatCols[c].push_back( i.seed == NULL ? NaN
+					: std::exp( - energy.getAccessibility2().getAccessibilityOrigin().getED( i.seed->bp_j.second, i.seed->bp_i.second ) / energy.getRT() ) );
+			break;
+
+		default : throw std::runtime_error("OutputHandlerBinary::add() : unhandled ColType '"+OutputHandlerCsv::list2string( ColTypeList(1,colOrder[c]) )+"'");
+		}
+	}
+	rows++;
+	reportedInteractions++;
+
+	// write batch if full
+	if (rows >= maxBatchRows) {
+		writeBatch();
+	}
+	} // omp critical(intarna_omp_outputHandlerBinary)
+
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void
+OutputHandlerBinary::
+writeBatch()
+{
+	// check if anything to write
+	if (rows == 0) {
+		return;
+	}
+
+	// generate batch
+	std::stringstream batch;
+	writeBinary( batch, batchMarker );
+	writeBinary( batch, (uint32_t)rows );
+	for (size_t c=0; c<colOrder.size(); c++) {
+		switch( getValueType( colOrder[c] ) ) {
+		case INT32 :
+			writeBinary( batch, intCols[c] );
+			intCols[c].clear();
+			break;
+		case FLOAT32 :
+			writeBinary( batch, floatCols[c] );
+			floatCols[c].clear();
+			break;
+		case DICT_STRING :
+			writeBinary( batch, (uint32_t)stringCols[c].dict.size() );
+			for (auto s = stringCols[c].dict.begin(); s != stringCols[c].dict.end(); s++) {
+				writeBinaryString( batch, *s );
+			}
+			writeBinary( batch, stringCols[c].rows );
+			stringCols[c].clear();
+			break;
+		}
+	}
+	rows = 0;
+
+	// ensure outputs do not intervene
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_outputStreamUpdate)
+#endif
+	{
+		out << batch.str();
+	} // omp critical(intarna_omp_outputStreamUpdate)
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void
+OutputHandlerBinary::DictColumn::
+add( const std::string & value )
+{
+	auto entry = index.find( value );
+	if (entry == index.end()) {
+		entry = index.insert( std::make_pair( value, (uint32_t)dict.size() ) ).first;
+		dict.push_back( value );
+	}
+	rows.push_back( entry->second );
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void
+OutputHandlerBinary::DictColumn::
+clear()
+{
+	index.clear();
+	dict.clear();
+	rows.clear();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+} // namespace
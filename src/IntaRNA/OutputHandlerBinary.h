@@ -0,0 +1,219 @@
+
+#ifndef INTARNA_OUTPUTHANDLERBINARY_H_
+#define INTARNA_OUTPUTHANDLERBINARY_H_
+
+#include "IntaRNA/general.h"
+
+#include "IntaRNA/OutputHandler.h"
+#include "IntaRNA/OutputHandlerCsv.h"
+#include "IntaRNA/InteractionEnergy.h"
+
+#include <cstdint>
+#include <vector>
+
+#include <boost/unordered_map.hpp>
+
+namespace IntaRNA {
+
+/**
+ * OutputHandler that stores interactions in a typed columnar binary format
+ * to be loaded without text parsing (e.g. into numpy/pandas/Arrow arrays).
+ * The columns are the same as for OutputHandlerCsv (see
+ * OutputHandlerCsv::string2list()).
+ *
+ * The output consists of a header (written once via getHeader()) followed
+ * by record batches. All integers are unsigned 32 bit and all values are
+ * stored in host byte order, which is given by the byte order mark of the
+ * header:
+ *
+ *   header :
+ *     char[8]   "IntaRNAB"
+ *     uint32    byte order mark 0x01020304
+ *     uint32    format version (1)
+ *     uint32    number of columns C
+ *     C times   column : uint8 value type, uint32 name length, name chars
+ *
+ *   record batch :
+ *     uint32    batch marker 0x48435442 ("BTCH" in little endian)
+ *     uint32    number of rows R
+ *     C times   column data in header order (depending on value type) :
+ *       INT32       : R x int32 (1-based positions; 0 if not available)
+ *       FLOAT32     : R x float32 (NaN if not available)
+ *       DICT_STRING : uint32 dictionary size D,
+ *                     D times ( uint32 length, chars ),
+ *                     R x uint32 dictionary index
+ *
+ * The dictionary of a string column is valid only within its batch.
+ * Batches are written when the handler is destructed (i.e. one batch per
+ * query-target combination or region) or when maxBatchRows rows are
+ * buffered.
+ *
+ */
+class OutputHandlerBinary : public OutputHandler
+{
+
+public:
+
+	//! value types of the columns
+	enum ValueType {
+		INT32 = 1, //!< 32 bit signed integers
+		FLOAT32 = 2, //!< 32 bit floating point values
+		DICT_STRING = 3 //!< dictionary encoded strings
+	};
+
+	//! the column types supported
+	typedef OutputHandlerCsv::ColType ColType;
+
+	//! list of ColTypes
+	typedef OutputHandlerCsv::ColTypeList ColTypeList;
+
+	//! format version written to the header
+	static const uint32_t formatVersion;
+
+	//! byte order mark written to the header
+	static const uint32_t byteOrderMark;
+
+	//! marker at the beginning of each record batch
+	static const uint32_t batchMarker;
+
+	//! default maximal number of rows per record batch
+	static const size_t defaultMaxBatchRows;
+
+public:
+
+	/**
+	 * Construct a binary columnar output handler for interaction reporting.
+	 *
+	 * @param out the stream to write to
+	 * @param energy the interaction energy object used for computation
+	 * @param colOrder the order and list of columns to be stored
+	 * @param maxBatchRows the maximal number of rows per record batch
+	 */
+	OutputHandlerBinary( std::ostream & out
+						, const InteractionEnergy & energy
+						, const ColTypeList colOrder
+						, const size_t maxBatchRows = defaultMaxBatchRows
+						);
+
+	/**
+	 * destruction; writes all buffered rows
+	 */
+	virtual ~OutputHandlerBinary();
+
+	/**
+	 * Buffers a given RNA-RNA interaction as a row of the next record batch.
+	 *
+	 * @param interaction the interaction to output
+	 */
+	virtual
+	void
+	add( const Interaction & interaction );
+
+	/**
+	 * Handles a given RNA-RNA interaction range as a
+	 * RNA-RNA interaction with two base pairs.
+	 *
+	 * @param range the interaction range to add
+	 */
+	virtual
+	void
+	add( const InteractionRange & range );
+
+	/**
+	 * Provides the value type of the given column type
+	 * @param col the column type of interest
+	 * @return the according value type
+	 */
+	static
+	ValueType
+	getValueType( const ColType col );
+
+	/**
+	 * Generates the binary header for a given list of columns
+	 * @param colTypes the list of column types to consider
+	 * @return the header of the binary output
+	 */
+	static
+	std::string
+	getHeader( const ColTypeList & colTypes );
+
+protected:
+
+	/**
+	 * Buffered data of a dictionary encoded string column
+	 */
+	class DictColumn {
+	public:
+		//! dictionary index of each string
+		boost::unordered_map< std::string, uint32_t > index;
+		//! the strings in order of their index
+		std::vector< std::string > dict;
+		//! the dictionary index of each row
+		std::vector< uint32_t > rows;
+		/**
+		 * Appends a row with the given value
+		 * @param value the value to add
+		 */
+		void add( const std::string & value );
+		/**
+		 * Removes all rows and the dictionary
+		 */
+		void clear();
+	};
+
+	//! the output stream to write to
+	std::ostream & out;
+
+	//! the interaction energy function used for interaction computation
+	const InteractionEnergy & energy;
+
+	//! the sequence of columns to be reported
+	const std::vector< ColType > colOrder;
+
+	//! whether or not all energy contributions are needed by any column
+	const bool needContributions;
+
+	//! whether or not the accessibility contributions are needed by any column
+	const bool needEDs;
+
+	//! the maximal number of rows per record batch
+	const size_t maxBatchRows;
+
+	//! the number of buffered rows
+	size_t rows;
+
+	//! buffered values of the INT32 columns (indexed by column position)
+	std::vector< std::vector<int32_t> > intCols;
+
+	//! buffered values of the FLOAT32 columns (indexed by column position)
+	std::vector< std::vector<float> > floatCols;
+
+	//! buffered values of the DICT_STRING columns (indexed by column position)
+	std::vector< DictColumn > stringCols;
+
+	/**
+	 * Writes all buffered rows as a record batch to the output stream and
+	 * clears the buffers.
+	 */
+	void
+	writeBatch();
+
+};
+
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+void
+OutputHandlerBinary::
+add( const InteractionRange & range )
+{
+	// forward to interaction reporting
+	add( Interaction(range) );
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_OUTPUTHANDLERBINARY_H_ */
@@ -5,6 +5,10 @@
 	#include <omp.h>
 #endif
 
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
 #include <boost/algorithm/string.hpp>
 
 namespace IntaRNA {
@@ -26,6 +30,13 @@ OutputHandlerCsv::OutputHandlerCsv(
 	, energy(energy)
 	, colOrder(colOrder)
 	, colSep(colSep)
+	, colSequence(colOrder.begin(), colOrder.end())
+	, needContributions(needsContributions(colOrder))
+	, needEDs(needsEDs(colOrder))
+	// ensure no colSeps are contained
+	, id1sanitized(boost::replace_all_copy(energy.getAccessibility1().getSequence().getId(), colSep, "_"))
+	, id2sanitized(boost::replace_all_copy(energy.getAccessibility2().getSequence().getId(), colSep, "_"))
+	, row()
 {
 	// init mapping of coltypes to string
 	initColType2string();
@@ -79,225 +90,304 @@ add( const Interaction & i )
 	const size_t i2 = i.basePairs.begin()->second;
 	const size_t j2 = i.basePairs.rbegin()->second;
 
-	// get individual energy contributions
-	InteractionEnergy::EnergyContributions contr = energy.getE_contributions(i);
+	// get individual energy contributions if needed
+	InteractionEnergy::EnergyContributions contr;
+	if (needContributions) {
+		contr = energy.getE_contributions(i);
+	} else if (needEDs) {
+		contr = energy.getED_contributions(i);
+	}
 
-	// ensure outputs do not intervene
-	{
-		std::stringstream outTmp;
+	const std::string & seq1str = energy.getAccessibility1().getSequence().asString();
+	const std::string & seq2str = energy.getAccessibility2().getAccessibilityOrigin().getSequence().asString();
+	const E_type NaN = std::numeric_limits<E_type>::signaling_NaN();
+
+	// compile row
+	row.clear();
+	for (auto col = colSequence.begin(); col != colSequence.end(); col++) {
+		// print separator if needed
+		if (col != colSequence.begin()) {
+			row.append( colSep );
+		}
+		// print this column information
+		switch ( *col ) {
+
+		case id1:
+			row.append( id1sanitized );
+			break;
+
+		case id2:
+			row.append( id2sanitized );
+			break;
+
+		case seq1:
+			row.append( seq1str );
+			break;
+
+		case seq2:
+			row.append( seq2str );
+			break;
+
+		case subseq1:
+			row.append( seq1str, i1, j1-i1+1 );
+			break;
+
+		case subseq2:
+			row.append( seq2str, j2, i2-j2+1 );
+			break;
+
+		case subseqDP:
+			row.append( seq1str, i1, j1-i1+1 );
+			row.push_back( '&' );
+			row.append( seq2str, j2, i2-j2+1 );
+			break;
+
+		case subseqDB:
+			append( row, i1+1 );
+			row.append( seq1str, i1, j1-i1+1 );
+			row.push_back( '&' );
+			append( row, j2+1 );
+			row.append( seq2str, j2, i2-j2+1 );
+			break;
+
+		case start1:
+			append( row, i1+1 );
+			break;
+
+		case end1:
+			append( row, j1+1 );
+			break;
+
+		case start2:
+			append( row, j2+1 );
+			break;
+
+		case end2:
+			append( row, i2+1 );
+			break;
+
+		case hybridDP:
+			row.append( Interaction::dotBracket( i ) );
+			break;
+
+		case hybridDB:
+			row.append( Interaction::dotBar( i ) );
+			break;
+
+		case E:
+			append( row, i.energy );
+			break;
+
+		case ED1:
+			append( row, contr.ED1 );
+			break;
+
+		case ED2:
+			append( row, contr.ED2 );
+			break;
+
+		case Pu1:
+			append( row, std::exp( - contr.ED1 / energy.getRT() ) );
+			break;
+
+		case Pu2:
+			append( row, std::exp( - contr.ED2 / energy.getRT() ) );
+			break;
+
+		case E_init:
+			append( row, contr.init );
+			break;
+
+		case E_loops:
+			append( row, contr.loops );
+			break;
+
+		case E_dangleL:
+			append( row, contr.dangleLeft );
+			break;
+
+		case E_dangleR:
+			append( row, contr.dangleRight );
+			break;
+
+		case E_endL:
+			append( row, contr.endLeft );
+			break;
+
+		case E_endR:
+			append( row, contr.endRight );
+			break;
+
+		case E_hybrid:
+			append( row, (i.energy - contr.ED1 - contr.ED2) );
+			break;
+
+		case E_norm:
+			append( row, (i.energy / std::log( energy.size1() * energy.size2() ) ) );
+			break;
+
+		case E_hybridNorm:
+			append( row, ( (i.energy - contr.ED1 - contr.ED2) / std::log( energy.size1() * energy.size2() ) ) );
+			break;
+
+		case seedStart1:
+			if (i.seed == NULL) {
+				append( row, NaN );
+			} else {
+				append( row, i.seed->bp_i.first+1 );
+			}
+			break;
+
+		case seedEnd1:
+			if (i.seed == NULL) {
+				append( row, NaN );
+			} else {
+				append( row, i.seed->bp_j.first+1 );
+			}
+			break;
+
+		case seedStart2:
+			if (i.seed == NULL) {
+				append( row, NaN );
+			} else {
+				append( row, i.seed->bp_j.second+1 );
+			}
+			break;
+
+		case seedEnd2:
+			if (i.seed == NULL) {
+				append( row, NaN );
+			} else {
+				append( row, i.seed->bp_i.second+1 );
+			}
+			break;
+
+		case seedE:
+			if (i.seed == NULL) {
+				append( row, NaN );
+			} else {
+				append( row, i.seed->energy );
+			}
+			break;
 
-		for (auto col = colOrder.begin(); col != colOrder.end(); col++) {
-			// print separator if needed
-			if (col != colOrder.begin()) {
-				outTmp <<colSep;
+		case seedED1:
+			if (i.seed == NULL) {
+				append( row, NaN );
+			} else {
+				append( row, energy.getED1( i.seed->bp_i.first, i.seed->bp_j.first ) );
 			}
-			// print this column information
-			switch ( *col ) {
-
-			case id1:
-				// ensure no colSeps are contained
-				outTmp <<boost::replace_all_copy(energy.getAccessibility1().getSequence().getId(), colSep, "_");
-				break;
-
-			case id2:
-				// ensure no colSeps are contained
-				outTmp <<boost::replace_all_copy(energy.getAccessibility2().getSequence().getId(), colSep, "_");
-				break;
-
-			case seq1:
-				outTmp <<energy.getAccessibility1().getSequence().asString();
-				break;
-
-			case seq2:
-				outTmp <<energy.getAccessibility2().getAccessibilityOrigin().getSequence().asString();
-				break;
-
-			case subseq1:
-				outTmp <<energy.getAccessibility1().getSequence().asString().substr(i1, j1-i1+1);
-				break;
-
-			case subseq2:
-				outTmp <<energy.getAccessibility2().getAccessibilityOrigin().getSequence().asString().substr(j2, i2-j2+1);
-				break;
-
-			case subseqDP:
-				outTmp <<energy.getAccessibility1().getSequence().asString().substr(i1, j1-i1+1)
-					<<'&'
-					<<energy.getAccessibility2().getAccessibilityOrigin().getSequence().asString().substr(j2, i2-j2+1);
-				break;
-
-			case subseqDB:
-				outTmp <<(i1+1)
-					<<energy.getAccessibility1().getSequence().asString().substr(i1, j1-i1+1)
-					<<'&'
-					<<(j2+1)
-					<<energy.getAccessibility2().getAccessibilityOrigin().getSequence().asString().substr(j2, i2-j2+1);
-				break;
-
-			case start1:
-				outTmp <<(i1+1);
-				break;
-
-			case end1:
-				outTmp <<(j1+1);
-				break;
-
-			case start2:
-				outTmp <<(j2+1);
-				break;
-
-			case end2:
-				outTmp <<(i2+1);
-				break;
-
-			case hybridDP:
-				outTmp <<Interaction::dotBracket( i );
-				break;
-
-			case hybridDB:
-				outTmp <<Interaction::dotBar( i );
-				break;
-
-			case E:
-				outTmp <<i.energy;
-				break;
-
-			case ED1:
-				outTmp <<contr.ED1;
-				break;
-
-			case ED2:
-				outTmp <<contr.ED2;
-				break;
-
-			case Pu1:
-				outTmp <<std::exp( - contr.ED1 / energy.getRT() );
-				break;
-
-			case Pu2:
-				outTmp <<std::exp( - contr.ED2 / energy.getRT() );
-				break;
-
-			case E_init:
-				outTmp <<contr.init;
-				break;
-
-			case E_loops:
-				outTmp <<contr.loops;
-				break;
-
-			case E_dangleL:
-				outTmp <<contr.dangleLeft;
-				break;
-
-			case E_dangleR:
-				outTmp <<contr.dangleRight;
-				break;
-
-			case E_endL:
-				outTmp <<contr.endLeft;
-				break;
-
-			case E_endR:
-				outTmp <<contr.endRight;
-				break;
-
-			case E_hybrid:
-				outTmp <<(i.energy - contr.ED1 - contr.ED2);
-				break;
-
-			case E_norm:
-				outTmp <<(i.energy / std::log( energy.size1() * energy.size2() ) );
-				break;
-
-			case E_hybridNorm:
-				outTmp <<( (i.energy - contr.ED1 - contr.ED2) / std::log( energy.size1() * energy.size2() ) );
-				break;
-
-			case seedStart1:
-				if (i.seed == NULL) {
-					outTmp <<std::numeric_limits<E_type>::signaling_NaN();
-				} else {
-					outTmp <<(i.seed->bp_i.first+1);
-				}
-				break;
-
-			case seedEnd1:
-				if (i.seed == NULL) {
-					outTmp <<std::numeric_limits<E_type>::signaling_NaN();
-				} else {
-					outTmp <<(i.seed->bp_j.first+1);
-				}
-				break;
-
-			case seedStart2:
-				if (i.seed == NULL) {
-					outTmp <<std::numeric_limits<E_type>::signaling_NaN();
-				} else {
-					outTmp <<(i.seed->bp_j.second+1);
-				}
-				break;
-
-			case seedEnd2:
-				if (i.seed == NULL) {
-					outTmp <<std::numeric_limits<E_type>::signaling_NaN();
-				} else {
-					outTmp <<(i.seed->bp_i.second+1);
-				}
-				break;
-
-			case seedE:
-				if (i.seed == NULL) {
-					outTmp <<std::numeric_limits<E_type>::signaling_NaN();
-				} else {
-					outTmp <<i.seed->energy;
-				}
-				break;
-
-			case seedED1:
-				if (i.seed == NULL) {
-					outTmp <<std::numeric_limits<E_type>::signaling_NaN();
-				} else {
-					outTmp <<energy.getED1( i.seed->bp_i.first, i.seed->bp_j.first );
-				}
-				break;
-
-			case seedED2:
-				if (i.seed == NULL) {
-					outTmp <<std::numeric_limits<E_type>::signaling_NaN();
-				} else {
-					outTmp <<energy.getAccessibility2().getAccessibilityOrigin().getED( i.seed->bp_j.second, i.seed->bp_i.second );
-				}
-				break;
-
-			case seedPu1:
-				if (i.seed == NULL) {
-					outTmp <<std::numeric_limits<E_type>::signaling_NaN();
-				} else {
-					outTmp <<std::exp( - energy.getED1( i.seed->bp_i.first, i.seed->bp_j.first ) / energy.getRT() );
-				}
-				break;
-
-			case seedPu2:
-				if (i.seed == NULL) {
-					outTmp <<std::numeric_limits<E_type>::signaling_NaN();
-				} else {
-					outTmp <<std::exp( - energy.getAccessibility2().getAccessibilityOrigin().getED( i.seed->bp_j.second, i.seed->bp_i.second ) / energy.getRT() );
-				}
-				break;
-
-			default : throw std::runtime_error("OutputHandlerCsv::add() : unhandled ColType '"+colType2string[*col]+"'");
+			break;
+
+		case seedED2:
+			if (i.seed == NULL) {
+				append( row, NaN );
+			} else {
+				append( row, energy.getAccessibility2().getAccessibilityOrigin().getED( i.seed->bp_j.second, i.seed->bp_i.second ) );
+			}
+			break;
+
+		case seedPu1:
+			if (i.seed == NULL) {
+				append( row, NaN );
+			} else {
+				append( row, std::exp( - energy.getED1( i.seed->bp_i.first, i.seed->bp_j.first ) / energy.getRT() ) );
+			}
+			break;
+
+		case seedPu2:
+			if (i.seed == NULL) {
+				append( row, NaN );
+			} else {
+				append( row, std::exp( - energy.getAccessibility2().getAccessibilityOrigin().getED( i.seed->bp_j.second, i.seed->bp_i.second ) / energy.getRT() ) );
 			}
+			break;
+
+		default : throw std::runtime_error("OutputHandlerCsv::add() : unhandled ColType '"+colType2string[*col]+"'");
 		}
-		outTmp <<'\n';
-	#if INTARNA_MULITHREADING
-		#pragma omp critical(intarna_omp_outputStreamUpdate)
-	#endif
-		{
-			out << outTmp.str();
-		} // omp critical(intarna_omp_outputStreamUpdate)
 	}
+	row.push_back( '\n' );
 
+	// ensure outputs do not intervene
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_outputStreamUpdate)
+#endif
+	{
+		out.write( row.c_str(), row.size() );
+	} // omp critical(intarna_omp_outputStreamUpdate)
+
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void
+OutputHandlerCsv::
+append( std::string & str, const double value )
+{
+	// same format as default stream output (precision 6)
+	char buffer[32];
+	const int length = std::snprintf( buffer, sizeof(buffer), "%g", value );
+	str.append( buffer, length );
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void
+OutputHandlerCsv::
+append( std::string & str, const size_t value )
+{
+	// print digits in reversed order
+	char buffer[24];
+	size_t pos = sizeof(buffer);
+	size_t rest = value;
+	do {
+		buffer[--pos] = (char)('0' + (rest % 10));
+		rest /= 10;
+	} while (rest > 0);
+	str.append( buffer+pos, sizeof(buffer)-pos );
+}
+
+////////////////////////////////////////////////////////////////////////
+
+bool
+OutputHandlerCsv::
+needsContributions( const ColTypeList & colTypes )
+{
+	for (auto col = colTypes.begin(); col != colTypes.end(); col++) {
+		switch (*col) {
+		case E_init :
+		case E_loops :
+		case E_dangleL :
+		case E_dangleR :
+		case E_endL :
+		case E_endR :
+			return true;
+		default :
+			break;
+		}
+	}
+	return false;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+bool
+OutputHandlerCsv::
+needsEDs( const ColTypeList & colTypes )
+{
+	for (auto col = colTypes.begin(); col != colTypes.end(); col++) {
+		switch (*col) {
+		case ED1 :
+		case ED2 :
+		case Pu1 :
+		case Pu2 :
+		case E_hybrid :
+		case E_hybridNorm :
+			return true;
+		default :
+			break;
+		}
+	}
+	return false;
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -9,6 +9,7 @@
 
 #include <list>
 #include <map>
+#include <vector>
 
 #include <boost/algorithm/string.hpp>
 
@@ -209,6 +210,26 @@ public:
 	std::string
 	getHeader( const ColTypeList & colTypes, const std::string& colSep = ";" );
 
+	/**
+	 * Checks whether or not any column of the list needs the energy
+	 * contributions of an interaction
+	 * @param colTypes the list of columns
+	 * @return true if InteractionEnergy::getE_contributions() is needed
+	 */
+	static
+	bool
+	needsContributions( const ColTypeList & colTypes );
+
+	/**
+	 * Checks whether or not any column of the list needs the accessibility
+	 * contributions (ED1, ED2) of an interaction
+	 * @param colTypes the list of columns
+	 * @return true if InteractionEnergy::getED_contributions() is needed
+	 */
+	static
+	bool
+	needsEDs( const ColTypeList & colTypes );
+
 protected:
 
 	//! the output stream to write to
@@ -223,7 +244,43 @@ protected:
 	//! the column separator to be used
 	std::string colSep;
 
+	//! the columns to be reported in order (for fast iteration)
+	const std::vector< ColType > colSequence;
+
+	//! whether or not energy contributions are needed by any column
+	const bool needContributions;
+
+	//! whether or not the accessibility contributions (ED1, ED2) are needed
+	//! by any column (computed independently of the other contributions)
+	const bool needEDs;
+
+	//! id of seq1 without colSep occurrences
+	const std::string id1sanitized;
 
+	//! id of seq2 without colSep occurrences
+	const std::string id2sanitized;
+
+	//! buffer to compile a row (reused for all rows)
+	std::string row;
+
+	/**
+	 * Appends the CSV representation of an energy-like value to a string
+	 * (same format as stream output with default precision).
+	 * @param str the string to append to
+	 * @param value the value to append
+	 */
+	static
+	void
+	append( std::string & str, const double value );
+
+	/**
+	 * Appends the decimal representation of a position to a string.
+	 * @param str the string to append to
+	 * @param value the value to append
+	 */
+	static
+	void
+	append( std::string & str, const size_t value );
 
 };
 
@@ -204,8 +204,8 @@ add( const Interaction & i )
 			;
 
 		if (detailedOutput) {
-			// get individual energy contributions
-			InteractionEnergy::EnergyContributions contr = energy.getE_contributions(i);
+			// get accessibility contributions (the only ones reported)
+			InteractionEnergy::EnergyContributions contr = energy.getED_contributions(i);
 				// print interaction details
 			outTmp	<<'\n'
 				<<"positions(target)     : "<<(i.basePairs.begin()->first +1)<<" -- "<<(i.basePairs.rbegin()->first +1) <<'\n'
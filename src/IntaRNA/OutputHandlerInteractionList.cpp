@@ -2,6 +2,7 @@
 #include "OutputHandlerInteractionList.h"
 
 #include <algorithm>
+#include <utility>
 
 namespace IntaRNA
 {
@@ -10,8 +11,13 @@ namespace IntaRNA
 
 OutputHandlerInteractionList::
 OutputHandlerInteractionList(const size_t maxToStore)
- :	storage()
+ :	compactStorage()
+	, storage()
+	, isSorted(true)
+	, toAdd()
 	, maxToStore(maxToStore)
+	, bestE(E_INF)
+	, storedKeys()
 {
 }
 
@@ -50,46 +56,127 @@ add( const Interaction & interaction )
 	{
 		// count interaction
 		reportedInteractions++;
-		if (storage.size() < maxToStore || lessThan_StorageContainer( &interaction, *(storage.rbegin()) )) {
-
-			// find where to insert this interaction
-			StorageContainer::iterator insertPos = std::lower_bound( storage.begin(), storage.end(), &interaction, lessThan_StorageContainer );
-
-			// check for duplicates
-			// lessThan_StorageContainer(*insertPos, &interaction) obsolete because of lower_bound
-			if (insertPos == storage.end() || lessThan_StorageContainer(&interaction, *insertPos)) {				
-				
-				bool isLastElement = false;
-				
-				// remove last element if needed
-				if (storage.size() >= maxToStore) {
-					
-					// check if insertPos points to the last element in the list which is about to get deleted -
-					// if this is the case, move the iterator one element backwards
-					if (insertPos == std::prev(storage.end())){
-						insertPos = std::prev(insertPos);
-						isLastElement = true;
+		// restore heap property if sorted by a previous access
+		if (isSorted) {
+			std::make_heap( compactStorage.begin(), compactStorage.end() );
+			isSorted = false;
+		}
+		// check if better than the worst stored (on top of heap)
+		if ( maxToStore > 0
+			&& (compactStorage.size() < maxToStore || InteractionCompact::isLess( interaction, compactStorage.front() )) )
+		{
+			// check if not a duplicate
+			const Key_type key = getKey( interaction );
+			toAdd.assign( interaction );
+			if ( ! isStored( toAdd, key ) ) {
+				if (compactStorage.size() < maxToStore) {
+					// add new element
+					compactStorage.push_back( toAdd );
+				} else {
+					// replace worst element (reusing its memory)
+					std::pop_heap( compactStorage.begin(), compactStorage.end() );
+					const auto evictedKey = storedKeys.find( getKey( compactStorage.back() ) );
+					if (evictedKey != storedKeys.end()) {
+						storedKeys.erase( evictedKey );
 					}
-					
-					// delete object
-					delete (*(storage.rbegin()));
-					// remove pointer
-					storage.resize(storage.size()-1);
+					std::swap( compactStorage.back(), toAdd );
 				}
-				
-				// if insertPos was moved backwards, move it back to it's former position (== storage.end())
-				if (isLastElement){
-					insertPos = std::next(insertPos);
+				storedKeys.insert( key );
+				std::push_heap( compactStorage.begin(), compactStorage.end() );
+				// update best energy
+				bestE = std::min( bestE, interaction.energy );
+			}
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool
+OutputHandlerInteractionList::
+isStored( const InteractionCompact & interaction, const Key_type key ) const
+{
+	// no stored interaction with the same key
+	if (storedKeys.find( key ) == storedKeys.end()) {
+		return false;
+	}
+	// compare with all stored interactions (rare hash collision check)
+	for (auto it = compactStorage.begin(); it != compactStorage.end(); it++) {
+		if ( E_equal( it->getEnergy(), interaction.getEnergy() )
+			&& it->hasSameBasePairs( interaction ) )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+OutputHandlerInteractionList::Key_type
+OutputHandlerInteractionList::
+getKey( const Interaction & interaction )
+{
+	return getKey( interaction.basePairs.begin(), interaction.basePairs.end() );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+OutputHandlerInteractionList::Key_type
+OutputHandlerInteractionList::
+getKey( const InteractionCompact & interaction )
+{
+	return getKey( interaction.begin(), interaction.end() );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void
+OutputHandlerInteractionList::
+sortStorage() const
+{
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_OutputHandlerInteractionListUpdate)
+#endif
+	{
+		if (!isSorted) {
+			// sort heap : best first
+			std::sort_heap( compactStorage.begin(), compactStorage.end() );
+			// release surplus expanded interactions
+			for (size_t i = compactStorage.size(); i < storage.size(); i++) {
+				delete storage.at(i);
+			}
+			storage.resize( std::min( storage.size(), compactStorage.size() ) );
+			// expand interactions (reusing the storage of previous expansions)
+			for (size_t i = 0; i < compactStorage.size(); i++) {
+				if (i == storage.size()) {
+					storage.push_back( new Interaction( *(compactStorage[i].getS1()), *(compactStorage[i].getS2()) ) );
 				}
-				
-				storage.insert( insertPos, new Interaction(interaction) );
+				compactStorage[i].expand( *(storage[i]) );
 			}
+			isSorted = true;
 		}
 	}
 }
 
 /////////////////////////////////////////////////////////////////////////////
 
+E_type
+OutputHandlerInteractionList::
+getBestE() const
+{
+	E_type curBestE = E_INF;
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_OutputHandlerInteractionListUpdate)
+#endif
+	{
+		curBestE = bestE;
+	}
+	return curBestE;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 void
 OutputHandlerInteractionList::
 add( const InteractionRange & range )
@@ -3,14 +3,32 @@
 #define OUTPUTHANDLERINTERACTIONLIST_H_
 
 #include "OutputHandler.h"
+#include "IntaRNA/InteractionCompact.h"
 
-#include <list>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/unordered_set.hpp>
 
 namespace IntaRNA
 {
 
 /**
- * OutputHandler that stores all reported interactions in a list
+ * OutputHandler that stores the maxToStore best (distinct) reported
+ * interactions.
+ *
+ * While adding, the interactions are kept in a bounded max-heap (worst
+ * interaction on top) such that non-competitive interactions are rejected
+ * in constant time and the storage of an evicted interaction is reused.
+ * The interactions are stored in the compact helix-run encoding of
+ * InteractionCompact and only expanded to explicit base pairs on first
+ * access via the iterators.
+ * Identical interactions (e.g. found by several overlapping windows) are
+ * rejected at insertion via a hash set of compact base pair keys, such that
+ * duplicates do not occupy any of the maxToStore slots.
+ * The interactions are sorted (best first) on first access via the
+ * iterators. Note, the expanded interactions accessed via the iterators are
+ * rebuilt if further interactions are added.
  *
  * NOTE: this handler does NOT support InteractionRange instances
  *
@@ -19,8 +37,14 @@ class OutputHandlerInteractionList: public OutputHandler
 {
 protected:
 
+	//! the container providing the expanded interactions
+	typedef std::vector<Interaction*> StorageContainer;
+
 	//! the container used internally for storing interactions
-	typedef std::list<Interaction*> StorageContainer;
+	typedef std::vector<InteractionCompact> CompactContainer;
+
+	//! type of the compact (hash) keys of stored interactions
+	typedef boost::uint64_t Key_type;
 
 public:
 
@@ -60,6 +84,15 @@ public:
 	//! @return true if no elements are stored
 	bool empty() const;
 
+	/**
+	 * Provides the energy of the best interaction stored so far. The access is
+	 * synchronized with add() such that it can be used as a bound for
+	 * concurrent predictions.
+	 *
+	 * @return the energy of the best stored interaction or E_INF if empty
+	 */
+	E_type getBestE() const;
+
 	//! constant iterator to first stored interaction or end() if empty
 	//! @return first stored interaction (pointer) or end() if empty
 	const_iterator begin() const;
@@ -81,17 +114,76 @@ protected:
 	//! counter of reported interactions
 	using OutputHandler::reportedInteractions;
 
-	//! container where interactions are stored
-	StorageContainer storage;
+	//! container where interactions are stored (max-heap or sorted)
+	mutable CompactContainer compactStorage;
+
+	//! the expanded interactions of compactStorage (valid only if sorted)
+	mutable StorageContainer storage;
+
+	//! whether or not compactStorage is sorted and expanded into storage
+	//! (otherwise it is a max-heap)
+	mutable bool isSorted;
+
+	//! encoding of the interaction to be added (storage reused among calls)
+	InteractionCompact toAdd;
 
 	//! number of elements to store within storage (only maxToStore best)
 	const size_t maxToStore;
 
-	//! 'less-than' comparison struct dereferencing storage pointer
+	//! energy of the best stored interaction
+	E_type bestE;
+
+	//! the keys of all stored interactions (see getKey())
+	boost::unordered_multiset< Key_type > storedKeys;
+
+	/**
+	 * Sorts the storage (best first) and expands the interactions if not
+	 * already done.
+	 */
+	void
+	sortStorage() const;
+
+	/**
+	 * Checks whether or not an identical interaction is already stored,
+	 * i.e. one with the same base pairs and energy. Only interactions with
+	 * the same key are compared.
+	 * @param interaction the interaction to check
+	 * @param key the key of the interaction (see getKey())
+	 * @return true if an identical interaction is stored
+	 */
+	bool
+	isStored( const InteractionCompact & interaction, const Key_type key ) const;
+
+	/**
+	 * Computes a compact hash key of the base pairs (and thus of the
+	 * boundaries i1,j1,i2,j2) of an interaction.
+	 * @param interaction the interaction of interest
+	 * @return the key of the interaction
+	 */
+	static
+	Key_type
+	getKey( const Interaction & interaction );
+
+	/**
+	 * Computes the compact hash key of an encoded interaction (see getKey())
+	 * @param interaction the interaction of interest
+	 * @return the key of the interaction
+	 */
 	static
-	bool lessThan_StorageContainer( const Interaction * const a
-			, const Interaction * const b )
-	    { return *a < *b; }
+	Key_type
+	getKey( const InteractionCompact & interaction );
+
+	/**
+	 * Computes the compact hash key of a sequence of base pairs
+	 * @param begin the first base pair
+	 * @param end the position after the last base pair
+	 * @return the key of the base pairs
+	 */
+	template < typename BasePairIterator >
+	static
+	Key_type
+	getKey( BasePairIterator begin, const BasePairIterator end );
+
 };
 
 ////////////////////////////////////////////////////////////////////////////
@@ -100,7 +192,7 @@ inline
 bool
 OutputHandlerInteractionList::
 empty() const {
-	return storage.empty();
+	return compactStorage.empty();
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -110,6 +202,7 @@ OutputHandlerInteractionList::
 const_iterator
 OutputHandlerInteractionList::
 begin() const {
+	sortStorage();
 	return storage.begin();
 }
 
@@ -120,6 +213,7 @@ OutputHandlerInteractionList::
 const_iterator
 OutputHandlerInteractionList::
 end() const {
+	sortStorage();
 	return storage.end();
 }
 
@@ -130,6 +224,7 @@ OutputHandlerInteractionList::
 iterator
 OutputHandlerInteractionList::
 begin() {
+	sortStorage();
 	return storage.begin();
 }
 
@@ -140,11 +235,29 @@ OutputHandlerInteractionList::
 iterator
 OutputHandlerInteractionList::
 end() {
+	sortStorage();
 	return storage.end();
 }
 
 ////////////////////////////////////////////////////////////////////////////
 
+template < typename BasePairIterator >
+inline
+OutputHandlerInteractionList::Key_type
+OutputHandlerInteractionList::
+getKey( BasePairIterator begin, const BasePairIterator end )
+{
+	// FNV-1a style combination of the base pair indices
+	Key_type key = 14695981039346656037ULL;
+	for (; begin != end; begin++) {
+		key = (key ^ (Key_type)begin->first) * 1099511628211ULL;
+		key = (key ^ (Key_type)begin->second) * 1099511628211ULL;
+	}
+	return key;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 ////////////////////////////////////////////////////////////////////////////
 
 ////////////////////////////////////////////////////////////////////////////
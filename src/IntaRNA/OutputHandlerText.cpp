@@ -259,9 +259,6 @@ add( const Interaction & i )
 		pos2tag	<<std::setw(interactionLength - 1) <<'|';
 	}
 
-	// get individual energy contributions
-	InteractionEnergy::EnergyContributions contr = energy.getE_contributions(i);
-
 	{
 		// ensure outputs do not intervene
 		std::stringstream outTmp;
@@ -301,6 +298,8 @@ add( const Interaction & i )
 			;
 
 		if (detailedOutput) {
+			// get individual energy contributions (detailed output only)
+			const InteractionEnergy::EnergyContributions contr = energy.getE_contributions(i);
 			outTmp
 				<<"  = E(init)        = "<<contr.init<<'\n'
 				<<"  + E(loops)       = "<<contr.loops<<'\n'
@@ -0,0 +1,132 @@
+
+#include "IntaRNA/OutputReorderBuffer.h"
+
+#if INTARNA_MULITHREADING
+	#include <omp.h>
+#endif
+
+namespace IntaRNA {
+
+////////////////////////////////////////////////////////////////////////////
+
+OutputReorderBuffer::
+OutputReorderBuffer( std::ostream & out
+					, const size_t maxPending
+					, const size_t firstIndex
+					, CheckpointJournal * journal )
+ :	out(out)
+	, maxPending(maxPending)
+	, nextIndex(firstIndex)
+	, pending()
+	, journal(journal)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+OutputReorderBuffer::
+~OutputReorderBuffer()
+{
+	// write all remaining chunks
+	flush();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+OutputReorderBuffer::
+add( const size_t index, const std::string & output )
+{
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_outputStreamUpdate)
+#endif
+	{
+		// check if no buffering is to be done or chunk is next in order
+		if (maxPending == 0 || index == nextIndex) {
+			write( index, output );
+			// update next index if in order
+			if (index == nextIndex) {
+				nextIndex++;
+			}
+		} else {
+			// store for later output
+			pending[index] = output;
+		}
+		// write all chunks in order now
+		writeInOrder();
+	} // omp critical(intarna_omp_outputStreamUpdate)
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+OutputReorderBuffer::
+addUnordered( const std::string & output )
+{
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_outputStreamUpdate)
+#endif
+	{
+		out <<output;
+		// make it available directly
+		out.flush();
+	} // omp critical(intarna_omp_outputStreamUpdate)
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+OutputReorderBuffer::
+write( const size_t index, const std::string & output )
+{
+	out <<output;
+	// record chunk once it is completely written
+	if (journal != NULL) {
+		out.flush();
+		const std::streampos outputSize = out.tellp();
+		if (outputSize >= 0) {
+			journal->add( index, (size_t)outputSize );
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+OutputReorderBuffer::
+writeInOrder()
+{
+	// write all chunks that are in order or exceed the buffer limit
+	while( !pending.empty()
+			&& (pending.begin()->first <= nextIndex || pending.size() > maxPending) )
+	{
+		write( pending.begin()->first, pending.begin()->second );
+		// update next index if not relaxed
+		nextIndex = std::max( nextIndex, pending.begin()->first+1 );
+		pending.erase(pending.begin());
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+OutputReorderBuffer::
+flush()
+{
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_outputStreamUpdate)
+#endif
+	{
+		// write all pending chunks in order
+		for (auto chunk = pending.begin(); chunk != pending.end(); chunk++) {
+			write( chunk->first, chunk->second );
+			nextIndex = std::max( nextIndex, chunk->first+1 );
+		}
+		pending.clear();
+		out.flush();
+	} // omp critical(intarna_omp_outputStreamUpdate)
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
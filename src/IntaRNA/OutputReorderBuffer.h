@@ -0,0 +1,158 @@
+
+#ifndef INTARNA_OUTPUTREORDERBUFFER_H_
+#define INTARNA_OUTPUTREORDERBUFFER_H_
+
+#include "IntaRNA/general.h"
+#include "IntaRNA/CheckpointJournal.h"
+
+#include <iostream>
+#include <string>
+#include <map>
+
+namespace IntaRNA {
+
+/**
+ * Collects (pre-formatted) output chunks that are generated in arbitrary
+ * order, e.g. by multiple threads, and writes them to a stream in the order
+ * of their indices. A chunk is written as soon as all chunks with lower
+ * index have been written.
+ *
+ * To bound the memory consumption, at most maxPending chunks are buffered.
+ * If this limit is exceeded, the chunk with the lowest index is written, even
+ * if chunks with lower index are still missing. These are written as soon as
+ * they are available, i.e. the output order is relaxed in this case.
+ *
+ * If a checkpoint journal is given, each written chunk is recorded along
+ * with the output size after writing it.
+ *
+ * All member functions are thread-safe.
+ *
+ */
+class OutputReorderBuffer {
+
+public:
+
+	/**
+	 * Construction
+	 *
+	 * @param out the stream to write the output chunks to
+	 * @param maxPending the maximal number of chunks to be buffered;
+	 *        if 0, all chunks are written directly in the order of addition
+	 * @param firstIndex the index of the first chunk to be written
+	 * @param journal if not NULL, each written chunk is recorded in this
+	 *        journal; the stream out has to support tellp() in this case
+	 */
+	OutputReorderBuffer( std::ostream & out
+						, const size_t maxPending
+						, const size_t firstIndex = 0
+						, CheckpointJournal * journal = NULL );
+
+	/**
+	 * Destruction, writes all pending chunks to the stream.
+	 */
+	virtual ~OutputReorderBuffer();
+
+	/**
+	 * Adds the output chunk for the given index. All chunks that are in
+	 * order afterwards are written to the stream.
+	 *
+	 * @param index the index of the chunk, which has to be unique
+	 * @param output the chunk to be written (might be empty)
+	 */
+	void
+	add( const size_t index, const std::string & output );
+
+	/**
+	 * Writes an output chunk directly to the stream, i.e. independently of
+	 * the chunk order (e.g. partial results of a chunk not finished yet).
+	 * The chunk is not recorded in the journal.
+	 *
+	 * @param output the chunk to be written
+	 */
+	void
+	addUnordered( const std::string & output );
+
+	/**
+	 * Writes all pending chunks in index order to the stream, independently
+	 * of missing chunks.
+	 */
+	void
+	flush();
+
+	/**
+	 * Access to the number of chunks currently buffered.
+	 * @return the number of pending chunks
+	 */
+	size_t
+	getPending() const;
+
+	/**
+	 * Access to the index of the next chunk to be written in order.
+	 * @return the index of the next chunk in order
+	 */
+	size_t
+	getNextIndex() const;
+
+protected:
+
+	//! the stream to write to
+	std::ostream & out;
+
+	//! maximal number of chunks to be buffered
+	const size_t maxPending;
+
+	//! index of the next chunk to be written
+	size_t nextIndex;
+
+	//! the buffered chunks not written yet, sorted by their index
+	std::map< size_t, std::string > pending;
+
+	//! the journal to record written chunks in or NULL
+	CheckpointJournal * journal;
+
+	/**
+	 * Writes a chunk and records it in the journal if present. Has to be
+	 * called within a critical section.
+	 *
+	 * @param index the index of the chunk
+	 * @param output the chunk to be written
+	 */
+	void
+	write( const size_t index, const std::string & output );
+
+	/**
+	 * Writes all pending chunks that are in order or that exceed the buffer
+	 * limit. Has to be called within a critical section.
+	 */
+	void
+	writeInOrder();
+
+};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+OutputReorderBuffer::
+getPending() const
+{
+	return pending.size();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+OutputReorderBuffer::
+getNextIndex() const
+{
+	return nextIndex;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_OUTPUTREORDERBUFFER_H_ */
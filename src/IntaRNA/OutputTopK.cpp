@@ -0,0 +1,121 @@
+
+#include "IntaRNA/OutputTopK.h"
+
+#include <algorithm>
+
+#if INTARNA_MULITHREADING
+	#include <omp.h>
+#endif
+
+namespace IntaRNA {
+
+////////////////////////////////////////////////////////////////////////////
+
+OutputTopK::
+OutputTopK( std::ostream & out
+			, const size_t maxToStore )
+ :	out(out)
+	, maxToStore(maxToStore)
+	, added(0)
+	, storage()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+OutputTopK::
+~OutputTopK()
+{
+	// write all stored outputs
+	flush();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+OutputTopK::
+isCompetitive( const E_type energy ) const
+{
+	// equal energies might be stored depending on the index
+	return maxToStore > 0 && !(getWorstE() < energy);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+OutputTopK::
+add( const E_type energy, const size_t index, const std::string & output )
+{
+	bool stored = false;
+	if (maxToStore == 0) {
+		return stored;
+	}
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_OutputTopKUpdate)
+#endif
+	{
+		Entry entry;
+		entry.energy = energy;
+		entry.index = index;
+		entry.added = added++;
+		if (storage.size() < maxToStore) {
+			// add new entry
+			entry.output = output;
+			storage.push_back( entry );
+			std::push_heap( storage.begin(), storage.end() );
+			stored = true;
+		} else if (entry < storage.front()) {
+			// replace worst entry (reusing its memory)
+			std::pop_heap( storage.begin(), storage.end() );
+			storage.back().energy = entry.energy;
+			storage.back().index = entry.index;
+			storage.back().added = entry.added;
+			storage.back().output.assign( output );
+			std::push_heap( storage.begin(), storage.end() );
+			stored = true;
+		}
+	} // omp critical(intarna_omp_OutputTopKUpdate)
+	return stored;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+E_type
+OutputTopK::
+getWorstE() const
+{
+	E_type worstE = E_INF;
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_OutputTopKUpdate)
+#endif
+	{
+		if (maxToStore > 0 && storage.size() == maxToStore) {
+			worstE = storage.front().energy;
+		}
+	} // omp critical(intarna_omp_OutputTopKUpdate)
+	return worstE;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+OutputTopK::
+flush()
+{
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_OutputTopKUpdate)
+#endif
+	{
+		// write all stored outputs by increasing energy
+		std::sort_heap( storage.begin(), storage.end() );
+		for (auto entry = storage.begin(); entry != storage.end(); entry++) {
+			out <<entry->output;
+		}
+		storage.clear();
+		out.flush();
+	} // omp critical(intarna_omp_OutputTopKUpdate)
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
@@ -0,0 +1,162 @@
+
+#ifndef INTARNA_OUTPUTTOPK_H_
+#define INTARNA_OUTPUTTOPK_H_
+
+#include "IntaRNA/general.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace IntaRNA {
+
+/**
+ * Collects the maxToStore best (pre-formatted) interaction outputs over all
+ * query-target combinations, e.g. generated by multiple threads, and writes
+ * them sorted by increasing energy to a stream once all are collected.
+ *
+ * The outputs are kept in a bounded max-heap (worst output on top), such
+ * that getWorstE() provides the energy an interaction has to beat to be
+ * stored once the container is full, which can be used as a pruning bound
+ * by the predictions still to be done.
+ *
+ * Outputs with equal energy are ordered by the given index and then by the
+ * order of their addition.
+ *
+ * All member functions are thread-safe.
+ *
+ */
+class OutputTopK {
+
+public:
+
+	/**
+	 * Construction
+	 *
+	 * @param out the stream to write the outputs to
+	 * @param maxToStore the number of best outputs to be stored
+	 */
+	OutputTopK( std::ostream & out
+				, const size_t maxToStore );
+
+	/**
+	 * Destruction, writes all stored outputs to the stream.
+	 */
+	virtual ~OutputTopK();
+
+	/**
+	 * Checks whether or not an interaction with the given energy would be
+	 * stored by add(), to avoid the formatting of non-competitive
+	 * interactions.
+	 *
+	 * @param energy the energy of the interaction
+	 * @return true if an interaction with this energy would be stored
+	 */
+	bool
+	isCompetitive( const E_type energy ) const;
+
+	/**
+	 * Adds the output of an interaction if it is among the best outputs
+	 * stored. If the container is full, the worst output is removed.
+	 *
+	 * @param energy the energy of the interaction
+	 * @param index the index of the query-target combination of the
+	 *        interaction (used for ordering outputs of equal energy)
+	 * @param output the formatted output of the interaction
+	 * @return true if the output was stored; false otherwise
+	 */
+	bool
+	add( const E_type energy, const size_t index, const std::string & output );
+
+	/**
+	 * Provides the energy of the worst stored output if the container is
+	 * full, i.e. the energy an interaction has to beat to be stored.
+	 * @return the worst energy stored or E_INF if not full yet
+	 */
+	E_type
+	getWorstE() const;
+
+	/**
+	 * Writes all stored outputs sorted by increasing energy to the stream
+	 * and clears the container.
+	 */
+	void
+	flush();
+
+	/**
+	 * Access to the number of outputs currently stored.
+	 * @return the number of stored outputs
+	 */
+	size_t
+	size() const;
+
+protected:
+
+	/**
+	 * A stored output along with its ordering information
+	 */
+	class Entry {
+	public:
+		//! energy of the interaction
+		E_type energy;
+		//! index of the query-target combination
+		size_t index;
+		//! number of outputs added before
+		size_t added;
+		//! the formatted output
+		std::string output;
+		/**
+		 * Ordering by energy, index and order of addition
+		 * @param e the entry to compare to
+		 * @return true if this entry is to be written before e
+		 */
+		bool operator<( const Entry & e ) const;
+	};
+
+	//! the stream to write to
+	std::ostream & out;
+
+	//! maximal number of outputs to be stored
+	const size_t maxToStore;
+
+	//! number of outputs added so far
+	size_t added;
+
+	//! the stored outputs (max-heap, worst on top)
+	std::vector< Entry > storage;
+
+};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+OutputTopK::Entry::
+operator<( const Entry & e ) const
+{
+	if (energy != e.energy) {
+		return energy < e.energy;
+	}
+	if (index != e.index) {
+		return index < e.index;
+	}
+	return added < e.added;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+OutputTopK::
+size() const
+{
+	return storage.size();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_OUTPUTTOPK_H_ */
@@ -0,0 +1,63 @@
+
+#include "IntaRNA/PairingMask.h"
+
+namespace IntaRNA {
+
+/////////////////////////////////////////////////////////////////////////////
+
+const size_t PairingMask::wordBits;
+
+/////////////////////////////////////////////////////////////////////////////
+
+PairingMask::
+PairingMask()
+ :	r1(0,0)
+	, r2(0,0)
+	, rowWords(1)
+	, bits(1,0)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void
+PairingMask::
+setup( const InteractionEnergy & energy
+		, const IndexRange & r1
+		, const IndexRange & r2
+		, const bool checkAccessibility )
+{
+	if (!r1.isAscending() || !r2.isAscending() || r1.to >= energy.size1() || r2.to >= energy.size2()) {
+		throw std::runtime_error("PairingMask::setup() : window "+toString(r1)+" x "+toString(r2)+" is out of range");
+	}
+
+	this->r1 = r1;
+	this->r2 = r2;
+	rowWords = (r2.to-r2.from+1 + wordBits-1) / wordBits;
+	bits.assign( (r1.to-r1.from+1)*rowWords, 0 );
+
+	// precompute accessibility of seq2
+	std::vector<bool> accessible2( r2.to-r2.from+1, true );
+	if (checkAccessibility) {
+		for (size_t i2=r2.from; i2<=r2.to; i2++) {
+			accessible2[i2-r2.from] = energy.isAccessible2(i2);
+		}
+	}
+
+	for (size_t i1=r1.from; i1<=r1.to; i1++) {
+		// skip blocked rows
+		if (checkAccessibility && !energy.isAccessible1(i1)) {
+			continue;
+		}
+		Word * row = &(bits[(i1-r1.from)*rowWords]);
+		for (size_t i2=r2.from; i2<=r2.to; i2++) {
+			if (accessible2[i2-r2.from] && energy.areComplementary(i1,i2)) {
+				row[(i2-r2.from)/wordBits] |= (Word)1 << ((i2-r2.from)%wordBits);
+			}
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+} // namespace
@@ -0,0 +1,239 @@
+
+#ifndef INTARNA_PAIRINGMASK_H_
+#define INTARNA_PAIRINGMASK_H_
+
+#include "IntaRNA/general.h"
+#include "IntaRNA/IndexRange.h"
+#include "IntaRNA/InteractionEnergy.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace IntaRNA {
+
+/**
+ * Bit-packed representation of all intermolecular base pairs (i1,i2) within
+ * a window r1 x r2 that can be formed, i.e. seq1(i1) and seq2(i2) are
+ * complementary and (optionally) both positions are accessible.
+ *
+ * The bits of each row i1 are stored within a contiguous block of machine
+ * words, which enables the enumeration of all pairing positions i2 of a row
+ * a word (64 positions) at a time instead of testing each cell individually.
+ *
+ * All indices are given in the index space of the energy handler used for
+ * setup.
+ *
+ */
+class PairingMask {
+
+public:
+
+	//! the type of the machine words storing the bits
+	typedef uint64_t Word;
+
+	//! the number of bits per machine word
+	static const size_t wordBits = 64;
+
+public:
+
+	/**
+	 * Construction of an empty mask
+	 */
+	PairingMask();
+
+	/**
+	 * Computes the mask for the given window.
+	 *
+	 * @param energy the energy handler that provides complementarity and
+	 *        accessibility information
+	 * @param r1 the (ascending) index range of seq1 to cover
+	 * @param r2 the (ascending) index range of seq2 to cover
+	 * @param checkAccessibility whether or not both positions have to be
+	 *        accessible (see InteractionEnergy::isAccessible1/2()) in
+	 *        addition to complementarity
+	 *
+	 * @throw std::runtime_error if the window exceeds the sequence lengths
+	 */
+	void
+	setup( const InteractionEnergy & energy
+			, const IndexRange & r1
+			, const IndexRange & r2
+			, const bool checkAccessibility );
+
+	/**
+	 * Checks whether or not (i1,i2) can form a base pair
+	 * @param i1 the index in seq1 (within r1)
+	 * @param i2 the index in seq2 (within r2)
+	 * @return true if the according bit is set; false otherwise
+	 */
+	bool
+	isPairing( const size_t i1, const size_t i2 ) const;
+
+	/**
+	 * Provides the smallest index i2' >= i2 such that (i1,i2') can form a
+	 * base pair.
+	 * @param i1 the index in seq1 (within r1)
+	 * @param i2 the first index in seq2 to consider
+	 * @return the according index or r2.to+1 if there is none
+	 */
+	size_t
+	getNextPairing( const size_t i1, const size_t i2 ) const;
+
+	/**
+	 * Provides the largest index i2' < i2end such that (i1,i2') can form a
+	 * base pair.
+	 * @param i1 the index in seq1 (within r1)
+	 * @param i2end the index in seq2 that bounds the search (exclusive)
+	 * @return the according index or RnaSequence::lastPos if there is none
+	 */
+	size_t
+	getPrevPairing( const size_t i1, const size_t i2end ) const;
+
+	/**
+	 * Access to the covered index range of seq1
+	 * @return the covered range
+	 */
+	const IndexRange &
+	getRange1() const;
+
+	/**
+	 * Access to the covered index range of seq2
+	 * @return the covered range
+	 */
+	const IndexRange &
+	getRange2() const;
+
+protected:
+
+	//! the covered index range of seq1
+	IndexRange r1;
+
+	//! the covered index range of seq2
+	IndexRange r2;
+
+	//! the number of words per row
+	size_t rowWords;
+
+	//! the bits of all rows (for each i1 in r1) in consecutive blocks
+	std::vector<Word> bits;
+
+	/**
+	 * Access to the first word of a row
+	 * @param i1 the index in seq1 (within r1)
+	 * @return the first word of the row
+	 */
+	const Word *
+	getRow( const size_t i1 ) const;
+
+};
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+inline
+const PairingMask::Word *
+PairingMask::
+getRow( const size_t i1 ) const
+{
+#if INTARNA_IN_DEBUG_MODE
+	if (i1 < r1.from || i1 > r1.to) {
+		throw std::runtime_error("PairingMask::getRow("+toString(i1)+") is out of range "+toString(r1));
+	}
+#endif
+	return &(bits[(i1-r1.from)*rowWords]);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+PairingMask::
+isPairing( const size_t i1, const size_t i2 ) const
+{
+#if INTARNA_IN_DEBUG_MODE
+	if (i2 < r2.from || i2 > r2.to) {
+		throw std::runtime_error("PairingMask::isPairing(i2="+toString(i2)+") is out of range "+toString(r2));
+	}
+#endif
+	const size_t k = i2-r2.from;
+	return (getRow(i1)[k/wordBits] >> (k%wordBits)) & (Word)1;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+PairingMask::
+getNextPairing( const size_t i1, const size_t i2 ) const
+{
+	if (i2 > r2.to) {
+		return r2.to+1;
+	}
+	const Word * row = getRow(i1);
+	const size_t k = (i2 < r2.from ? 0 : i2-r2.from);
+	size_t w = k/wordBits;
+	// mask all bits below k
+	Word cur = row[w] & (~((Word)0) << (k%wordBits));
+	while( cur == 0 ) {
+		if (++w == rowWords) {
+			return r2.to+1;
+		}
+		cur = row[w];
+	}
+	return r2.from + w*wordBits + (size_t)__builtin_ctzll(cur);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+PairingMask::
+getPrevPairing( const size_t i1, const size_t i2end ) const
+{
+	if (i2end <= r2.from) {
+		return RnaSequence::lastPos;
+	}
+	const Word * row = getRow(i1);
+	// number of candidate positions
+	const size_t k = std::min(i2end,r2.to+1)-r2.from;
+	size_t w = (k-1)/wordBits;
+	// mask all bits >= k
+	const size_t keep = (k-1)%wordBits+1;
+	Word cur = row[w] & (keep == wordBits ? ~((Word)0) : (((Word)1 << keep)-1));
+	while( cur == 0 ) {
+		if (w == 0) {
+			return RnaSequence::lastPos;
+		}
+		cur = row[--w];
+	}
+	return r2.from + w*wordBits + (wordBits-1) - (size_t)__builtin_clzll(cur);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+inline
+const IndexRange &
+PairingMask::
+getRange1() const
+{
+	return r1;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+inline
+const IndexRange &
+PairingMask::
+getRange2() const
+{
+	return r2;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_PAIRINGMASK_H_ */
@@ -4,6 +4,7 @@
 
 
 #include "IntaRNA/general.h"
+#include "IntaRNA/Arena4dMatrix.h"
 
 namespace IntaRNA {
 
@@ -43,6 +44,51 @@ public:
 						, const E_type energy
 						) = 0;
 
+	//! Boltzmann weights of interaction boundaries, i.e. (*Z(i1,i2))(w1,w2)
+	//! holds the weight of the interaction site (i1,i1+w1,i2,i2+w2)
+	typedef Arena4dMatrix< E_type > BoundaryZ;
+
+	/**
+	 * Whether or not the tracker only depends on the Boltzmann weights of
+	 * the energies it is informed about. If so, partition function-based
+	 * predictors provide the weights of all interaction boundaries at once
+	 * via updateBoundaryZ() instead of calling updateOptimumCalled() for
+	 * each boundary.
+	 *
+	 * @return true if updateBoundaryZ() is supported; false otherwise
+	 */
+	virtual
+	bool
+	isBoundaryZTracker() const;
+
+	/**
+	 * Informs the tracker about the Boltzmann weights of all interaction
+	 * boundaries of a prediction, which is equivalent to an
+	 * updateOptimumCalled() call for each non-zero entry of Z (only called
+	 * if isBoundaryZTracker()).
+	 *
+	 * @param Z the Boltzmann weights of all interaction boundaries
+	 * @param offset1 the index in the first sequence of Z's index i1=0
+	 * @param offset2 the index in the second sequence of Z's index i2=0
+	 */
+	virtual
+	void
+	updateBoundaryZ( const BoundaryZ & Z, const size_t offset1, const size_t offset2 );
+
+	/**
+	 * Creates a partial tracker that collects the data of the predictions
+	 * it is informed about on its own and merges it into this tracker on
+	 * its destruction (thread-safe). Thus, concurrently running predictions
+	 * (e.g. of different windows) can use their own partial trackers,
+	 * while this tracker provides the overall result.
+	 *
+	 * @return a newly allocated partial tracker to be deleted by the caller
+	 *         before this tracker
+	 */
+	virtual
+	PredictionTracker *
+	newPartialTracker() = 0;
+
 };
 
 
@@ -63,6 +109,24 @@ PredictionTracker::~PredictionTracker()
 
 ///////////////////////////////////////////////////////////////////////////
 
+inline
+bool
+PredictionTracker::isBoundaryZTracker() const
+{
+	return false;
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+inline
+void
+PredictionTracker::updateBoundaryZ( const BoundaryZ & Z, const size_t offset1, const size_t offset2 )
+{
+	INTARNA_NOT_IMPLEMENTED("PredictionTracker::updateBoundaryZ() : not supported by this tracker");
+}
+
+///////////////////////////////////////////////////////////////////////////
+
 
 } // namespace
 
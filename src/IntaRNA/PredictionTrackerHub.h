@@ -4,7 +4,7 @@
 
 #include "IntaRNA/PredictionTracker.h"
 
-#include <list>
+#include <vector>
 
 namespace IntaRNA {
 
@@ -18,7 +18,7 @@ class PredictionTrackerHub: public PredictionTracker
 protected:
 
 	//! list of PredictionTracker objects to forward to
-	std::list< PredictionTracker * > trackList;
+	std::vector< PredictionTracker * > trackList;
 
 	//! whether or not the elements in trackList are to be deleted when this
 	//! object is destroyed
@@ -63,6 +63,26 @@ public:
 						, const E_type energy
 						);
 
+	/**
+	 * Whether or not all registered trackers support updateBoundaryZ().
+	 * @return true if all (and at least one) trackers are boundary Z trackers
+	 */
+	virtual
+	bool
+	isBoundaryZTracker() const;
+
+	/**
+	 * Forwards the Boltzmann weights of all interaction boundaries to all
+	 * registered trackers (see PredictionTracker::updateBoundaryZ()).
+	 *
+	 * @param Z the Boltzmann weights of all interaction boundaries
+	 * @param offset1 the index in the first sequence of Z's index i1=0
+	 * @param offset2 the index in the second sequence of Z's index i2=0
+	 */
+	virtual
+	void
+	updateBoundaryZ( const BoundaryZ & Z, const size_t offset1, const size_t offset2 );
+
 	/**
 	 * Adds a new PredictionTracker to the forwarding list.
 	 * @param tracker pointer to the tracker to forward to
@@ -71,6 +91,17 @@ public:
 	void
 	addPredictionTracker( PredictionTracker * tracker );
 
+	/**
+	 * Creates a hub forwarding to partial trackers of all registered
+	 * trackers (see PredictionTracker::newPartialTracker()).
+	 *
+	 * @return a newly allocated hub of partial trackers to be deleted by the
+	 *         caller before this hub
+	 */
+	virtual
+	PredictionTracker *
+	newPartialTracker();
+
 	/**
 	 * Defines whether or not the PredictionTracker instances this hub forwards to
 	 * are deleted when this hub is deleted.
@@ -194,6 +225,49 @@ updateOptimumCalled( const size_t i1, const size_t j1
 
 /////////////////////////////////////////////////////////////////////////
 
+inline
+bool
+PredictionTrackerHub::
+isBoundaryZTracker() const
+{
+	for (auto trackIt=trackList.begin(); trackIt!=trackList.end(); trackIt++) {
+		if (!(*trackIt)->isBoundaryZTracker()) {
+			return false;
+		}
+	}
+	return !trackList.empty();
+}
+
+/////////////////////////////////////////////////////////////////////////
+
+inline
+void
+PredictionTrackerHub::
+updateBoundaryZ( const BoundaryZ & Z, const size_t offset1, const size_t offset2 )
+{
+	// forward to all in list
+	for (auto trackIt=trackList.begin(); trackIt!=trackList.end(); trackIt++) {
+		(*trackIt)->updateBoundaryZ(Z,offset1,offset2);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////
+
+inline
+PredictionTracker *
+PredictionTrackerHub::
+newPartialTracker()
+{
+	// hub that deletes the partial trackers on destruction
+	PredictionTrackerHub * partialHub = new PredictionTrackerHub( true );
+	for (auto trackIt=trackList.begin(); trackIt!=trackList.end(); trackIt++) {
+		partialHub->addPredictionTracker( (*trackIt)->newPartialTracker() );
+	}
+	return partialHub;
+}
+
+/////////////////////////////////////////////////////////////////////////
+
 inline
 void
 PredictionTrackerHub::
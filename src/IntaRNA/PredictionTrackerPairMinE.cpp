@@ -1,10 +1,16 @@
 
 #include "IntaRNA/PredictionTrackerPairMinE.h"
 
+#include <algorithm>
+
 namespace IntaRNA {
 
 //////////////////////////////////////////////////////////////////////
 
+const size_t PredictionTrackerPairMinE::tileSize = 64;
+
+//////////////////////////////////////////////////////////////////////
+
 PredictionTrackerPairMinE::
 PredictionTrackerPairMinE(
 		const InteractionEnergy & energy
@@ -13,10 +19,14 @@ PredictionTrackerPairMinE(
 	)
  :	PredictionTracker()
 	, energy(energy)
+	, mergeInto(NULL)
 	, deleteStreamsOnDestruction(true)
 	, outStream(NULL)
 	, E_INF_string(E_INF_string)
-	, pairMinE( energy.size1(), energy.size2(), E_INF ) // init E_INF
+	, size1( energy.size1() )
+	, size2( energy.size2() )
+	, tiles2( (size2+tileSize-1)/tileSize )
+	, tiles( ((size1+tileSize-1)/tileSize)*tiles2 ) // all tiles empty
 {
 #if INTARNA_IN_DEBUG_MODE
 	if (streamName.empty()) {
@@ -40,10 +50,31 @@ PredictionTrackerPairMinE(
 	)
  :	PredictionTracker()
 	, energy(energy)
+	, mergeInto(NULL)
 	, deleteStreamsOnDestruction(false)
 	, outStream(outStream)
 	, E_INF_string(E_INF_string)
-	, pairMinE( energy.size1(), energy.size2(), E_INF ) // init E_INF
+	, size1( energy.size1() )
+	, size2( energy.size2() )
+	, tiles2( (size2+tileSize-1)/tileSize )
+	, tiles( ((size1+tileSize-1)/tileSize)*tiles2 ) // all tiles empty
+{
+}
+
+//////////////////////////////////////////////////////////////////////
+
+PredictionTrackerPairMinE::
+PredictionTrackerPairMinE( PredictionTrackerPairMinE & mergeInto )
+ :	PredictionTracker()
+	, energy(mergeInto.energy)
+	, mergeInto(&mergeInto)
+	, deleteStreamsOnDestruction(false)
+	, outStream(NULL)
+	, E_INF_string(mergeInto.E_INF_string)
+	, size1( mergeInto.size1 )
+	, size2( mergeInto.size2 )
+	, tiles2( mergeInto.tiles2 )
+	, tiles( mergeInto.tiles.size() ) // all tiles empty
 {
 }
 
@@ -52,10 +83,33 @@ PredictionTrackerPairMinE(
 PredictionTrackerPairMinE::
 ~PredictionTrackerPairMinE()
 {
-	writeData( *outStream
-				, pairMinE
-				, energy
-				, E_INF_string );
+	// partial tracker : merge data (minimum)
+	if (mergeInto != NULL) {
+#if INTARNA_MULITHREADING
+		#pragma omp critical(intarna_omp_predictionTrackerMerge)
+#endif
+		{
+			for (size_t t=0; t<tiles.size(); t++) {
+				// skip tiles not covered
+				if (tiles.at(t).empty()) {
+					continue;
+				}
+				Tile & target = mergeInto->tiles.at(t);
+				// move tile if not covered in target
+				if (target.empty()) {
+					target.swap( tiles[t] );
+					continue;
+				}
+				for (size_t k=0; k<target.size(); k++) {
+					if (tiles[t][k] < target[k]) {
+						target[k] = tiles[t][k];
+					}
+				}
+			}
+		} // omp critical(intarna_omp_predictionTrackerMerge)
+	} else {
+		writeData( *outStream );
+	}
 
 	// clean up if file pointers were created in constructor
 	if (deleteStreamsOnDestruction) {
@@ -86,27 +140,57 @@ updateOptimumCalled( const size_t i1_, const size_t j1_
 	if (i2>j2) throw std::runtime_error("PredictionTrackerPairMinE::updateProfile() : i2 "+toString(i2)+" > j2 "+toString(j2));
 #endif
 
-	// update pair data
-	for (size_t k1=i1; k1<=j1; k1++) {
-		for (size_t k2=i2; k2<=j2; k2++) {
-			// check if E is smaller than current minE
-			if ( curE < pairMinE(k1,k2) ) {
-				// write new minimum
-				pairMinE(k1,k2) = curE;
+	// update pair data tile-wise
+	for (size_t t1=i1/tileSize; t1<=j1/tileSize; t1++) {
+	for (size_t t2=i2/tileSize; t2<=j2/tileSize; t2++) {
+		Tile & tile = getTile( t1, t2 );
+		// index range covered within this tile
+		const size_t k1end = std::min( j1+1, (t1+1)*tileSize );
+		const size_t k2end = std::min( j2+1, (t2+1)*tileSize );
+		for (size_t k1=std::max(i1,t1*tileSize); k1<k1end; k1++) {
+			E_type * row = &(tile[ (k1%tileSize)*tileSize ]);
+			for (size_t k2=std::max(i2,t2*tileSize); k2<k2end; k2++) {
+				// check if E is smaller than current minE
+				if ( curE < row[k2%tileSize] ) {
+					// write new minimum
+					row[k2%tileSize] = curE;
+				}
 			}
 		}
 	}
+	}
 }
 
+//////////////////////////////////////////////////////////////////////
+
+size_t
+PredictionTrackerPairMinE::
+getTileNumber() const
+{
+	size_t number = 0;
+	for (size_t t=0; t<tiles.size(); t++) {
+		if (!tiles.at(t).empty()) {
+			number++;
+		}
+	}
+	return number;
+}
+
+
+//////////////////////////////////////////////////////////////////////
+
+PredictionTracker *
+PredictionTrackerPairMinE::
+newPartialTracker()
+{
+	return new PredictionTrackerPairMinE( *this );
+}
 
 //////////////////////////////////////////////////////////////////////
 
 void
 PredictionTrackerPairMinE::
-writeData( std::ostream &out
-			, const E2dMatrix & pairMinE
-			, const InteractionEnergy & energy
-			, const std::string & E_INF_string )
+writeData( std::ostream &out ) const
 {
 	// direct access to sequence string information
 	const std::string & rna1 = energy.getAccessibility1().getSequence().asString();
@@ -124,18 +208,33 @@ writeData( std::ostream &out
 	}
 	out <<'\n';
 	// print minE data
-	for (size_t i=0; i<pairMinE.size1(); i++) {
+	for (size_t i=0; i<size1; i++) {
 		// out nt in seq1 together with index
 		out <<rna1.at(i)<<"_"<<(i+1);
-		for (size_t j=pairMinE.size2(); j-- > 0; ) {
-			// out separator
-			out <<';';
-			// out infinity replacement if needed
-			if ( E_isINF( pairMinE(i,j) ) ) {
-				out<<E_INF_string;
-			} else {
-				// print energy
-				out <<pairMinE(i,j);
+		const size_t t1 = i/tileSize;
+		// tiles of this row in reversed order
+		for (size_t t2=tiles2; t2-- > 0; ) {
+			const Tile & tile = tiles.at( t1*tiles2 + t2 );
+			const size_t jStart = t2*tileSize;
+			const size_t jEnd = std::min( size2, jStart+tileSize );
+			// tile not covered : all E_INF
+			if (tile.empty()) {
+				for (size_t j=jStart; j<jEnd; j++) {
+					out <<';' <<E_INF_string;
+				}
+				continue;
+			}
+			const E_type * row = &(tile[ (i%tileSize)*tileSize ]);
+			for (size_t j=jEnd; j-- > jStart; ) {
+				// out separator
+				out <<';';
+				// out infinity replacement if needed
+				if ( E_isINF( row[j-jStart] ) ) {
+					out<<E_INF_string;
+				} else {
+					// print energy
+					out <<row[j-jStart];
+				}
 			}
 		}
 		// line end
@@ -145,5 +244,16 @@ writeData( std::ostream &out
 
 //////////////////////////////////////////////////////////////////////
 
+size_t
+PredictionTrackerPairMinE::
+getMemoryEstimate( const size_t size1, const size_t size2 )
+{
+	// full tiles covering the index pairs
+	return ((size1+tileSize-1)/tileSize) * ((size2+tileSize-1)/tileSize)
+			* tileSize*tileSize*sizeof(E_type);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 } // namespace
 
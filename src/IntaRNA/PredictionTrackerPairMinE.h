@@ -6,9 +6,9 @@
 #include "IntaRNA/InteractionEnergy.h"
 
 #include <iostream>
+#include <vector>
 
 #include <boost/algorithm/string.hpp>
-#include <boost/numeric/ublas/matrix.hpp>
 
 
 namespace IntaRNA {
@@ -17,11 +17,21 @@ namespace IntaRNA {
  * Collects for each intermolecular index pair the minimal energy of any interaction
  * covering this pair (even if not forming a base pair).
  *
+ * The pair data is stored in square tiles of tileSize x tileSize index
+ * pairs that are only allocated if covered by any interaction. Thus, the
+ * memory consumption is proportional to the area covered by interactions
+ * rather than to the product of the sequence lengths.
+ *
  * The pair data is written to stream on destruction.
  */
 class PredictionTrackerPairMinE: public PredictionTracker
 {
 
+public:
+
+	//! edge length of the square tiles the pair data is stored in
+	static const size_t tileSize;
+
 public:
 
 	/**
@@ -62,6 +72,14 @@ public:
 				, const std::string E_INF_string = "NA"
 			);
 
+	/**
+	 * Constructs a partial tracker that collects the minE data on its own
+	 * and merges it into the given tracker on destruction.
+	 *
+	 * @param mergeInto the tracker to merge the collected data into
+	 */
+	PredictionTrackerPairMinE( PredictionTrackerPairMinE & mergeInto );
+
 	/**
 	 * destruction: write the profile(s) to the according streams.
 	 */
@@ -84,12 +102,58 @@ public:
 						, const E_type energy
 						);
 
+	/**
+	 * Creates a partial tracker that merges its data into this tracker on
+	 * destruction.
+	 *
+	 * @return a newly allocated partial tracker to be deleted by the caller
+	 *         before this tracker
+	 */
+	virtual
+	PredictionTracker *
+	newPartialTracker();
+
+	/**
+	 * Provides the minimal energy of any interaction covering the given
+	 * index pair.
+	 *
+	 * @param k1 the index in the first sequence
+	 * @param k2 the index in the second sequence
+	 * @return the minimal energy covering (k1,k2) or E_INF if not covered
+	 */
+	E_type
+	getMinE( const size_t k1, const size_t k2 ) const;
+
+	/**
+	 * Provides the number of allocated tiles.
+	 * @return the number of tiles covered by any interaction
+	 */
+	size_t
+	getTileNumber() const;
+
+	/**
+	 * Computes the memory needed if all tiles are allocated.
+	 *
+	 * @param size1 the length of the first sequence
+	 * @param size2 the length of the second sequence
+	 *
+	 * @return the estimated number of bytes
+	 */
+	static
+	size_t
+	getMemoryEstimate( const size_t size1, const size_t size2 );
+
+
 
 protected:
 
 	//! energy handler used for predictions
 	const InteractionEnergy & energy;
 
+	//! if non-NULL, the tracker to merge the collected data into on
+	//! destruction (partial tracker)
+	PredictionTrackerPairMinE * mergeInto;
+
 	//! whether or not the streams are to be deleted on destruction
 	const bool deleteStreamsOnDestruction;
 
@@ -99,32 +163,72 @@ protected:
 	//! the output string representation of E_INF values in the profile output
 	const std::string E_INF_string;
 
-	//! matrix type to hold the mfe energies and boundaries for interaction site starts
-	typedef boost::numeric::ublas::matrix<E_type> E2dMatrix;
+	//! a tile of index-pair-wise minimal energy values (row-major);
+	//! empty if not covered by any interaction so far
+	typedef std::vector<E_type> Tile;
+
+	//! length of the first sequence
+	const size_t size1;
 
-	//! the index-pair-wise minimal energy values
-	E2dMatrix pairMinE;
+	//! length of the second sequence
+	const size_t size2;
+
+	//! number of tiles covering the second sequence
+	const size_t tiles2;
+
+	//! the tiles of index-pair-wise minimal energy values (row-major)
+	std::vector< Tile > tiles;
+
+	/**
+	 * Provides the tile for the given tile indices and allocates it if
+	 * not done yet.
+	 *
+	 * @param t1 the tile index in the first sequence
+	 * @param t2 the tile index in the second sequence
+	 * @return the allocated tile
+	 */
+	Tile &
+	getTile( const size_t t1, const size_t t2 );
 
 	/**
-	 * Writes profile data to stream.
+	 * Writes the pair data to stream. Rows are generated on the fly from
+	 * the tiles, i.e. no dense matrix is created.
 	 *
 	 * @param out the output stream to write to
-	 * @param pairMinE the minE data to write
-	 * @param energy the energy function used
-	 * @param E_INF_string the string to be used for E_INF entries
 	 */
-	static
 	void
-	writeData( std::ostream &out
-				, const E2dMatrix & pairMinE
-				, const InteractionEnergy & energy
-				, const std::string & E_INF_string );
+	writeData( std::ostream &out ) const;
 
 
 };
 
 //////////////////////////////////////////////////////////////////////
 
+inline
+E_type
+PredictionTrackerPairMinE::
+getMinE( const size_t k1, const size_t k2 ) const
+{
+	const Tile & tile = tiles.at( (k1/tileSize)*tiles2 + (k2/tileSize) );
+	return tile.empty() ? E_INF : tile[ (k1%tileSize)*tileSize + (k2%tileSize) ];
+}
+
+//////////////////////////////////////////////////////////////////////
+
+inline
+PredictionTrackerPairMinE::Tile &
+PredictionTrackerPairMinE::
+getTile( const size_t t1, const size_t t2 )
+{
+	Tile & tile = tiles.at( t1*tiles2 + t2 );
+	if (tile.empty()) {
+		tile.resize( tileSize*tileSize, E_INF );
+	}
+	return tile;
+}
+
+//////////////////////////////////////////////////////////////////////
+
 } // namespace
 
 #endif /* PREDICTIONTRACKERPAIRMINE_H_ */
@@ -14,6 +14,7 @@ PredictionTrackerProfileMinE(
 	)
  :	PredictionTracker()
 	, energy(energy)
+	, mergeInto(NULL)
 	, deleteStreamsOnDestruction(true)
 	, seq1stream(NULL)
 	, seq2stream(NULL)
@@ -51,6 +52,7 @@ PredictionTrackerProfileMinE(
 	)
  :	PredictionTracker()
 	, energy(energy)
+	, mergeInto(NULL)
 	, deleteStreamsOnDestruction(false)
 	, seq1stream(seq1stream)
 	, seq2stream(seq2stream)
@@ -62,9 +64,44 @@ PredictionTrackerProfileMinE(
 
 //////////////////////////////////////////////////////////////////////
 
+PredictionTrackerProfileMinE::
+PredictionTrackerProfileMinE( PredictionTrackerProfileMinE & mergeInto )
+ :	PredictionTracker()
+	, energy(mergeInto.energy)
+	, mergeInto(&mergeInto)
+	, deleteStreamsOnDestruction(false)
+	, seq1stream(NULL)
+	, seq2stream(NULL)
+	, E_INF_string(mergeInto.E_INF_string)
+	, seq1minE( mergeInto.seq1minE.size(), E_INF ) // init E_INF
+	, seq2minE( mergeInto.seq2minE.size(), E_INF ) // init E_INF
+{
+}
+
+//////////////////////////////////////////////////////////////////////
+
 PredictionTrackerProfileMinE::
 ~PredictionTrackerProfileMinE()
 {
+	// partial tracker : merge profiles (minimum)
+	if (mergeInto != NULL) {
+#if INTARNA_MULITHREADING
+		#pragma omp critical(intarna_omp_predictionTrackerMerge)
+#endif
+		{
+			for (size_t k=0; k<seq1minE.size(); k++) {
+				if (seq1minE[k] < mergeInto->seq1minE[k]) {
+					mergeInto->seq1minE[k] = seq1minE[k];
+				}
+			}
+			for (size_t k=0; k<seq2minE.size(); k++) {
+				if (seq2minE[k] < mergeInto->seq2minE[k]) {
+					mergeInto->seq2minE[k] = seq2minE[k];
+				}
+			}
+		} // omp critical(intarna_omp_predictionTrackerMerge)
+	}
+
 	// write profiles to streams
 	if (seq1stream != NULL) {
 		writeProfile( *seq1stream
@@ -120,6 +157,15 @@ updateOptimumCalled( const size_t i1, const size_t j1
 }
 
 
+//////////////////////////////////////////////////////////////////////
+
+PredictionTracker *
+PredictionTrackerProfileMinE::
+newPartialTracker()
+{
+	return new PredictionTrackerProfileMinE( *this );
+}
+
 //////////////////////////////////////////////////////////////////////
 
 void
@@ -64,6 +64,14 @@ public:
 				, const std::string E_INF_string = "NA"
 			);
 
+	/**
+	 * Constructs a partial tracker that collects the minE profiles on its own
+	 * and merges it into the given tracker on destruction.
+	 *
+	 * @param mergeInto the tracker to merge the collected data into
+	 */
+	PredictionTrackerProfileMinE( PredictionTrackerProfileMinE & mergeInto );
+
 	/**
 	 * destruction: write the profile(s) to the according streams.
 	 */
@@ -86,12 +94,27 @@ public:
 						, const E_type energy
 						);
 
+	/**
+	 * Creates a partial tracker that merges its data into this tracker on
+	 * destruction.
+	 *
+	 * @return a newly allocated partial tracker to be deleted by the caller
+	 *         before this tracker
+	 */
+	virtual
+	PredictionTracker *
+	newPartialTracker();
+
 
 protected:
 
 	//! energy handler used for predictions
 	const InteractionEnergy & energy;
 
+	//! if non-NULL, the tracker to merge the collected data into on
+	//! destruction (partial tracker)
+	PredictionTrackerProfileMinE * mergeInto;
+
 	//! whether or not the streams are to be deleted on destruction
 	const bool deleteStreamsOnDestruction;
 
@@ -1,6 +1,8 @@
 
 #include "IntaRNA/PredictionTrackerProfileSpotProb.h"
 
+#include <vector>
+
 namespace IntaRNA {
 
 //////////////////////////////////////////////////////////////////////
@@ -14,6 +16,7 @@ PredictionTrackerProfileSpotProb(
 	)
  :	PredictionTracker()
 	, energy(energy)
+	, mergeInto(NULL)
 	, deleteStreamsOnDestruction(true)
 	, seq1stream(NULL)
 	, seq2stream(NULL)
@@ -52,6 +55,7 @@ PredictionTrackerProfileSpotProb(
 	)
  :	PredictionTracker()
 	, energy(energy)
+	, mergeInto(NULL)
 	, deleteStreamsOnDestruction(false)
 	, seq1stream(seq1stream)
 	, seq2stream(seq2stream)
@@ -64,9 +68,46 @@ PredictionTrackerProfileSpotProb(
 
 //////////////////////////////////////////////////////////////////////
 
+PredictionTrackerProfileSpotProb::
+PredictionTrackerProfileSpotProb( PredictionTrackerProfileSpotProb & mergeInto )
+ :	PredictionTracker()
+	, energy(mergeInto.energy)
+	, mergeInto(&mergeInto)
+	, deleteStreamsOnDestruction(false)
+	, seq1stream(NULL)
+	, seq2stream(NULL)
+	, E_INF_string(mergeInto.E_INF_string)
+	, seq1Z( mergeInto.seq1Z.size(), E_INF ) // init E_INF
+	, seq2Z( mergeInto.seq2Z.size(), E_INF ) // init E_INF
+	, overallZ( 0.0 )
+{
+}
+
+//////////////////////////////////////////////////////////////////////
+
 PredictionTrackerProfileSpotProb::
 ~PredictionTrackerProfileSpotProb()
 {
+	// partial tracker : merge partition functions (sum)
+	if (mergeInto != NULL) {
+#if INTARNA_MULITHREADING
+		#pragma omp critical(intarna_omp_predictionTrackerMerge)
+#endif
+		{
+			mergeInto->overallZ += overallZ;
+			for (size_t k=0; k<seq1Z.size(); k++) {
+				if (E_isNotINF(seq1Z[k])) {
+					mergeInto->seq1Z[k] = E_isINF(mergeInto->seq1Z[k]) ? seq1Z[k] : mergeInto->seq1Z[k] + seq1Z[k];
+				}
+			}
+			for (size_t k=0; k<seq2Z.size(); k++) {
+				if (E_isNotINF(seq2Z[k])) {
+					mergeInto->seq2Z[k] = E_isINF(mergeInto->seq2Z[k]) ? seq2Z[k] : mergeInto->seq2Z[k] + seq2Z[k];
+				}
+			}
+		} // omp critical(intarna_omp_predictionTrackerMerge)
+	}
+
 	// write profiles to streams
 	if (seq1stream != NULL) {
 		writeProfile( *seq1stream
@@ -130,6 +171,91 @@ updateOptimumCalled( const size_t i1, const size_t j1
 }
 
 
+//////////////////////////////////////////////////////////////////////
+
+void
+PredictionTrackerProfileSpotProb::
+updateBoundaryZ( const BoundaryZ & Z, const size_t offset1, const size_t offset2 )
+{
+	// weights added at the interval start and subtracted after its end
+	std::vector<double> diff1( seq1Z.empty() ? 0 : Z.size1()+1, 0.0 );
+	std::vector<double> diff2( seq2Z.empty() ? 0 : Z.size2()+1, 0.0 );
+	// number of interactions starting/ending to identify covered positions
+	std::vector<long> count1( diff1.size(), 0 );
+	std::vector<long> count2( diff2.size(), 0 );
+	double sumZ = 0.0;
+
+	for (size_t i1=0; i1<Z.size1(); i1++) {
+	for (size_t i2=0; i2<Z.size2(); i2++) {
+		const BoundaryZ::Block * block = Z(i1,i2);
+		if (block == NULL) {
+			continue;
+		}
+		for (size_t w1=0; w1<block->size1(); w1++) {
+		for (size_t w2=0; w2<block->size2(); w2++) {
+			const E_type bwE = (*block)(w1,w2);
+			if (!(bwE > 0)) {
+				continue;
+			}
+			sumZ += bwE;
+			if (!diff1.empty()) {
+				diff1[i1] += bwE; diff1[i1+w1+1] -= bwE;
+				count1[i1]++; count1[i1+w1+1]--;
+			}
+			if (!diff2.empty()) {
+				diff2[i2] += bwE; diff2[i2+w2+1] -= bwE;
+				count2[i2]++; count2[i2+w2+1]--;
+			}
+		}
+		}
+	}
+	}
+
+	// update overall partition function
+	overallZ += (E_type)sumZ;
+
+	// update seq1 profile via prefix sums
+	double curZ = 0.0;
+	long curCount = 0;
+	for (size_t k=0; k+1<diff1.size(); k++) {
+		curZ += diff1[k];
+		curCount += count1[k];
+		if (curCount > 0) {
+			const size_t idx = k+offset1;
+			seq1Z[idx] = E_isINF(seq1Z[idx]) ? (E_type)curZ : seq1Z[idx] + (E_type)curZ;
+		}
+	}
+	// update seq2 profile (reversed indexing)
+	curZ = 0.0;
+	curCount = 0;
+	for (size_t k=0; k+1<diff2.size(); k++) {
+		curZ += diff2[k];
+		curCount += count2[k];
+		if (curCount > 0) {
+			const size_t idx = energy.getAccessibility2().getReversedIndex(k+offset2);
+			seq2Z[idx] = E_isINF(seq2Z[idx]) ? (E_type)curZ : seq2Z[idx] + (E_type)curZ;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+
+bool
+PredictionTrackerProfileSpotProb::
+isBoundaryZTracker() const
+{
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+
+PredictionTracker *
+PredictionTrackerProfileSpotProb::
+newPartialTracker()
+{
+	return new PredictionTrackerProfileSpotProb( *this );
+}
+
 //////////////////////////////////////////////////////////////////////
 
 void
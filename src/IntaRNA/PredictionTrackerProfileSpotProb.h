@@ -68,6 +68,14 @@ public:
 				, const std::string E_INF_string = "NA"
 			);
 
+	/**
+	 * Constructs a partial tracker that collects the partition function profiles on its own
+	 * and merges it into the given tracker on destruction.
+	 *
+	 * @param mergeInto the tracker to merge the collected data into
+	 */
+	PredictionTrackerProfileSpotProb( PredictionTrackerProfileSpotProb & mergeInto );
+
 	/**
 	 * destruction: write the profile(s) to the according streams.
 	 */
@@ -90,12 +98,50 @@ public:
 						, const E_type energy
 						);
 
+	/**
+	 * Computes the profiles of a prediction from the Boltzmann weights of
+	 * all interaction boundaries in one sweep, where the weight of each
+	 * boundary is added to the start of its interval and subtracted after
+	 * its end, such that the prefix sums provide the partition function of
+	 * all interactions covering a position.
+	 *
+	 * @param Z the Boltzmann weights of all interaction boundaries
+	 * @param offset1 the index in the first sequence of Z's index i1=0
+	 * @param offset2 the index in the second sequence of Z's index i2=0
+	 */
+	virtual
+	void
+	updateBoundaryZ( const BoundaryZ & Z, const size_t offset1, const size_t offset2 );
+
+	/**
+	 * The profiles only depend on the Boltzmann weights of the interactions.
+	 * @return true
+	 */
+	virtual
+	bool
+	isBoundaryZTracker() const;
+
+	/**
+	 * Creates a partial tracker that merges its data into this tracker on
+	 * destruction.
+	 *
+	 * @return a newly allocated partial tracker to be deleted by the caller
+	 *         before this tracker
+	 */
+	virtual
+	PredictionTracker *
+	newPartialTracker();
+
 
 protected:
 
 	//! energy handler used for predictions
 	const InteractionEnergy & energy;
 
+	//! if non-NULL, the tracker to merge the collected data into on
+	//! destruction (partial tracker)
+	PredictionTrackerProfileSpotProb * mergeInto;
+
 	//! whether or not the streams are to be deleted on destruction
 	const bool deleteStreamsOnDestruction;
 
@@ -1,6 +1,8 @@
 
 #include "IntaRNA/PredictionTrackerSpotProb.h"
 
+#include <algorithm>
+
 #include <boost/foreach.hpp>
 #include <boost/regex.hpp>
 
@@ -21,11 +23,16 @@ PredictionTrackerSpotProb(
 	)
  :	PredictionTracker()
 	, energy(energy)
+	, mergeInto(NULL)
 	, outStream(NULL)
 	, deleteOutStream(true)
 	, spots()
 	, noSpotZ(0.0)
 	, overallZ(0.0)
+	, spotOrder()
+	, spotOrderIdx2()
+	, rowIdx1()
+	, rowStart()
 {
 #if INTARNA_IN_DEBUG_MODE
 	// check spot encoding via regex
@@ -52,6 +59,9 @@ PredictionTrackerSpotProb(
 		// update start of next interval encoding to parse
 		startPos = splitPos + (splitPos != std::string::npos ? 1 : 0);
 	}
+
+	// setup spot lookup
+	initSpotIndex();
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -64,11 +74,16 @@ PredictionTrackerSpotProb(
 	)
  :	PredictionTracker()
 	, energy(energy)
+	, mergeInto(NULL)
 	, outStream(&outStream)
 	, deleteOutStream(false)
 	, spots()
 	, noSpotZ(0.0)
 	, overallZ(0.0)
+	, spotOrder()
+	, spotOrderIdx2()
+	, rowIdx1()
+	, rowStart()
 {
 #if INTARNA_IN_DEBUG_MODE
 	// check spot encoding via regex
@@ -87,6 +102,67 @@ PredictionTrackerSpotProb(
 		// update start of next interval encoding to parse
 		startPos = splitPos + (splitPos != std::string::npos ? 1 : 0);
 	}
+
+	// setup spot lookup
+	initSpotIndex();
+}
+
+//////////////////////////////////////////////////////////////////////
+
+PredictionTrackerSpotProb::
+PredictionTrackerSpotProb( PredictionTrackerSpotProb & mergeInto )
+ :	PredictionTracker()
+	, energy(mergeInto.energy)
+	, mergeInto(&mergeInto)
+	, outStream(NULL)
+	, deleteOutStream(false)
+	, spots()
+	, noSpotZ(0.0)
+	, overallZ(0.0)
+	, spotOrder()
+	, spotOrderIdx2()
+	, rowIdx1()
+	, rowStart()
+{
+	// same spots with empty partition functions
+	BOOST_FOREACH( const Spot & s, mergeInto.spots) {
+		spots.push_back( Spot( s.idx1, s.idx2 ) );
+	}
+	// same spot lookup
+	spotOrder = mergeInto.spotOrder;
+	spotOrderIdx2 = mergeInto.spotOrderIdx2;
+	rowIdx1 = mergeInto.rowIdx1;
+	rowStart = mergeInto.rowStart;
+}
+
+//////////////////////////////////////////////////////////////////////
+
+void
+PredictionTrackerSpotProb::
+initSpotIndex()
+{
+	// sort spots by (idx1,idx2)
+	std::vector< std::pair< std::pair<size_t,size_t>, size_t > > sorted;
+	sorted.reserve( spots.size() );
+	for (size_t s=0; s<spots.size(); s++) {
+		sorted.push_back( std::make_pair( std::make_pair( spots[s].idx1, spots[s].idx2 ), s ) );
+	}
+	std::sort( sorted.begin(), sorted.end() );
+
+	spotOrder.resize( sorted.size() );
+	spotOrderIdx2.resize( sorted.size() );
+	rowIdx1.clear();
+	rowStart.clear();
+	for (size_t k=0; k<sorted.size(); k++) {
+		spotOrder[k] = sorted[k].second;
+		spotOrderIdx2[k] = sorted[k].first.second;
+		// start of a new row
+		if (rowIdx1.empty() || rowIdx1.back() != sorted[k].first.first) {
+			rowIdx1.push_back( sorted[k].first.first );
+			rowStart.push_back( k );
+		}
+	}
+	rowStart.push_back( spotOrder.size() );
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -94,6 +170,21 @@ PredictionTrackerSpotProb(
 PredictionTrackerSpotProb::
 ~PredictionTrackerSpotProb()
 {
+	// partial tracker : merge partition functions (sum)
+	if (mergeInto != NULL) {
+#if INTARNA_MULITHREADING
+		#pragma omp critical(intarna_omp_predictionTrackerMerge)
+#endif
+		{
+			mergeInto->noSpotZ += noSpotZ;
+			mergeInto->overallZ += overallZ;
+			for (size_t s=0; s<spots.size(); s++) {
+				mergeInto->spots[s].Z += spots[s].Z;
+			}
+		} // omp critical(intarna_omp_predictionTrackerMerge)
+		return;
+	}
+
 	// write probabilities to streams
 	// probability of interactions covering no tracked spot
 	(*outStream) <<"spot;probability\n";
@@ -139,14 +230,17 @@ updateOptimumCalled( const size_t i1, const size_t j1
 	// update spot information
 	bool noSpotCovered = true;
 
-	// update final output handler
-	BOOST_FOREACH( Spot & s, spots) {
-		// check if covered
-		if ( bp_l.first <= s.idx1 && s.idx1 <= bp_r.first
-			&& bp_r.second <= s.idx2 && s.idx2 <= bp_l.second)
+	// iterate all spots with bp_l.first <= idx1 <= bp_r.first
+	for (std::vector<size_t>::const_iterator row = std::lower_bound( rowIdx1.begin(), rowIdx1.end(), bp_l.first );
+			row != rowIdx1.end() && *row <= bp_r.first; row++)
+	{
+		const size_t r = row - rowIdx1.begin();
+		// find first spot of this row with bp_r.second <= idx2
+		for (size_t k = std::lower_bound( spotOrderIdx2.begin()+rowStart[r], spotOrderIdx2.begin()+rowStart[r+1], bp_r.second ) - spotOrderIdx2.begin();
+				k < rowStart[r+1] && spotOrderIdx2[k] <= bp_l.second; k++)
 		{
 			// update partition function of this spot, since it is covered
-			s.Z += curBW;
+			spots[spotOrder[k]].Z += curBW;
 			// note that a spot was covered
 			noSpotCovered = false;
 		}
@@ -160,6 +254,102 @@ updateOptimumCalled( const size_t i1, const size_t j1
 }
 
 
+//////////////////////////////////////////////////////////////////////
+
+void
+PredictionTrackerSpotProb::
+updateBoundaryZ( const BoundaryZ & Z, const size_t offset1, const size_t offset2 )
+{
+	// spots within Z given as (spot index, (local idx1, local reversed idx2))
+	std::vector< std::pair< size_t, std::pair<size_t,size_t> > > localSpots;
+	for (size_t s=0; s<spots.size(); s++) {
+		if (spots[s].idx1 < offset1 || spots[s].idx1-offset1 >= Z.size1() || spots[s].idx2 >= energy.size2()) {
+			continue;
+		}
+		const size_t idx2 = energy.getAccessibility2().getReversedIndex( spots[s].idx2 );
+		if (idx2 < offset2 || idx2-offset2 >= Z.size2()) {
+			continue;
+		}
+		localSpots.push_back( std::make_pair( s, std::make_pair( spots[s].idx1-offset1, idx2-offset2 ) ) );
+	}
+
+	std::vector<double> spotZ( spots.size(), 0.0 );
+	double sumZ = 0.0, sumNoSpotZ = 0.0;
+	// suffix sums of the current block, i.e. suffixZ(w1,w2) = partition
+	// function of all right boundaries (w1'>=w1,w2'>=w2)
+	std::vector<double> suffixZ;
+	// for each w1 the minimal w2 of a spot with w1'<=w1 within the block
+	std::vector<size_t> minSpotW2;
+
+	for (size_t i1=0; i1<Z.size1(); i1++) {
+	for (size_t i2=0; i2<Z.size2(); i2++) {
+		const BoundaryZ::Block * block = Z(i1,i2);
+		if (block == NULL) {
+			continue;
+		}
+		const size_t rows = block->size1(), cols = block->size2();
+		suffixZ.assign( (rows+1)*(cols+1), 0.0 );
+		for (size_t w1=rows; w1-- > 0;) {
+		for (size_t w2=cols; w2-- > 0;) {
+			const E_type bwE = (*block)(w1,w2);
+			suffixZ[w1*(cols+1)+w2] = (bwE > 0 ? (double)bwE : 0.0)
+					+ suffixZ[(w1+1)*(cols+1)+w2]
+					+ suffixZ[w1*(cols+1)+w2+1]
+					- suffixZ[(w1+1)*(cols+1)+w2+1];
+		}
+		}
+		sumZ += suffixZ[0];
+
+		// interactions covering a spot end right of it
+		minSpotW2.assign( rows, cols );
+		for (auto spot = localSpots.begin(); spot != localSpots.end(); spot++) {
+			if (spot->second.first < i1 || spot->second.second < i2) {
+				continue;
+			}
+			const size_t w1 = spot->second.first-i1, w2 = spot->second.second-i2;
+			if (w1 < rows && w2 < cols) {
+				spotZ[spot->first] += suffixZ[w1*(cols+1)+w2];
+				minSpotW2[w1] = std::min( minSpotW2[w1], w2 );
+			}
+		}
+
+		// interactions covering no spot end left of all spots
+		size_t maxW2 = cols;
+		for (size_t w1=0; w1<rows; w1++) {
+			maxW2 = std::min( maxW2, minSpotW2[w1] );
+			// row sum of all w2 < maxW2
+			sumNoSpotZ += (suffixZ[w1*(cols+1)] - suffixZ[(w1+1)*(cols+1)])
+					- (suffixZ[w1*(cols+1)+maxW2] - suffixZ[(w1+1)*(cols+1)+maxW2]);
+		}
+	}
+	}
+
+	// update partition functions
+	overallZ += (E_type)sumZ;
+	noSpotZ += (E_type)sumNoSpotZ;
+	for (size_t s=0; s<spots.size(); s++) {
+		spots[s].Z += (E_type)spotZ[s];
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+
+bool
+PredictionTrackerSpotProb::
+isBoundaryZTracker() const
+{
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+
+PredictionTracker *
+PredictionTrackerSpotProb::
+newPartialTracker()
+{
+	return new PredictionTrackerSpotProb( *this );
+}
+
 ////////////////////////////////////////////////////////////////////////////
 
 
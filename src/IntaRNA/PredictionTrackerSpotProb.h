@@ -64,6 +64,15 @@ public:
 			);
 
 
+	/**
+	 * Constructs a partial tracker that collects the partition functions of
+	 * the spots on its own and merges them into the given tracker on
+	 * destruction.
+	 *
+	 * @param mergeInto the tracker to merge the collected data into
+	 */
+	PredictionTrackerSpotProb( PredictionTrackerSpotProb & mergeInto );
+
 	/**
 	 * destruction: write the probabilities to stream.
 	 */
@@ -86,6 +95,41 @@ public:
 						, const E_type energy
 						);
 
+	/**
+	 * Computes the spot partition functions of a prediction from the
+	 * Boltzmann weights of all interaction boundaries in one sweep. For each
+	 * left boundary, the suffix sums over the right boundaries provide the
+	 * partition function of all interactions covering a spot, and the
+	 * interactions covering no spot form a staircase of right boundaries.
+	 *
+	 * @param Z the Boltzmann weights of all interaction boundaries
+	 * @param offset1 the index in the first sequence of Z's index i1=0
+	 * @param offset2 the index in the second sequence of Z's index i2=0
+	 */
+	virtual
+	void
+	updateBoundaryZ( const BoundaryZ & Z, const size_t offset1, const size_t offset2 );
+
+	/**
+	 * The spot probabilities only depend on the Boltzmann weights of the
+	 * interactions.
+	 * @return true
+	 */
+	virtual
+	bool
+	isBoundaryZTracker() const;
+
+	/**
+	 * Creates a partial tracker that merges its data into this tracker on
+	 * destruction.
+	 *
+	 * @return a newly allocated partial tracker to be deleted by the caller
+	 *         before this tracker
+	 */
+	virtual
+	PredictionTracker *
+	newPartialTracker();
+
 protected:
 
 	class Spot {
@@ -139,6 +183,10 @@ protected:
 	//! energy handler used for predictions
 	const InteractionEnergy & energy;
 
+	//! if non-NULL, the tracker to merge the collected data into on
+	//! destruction (partial tracker)
+	PredictionTrackerSpotProb * mergeInto;
+
 	//! the stream to write the probabilities to
 	std::ostream * outStream;
 
@@ -154,6 +202,26 @@ protected:
 	//! overall partition function of all reported interactions
 	E_type overallZ;
 
+	//! indices of the spots sorted by (idx1,idx2) for range lookup
+	std::vector<size_t> spotOrder;
+
+	//! idx2 of the spots in the order of spotOrder
+	std::vector<size_t> spotOrderIdx2;
+
+	//! the distinct idx1 values of the spots in ascending order
+	std::vector<size_t> rowIdx1;
+
+	//! for each entry of rowIdx1 the first according position within
+	//! spotOrder, followed by spotOrder.size()
+	std::vector<size_t> rowStart;
+
+	/**
+	 * Sets up the spot index (spotOrder, spotOrderIdx2, rowIdx1, rowStart)
+	 * from the spots container.
+	 */
+	void
+	initSpotIndex();
+
 protected:
 
 
@@ -10,6 +10,9 @@
 
 #include "IntaRNA/PredictionTracker.h"
 
+#include <chrono>
+#include <stdexcept>
+
 namespace IntaRNA {
 
 /**
@@ -20,6 +23,31 @@ namespace IntaRNA {
  */
 class Predictor {
 
+public:
+
+	/**
+	 * Exception thrown by a prediction that exceeds the deadline set via
+	 * setDeadline().
+	 */
+	class Timeout : public std::runtime_error {
+	public:
+		/**
+		 * Construction
+		 * @param remaining1 the range of the first sequence whose windows
+		 *        were not predicted (see predictWindows())
+		 */
+		Timeout( const IndexRange & remaining1 = IndexRange(0,RnaSequence::lastPos) )
+			: std::runtime_error("Predictor : deadline exceeded")
+			, remaining1(remaining1)
+		{}
+		//! the range of the first sequence whose windows were not predicted,
+		//! i.e. the windows reported before the timeout are not covered
+		IndexRange remaining1;
+	};
+
+	//! clock used for prediction deadlines
+	typedef std::chrono::steady_clock Clock;
+
 public:
 
 	/**
@@ -59,6 +87,30 @@ public:
 			, const IndexRange & r2 = IndexRange(0,RnaSequence::lastPos)
 			, const OutputConstraint & outConstraint = OutputConstraint() ) = 0;
 
+	/**
+	 * Computes the predictors optimization target for overlapping windows of
+	 * the range r1 (see IndexRange::overlappingWindows()) and the range r2.
+	 * The optimal interactions of each window are given to the output handler.
+	 *
+	 * By default, predict() is called for each window independently.
+	 * Predictors can overwrite this to reuse the results of the window
+	 * overlaps.
+	 *
+	 * @param r1 the index range of the first sequence to be cut into windows
+	 * @param r2 the index range of the second sequence interacting with r1
+	 * @param windowWidth the width of the windows of r1
+	 * @param windowOverlap the overlap of successive windows of r1
+	 * @param outConstraint constrains the interactions reported to the output handler
+	 *
+	 */
+	virtual
+	void
+	predictWindows( const IndexRange & r1
+			, const IndexRange & r2
+			, const size_t windowWidth
+			, const size_t windowOverlap
+			, const OutputConstraint & outConstraint = OutputConstraint() );
+
 	/**
 	 * Computes the maximal width of an interaction for a given site width and
 	 * maximal size of interaction loops.
@@ -72,8 +124,37 @@ public:
 	size_t
 	getMaxInteractionWidth( const size_t w, const size_t maxLoopSize );
 
+	/**
+	 * Sets a deadline for all subsequent predictions. Predictors that support
+	 * cooperative cancellation check the deadline within their fill loops
+	 * and abort the prediction via a Timeout exception once it is exceeded.
+	 * In that case, nothing is reported to the output handler for the aborted
+	 * window, while the windows of predictWindows() completed before are
+	 * reported (see Timeout::remaining1).
+	 *
+	 * @param deadline the time point after which predictions are aborted
+	 */
+	virtual
+	void
+	setDeadline( const Clock::time_point & deadline );
+
 protected:
 
+	//! whether or not a deadline was set via setDeadline()
+	bool hasDeadline;
+
+	//! the time point after which predictions are aborted (if hasDeadline)
+	Clock::time_point deadline;
+
+	/**
+	 * Checks whether the deadline (if any) is exceeded. To be called by the
+	 * fill loops of predictors supporting cooperative cancellation.
+	 *
+	 * @throws Timeout if the deadline is exceeded
+	 */
+	void
+	checkDeadline() const;
+
 	//! energy computation handler
 	InteractionEnergyIdxOffset energy;
 
@@ -136,7 +217,9 @@ Predictor::Predictor( const InteractionEnergy & energy
 					, OutputHandler & output
 					, PredictionTracker * predTracker )
 :
-	energy(energy)
+	hasDeadline(false)
+	, deadline()
+	, energy(energy)
 	, output(output)
 	, predTracker(predTracker)
 {
@@ -152,6 +235,32 @@ Predictor::~Predictor()
 
 ////////////////////////////////////////////////////////////////////////////
 
+inline
+void
+Predictor::
+predictWindows( const IndexRange & r1
+		, const IndexRange & r2
+		, const size_t windowWidth
+		, const size_t windowOverlap
+		, const OutputConstraint & outConstraint )
+{
+	// restrict to the sequence length (independent of the current offset)
+	const size_t size1 = energy.size1() + energy.getOffset1();
+	const IndexRange range1( r1.from, std::min( r1.to, size1-1 ) );
+	// predict each window independently
+	const std::vector<IndexRange> windows = range1.overlappingWindows( windowWidth, windowOverlap );
+	for (size_t w = 0; w < windows.size(); w++) {
+		try {
+			predict( windows.at(w), r2, outConstraint );
+		} catch (Timeout & e) {
+			// the remaining windows start with the aborted one
+			throw Timeout( IndexRange( windows.at(w).from, range1.to ) );
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 inline
 size_t
 Predictor::
@@ -166,6 +275,29 @@ getMaxInteractionWidth( const size_t w, const size_t maxLoopSize )
 
 ////////////////////////////////////////////////////////////////////////////
 
+inline
+void
+Predictor::
+setDeadline( const Clock::time_point & deadline_ )
+{
+	hasDeadline = true;
+	deadline = deadline_;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+void
+Predictor::
+checkDeadline() const
+{
+	if (hasDeadline && Clock::now() > deadline) {
+		throw Timeout();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 } // namespace
 
 #endif /* PREDICTOR_H_ */
@@ -1,20 +1,31 @@
 
 #include "IntaRNA/PredictorMaxProb.h"
+#include "IntaRNA/Telemetry.h"
+
+#include <cmath>
+#include <limits>
 
 namespace IntaRNA {
 
 ////////////////////////////////////////////////////////////////////////////
 
+const size_t PredictorMaxProb::hybridZRowBlockSize = 16;
+
+////////////////////////////////////////////////////////////////////////////
+
 PredictorMaxProb::
 PredictorMaxProb(
 		const InteractionEnergy & energy
 		, OutputHandler & output
 		, PredictionTracker * predTracker )
  : Predictor(energy,output,predTracker)
-	, hybridZ( 0,0 )
-	, Z(0.0)
+	, hybridZ()
+	, logZ(0.0)
+	, logScale(0.0)
+	, scale()
 	, maxProbInteraction(energy.getAccessibility1().getSequence()
 			,energy.getAccessibility2().getAccessibilityOrigin().getSequence())
+	, trackBoundaryZ(false)
 {
 }
 
@@ -95,19 +106,21 @@ predict( const IndexRange & r1
 		if ( ! i1or2blocked
 			&& energy.areComplementary( i1, i2 ))
 		{
-			// create new 2d matrix for different interaction site widths
-			hybridZ(i1,i2) = new E2dMatrix(
+			// reserve 2d matrix for different interaction site widths
+			hybridZ.reserveBlock( i1, i2,
 				/*w1 = */ std::min(energy.getAccessibility1().getMaxLength(), std::min( hybridZ.size1()-i1, maxWidthFori1i2) ),
 				/*w2 = */ std::min(energy.getAccessibility2().getMaxLength(), std::min( hybridZ.size2()-i2, maxWidthFori1i2) ));
 
 			debug_count_cells_nonNull += debug_cellNumber;
 		} else {
 			// reduce memory consumption and avoid computation for this start index combination
-			hybridZ(i1,i2) = NULL;
 			debug_count_cells_null += debug_cellNumber;
 		}
 	}
 	}
+	// allocate all 2d matrices at once
+	hybridZ.allocate();
+
 #if INTARNA_MULITHREADING
 	#pragma omp critical(intarna_omp_logOutput)
 #endif
@@ -115,12 +128,20 @@ predict( const IndexRange & r1
 				<<((double)debug_count_cells_nonNull/(double)(debug_count_cells_nonNull+debug_count_cells_null))
 				<<"%) and "<<debug_count_cells_null <<" not allocated"; }
 
+	// initialize partition function scaling
+	initScale( energy.getMaxInternalLoopSize1() + energy.getMaxInternalLoopSize2() + 2 );
+
 	// initialize max prob interaction for updates
 	initOptima( outConstraint );
 
 	// fill matrix
 	fillHybridZ( );
 
+	// inform tracker about all interaction boundaries at once
+	if (trackBoundaryZ) {
+		updateTrackerBoundaryZ( hybridZ, 0 );
+	}
+
 	// report interaction site with maximal probability
 	reportOptima( outConstraint );
 }
@@ -131,105 +152,211 @@ void
 PredictorMaxProb::
 clear()
 {
-	// delete 3rd and 4th dimension of the matrix
-	for (E4dMatrix::iterator1 iRows = hybridZ.begin1(); iRows != hybridZ.end1(); iRows++) {
-		for (E4dMatrix::iterator2 ijEntry = iRows.begin(); ijEntry != iRows.end(); ijEntry++) {
-			// delete 2d matrix for current ij
-			 INTARNA_CLEANUP(*ijEntry);
-		}
-	}
-	// clear matrix, free data
+	// clear matrix (memory is kept for reuse)
 	hybridZ.clear();
 
 }
 
 ////////////////////////////////////////////////////////////////////////////
 
+void
+PredictorMaxProb::
+initScale( const size_t maxLength )
+{
+	// scale each nucleotide by the square root of the best stacking weight
+	// such that the scaled partition functions remain within float range
+	const E_type bestStackingE = energy.getBestE_interLoop();
+	logScale = (bestStackingE < 0 && !E_isINF(bestStackingE))
+				? - (double)bestStackingE / (2.0 * (double)energy.getRT())
+				: 0.0;
+
+	// precompute scaling factors
+	scale.resize( maxLength+1 );
+	for (size_t d=0; d<scale.size(); d++) {
+		scale[d] = std::exp( - (double)d * logScale );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 void
 PredictorMaxProb::
 fillHybridZ()
 {
 
 	// global vars to avoid reallocation
-	size_t i1,i2,j1,j2,w1,w2,k1,k2;
+	size_t i1,i2,w1,w2,b;
 
 	//////////  FIRST ROUND : COMPUTE HYBRIDIZATION ENERGIES ONLY  ////////////
 
 	// reset overall partition function
-	Z = 0.0;
+	logZ = - std::numeric_limits<double>::infinity();
 
-	// current Z value
-	E_type curZ = 0.0;
 	// iterate increasingly over all window sizes w1 (seq1) and w2 (seq2)
 	for (w1=0; w1<energy.getAccessibility1().getMaxLength(); w1++) {
 	for (w2=0; w2<energy.getAccessibility2().getMaxLength(); w2++) {
-		// iterate over all window starts i1 (seq1) and i2 (seq2)
-		// TODO PARALLELIZE THIS DOUBLE LOOP ?!
+		// nothing to do if no window start possible
+		if (w1 >= hybridZ.size1() || w2 >= hybridZ.size2()) {
+			continue;
+		}
+		// the entries of all window starts only depend on smaller windows
+		// -> compute blocks of window starts i1 (seq1) in parallel if worthwhile
+		const size_t rows = hybridZ.size1()-w1;
+		for (b=0; b<rows; b+=hybridZRowBlockSize) {
+#if INTARNA_MULITHREADING
+			#pragma omp task firstprivate(w1,w2,b) if(rows > hybridZRowBlockSize)
+#endif
+			{
+			fillHybridZ( w1, w2, b, std::min(b+hybridZRowBlockSize,rows) );
+			}
+		}
+#if INTARNA_MULITHREADING
+		#pragma omp taskwait
+#endif
+
+		// update max prob interaction (in the order of the sequential recursion)
 		for (i1=0; i1+w1<hybridZ.size1(); i1++) {
 		for (i2=0; i2+w2<hybridZ.size2(); i2++) {
-			// check if left boundary is complementary
-			// and widths are possible
-			if (hybridZ(i1,i2) == NULL || hybridZ(i1,i2)->size1()<=w1 || hybridZ(i1,i2)->size2()<=w2) {
-				// interaction not possible: nothing to do
-				continue;
-			}
-			// check if interaction exceeds possible width due to max-loop-length
-			if ( getMaxInteractionWidth( 1+w1, energy.getMaxInternalLoopSize1() ) < w2
-				|| getMaxInteractionWidth( 1+w2, energy.getMaxInternalLoopSize2() ) < w1)
-			{
-				// ignore this entry
-				(*hybridZ(i1,i2))(w1,w2) = 0;
-				continue;
+			if (hybridZ(i1,i2) != NULL && hybridZ(i1,i2)->size1()>w1 && hybridZ(i1,i2)->size2()>w2) {
+				updateOptima( i1,i1+w1,i2,i2+w2, (*hybridZ(i1,i2))(w1,w2), true );
 			}
+		}
+		}
+	}
+	}
 
-			// get window ends j (seq1) and l (seq2)
-			j1=i1+w1;
-			j2=i2+w2;
 
-			// check if right boundary is complementary
-			if (hybridZ(j1,j2) == NULL) {
-				// not complementary -> ignore this entry
-				(*hybridZ(i1,i2))(w1,w2) = 0;
-				continue;
-			}
-			// compute entry
-			curZ = 0;
-
-			// either interaction initiation
-			if ( w1==0 && w2==0 )  {
-				curZ += energy.getBoltzmannWeight(energy.getE_init());
-			} else {
-			// or only internal loop energy (nothing between i and j)
-				if ( (w1+1) <= energy.getMaxInternalLoopSize1() && (w2+1) <= energy.getMaxInternalLoopSize2()) {
-					curZ += energy.getBoltzmannWeight(energy.getE_interLeft(i1,j1,i2,j2))
-						* (*hybridZ(j1,j2))(0,0);
-				}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMaxProb::
+fillHybridZ( const size_t w1, const size_t w2
+			, const size_t i1from, const size_t i1to )
+{
+	// local vars to avoid reallocation
+	size_t i1,i2,j1,j2,k1,k2;
+
+	// current (scaled) Z value
+	double curZ = 0.0;
+	// iterate over all window starts i1 (seq1) and i2 (seq2)
+	for (i1=i1from; i1<i1to; i1++) {
+	for (i2=0; i2+w2<hybridZ.size2(); i2++) {
+		// check if left boundary is complementary
+		// and widths are possible
+		if (hybridZ(i1,i2) == NULL || hybridZ(i1,i2)->size1()<=w1 || hybridZ(i1,i2)->size2()<=w2) {
+			// interaction not possible: nothing to do
+			continue;
+		}
+		// check if interaction exceeds possible width due to max-loop-length
+		if ( getMaxInteractionWidth( 1+w1, energy.getMaxInternalLoopSize1() ) < w2
+			|| getMaxInteractionWidth( 1+w2, energy.getMaxInternalLoopSize2() ) < w1)
+		{
+			// ignore this entry
+			(*hybridZ(i1,i2))(w1,w2) = 0;
+			continue;
+		}
+
+		// get window ends j (seq1) and l (seq2)
+		j1=i1+w1;
+		j2=i2+w2;
+
+		// check if right boundary is complementary
+		if (hybridZ(j1,j2) == NULL) {
+			// not complementary -> ignore this entry
+			(*hybridZ(i1,i2))(w1,w2) = 0;
+			continue;
+		}
+		// compute entry
+		curZ = 0;
+
+		// either interaction initiation
+		if ( w1==0 && w2==0 )  {
+			curZ += (double)energy.getBoltzmannWeight(energy.getE_init())
+					* getScale(2);
+		} else {
+		// or only internal loop energy (nothing between i and j)
+			if ( (w1+1) <= energy.getMaxInternalLoopSize1() && (w2+1) <= energy.getMaxInternalLoopSize2()) {
+				curZ += (double)energy.getBoltzmannWeight(energy.getE_interLeft(i1,j1,i2,j2))
+					* getScale(w1+w2)
+					* (double)(*hybridZ(j1,j2))(0,0);
 			}
+		}
 
-			if (w1 > 1 && w2 > 1) {
-				// sum all combinations of decompositions into (i1,i2)..(k1,k2)-(j1,j2)
-				for (k1=std::min(j1-1,i1+energy.getMaxInternalLoopSize1()+1); k1>i1; k1--) {
-				for (k2=std::min(j2-1,i2+energy.getMaxInternalLoopSize2()+1); k2>i2; k2--) {
-					// check if (k1,k2) are complementary
-					if (hybridZ(k1,k2) != NULL && hybridZ(k1,k2)->size1()>(j1-k1) && hybridZ(k1,k2)->size2()>(j2-k2)) {
-						curZ += energy.getBoltzmannWeight(energy.getE_interLeft(i1,k1,i2,k2))
-								* ((*hybridZ(k1,k2))(j1-k1,j2-k2));
-					}
-				}
+		if (w1 > 1 && w2 > 1) {
+			// sum all combinations of decompositions into (i1,i2)..(k1,k2)-(j1,j2)
+			for (k1=std::min(j1-1,i1+energy.getMaxInternalLoopSize1()+1); k1>i1; k1--) {
+			for (k2=std::min(j2-1,i2+energy.getMaxInternalLoopSize2()+1); k2>i2; k2--) {
+				// check if (k1,k2) are complementary
+				if (hybridZ(k1,k2) != NULL && hybridZ(k1,k2)->size1()>(j1-k1) && hybridZ(k1,k2)->size2()>(j2-k2)) {
+					curZ += (double)energy.getBoltzmannWeight(energy.getE_interLeft(i1,k1,i2,k2))
+							* getScale((k1-i1)+(k2-i2))
+							* (double)((*hybridZ(k1,k2))(j1-k1,j2-k2));
 				}
 			}
-			// store value
-			(*hybridZ(i1,i2))(w1,w2) = curZ;
-			// update max prob interaction
-			updateOptima( i1,j1,i2,j2, (*hybridZ(i1,i2))(w1,w2), true );
-		}
+			}
 		}
+		// store value
+		(*hybridZ(i1,i2))(w1,w2) = (E_type)curZ;
 	}
 	}
+}
 
 
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMaxProb::
+updateTrackerBoundaryZ( E4dMatrix & Z, const size_t minW )
+{
+	// convert blocks of window starts in parallel if worthwhile
+	for (size_t b=0; b<Z.size1(); b+=hybridZRowBlockSize) {
+#if INTARNA_MULITHREADING
+		#pragma omp task firstprivate(b) shared(Z) if(Z.size1() > hybridZRowBlockSize)
+#endif
+		{
+		updateTrackerBoundaryZ( Z, minW, b, std::min(b+hybridZRowBlockSize,Z.size1()) );
+		}
+	}
+#if INTARNA_MULITHREADING
+	#pragma omp taskwait
+#endif
+
+	// forward all Boltzmann weights
+	predTracker->updateBoundaryZ( Z, energy.getOffset1(), energy.getOffset2() );
 }
 
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMaxProb::
+updateTrackerBoundaryZ( E4dMatrix & Z, const size_t minW
+					, const size_t i1from, const size_t i1to )
+{
+	for (size_t i1=i1from; i1<i1to; i1++) {
+	for (size_t i2=0; i2<Z.size2(); i2++) {
+		E2dMatrix * block = Z(i1,i2);
+		if (block == NULL) {
+			continue;
+		}
+		for (size_t w1=0; w1<block->size1(); w1++) {
+		for (size_t w2=0; w2<block->size2(); w2++) {
+			E_type & curZ = (*block)(w1,w2);
+			// ignore empty ensembles and entries not computed
+			if (w1 < minW || w2 < minW || !(curZ > 0)) {
+				curZ = 0;
+				continue;
+			}
+			// Boltzmann weight of the ensemble energy (see updateOptima())
+			const double curLogZ = std::log( (double)curZ ) + (double)(w1+w2+2) * logScale
+					- (double)energy.getE(i1,i1+w1,i2,i2+w2,0.0) / (double)energy.getRT();
+			curZ = energy.getBoltzmannWeight( (E_type)( - (double)energy.getRT() * curLogZ ) );
+		}
+		}
+	}
+	}
+}
 
 ////////////////////////////////////////////////////////////////////////////
 
@@ -237,8 +364,11 @@ void
 PredictorMaxProb::
 initOptima( const OutputConstraint & outConstraint )
 {
-	// initialize max prob interaction (partition function value)
-	maxProbInteraction.energy = 0.0;
+	// tracker informed about all boundaries at once if supported
+	trackBoundaryZ = predTracker != NULL && predTracker->isBoundaryZTracker();
+
+	// initialize max prob interaction (ensemble energy)
+	maxProbInteraction.energy = E_INF;
 	// reset boundary base pairs
 	maxProbInteraction.r1.from = RnaSequence::lastPos;
 	maxProbInteraction.r1.to = RnaSequence::lastPos;
@@ -263,25 +393,41 @@ updateOptima( const size_t i1, const size_t j1
 //						<<curZ
 //						<<" = " <<(eH + eE + eD); }
 
+	// nothing to do for empty ensembles
+	if (!(interZ > 0)) {
+		return;
+	}
+
+	// unscaled log partition function
+	double curLogZ = std::log( (double)interZ ) + (double)((j1-i1)+(j2-i2)+2) * logScale;
 	// add Boltzmann weights of all penalties
-	E_type curZ = isHybridZ ? interZ * energy.getBoltzmannWeight( energy.getE(i1,j1,i2,j2,0.0) ) : interZ;
+	if (isHybridZ) {
+		curLogZ -= (double)energy.getE(i1,j1,i2,j2,0.0) / (double)energy.getRT();
+	}
+
+	// ensemble energy of the interaction
+	const E_type curE = (E_type)( - (double)energy.getRT() * curLogZ );
 
-	// report call if needed
-	if (predTracker != NULL) {
+	// report call if needed (unless reported via updateTrackerBoundaryZ())
+	if (predTracker != NULL && !trackBoundaryZ) {
 		// inform about prediction
 		predTracker->updateOptimumCalled( i1 + energy.getOffset1()
 										, j1 + energy.getOffset1()
 										, i2 + energy.getOffset2()
 										, j2 + energy.getOffset2()
-										, energy.getE(curZ) );
+										, curE );
 	}
 
-	// update overall partition function
-	Z += (double)curZ;
+	// update overall partition function in log-space
+	if (curLogZ > logZ) {
+		logZ = curLogZ + std::log1p( std::exp( logZ - curLogZ ) );
+	} else {
+		logZ = logZ + std::log1p( std::exp( curLogZ - logZ ) );
+	}
 
-	if (curZ > maxProbInteraction.energy) {
+	if (curE < maxProbInteraction.energy) {
 		// store new global min
-		maxProbInteraction.energy = curZ;
+		maxProbInteraction.energy = curE;
 		// store interaction boundaries
 		// left
 		maxProbInteraction.r1.from = i1+energy.getOffset1();
@@ -299,6 +445,8 @@ void
 PredictorMaxProb::
 reportOptima( const OutputConstraint & outConstraint )
 {
+	// measure traceback and reporting
+	Telemetry::Timer telemetryTimer( Telemetry::TRACEBACK );
 
 	if (outConstraint.reportMax == 0) {
 		return;
@@ -309,10 +457,7 @@ reportOptima( const OutputConstraint & outConstraint )
 	}
 
 	// maximal probability is
-	// double maxProb = (double)maxProbInteraction.getEnergy() / Z;
-
-	// convert the partition function into an ensemble energy
-	maxProbInteraction.energy = energy.getE( maxProbInteraction.energy );
+	// double maxProb = std::exp( - maxProbInteraction.getEnergy() / RT - logZ );
 
 	// push to output handler
 	output.add( maxProbInteraction );
@@ -4,8 +4,9 @@
 
 #include "IntaRNA/Predictor.h"
 #include "IntaRNA/InteractionRange.h"
+#include "IntaRNA/Arena4dMatrix.h"
 
-#include <boost/numeric/ublas/matrix.hpp>
+#include <vector>
 
 namespace IntaRNA {
 
@@ -20,13 +21,14 @@ class PredictorMaxProb: public Predictor {
 
 protected:
 
-	//! matrix type to cover the energies for different interaction site widths
-	typedef boost::numeric::ublas::matrix<E_type> E2dMatrix;
-
 	//! full 4D DP-matrix for computation to hold all start position combinations
 	//! first index = start positions (i1,i2) of (seq1,seq2)
-	//! second index = interaction window sizes (w1,w2) or NULL if (i1,i2) not complementary
-	typedef boost::numeric::ublas::matrix< E2dMatrix* > E4dMatrix;
+	//! second index = interaction window sizes (w1,w2) or NULL if (i1,i2) not complementary;
+	//! all 2D blocks are stored within one arena that is reused by predict() calls
+	typedef Arena4dMatrix< E_type > E4dMatrix;
+
+	//! matrix type to cover the energies for different interaction site widths
+	typedef E4dMatrix::Block E2dMatrix;
 
 
 public:
@@ -71,18 +73,29 @@ protected:
 	//! access to the output handler of the super class
 	using Predictor::output;
 
-	//! partition function of all interaction hybrids computed by the recursion with indices
+	//! scaled partition function of all interaction hybrids computed by the recursion with indices
 	//! hybridZ(i1,i2)->(w1,w2), with interaction start i1 (seq1) and i2 (seq2) and
 	//! ineraction end j1=i1+w1 and j2=j2+w2
 	//! NOTE: hybridZ(i1,i2)==NULL if not complementary(seq1[i1],seq2[i2])
+	//! NOTE: entries are scaled by getScale(w1+w2+2) to avoid overflows
 	E4dMatrix hybridZ;
 
-	//! the overall partition function = sum or all hybridZ entries
-	double Z;
+	//! the logarithm of the overall partition function = sum or all hybridZ entries
+	double logZ;
+
+	//! the logarithm of the per-nucleotide scaling factor of hybridZ entries
+	double logScale;
+
+	//! scaling factors getScale(d) = exp(-d*logScale) for all used d
+	std::vector<double> scale;
 
 	//! interaction boundaries with maximal probability
 	InteractionRange maxProbInteraction;
 
+	//! whether or not the prediction tracker is informed via a single
+	//! updateBoundaryZ() call instead of updateOptimumCalled() calls
+	bool trackBoundaryZ;
+
 protected:
 
 	/**
@@ -91,12 +104,74 @@ protected:
 	void
 	clear();
 
+	/**
+	 * Initializes the scaling of the partition functions for the given
+	 * maximal number of nucleotides covered by an interaction
+	 * @param maxLength the maximal number of nucleotides (both sequences)
+	 */
+	void
+	initScale( const size_t maxLength );
+
+	/**
+	 * Access to the scaling factor for partition functions covering the given
+	 * overall number of nucleotides (both sequences)
+	 * @param length the overall number of covered nucleotides
+	 * @return the scaling factor exp(-length*logScale)
+	 */
+	double
+	getScale( const size_t length ) const;
+
 	/**
 	 * computes all entries of the hybridZ matrix
 	 */
 	void
 	fillHybridZ( );
 
+	/**
+	 * computes the hybridZ entries for the given interaction window sizes
+	 * and a block of window starts in the first sequence, which only
+	 * depend on entries of smaller window sizes; the optima are not updated
+	 *
+	 * @param w1 the window size in the first sequence
+	 * @param w2 the window size in the second sequence
+	 * @param i1from the first window start in the first sequence to compute
+	 * @param i1to the window start in the first sequence after the block
+	 */
+	void
+	fillHybridZ( const size_t w1, const size_t w2
+				, const size_t i1from, const size_t i1to );
+
+	//! number of window starts in the first sequence whose hybridZ entries
+	//! are computed within one parallel task
+	static const size_t hybridZRowBlockSize;
+
+	/**
+	 * Converts the scaled hybridization partition functions of all
+	 * interaction boundaries into the Boltzmann weights of the overall
+	 * interaction energies (as computed by updateOptima()) and forwards them
+	 * to the prediction tracker via updateBoundaryZ(). The content of Z is
+	 * overwritten.
+	 *
+	 * @param Z the partition functions to convert (see hybridZ)
+	 * @param minW the minimal window size computed within Z; entries of
+	 *        smaller windows are ignored
+	 */
+	void
+	updateTrackerBoundaryZ( E4dMatrix & Z, const size_t minW );
+
+	/**
+	 * Converts the entries of updateTrackerBoundaryZ() for a block of window
+	 * starts in the first sequence.
+	 *
+	 * @param Z the partition functions to convert (see hybridZ)
+	 * @param minW the minimal window size computed within Z
+	 * @param i1from the first window start in the first sequence to convert
+	 * @param i1to the window start in the first sequence after the block
+	 */
+	void
+	updateTrackerBoundaryZ( E4dMatrix & Z, const size_t minW
+						, const size_t i1from, const size_t i1to );
+
 	/**
 	 * Initializes the interaction site with maximal probability
 	 *
@@ -113,7 +188,8 @@ protected:
 	 * @param j1 the index of the first sequence interacting with j2
 	 * @param i2 the index of the second sequence interacting with i1
 	 * @param j2 the index of the second sequence interacting with j1
-	 * @param Z partition function for the interaction
+	 * @param Z scaled partition function for the interaction, i.e. the
+	 *        partition function times getScale(j1-i1+j2-i2+2)
 	 * @param isHybridZ whether or not the given hybridZ is only for
 	 *        hybridizations (init+loops) or the total interaction energy details
 	 */
@@ -138,6 +214,25 @@ protected:
 
 };
 
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+
+inline
+double
+PredictorMaxProb::
+getScale( const size_t length ) const
+{
+#if INTARNA_IN_DEBUG_MODE
+	if (length >= scale.size()) {
+		throw std::runtime_error("PredictorMaxProb::getScale("+toString(length)+") is out of range");
+	}
+#endif
+	return scale[length];
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 } // namespace
 
 #endif /* INTARNA_PREDICTORMAXPROB_H_ */
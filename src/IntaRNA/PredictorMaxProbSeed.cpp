@@ -0,0 +1,501 @@
+
+#include "IntaRNA/PredictorMaxProbSeed.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace IntaRNA {
+
+////////////////////////////////////////////////////////////////////////////
+
+PredictorMaxProbSeed::
+PredictorMaxProbSeed(
+		const InteractionEnergy & energy
+		, OutputHandler & output
+		, PredictionTracker * predTracker
+		, SeedHandler * seedHandlerInstance )
+ : PredictorMaxProb(energy,output,predTracker)
+	, seedHandler(seedHandlerInstance)
+	, hybridZ_seed()
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+
+PredictorMaxProbSeed::
+~PredictorMaxProbSeed()
+{
+	// clean up
+	this->clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMaxProbSeed::
+predict( const IndexRange & r1
+		, const IndexRange & r2
+		, const OutputConstraint & outConstraint
+		)
+{
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_logOutput)
+#endif
+	{ VLOG(2) <<"predicting maximally probable interactions with seed in O(n^4) space..."; }
+	// measure timing
+	TIMED_FUNC_IF(timerObj,VLOG_IS_ON(9));
+
+	if (outConstraint.reportMax > 1) {
+		INTARNA_NOT_IMPLEMENTED("PredictorMaxProbSeed::predict(reportMax > 1) : not implemented");
+	}
+
+#if INTARNA_IN_DEBUG_MODE
+	// check indices (both regions ascending due to reversing of seq2)
+	if (!(r1.isAscending() && r2.isAscending()) )
+		throw std::runtime_error("PredictorMaxProbSeed::predict("+toString(r1)+","+toString(r2)+") is not sane");
+#endif
+
+	// clear data
+	clear();
+
+	// setup index offset
+	energy.setOffset1(r1.from);
+	energy.setOffset2(r2.from);
+	seedHandler.setOffset1(r1.from);
+	seedHandler.setOffset2(r2.from);
+
+	const size_t hybridZsize1 = std::min( energy.size1()
+			, (r1.to==RnaSequence::lastPos?energy.size1()-1:r1.to)-r1.from+1 );
+	const size_t hybridZsize2 = std::min( energy.size2()
+			, (r2.to==RnaSequence::lastPos?energy.size2()-1:r2.to)-r2.from+1 );
+
+	// compute seed interactions for whole range
+	// and check if any seed possible
+	if (seedHandler.fillSeed( 0, hybridZsize1-1, 0, hybridZsize2-1 ) == 0) {
+		// trigger empty interaction reporting
+		initOptima(outConstraint);
+		reportOptima(outConstraint);
+		// stop computation
+		return;
+	}
+
+	// identify the left ends that are needed for seed-containing interactions
+	// via 2D difference arrays (rectangle updates for each seed start (s1,s2)) :
+	// - hybridZ : left ends within the maximal interaction length right of s
+	// - hybridZ_seed : left ends within the maximal interaction length left of s
+	const size_t maxLength1 = energy.getAccessibility1().getMaxLength();
+	const size_t maxLength2 = energy.getAccessibility2().getMaxLength();
+	const size_t cols = hybridZsize2+1;
+	std::vector<int> needZ( (hybridZsize1+1)*cols, 0 );
+	std::vector<int> needZseed( (hybridZsize1+1)*cols, 0 );
+	size_t s1, s2, from1, from2, to1, to2;
+	for (s1=0; s1<hybridZsize1; s1++) {
+	for (s2=0; s2<hybridZsize2; s2++) {
+		if (E_isINF( seedHandler.getSeedE(s1,s2) )) {
+			continue;
+		}
+		// rectangle [s1,s1+maxLength1-1] x [s2,s2+maxLength2-1]
+		to1 = std::min( hybridZsize1, s1+maxLength1 );
+		to2 = std::min( hybridZsize2, s2+maxLength2 );
+		needZ[s1*cols+s2]++;
+		needZ[s1*cols+to2]--;
+		needZ[to1*cols+s2]--;
+		needZ[to1*cols+to2]++;
+		// rectangle [s1-maxLength1+1,s1] x [s2-maxLength2+1,s2]
+		from1 = s1+1 > maxLength1 ? s1+1-maxLength1 : 0;
+		from2 = s2+1 > maxLength2 ? s2+1-maxLength2 : 0;
+		needZseed[from1*cols+from2]++;
+		needZseed[from1*cols+s2+1]--;
+		needZseed[(s1+1)*cols+from2]--;
+		needZseed[(s1+1)*cols+s2+1]++;
+	}
+	}
+	// prefix sums to get the number of covering rectangles
+	for (s1=0; s1<hybridZsize1; s1++) {
+	for (s2=0; s2<hybridZsize2; s2++) {
+		if (s1 > 0) {
+			needZ[s1*cols+s2] += needZ[(s1-1)*cols+s2];
+			needZseed[s1*cols+s2] += needZseed[(s1-1)*cols+s2];
+		}
+		if (s2 > 0) {
+			needZ[s1*cols+s2] += needZ[s1*cols+s2-1];
+			needZseed[s1*cols+s2] += needZseed[s1*cols+s2-1];
+		}
+		if (s1 > 0 && s2 > 0) {
+			needZ[s1*cols+s2] -= needZ[(s1-1)*cols+s2-1];
+			needZseed[s1*cols+s2] -= needZseed[(s1-1)*cols+s2-1];
+		}
+	}
+	}
+
+	// resize matrix
+	hybridZ.resize( hybridZsize1, hybridZsize2 );
+	hybridZ_seed.resize( hybridZsize1, hybridZsize2 );
+
+	size_t debug_count_cells_null=0, debug_count_cells_nonNull = 0, debug_cellNumber=0;
+
+	size_t maxWidthFori1i2 = 0, w1, w2;
+
+	bool i1blocked, i1or2blocked;
+	// initialize 3rd and 4th dimension of the matrix
+	for (size_t i1=0; i1<hybridZsize1; i1++) {
+		// check if i1 is blocked for interaction
+		i1blocked = !energy.isAccessible1(i1);
+	for (size_t i2=0; i2<hybridZsize2; i2++) {
+		// check whether i1 or i2 is blocked for interaction
+		i1or2blocked = i1blocked || !energy.isAccessible2(i2);
+
+		if (hybridZsize1-i1 < hybridZsize2-i2) {
+			maxWidthFori1i2 = getMaxInteractionWidth( hybridZsize1-i1, energy.getMaxInternalLoopSize1() );
+		} else {
+			maxWidthFori1i2 = getMaxInteractionWidth( hybridZsize2-i2, energy.getMaxInternalLoopSize2() );
+		}
+
+		w1 = std::min(maxLength1, std::min( hybridZsize1-i1, maxWidthFori1i2) );
+		w2 = std::min(maxLength2, std::min( hybridZsize2-i2, maxWidthFori1i2) );
+		debug_cellNumber = w1 * w2;
+
+		// check if i1 and i2 are not blocked and can form a base pair
+		if ( ! i1or2blocked
+			&& energy.areComplementary( i1, i2 ))
+		{
+			// reserve 2d matrices for different interaction site widths if needed
+			if (needZ[i1*cols+i2] > 0) {
+				hybridZ.reserveBlock( i1, i2, w1, w2 );
+				debug_count_cells_nonNull += debug_cellNumber;
+			} else {
+				debug_count_cells_null += debug_cellNumber;
+			}
+			if (needZseed[i1*cols+i2] > 0) {
+				hybridZ_seed.reserveBlock( i1, i2, w1, w2 );
+				debug_count_cells_nonNull += debug_cellNumber;
+			} else {
+				debug_count_cells_null += debug_cellNumber;
+			}
+		} else {
+			// reduce memory consumption and avoid computation for this start index combination
+			debug_count_cells_null += 2*debug_cellNumber;
+		}
+	}
+	}
+	// allocate all 2d matrices at once
+	hybridZ.allocate();
+	hybridZ_seed.allocate();
+
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_logOutput)
+#endif
+	{ LOG(DEBUG) <<"init 2x 4d matrix : "<<debug_count_cells_nonNull <<" to be filled ("
+				<<((double)debug_count_cells_nonNull/(double)(debug_count_cells_nonNull+debug_count_cells_null))
+				<<"%) and "<<debug_count_cells_null <<" not allocated"; }
+
+	// initialize partition function scaling (covering loops and seeds)
+	initScale( std::max( energy.getMaxInternalLoopSize1() + energy.getMaxInternalLoopSize2()
+						, seedHandler.getConstraint().getMaxLength1() + seedHandler.getConstraint().getMaxLength2() )
+				+ 2 );
+
+	// initialize max prob interaction for updates
+	initOptima( outConstraint );
+
+	// fill matrix
+	// compute partition functions WITHOUT seed condition
+	// -> no optima update since updateOptima overwritten
+	fillHybridZ( );
+
+	// compute partition functions WITH seed condition and update optima
+	fillHybridZ_seed( );
+
+	// inform tracker about all interaction boundaries at once
+	if (trackBoundaryZ) {
+		updateTrackerBoundaryZ( hybridZ_seed, seedHandler.getConstraint().getBasePairs()-1 );
+	}
+
+	// report interaction site with maximal probability
+	reportOptima( outConstraint );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMaxProbSeed::
+clear()
+{
+	// clear matrix (memory is kept for reuse)
+	hybridZ_seed.clear();
+	seeds.clear();
+	seedsOfStart.clear();
+
+	// clean up super class data structures
+	PredictorMaxProb::clear();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMaxProbSeed::
+fillHybridZ_seed( )
+{
+
+	// global vars to avoid reallocation
+	size_t i1,i2,j1,j2,w1,w2,k1,k2,s,c,t;
+
+	const size_t seedBP = seedHandler.getConstraint().getBasePairs();
+
+	// enumerate all seeds of the current ranges
+	initSeeds();
+
+	// reset overall partition function
+	logZ = - std::numeric_limits<double>::infinity();
+
+	// current (scaled) Z values
+	double curZ = 0.0, lastZ = 0.0, psiZ = 0.0;
+	// iterate increasingly over all window sizes w1 (seq1) and w2 (seq2)
+	for (w1=0; w1<energy.getAccessibility1().getMaxLength(); w1++) {
+	for (w2=0; w2<energy.getAccessibility2().getMaxLength(); w2++) {
+		// iterate over all window starts i1 (seq1) and i2 (seq2)
+		for (i1=0; i1+w1<hybridZ_seed.size1(); i1++) {
+		for (i2=0; i2+w2<hybridZ_seed.size2(); i2++) {
+			// check if left boundary is complementary and widths are possible
+			if (hybridZ_seed(i1,i2) == NULL || hybridZ_seed(i1,i2)->size1()<=w1 || hybridZ_seed(i1,i2)->size2()<=w2) {
+				// interaction not possible: nothing to do, since no storage reserved
+				continue;
+			}
+
+			// check if window can cover a seed
+			if (w1+1 < seedBP || w2+1 < seedBP) {
+				(*hybridZ_seed(i1,i2))(w1,w2) = 0;
+				continue;
+			}
+
+			// get window ends j1 (seq1) and j2 (seq2)
+			j1=i1+w1;
+			j2=i2+w2;
+
+			// compute entry
+			curZ = 0;
+
+			// base case = interactions whose right-most seed starts at (i1,i2)
+			for (s=seedsOfStart[i1*hybridZ_seed.size2()+i2]; s<seedsOfStart[i1*hybridZ_seed.size2()+i2+1]; s++) {
+				SeedChain & seed = seeds[s];
+				// check if seed fits into the window or contains another seed
+				if (seed.bp.rbegin()->first > j1 || seed.bp.rbegin()->second > j2
+						|| seed.containsSeed)
+				{
+					continue;
+				}
+				// all interactions starting with the seed
+				lastZ = seed.seedZ * getZ( hybridZ, seed.bp.rbegin()->first, seed.bp.rbegin()->second, j1, j2 );
+				// remove all interactions starting with the seed that contain
+				// another seed start right of (i1,i2), decomposed by whether
+				// or not such a seed starts at the seed's base pair t
+				psiZ = getZ( hybridZ_seed, seed.bp.rbegin()->first, seed.bp.rbegin()->second, j1, j2 );
+				for (t=seed.bp.size()-1; t-- > 1; ) {
+					psiZ *= seed.loopZ[t];
+					for (c=0; c<seed.ext[t].size(); c++) {
+						psiZ += getLastZ( seeds[seed.ext[t][c]], j1, j2 );
+					}
+				}
+				lastZ -= seed.loopZ[0] * psiZ;
+				// store (avoid negative values due to rounding)
+				if (lastZ > 0) {
+					seed.lastZ[w1*seed.lastZcols+w2] = (E_type)lastZ;
+					curZ += lastZ;
+				}
+			}
+
+			// sum all combinations of decompositions into (i1,i2)..(k1,k2)-(j1,j2)
+			// where k1..j1 contains a seed
+			for (k1=std::min(j1-seedBP+1,i1+energy.getMaxInternalLoopSize1()+1); k1>i1; k1--) {
+			for (k2=std::min(j2-seedBP+1,i2+energy.getMaxInternalLoopSize2()+1); k2>i2; k2--) {
+				// check if (k1,k2) are valid left boundaries including a seed
+				if ( hybridZ_seed(k1,k2) != NULL
+						&& j1-k1 < hybridZ_seed(k1,k2)->size1()
+						&& j2-k2 < hybridZ_seed(k1,k2)->size2() )
+				{
+					curZ += (double)energy.getBoltzmannWeight(energy.getE_interLeft(i1,k1,i2,k2))
+							* getScale((k1-i1)+(k2-i2))
+							* (double)((*hybridZ_seed(k1,k2))(j1-k1,j2-k2));
+				}
+			}
+			}
+
+			// store value
+			(*hybridZ_seed(i1,i2))(w1,w2) = (E_type)curZ;
+			// update max prob interaction (call super class)
+			PredictorMaxProb::updateOptima( i1,j1,i2,j2, (*hybridZ_seed(i1,i2))(w1,w2), true );
+		}
+		}
+	}
+	}
+
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMaxProbSeed::
+initSeeds( )
+{
+	seeds.clear();
+	seedsOfStart.assign( hybridZ_seed.size1()*hybridZ_seed.size2()+1, 0 );
+
+	const bool isExplicit = !seedHandler.getConstraint().getExplicitSeeds().empty();
+
+	size_t i1, i2, s, c, t;
+	for (i1=0; i1<hybridZ_seed.size1(); i1++) {
+	for (i2=0; i2<hybridZ_seed.size2(); i2++) {
+		seedsOfStart[i1*hybridZ_seed.size2()+i2] = seeds.size();
+		// check if any seed starts at (i1,i2)
+		if (hybridZ_seed(i1,i2) == NULL || E_isINF( seedHandler.getSeedE(i1,i2) )) {
+			continue;
+		}
+		SeedChain seed;
+		seed.bp.push_back( std::make_pair( i1, i2 ) );
+		seed.seedZ = 1.0;
+		seed.containsSeed = false;
+		seed.lastZcols = 0;
+		if (isExplicit) {
+			// explicit seeds are unique for each start -> trace back base pairs
+			Interaction interaction( energy.getAccessibility1().getSequence()
+					, energy.getAccessibility2().getAccessibilityOrigin().getSequence() );
+			seedHandler.traceBackSeed( interaction, i1, i2 );
+			for (Interaction::PairingVec::const_iterator bp = interaction.basePairs.begin(); bp != interaction.basePairs.end(); bp++) {
+				seed.bp.push_back( std::make_pair( energy.getIndex1(*bp), energy.getIndex2(*bp) ) );
+			}
+			seed.bp.push_back( std::make_pair( i1+seedHandler.getSeedLength1(i1,i2)-1
+											, i2+seedHandler.getSeedLength2(i1,i2)-1 ) );
+			// get loop weights
+			for (t=0; t+1<seed.bp.size(); t++) {
+				seed.loopZ.push_back( (double)energy.getBoltzmannWeight( energy.getE_interLeft(
+											seed.bp[t].first, seed.bp[t+1].first
+											, seed.bp[t].second, seed.bp[t+1].second ) )
+						* getScale( (seed.bp[t+1].first-seed.bp[t].first) + (seed.bp[t+1].second-seed.bp[t].second) ) );
+				seed.seedZ *= *seed.loopZ.rbegin();
+			}
+			seed.ext.resize( seed.bp.size() );
+			seeds.push_back( seed );
+		} else {
+			// enumerate all seeds starting at (i1,i2)
+			initSeeds( seed, 0.0, 0, 0 );
+		}
+	}
+	}
+	seedsOfStart[hybridZ_seed.size1()*hybridZ_seed.size2()] = seeds.size();
+
+	// identify for each seed the seeds starting within that share its
+	// remaining base pairs
+	for (s=0; s<seeds.size(); s++) {
+		SeedChain & seed = seeds[s];
+		for (t=1; t+1<seed.bp.size(); t++) {
+			const size_t startIdx = seed.bp[t].first*hybridZ_seed.size2()+seed.bp[t].second;
+			for (c=seedsOfStart[startIdx]; c<seedsOfStart[startIdx+1]; c++) {
+				const SeedChain & other = seeds[c];
+				// check if the other seed ends within this seed
+				if (other.bp.size() <= seed.bp.size()-t) {
+					// all interactions starting with this seed contain the other seed
+					if (std::equal( other.bp.begin(), other.bp.end(), seed.bp.begin()+t )) {
+						seed.containsSeed = true;
+					}
+				} else
+				// check if the other seed starts with this seed's base pairs
+				if (std::equal( seed.bp.begin()+t, seed.bp.end(), other.bp.begin() )) {
+					seed.ext[t].push_back( c );
+				}
+			}
+		}
+		// storage of the partition functions without further seed start
+		seed.lastZcols = hybridZ_seed(seed.bp.begin()->first,seed.bp.begin()->second)->size2();
+		seed.lastZ.assign( hybridZ_seed(seed.bp.begin()->first,seed.bp.begin()->second)->size1()*seed.lastZcols, 0 );
+	}
+
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_logOutput)
+#endif
+	{ VLOG(2) <<"seeds = "<<seeds.size(); }
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMaxProbSeed::
+initSeeds( SeedChain & seed, const E_type hybridE
+		, const size_t u1, const size_t u2 )
+{
+	const SeedConstraint & seedConstraint = seedHandler.getConstraint();
+
+	// current seed boundaries
+	const size_t i1 = seed.bp.begin()->first, i2 = seed.bp.begin()->second;
+	const size_t p1 = seed.bp.rbegin()->first, p2 = seed.bp.rbegin()->second;
+
+	// check if seed is complete
+	if (seed.bp.size() == seedConstraint.getBasePairs()) {
+		// check if this index range is to be considered for seed search
+		if ( (!seedConstraint.getRanges1().empty()
+				&& !seedConstraint.getRanges1().covers( i1+energy.getOffset1(), p1+energy.getOffset1() ))
+			|| (!seedConstraint.getRanges2().empty()
+				&& !seedConstraint.getRanges2().covers( i2+energy.getOffset2(), p2+energy.getOffset2() )) )
+		{
+			return;
+		}
+		// check ED boundary
+		if (energy.getED1(i1,p1) > seedConstraint.getMaxED()
+				|| energy.getED2(i2,p2) > seedConstraint.getMaxED() )
+		{
+			return;
+		}
+		// check overall interaction energy of the seed
+		const E_type seedE = energy.getE( i1, p1, i2, p2, hybridE ) + energy.getE_init();
+		if (E_isINF(seedE) || seedE > seedConstraint.getMaxE()) {
+			return;
+		}
+		// store seed
+		seed.ext.resize( seed.bp.size() );
+		seeds.push_back( seed );
+		seed.ext.clear();
+		return;
+	}
+
+	// extend seed by all feasible next base pairs (k1,k2)
+	size_t k1, k2, u1p, u2p;
+	for (u1p=0; u1+u1p <= seedConstraint.getMaxUnpaired1() && u1p <= energy.getMaxInternalLoopSize1(); u1p++) {
+		k1 = p1+1+u1p;
+		if (k1 >= hybridZ_seed.size1()) {
+			break;
+		}
+	for (u2p=0; u2+u2p <= seedConstraint.getMaxUnpaired2() && u2p <= energy.getMaxInternalLoopSize2()
+				&& u1+u1p+u2+u2p <= seedConstraint.getMaxUnpairedOverall(); u2p++)
+	{
+		k2 = p2+1+u2p;
+		if (k2 >= hybridZ_seed.size2()) {
+			break;
+		}
+		// check if base pair can be part of an interaction
+		if (!(energy.isAccessible1(k1) && energy.isAccessible2(k2) && energy.areComplementary(k1,k2))) {
+			continue;
+		}
+		const E_type loopE = energy.getE_interLeft( p1, k1, p2, k2 );
+		if (E_isINF(loopE)) {
+			continue;
+		}
+		// extend seed
+		const double prevSeedZ = seed.seedZ;
+		seed.bp.push_back( std::make_pair( k1, k2 ) );
+		seed.loopZ.push_back( (double)energy.getBoltzmannWeight(loopE) * getScale( u1p+u2p+2 ) );
+		seed.seedZ *= *seed.loopZ.rbegin();
+		initSeeds( seed, hybridE+loopE, u1+u1p, u2+u2p );
+		// undo extension
+		seed.seedZ = prevSeedZ;
+		seed.loopZ.pop_back();
+		seed.bp.pop_back();
+	}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+
+} // namespace
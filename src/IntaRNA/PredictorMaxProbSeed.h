@@ -0,0 +1,269 @@
+
+#ifndef INTARNA_PREDICTORMAXPROBSEED_H_
+#define INTARNA_PREDICTORMAXPROBSEED_H_
+
+#include "IntaRNA/PredictorMaxProb.h"
+#include "IntaRNA/SeedHandlerIdxOffset.h"
+
+#include <utility>
+#include <vector>
+
+namespace IntaRNA {
+
+/**
+ * Computes the interaction site with maximal probability among all interaction
+ * sites that contain a seed interaction (see PredictorMaxProb).
+ *
+ * The partition function of seed-containing interactions is decomposed via
+ * the right-most seed start of each interaction, i.e. all seeds (not only
+ * the mfe seed) of a left end are combined with the partition function of
+ * all interactions to their right that do not contain a further seed start.
+ * Thus, each interaction is counted exactly once independently of the number
+ * of seeds it contains. Note, all base pairs of a seed have to be accessible
+ * to be considered.
+ *
+ * Only the 2D blocks of left ends (i1,i2) that are within the maximal
+ * interaction length of a seed are allocated and computed.
+ *
+ * @author Martin Mann
+ *
+ */
+class PredictorMaxProbSeed: public PredictorMaxProb {
+
+public:
+
+	/**
+	 * Constructs a predictor and stores the energy and output handler
+	 *
+	 * @param energy the interaction energy handler
+	 * @param output the output handler to report optimal interactions to
+	 * @param predTracker the prediction tracker to be used or NULL if no
+	 *         tracking is to be done; if non-NULL, the tracker gets deleted
+	 *         on this->destruction.
+	 * @param seedHandler the seed handler to be used for seed identification
+	 */
+	PredictorMaxProbSeed( const InteractionEnergy & energy
+					, OutputHandler & output
+					, PredictionTracker * predTracker
+					, SeedHandler * seedHandler );
+
+	virtual ~PredictorMaxProbSeed();
+
+	/**
+	 * Computes the interaction site with maximal probability among all sites
+	 * containing a seed for the given sequence ranges (i1-j1) in the first
+	 * sequence and (i2-j2) in the second sequence and reports it to the output
+	 * handler.
+	 *
+	 * @param r1 the index range of the first sequence interacting with r2
+	 * @param r2 the index range of the second sequence interacting with r1
+	 * @param outConstraint constrains the interactions reported to the output handler
+	 *
+	 */
+	virtual
+	void
+	predict( const IndexRange & r1 = IndexRange(0,RnaSequence::lastPos)
+			, const IndexRange & r2 = IndexRange(0,RnaSequence::lastPos)
+			, const OutputConstraint & outConstraint = OutputConstraint() );
+
+protected:
+
+	//! access to the interaction energy handler of the super class
+	using PredictorMaxProb::energy;
+
+	//! access to the output handler of the super class
+	using PredictorMaxProb::output;
+
+	//! scaled partition function of all interaction hybrids with indices
+	//! hybridZ(i1,i2)->(w1,w2) that do not necessarily contain a seed
+	//! (see PredictorMaxProb)
+	using PredictorMaxProb::hybridZ;
+
+	//! the seed handler (with idx offset)
+	SeedHandlerIdxOffset seedHandler;
+
+	//! scaled partition function of all interaction hybrids that contain a
+	//! seed interaction with indices hybridZ_seed(i1,i2)->(w1,w2), with
+	//! interaction start i1 (seq1) and i2 (seq2) and interaction end
+	//! j1=i1+w1 and j2=j2+w2
+	//! NOTE: hybridZ_seed(i1,i2)==NULL if not complementary(seq1[i1],seq2[i2])
+	//! or no seed can start within the maximal interaction length
+	//! NOTE: entries are scaled by getScale(w1+w2+2) to avoid overflows
+	E4dMatrix hybridZ_seed;
+
+	/**
+	 * A seed interaction, i.e. a chain of seed base pairs that fulfills the
+	 * seed constraint
+	 */
+	class SeedChain {
+	public:
+		//! the base pairs of the seed (shifted by the index offset)
+		std::vector< std::pair<size_t,size_t> > bp;
+		//! scaled Boltzmann weights of the loops (bp[t],bp[t+1]) of the seed
+		std::vector<double> loopZ;
+		//! scaled Boltzmann weight of the whole seed
+		double seedZ;
+		//! for each base pair index t the indices of all seeds (within seeds)
+		//! that start at bp[t] and begin with the base pairs bp[t..]
+		//! (empty for t==0)
+		std::vector< std::vector<size_t> > ext;
+		//! scaled partition function of all interactions starting with the
+		//! seed that contain no further seed start, indexed via
+		//! (w1,w2) -> w1*lastZcols+w2 relative to bp[0]
+		std::vector<E_type> lastZ;
+		//! the number of columns of lastZ
+		size_t lastZcols;
+		//! whether or not another seed starts and ends within the seed
+		bool containsSeed;
+	};
+
+	//! all seeds of the current ranges ordered by their left-most base pair
+	std::vector<SeedChain> seeds;
+
+	//! the seeds starting at (i1,i2) are given by the indices in the interval
+	//! [ seedsOfStart[i1*hybridZ_seed.size2()+i2]
+	//!   , seedsOfStart[i1*hybridZ_seed.size2()+i2+1] ) within seeds
+	std::vector<size_t> seedsOfStart;
+
+protected:
+
+	/**
+	 * Removes all temporary data structures and resets the predictor
+	 */
+	void
+	clear();
+
+	/**
+	 * does nothing but to ignore the calls from fillHybridZ()
+	 *
+	 * @param i1 the index of the first sequence interacting with i2
+	 * @param j1 the index of the first sequence interacting with j2
+	 * @param i2 the index of the second sequence interacting with i1
+	 * @param j2 the index of the second sequence interacting with j1
+	 * @param Z ignored
+	 * @param isHybridZ ignored
+	 */
+	virtual
+	void
+	updateOptima( const size_t i1, const size_t j1
+			, const size_t i2, const size_t j2
+			, const E_type Z
+			, const bool isHybridZ );
+
+	/**
+	 * computes all entries of the hybridZ_seed matrix and updates the
+	 * interaction site with maximal probability
+	 */
+	void
+	fillHybridZ_seed( );
+
+	/**
+	 * Enumerates all seeds that can be part of an interaction within the
+	 * current ranges and stores them in seeds and seedsOfStart.
+	 * Requires initialized scaling factors (see initScale()).
+	 */
+	void
+	initSeeds( );
+
+	/**
+	 * Recursively extends the given partial seed by all feasible base pairs
+	 * and stores each complete and valid seed in seeds.
+	 *
+	 * @param seed the partial seed to extend (bp, loopZ and seedZ are set)
+	 * @param hybridE the hybridization energy of the loops of the partial seed
+	 * @param u1 the number of unpaired bases of seq1 used so far
+	 * @param u2 the number of unpaired bases of seq2 used so far
+	 */
+	void
+	initSeeds( SeedChain & seed, const E_type hybridE
+			, const size_t u1, const size_t u2 );
+
+	/**
+	 * Provides the scaled partition function entry for the given boundaries
+	 *
+	 * @param Z the 4D matrix to access
+	 * @param i1 the left end in seq1
+	 * @param i2 the left end in seq2
+	 * @param j1 the right end in seq1
+	 * @param j2 the right end in seq2
+	 * @return Z(i1,i2)->(j1-i1,j2-i2) or 0 if no such entry is available
+	 */
+	static
+	double
+	getZ( const E4dMatrix & Z
+			, const size_t i1, const size_t i2
+			, const size_t j1, const size_t j2 );
+
+	/**
+	 * Provides the scaled partition function of all interactions up to
+	 * (j1,j2) that start with the given seed and contain no further seed start
+	 *
+	 * @param seed the seed of interest
+	 * @param j1 the right end in seq1
+	 * @param j2 the right end in seq2
+	 * @return the according partition function or 0 if not available
+	 */
+	static
+	double
+	getLastZ( const SeedChain & seed, const size_t j1, const size_t j2 );
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+
+inline
+void
+PredictorMaxProbSeed::
+updateOptima( const size_t i1, const size_t j1
+		, const size_t i2, const size_t j2
+		, const E_type Z
+		, const bool isHybridZ )
+{
+	// do nothing and ignore calls from fillHybridZ()
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+double
+PredictorMaxProbSeed::
+getZ( const E4dMatrix & Z
+		, const size_t i1, const size_t i2
+		, const size_t j1, const size_t j2 )
+{
+	if ( j1 < i1 || j2 < i2 || i1 >= Z.size1() || i2 >= Z.size2()
+			|| Z(i1,i2) == NULL
+			|| j1-i1 >= Z(i1,i2)->size1()
+			|| j2-i2 >= Z(i1,i2)->size2() )
+	{
+		return 0.0;
+	}
+	return (double)((*Z(i1,i2))(j1-i1,j2-i2));
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+double
+PredictorMaxProbSeed::
+getLastZ( const SeedChain & seed, const size_t j1, const size_t j2 )
+{
+	// check if the seed fits into the boundaries
+	if ( j1 < seed.bp.rbegin()->first || j2 < seed.bp.rbegin()->second ) {
+		return 0.0;
+	}
+	const size_t w1 = j1-seed.bp.begin()->first;
+	const size_t w2 = j2-seed.bp.begin()->second;
+	if ( w2 >= seed.lastZcols || w1*seed.lastZcols+w2 >= seed.lastZ.size() ) {
+		return 0.0;
+	}
+	return (double)seed.lastZ[w1*seed.lastZcols+w2];
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_PREDICTORMAXPROBSEED_H_ */
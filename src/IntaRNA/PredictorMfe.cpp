@@ -1,8 +1,12 @@
 
 #include "IntaRNA/PredictorMfe.h"
+#include "IntaRNA/Telemetry.h"
+#include "IntaRNA/InteractionEnergyVrna.h"
+#include "IntaRNA/InteractionEnergyBasePair.h"
 
 #include <iostream>
 #include <algorithm>
+#include <exception>
 
 namespace IntaRNA {
 
@@ -15,11 +19,24 @@ PredictorMfe::PredictorMfe(
 		)
 	: Predictor(energy,output,predTracker)
 	, mfeInteractions()
+	, mfeInteractionsStored()
+	, mfeInteractionsMax(0)
+	, mfeInteractionsMaxE(E_INF)
 	, reportedInteractions()
 	, minStackingEnergy( energy.getBestE_interLoop() )
 	, minInitEnergy( energy.getE_init() )
 	, minDangleEnergy( energy.getBestE_dangling() )
 	, minEndEnergy( energy.getBestE_end() )
+	, pruning(false)
+	, pruningByOptima(false)
+	, symmetric(false)
+	, pruningCellsEvaluated(0)
+	, pruningCellsPruned(0)
+	, workCounters()
+	, pruningMinED1()
+	, pruningMinED2()
+	, energyVrna( dynamic_cast<const InteractionEnergyVrna*>(&energy) )
+	, energyBasePair( dynamic_cast<const InteractionEnergyBasePair*>(&energy) )
 {
 
 }
@@ -30,6 +47,40 @@ PredictorMfe::~PredictorMfe()
 {
 }
 
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMfe::
+setPruning( const bool enable )
+{
+	pruning = enable;
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+PredictorMfe::
+isCanonical( const size_t i1, const size_t j1
+			, const size_t i2, const size_t j2 ) const
+{
+	// original indices : (first in seq1, last in seq2) and (last in seq1, first in seq2)
+	const Interaction::BasePair left = energy.getBasePair( i1, i2 );
+	const Interaction::BasePair right = energy.getBasePair( j1, j2 );
+	return left.first < right.second
+			|| (left.first == right.second && right.first <= left.second);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+PredictorMfe::
+canEndCanonical( const size_t j1, const size_t j2 ) const
+{
+	// original indices : (last in seq1, first in seq2)
+	const Interaction::BasePair right = energy.getBasePair( j1, j2 );
+	return right.first < right.second + energy.getAccessibility1().getMaxLength();
+}
 
 ////////////////////////////////////////////////////////////////////////////
 
@@ -37,26 +88,20 @@ void
 PredictorMfe::
 initOptima( const OutputConstraint & outConstraint )
 {
-	// resize to the given number of interactions if overlapping reports allowed
-	mfeInteractions.resize(outConstraint.reportOverlap!=OutputConstraint::ReportOverlap::OVERLAP_BOTH ? 1 : outConstraint.reportMax
-			, Interaction(energy.getAccessibility1().getSequence()
-					,energy.getAccessibility2().getAccessibilityOrigin().getSequence())
-			);
-
-	// init all interactions to be filled
-	for (InteractionList::iterator i = mfeInteractions.begin(); i!= mfeInteractions.end(); i++) {
-		// initialize global E minimum : should be below 0.0
-		i->energy = outConstraint.maxE;
-		// ensure it holds only the boundary
-		if (i->basePairs.size()!=2) {
-			i->basePairs.resize(2);
-		}
-		// reset boundary base pairs
-		i->basePairs[0].first = RnaSequence::lastPos;
-		i->basePairs[0].second = RnaSequence::lastPos;
-		i->basePairs[1].first = RnaSequence::lastPos;
-		i->basePairs[1].second = RnaSequence::lastPos;
-	}
+	// number of interactions to store (all if overlapping reports allowed)
+	mfeInteractionsMax = outConstraint.reportOverlap!=OutputConstraint::ReportOverlap::OVERLAP_BOTH ? 1 : outConstraint.reportMax;
+	// initialize global E minimum : should be below 0.0
+	mfeInteractionsMaxE = outConstraint.maxE;
+	// non-overlapping suboptimals are enumerated from the matrices later on,
+	// i.e. only the maximal energy bounds the interactions to be reported
+	pruningByOptima = outConstraint.reportOverlap==OutputConstraint::ReportOverlap::OVERLAP_BOTH || outConstraint.reportMax <= 1;
+	// only one of two symmetric interactions for identical sequences
+	symmetric = outConstraint.symmetric;
+
+	// clear heap (keeps the capacity)
+	mfeInteractions.clear();
+	mfeInteractions.reserve( mfeInteractionsMax );
+	mfeInteractionsStored.clear();
 
 	// clear reported interaction ranges
 	reportedInteractions.first.clear();
@@ -76,20 +121,11 @@ updateOptima( const size_t i1, const size_t j1
 //	LOG(DEBUG) <<"PredictorMfe::updateOptima( "<<i1<<"-"<<j1<<", "<<i2<<"-"<<j2<<" , E = " <<interE;
 
 	// check if nothing to be done
-	if (mfeInteractions.size() == 0) {
-		// report call if needed
-		if (predTracker != NULL) {
-			// get final energy of current interaction
-			E_type curE = isHybridE ? energy.getE( i1,j1, i2,j2, interE ) : interE;
-			if (E_isNotINF(curE)) {
-				// inform about prediction
-				predTracker->updateOptimumCalled( i1 + (i1==RnaSequence::lastPos ? 0 : energy.getOffset1())
-												, j1 + (j1==RnaSequence::lastPos ? 0 : energy.getOffset1())
-												, i2 + (i2==RnaSequence::lastPos ? 0 : energy.getOffset2())
-												, j2 + (j2==RnaSequence::lastPos ? 0 : energy.getOffset2())
-												, curE );
-			}
-		}
+	if (mfeInteractionsMax == 0 && predTracker == NULL) {
+		return;
+	}
+	// the symmetric interaction is considered instead
+	if (symmetric && !isCanonical( i1, j1, i2, j2 )) {
 		return;
 	}
 
@@ -107,77 +143,195 @@ updateOptima( const size_t i1, const size_t j1
 										, curE );
 	}
 
-	if (mfeInteractions.size() == 1) {
-		if (curE < mfeInteractions.begin()->energy) {
+	// check if within range of the interactions to store
+	if (!(curE < mfeInteractionsMaxE)) {
+		return;
+	}
+
+	if (mfeInteractionsMax == 1) {
+		// store new global min
+		if (mfeInteractions.empty()) {
+			mfeInteractions.push_back( OptimumBoundary( curE, i1,j1, i2,j2 ) );
+			INTARNA_COUNT_WORK( workCounters.optimaUpdates++ );
+		} else if (curE < mfeInteractions.begin()->energy) {
 //			LOG(DEBUG) <<"PredictorMfe::updateOptima() : new mfe ( "
 //				<<i1<<"-"<<j1<<", "<<i2<<"-"<<j2<<" ) = " <<interE <<" : "<<curE;
-			// store new global min
-			mfeInteractions.begin()->energy = (curE);
-			// store interaction boundaries
-			// left
-			mfeInteractions.begin()->basePairs[0] = energy.getBasePair(i1,i2);
-			// right
-			mfeInteractions.begin()->basePairs[1] = energy.getBasePair(j1,j2);
+			*(mfeInteractions.begin()) = OptimumBoundary( curE, i1,j1, i2,j2 );
+			INTARNA_COUNT_WORK( workCounters.optimaUpdates++ );
+		}
+	} else if (mfeInteractionsMax > 1) {
+
+		// check if within range of already known suboptimals (< E(worst==front))
+		const bool heapFull = mfeInteractions.size() == mfeInteractionsMax;
+		if (heapFull && !(curE < mfeInteractions.begin()->energy)) {
+			return;
 		}
-	} else {
-
-		// check if within range of already known suboptimals (< E(worst==last))
-		if (curE < mfeInteractions.rbegin()->energy) {
-
-			// identify sorted insertion position (iterator to position AFTER insertion)
-			InteractionList::iterator toInsert = --(mfeInteractions.end());
-			InteractionList::iterator insertSuccPos =
-					std::upper_bound(mfeInteractions.begin(), toInsert
-								, curE
-								, Interaction::compareEnergy );
-
-			// check if not already within list
-			bool isToBeInserted = insertSuccPos == mfeInteractions.begin();
-			if (!isToBeInserted) {
-				// go to preceeding interaction to check for equivalence
-				--insertSuccPos;
-				// check if not equal
-				isToBeInserted =
-						// check energy
-						! E_equal(curE,insertSuccPos->energy)
-						// check boundaries
-						&& insertSuccPos->basePairs.at(0) != energy.getBasePair(i1,i2)
-						&& insertSuccPos->basePairs.at(1) != energy.getBasePair(j1,j2)
-						;
-				// restore insert position
-				++insertSuccPos;
+
+		// check if not equivalent to the stored interaction with the next
+		// lower or equal energy, i.e. no equal energy and no common end
+		const OptimumBoundary cur( curE, i1,j1, i2,j2 );
+		std::set< OptimumBoundary >::const_iterator pred = mfeInteractionsStored.upper_bound(
+				OptimumBoundary( curE, RnaSequence::lastPos, RnaSequence::lastPos, RnaSequence::lastPos, RnaSequence::lastPos ) );
+		if (pred != mfeInteractionsStored.begin()) {
+			--pred;
+			if ( E_equal( curE, pred->energy )
+				|| (pred->i1 == i1 && pred->i2 == i2)
+				|| (pred->j1 == j1 && pred->j2 == j2) )
+			{
+				return;
 			}
+		}
+		mfeInteractionsStored.insert( cur );
+
+		// remove worst interaction if needed
+		if (heapFull) {
+			std::pop_heap( mfeInteractions.begin(), mfeInteractions.end() );
+			mfeInteractionsStored.erase( mfeInteractions.back() );
+			mfeInteractions.pop_back();
+		}
+		// insert current interaction
+		mfeInteractions.push_back( cur );
+		std::push_heap( mfeInteractions.begin(), mfeInteractions.end() );
+		INTARNA_COUNT_WORK( workCounters.optimaUpdates++ );
+	}
+}
 
-			// insert current interaction into lowest energy interaction list
-			if (isToBeInserted) {
+////////////////////////////////////////////////////////////////////////////
 
-				// overwrite last list element
-				// set current energy
-				toInsert->energy = (curE);
-				// store interaction boundaries
-				// left
-				toInsert->basePairs[0] = energy.getBasePair(i1,i2);
-				// right
-				toInsert->basePairs[1] = energy.getBasePair(j1,j2);
+E_type
+PredictorMfe::
+getOptimumE() const
+{
+	E_type mfe = mfeInteractionsMaxE;
+	for (std::vector<OptimumBoundary>::const_iterator b = mfeInteractions.begin(); b != mfeInteractions.end(); b++) {
+		mfe = std::min( mfe, b->energy );
+	}
+	return mfe;
+}
 
-				// relocate last element within list (no reallocation needed, just list-link-update)
-				mfeInteractions.splice( insertSuccPos, mfeInteractions, toInsert );
-			}
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMfe::
+initPruning( const size_t size1, const size_t size2 )
+{
+	// reset statistics
+	pruningCellsEvaluated = 0;
+	pruningCellsPruned = 0;
 
+	pruningMinED1.clear();
+	pruningMinED2.clear();
+	if (!pruning || predTracker != NULL) {
+		return;
+	}
+
+	// minimal ED of all ranges covering a position, computed for each left
+	// end via the suffix minima over the right ends
+	const size_t maxLength1 = energy.getAccessibility1().getMaxLength();
+	pruningMinED1.resize( size1, E_INF );
+	for (size_t i1=0; i1<size1; i1++) {
+		E_type minED = E_INF;
+		for (size_t j1=std::min(size1,i1+maxLength1); j1-- > i1; ) {
+			minED = std::min( minED, energy.getED1( i1, j1 ) );
+			pruningMinED1[j1] = std::min( pruningMinED1[j1], minED );
+		}
+	}
+	const size_t maxLength2 = energy.getAccessibility2().getMaxLength();
+	pruningMinED2.resize( size2, E_INF );
+	for (size_t i2=0; i2<size2; i2++) {
+		E_type minED = E_INF;
+		for (size_t j2=std::min(size2,i2+maxLength2); j2-- > i2; ) {
+			minED = std::min( minED, energy.getED2( i2, j2 ) );
+			pruningMinED2[j2] = std::min( pruningMinED2[j2], minED );
 		}
 	}
 }
 
 ////////////////////////////////////////////////////////////////////////////
 
+E_type
+PredictorMfe::
+getPruningBound() const
+{
+	// check if pruning is to be done
+	if (!pruning || predTracker != NULL) {
+		return E_INF;
+	}
+	// check if the worst stored optimum bounds the interactions to report
+	if (pruningByOptima && mfeInteractionsMax > 0 && mfeInteractions.size() == mfeInteractionsMax) {
+		return std::min( mfeInteractionsMaxE, mfeInteractions.begin()->energy );
+	}
+	return mfeInteractionsMaxE;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMfe::
+reportPruning() const
+{
+	if (pruningCellsEvaluated == 0) {
+		return;
+	}
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_logOutput)
+#endif
+	{ VLOG(1) <<"pruning : "<<pruningCellsPruned<<" of "<<pruningCellsEvaluated<<" evaluated cells pruned ("
+				<<(100.0*(double)pruningCellsPruned/(double)pruningCellsEvaluated)<<"%)"; }
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMfe::
+reportWork()
+{
+#if INTARNA_WORK_COUNTERS
+	if (workCounters.empty()) {
+		return;
+	}
+	Telemetry::addWork( workCounters );
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_logOutput)
+#endif
+	{ VLOG(1) <<"work : "<<workCounters; }
+	workCounters.clear();
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+PredictorMfe::
+isTraceBackConcurrent() const
+{
+	return false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 void
 PredictorMfe::
 reportOptima( const OutputConstraint & outConstraint )
 {
+	// report the work of the recursion
+	reportWork();
+
+	// measure traceback and reporting
+	Telemetry::Timer telemetryTimer( Telemetry::TRACEBACK );
+
+	// sort stored interactions by increasing energy
+	std::sort_heap( mfeInteractions.begin(), mfeInteractions.end() );
+
 	// number of reported interactions
 	size_t reported = 0;
 	// get maximal report energy = mfe + deltaE + precisionEpsilon
-	const E_type maxE = std::min(outConstraint.maxE, (E_type)(mfeInteractions.begin()->energy + outConstraint.deltaE + E_precisionEpsilon));
+	const E_type maxE = std::min(outConstraint.maxE, (E_type)(getOptimumE() + outConstraint.deltaE + E_precisionEpsilon));
+
+	// interaction to be reported (filled from boundaries)
+	Interaction curBest( energy.getAccessibility1().getSequence()
+					, energy.getAccessibility2().getAccessibilityOrigin().getSequence() );
+	curBest.basePairs.resize(2);
 
 	// clear reported interaction ranges
 	reportedInteractions.first.clear();
@@ -186,7 +340,12 @@ reportOptima( const OutputConstraint & outConstraint )
 	// check if non-overlapping output is wanted
 	if (outConstraint.reportOverlap!=OutputConstraint::ReportOverlap::OVERLAP_BOTH) {
 		// check if mfe is worth reporting
-		Interaction curBest = *mfeInteractions.begin();
+		curBest.energy = mfeInteractionsMaxE;
+		if (!mfeInteractions.empty()) {
+			curBest.energy = mfeInteractions.begin()->energy;
+			curBest.basePairs[0] = energy.getBasePair( mfeInteractions.begin()->i1, mfeInteractions.begin()->i2 );
+			curBest.basePairs[1] = energy.getBasePair( mfeInteractions.begin()->j1, mfeInteractions.begin()->j2 );
+		}
 		while( curBest.energy < maxE && reported < outConstraint.reportMax ) {
 			// report current best
 			// fill interaction with according base pairs
@@ -225,33 +384,66 @@ reportOptima( const OutputConstraint & outConstraint )
 	{
 
 		// report all (possibly overlapping) interactions with energy below 0
-		assert(outConstraint.reportMax <= mfeInteractions.size());
-		for (InteractionList::iterator i = mfeInteractions.begin();
-				reported < outConstraint.reportMax
+		assert(mfeInteractions.size() <= outConstraint.reportMax);
+		// collect all interactions within the allowed energy range
+		std::vector< Interaction > toReport;
+		toReport.reserve( std::min( mfeInteractions.size(), outConstraint.reportMax ) );
+		for (std::vector<OptimumBoundary>::const_iterator i = mfeInteractions.begin();
+				toReport.size() < outConstraint.reportMax
 				&& i!= mfeInteractions.end(); i++)
 		{
 			// check if interaction is within allowed energy range
 			if (i->energy < maxE) {
+				// fill interaction from boundaries
+				toReport.push_back( Interaction( *(curBest.s1), *(curBest.s2) ) );
+				toReport.rbegin()->energy = i->energy;
+				toReport.rbegin()->basePairs.resize(2);
+				toReport.rbegin()->basePairs[0] = energy.getBasePair( i->i1, i->i2 );
+				toReport.rbegin()->basePairs[1] = energy.getBasePair( i->j1, i->j2 );
+			}
+		}
 
-				// fill mfe interaction with according base pairs
-				traceBack( *i, outConstraint );
-				// report mfe interaction
-				output.add( *i );
-				// count
-				reported++;
+		// fill interactions with according base pairs
+		// (concurrently if the traceback only reads the filled matrices)
+		const bool concurrentTraceBack = isTraceBackConcurrent();
+		// exceptions of the tracebacks (forwarded after all are done)
+		std::vector< std::exception_ptr > failed( toReport.size(), NULL );
+		for (size_t r = 0; r < toReport.size(); r++) {
+#if INTARNA_MULITHREADING
+			#pragma omp task firstprivate(r) shared(toReport,failed,outConstraint) if(concurrentTraceBack && toReport.size() > 1)
+#endif
+			{
+				try {
+					traceBack( toReport[r], outConstraint );
+				} catch (...) {
+					failed[r] = std::current_exception();
+				}
+			}
+		}
+#if INTARNA_MULITHREADING
+		#pragma omp taskwait
+#endif
+		for (size_t r = 0; r < toReport.size(); r++) {
+			if (failed.at(r) != NULL) {
+				std::rethrow_exception( failed.at(r) );
 			}
 		}
+
+		// report in the order of increasing energy
+		for (size_t r = 0; r < toReport.size(); r++) {
+			output.add( toReport.at(r) );
+		}
+		reported = toReport.size();
 	} // overlapping interactions
 
 	// check if nothing was worth reporting but report was expected
 	if (reported == 0 && outConstraint.reportMax > 0 ) {
 		// TODO replace with no report and "no-interaction-message" in output destructor
 		// -> no preferable interactions found !!!
-		// replace mfeInteraction with no interaction
-		mfeInteractions.begin()->clear();
-		mfeInteractions.begin()->energy = 0.0;
-		// report mfe interaction
-		output.add( *(mfeInteractions.begin()) );
+		// report no interaction
+		curBest.clear();
+		curBest.energy = 0.0;
+		output.add( curBest );
 	}
 
 }
@@ -6,12 +6,18 @@
 #include "IntaRNA/Predictor.h"
 
 #include "IntaRNA/IndexRangeList.h"
+#include "IntaRNA/WorkCounters.h"
 
-#include <list>
+#include <set>
 #include <utility>
+#include <vector>
 
 namespace IntaRNA {
 
+// forward declarations of the energy models with specific prediction kernels
+class InteractionEnergyVrna;
+class InteractionEnergyBasePair;
+
 /**
  * Generic Predictor interface for MFE interaction computation to avoid
  * code redundancy
@@ -39,6 +45,19 @@ public:
 
 	virtual ~PredictorMfe();
 
+	/**
+	 * Enables or disables the pruning of DP cells via energy lower bounds.
+	 * If enabled, cells whose optimistic total energy (i.e. the best
+	 * possible interaction covering the cell) cannot beat the currently
+	 * worst stored optimum (or the maximal energy of the output constraint)
+	 * are skipped. Pruning is not applied if a prediction tracker is used,
+	 * since trackers have to be informed about all interactions.
+	 *
+	 * @param enable whether or not pruning is to be applied
+	 */
+	void
+	setPruning( const bool enable );
+
 protected:
 
 
@@ -53,11 +72,57 @@ protected:
 
 	// TODO provide all data structures as arguments to make predict() call threadsafe
 
-	//! list of interactions
-	typedef std::list<Interaction> InteractionList;
+	/**
+	 * Light-weight boundary information of an optimal interaction, which is
+	 * converted into an Interaction object not before reportOptima().
+	 * The indices are relative to the current index offsets of the energy
+	 * handler.
+	 */
+	class OptimumBoundary {
+	public:
+
+		//! init data
+		OptimumBoundary( const E_type energy, const size_t i1, const size_t j1, const size_t i2, const size_t j2 )
+			: energy(energy), i1(i1), j1(j1), i2(i2), j2(j2)
+		{}
+
+		//! whether or not this has a lower energy than the other
+		//! (ties are resolved via the boundaries)
+		bool operator<( const OptimumBoundary & other ) const
+		{
+			if (energy != other.energy) return energy < other.energy;
+			if (i1 != other.i1) return i1 < other.i1;
+			if (i2 != other.i2) return i2 < other.i2;
+			if (j1 != other.j1) return j1 < other.j1;
+			return j2 < other.j2;
+		}
+
+	public:
+		//! overall energy of the interaction
+		E_type energy;
+		//! left end of the interaction in seq1
+		size_t i1;
+		//! right end of the interaction in seq1
+		size_t j1;
+		//! left end of the interaction in seq2
+		size_t i2;
+		//! right end of the interaction in seq2
+		size_t j2;
+	};
+
+	//! bounded max-heap of the best interaction boundaries found so far,
+	//! i.e. the worst stored interaction is at the front
+	std::vector<OptimumBoundary> mfeInteractions;
+
+	//! the boundaries stored within mfeInteractions (if mfeInteractionsMax > 1)
+	//! sorted by energy to identify the stored interaction preceding a new one
+	std::set< OptimumBoundary > mfeInteractionsStored;
+
+	//! maximal number of interactions to be stored within mfeInteractions
+	size_t mfeInteractionsMax;
 
-	//! mfe interaction boundaries
-	InteractionList mfeInteractions;
+	//! upper bound (exclusive) for the energy of interactions to be stored
+	E_type mfeInteractionsMaxE;
 
 	//! index ranges of reported interactions to identify non-overlapping
 	//! interactions (first = seq1, second = seq2)
@@ -73,6 +138,34 @@ protected:
 	//! minimal interaction end energy
 	const E_type minEndEnergy;
 
+	//! whether or not DP cells are to be pruned via energy lower bounds
+	bool pruning;
+	//! whether or not the stored optima bound the energy of interactions to
+	//! be reported (false for non-overlapping suboptimal enumeration)
+	bool pruningByOptima;
+	//! whether or not only canonical interactions are to be stored, since
+	//! both sequences are identical (see OutputConstraint::symmetric)
+	bool symmetric;
+	//! number of DP cells checked for pruning since the last initPruning()
+	size_t pruningCellsEvaluated;
+	//! number of DP cells pruned since the last initPruning()
+	size_t pruningCellsPruned;
+	//! DP work done since the last reportWork() (see INTARNA_COUNT_WORK())
+	WorkCounters workCounters;
+	//! for each position of seq1 : the minimal ED of all interaction ranges
+	//! covering the position (empty if pruning is disabled)
+	std::vector<E_type> pruningMinED1;
+	//! for each position of seq2 : the minimal ED of all interaction ranges
+	//! covering the position (empty if pruning is disabled)
+	std::vector<E_type> pruningMinED2;
+
+	//! the energy handler if it is a VRNA-based model (otherwise NULL),
+	//! which enables the use of energy-model-specific recursion kernels
+	const InteractionEnergyVrna * const energyVrna;
+	//! the energy handler if it is a base pair model (otherwise NULL),
+	//! which enables the use of energy-model-specific recursion kernels
+	const InteractionEnergyBasePair * const energyBasePair;
+
 	/**
 	 * Initializes the global energy minimum storage
 	 *
@@ -101,6 +194,80 @@ protected:
 				, const bool isHybridE );
 
 
+	/**
+	 * Checks whether or not an interaction is the canonical one of two
+	 * symmetric interactions of identical sequences, i.e. whether or not its
+	 * range in seq1 is not right of its range in seq2 (compared by start
+	 * and end). Interactions with identical ranges are canonical.
+	 *
+	 * @param i1 the index of the first sequence interacting with i2
+	 * @param j1 the index of the first sequence interacting with j2
+	 * @param i2 the index of the second sequence interacting with i1
+	 * @param j2 the index of the second sequence interacting with j1
+	 * @return true if the interaction is canonical; false otherwise
+	 */
+	bool
+	isCanonical( const size_t i1, const size_t j1
+				, const size_t i2, const size_t j2 ) const;
+
+	/**
+	 * Checks whether or not any canonical interaction (see isCanonical())
+	 * can end in the given right end, i.e. whether or not its range in seq1
+	 * can start left of or at its range in seq2 given the maximal
+	 * interaction length in seq1.
+	 *
+	 * @param j1 the right end in seq1
+	 * @param j2 the right end in seq2
+	 * @return true if a canonical interaction can end in (j1,j2)
+	 */
+	bool
+	canEndCanonical( const size_t j1, const size_t j2 ) const;
+
+	/**
+	 * Access to the lowest energy stored via updateOptima() since the last
+	 * initOptima() call.
+	 *
+	 * @return the mfe found so far or the maximal energy of initOptima()
+	 *         if no interaction was stored
+	 */
+	E_type
+	getOptimumE() const;
+
+	/**
+	 * Resets the pruning statistics and computes the ED lower bounds
+	 * (pruningMinED1/2) for the current index offsets if pruning is enabled.
+	 *
+	 * @param size1 the number of positions of seq1 to be considered
+	 * @param size2 the number of positions of seq2 to be considered
+	 */
+	void
+	initPruning( const size_t size1, const size_t size2 );
+
+	/**
+	 * Provides the energy bound for pruning, i.e. DP cells whose optimistic
+	 * total energy is equal or above the bound can not contribute to any
+	 * interaction to be reported.
+	 *
+	 * @return the pruning bound or E_INF if no pruning is to be done
+	 */
+	virtual
+	E_type
+	getPruningBound() const;
+
+	/**
+	 * Logs the pruning statistics collected since the last initPruning().
+	 */
+	void
+	reportPruning() const;
+
+	/**
+	 * Logs the DP work counted since the last call, adds it to the
+	 * telemetry summary and resets the counters (only if work counters are
+	 * enabled at build time).
+	 */
+	void
+	reportWork();
+
 	/**
 	 * Fills a given interaction (boundaries given) with the according
 	 * hybridizing base pairs.
@@ -113,6 +280,16 @@ protected:
 	traceBack( Interaction & interaction, const OutputConstraint & outConstraint  ) = 0;
 
 
+	/**
+	 * Whether or not traceBack() only reads the filled recursion data, such
+	 * that the traceback of multiple interactions can be done concurrently.
+	 *
+	 * @return false, since tracebacks might refill recursion data
+	 */
+	virtual
+	bool
+	isTraceBackConcurrent() const;
+
 	/**
 	 * Identifies the next best interaction with an energy equal to or higher
 	 * than the given interaction. The new interaction will not overlap any
@@ -1,5 +1,7 @@
 
 #include "IntaRNA/PredictorMfe2d.h"
+#include "IntaRNA/InteractionEnergyVrna.h"
+#include "IntaRNA/InteractionEnergyBasePair.h"
 
 #include <stdexcept>
 
@@ -16,6 +18,10 @@ PredictorMfe2d(
 	, hybridE_pq( 0,0 )
 	, hybridErange( energy.getAccessibility1().getSequence()
 			, energy.getAccessibility2().getAccessibilityOrigin().getSequence() )
+	, hybridEoffset1( 0 )
+	, hybridEoffset2( 0 )
+	, pruningMinEDleft1()
+	, pruningMinEDleft2()
 {
 }
 
@@ -60,34 +66,43 @@ predict( const IndexRange & r1
 	energy.setOffset1(r1.from);
 	energy.setOffset2(r2.from);
 
+	const size_t size1 = std::min( energy.size1()
+			, (r1.to==RnaSequence::lastPos?energy.size1()-1:r1.to)-r1.from+1 );
+	const size_t size2 = std::min( energy.size2()
+			, (r2.to==RnaSequence::lastPos?energy.size2()-1:r2.to)-r2.from+1 );
+
 	// resize matrix
-	hybridE_pq.resize( std::min( energy.size1()
-						, (r1.to==RnaSequence::lastPos?energy.size1()-1:r1.to)-r1.from+1 )
-				, std::min( energy.size2()
-						, (r2.to==RnaSequence::lastPos?energy.size2()-1:r2.to)-r2.from+1 ) );
+	resizeHybridE( size1, size2 );
 
 	// initialize mfe interaction for updates
 	initOptima( outConstraint );
+	initPruning( size1, size2 );
 
 	// for all right ends j1
-	for (size_t j1 = hybridE_pq.size1(); j1-- > 0; ) {
+	for (size_t j1 = size1; j1-- > 0; ) {
+		// cooperative cancellation
+		checkDeadline();
 		// check if j1 is accessible
 		if (!energy.isAccessible1(j1))
 			continue;
 		// iterate over all right ends j2
-		for (size_t j2 = hybridE_pq.size2(); j2-- > 0; ) {
+		for (size_t j2 = size2; j2-- > 0; ) {
 			// check if j2 is accessible
 			if (!energy.isAccessible2(j2))
 				continue;
 			// check if base pair (j1,j2) possible
 			if (!energy.areComplementary( j1, j2 ))
 				continue;
+			// identical sequences : only right ends of canonical interactions
+			if (symmetric && !canEndCanonical( j1, j2 ))
+				continue;
 
 			// fill matrix and store best interaction
 			fillHybridE( j1, j2, outConstraint, 0, 0 );
 
 		}
 	}
+	reportPruning();
 
 	// report mfe interaction
 	reportOptima( outConstraint );
@@ -95,6 +110,19 @@ predict( const IndexRange & r1
 
 ////////////////////////////////////////////////////////////////////////////
 
+void
+PredictorMfe2d::
+resizeHybridE( const size_t size1, const size_t size2 )
+{
+	// left ends are at most maxLength+1 positions left of the right end
+	// (see initHybridE())
+	hybridE_pq.resize( std::min( size1, energy.getAccessibility1().getMaxLength()+2 )
+					, std::min( size2, energy.getAccessibility2().getMaxLength()+2 )
+					, false );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 void
 PredictorMfe2d::
 initHybridE( const size_t j1, const size_t j2
@@ -122,16 +150,20 @@ initHybridE( const size_t j1, const size_t j2
 	hybridErange.r2.from = std::max(i2init,j2-std::min(j2,energy.getAccessibility2().getMaxLength()+1));
 	hybridErange.r2.to = j2;
 
+	// band of hybridE_pq that ends in (j1,j2)
+	hybridEoffset1 = j1 - std::min( j1, hybridE_pq.size1()-1 );
+	hybridEoffset2 = j2 - std::min( j2, hybridE_pq.size2()-1 );
+
 	for (i1=hybridErange.r1.from; i1<=j1; i1++ ) {
 		for (i2=hybridErange.r2.from; i2<=j2; i2++) {
 			// check if complementary, i.e. to be computed
 			if( energy.areComplementary(i1,i2) )
 			{
 				// mark as to be computed (has to be < E_INF)
-				hybridE_pq(i1,i2) = E_MAX;
+				getHybridE(i1,i2) = E_MAX;
 			} else {
 				// mark as NOT to be computed
-				hybridE_pq(i1,i2) = E_INF;
+				getHybridE(i1,i2) = E_INF;
 			}
 		}
 	}
@@ -147,6 +179,57 @@ fillHybridE( const size_t j1, const size_t j2
 			, const OutputConstraint & outConstraint
 			, const size_t i1init, const size_t i2init )
 {
+	// use the recursion kernel specific for the energy model
+	if (energyVrna != NULL) {
+		fillHybridE( *energyVrna, energy.getOffset1(), energy.getOffset2(), j1, j2, outConstraint, i1init, i2init );
+	} else
+	if (energyBasePair != NULL) {
+		fillHybridE( *energyBasePair, energy.getOffset1(), energy.getOffset2(), j1, j2, outConstraint, i1init, i2init );
+	} else {
+		fillHybridE( energy, 0, 0, j1, j2, outConstraint, i1init, i2init );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+template < class EnergyType >
+void
+PredictorMfe2d::
+fillHybridE( const EnergyType & energyModel
+			, const size_t offset1, const size_t offset2
+			, const size_t j1, const size_t j2
+			, const OutputConstraint & outConstraint
+			, const size_t i1init, const size_t i2init )
+{
+	// use kernels with fixed loop sizes for the most common setups
+	const size_t maxLoop = energyModel.getMaxInternalLoopSize1() == energyModel.getMaxInternalLoopSize2()
+						? energyModel.getMaxInternalLoopSize1() : RnaSequence::lastPos;
+	switch (maxLoop) {
+	case 0 :
+		fillHybridE<EnergyType,0>( energyModel, offset1, offset2, j1, j2, outConstraint, i1init, i2init );
+		break;
+	case 16 :
+		fillHybridE<EnergyType,16>( energyModel, offset1, offset2, j1, j2, outConstraint, i1init, i2init );
+		break;
+	default :
+		fillHybridE<EnergyType,-1>( energyModel, offset1, offset2, j1, j2, outConstraint, i1init, i2init );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+template < class EnergyType, int MaxLoop >
+void
+PredictorMfe2d::
+fillHybridE( const EnergyType & energyModel
+			, const size_t offset1, const size_t offset2
+			, const size_t j1, const size_t j2
+			, const OutputConstraint & outConstraint
+			, const size_t i1init, const size_t i2init )
+{
+	// loop-independent constraints (compile-time constants if MaxLoop is set)
+	const size_t maxLoop1 = MaxLoop < 0 ? energyModel.getMaxInternalLoopSize1() : (size_t)MaxLoop;
+	const size_t maxLoop2 = MaxLoop < 0 ? energyModel.getMaxInternalLoopSize2() : (size_t)MaxLoop;
 
 	// init for right interaction end (j1,j2)
 	initHybridE( j1, j2, outConstraint, i1init, i2init );
@@ -157,58 +240,121 @@ fillHybridE( const size_t j1, const size_t j2
 	// global vars to avoid reallocation
 	size_t i1,i2,w1,w2,k1,k2;
 
+	// pruning setup : optimistic energy contributions and ED lower bounds
+	// of all interactions ending in (j1,j2) with a left end up to (i1,i2)
+	E_type pruneBound = getPruningBound();
+	const bool prune = E_isNotINF(pruneBound);
+	const E_type pruneLoopE = std::min( (E_type)0, minStackingEnergy );
+	const E_type pruneEndsE = 2.0*std::min( (E_type)0, minDangleEnergy ) + 2.0*std::min( (E_type)0, minEndEnergy );
+	if (prune) {
+		pruningMinEDleft1.resize( j1-hybridErange.r1.from+1 );
+		for (i1=hybridErange.r1.from; i1<=j1; i1++) {
+			pruningMinEDleft1[i1-hybridErange.r1.from] = std::min( energy.getED1( i1, j1 )
+					, i1==hybridErange.r1.from ? E_INF : pruningMinEDleft1[i1-1-hybridErange.r1.from] );
+		}
+		pruningMinEDleft2.resize( j2-hybridErange.r2.from+1 );
+		for (i2=hybridErange.r2.from; i2<=j2; i2++) {
+			pruningMinEDleft2[i2-hybridErange.r2.from] = std::min( energy.getED2( i2, j2 )
+					, i2==hybridErange.r2.from ? E_INF : pruningMinEDleft2[i2-1-hybridErange.r2.from] );
+		}
+	}
+	// number of base pairs that can be added left of (i1,i2)
+	size_t pruneLeftBP = 0;
+
 	//////////  FIRST ROUND : COMPUTE HYBRIDIZATION ENERGIES ONLY  ////////////
 
 	// current minimal value
 	E_type curMinE = E_INF;
+	// the window starts are traversed in tiles of (maxLoop1+1) x (maxLoop2+1)
+	// cells (tiles and cells within each tile in decreasing order), such that
+	// all cells (k1,k2) needed for a cell are within the current tile or its
+	// three already computed successor tiles; thus the working set stays
+	// cache-local even for large maximal interaction lengths
+	const size_t tileSize1 = maxLoop1+1;
+	const size_t tileSize2 = maxLoop2+1;
+	size_t tile1to, tile1from, tile2to, tile2from;
 	// iterate over all window starts i1 (seq1) and i2 (seq2)
-	// TODO PARALLELIZE THIS DOUBLE LOOP ?!
-	for (i1=hybridErange.r1.to+1; i1-- > hybridErange.r1.from; ) {
+	for (tile1to=hybridErange.r1.to+1; tile1to > hybridErange.r1.from; tile1to=tile1from) {
+		tile1from = tile1to - std::min( tileSize1, tile1to-hybridErange.r1.from );
+	for (tile2to=hybridErange.r2.to+1; tile2to > hybridErange.r2.from; tile2to=tile2from) {
+		tile2from = tile2to - std::min( tileSize2, tile2to-hybridErange.r2.from );
+	for (i1=tile1to; i1-- > tile1from; ) {
 		w1 = j1-i1+1;
 		// w1 width check obsolete due to hybridErange setup
 		// screen for left boundaries in seq2
-		for (i2=hybridErange.r2.to+1; i2-- > hybridErange.r2.from; ) {
+		for (i2=tile2to; i2-- > tile2from; ) {
 			// w2 width check obsolete due to hybridErange setup
 			w2 = j2-i2+1;
 			curMinE = E_INF;
 
 			// check if this cell is to be computed (!=E_INF)
-			if( E_isNotINF( hybridE_pq(i1,i2) ) ) {
+			if( E_isNotINF( getHybridE(i1,i2) ) ) {
+				INTARNA_COUNT_WORK( workCounters.complementaryCells++ );
+
+				// check if any interaction covering (i1,i2) can beat the bound
+				if (prune) {
+					pruningCellsEvaluated++;
+					pruneLeftBP = std::min( i1-hybridErange.r1.from, i2-hybridErange.r2.from );
+					if (!( minInitEnergy + (E_type)(std::min(j1-i1,j2-i2)+pruneLeftBP)*pruneLoopE + pruneEndsE
+							+ pruningMinEDleft1[i1-hybridErange.r1.from] + pruningMinEDleft2[i2-hybridErange.r2.from] < pruneBound ))
+					{
+						pruningCellsPruned++;
+						getHybridE(i1,i2) = E_INF;
+						continue;
+					}
+				}
 
 				// compute entry
+				INTARNA_COUNT_WORK( workCounters.filledCells++ );
 
 				// either interaction initiation
 				if ( i1==j1 && i2==j2 )  {
-					curMinE = energy.getE_init();
+					curMinE = energyModel.getE_init();
 				} else { // or more complex stuff
 					// test only internal loop energy (nothing between i and j)
 					// will be E_INF if loop is too large
-					curMinE = energy.getE_interLeft(i1,j1,i2,j2)
-							+ hybridE_pq(j1,j2);
+					curMinE = energyModel.getE_interLeft(i1+offset1,j1+offset1,i2+offset2,j2+offset2)
+							+ getHybridE(j1,j2);
+					INTARNA_COUNT_WORK( workCounters.loopEvaluations++ );
 
 					// check all combinations of decompositions into (i1,i2)..(k1,k2)-(j1,j2)
 					if (w1 > 2 && w2 > 2) {
-						for (k1=std::min(j1-1,i1+energy.getMaxInternalLoopSize1()+1); k1>i1; k1--) {
-						for (k2=std::min(j2-1,i2+energy.getMaxInternalLoopSize2()+1); k2>i2; k2--) {
+						for (k1=std::min(j1-1,i1+maxLoop1+1); k1>i1; k1--) {
+						for (k2=std::min(j2-1,i2+maxLoop2+1); k2>i2; k2--) {
 							// check if (k1,k2) are valid left boundary
-							if ( E_isNotINF( hybridE_pq(k1,k2) ) ) {
+							if ( E_isNotINF( getHybridE(k1,k2) ) ) {
 								curMinE = std::min( curMinE,
-										(energy.getE_interLeft(i1,k1,i2,k2)
-												+ hybridE_pq(k1,k2) )
+										(energyModel.getE_interLeft(i1+offset1,k1+offset1,i2+offset2,k2+offset2)
+												+ getHybridE(k1,k2) )
 										);
+								INTARNA_COUNT_WORK( workCounters.loopEvaluations++ );
 							}
 						}
 						}
 					}
 				}
+				// check if extensions to the left can beat the bound
+				if (prune && !( curMinE + (E_type)pruneLeftBP*pruneLoopE + pruneEndsE
+							+ pruningMinEDleft1[i1-hybridErange.r1.from] + pruningMinEDleft2[i2-hybridErange.r2.from] < pruneBound ))
+				{
+					pruningCellsPruned++;
+					getHybridE(i1,i2) = E_INF;
+					continue;
+				}
 				// store value
-				hybridE_pq(i1,i2) = curMinE;
+				getHybridE(i1,i2) = curMinE;
 				// update mfe if needed
-				updateOptima( i1,j1,i2,j2, hybridE_pq(i1,i2), true );
+				updateOptima( i1,j1,i2,j2, getHybridE(i1,i2), true );
+				// update bound for the next cells
+				if (prune) {
+					pruneBound = getPruningBound();
+				}
 				continue;
 			}
 		}
 	}
+	}
+	}
 
 }
 
@@ -254,17 +400,21 @@ traceBack( Interaction & interaction, const OutputConstraint & outConstraint  )
 			i2 = energy.getIndex2(interaction.basePairs.at(0)),
 			j2 = energy.getIndex2(interaction.basePairs.at(1));
 
-	// refill submatrix of mfe interaction
+	// refill submatrix of mfe interaction (without pruning, since the bound
+	// might be met by the interaction itself)
+	const bool curPruning = pruning;
+	pruning = false;
 	fillHybridE( j1, j2, outConstraint, i1, i2 );
+	pruning = curPruning;
 
 	// the currently traced value for i1-j1, i2-j2
-	E_type curE = hybridE_pq(i1,i2);
+	E_type curE = getHybridE(i1,i2);
 
 	// trace back
 	while( i1 != j1 ) {
 
 		// check if just internal loop
-		if ( E_equal( curE, (energy.getE_interLeft(i1,j1,i2,j2) + hybridE_pq(j1,j2)) ) )
+		if ( E_equal( curE, (energy.getE_interLeft(i1,j1,i2,j2) + getHybridE(j1,j2)) ) )
 		{
 			break;
 		}
@@ -277,9 +427,9 @@ traceBack( Interaction & interaction, const OutputConstraint & outConstraint  )
 			for (k1=std::min(j1-1,i1+energy.getMaxInternalLoopSize1()+1); traceNotFound && k1>i1; k1--) {
 			for (k2=std::min(j2-1,i2+energy.getMaxInternalLoopSize2()+1); traceNotFound && k2>i2; k2--) {
 				// check if (k1,k2) are valid left boundary
-				if ( E_isNotINF( hybridE_pq(k1,k2) ) ) {
+				if ( E_isNotINF( getHybridE(k1,k2) ) ) {
 					if ( E_equal( curE,
-							(energy.getE_interLeft(i1,k1,i2,k2) + hybridE_pq(k1,k2)) ) )
+							(energy.getE_interLeft(i1,k1,i2,k2) + getHybridE(k1,k2)) ) )
 					{
 						// stop searching
 						traceNotFound = false;
@@ -288,7 +438,7 @@ traceBack( Interaction & interaction, const OutputConstraint & outConstraint  )
 						// trace right part of split
 						i1=k1;
 						i2=k2;
-						curE = hybridE_pq(i1,i2);
+						curE = getHybridE(i1,i2);
 					}
 				}
 			}
@@ -324,4 +474,14 @@ getNextBest( Interaction & curBest )
 ////////////////////////////////////////////////////////////////////////////
 
 
+size_t
+PredictorMfe2d::
+getMemoryEstimate( const size_t size1, const size_t size2 )
+{
+	// hybridE_pq
+	return size1*size2*sizeof(E_type);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 } // namespace
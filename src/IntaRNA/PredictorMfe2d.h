@@ -3,8 +3,11 @@
 #define INTARNA_PREDICTORMFE2D_H_
 
 #include "IntaRNA/PredictorMfe.h"
+#include "IntaRNA/HugePageAllocator.h"
 #include "IntaRNA/Interaction.h"
 
+#include <vector>
+
 #include <boost/numeric/ublas/matrix.hpp>
 
 namespace IntaRNA {
@@ -20,8 +23,9 @@ class PredictorMfe2d: public PredictorMfe {
 
 protected:
 
-	//! matrix type to hold the mfe energies for interaction site starts
-	typedef boost::numeric::ublas::matrix<E_type> E2dMatrix;
+	//! matrix type to hold the mfe energies for interaction site starts;
+	//! vector storage keeps its capacity when resized for smaller windows
+	typedef boost::numeric::ublas::matrix<E_type, boost::numeric::ublas::row_major, HugePageAllocator<E_type>::vector > E2dMatrix;
 
 public:
 
@@ -57,6 +61,19 @@ public:
 			, const OutputConstraint & outConstraint = OutputConstraint()
 			);
 
+	/**
+	 * Computes the memory needed for the matrices of a predict() call.
+	 *
+	 * @param size1 the length of the first sequence (window)
+	 * @param size2 the length of the second sequence (window)
+	 *
+	 * @return the estimated number of bytes
+	 */
+	static
+	size_t
+	getMemoryEstimate( const size_t size1, const size_t size2 );
+
+
 protected:
 
 	//! access to the interaction energy handler of the super class
@@ -68,14 +85,49 @@ protected:
 	// TODO provide all data structures as arguments to make predict() call threadsafe
 
 	//! energy of all interaction hybrids that end in position p (seq1) and
-	//! q (seq2)
+	//! q (seq2); only the band of left ends within the maximal interaction
+	//! lengths is stored (see getHybridE())
 	E2dMatrix hybridE_pq;
 
 	//! the current range of computed entries within hybridE_pq set by initHybridE()
 	InteractionRange hybridErange;
 
+	//! the left end i1 of the current right end is stored in row i1-hybridEoffset1
+	size_t hybridEoffset1;
+	//! the left end i2 of the current right end is stored in column i2-hybridEoffset2
+	size_t hybridEoffset2;
+
+	//! for pruning : minimal ED1(k1,j1) of all k1 in [hybridErange.r1.from,i1]
+	//! at index i1-hybridErange.r1.from for the current right end j1
+	std::vector<E_type> pruningMinEDleft1;
+	//! for pruning : minimal ED2(k2,j2) of all k2 in [hybridErange.r2.from,i2]
+	//! at index i2-hybridErange.r2.from for the current right end j2
+	std::vector<E_type> pruningMinEDleft2;
+
 protected:
 
+	/**
+	 * Resizes hybridE_pq to the band of left ends needed for any right end,
+	 * i.e. the maximal interaction lengths (plus 1) but at most the given
+	 * window sizes.
+	 *
+	 * @param size1 the window size in seq1
+	 * @param size2 the window size in seq2
+	 */
+	void
+	resizeHybridE( const size_t size1, const size_t size2 );
+
+	/**
+	 * Access to the hybridE_pq entry of the left end (i1,i2) for the right
+	 * end of the last initHybridE() call.
+	 *
+	 * @param i1 the left end in seq1 (within hybridErange.r1)
+	 * @param i2 the left end in seq2 (within hybridErange.r2)
+	 * @return the according entry within the band stored in hybridE_pq
+	 */
+	E_type &
+	getHybridE( const size_t i1, const size_t i2 );
+
 	/**
 	 * Initializes the hybridE_pq table for the computation for interactions
 	 * ending in p=j1 and q=j2
@@ -95,6 +147,8 @@ protected:
 	/**
 	 * Computes all entries of the hybridE matrix for interactions ending in
 	 * p=j1 and q=j2 and report all valid interactions to updateOptima()
+	 * using the recursion kernel specific for the energy model used (if
+	 * available).
 	 *
 	 * @param j1 end of the interaction within seq 1
 	 * @param j2 end of the interaction within seq 2
@@ -109,6 +163,59 @@ protected:
 				, const size_t i1init, const size_t i2init
 				);
 
+	/**
+	 * Computes all entries of the hybridE matrix for interactions ending in
+	 * p=j1 and q=j2 (see above), where all energy calls of the recursion are
+	 * done via the given energy handler with shifted indices. Thus, if
+	 * EnergyType is a final energy class, all energy calls of the recursion
+	 * are bound at compile time.
+	 *
+	 * @param energyModel the energy handler to use
+	 * @param offset1 the index offset of seq1 to be applied for energyModel
+	 * @param offset2 the index offset of seq2 to be applied for energyModel
+	 * @param j1 end of the interaction within seq 1
+	 * @param j2 end of the interaction within seq 2
+	 * @param outConstraint constrains the interactions reported to the output handler
+	 * @param i1init smallest value for i1
+	 * @param i2init smallest value for i2
+	 *
+	 */
+	template < class EnergyType >
+	void
+	fillHybridE( const EnergyType & energyModel
+				, const size_t offset1, const size_t offset2
+				, const size_t j1, const size_t j2
+				, const OutputConstraint & outConstraint
+				, const size_t i1init, const size_t i2init
+				);
+
+	/**
+	 * Recursion kernel of fillHybridE() with the maximal interior loop size
+	 * known at compile time, such that the loops over the interior loop
+	 * sizes can be unrolled. Instantiated for the common limits 0 (stackings
+	 * only) and 16 (default) of both sequences.
+	 *
+	 * @param energyModel the energy handler to use
+	 * @param offset1 the index offset of seq1 to be applied for energyModel
+	 * @param offset2 the index offset of seq2 to be applied for energyModel
+	 * @param j1 end of the interaction within seq 1
+	 * @param j2 end of the interaction within seq 2
+	 * @param outConstraint constrains the interactions reported to the output handler
+	 * @param i1init smallest value for i1
+	 * @param i2init smallest value for i2
+	 *
+	 * @tparam MaxLoop the maximal interior loop size for both sequences; if
+	 *        negative, the sizes of the energy handler are used
+	 */
+	template < class EnergyType, int MaxLoop >
+	void
+	fillHybridE( const EnergyType & energyModel
+				, const size_t offset1, const size_t offset2
+				, const size_t j1, const size_t j2
+				, const OutputConstraint & outConstraint
+				, const size_t i1init, const size_t i2init
+				);
+
 	/**
 	 * Fills a given interaction (boundaries given) with the according
 	 * hybridizing base pairs.
@@ -135,6 +242,18 @@ protected:
 
 };
 
+//////////////////////////////////////////////////////////////////////////
+
+inline
+E_type &
+PredictorMfe2d::
+getHybridE( const size_t i1, const size_t i2 )
+{
+	return hybridE_pq( i1-hybridEoffset1, i2-hybridEoffset2 );
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 } // namespace
 
 #endif /* INTARNA_PREDICTORMFE2D_H_ */
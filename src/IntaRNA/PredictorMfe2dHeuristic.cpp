@@ -1,12 +1,19 @@
 
 #include "IntaRNA/PredictorMfe2dHeuristic.h"
+#include "IntaRNA/InteractionEnergyVrna.h"
+#include "IntaRNA/InteractionEnergyBasePair.h"
 
+#include <algorithm>
 #include <stdexcept>
 
 namespace IntaRNA {
 
 ////////////////////////////////////////////////////////////////////////////
 
+const size_t PredictorMfe2dHeuristic::hybridERowBlockSize = 256;
+
+////////////////////////////////////////////////////////////////////////////
+
 PredictorMfe2dHeuristic::
 PredictorMfe2dHeuristic(
 		const InteractionEnergy & energy
@@ -14,6 +21,11 @@ PredictorMfe2dHeuristic(
 		, PredictionTracker * predTracker )
  : PredictorMfe(energy,output,predTracker)
 	, hybridE( 0,0 )
+	, hybridE_j1( 0,0 )
+	, hybridE_j2( 0,0 )
+	, traceStorage( false )
+	, hybridE_trace( 0,0 )
+	, hybridErowsToFill( 0 )
 {
 }
 
@@ -55,39 +67,21 @@ predict( const IndexRange & r1
 	energy.setOffset2(r2.from);
 
 	// resize matrix
-	hybridE.resize( std::min( energy.size1()
+	resizeHybridE( std::min( energy.size1()
 						, (r1.to==RnaSequence::lastPos?energy.size1()-1:r1.to)-r1.from+1 )
 				, std::min( energy.size2()
 						, (r2.to==RnaSequence::lastPos?energy.size2()-1:r2.to)-r2.from+1 ) );
 
-	// temp vars
-	size_t i1,i2,w1,w2;
-
 	// init matrix
-	bool isValidCell = true;
-	for (i1=0; i1<hybridE.size1(); i1++) {
-	for (i2=0; i2<hybridE.size2(); i2++) {
-
-		// check if positions can form interaction
-		if (	energy.isAccessible1(i1)
-				&& energy.isAccessible2(i2)
-				&& energy.areComplementary(i1,i2) )
-		{
-			// set to interaction initiation with according boundary
-			hybridE(i1,i2) = BestInteraction(energy.getE_init(), i1, i2);
-		} else {
-			// set to infinity, ie not used
-			hybridE(i1,i2) = BestInteraction(E_INF, RnaSequence::lastPos, RnaSequence::lastPos);
-		}
-
-	} // i2
-	} // i1
+	initHybridE();
 
 	// init mfe for later updates
 	initOptima( outConstraint );
+	initPruning( hybridE.size1(), hybridE.size2() );
 
 	// compute table and update mfeInteraction
 	fillHybridE();
+	reportPruning();
 
 	// trace back and output handler update
 	reportOptima( outConstraint );
@@ -95,58 +89,322 @@ predict( const IndexRange & r1
 }
 
 
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMfe2dHeuristic::
+predictWindows( const IndexRange & r1
+		, const IndexRange & r2
+		, const size_t windowWidth
+		, const size_t windowOverlap
+		, const OutputConstraint & outConstraint )
+{
+	// restrict to the sequence lengths
+	energy.setOffset1(r1.from);
+	energy.setOffset2(r2.from);
+	const IndexRange range1( r1.from, r1.from - 1 + std::min( energy.size1()
+						, (r1.to==RnaSequence::lastPos?energy.size1()-1:r1.to)-r1.from+1 ) );
+	const size_t size2 = std::min( energy.size2()
+						, (r2.to==RnaSequence::lastPos?energy.size2()-1:r2.to)-r2.from+1 );
+
+	// get windows
+	const std::vector<IndexRange> windows = range1.overlappingWindows( windowWidth, windowOverlap );
+
+	// check if there is anything to reuse
+	if (windows.size() == 1) {
+		predict( range1, r2, outConstraint );
+		return;
+	}
+	// carried rows might have been pruned with the bound of another window
+	if (E_isNotINF(getPruningBound())) {
+		Predictor::predictWindows( r1, r2, windowWidth, windowOverlap, outConstraint );
+		return;
+	}
+
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_logOutput)
+#endif
+	{ VLOG(2) <<"predicting mfe interactions heuristically for "<<windows.size()<<" sliding windows..."; }
+	// measure timing
+	TIMED_FUNC_IF(timerObj,VLOG_IS_ON(9));
+
+	// maximal number of rows covered by an interaction
+	const size_t maxLength1 = std::max( (size_t)1, std::min( range1.to-range1.from+1, energy.getAccessibility1().getMaxLength() ) );
+
+	// process windows from right to left
+	size_t prevFrom = range1.to+1;
+	for (size_t w = windows.size(); w-- > 0; ) {
+		// rows of the window not covered by the right neighbour
+		const size_t newFrom = windows.at(w).from;
+		const size_t newRows = prevFrom - newFrom;
+		// rows of the right neighbour reachable by interactions starting
+		// within the new rows (carried over)
+		const size_t carriedRows = std::min( range1.to+1, prevFrom + maxLength1 - 1 ) - prevFrom;
+		assert( carriedRows <= hybridE.size1() );
+
+		// resize matrix (row-major storage keeps the leading rows)
+		resizeHybridE( newRows + carriedRows, size2 );
+		// move carried rows behind the new rows
+		// (relative boundaries are not affected by the shift)
+		if (carriedRows > 0) {
+			const size_t carriedCells = carriedRows * size2, shiftCells = newRows * size2;
+			std::copy_backward( hybridE.data().begin(), hybridE.data().begin()+carriedCells, hybridE.data().begin()+shiftCells+carriedCells );
+			std::copy_backward( hybridE_j1.data().begin(), hybridE_j1.data().begin()+carriedCells, hybridE_j1.data().begin()+shiftCells+carriedCells );
+			std::copy_backward( hybridE_j2.data().begin(), hybridE_j2.data().begin()+carriedCells, hybridE_j2.data().begin()+shiftCells+carriedCells );
+			if (!hybridE_trace.data().empty()) {
+				std::copy_backward( hybridE_trace.data().begin(), hybridE_trace.data().begin()+carriedCells, hybridE_trace.data().begin()+shiftCells+carriedCells );
+			}
+		}
+
+		// set index offset of this window
+		energy.setOffset1(newFrom);
+
+		// init new rows only
+		initHybridE( newRows );
+
+		// init mfe for later updates
+		initOptima( outConstraint );
+
+		// compute new rows and update mfeInteraction
+		fillHybridE();
+
+		// trace back and output handler update
+		reportOptima( outConstraint );
+
+		// update for next window
+		prevFrom = newFrom;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMfe2dHeuristic::
+initHybridE( const size_t rows )
+{
+	// identify all positions that can form an interaction
+	pairingMask.setup( energy, IndexRange(0,hybridE.size1()-1), IndexRange(0,hybridE.size2()-1), true );
+
+	// the rows to be computed
+	hybridErowsToFill = std::min( rows, hybridE.size1() );
+	const size_t cells = hybridErowsToFill * hybridE.size2();
+
+	// mark all cells as not used
+	std::fill( hybridE.data().begin(), hybridE.data().begin()+cells, E_INF );
+	// (single base pair interactions, i.e. zero right boundary offsets)
+	std::fill( hybridE_j1.data().begin(), hybridE_j1.data().begin()+cells, 0 );
+	std::fill( hybridE_j2.data().begin(), hybridE_j2.data().begin()+cells, 0 );
+	if (!hybridE_trace.data().empty()) {
+		std::fill( hybridE_trace.data().begin(), hybridE_trace.data().begin()+cells, 0 );
+	}
+
+	// set pairing cells to interaction initiation
+	const E_type initE = energy.getE_init();
+	for (size_t i1=0; i1<hybridErowsToFill; i1++) {
+	for (size_t i2=pairingMask.getNextPairing(i1,0); i2<hybridE.size2(); i2=pairingMask.getNextPairing(i1,i2+1)) {
+		hybridE(i1,i2) = initE;
+	} // i2
+	} // i1
+}
+
 ////////////////////////////////////////////////////////////////////////////
 
 void
 PredictorMfe2dHeuristic::
 fillHybridE()
 {
+	// use the recursion kernel specific for the energy model
+	// (and skip all accessibility lookups if disabled)
+	if (energyVrna != NULL) {
+		if (energyVrna->isAccessibilityDisabled()) {
+			fillHybridE<InteractionEnergyVrna,true>( *energyVrna, energy.getOffset1(), energy.getOffset2() );
+		} else {
+			fillHybridE<InteractionEnergyVrna,false>( *energyVrna, energy.getOffset1(), energy.getOffset2() );
+		}
+	} else
+	if (energyBasePair != NULL) {
+		if (energyBasePair->isAccessibilityDisabled()) {
+			fillHybridE<InteractionEnergyBasePair,true>( *energyBasePair, energy.getOffset1(), energy.getOffset2() );
+		} else {
+			fillHybridE<InteractionEnergyBasePair,false>( *energyBasePair, energy.getOffset1(), energy.getOffset2() );
+		}
+	} else {
+		fillHybridE<InteractionEnergyIdxOffset,false>( energy, 0, 0 );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+template < class EnergyType, bool AccDisabled >
+void
+PredictorMfe2dHeuristic::
+fillHybridE( const EnergyType & energyModel
+			, const size_t offset1
+			, const size_t offset2 )
+{
+	// the maximal interior loop size if equal for both sequences
+	const size_t maxLoop = energyModel.getMaxInternalLoopSize1() == energyModel.getMaxInternalLoopSize2()
+						? energyModel.getMaxInternalLoopSize1() : RnaSequence::lastPos;
+	// pairing positions of the current row (decreasing) and their energies
+	std::vector<size_t> rowI2;
+	std::vector<E_type> rowE;
+	rowI2.reserve( hybridE.size2() );
+	size_t i1,i2,b;
+	// iterate (decreasingly) over all left interaction starts that can pair
+	for (i1=hybridErowsToFill; i1-- > 0;) {
+		// collect all pairing positions of the row
+		rowI2.clear();
+		for (i2=pairingMask.getPrevPairing(i1,hybridE.size2()); i2 != RnaSequence::lastPos; i2=pairingMask.getPrevPairing(i1,i2)) {
+			rowI2.push_back(i2);
+		}
+		rowE.resize( rowI2.size() );
+		// the optima are not updated within the row
+		const E_type pruneBound = getPruningBound();
+
+		// the entries of a row only depend on subsequent rows
+		// -> compute blocks of the row in parallel if worthwhile
+		for (b=0; b<rowI2.size(); b+=hybridERowBlockSize) {
+#if INTARNA_MULITHREADING
+			#pragma omp task shared(energyModel,rowI2,rowE) firstprivate(i1,b) if(rowI2.size() > hybridERowBlockSize)
+#endif
+			{
+			// use kernels with fixed loop sizes for the most common setups
+			switch (maxLoop) {
+			case 0 :
+				fillHybridE<EnergyType,0,AccDisabled>( energyModel, offset1, offset2, i1, rowI2, rowE, b, std::min(b+hybridERowBlockSize,rowI2.size()), pruneBound );
+				break;
+			case 16 :
+				fillHybridE<EnergyType,16,AccDisabled>( energyModel, offset1, offset2, i1, rowI2, rowE, b, std::min(b+hybridERowBlockSize,rowI2.size()), pruneBound );
+				break;
+			default :
+				fillHybridE<EnergyType,-1,AccDisabled>( energyModel, offset1, offset2, i1, rowI2, rowE, b, std::min(b+hybridERowBlockSize,rowI2.size()), pruneBound );
+			}
+			}
+		}
+#if INTARNA_MULITHREADING
+		#pragma omp taskwait
+#endif
+
+		// update mfe if needed (in the order of the sequential recursion)
+		for (b=0; b<rowI2.size(); b++) {
+			if (E_isNotINF(rowE[b])) {
+				updateOptima( i1,i1+hybridE_j1(i1,rowI2[b]), rowI2[b],rowI2[b]+hybridE_j2(i1,rowI2[b]), rowE[b], false );
+			}
+		}
+
+	} // i1
+
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+template < class EnergyType, int MaxLoop, bool AccDisabled >
+void
+PredictorMfe2dHeuristic::
+fillHybridE( const EnergyType & energyModel
+			, const size_t offset1
+			, const size_t offset2
+			, const size_t i1
+			, const std::vector<size_t> & rowI2
+			, std::vector<E_type> & rowE
+			, const size_t from
+			, const size_t to
+			, const E_type pruneBound )
+{
+	// loop-independent constraints (compile-time constants if MaxLoop is set)
+	const size_t maxLoop1 = MaxLoop < 0 ? energyModel.getMaxInternalLoopSize1() : (size_t)MaxLoop;
+	const size_t maxLoop2 = MaxLoop < 0 ? energyModel.getMaxInternalLoopSize2() : (size_t)MaxLoop;
+	// (limited by the range of the relative boundaries)
+	const size_t maxLength1 = std::min( energyModel.getAccessibility1().getMaxLength(), maxBoundaryOffset+1 );
+	const size_t maxLength2 = std::min( energyModel.getAccessibility2().getMaxLength(), maxBoundaryOffset+1 );
+
+	// optimistic energy contributions for pruning
+	const bool prune = E_isNotINF(pruneBound);
+	const E_type pruneLoopE = std::min( (E_type)0, minStackingEnergy );
+	const E_type pruneEndsE = 2.0*std::min( (E_type)0, minDangleEnergy ) + 2.0*std::min( (E_type)0, minEndEnergy );
+	// best hybridization energy of any interaction
+	const E_type pruneHybridE = minInitEnergy + (E_type)(std::min(maxLength1,maxLength2)-1)*pruneLoopE;
+	size_t pruneEvaluated = 0, prunePruned = 0;
+	// DP work of this block
+	INTARNA_COUNT_WORK( WorkCounters work; )
+
+	// row length of the matrices
+	const size_t size2 = hybridE.size2();
+	// whether or not traceback pointers are to be stored
+	const bool storeTrace = !hybridE_trace.data().empty();
+
 	// compute entries
 	// current minimal value
 	E_type curE = E_INF, curEtotal = E_INF, curCellEtotal = E_INF;
-	size_t i1,i2,w1,w2;
-	BestInteraction * curCell = NULL;
-	const BestInteraction * rightExt = NULL;
-	// iterate (decreasingly) over all left interaction starts
-	for (i1=hybridE.size1(); i1-- > 0;) {
-	for (i2=hybridE.size2(); i2-- > 0;) {
-		// direct cell access
-		curCell = &(hybridE(i1,i2));
+	// current best entry for the left boundary
+	E_type curCellE = E_INF;
+	size_t curCellJ1 = 0, curCellJ2 = 0;
+	TracePointer curCellTrace = 0;
+	size_t i2,w1,w2,k2;
+	// direct access to the rows of the right extensions
+	const E_type * rowExtE = NULL;
+	const BoundaryOffset * rowExtJ1 = NULL;
+	const BoundaryOffset * rowExtJ2 = NULL;
+	// iterate over the given left interaction starts that can pair
+	for (size_t r=from; r<to; r++) {
+		i2 = rowI2[r];
+		INTARNA_COUNT_WORK( work.complementaryCells++ );
 		// check if left side can pair
-		if (E_isINF(curCell->E)) {
+		curCellE = hybridE(i1,i2);
+		if (E_isINF(curCellE)) {
+			rowE[r] = E_INF;
 			continue;
 		}
+		curCellJ1 = i1+hybridE_j1(i1,i2);
+		curCellJ2 = i2+hybridE_j2(i1,i2);
+		curCellTrace = 0;
+
+		// check if any interaction covering (i1,i2) can beat the bound
+		if (prune) {
+			pruneEvaluated++;
+			if (!(pruneHybridE + pruneEndsE + pruningMinED1[i1] + pruningMinED2[i2] < pruneBound)) {
+				prunePruned++;
+				hybridE(i1,i2) = E_INF;
+				rowE[r] = E_INF;
+				continue;
+			}
+		}
 
 		// current best total energy value (covers to far E_init only)
-		curCellEtotal = energy.getE(i1,curCell->j1,i2,curCell->j2,curCell->E);
+		curCellEtotal = InteractionEnergy::getE<EnergyType,AccDisabled>( energyModel, i1+offset1, curCellJ1+offset1, i2+offset2, curCellJ2+offset2, curCellE );
+		INTARNA_COUNT_WORK( work.filledCells++ );
 
-		// TODO PARALLELIZE THIS DOUBLE LOOP ?!
 		// iterate over all loop sizes w1 (seq1) and w2 (seq2) (minus 1)
-		for (w1=1; w1-1 <= energy.getMaxInternalLoopSize1() && i1+w1<hybridE.size1(); w1++) {
-		for (w2=1; w2-1 <= energy.getMaxInternalLoopSize2() && i2+w2<hybridE.size2(); w2++) {
-			// direct cell access (const)
-			rightExt = &(hybridE(i1+w1,i2+w2));
+		for (w1=1; w1-1 <= maxLoop1 && i1+w1<hybridE.size1(); w1++) {
+		// direct row access (contiguous storage) of the right extensions
+		rowExtE = &(hybridE.data()[(i1+w1)*size2]);
+		rowExtJ1 = &(hybridE_j1.data()[(i1+w1)*size2]);
+		rowExtJ2 = &(hybridE_j2.data()[(i1+w1)*size2]);
+		// iterate only over right sides that can pair
+		for (w2=pairingMask.getNextPairing(i1+w1,i2+1)-i2; w2-1 <= maxLoop2 && i2+w2<size2; w2=pairingMask.getNextPairing(i1+w1,i2+w2+1)-i2) {
+			k2 = i2+w2;
 			// check if right side can pair
-			if (E_isINF(rightExt->E)) {
+			if (E_isINF(rowExtE[k2])) {
 				continue;
 			}
 			// check if interaction length is within boundary
-			if ( (rightExt->j1 +1 -i1) > energy.getAccessibility1().getMaxLength()
-				|| (rightExt->j2 +1 -i2) > energy.getAccessibility2().getMaxLength() )
+			if ( (w1 +rowExtJ1[k2] +1) > maxLength1
+				|| (w2 +rowExtJ2[k2] +1) > maxLength2 )
 			{
 				continue;
 			}
 			// compute energy for this loop sizes
-			curE = energy.getE_interLeft(i1,i1+w1,i2,i2+w2) + rightExt->E;
+			curE = energyModel.getE_interLeft(i1+offset1,i1+w1+offset1,i2+offset2,k2+offset2) + rowExtE[k2];
+			INTARNA_COUNT_WORK( work.loopEvaluations++ );
 			// check if this combination yields better energy
-			curEtotal = energy.getE(i1,rightExt->j1,i2,rightExt->j2,curE);
+			curEtotal = InteractionEnergy::getE<EnergyType,AccDisabled>( energyModel, i1+offset1, i1+w1+rowExtJ1[k2]+offset1, i2+offset2, k2+rowExtJ2[k2]+offset2, curE );
 			if ( curEtotal < curCellEtotal )
 			{
 				// update current best for this left boundary
-				// copy right boundary
-				*curCell = *rightExt;
-				// set new energy
-				curCell->E = curE;
+				curCellE = curE;
+				curCellJ1 = i1+w1+rowExtJ1[k2];
+				curCellJ2 = k2+rowExtJ2[k2];
+				curCellTrace = (TracePointer)(w1<<8 | w2);
 				// store total energy to avoid recomputation
 				curCellEtotal = curEtotal;
 			}
@@ -154,16 +412,57 @@ fillHybridE()
 		} // w2
 		} // w1
 
-		// update mfe if needed
-		updateOptima( i1,curCell->j1, i2,curCell->j2, curCellEtotal, false );
+		// check if extensions to the left (up to the maximal interaction
+		// lengths) can beat the bound given the right part of this entry
+		if (prune && !( curCellE
+					+ (E_type)std::min( std::min( i1, i1+maxLength1-1-curCellJ1 ), std::min( i2, i2+maxLength2-1-curCellJ2 ) )*pruneLoopE
+					+ pruneEndsE + pruningMinED1[i1] + pruningMinED2[i2] < pruneBound ))
+		{
+			prunePruned++;
+			curCellE = E_INF;
+			curCellEtotal = E_INF;
+		}
+
+		// store best entry
+		hybridE(i1,i2) = curCellE;
+		hybridE_j1(i1,i2) = (BoundaryOffset)(curCellJ1-i1);
+		hybridE_j2(i1,i2) = (BoundaryOffset)(curCellJ2-i2);
+		if (storeTrace) {
+			hybridE_trace(i1,i2) = curCellTrace;
+		}
+
+		// store total energy for the update of the optima
+		rowE[r] = curCellEtotal;
 
 	} // i2
-	} // i1
+
+	// update pruning statistics
+	if (prune) {
+#if INTARNA_MULITHREADING
+		#pragma omp atomic
+#endif
+		pruningCellsEvaluated += pruneEvaluated;
+#if INTARNA_MULITHREADING
+		#pragma omp atomic
+#endif
+		pruningCellsPruned += prunePruned;
+	}
+	// update work statistics (thread-safe)
+	INTARNA_COUNT_WORK( workCounters.add( work ); )
 
 }
 
 ////////////////////////////////////////////////////////////////////////////
 
+bool
+PredictorMfe2dHeuristic::
+isTraceBackConcurrent() const
+{
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 void
 PredictorMfe2dHeuristic::
 traceBack( Interaction & interaction, const OutputConstraint & outConstraint  )
@@ -205,9 +504,9 @@ traceBack( Interaction & interaction, const OutputConstraint & outConstraint  )
 
 
 	// the currently traced value for i1-j1, i2-j2
-	E_type curE = hybridE(i1,i2).E;
-	assert( hybridE(i1,i2).j1 == j1 );
-	assert( hybridE(i1,i2).j2 == j2 );
+	E_type curE = hybridE(i1,i2);
+	assert( i1+hybridE_j1(i1,i2) == j1 );
+	assert( i2+hybridE_j2(i1,i2) == j2 );
 	assert( i1 <= j1 );
 	assert( i2 <= j2 );
 	assert( j1 < hybridE.size1() );
@@ -216,21 +515,32 @@ traceBack( Interaction & interaction, const OutputConstraint & outConstraint  )
 	// trace back
 	// temp variables
 	size_t k1,k2;
+	// follow the stored traceback pointers if available
+	if (!hybridE_trace.data().empty()) {
+		while( i1 < j1 ) {
+			const TracePointer trace = hybridE_trace(i1,i2);
+			assert( trace != 0 );
+			i1 += (trace >> 8);
+			i2 += (trace & 0xFF);
+			// store splitting base pair if not last one of interaction range
+			if ( i1 < j1 ) {
+				interaction.basePairs.push_back( energy.getBasePair(i1,i2) );
+			}
+		}
+		assert( i2 == j2 );
+	}
 	// check all possible splits of the interval (i1,i2)-(j1,j2)
 	// only reasonable, if there is an enclosed position k1 between i1-j1
 	while( (j1-i1) > 1 ) {
 
-		const BestInteraction * curCell = NULL;
 		bool traceNotFound = true;
 		// check all combinations of decompositions into (i1,i2)..(k1,k2)-(j1,j2)
 		for (k1=std::min(j1,i1+energy.getMaxInternalLoopSize1()+1); traceNotFound && k1>i1; k1--) {
 		for (k2=std::min(j2,i2+energy.getMaxInternalLoopSize2()+1); traceNotFound && k2>i2; k2--) {
-			// temp access to current cell
-			curCell = &(hybridE(k1,k2));
 			// check if right boundary is equal (part of the heuristic)
-			if ( curCell->j1 == j1 && curCell->j2 == j2 &&
+			if ( k1+hybridE_j1(k1,k2) == j1 && k2+hybridE_j2(k1,k2) == j2 &&
 					// and energy is the source of curE
-					E_equal( curE, (energy.getE_interLeft(i1,k1,i2,k2) + curCell->E ) ) )
+					E_equal( curE, (energy.getE_interLeft(i1,k1,i2,k2) + hybridE(k1,k2) ) ) )
 			{
 				// stop searching
 				traceNotFound = false;
@@ -241,7 +551,7 @@ traceBack( Interaction & interaction, const OutputConstraint & outConstraint  )
 				// trace right part of split
 				i1=k1;
 				i2=k2;
-				curE = curCell->E;
+				curE = hybridE(k1,k2);
 			}
 		}
 		}
@@ -277,13 +587,11 @@ getNextBest( Interaction & curBest )
 	// identify cell with next best non-overlapping interaction site
 	// iterate (decreasingly) over all left interaction starts
 	size_t i1,i2;
-	BestInteraction * curBestCell = NULL;
 	E_type curBestCellE = E_INF;
-	Interaction::BasePair curBestCellStart;
-	BestInteraction * curCell = NULL;
+	Interaction::BasePair curBestCellStart, curBestCellEnd;
 	E_type curCellE = E_INF;
 	IndexRange r1,r2;
-	for (i1=hybridE.size1(); i1-- > 0;) {
+	for (i1=hybridErowsToFill; i1-- > 0;) {
 		// ensure interaction site start is not covered
 		if (reportedInteractions.first.covers(i1)) {
 			continue;
@@ -293,15 +601,13 @@ getNextBest( Interaction & curBest )
 			if (reportedInteractions.second.covers(i2)) {
 				continue;
 			}
-			// direct cell access
-			curCell = &(hybridE(i1,i2));
 			// check if left side can pair
-			if (E_isINF(curCell->E))
+			if (E_isINF(hybridE(i1,i2)))
 			{
 				continue;
 			}
 			// get overall energy of the interaction
-			curCellE = energy.getE(i1,curCell->j1,i2,curCell->j2,curCell->E);
+			curCellE = energy.getE(i1,i1+hybridE_j1(i1,i2),i2,i2+hybridE_j2(i1,i2),hybridE(i1,i2));
 			// or energy is too low to be considered
 			// or energy is higher than current best found so far
 			if (curCellE < curBestE || curCellE >= curBestCellE )
@@ -310,21 +616,22 @@ getNextBest( Interaction & curBest )
 			}
 			// ensure site is not overlapping
 			r1.from = i1;
-			r1.to = curCell->j1;
+			r1.to = i1+hybridE_j1(i1,i2);
 			if ( reportedInteractions.first.overlaps( r1 )) {
 				continue;
 			}
 			r2.from = i2;
-			r2.to = curCell->j2;
+			r2.to = i2+hybridE_j2(i1,i2);
 			if ( reportedInteractions.second.overlaps( r2 )) {
 				continue;
 			}
 			//// FOUND THE NEXT BETTER SOLUTION
 			// overwrite current best found so far
-			curBestCell = curCell;
 			curBestCellE = curCellE;
 			curBestCellStart.first = i1;
 			curBestCellStart.second = i2;
+			curBestCellEnd.first = r1.to;
+			curBestCellEnd.second = r2.to;
 
 		} // i2
 	} // i1
@@ -334,11 +641,21 @@ getNextBest( Interaction & curBest )
 	curBest.basePairs.resize(2);
 	if (E_isNotINF(curBestCellE)) {
 		curBest.basePairs[0] = energy.getBasePair( curBestCellStart.first, curBestCellStart.second );
-		curBest.basePairs[1] = energy.getBasePair( curBestCell->j1, curBestCell->j2 );
+		curBest.basePairs[1] = energy.getBasePair( curBestCellEnd.first, curBestCellEnd.second );
 	}
 }
 
 ////////////////////////////////////////////////////////////////////////////
 
+size_t
+PredictorMfe2dHeuristic::
+getMemoryEstimate( const size_t size1, const size_t size2 )
+{
+	// hybridE, hybridE_j1, hybridE_j2, hybridE_trace and pairingMask (upper bound)
+	return size1*size2*(sizeof(EnergyMatrix::value_type)+2*sizeof(BoundaryMatrix::value_type)+sizeof(TraceMatrix::value_type)+1);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 } // namespace
 
@@ -3,7 +3,12 @@
 #define INTARNA_PREDICTORMFE2DHEURISTIC_H_
 
 #include "IntaRNA/PredictorMfe.h"
+#include "IntaRNA/HugePageAllocator.h"
 #include "IntaRNA/Interaction.h"
+#include "IntaRNA/PairingMask.h"
+
+#include <cstdint>
+#include <vector>
 
 #include <boost/numeric/ublas/matrix.hpp>
 
@@ -19,6 +24,15 @@ namespace IntaRNA {
  *
  * This yields a quadratic time and space complexity.
  *
+ * The right boundaries are stored as 16 bit offsets relative to the left
+ * boundary, such that a matrix cell takes 8 bytes only. Thus, the
+ * interaction length is limited to maxBoundaryOffset+1 positions in both
+ * sequences, independently of the accessibility's maximal length.
+ *
+ * The recursion kernel is instantiated for the common interior loop size
+ * limits 0 (stackings only) and 16 (default) of both sequences, such that
+ * its loops can be unrolled; other setups use a generic kernel.
+ *
  * @author Martin Mann
  *
  */
@@ -26,29 +40,50 @@ class PredictorMfe2dHeuristic: public PredictorMfe {
 
 protected:
 
+	//! type of the right boundary offsets relative to the left boundary
+	typedef uint16_t BoundaryOffset;
+
+	//! the maximal offset of the right boundary of an interaction, i.e.
+	//! the maximal interaction length is maxBoundaryOffset+1
+	static const size_t maxBoundaryOffset = UINT16_MAX;
+
 	/**
 	 * Describes the currently best interaction found for a left interaction
-	 * boundary i1,i2
+	 * boundary i1,i2 (8 bytes)
 	 */
 	class BestInteraction {
 	public:
 
 		//! init data
-		BestInteraction( const E_type E=E_INF, const size_t j1=RnaSequence::lastPos, const size_t j2=RnaSequence::lastPos )
-			: E(E), j1(j1), j2(j2)
+		BestInteraction( const E_type E=E_INF, const size_t d1=0, const size_t d2=0 )
+			: E(E), d1((BoundaryOffset)d1), d2((BoundaryOffset)d2)
 		{}
 
 	public:
 		//! energy of the interaction
 		E_type E;
-		//! right end of the interaction in seq1
-		size_t j1;
-		//! right end of the interaction in seq2
-		size_t j2;
+		//! right end of the interaction in seq1 relative to i1, i.e. j1-i1
+		BoundaryOffset d1;
+		//! right end of the interaction in seq2 relative to i2, i.e. j2-i2
+		BoundaryOffset d2;
 	};
 
 	//! matrix type to hold the mfe energies and boundaries for interaction site starts
-	typedef boost::numeric::ublas::matrix<BestInteraction> E2dMatrix;
+	//! (vector storage keeps its capacity when resized for smaller windows)
+	typedef boost::numeric::ublas::matrix<BestInteraction, boost::numeric::ublas::row_major, HugePageAllocator<BestInteraction>::vector > E2dMatrix;
+
+	//! matrix type to hold the mfe energies for interaction site starts
+	typedef boost::numeric::ublas::matrix<E_type, boost::numeric::ublas::row_major, HugePageAllocator<E_type>::vector > EnergyMatrix;
+
+	//! matrix type to hold the right boundary offsets for interaction site starts
+	typedef boost::numeric::ublas::matrix<BoundaryOffset, boost::numeric::ublas::row_major, HugePageAllocator<BoundaryOffset>::vector > BoundaryMatrix;
+
+	//! traceback pointer to the right extension (i1+w1,i2+w2) of a cell
+	//! encoded as (w1<<8 | w2); 0 if there is no right extension
+	typedef uint16_t TracePointer;
+
+	//! matrix type to hold the traceback pointers for interaction site starts
+	typedef boost::numeric::ublas::matrix<TracePointer, boost::numeric::ublas::row_major, HugePageAllocator<TracePointer>::vector > TraceMatrix;
 
 public:
 
@@ -83,6 +118,61 @@ public:
 			, const IndexRange & r2 = IndexRange(0,RnaSequence::lastPos)
 			, const OutputConstraint & outConstraint = OutputConstraint() );
 
+	/**
+	 * Computes the mfe interactions for overlapping windows of r1 (see
+	 * IndexRange::overlappingWindows()) and the range r2 and reports the
+	 * optima of each window to the output handler.
+	 *
+	 * The windows are processed from right to left. Since the recursion
+	 * runs right-to-left, only the rows of a window that are not covered by
+	 * its right neighbour are computed, while the rows of the overlap (that
+	 * can be reached by an interaction) are carried over. Thus, the overall
+	 * effort is that of a single pass over r1, while the memory is bounded
+	 * by the window width. Each window reports only interactions starting
+	 * within its computed rows.
+	 *
+	 * @param r1 the index range of the first sequence to be cut into windows
+	 * @param r2 the index range of the second sequence interacting with r1
+	 * @param windowWidth the width of the windows of r1
+	 * @param windowOverlap the overlap of successive windows of r1
+	 * @param outConstraint constrains the interactions reported to the output handler
+	 *
+	 */
+	virtual
+	void
+	predictWindows( const IndexRange & r1
+			, const IndexRange & r2
+			, const size_t windowWidth
+			, const size_t windowOverlap
+			, const OutputConstraint & outConstraint = OutputConstraint() );
+
+	/**
+	 * Computes the memory needed for the matrices of a predict() call.
+	 *
+	 * @param size1 the length of the first sequence (window)
+	 * @param size2 the length of the second sequence (window)
+	 *
+	 * @return the estimated number of bytes
+	 */
+	static
+	size_t
+	getMemoryEstimate( const size_t size1, const size_t size2 );
+
+	/**
+	 * Enables or disables the storage of traceback pointers during the
+	 * recursion. If enabled, the right extension of each cell's best
+	 * interaction is stored (2 bytes per cell), such that the traceback is a
+	 * linear walk instead of a reevaluation of all loop energies. This pays
+	 * off if many (suboptimal) interactions are to be reported.
+	 * Pointers are only stored if both maximal interior loop sizes are
+	 * below 255.
+	 *
+	 * @param enable whether or not traceback pointers are to be stored
+	 */
+	void
+	setTraceStorage( const bool enable );
+
+
 protected:
 
 	//! access to the interaction energy handler of the super class
@@ -97,17 +187,137 @@ protected:
 	// TODO provide all data structures as arguments to make predict() call threadsafe
 
 	//! energy of all interaction hybrids starting in i1,i2
-	E2dMatrix hybridE;
+	//! (E_INF if no interaction possible);
+	//! NOTE: the best interactions are stored as structure of arrays
+	//! (hybridE, hybridE_j1, hybridE_j2) such that the recursion scans
+	//! contiguous energy rows only
+	EnergyMatrix hybridE;
+
+	//! right end in seq1 of the best interaction starting in i1,i2
+	//! relative to i1, i.e. j1-i1
+	BoundaryMatrix hybridE_j1;
+
+	//! right end in seq2 of the best interaction starting in i1,i2
+	//! relative to i2, i.e. j2-i2
+	BoundaryMatrix hybridE_j2;
+
+	//! whether or not traceback pointers are to be stored (see setTraceStorage())
+	bool traceStorage;
+
+	//! traceback pointers of the best interactions starting in i1,i2;
+	//! empty if no pointers are stored
+	TraceMatrix hybridE_trace;
+
+	//! the positions (i1,i2) that can form an interaction within hybridE
+	PairingMask pairingMask;
+
+	//! the number of leading rows of hybridE that are computed by
+	//! fillHybridE() and screened by getNextBest(); all remaining rows are
+	//! carried over from the previous window by predictWindows()
+	size_t hybridErowsToFill;
 
 protected:
 
 	/**
-	 * Computes all entries of the hybridE matrix
+	 * Resizes hybridE, hybridE_j1 and hybridE_j2 as well as hybridE_trace
+	 * if traceback pointers are to be stored.
+	 * @param size1 the number of rows (seq1)
+	 * @param size2 the number of columns (seq2)
+	 */
+	void
+	resizeHybridE( const size_t size1, const size_t size2 );
+
+	/**
+	 * Provides the best interaction starting in i1,i2.
+	 * @param i1 the interaction start in seq1
+	 * @param i2 the interaction start in seq2
+	 * @return the energy and right boundary offsets of the best interaction
+	 */
+	BestInteraction
+	getHybridE( const size_t i1, const size_t i2 ) const;
+
+	/**
+	 * Sets up pairingMask for the current size of hybridE and initializes
+	 * all hybridE entries of the leading rows that can form an interaction
+	 * with the interaction initiation energy and all other with E_INF.
+	 * The number of initialized rows is stored in hybridErowsToFill.
+	 *
+	 * @param rows the number of leading rows to initialize; all other rows
+	 *        are kept (all rows are initialized if exceeding the row number)
+	 */
+	void
+	initHybridE( const size_t rows = RnaSequence::lastPos );
+
+	/**
+	 * Computes all entries of the hybridE matrix using the recursion kernel
+	 * specific for the energy model used (if available).
 	 */
 	virtual
 	void
 	fillHybridE();
 
+	/**
+	 * Computes all entries of the hybridE matrix, where all energy calls are
+	 * done via the given energy handler with shifted indices. Thus, if
+	 * EnergyType is a final energy class, all energy calls of the recursion
+	 * are bound at compile time.
+	 *
+	 * @param energyModel the energy handler to use
+	 * @param offset1 the index offset of seq1 to be applied for energyModel
+	 * @param offset2 the index offset of seq2 to be applied for energyModel
+	 *
+	 * @tparam AccDisabled whether or not the accessibility of both sequences
+	 *        is disabled (see InteractionEnergy::isAccessibilityDisabled()),
+	 *        such that all accessibility terms are evaluated without ED lookups
+	 */
+	template < class EnergyType, bool AccDisabled >
+	void
+	fillHybridE( const EnergyType & energyModel
+				, const size_t offset1
+				, const size_t offset2 );
+
+	/**
+	 * Computes the hybridE entries for a block of pairing positions within
+	 * the row i1. Since the entries of a row depend on entries of
+	 * subsequent rows only, different blocks of a row can be computed
+	 * independently. The optima are not updated.
+	 *
+	 * @param energyModel the energy handler to use
+	 * @param offset1 the index offset of seq1 to be applied for energyModel
+	 * @param offset2 the index offset of seq2 to be applied for energyModel
+	 * @param i1 the row of hybridE to compute
+	 * @param rowI2 the pairing positions of the row to compute
+	 * @param rowE IN/OUT the overall energies of the row's entries
+	 *        (same indexing as rowI2, E_INF if the entry is not used)
+	 * @param from the first index within rowI2 to compute
+	 * @param to the index within rowI2 after the last to compute
+	 * @param pruneBound entries whose optimistic total energy of all
+	 *        interactions covering them is not below this bound are set to
+	 *        E_INF (E_INF disables pruning, see getPruningBound())
+	 *
+	 * @tparam MaxLoop the maximal interior loop size for both sequences
+	 *        known at compile time to enable loop unrolling; if negative,
+	 *        the sizes of the energy handler are used
+	 * @tparam AccDisabled whether or not the accessibility of both sequences
+	 *        is disabled (see InteractionEnergy::isAccessibilityDisabled()),
+	 *        such that all accessibility terms are evaluated without ED lookups
+	 */
+	template < class EnergyType, int MaxLoop, bool AccDisabled >
+	void
+	fillHybridE( const EnergyType & energyModel
+				, const size_t offset1
+				, const size_t offset2
+				, const size_t i1
+				, const std::vector<size_t> & rowI2
+				, std::vector<E_type> & rowE
+				, const size_t from
+				, const size_t to
+				, const E_type pruneBound );
+
+	//! number of pairing positions within a row of hybridE that are computed
+	//! within one parallel task
+	static const size_t hybridERowBlockSize;
+
 	/**
 	 * Fills a given interaction (boundaries given) with the according
 	 * hybridizing base pairs.
@@ -118,6 +328,14 @@ protected:
 	void
 	traceBack( Interaction & interaction, const OutputConstraint & outConstraint  );
 
+	/**
+	 * Whether or not traceBack() can be called concurrently.
+	 * @return true, since the traceback only reads the filled matrices
+	 */
+	virtual
+	bool
+	isTraceBackConcurrent() const;
+
 	/**
 	 * Identifies the next best interaction with an energy equal to or higher
 	 * than the given interaction. The new interaction will not overlap any
@@ -134,6 +352,48 @@ protected:
 
 };
 
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+
+inline
+void
+PredictorMfe2dHeuristic::
+resizeHybridE( const size_t size1, const size_t size2 )
+{
+	hybridE.resize( size1, size2, false );
+	hybridE_j1.resize( size1, size2, false );
+	hybridE_j2.resize( size1, size2, false );
+	// traceback pointers need loop sizes encodable in a byte each
+	if (traceStorage && energy.getMaxInternalLoopSize1() < 255 && energy.getMaxInternalLoopSize2() < 255) {
+		hybridE_trace.resize( size1, size2, false );
+	} else {
+		hybridE_trace.resize( 0, 0, false );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+void
+PredictorMfe2dHeuristic::
+setTraceStorage( const bool enable )
+{
+	traceStorage = enable;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+PredictorMfe2dHeuristic::BestInteraction
+PredictorMfe2dHeuristic::
+getHybridE( const size_t i1, const size_t i2 ) const
+{
+	return BestInteraction( hybridE(i1,i2), hybridE_j1(i1,i2), hybridE_j2(i1,i2) );
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 } // namespace
 
 #endif /* INTARNA_PREDICTORMFE2DHEURISTIC_H_ */
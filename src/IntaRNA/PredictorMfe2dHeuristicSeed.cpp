@@ -1,6 +1,7 @@
 
 #include "IntaRNA/PredictorMfe2dHeuristicSeed.h"
 
+#include <algorithm>
 #include <stdexcept>
 
 namespace IntaRNA {
@@ -73,33 +74,16 @@ predict( const IndexRange & r1
 	}
 
 	// resize matrix
-	hybridE.resize( hybridEsize1, hybridEsize2 );
-	hybridE_seed.resize( hybridE.size1(), hybridE.size2() );
+	resizeHybridE( hybridEsize1, hybridEsize2 );
+	hybridE_seed.resize( hybridE.size1(), hybridE.size2(), false );
 
 	// temp vars
 	size_t i1,i2,w1,w2;
 
 	// init hybridE matrix
-	bool isValidCell = true;
-	for (i1=0; i1<hybridE.size1(); i1++) {
-	for (i2=0; i2<hybridE.size2(); i2++) {
-
-		// check if positions can form interaction
-		if (	energy.isAccessible1(i1)
-				&& energy.isAccessible2(i2)
-				&& energy.areComplementary(i1,i2) )
-		{
-			// set to interaction initiation with according boundary
-			hybridE(i1,i2) = BestInteraction(energy.getE_init(), i1, i2);
-		} else {
-			// set to infinity, ie not used
-			hybridE(i1,i2) = BestInteraction(E_INF, RnaSequence::lastPos, RnaSequence::lastPos);
-		}
-		// init seed data
-		hybridE_seed(i1,i2) = BestInteraction(E_INF, RnaSequence::lastPos, RnaSequence::lastPos);
-
-	} // i2
-	} // i1
+	initHybridE();
+	// init seed data
+	std::fill( hybridE_seed.data().begin(), hybridE_seed.data().end(), BestInteraction() );
 
 	// init mfe without seed condition
 	OutputConstraint tmpOutConstraint(1, outConstraint.reportOverlap, outConstraint.maxE, outConstraint.deltaE);
@@ -112,7 +96,7 @@ predict( const IndexRange & r1
 
 	// check if any interaction possible
 	// if not no seed-containing interaction is possible neither
-	if (!(this->mfeInteractions.begin()->energy < tmpOutConstraint.maxE)) {
+	if (!(getOptimumE() < tmpOutConstraint.maxE)) {
 		// stop computation since no favorable interaction found
 		reportOptima(tmpOutConstraint);
 		return;
@@ -126,13 +110,16 @@ predict( const IndexRange & r1
 	E_type curE = E_INF, curEtotal = E_INF, curCellEtotal = E_INF;
 	BestInteraction * curCell = NULL;
 	const BestInteraction * rightExt = NULL;
+	// maximal interaction lengths (limited by the range of the relative boundaries)
+	const size_t maxLength1 = std::min( energy.getAccessibility1().getMaxLength(), maxBoundaryOffset+1 );
+	const size_t maxLength2 = std::min( energy.getAccessibility2().getMaxLength(), maxBoundaryOffset+1 );
 
-	// iterate (decreasingly) over all left interaction starts
+	// iterate (decreasingly) over all left interaction starts that can pair
 	for (i1=hybridE_seed.size1(); i1-- > 0;) {
-	for (i2=hybridE_seed.size2(); i2-- > 0;) {
+	for (i2=pairingMask.getPrevPairing(i1,hybridE_seed.size2()); i2 != RnaSequence::lastPos; i2=pairingMask.getPrevPairing(i1,i2)) {
 
 		// check if left side can pair
-		if (E_isINF(hybridE(i1,i2).E)) {
+		if (E_isINF(hybridE(i1,i2))) {
 			continue;
 		}
 		// direct cell access
@@ -152,7 +139,8 @@ predict( const IndexRange & r1
 		// TODO PARALLELIZE THIS DOUBLE LOOP ?!
 		// iterate over all loop sizes w1 (seq1) and w2 (seq2)
 		for (w1=1; w1-1 <= energy.getMaxInternalLoopSize1() && i1+w1<hybridE_seed.size1(); w1++) {
-		for (w2=1; w2-1 <= energy.getMaxInternalLoopSize2() && i2+w2<hybridE_seed.size2(); w2++) {
+		// iterate only over right sides that can pair
+		for (w2=pairingMask.getNextPairing(i1+w1,i2+1)-i2; w2-1 <= energy.getMaxInternalLoopSize2() && i2+w2<hybridE_seed.size2(); w2=pairingMask.getNextPairing(i1+w1,i2+w2+1)-i2) {
 			// direct cell access to right side end of loop (seed has to be to the right of it)
 			rightExt = &(hybridE_seed(i1+w1,i2+w2));
 			// check if right side of loop can pair
@@ -160,20 +148,21 @@ predict( const IndexRange & r1
 				continue;
 			}
 			// check if interaction length is within boundary
-			if ( (rightExt->j1 +1 -i1) > energy.getAccessibility1().getMaxLength()
-				|| (rightExt->j2 +1 -i2) > energy.getAccessibility2().getMaxLength() )
+			if ( (w1 +rightExt->d1 +1) > maxLength1
+				|| (w2 +rightExt->d2 +1) > maxLength2 )
 			{
 				continue;
 			}
 			// compute energy for this loop sizes
 			curE = energy.getE_interLeft(i1,i1+w1,i2,i2+w2) + rightExt->E;
 			// check if this combination yields better energy
-			curEtotal = energy.getE(i1,rightExt->j1,i2,rightExt->j2,curE);
+			curEtotal = energy.getE(i1,i1+w1+rightExt->d1,i2,i2+w2+rightExt->d2,curE);
 			if ( curEtotal < curCellEtotal )
 			{
 				// update current best for this left boundary
-				// copy right boundary
-				*curCell = *rightExt;
+				// copy right boundary (relative to i1,i2)
+				curCell->d1 = (BoundaryOffset)(w1+rightExt->d1);
+				curCell->d2 = (BoundaryOffset)(w2+rightExt->d2);
 				// set new energy
 				curCell->E = curE;
 				// store overall energy
@@ -191,16 +180,19 @@ predict( const IndexRange & r1
 			// get right extension
 			w1 = seedHandler.getSeedLength1(i1,i2)-1; assert(i1+w1 < hybridE.size1());
 			w2 = seedHandler.getSeedLength2(i1,i2)-1; assert(i2+w2 < hybridE.size2());
-			rightExt = &(hybridE(i1+w1,i2+w2));
+			const BestInteraction seedRightExt = getHybridE(i1+w1,i2+w2);
 			// get energy of seed interaction with best right extension
-			curE = seedHandler.getSeedE(i1,i2) + rightExt->E;
+			curE = seedHandler.getSeedE(i1,i2) + seedRightExt.E;
 			// check if this combination yields better energy
-			curEtotal = energy.getE(i1,rightExt->j1,i2,rightExt->j2,curE);
-			if ( curEtotal < curCellEtotal )
+			curEtotal = energy.getE(i1,i1+w1+seedRightExt.d1,i2,i2+w2+seedRightExt.d2,curE);
+			if ( curEtotal < curCellEtotal
+				// ensure the right boundary can be stored
+				&& w1+seedRightExt.d1 <= maxBoundaryOffset && w2+seedRightExt.d2 <= maxBoundaryOffset )
 			{
 				// update current best for this left boundary
-				// copy right boundary
-				*curCell = *rightExt;
+				// copy right boundary (relative to i1,i2)
+				curCell->d1 = (BoundaryOffset)(w1+seedRightExt.d1);
+				curCell->d2 = (BoundaryOffset)(w2+seedRightExt.d2);
 				// set new energy
 				curCell->E = curE;
 				// store total energy
@@ -209,7 +201,7 @@ predict( const IndexRange & r1
 		}
 
 		// update mfe if needed (call superclass update routine)
-		PredictorMfe2dHeuristic::updateOptima( i1,curCell->j1, i2,curCell->j2, curCellEtotal, false );
+		PredictorMfe2dHeuristic::updateOptima( i1,i1+curCell->d1, i2,i2+curCell->d2, curCellEtotal, false );
 
 	} // i2
 	} // i1
@@ -220,6 +212,29 @@ predict( const IndexRange & r1
 
 }
 
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMfe2dHeuristicSeed::
+predictWindows( const IndexRange & r1
+		, const IndexRange & r2
+		, const size_t windowWidth
+		, const size_t windowOverlap
+		, const OutputConstraint & outConstraint )
+{
+	// independent prediction for each window
+	Predictor::predictWindows( r1, r2, windowWidth, windowOverlap, outConstraint );
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+PredictorMfe2dHeuristicSeed::
+isTraceBackConcurrent() const
+{
+	return false;
+}
 
 ////////////////////////////////////////////////////////////////////////////
 
@@ -265,8 +280,8 @@ traceBack( Interaction & interaction, const OutputConstraint & outConstraint  )
 
 	// the currently traced value for i1-j1, i2-j2
 	E_type curE = hybridE_seed(i1,i2).E;
-	assert( hybridE_seed(i1,i2).j1 == j1 );
-	assert( hybridE_seed(i1,i2).j2 == j2 );
+	assert( i1+hybridE_seed(i1,i2).d1 == j1 );
+	assert( i2+hybridE_seed(i1,i2).d2 == j2 );
 	assert( i1 <= j1 );
 	assert( i2 <= j2 );
 	assert( j1 < hybridE_seed.size1() );
@@ -285,7 +300,7 @@ traceBack( Interaction & interaction, const OutputConstraint & outConstraint  )
 			// temp access to current cell
 			curCell = &(hybridE_seed(k1,k2));
 			// check if right boundary is equal (part of the heuristic)
-			if ( curCell->j1 == j1 && curCell->j2 == j2 &&
+			if ( k1+curCell->d1 == j1 && k2+curCell->d2 == j2 &&
 					// and energy is the source of curE
 					E_equal( curE, (energy.getE_interLeft(i1,k1,i2,k2) + curCell->E ) ) )
 			{
@@ -307,7 +322,7 @@ traceBack( Interaction & interaction, const OutputConstraint & outConstraint  )
 			assert(E_isNotINF(seedHandler.getSeedE(i1,i2)));
 			k1 = i1+seedHandler.getSeedLength1(i1,i2)-1; assert(k1<hybridE.size1());
 			k2 = i2+seedHandler.getSeedLength2(i1,i2)-1; assert(k2<hybridE.size2());
-			curCell = &(hybridE(k1,k2)); assert( E_equal( curE, (seedHandler.getSeedE(i1,i2)+curCell->E) ));
+			assert( E_equal( curE, (seedHandler.getSeedE(i1,i2)+hybridE(k1,k2)) ));
 			// store seed information
 			interaction.setSeedRange(
 							energy.getBasePair(i1,i2),
@@ -398,7 +413,7 @@ getNextBest( Interaction & curBest )
 				continue;
 			}
 			// get overall energy of the interaction
-			curCellE = energy.getE(i1,curCell->j1,i2,curCell->j2,curCell->E);
+			curCellE = energy.getE(i1,i1+curCell->d1,i2,i2+curCell->d2,curCell->E);
 			// or energy is too low to be considered
 			// or energy is higher than current best found so far
 			if (curCellE < curBestE || curCellE >= curBestCellE )
@@ -407,12 +422,12 @@ getNextBest( Interaction & curBest )
 			}
 			// ensure site is not overlapping
 			r1.from = i1;
-			r1.to = curCell->j1;
+			r1.to = i1+curCell->d1;
 			if ( reportedInteractions.first.overlaps( r1 )) {
 				continue;
 			}
 			r2.from = i2;
-			r2.to = curCell->j2;
+			r2.to = i2+curCell->d2;
 			if ( reportedInteractions.second.overlaps( r2 )) {
 				continue;
 			}
@@ -431,12 +446,22 @@ getNextBest( Interaction & curBest )
 	curBest.energy = curBestCellE;
 	if (E_isNotINF(curBestCellE)) {
 		curBest.basePairs[0] = energy.getBasePair( curBestCellStart.first, curBestCellStart.second );
-		curBest.basePairs[1] = energy.getBasePair( curBestCell->j1, curBestCell->j2 );
+		curBest.basePairs[1] = energy.getBasePair( curBestCellStart.first+curBestCell->d1, curBestCellStart.second+curBestCell->d2 );
 	}
 
 }
 
 ////////////////////////////////////////////////////////////////////////////
 
+size_t
+PredictorMfe2dHeuristicSeed::
+getMemoryEstimate( const size_t size1, const size_t size2 )
+{
+	// matrices of the super class and hybridE_seed
+	return PredictorMfe2dHeuristic::getMemoryEstimate( size1, size2 ) + size1*size2*sizeof(E2dMatrix::value_type);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 } // namespace
 
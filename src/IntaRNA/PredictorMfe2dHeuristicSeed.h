@@ -63,6 +63,40 @@ public:
 			, const IndexRange & r2 = IndexRange(0,RnaSequence::lastPos)
 			, const OutputConstraint & outConstraint = OutputConstraint());
 
+	/**
+	 * Computes the mfe interactions for overlapping windows of r1 via
+	 * independent predict() calls, since the seed information cannot be
+	 * carried over between windows.
+	 *
+	 * @param r1 the index range of the first sequence to be cut into windows
+	 * @param r2 the index range of the second sequence interacting with r1
+	 * @param windowWidth the width of the windows of r1
+	 * @param windowOverlap the overlap of successive windows of r1
+	 * @param outConstraint constrains the interactions reported to the output handler
+	 *
+	 */
+	virtual
+	void
+	predictWindows( const IndexRange & r1
+			, const IndexRange & r2
+			, const size_t windowWidth
+			, const size_t windowOverlap
+			, const OutputConstraint & outConstraint = OutputConstraint() );
+
+	/**
+	 * Computes the memory needed for the matrices of a predict() call
+	 * (without the seed handler).
+	 *
+	 * @param size1 the length of the first sequence (window)
+	 * @param size2 the length of the second sequence (window)
+	 *
+	 * @return the estimated number of bytes
+	 */
+	static
+	size_t
+	getMemoryEstimate( const size_t size1, const size_t size2 );
+
+
 protected:
 
 	//! access to the interaction energy handler of the super class
@@ -105,6 +139,16 @@ protected:
 			, const E_type energy
 			, const bool isHybridE );
 
+	/**
+	 * Disables pruning, since the energy bounds of the unconstrained
+	 * recursion neglect the seed constraint.
+	 *
+	 * @return E_INF
+	 */
+	virtual
+	E_type
+	getPruningBound() const;
+
 	/**
 	 * Fills a given interaction (boundaries given) with the according
 	 * hybridizing base pairs.
@@ -115,6 +159,14 @@ protected:
 	void
 	traceBack( Interaction & interaction, const OutputConstraint & outConstraint  );
 
+	/**
+	 * Whether or not traceBack() can be called concurrently.
+	 * @return false, since the seed traceback might recompute seed recursion data
+	 */
+	virtual
+	bool
+	isTraceBackConcurrent() const;
+
 
 	/**
 	 * Identifies the next best interaction (containing a seed)
@@ -157,6 +209,16 @@ updateOptima( const size_t i1, const size_t j1
 
 //////////////////////////////////////////////////////////////////////////
 
+inline
+E_type
+PredictorMfe2dHeuristicSeed::
+getPruningBound() const
+{
+	return E_INF;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 } // namespace
 
 #endif /* INTARNA_PREDICTORMFE2DHEURISTICSEED_H_ */
@@ -0,0 +1,632 @@
+
+#include "IntaRNA/PredictorMfe2dHeuristicSeedSparse.h"
+#include "IntaRNA/InteractionEnergyVrna.h"
+#include "IntaRNA/InteractionEnergyBasePair.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace IntaRNA {
+
+////////////////////////////////////////////////////////////////////////////
+
+PredictorMfe2dHeuristicSeedSparse::
+PredictorMfe2dHeuristicSeedSparse( const InteractionEnergy & energy
+		, OutputHandler & output
+		, PredictionTracker * predTracker
+		, SeedHandler * seedHandlerInstance
+		)
+ : PredictorMfe(energy,output,predTracker)
+	, seedHandler( seedHandlerInstance )
+	, regions()
+	, regionRow()
+	, hybridE( 0,0 )
+	, hybridE_j1( 0,0 )
+	, hybridE_j2( 0,0 )
+	, hybridE_seed( 0,0 )
+	, pairingMask()
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+
+PredictorMfe2dHeuristicSeedSparse::
+~PredictorMfe2dHeuristicSeedSparse()
+{
+	// clean up
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMfe2dHeuristicSeedSparse::
+predict( const IndexRange & r1
+		, const IndexRange & r2
+		, const OutputConstraint & outConstraint )
+{
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_logOutput)
+#endif
+	{ VLOG(2) <<"predicting mfe interactions with seed heuristically around seed anchors..."; }
+	// measure timing
+	TIMED_FUNC_IF(timerObj,VLOG_IS_ON(9));
+
+#if INTARNA_IN_DEBUG_MODE
+	// check indices
+	if (!(r1.isAscending() && r2.isAscending()) )
+		throw std::runtime_error("PredictorMfe2dHeuristicSeedSparse::predict("+toString(r1)+","+toString(r2)+") is not sane");
+#endif
+
+	// set index offset
+	energy.setOffset1(r1.from);
+	energy.setOffset2(r2.from);
+	seedHandler.setOffset1(r1.from);
+	seedHandler.setOffset2(r2.from);
+
+	const size_t size1 = std::min( energy.size1()
+			, (r1.to==RnaSequence::lastPos?energy.size1()-1:r1.to)-r1.from+1 );
+	const size_t size2 = std::min( energy.size2()
+			, (r2.to==RnaSequence::lastPos?energy.size2()-1:r2.to)-r2.from+1 );
+
+	// init mfe for later updates
+	initOptima( outConstraint );
+
+	// compute seed interactions for whole range
+	// and check if any seed possible
+	if (seedHandler.fillSeed( 0, size1-1, 0, size2-1 ) == 0) {
+		// trigger empty interaction reporting
+		reportOptima(outConstraint);
+		// stop computation
+		return;
+	}
+
+	// identify the regions to be computed
+	initRegions( size1, size2 );
+
+	// resize matrices to hold the rows of all regions
+	const size_t rows = regionRow.back() + (regions.back().to - regions.back().from + 1);
+	hybridE.resize( rows, size2, false );
+	hybridE_j1.resize( rows, size2, false );
+	hybridE_j2.resize( rows, size2, false );
+	hybridE_seed.resize( rows, size2, false );
+
+	// compute the regions independently and update mfeInteraction
+	for (size_t r = regions.size(); r-- > 0; ) {
+		fillRegion( r );
+	}
+
+	// trace back and output handler update
+	reportOptima( outConstraint );
+
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMfe2dHeuristicSeedSparse::
+initRegions( const size_t size1, const size_t size2 )
+{
+	regions.clear();
+	regionRow.clear();
+
+	// maximal extent of interactions containing a seed
+	const size_t maxLength1 = std::max( (size_t)1, energy.getAccessibility1().getMaxLength() );
+	const size_t seedBP = seedHandler.getConstraint().getBasePairs();
+
+	size_t anchors = 0;
+	for (size_t i1=0; i1<size1; i1++) {
+		// check if any seed starts within this row
+		bool isAnchor = false;
+		for (size_t i2=0; !isAnchor && i2<size2; i2++) {
+			isAnchor = E_isNotINF( seedHandler.getSeedE(i1,i2) );
+		}
+		if (!isAnchor) {
+			continue;
+		}
+		anchors++;
+		// all interactions containing a seed starting in i1
+		// + right context of the seed-free recursion for their right ends
+		const IndexRange neighborhood( (i1+seedBP > maxLength1 ? i1+seedBP-maxLength1 : 0)
+									, std::min( size1-1, i1+2*(maxLength1-1) ) );
+		// merge with previous region if overlapping or adjacent
+		// (both boundaries are increasing with i1)
+		if (!regions.empty() && neighborhood.from <= regions.rbegin()->to+1) {
+			regions.rbegin()->to = neighborhood.to;
+		} else {
+			regions.push_back( neighborhood );
+		}
+	}
+
+	// consecutive matrix rows of the regions
+	size_t rows = 0;
+	for (std::vector<IndexRange>::const_iterator r = regions.begin(); r != regions.end(); r++) {
+		regionRow.push_back( rows );
+		rows += r->to - r->from + 1;
+	}
+
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_logOutput)
+#endif
+	{ VLOG(2) <<anchors<<" seed anchors : computing "<<regions.size()<<" regions with "<<rows<<" of "<<size1<<" positions of seq1"; }
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+size_t
+PredictorMfe2dHeuristicSeedSparse::
+getRegion( const size_t i1 ) const
+{
+	// binary search for the first region starting after i1
+	size_t r = 0, rEnd = regions.size();
+	while (r < rEnd) {
+		const size_t mid = r + (rEnd-r)/2;
+		if (regions.at(mid).from <= i1) {
+			r = mid+1;
+		} else {
+			rEnd = mid;
+		}
+	}
+#if INTARNA_IN_DEBUG_MODE
+	if (r == 0 || regions.at(r-1).to < i1) {
+		throw std::runtime_error("PredictorMfe2dHeuristicSeedSparse::getRegion("+toString(i1)+") : not covered by any region");
+	}
+#endif
+	return r-1;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMfe2dHeuristicSeedSparse::
+fillRegion( const size_t r )
+{
+	// use the recursion kernel specific for the energy model
+	// (and skip all accessibility lookups if disabled)
+	if (energyVrna != NULL) {
+		if (energyVrna->isAccessibilityDisabled()) {
+			fillRegion<InteractionEnergyVrna,true>( *energyVrna, energy.getOffset1(), energy.getOffset2(), r );
+		} else {
+			fillRegion<InteractionEnergyVrna,false>( *energyVrna, energy.getOffset1(), energy.getOffset2(), r );
+		}
+	} else
+	if (energyBasePair != NULL) {
+		if (energyBasePair->isAccessibilityDisabled()) {
+			fillRegion<InteractionEnergyBasePair,true>( *energyBasePair, energy.getOffset1(), energy.getOffset2(), r );
+		} else {
+			fillRegion<InteractionEnergyBasePair,false>( *energyBasePair, energy.getOffset1(), energy.getOffset2(), r );
+		}
+	} else {
+		fillRegion<InteractionEnergyIdxOffset,false>( energy, 0, 0, r );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+template < class EnergyType, bool AccDisabled >
+void
+PredictorMfe2dHeuristicSeedSparse::
+fillRegion( const EnergyType & energyModel
+			, const size_t offset1
+			, const size_t offset2
+			, const size_t r )
+{
+	const IndexRange & region = regions.at(r);
+	// difference of a position of seq1 within the region and its matrix row
+	const size_t rowShift = region.from - regionRow.at(r);
+
+	// loop-independent constraints
+	const size_t maxLoop1 = energyModel.getMaxInternalLoopSize1();
+	const size_t maxLoop2 = energyModel.getMaxInternalLoopSize2();
+	// (limited by the range of the relative boundaries)
+	const size_t maxLength1 = std::min( energyModel.getAccessibility1().getMaxLength(), maxBoundaryOffset+1 );
+	const size_t maxLength2 = std::min( energyModel.getAccessibility2().getMaxLength(), maxBoundaryOffset+1 );
+	const size_t size2 = hybridE.size2();
+
+	// identify all positions of the region that can form an interaction
+	pairingMask.setup( energy, region, IndexRange(0,size2-1), true );
+
+	// mark all cells of the region as not used
+	const size_t firstCell = regionRow.at(r)*size2;
+	const size_t lastCell = (region.to-rowShift+1)*size2;
+	std::fill( hybridE.data().begin()+firstCell, hybridE.data().begin()+lastCell, E_INF );
+	std::fill( hybridE_j1.data().begin()+firstCell, hybridE_j1.data().begin()+lastCell, 0 );
+	std::fill( hybridE_j2.data().begin()+firstCell, hybridE_j2.data().begin()+lastCell, 0 );
+	std::fill( hybridE_seed.data().begin()+firstCell, hybridE_seed.data().begin()+lastCell, BestInteraction() );
+
+	// temp vars
+	size_t i1,i2,w1,w2,k1,k2;
+	E_type curE = E_INF, curEtotal = E_INF, curCellE = E_INF, curCellEtotal = E_INF;
+	size_t curCellJ1 = 0, curCellJ2 = 0;
+	const E_type initE = energyModel.getE_init();
+
+	//////////  SEED-FREE RECURSION (HEURISTIC)  ////////////
+
+	// iterate (decreasingly) over all left interaction starts that can pair
+	for (i1=region.to+1; i1-- > region.from; ) {
+	for (i2=pairingMask.getPrevPairing(i1,size2); i2 != RnaSequence::lastPos; i2=pairingMask.getPrevPairing(i1,i2)) {
+
+		// interaction initiation
+		curCellE = initE;
+		curCellJ1 = i1;
+		curCellJ2 = i2;
+		curCellEtotal = InteractionEnergy::getE<EnergyType,AccDisabled>( energyModel, i1+offset1, i1+offset1, i2+offset2, i2+offset2, curCellE );
+
+		// iterate over all loop sizes w1 (seq1) and w2 (seq2) (minus 1)
+		for (w1=1; w1-1 <= maxLoop1 && i1+w1 <= region.to; w1++) {
+		// direct row access of the right extensions
+		const E_type * rowExtE = &(hybridE.data()[(i1+w1-rowShift)*size2]);
+		const BoundaryOffset * rowExtJ1 = &(hybridE_j1.data()[(i1+w1-rowShift)*size2]);
+		const BoundaryOffset * rowExtJ2 = &(hybridE_j2.data()[(i1+w1-rowShift)*size2]);
+		// iterate only over right sides that can pair
+		for (w2=pairingMask.getNextPairing(i1+w1,i2+1)-i2; w2-1 <= maxLoop2 && i2+w2<size2; w2=pairingMask.getNextPairing(i1+w1,i2+w2+1)-i2) {
+			k2 = i2+w2;
+			// check if right side can pair
+			if (E_isINF(rowExtE[k2])) {
+				continue;
+			}
+			// check if interaction length is within boundary
+			if ( (w1 +rowExtJ1[k2] +1) > maxLength1
+				|| (w2 +rowExtJ2[k2] +1) > maxLength2 )
+			{
+				continue;
+			}
+			// compute energy for this loop sizes
+			curE = energyModel.getE_interLeft(i1+offset1,i1+w1+offset1,i2+offset2,k2+offset2) + rowExtE[k2];
+			// check if this combination yields better energy
+			curEtotal = InteractionEnergy::getE<EnergyType,AccDisabled>( energyModel, i1+offset1, i1+w1+rowExtJ1[k2]+offset1, i2+offset2, k2+rowExtJ2[k2]+offset2, curE );
+			if ( curEtotal < curCellEtotal )
+			{
+				// update current best for this left boundary
+				curCellE = curE;
+				curCellJ1 = i1+w1+rowExtJ1[k2];
+				curCellJ2 = k2+rowExtJ2[k2];
+				curCellEtotal = curEtotal;
+			}
+		} // w2
+		} // w1
+
+		// store best entry
+		hybridE(i1-rowShift,i2) = curCellE;
+		hybridE_j1(i1-rowShift,i2) = (BoundaryOffset)(curCellJ1-i1);
+		hybridE_j2(i1-rowShift,i2) = (BoundaryOffset)(curCellJ2-i2);
+
+	} // i2
+	} // i1
+
+	//////////  SEED-CONTAINING RECURSION (HEURISTIC)  ////////////
+
+	BestInteraction * curCell = NULL;
+	const BestInteraction * rightExt = NULL;
+
+	// iterate (decreasingly) over all left interaction starts that can pair
+	for (i1=region.to+1; i1-- > region.from; ) {
+	for (i2=pairingMask.getPrevPairing(i1,size2); i2 != RnaSequence::lastPos; i2=pairingMask.getPrevPairing(i1,i2)) {
+
+		// check if left side can pair
+		if (E_isINF(hybridE(i1-rowShift,i2))) {
+			continue;
+		}
+		// direct cell access
+		curCell = &(hybridE_seed(i1-rowShift,i2));
+		// current best total energy value
+		// NOTE: by setting to E_INF instead of getE(curCell->E) we ignore the
+		// single intermolecular bp case to avoid the effect of extremely low
+		// EDs of single positions
+		curCellEtotal = E_INF;
+
+		// check all extensions of interactions CONTAINING a seed already
+		for (w1=1; w1-1 <= maxLoop1 && i1+w1 <= region.to; w1++) {
+		// iterate only over right sides that can pair
+		for (w2=pairingMask.getNextPairing(i1+w1,i2+1)-i2; w2-1 <= maxLoop2 && i2+w2<size2; w2=pairingMask.getNextPairing(i1+w1,i2+w2+1)-i2) {
+			// direct cell access to right side end of loop (seed has to be to the right of it)
+			rightExt = &(hybridE_seed(i1+w1-rowShift,i2+w2));
+			// check if right side of loop can pair
+			if (E_isINF(rightExt->E)) {
+				continue;
+			}
+			// check if interaction length is within boundary
+			if ( (w1 +rightExt->d1 +1) > maxLength1
+				|| (w2 +rightExt->d2 +1) > maxLength2 )
+			{
+				continue;
+			}
+			// compute energy for this loop sizes
+			curE = energyModel.getE_interLeft(i1+offset1,i1+w1+offset1,i2+offset2,i2+w2+offset2) + rightExt->E;
+			// check if this combination yields better energy
+			curEtotal = InteractionEnergy::getE<EnergyType,AccDisabled>( energyModel, i1+offset1, i1+w1+rightExt->d1+offset1, i2+offset2, i2+w2+rightExt->d2+offset2, curE );
+			if ( curEtotal < curCellEtotal )
+			{
+				// update current best for this left boundary (relative to i1,i2)
+				curCell->d1 = (BoundaryOffset)(w1+rightExt->d1);
+				curCell->d2 = (BoundaryOffset)(w2+rightExt->d2);
+				curCell->E = curE;
+				curCellEtotal = curEtotal;
+			}
+		} // w2
+		} // w1
+
+		// check if seed is starting here
+		if ( E_isNotINF( seedHandler.getSeedE(i1,i2) ) ) {
+			// get right end of the seed
+			k1 = i1+seedHandler.getSeedLength1(i1,i2)-1;
+			k2 = i2+seedHandler.getSeedLength2(i1,i2)-1;
+			if (k1 <= region.to && k2 < size2 && E_isNotINF(hybridE(k1-rowShift,k2))) {
+				// get energy of seed interaction with best right extension
+				curE = seedHandler.getSeedE(i1,i2) + hybridE(k1-rowShift,k2);
+				// check if this combination yields better energy
+				curEtotal = InteractionEnergy::getE<EnergyType,AccDisabled>( energyModel, i1+offset1, k1+hybridE_j1(k1-rowShift,k2)+offset1, i2+offset2, k2+hybridE_j2(k1-rowShift,k2)+offset2, curE );
+				if ( curEtotal < curCellEtotal
+					// ensure the right boundary can be stored
+					&& k1-i1+hybridE_j1(k1-rowShift,k2) <= maxBoundaryOffset
+					&& k2-i2+hybridE_j2(k1-rowShift,k2) <= maxBoundaryOffset )
+				{
+					// update current best for this left boundary (relative to i1,i2)
+					curCell->E = curE;
+					curCell->d1 = (BoundaryOffset)(k1-i1+hybridE_j1(k1-rowShift,k2));
+					curCell->d2 = (BoundaryOffset)(k2-i2+hybridE_j2(k1-rowShift,k2));
+					curCellEtotal = curEtotal;
+				}
+			}
+		}
+
+		// update mfe if needed
+		if (E_isNotINF(curCellEtotal)) {
+			updateOptima( i1,i1+curCell->d1, i2,i2+curCell->d2, curCellEtotal, false );
+		}
+
+	} // i2
+	} // i1
+
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMfe2dHeuristicSeedSparse::
+traceBack( Interaction & interaction, const OutputConstraint & outConstraint  )
+{
+	// check if something to trace
+	if (interaction.basePairs.size() < 2) {
+		return;
+	}
+
+#if INTARNA_IN_DEBUG_MODE
+	// sanity checks
+	if ( interaction.basePairs.size() != 2 ) {
+		throw std::runtime_error("PredictorMfe2dHeuristicSeedSparse::traceBack() : given interaction does not contain boundaries only");
+	}
+#endif
+
+	// check for single interaction
+	if (interaction.basePairs.at(0).first == interaction.basePairs.at(1).first) {
+		// delete second boundary (identical to first)
+		interaction.basePairs.resize(1);
+		// update done
+		return;
+	}
+
+#if INTARNA_IN_DEBUG_MODE
+	// sanity checks
+	if ( ! interaction.isValid() ) {
+		throw std::runtime_error("PredictorMfe2dHeuristicSeedSparse::traceBack() : given interaction not valid");
+	}
+#endif
+
+	// ensure sorting
+	interaction.sort();
+	// get indices in hybridE for boundary base pairs
+	size_t	i1 = energy.getIndex1(interaction.basePairs.at(0)),
+			i2 = energy.getIndex2(interaction.basePairs.at(0));
+	const size_t j1 = energy.getIndex1(interaction.basePairs.at(1));
+	const size_t j2 = energy.getIndex2(interaction.basePairs.at(1));
+
+	// get the matrix rows of the interaction's region
+	const size_t r = getRegion( i1 );
+	const size_t rowShift = regions.at(r).from - regionRow.at(r);
+	assert( j1 <= regions.at(r).to );
+
+	// the currently traced value for i1-j1, i2-j2
+	E_type curE = hybridE_seed(i1-rowShift,i2).E;
+	assert( i1+hybridE_seed(i1-rowShift,i2).d1 == j1 );
+	assert( i2+hybridE_seed(i1-rowShift,i2).d2 == j2 );
+	assert( i1 <= j1 );
+	assert( i2 <= j2 );
+
+	// trace back
+	// temp variables
+	size_t k1,k2;
+	// do until only right boundary is left over
+	while( (j1-i1) > 1 ) {
+		const BestInteraction * curCell = NULL;
+		bool traceNotFound = true;
+		// check all combinations of decompositions into (i1,i2)..(k1,k2)-(j1,j2)
+		for (k1=std::min(j1,i1+energy.getMaxInternalLoopSize1()+1); traceNotFound && k1>i1; k1--) {
+		for (k2=std::min(j2,i2+energy.getMaxInternalLoopSize2()+1); traceNotFound && k2>i2; k2--) {
+			// temp access to current cell
+			curCell = &(hybridE_seed(k1-rowShift,k2));
+			// check if right boundary is equal (part of the heuristic)
+			if ( k1+curCell->d1 == j1 && k2+curCell->d2 == j2 &&
+					// and energy is the source of curE
+					E_equal( curE, (energy.getE_interLeft(i1,k1,i2,k2) + curCell->E ) ) )
+			{
+				// stop searching
+				traceNotFound = false;
+				// store splitting base pair
+				if (k1 < j1) {
+					interaction.basePairs.push_back( energy.getBasePair(k1,k2) );
+				}
+				// trace right part of split
+				i1=k1;
+				i2=k2;
+				curE = curCell->E;
+			}
+		}
+		}
+		// has to be interaction with seed on the left starting at (i1,i2)..seed..(k1,k2)..rest..(j1,j2)
+		if (traceNotFound) {
+			assert(E_isNotINF(seedHandler.getSeedE(i1,i2)));
+			k1 = i1+seedHandler.getSeedLength1(i1,i2)-1;
+			k2 = i2+seedHandler.getSeedLength2(i1,i2)-1;
+			assert( E_equal( curE, (seedHandler.getSeedE(i1,i2)+hybridE(k1-rowShift,k2)) ));
+			// store seed information
+			interaction.setSeedRange(
+							energy.getBasePair(i1,i2),
+							energy.getBasePair(k1,k2),
+							energy.getE(i1,k1,i2,k2,seedHandler.getSeedE(i1,i2))+energy.getE_init());
+			// traceback seed base pairs (excludes right most = (k1,k2))
+			seedHandler.traceBackSeed( interaction, i1, i2 );
+			// traceback remaining right interaction via hybridE
+			if (k1<j1) {
+				// store right most seed base pair
+				interaction.basePairs.push_back( energy.getBasePair(k1,k2) );
+				traceBackHybridE( interaction, k1, k2, j1, j2, rowShift );
+			}
+			// stop search since all trace back done
+			i1 = j1;
+			i2 = j2;
+			break;
+		}
+	}
+
+	// sort final interaction (to make valid) (faster than calling sort())
+	if (interaction.basePairs.size() > 2) {
+		Interaction::PairingVec & bps = interaction.basePairs;
+		// shift all added base pairs to the front
+		for (size_t i=2; i<bps.size(); i++) {
+			bps.at(i-1).first = bps.at(i).first;
+			bps.at(i-1).second = bps.at(i).second;
+		}
+		// set last to j1-j2
+		(*bps.rbegin()) = energy.getBasePair( j1, j2 );
+	}
+
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMfe2dHeuristicSeedSparse::
+traceBackHybridE( Interaction & interaction
+		, size_t i1, size_t i2
+		, const size_t j1, const size_t j2
+		, const size_t rowShift )
+{
+	assert( i1+hybridE_j1(i1-rowShift,i2) == j1 );
+	assert( i2+hybridE_j2(i1-rowShift,i2) == j2 );
+
+	// the currently traced value for i1-j1, i2-j2
+	E_type curE = hybridE(i1-rowShift,i2);
+
+	// temp variables
+	size_t k1,k2;
+	// only reasonable, if there is an enclosed position k1 between i1-j1
+	while( (j1-i1) > 1 ) {
+
+		bool traceNotFound = true;
+		// check all combinations of decompositions into (i1,i2)..(k1,k2)-(j1,j2)
+		for (k1=std::min(j1,i1+energy.getMaxInternalLoopSize1()+1); traceNotFound && k1>i1; k1--) {
+		for (k2=std::min(j2,i2+energy.getMaxInternalLoopSize2()+1); traceNotFound && k2>i2; k2--) {
+			// check if right boundary is equal (part of the heuristic)
+			if ( k1+hybridE_j1(k1-rowShift,k2) == j1 && k2+hybridE_j2(k1-rowShift,k2) == j2 &&
+					// and energy is the source of curE
+					E_equal( curE, (energy.getE_interLeft(i1,k1,i2,k2) + hybridE(k1-rowShift,k2) ) ) )
+			{
+				// stop searching
+				traceNotFound = false;
+				// store splitting base pair if not last one of interaction range
+				if ( k1 < j1 ) {
+					interaction.basePairs.push_back( energy.getBasePair(k1,k2) );
+				}
+				// trace right part of split
+				i1=k1;
+				i2=k2;
+				curE = hybridE(k1-rowShift,k2);
+			}
+		}
+		}
+		assert( !traceNotFound );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMfe2dHeuristicSeedSparse::
+getNextBest( Interaction & curBest )
+{
+
+	const E_type curBestE = curBest.energy;
+
+	// identify cell with next best non-overlapping interaction site
+	// iterate (decreasingly) over all left interaction starts of all regions
+	size_t i1,i2;
+	const BestInteraction * curBestCell = NULL;
+	E_type curBestCellE = E_INF;
+	Interaction::BasePair curBestCellStart;
+	const BestInteraction * curCell = NULL;
+	E_type curCellE = E_INF;
+	IndexRange r1,r2;
+	for (size_t r = regions.size(); r-- > 0; ) {
+		const size_t rowShift = regions.at(r).from - regionRow.at(r);
+	for (i1=regions.at(r).to+1; i1-- > regions.at(r).from;) {
+		// ensure interaction site start is not covered
+		if (reportedInteractions.first.covers(i1)) {
+			continue;
+		}
+		for (i2=hybridE_seed.size2(); i2-- > 0;) {
+			// ensure interaction site start is not covered
+			if (reportedInteractions.second.covers(i2)) {
+				continue;
+			}
+			// direct cell access
+			curCell = &(hybridE_seed(i1-rowShift,i2));
+			// check if left side can pair
+			if (E_isINF(curCell->E))
+			{
+				continue;
+			}
+			// get overall energy of the interaction
+			curCellE = energy.getE(i1,i1+curCell->d1,i2,i2+curCell->d2,curCell->E);
+			// or energy is too low to be considered
+			// or energy is higher than current best found so far
+			if (curCellE < curBestE || curCellE >= curBestCellE )
+			{
+				continue;
+			}
+			// ensure site is not overlapping
+			r1.from = i1;
+			r1.to = i1+curCell->d1;
+			if ( reportedInteractions.first.overlaps( r1 )) {
+				continue;
+			}
+			r2.from = i2;
+			r2.to = i2+curCell->d2;
+			if ( reportedInteractions.second.overlaps( r2 )) {
+				continue;
+			}
+			//// FOUND THE NEXT BETTER SOLUTION
+			// overwrite current best found so far
+			curBestCell = curCell;
+			curBestCellE = curCellE;
+			curBestCellStart.first = i1;
+			curBestCellStart.second = i2;
+
+		} // i2
+	} // i1
+	} // r
+
+	// overwrite curBest
+	curBest.basePairs.resize(2);
+	curBest.energy = curBestCellE;
+	if (E_isNotINF(curBestCellE)) {
+		curBest.basePairs[0] = energy.getBasePair( curBestCellStart.first, curBestCellStart.second );
+		curBest.basePairs[1] = energy.getBasePair( curBestCellStart.first+curBestCell->d1, curBestCellStart.second+curBestCell->d2 );
+	}
+
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
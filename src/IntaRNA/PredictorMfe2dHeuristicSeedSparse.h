@@ -0,0 +1,264 @@
+
+#ifndef INTARNA_PREDICTORMFE2DHEURISTICSEEDSPARSE_H_
+#define INTARNA_PREDICTORMFE2DHEURISTICSEEDSPARSE_H_
+
+#include "IntaRNA/PredictorMfe.h"
+#include "IntaRNA/HugePageAllocator.h"
+#include "IntaRNA/Interaction.h"
+#include "IntaRNA/PairingMask.h"
+#include "IntaRNA/SeedHandlerIdxOffset.h"
+
+#include <cstdint>
+#include <vector>
+
+#include <boost/numeric/ublas/matrix.hpp>
+
+namespace IntaRNA {
+
+
+/**
+ * Seed-constrained heuristic interaction predictor (see
+ * PredictorMfe2dHeuristicSeed) that restricts the recursion to the
+ * neighborhoods of seed anchors in seq1.
+ *
+ * To this end, all seeds are identified first. Each row i1 of seq1 where a
+ * seed starts (an anchor) defines a region of seq1 that covers all
+ * interactions containing such a seed (given the maximal interaction length
+ * of seq1) as well as the right context needed by the heuristic recursion of
+ * the seed-free interaction parts. Overlapping regions are merged and the
+ * heuristic recursion is computed for the rows of the regions only, which
+ * are stored consecutively within the DP matrices.
+ *
+ * Thus, the time and space requirements of the hybridization recursion
+ * scale with the number of seed anchors rather than the length of seq1,
+ * which is beneficial for long targets with few seeds.
+ *
+ * Note, results might slightly differ from PredictorMfe2dHeuristicSeed, since
+ * the right context of the seed-free recursion is restricted to the regions.
+ *
+ * As for PredictorMfe2dHeuristic, right boundaries are stored as 16 bit
+ * offsets relative to the left boundary, which limits the interaction length
+ * to maxBoundaryOffset+1 positions.
+ *
+ */
+class PredictorMfe2dHeuristicSeedSparse: public PredictorMfe {
+
+protected:
+
+	//! type of the right boundary offsets relative to the left boundary
+	typedef uint16_t BoundaryOffset;
+
+	//! the maximal offset of the right boundary of an interaction, i.e.
+	//! the maximal interaction length is maxBoundaryOffset+1
+	static const size_t maxBoundaryOffset = UINT16_MAX;
+
+	/**
+	 * Describes the currently best interaction found for a left interaction
+	 * boundary i1,i2 (8 bytes)
+	 */
+	class BestInteraction {
+	public:
+
+		//! init data
+		BestInteraction( const E_type E=E_INF, const size_t d1=0, const size_t d2=0 )
+			: E(E), d1((BoundaryOffset)d1), d2((BoundaryOffset)d2)
+		{}
+
+	public:
+		//! energy of the interaction
+		E_type E;
+		//! right end of the interaction in seq1 relative to i1, i.e. j1-i1
+		BoundaryOffset d1;
+		//! right end of the interaction in seq2 relative to i2, i.e. j2-i2
+		BoundaryOffset d2;
+	};
+
+	//! matrix type to hold the mfe energies and boundaries for interaction site starts
+	typedef boost::numeric::ublas::matrix<BestInteraction, boost::numeric::ublas::row_major, HugePageAllocator<BestInteraction>::vector > E2dMatrix;
+	//! matrix type to hold the mfe energies for interaction site starts
+	typedef boost::numeric::ublas::matrix<E_type, boost::numeric::ublas::row_major, HugePageAllocator<E_type>::vector > EnergyMatrix;
+	//! matrix type to hold the right boundary offsets for interaction site starts
+	typedef boost::numeric::ublas::matrix<BoundaryOffset, boost::numeric::ublas::row_major, HugePageAllocator<BoundaryOffset>::vector > BoundaryMatrix;
+
+public:
+
+	/**
+	 * Constructs a predictor and stores the energy and output handler
+	 *
+	 * @param energy the interaction energy handler
+	 * @param output the output handler to report mfe interactions to
+	 * @param predTracker the prediction tracker to be used or NULL if no
+	 *         tracking is to be done; if non-NULL, the tracker gets deleted
+	 *         on this->destruction.
+	 * @param seedHandler the seed handler to be applied
+	 */
+	PredictorMfe2dHeuristicSeedSparse( const InteractionEnergy & energy
+			, OutputHandler & output
+			, PredictionTracker * predTracker
+			, SeedHandler* seedHandler );
+
+	virtual ~PredictorMfe2dHeuristicSeedSparse();
+
+	/**
+	 * Computes the mfe for the given sequence ranges (i1-j1) in the first
+	 * sequence and (i2-j2) in the second sequence and reports it to the output
+	 * handler.
+	 *
+	 * @param r1 the index range of the first sequence interacting with r2
+	 * @param r2 the index range of the second sequence interacting with r1
+	 * @param outConstraint constrains the interactions reported to the output handler
+	 *
+	 */
+	virtual
+	void
+	predict( const IndexRange & r1 = IndexRange(0,RnaSequence::lastPos)
+			, const IndexRange & r2 = IndexRange(0,RnaSequence::lastPos)
+			, const OutputConstraint & outConstraint = OutputConstraint());
+
+protected:
+
+	//! access to the interaction energy handler of the super class
+	using PredictorMfe::energy;
+
+	//! access to the output handler of the super class
+	using PredictorMfe::output;
+
+	//! access to the list of reported interaction ranges of the super class
+	using PredictorMfe::reportedInteractions;
+
+	// TODO provide all data structures as arguments to make predict() call threadsafe
+
+	//! handler to generate and access seed information with idx offset
+	SeedHandlerIdxOffset seedHandler;
+
+	//! the (ascending and non-overlapping) ranges of seq1 around seed anchors
+	//! to be computed (indices relative to the current index offset)
+	std::vector<IndexRange> regions;
+
+	//! for each region : the matrix row that stores its first position
+	std::vector<size_t> regionRow;
+
+	//! energy of the best seed-free interaction starting in i1,i2 (matrix rows
+	//! of the regions, see regionRow); E_INF if no interaction possible
+	EnergyMatrix hybridE;
+	//! right end in seq1 of the best seed-free interaction starting in i1,i2
+	//! relative to i1, i.e. j1-i1
+	BoundaryMatrix hybridE_j1;
+	//! right end in seq2 of the best seed-free interaction starting in i1,i2
+	//! relative to i2, i.e. j2-i2
+	BoundaryMatrix hybridE_j2;
+
+	//! the best hybridization energy including a seed for start i1,i2
+	//! (matrix rows of the regions, see regionRow)
+	E2dMatrix hybridE_seed;
+
+	//! the positions (i1,i2) that can form an interaction within the region
+	//! currently computed
+	PairingMask pairingMask;
+
+protected:
+
+	/**
+	 * Identifies all rows of seq1 where a seed starts and sets up the
+	 * regions around them (merging overlapping ones) as well as their
+	 * matrix rows.
+	 *
+	 * @param size1 the number of positions of seq1 to be considered
+	 * @param size2 the number of positions of seq2 to be considered
+	 */
+	void
+	initRegions( const size_t size1, const size_t size2 );
+
+	/**
+	 * Provides the index of the region covering a position of seq1.
+	 *
+	 * @param i1 the position of seq1 (relative to the index offset)
+	 * @return the index of the region within regions
+	 *
+	 * @throw std::runtime_error if no region covers i1 (in debug mode only)
+	 */
+	size_t
+	getRegion( const size_t i1 ) const;
+
+	/**
+	 * Computes the hybridE and hybridE_seed entries of a region using the
+	 * recursion kernel specific for the energy model used (if available)
+	 * and updates the optima.
+	 *
+	 * @param r the index of the region to compute
+	 */
+	void
+	fillRegion( const size_t r );
+
+	/**
+	 * Computes the hybridE and hybridE_seed entries of a region, where all
+	 * energy calls are done via the given energy handler with shifted
+	 * indices. Thus, if EnergyType is a final energy class, all energy calls
+	 * of the recursion are bound at compile time.
+	 *
+	 * @param energyModel the energy handler to use
+	 * @param offset1 the index offset of seq1 to be applied for energyModel
+	 * @param offset2 the index offset of seq2 to be applied for energyModel
+	 * @param r the index of the region to compute
+	 *
+	 * @tparam AccDisabled whether or not the accessibility of both sequences
+	 *        is disabled (see InteractionEnergy::isAccessibilityDisabled()),
+	 *        such that all accessibility terms are evaluated without ED lookups
+	 */
+	template < class EnergyType, bool AccDisabled >
+	void
+	fillRegion( const EnergyType & energyModel
+				, const size_t offset1
+				, const size_t offset2
+				, const size_t r );
+
+	/**
+	 * Fills a given interaction (boundaries given) with the according
+	 * hybridizing base pairs.
+	 * @param interaction IN/OUT the interaction to fill
+	 * @param outConstraint constrains the interactions reported to the output handler
+	 */
+	virtual
+	void
+	traceBack( Interaction & interaction, const OutputConstraint & outConstraint  );
+
+	/**
+	 * Adds the inner base pairs of the seed-free interaction stored in
+	 * hybridE for the left end (i1,i2) with the right end (j1,j2), i.e.
+	 * excluding both boundary base pairs.
+	 *
+	 * @param interaction IN/OUT the interaction to add the base pairs to
+	 * @param i1 the left end in seq1
+	 * @param i2 the left end in seq2
+	 * @param j1 the right end in seq1
+	 * @param j2 the right end in seq2
+	 * @param rowShift the difference of i1 and its matrix row
+	 */
+	void
+	traceBackHybridE( Interaction & interaction
+			, size_t i1, size_t i2
+			, const size_t j1, const size_t j2
+			, const size_t rowShift );
+
+	/**
+	 * Identifies the next best interaction (containing a seed)
+	 * with an energy equal to or higher
+	 * than the given interaction. The new interaction will not overlap any
+	 * index range stored in reportedInteractions.
+	 *
+	 * @param curBest IN/OUT the current best interaction to be replaced with one
+	 *        of equal or higher energy not overlapping with any reported
+	 *        interaction so far; an interaction with energy E_INF is set, if
+	 *        there is no better interaction left
+	 */
+	virtual
+	void
+	getNextBest( Interaction & curBest );
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_PREDICTORMFE2DHEURISTICSEEDSPARSE_H_ */
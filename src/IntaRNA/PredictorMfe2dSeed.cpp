@@ -73,26 +73,31 @@ predict( const IndexRange & r1, const IndexRange & r2
 		return;
 	}
 
-	// resize matrix
-	hybridE_pq.resize( hybridE_pqsize1, hybridE_pqsize2 );
-	hybridE_pq_seed.resize( hybridE_pqsize1, hybridE_pqsize2 );
+	// resize matrices to the band of left ends
+	resizeHybridE( hybridE_pqsize1, hybridE_pqsize2 );
+	hybridE_pq_seed.resize( hybridE_pq.size1(), hybridE_pq.size2(), false );
 
 	// initialize mfe interaction for updates
 	initOptima( outConstraint );
 
 	// for all right ends j1
-	for (size_t j1 = hybridE_pq.size1(); j1-- > 0; ) {
+	for (size_t j1 = hybridE_pqsize1; j1-- > 0; ) {
+		// cooperative cancellation
+		checkDeadline();
 		// check if j1 is accessible
 		if (!energy.isAccessible1(j1))
 			continue;
 		// iterate over all right ends j2
-		for (size_t j2 = hybridE_pq.size2(); j2-- > 0; ) {
+		for (size_t j2 = hybridE_pqsize2; j2-- > 0; ) {
 			// check if j2 is accessible
 			if (!energy.isAccessible2(j2))
 				continue;
 			// check if base pair (j1,j2) possible
 			if (!energy.areComplementary( j1, j2 ))
 				continue;
+			// identical sequences : only right ends of canonical interactions
+			if (symmetric && !canEndCanonical( j1, j2 ))
+				continue;
 
 			// compute hybridE_pq_seed and update mfe via PredictorMfe2d::updateOptima()
 			fillHybridE_seed( j1, j2, 0, 0, outConstraint );
@@ -121,8 +126,8 @@ fillHybridE_seed( const size_t j1, const size_t j2, const size_t i1min, const si
 	assert(hybridErange.r2.from <= i2min);
 	assert(j1==hybridErange.r1.to);
 	assert(j2==hybridErange.r2.to);
-	assert(j1<hybridE_pq.size1());
-	assert(j2<hybridE_pq.size2());
+	assert(j1-hybridEoffset1<hybridE_pq.size1());
+	assert(j2-hybridEoffset2<hybridE_pq.size2());
 
 	// check if it is possible to have a seed ending on the right at (j1,j2)
 	if (std::min(j1-i1min,j2-i2min)+1 < seedHandler.getConstraint().getBasePairs()) {
@@ -151,7 +156,7 @@ fillHybridE_seed( const size_t j1, const size_t j2, const size_t i1min, const si
 			curMinE = E_INF;
 
 			// check if this cell is to be computed (!=E_INF)
-			if( E_isNotINF( hybridE_pq(i1,i2) ) ) {
+			if( E_isNotINF( getHybridE(i1,i2) ) ) {
 
 				// base case = incorporate mfe seed starting at (i1,i2)
 				//             + interaction on right side up to (p,q)
@@ -160,8 +165,8 @@ fillHybridE_seed( const size_t j1, const size_t j2, const size_t i1min, const si
 					k1 = i1+seedHandler.getSeedLength1(i1,i2)-1;
 					k2 = i2+seedHandler.getSeedLength2(i1,i2)-1;
 					// compute overall energy of seed+upToPQ
-					if ( k1 <= j1 && k2 <= j2 && E_isNotINF(hybridE_pq(k1,k2))) {
-						curMinE = seedHandler.getSeedE(i1,i2) + hybridE_pq(k1,k2);
+					if ( k1 <= j1 && k2 <= j2 && E_isNotINF(getHybridE(k1,k2))) {
+						curMinE = seedHandler.getSeedE(i1,i2) + getHybridE(k1,k2);
 					}
 				}
 
@@ -170,10 +175,10 @@ fillHybridE_seed( const size_t j1, const size_t j2, const size_t i1min, const si
 				for (k1=std::min(i1range.to,i1+energy.getMaxInternalLoopSize1()+1); k1>i1; k1--) {
 				for (k2=std::min(i2range.to,i2+energy.getMaxInternalLoopSize2()+1); k2>i2; k2--) {
 					// check if (k1,k2) are valid left boundaries including a seed
-					if ( E_isNotINF( hybridE_pq_seed(k1,k2) ) ) {
+					if ( E_isNotINF( getHybridEseed(k1,k2) ) ) {
 						curMinE = std::min( curMinE,
 								(energy.getE_interLeft(i1,k1,i2,k2)
-										+ hybridE_pq_seed(k1,k2) )
+										+ getHybridEseed(k1,k2) )
 							);
 					}
 				}
@@ -185,7 +190,7 @@ fillHybridE_seed( const size_t j1, const size_t j2, const size_t i1min, const si
 			}
 
 			// store value
-			hybridE_pq_seed(i1,i2) = curMinE;
+			getHybridEseed(i1,i2) = curMinE;
 		}
 	}
 
@@ -249,7 +254,7 @@ traceBack( Interaction & interaction, const OutputConstraint & outConstraint  )
 	fillHybridE_seed( j1, j2, i1, i2, outConstraint );
 
 	// the currently traced value for i1-j1, i2-j2
-	E_type curE = hybridE_pq_seed(i1,i2);
+	E_type curE = getHybridEseed(i1,i2);
 
 	// trace back
 	bool seedNotTraced = true;
@@ -266,7 +271,7 @@ traceBack( Interaction & interaction, const OutputConstraint & outConstraint  )
 				k2 = i2 + seedHandler.getSeedLength2(i1,i2) -1;
 
 				// check if correct trace
-				if ( E_equal( curE, seedHandler.getSeedE(i1,i2) + hybridE_pq(k1,k2) ) ) {
+				if ( E_equal( curE, seedHandler.getSeedE(i1,i2) + getHybridE(k1,k2) ) ) {
 					// store seed information
 					interaction.setSeedRange(
 									energy.getBasePair(i1,i2),
@@ -277,7 +282,7 @@ traceBack( Interaction & interaction, const OutputConstraint & outConstraint  )
 					// continue after seed
 					i1 = k1;
 					i2 = k2;
-					curE = hybridE_pq(k1,k2);
+					curE = getHybridE(k1,k2);
 					seedNotTraced = false;
 					continue;
 				}
@@ -290,17 +295,17 @@ traceBack( Interaction & interaction, const OutputConstraint & outConstraint  )
 				for (k1=std::min(j1-seedHandler.getConstraint().getBasePairs()+1,i1+energy.getMaxInternalLoopSize1()+1); traceNotFound && k1>i1; k1--) {
 				for (k2=std::min(j2-seedHandler.getConstraint().getBasePairs()+1,i2+energy.getMaxInternalLoopSize2()+1); traceNotFound && k2>i2; k2--) {
 					// check if (k1,k2) are valid left boundaries including a seed
-					if ( E_isNotINF( hybridE_pq_seed(k1,k2) ) ) {
+					if ( E_isNotINF( getHybridEseed(k1,k2) ) ) {
 						// check if correct split
 						if (E_equal ( curE,
 								(energy.getE_interLeft(i1,k1,i2,k2)
-										+ hybridE_pq_seed(k1,k2) )
+										+ getHybridEseed(k1,k2) )
 								) )
 						{
 							// update trace back boundary
 							i1=k1;
 							i2=k2;
-							curE= hybridE_pq_seed(k1,k2);
+							curE= getHybridEseed(k1,k2);
 							// stop search splits
 							traceNotFound = false;
 							// store splitting base pair
@@ -359,4 +364,14 @@ getNextBest( Interaction & curBest )
 
 
 
+size_t
+PredictorMfe2dSeed::
+getMemoryEstimate( const size_t size1, const size_t size2 )
+{
+	// hybridE_pq and hybridE_pq_seed
+	return PredictorMfe2d::getMemoryEstimate( size1, size2 ) + size1*size2*sizeof(E_type);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 } // namespace
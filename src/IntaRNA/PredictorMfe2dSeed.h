@@ -75,6 +75,20 @@ public:
 			, const IndexRange & r2 = IndexRange(0,RnaSequence::lastPos)
 			, const OutputConstraint & outConstraint = OutputConstraint() );
 
+	/**
+	 * Computes the memory needed for the matrices of a predict() call
+	 * (without the seed handler).
+	 *
+	 * @param size1 the length of the first sequence (window)
+	 * @param size2 the length of the second sequence (window)
+	 *
+	 * @return the estimated number of bytes
+	 */
+	static
+	size_t
+	getMemoryEstimate( const size_t size1, const size_t size2 );
+
+
 
 protected:
 
@@ -94,16 +108,31 @@ protected:
 	//! the current range of computed entries within hybridE_pq set by initHybridE()
 	using PredictorMfe2d::hybridErange;
 
+	//! index offsets of the band stored in hybridE_pq and hybridE_pq_seed
+	using PredictorMfe2d::hybridEoffset1;
+	using PredictorMfe2d::hybridEoffset2;
+
 	//! the seed handler (with idx offset)
 	SeedHandlerIdxOffset seedHandler;
 
 	//! for fixed interaction end p=j1,q=j2: each cell (i1,i2) provides the mfe
 	//! for the interaction i1..j1 with i2..j2 given that the range contains
-	//! a valid seed interaction
+	//! a valid seed interaction (same band as hybridE_pq, see getHybridEseed())
 	E2dMatrix hybridE_pq_seed;
 
 protected:
 
+	/**
+	 * Access to the hybridE_pq_seed entry of the left end (i1,i2) for the
+	 * right end of the last initHybridE() call.
+	 *
+	 * @param i1 the left end in seq1 (within hybridErange.r1)
+	 * @param i2 the left end in seq2 (within hybridErange.r2)
+	 * @return the according entry within the band stored in hybridE_pq_seed
+	 */
+	E_type &
+	getHybridEseed( const size_t i1, const size_t i2 );
+
 	/**
 	 * does nothing but to ignore the calls from fillHybridE()
 	 *
@@ -136,6 +165,16 @@ protected:
 	fillHybridE_seed( const size_t j1, const size_t j2, const size_t i1min, const size_t i2min
 			, const OutputConstraint & outConstraint );
 
+	/**
+	 * Disables pruning, since the energy bounds of the unconstrained
+	 * recursion neglect the seed constraint.
+	 *
+	 * @return E_INF
+	 */
+	virtual
+	E_type
+	getPruningBound() const;
+
 	/**
 	 * Fills a given interaction (boundaries given) with the according
 	 * hybridizing base pairs using hybridE_seed.
@@ -179,6 +218,26 @@ updateOptima( const size_t i1, const size_t j1
 
 //////////////////////////////////////////////////////////////////////////
 
+inline
+E_type
+PredictorMfe2dSeed::
+getPruningBound() const
+{
+	return E_INF;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+E_type &
+PredictorMfe2dSeed::
+getHybridEseed( const size_t i1, const size_t i2 )
+{
+	return hybridE_pq_seed( i1-hybridEoffset1, i2-hybridEoffset2 );
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 } // namespace
 
 #endif /* INTARNA_PREDICTORMFE2DSEED_H_ */
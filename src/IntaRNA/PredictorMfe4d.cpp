@@ -1,5 +1,7 @@
 
 #include "IntaRNA/PredictorMfe4d.h"
+#include "IntaRNA/InteractionEnergyVrna.h"
+#include "IntaRNA/InteractionEnergyBasePair.h"
 
 #include <stdexcept>
 #include <algorithm>
@@ -13,7 +15,7 @@ PredictorMfe4d( const InteractionEnergy & energy
 				, OutputHandler & output
 				, PredictionTracker * predTracker )
  : PredictorMfe(energy,output,predTracker)
-	, hybridE( 0,0 )
+	, hybridE()
 {
 }
 
@@ -95,13 +97,28 @@ predict( const IndexRange & r1
 			if ( ! i1or2blocked
 				&& energy.areComplementary( i1, i2 ))
 			{
-				// create new 2d matrix for different interaction site widths
-				hybridE(i1,i2) = new E2dMatrix(
+				// reserve 2d matrix for different interaction site widths
+				hybridE.reserveBlock( i1, i2,
 					/*w1 = */ std::min(energy.getAccessibility1().getMaxLength(), std::min( hybridE.size1()-i1, maxWidthFori1i2) ),
 					/*w2 = */ std::min(energy.getAccessibility2().getMaxLength(), std::min( hybridE.size2()-i2, maxWidthFori1i2) ));
 
 				debug_count_cells_nonNull += debug_cellNumber;
 
+			} else {
+				// reduce memory consumption and avoid computation for this start index combination
+				debug_count_cells_null += debug_cellNumber;
+			}
+		}
+	}
+
+	// allocate all 2d matrices at once
+	hybridE.allocate();
+
+	// screen all 2d matrices
+	for (size_t i1=0; i1<hybridE.size1(); i1++) {
+		for (size_t i2=0; i2<hybridE.size2(); i2++) {
+			if (hybridE(i1,i2) != NULL) {
+
 				// screen for cells that can be skipped from computation (decreasing window sizes)
 				for (size_t w1x = (*hybridE(i1,i2)).size1(); w1x>0; w1x--) {
 					w1 = w1x-1;
@@ -146,10 +163,6 @@ predict( const IndexRange & r1
 				}
 				}
 
-			} else {
-				// reduce memory consumption and avoid computation for this start index combination
-				hybridE(i1,i2) = NULL;
-				debug_count_cells_null += debug_cellNumber;
 			}
 		}
 	}
@@ -176,18 +189,40 @@ predict( const IndexRange & r1
 
 ////////////////////////////////////////////////////////////////////////////
 
-void
+size_t
 PredictorMfe4d::
-clear()
+getMemoryEstimate( const size_t size1
+				, const size_t size2
+				, const size_t maxLength1
+				, const size_t maxLength2
+				, const size_t maxLoop1
+				, const size_t maxLoop2 )
 {
-	// delete 3rd and 4th dimension of the matrix
-	for (E4dMatrix::iterator1 iRows = hybridE.begin1(); iRows != hybridE.end1(); iRows++) {
-		for (E4dMatrix::iterator2 ijEntry = iRows.begin(); ijEntry != iRows.end(); ijEntry++) {
-			// delete 2d matrix for current ij
-			 INTARNA_CLEANUP(*ijEntry);
+	const size_t maxW1 = maxLength1==0 ? size1 : std::min(size1,maxLength1);
+	const size_t maxW2 = maxLength2==0 ? size2 : std::min(size2,maxLength2);
+	size_t cells = 0, maxWidthFori1i2 = 0;
+	// same block dimensions as in predict()
+	for (size_t i1=0; i1<size1; i1++) {
+	for (size_t i2=0; i2<size2; i2++) {
+		if (size1-i1 < size2-i2) {
+			maxWidthFori1i2 = getMaxInteractionWidth( size1-i1, maxLoop1 );
+		} else {
+			maxWidthFori1i2 = getMaxInteractionWidth( size2-i2, maxLoop2 );
 		}
+		cells += std::min(maxW1, std::min( size1-i1, maxWidthFori1i2) )
+				* std::min(maxW2, std::min( size2-i2, maxWidthFori1i2) );
+	}
 	}
-	// clear matrix, free data
+	return cells*sizeof(E_type) + size1*size2*sizeof(E2dMatrix);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMfe4d::
+clear()
+{
+	// clear matrix (memory is kept for reuse)
 	hybridE.clear();
 }
 
@@ -197,6 +232,31 @@ void
 PredictorMfe4d::
 fillHybridE( )
 {
+	// use the recursion kernel specific for the energy model
+	if (energyVrna != NULL) {
+		fillHybridE( *energyVrna, energy.getOffset1(), energy.getOffset2() );
+	} else
+	if (energyBasePair != NULL) {
+		fillHybridE( *energyBasePair, energy.getOffset1(), energy.getOffset2() );
+	} else {
+		fillHybridE( energy, 0, 0 );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+template < class EnergyType >
+void
+PredictorMfe4d::
+fillHybridE( const EnergyType & energyModel
+			, const size_t offset1
+			, const size_t offset2 )
+{
+	// loop-independent constraints
+	const size_t maxLoop1 = energyModel.getMaxInternalLoopSize1();
+	const size_t maxLoop2 = energyModel.getMaxInternalLoopSize2();
+	const size_t maxLength1 = energyModel.getAccessibility1().getMaxLength();
+	const size_t maxLength2 = energyModel.getAccessibility2().getMaxLength();
 
 	// global vars to avoid reallocation
 	size_t i1,i2,j1,j2,w1,w2,k1,k2;
@@ -206,8 +266,10 @@ fillHybridE( )
 	// current minimal value
 	E_type curMinE = E_INF;
 	// iterate increasingly over all window sizes w1 (seq1) and w2 (seq2)
-	for (w1=0; w1<energy.getAccessibility1().getMaxLength(); w1++) {
-	for (w2=0; w2<energy.getAccessibility2().getMaxLength(); w2++) {
+	for (w1=0; w1<maxLength1; w1++) {
+	for (w2=0; w2<maxLength2; w2++) {
+		// cooperative cancellation
+		checkDeadline();
 		// iterate over all window starts i1 (seq1) and i2 (seq2)
 		// TODO PARALLELIZE THIS DOUBLE LOOP ?!
 		for (i1=0; i1+w1<hybridE.size1(); i1++) {
@@ -223,9 +285,10 @@ fillHybridE( )
 				// interaction not possible: nothing to do, since no storage reserved
 				continue;
 			}
+			INTARNA_COUNT_WORK( workCounters.complementaryCells++ );
 			// check if interaction exceeds possible width due to max-loop-length
-			if ( getMaxInteractionWidth( 1+w1, energy.getMaxInternalLoopSize1() ) < w2
-				|| getMaxInteractionWidth( 1+w2, energy.getMaxInternalLoopSize2() ) < w1)
+			if ( getMaxInteractionWidth( 1+w1, maxLoop1 ) < w2
+				|| getMaxInteractionWidth( 1+w2, maxLoop2 ) < w1)
 			{
 				// ignore this entry
 				(*hybridE(i1,i2))(w1,w2) = E_INF;
@@ -246,26 +309,29 @@ fillHybridE( )
 			if( E_isNotINF( (*hybridE(i1,i2))(w1,w2) ) ) {
 
 				// compute entry
+				INTARNA_COUNT_WORK( workCounters.filledCells++ );
 
 				// either interaction initiation
 				if ( w1==0 && w2==0 )  {
-					curMinE = energy.getE_init();
+					curMinE = energyModel.getE_init();
 				} else {
 				
 					// or only internal loop energy (nothing between i and j)
-					curMinE = energy.getE_interLeft(i1,j1,i2,j2)
+					curMinE = energyModel.getE_interLeft(i1+offset1,j1+offset1,i2+offset2,j2+offset2)
 							+ (*hybridE(j1,j2))(0,0) ;
+					INTARNA_COUNT_WORK( workCounters.loopEvaluations++ );
 
 					// check all combinations of decompositions into (i1,i2)..(k1,k2)-(j1,j2)
 					if (w1 > 1 && w2 > 1) {
-						for (k1=std::min(j1-1,i1+energy.getMaxInternalLoopSize1()+1); k1>i1; k1--) {
-						for (k2=std::min(j2-1,i2+energy.getMaxInternalLoopSize2()+1); k2>i2; k2--) {
+						for (k1=std::min(j1-1,i1+maxLoop1+1); k1>i1; k1--) {
+						for (k2=std::min(j2-1,i2+maxLoop2+1); k2>i2; k2--) {
 							// check if (k1,k2) are complementary
 							if (hybridE(k1,k2) != NULL && hybridE(k1,k2)->size1() > (j1-k1) && hybridE(k1,k2)->size2() > (j2-k2)) {
 								curMinE = std::min( curMinE,
-										(energy.getE_interLeft(i1,k1,i2,k2)
+										(energyModel.getE_interLeft(i1+offset1,k1+offset1,i2+offset2,k2+offset2)
 												+ (*hybridE(k1,k2))(j1-k1,j2-k2))
 										);
+								INTARNA_COUNT_WORK( workCounters.loopEvaluations++ );
 							}
 						}
 						}
@@ -288,6 +354,15 @@ fillHybridE( )
 }
 
 
+////////////////////////////////////////////////////////////////////////////
+
+bool
+PredictorMfe4d::
+isTraceBackConcurrent() const
+{
+	return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////
 
 void
@@ -4,8 +4,7 @@
 
 #include "IntaRNA/PredictorMfe.h"
 #include "IntaRNA/Interaction.h"
-
-#include <boost/numeric/ublas/matrix.hpp>
+#include "IntaRNA/Arena4dMatrix.h"
 
 namespace IntaRNA {
 
@@ -20,13 +19,14 @@ class PredictorMfe4d: public PredictorMfe {
 
 protected:
 
-	//! matrix type to cover the energies for different interaction site widths
-	typedef boost::numeric::ublas::matrix<E_type> E2dMatrix;
-
 	//! full 4D DP-matrix for computation to hold all start position combinations
 	//! first index = start positions (i1,i2) of (seq1,seq2)
-	//! second index = interaction window sizes (w1,w2) or NULL if (i1,i2) not complementary
-	typedef boost::numeric::ublas::matrix< E2dMatrix* > E4dMatrix;
+	//! second index = interaction window sizes (w1,w2) or NULL if (i1,i2) not complementary;
+	//! all 2D blocks are stored within one arena that is reused by predict() calls
+	typedef Arena4dMatrix< E_type > E4dMatrix;
+
+	//! matrix type to cover the energies for different interaction site widths
+	typedef E4dMatrix::Block E2dMatrix;
 
 
 public:
@@ -62,6 +62,31 @@ public:
 			, const IndexRange & r2 = IndexRange(0,RnaSequence::lastPos)
 			, const OutputConstraint & outConstraint = OutputConstraint() );
 
+	/**
+	 * Computes an upper bound of the memory needed for the 4D matrix of a
+	 * predict() call, assuming that all index combinations are complementary
+	 * and accessible.
+	 *
+	 * @param size1 the length of the first sequence (window)
+	 * @param size2 the length of the second sequence (window)
+	 * @param maxLength1 the maximal length of interaction sites in seq1
+	 *         (0 = size1)
+	 * @param maxLength2 the maximal length of interaction sites in seq2
+	 *         (0 = size2)
+	 * @param maxLoop1 the maximal internal loop size in seq1
+	 * @param maxLoop2 the maximal internal loop size in seq2
+	 *
+	 * @return the estimated number of bytes of one 4D matrix
+	 */
+	static
+	size_t
+	getMemoryEstimate( const size_t size1
+					, const size_t size2
+					, const size_t maxLength1
+					, const size_t maxLength2
+					, const size_t maxLoop1
+					, const size_t maxLoop2 );
+
 protected:
 
 	//! access to the interaction energy handler of the super class
@@ -90,11 +115,28 @@ protected:
 	clear();
 
 	/**
-	 * computes all entries of the hybridE matrix
+	 * computes all entries of the hybridE matrix using the recursion kernel
+	 * specific for the energy model used (if available)
 	 */
 	void
 	fillHybridE( );
 
+	/**
+	 * computes all entries of the hybridE matrix, where all energy calls of
+	 * the recursion are done via the given energy handler with shifted
+	 * indices. Thus, if EnergyType is a final energy class, all energy calls
+	 * of the recursion are bound at compile time.
+	 *
+	 * @param energyModel the energy handler to use
+	 * @param offset1 the index offset of seq1 to be applied for energyModel
+	 * @param offset2 the index offset of seq2 to be applied for energyModel
+	 */
+	template < class EnergyType >
+	void
+	fillHybridE( const EnergyType & energyModel
+				, const size_t offset1
+				, const size_t offset2 );
+
 	/**
 	 * Fills a given interaction (boundaries given) with the according
 	 * hybridizing base pairs.
@@ -105,6 +147,14 @@ protected:
 	void
 	traceBack( Interaction & interaction, const OutputConstraint & outConstraint  );
 
+	/**
+	 * Whether or not traceBack() can be called concurrently.
+	 * @return true, since the traceback only reads hybridE
+	 */
+	virtual
+	bool
+	isTraceBackConcurrent() const;
+
 
 	/**
 	 * Identifies the next best interaction with an energy equal to or higher
@@ -15,7 +15,7 @@ PredictorMfe4dSeed( const InteractionEnergy & energy
 					, SeedHandler * seedHandlerInstance )
  : PredictorMfe4d(energy,output,predTracker)
 	, seedHandler(seedHandlerInstance)
-	, hybridE_seed(0,0)
+	, hybridE_seed()
 {
 }
 
@@ -78,6 +78,19 @@ predict( const IndexRange & r1
 	}
 
 
+	// number of seed starts (k1,k2) with k1>=i1 and k2>=i2 for each (i1,i2)
+	// to identify the left boundaries that can reach a seed
+	const size_t seedBP = seedHandler.getConstraint().getBasePairs();
+	std::vector< size_t > seedStarts( (hybridEsize1+1)*(hybridEsize2+1), 0 );
+	for (size_t i1=hybridEsize1; i1-- > 0;) {
+	for (size_t i2=hybridEsize2; i2-- > 0;) {
+		seedStarts[i1*(hybridEsize2+1)+i2] = (E_isNotINF( seedHandler.getSeedE(i1,i2) ) ? 1 : 0)
+				+ seedStarts[(i1+1)*(hybridEsize2+1)+i2]
+				+ seedStarts[i1*(hybridEsize2+1)+i2+1]
+				- seedStarts[(i1+1)*(hybridEsize2+1)+i2+1];
+	}
+	}
+
 	// resize matrix
 	hybridE.resize( hybridEsize1, hybridEsize2 );
 	hybridE_seed.resize( hybridEsize1, hybridEsize2 );
@@ -85,8 +98,9 @@ predict( const IndexRange & r1
 	size_t debug_count_cells_null=0
 			, debug_count_cells_nonNull = 0
 			, debug_count_cells_inf = 0
+			, debug_count_cells_noSeed = 0
 			, debug_cellNumber=0
-			, w1, w2;
+			, w1, w2, e1, e2;
 
 
 	size_t maxWidthFori1i2 = 0;
@@ -114,14 +128,47 @@ predict( const IndexRange & r1
 			if ( ! i1or2blocked
 				&& energy.areComplementary( i1, i2 ))
 			{
-				// create new 2d matrix for different interaction site widths
-				hybridE(i1,i2) = new E2dMatrix(
-					/*w1 = */ std::min(energy.getAccessibility1().getMaxLength(), std::min( hybridEsize1-i1, maxWidthFori1i2) ),
-					/*w2 = */ std::min(energy.getAccessibility2().getMaxLength(), std::min( hybridEsize2-i2, maxWidthFori1i2) ));
-				hybridE_seed(i1,i2) = new E2dMatrix( hybridE(i1,i2)->size1(), hybridE(i1,i2)->size2() );
+				// reserve 2d matrices for different interaction site widths
+				w1 = std::min(energy.getAccessibility1().getMaxLength(), std::min( hybridEsize1-i1, maxWidthFori1i2) );
+				w2 = std::min(energy.getAccessibility2().getMaxLength(), std::min( hybridEsize2-i2, maxWidthFori1i2) );
+				hybridE.reserveBlock( i1, i2, w1, w2 );
+
+				// seed-containing interactions only if a seed can start
+				// within [i1,i1+w1-seedBP] x [i2,i2+w2-seedBP]
+				if (w1 >= seedBP && w2 >= seedBP) {
+					e1 = i1+w1-seedBP+1;
+					e2 = i2+w2-seedBP+1;
+					if ( seedStarts[i1*(hybridEsize2+1)+i2]
+						+ seedStarts[e1*(hybridEsize2+1)+e2]
+						> seedStarts[e1*(hybridEsize2+1)+i2]
+						+ seedStarts[i1*(hybridEsize2+1)+e2] )
+					{
+						hybridE_seed.reserveBlock( i1, i2, w1, w2 );
+					} else {
+						debug_count_cells_noSeed += debug_cellNumber;
+					}
+				} else {
+					debug_count_cells_noSeed += debug_cellNumber;
+				}
 
 				debug_count_cells_nonNull += debug_cellNumber;
 
+			} else {
+				// reduce memory consumption and avoid computation for this start index combination
+				debug_count_cells_null += debug_cellNumber;
+			}
+		}
+	}
+
+	// allocate all 2d matrices at once
+	hybridE.allocate();
+	hybridE_seed.allocate();
+
+	// screen all 2d matrices
+	for (size_t i1=0; i1<hybridEsize1; i1++) {
+		for (size_t i2=0; i2<hybridEsize2; i2++) {
+			if (hybridE(i1,i2) != NULL) {
+
 				// screen for cells that can be skipped from computation (decreasing window sizes)
 				for (size_t w1x = (*hybridE(i1,i2)).size1(); w1x>0; w1x--) {
 					w1 = w1x-1;
@@ -160,18 +207,15 @@ predict( const IndexRange & r1
 					if (skipw1w2) {
 						// init with infinity to mark that this cell is not to be computed later on
 						(*hybridE(i1,i2))(w1,w2) = E_INF;
-						(*hybridE_seed(i1,i2))(w1,w2) = E_INF;
+						if (hybridE_seed(i1,i2) != NULL) {
+							(*hybridE_seed(i1,i2))(w1,w2) = E_INF;
+						}
 						debug_count_cells_inf++;
 					}
 
 				}
 				}
 
-			} else {
-				// reduce memory consumption and avoid computation for this start index combination
-				hybridE(i1,i2) = NULL;
-				hybridE_seed(i1,i2) = NULL;
-				debug_count_cells_null += debug_cellNumber;
 			}
 		}
 	}
@@ -183,7 +227,7 @@ predict( const IndexRange & r1
 				<<((double)(debug_count_cells_nonNull-debug_count_cells_inf)/(double)(debug_count_cells_nonNull+debug_count_cells_null))
 				<<"%) and "<<debug_count_cells_null <<" not allocated ("
 				<<((double)(debug_count_cells_null)/(double)(debug_count_cells_nonNull+debug_count_cells_null))
-				<<"%)"; }
+				<<"%), "<<debug_count_cells_noSeed<<" without reachable seed not allocated for seed interactions"; }
 
 	// init mfe without seed condition
 	OutputConstraint tmpOutConstraint(1, outConstraint.reportOverlap, outConstraint.maxE, outConstraint.deltaE);
@@ -197,7 +241,7 @@ predict( const IndexRange & r1
 
 	// check if any interaction possible
 	// if not no seed-containing interaction is possible neither
-	if (!(this->mfeInteractions.begin()->energy < tmpOutConstraint.maxE)) {
+	if (!(getOptimumE() < tmpOutConstraint.maxE)) {
 		// stop computation since no favorable interaction found
 		reportOptima(tmpOutConstraint);
 		return;
@@ -219,14 +263,7 @@ void
 PredictorMfe4dSeed::
 clear()
 {
-	// delete 3rd and 4th dimension of the matrix
-	for (E4dMatrix::iterator1 iRows = hybridE_seed.begin1(); iRows != hybridE_seed.end1(); iRows++) {
-		for (E4dMatrix::iterator2 ijEntry = iRows.begin(); ijEntry != iRows.end(); ijEntry++) {
-			// delete 2d matrix for current ij
-			 INTARNA_CLEANUP(*ijEntry);
-		}
-	}
-	// clear matrix, free data
+	// clear matrix (memory is kept for reuse)
 	hybridE_seed.clear();
 
 	// clean up super class data structures
@@ -251,6 +288,8 @@ fillHybridE_seed( )
 	// minimal size == number of seed base pairs
 	for (w1=0; w1<energy.getAccessibility1().getMaxLength(); w1++) {
 	for (w2=0; w2<energy.getAccessibility2().getMaxLength(); w2++) {
+		// cooperative cancellation
+		checkDeadline();
 		// iterate over all window starts i1 (seq1) and i2 (seq2)
 		// TODO PARALLELIZE THIS DOUBLE LOOP ?!
 		for (i1=0; i1+w1<hybridE_seed.size1(); i1++) {
@@ -338,6 +377,15 @@ fillHybridE_seed( )
 }
 
 
+////////////////////////////////////////////////////////////////////////////
+
+bool
+PredictorMfe4dSeed::
+isTraceBackConcurrent() const
+{
+	return false;
+}
+
 ////////////////////////////////////////////////////////////////////////////
 
 void
@@ -399,7 +447,7 @@ traceBack( Interaction & interaction, const OutputConstraint & outConstraint  )
 				k2 = i2 + seedHandler.getSeedLength2(i1,i2) -1;
 
 				// check if correct trace
-				if ( hybridE_seed(k1,k2) != NULL
+				if ( hybridE(k1,k2) != NULL
 						&& E_equal( curE, seedHandler.getSeedE(i1,i2) + (*hybridE(k1,k2))(j1-k1,j2-k2) ) )
 				{
 					// store seed information
@@ -128,6 +128,14 @@ protected:
 	void
 	traceBack( Interaction & interaction, const OutputConstraint & outConstraint  );
 
+	/**
+	 * Whether or not traceBack() can be called concurrently.
+	 * @return false, since the seed traceback might recompute seed recursion data
+	 */
+	virtual
+	bool
+	isTraceBackConcurrent() const;
+
 
 	/**
 	 * Identifies the next best interaction with an energy equal to or higher
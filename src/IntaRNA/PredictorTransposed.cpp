@@ -0,0 +1,201 @@
+
+#include "IntaRNA/PredictorTransposed.h"
+
+namespace IntaRNA {
+
+////////////////////////////////////////////////////////////////////////////
+
+PredictorTransposed::
+PredictorTransposed( const InteractionEnergy & energy
+					, OutputHandler & output
+					, ReverseAccessibility * accS1reversed
+					, InteractionEnergy * energyTransposed )
+ :
+	Predictor( energy, output, NULL )
+	, accS1reversed( accS1reversed )
+	, energyTransposed( energyTransposed )
+	, outputTransposed( output )
+	, predictorTransposed( NULL )
+	, predictorDirect( NULL )
+{
+	INTARNA_CHECK_NOT_NULL( accS1reversed, "PredictorTransposed() : accS1reversed is NULL" );
+	INTARNA_CHECK_NOT_NULL( energyTransposed, "PredictorTransposed() : energyTransposed is NULL" );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+PredictorTransposed::
+~PredictorTransposed()
+{
+	// cleanup in reverse order of dependency
+	INTARNA_CLEANUP( predictorDirect );
+	INTARNA_CLEANUP( predictorTransposed );
+	INTARNA_CLEANUP( energyTransposed );
+	INTARNA_CLEANUP( accS1reversed );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorTransposed::
+setTransposedPredictor( Predictor * predictor )
+{
+	INTARNA_CLEANUP( predictorTransposed );
+	predictorTransposed = predictor;
+	// apply deadline if already set
+	if (predictorTransposed != NULL && hasDeadline) {
+		predictorTransposed->setDeadline( deadline );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorTransposed::
+setDirectPredictor( Predictor * predictor )
+{
+	INTARNA_CLEANUP( predictorDirect );
+	predictorDirect = predictor;
+	// apply deadline if already set
+	if (predictorDirect != NULL && hasDeadline) {
+		predictorDirect->setDeadline( deadline );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorTransposed::
+setDeadline( const Clock::time_point & deadline )
+{
+	Predictor::setDeadline( deadline );
+	if (predictorTransposed != NULL) {
+		predictorTransposed->setDeadline( deadline );
+	}
+	if (predictorDirect != NULL) {
+		predictorDirect->setDeadline( deadline );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorTransposed::
+predict( const IndexRange & r1
+		, const IndexRange & r2
+		, const OutputConstraint & outConstraint )
+{
+#if INTARNA_IN_DEBUG_MODE
+	// check indices
+	if (!(r1.isAscending() && r2.isAscending()) )
+		throw std::runtime_error("PredictorTransposed::predict("+toString(r1)+","+toString(r2)+") is not sane");
+#endif
+
+	// check if anything to predict
+	if (r1.from >= energy.size1() || r2.from >= energy.size2()) {
+		return;
+	}
+
+	// predict directly if transposition is not beneficial for the ranges
+	if (predictorDirect != NULL
+		&& !isTransposable( std::min( r1.to, energy.size1()-1 )-r1.from+1
+						, std::min( r2.to, energy.size2()-1 )-r2.from+1 ))
+	{
+		predictorDirect->predict( r1, r2, outConstraint );
+		return;
+	}
+
+	INTARNA_CHECK_NOT_NULL( predictorTransposed, "PredictorTransposed::predict() : no transposed predictor set" );
+
+	// the (reversed) second sequence becomes the first sequence and vice versa
+	const IndexRange r1transposed = energy.getAccessibility2().getReversedIndexRange(
+			IndexRange( r2.from, std::min( r2.to, energy.size2()-1 ) ) );
+	const IndexRange r2transposed = accS1reversed->getReversedIndexRange(
+			IndexRange( r1.from, std::min( r1.to, energy.size1()-1 ) ) );
+
+	// exchange sequence-specific overlap restrictions
+	OutputConstraint::ReportOverlap reportOverlap = outConstraint.reportOverlap;
+	switch (outConstraint.reportOverlap) {
+	case OutputConstraint::ReportOverlap::OVERLAP_SEQ1 : reportOverlap = OutputConstraint::ReportOverlap::OVERLAP_SEQ2; break;
+	case OutputConstraint::ReportOverlap::OVERLAP_SEQ2 : reportOverlap = OutputConstraint::ReportOverlap::OVERLAP_SEQ1; break;
+	default : break;
+	}
+
+	// predict transposed problem (reported interactions are transposed back)
+	predictorTransposed->predict( r1transposed, r2transposed
+			, OutputConstraint( outConstraint.reportMax
+								, reportOverlap
+								, outConstraint.maxE
+								, outConstraint.deltaE
+								, outConstraint.symmetric ) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+Interaction
+PredictorTransposed::
+getTransposed( const Interaction & interaction )
+{
+	Interaction transposed( *(interaction.s2), *(interaction.s1) );
+	transposed.energy = interaction.energy;
+	// exchange indices and reverse order to keep the base pairs sorted
+	transposed.basePairs.reserve( interaction.basePairs.size() );
+	for (auto bp = interaction.basePairs.rbegin(); bp != interaction.basePairs.rend(); bp++) {
+		transposed.basePairs.push_back( Interaction::BasePair( bp->second, bp->first ) );
+	}
+	// right-most seed base pair becomes the left-most and vice versa
+	if (interaction.seed != NULL) {
+		transposed.setSeedRange(
+				  Interaction::BasePair( interaction.seed->bp_j.second, interaction.seed->bp_j.first )
+				, Interaction::BasePair( interaction.seed->bp_i.second, interaction.seed->bp_i.first )
+				, interaction.seed->energy );
+	}
+	return transposed;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+InteractionRange
+PredictorTransposed::
+getTransposed( const InteractionRange & range )
+{
+	// exchange ranges and reverse their order
+	return InteractionRange( *(range.s2), *(range.s1)
+			, IndexRange( range.r2.to, range.r2.from )
+			, IndexRange( range.r1.to, range.r1.from )
+			, range.energy );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+PredictorTransposed::TransposingOutputHandler::
+TransposingOutputHandler( OutputHandler & output )
+ :
+	OutputHandler()
+	, output( output )
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorTransposed::TransposingOutputHandler::
+add( const Interaction & interaction )
+{
+	reportedInteractions++;
+	output.add( PredictorTransposed::getTransposed( interaction ) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorTransposed::TransposingOutputHandler::
+add( const InteractionRange & range )
+{
+	reportedInteractions++;
+	output.add( PredictorTransposed::getTransposed( range ) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
@@ -0,0 +1,316 @@
+
+#ifndef INTARNA_PREDICTORTRANSPOSED_H_
+#define INTARNA_PREDICTORTRANSPOSED_H_
+
+#include "IntaRNA/Predictor.h"
+#include "IntaRNA/ReverseAccessibility.h"
+
+namespace IntaRNA {
+
+/**
+ * Predictor that computes the interactions of an energy handler via another
+ * predictor working on the transposed problem, i.e. with exchanged roles of
+ * the first and second sequence. The interactions reported by the transposed
+ * predictor are transposed back before they are forwarded to the output
+ * handler.
+ *
+ * Since the DP matrices of the predictors are stored and iterated row-wise,
+ * the second sequence is the contiguous dimension with the innermost loops.
+ * Thus, if the first sequence is much longer than the second, the transposed
+ * prediction yields longer inner loops and a better memory locality.
+ *
+ * Whether or not the transposition is beneficial is decided for each
+ * predict() call based on the lengths of the given ranges (see
+ * isTransposable()). If not, the ranges are predicted by the direct
+ * predictor (if set, see setDirectPredictor()).
+ *
+ * NOTE: this is only valid for predictors whose results are independent of
+ * the orientation, i.e. exact predictions for sequence-symmetric constraints.
+ * Prediction trackers are not supported, since they are informed about the
+ * DP cells of the transposed problem.
+ *
+ */
+class PredictorTransposed: public Predictor {
+
+public:
+
+	/**
+	 * Construction
+	 *
+	 * @param energy the interaction energy handler
+	 * @param output the output handler to report the (back-transposed)
+	 *        interactions to
+	 * @param accS1reversed the reversed accessibility of the first sequence
+	 *        of energy, i.e. the second sequence of energyTransposed;
+	 *        it is deleted on destruction. To avoid a copy of all ED values
+	 *        of the first sequence for each predictor, it should not be
+	 *        materialized.
+	 * @param energyTransposed the energy handler of the transposed problem,
+	 *        i.e. the first sequence is the second of energy and vice versa;
+	 *        it is deleted on destruction
+	 */
+	PredictorTransposed( const InteractionEnergy & energy
+						, OutputHandler & output
+						, ReverseAccessibility * accS1reversed
+						, InteractionEnergy * energyTransposed );
+
+	/**
+	 * destruction
+	 */
+	virtual ~PredictorTransposed();
+
+	/**
+	 * Access to the energy handler of the transposed problem, to be used
+	 * to construct the transposed predictor.
+	 * @return the energy handler of the transposed problem
+	 */
+	const InteractionEnergy &
+	getTransposedEnergy() const;
+
+	/**
+	 * Access to the output handler the transposed predictor has to report to.
+	 * @return the output handler that transposes and forwards interactions
+	 */
+	OutputHandler &
+	getTransposedOutput();
+
+	/**
+	 * Sets the predictor that works on the transposed problem, i.e. that uses
+	 * getTransposedEnergy() and reports to getTransposedOutput().
+	 *
+	 * @param predictor the predictor to use; it is deleted on destruction
+	 */
+	void
+	setTransposedPredictor( Predictor * predictor );
+
+	/**
+	 * Sets the predictor that works on the original problem, i.e. that uses
+	 * the energy and output handler of this predictor. It is used for all
+	 * ranges whose transposition is not beneficial (see isTransposable()).
+	 *
+	 * @param predictor the predictor to use or NULL if all ranges are to be
+	 *        predicted via the transposed predictor; it is deleted on
+	 *        destruction
+	 */
+	void
+	setDirectPredictor( Predictor * predictor );
+
+	/**
+	 * Checks whether or not the transposed prediction is beneficial for the
+	 * given lengths of the ranges to predict, i.e. if the first range is
+	 * much longer than the second.
+	 *
+	 * @param length1 the length of the range of the first sequence
+	 * @param length2 the length of the range of the second sequence
+	 * @return true if the transposed prediction is to be used
+	 */
+	static
+	bool
+	isTransposable( const size_t length1, const size_t length2 );
+
+	/**
+	 * Computes the interactions for the given ranges of the first and second
+	 * sequence via the transposed predictor or, if the transposition is not
+	 * beneficial for the ranges (see isTransposable()), via the direct
+	 * predictor (if set).
+	 *
+	 * @param r1 the index range of the first sequence interacting with r2
+	 * @param r2 the index range of the second sequence interacting with r1
+	 * @param outConstraint constrains the interactions reported to the output handler
+	 *
+	 */
+	virtual
+	void
+	predict( const IndexRange & r1 = IndexRange(0,RnaSequence::lastPos)
+			, const IndexRange & r2 = IndexRange(0,RnaSequence::lastPos)
+			, const OutputConstraint & outConstraint = OutputConstraint() );
+
+	/**
+	 * Sets the deadline for the transposed predictor.
+	 *
+	 * @param deadline the time point after which predictions are aborted
+	 */
+	virtual
+	void
+	setDeadline( const Clock::time_point & deadline );
+
+	/**
+	 * Provides the transposed interaction, i.e. the sequences as well as the
+	 * indices of each base pair are exchanged. Transposing twice yields the
+	 * original interaction.
+	 *
+	 * @param interaction the interaction to transpose
+	 * @return the transposed interaction
+	 */
+	static
+	Interaction
+	getTransposed( const Interaction & interaction );
+
+	/**
+	 * Provides the transposed interaction range, i.e. the sequences as well
+	 * as the ranges are exchanged. Transposing twice yields the original
+	 * range.
+	 *
+	 * @param range the interaction range to transpose
+	 * @return the transposed interaction range
+	 */
+	static
+	InteractionRange
+	getTransposed( const InteractionRange & range );
+
+protected:
+
+	/**
+	 * Output handler that transposes all reported interactions and forwards
+	 * them to another output handler.
+	 */
+	class TransposingOutputHandler : public OutputHandler {
+
+	public:
+
+		/**
+		 * Construction
+		 * @param output the output handler to forward to
+		 */
+		TransposingOutputHandler( OutputHandler & output );
+
+		/**
+		 * Forwards the transposed interaction.
+		 * @param interaction the interaction to transpose and forward
+		 */
+		virtual
+		void
+		add( const Interaction & interaction );
+
+		/**
+		 * Forwards the transposed interaction range.
+		 * @param range the interaction range to transpose and forward
+		 */
+		virtual
+		void
+		add( const InteractionRange & range );
+
+	protected:
+
+		//! the output handler to forward to
+		OutputHandler & output;
+
+	};
+
+	//! the reversed accessibility of the first sequence
+	ReverseAccessibility * accS1reversed;
+
+	//! the energy handler of the transposed problem
+	InteractionEnergy * energyTransposed;
+
+	//! the output handler the transposed predictor reports to
+	TransposingOutputHandler outputTransposed;
+
+	//! the predictor of the transposed problem
+	Predictor * predictorTransposed;
+
+	//! the predictor of the original problem (or NULL)
+	Predictor * predictorDirect;
+
+	/**
+	 * Not used, since the optima are handled by the transposed predictor.
+	 * @param outConstraint ignored
+	 */
+	virtual
+	void
+	initOptima( const OutputConstraint & outConstraint );
+
+	/**
+	 * Not used, since the optima are handled by the transposed predictor.
+	 * @param i1 ignored
+	 * @param j1 ignored
+	 * @param i2 ignored
+	 * @param j2 ignored
+	 * @param energy ignored
+	 * @param isHybridE ignored
+	 */
+	virtual
+	void
+	updateOptima( const size_t i1, const size_t j1
+				, const size_t i2, const size_t j2
+				, const E_type energy
+				, const bool isHybridE );
+
+	/**
+	 * Not used, since the optima are reported by the transposed predictor.
+	 * @param outConstraint ignored
+	 */
+	virtual
+	void
+	reportOptima( const OutputConstraint & outConstraint );
+
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+PredictorTransposed::
+isTransposable( const size_t length1, const size_t length2 )
+{
+	return length1 > 2*length2;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+const InteractionEnergy &
+PredictorTransposed::
+getTransposedEnergy() const
+{
+	return *energyTransposed;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+OutputHandler &
+PredictorTransposed::
+getTransposedOutput()
+{
+	return outputTransposed;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+void
+PredictorTransposed::
+initOptima( const OutputConstraint & outConstraint )
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+void
+PredictorTransposed::
+updateOptima( const size_t i1, const size_t j1
+			, const size_t i2, const size_t j2
+			, const E_type energy
+			, const bool isHybridE )
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+void
+PredictorTransposed::
+reportOptima( const OutputConstraint & outConstraint )
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_PREDICTORTRANSPOSED_H_ */
@@ -0,0 +1,97 @@
+
+#include "IntaRNA/ResultStore.h"
+
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+
+namespace IntaRNA {
+
+////////////////////////////////////////////////////////////////////////////
+
+const std::string ResultStore::fileHeader = "IntaRNA-result-store-1\n";
+
+////////////////////////////////////////////////////////////////////////////
+
+ResultStore::
+ResultStore( const std::string & storeDir )
+ :	store( storeDir, fileHeader, ".out", "result store" )
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+ResultStore::
+~ResultStore()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+std::string
+ResultStore::
+getKey( const std::string & parameters
+		, const RnaSequence & target
+		, const RnaSequence & query )
+{
+	std::stringstream key;
+	key <<"parameters=" <<parameters
+		<<"\ntarget=" <<target.getId()
+		<<'\n' <<target.asString()
+		<<"\nquery=" <<query.getId()
+		<<'\n' <<query.asString()
+		<<'\n';
+	return key.str();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+ResultStore::
+read( const std::string & key, std::string & output ) const
+{
+	std::ifstream in;
+	if (!store.open( key, in )) {
+		return false;
+	}
+	const std::string fileName = getFileName( key );
+
+	// read output
+	uint64_t outputSize = 0;
+	in.read( (char*)&outputSize, sizeof(outputSize) );
+	std::string entryOutput( in.good() ? outputSize : 0, '\0' );
+	if (in.good() && !entryOutput.empty()) {
+		in.read( &(entryOutput[0]), entryOutput.size() );
+	}
+	if (in.fail()) {
+#if INTARNA_MULITHREADING
+			#pragma omp critical(intarna_omp_logOutput)
+#endif
+		{ VLOG(2) <<"result store : ignoring incomplete entry "<<fileName; }
+		return false;
+	}
+	output.swap( entryOutput );
+
+#if INTARNA_MULITHREADING
+		#pragma omp critical(intarna_omp_logOutput)
+#endif
+	{ VLOG(2) <<"result store : read output from "<<fileName; }
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+ResultStore::
+write( const std::string & key, const std::string & output ) const
+{
+	const uint64_t outputSize = output.size();
+	KeyedFileStore::DataBlocks data;
+	data.push_back( std::make_pair( (const char*)&outputSize, sizeof(outputSize) ) );
+	data.push_back( std::make_pair( output.c_str(), output.size() ) );
+	store.write( key, data );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
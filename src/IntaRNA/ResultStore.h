@@ -0,0 +1,108 @@
+
+#ifndef INTARNA_RESULTSTORE_H_
+#define INTARNA_RESULTSTORE_H_
+
+#include "IntaRNA/general.h"
+#include "IntaRNA/RnaSequence.h"
+#include "IntaRNA/KeyedFileStore.h"
+
+#include <string>
+
+namespace IntaRNA {
+
+/**
+ * Persistent on-disk store of the output reported for query-target
+ * combinations to avoid their recomputation by later runs (e.g. reruns of
+ * pipelines for overlapping sets of sequences).
+ *
+ * Each entry holds the formatted output of one combination and is kept in a
+ * KeyedFileStore, where each entry's key describes both sequences (including
+ * their IDs, since these are part of the output) and all parameters the
+ * output depends on (see getKey()).
+ *
+ */
+class ResultStore {
+
+public:
+
+	/**
+	 * Construction
+	 * @param storeDir the (existing) directory to store the entries in
+	 */
+	ResultStore( const std::string & storeDir );
+
+	/**
+	 * destruction
+	 */
+	virtual ~ResultStore();
+
+	/**
+	 * Generates the key of an entry, i.e. a description of the combination
+	 * and all parameters its output depends on.
+	 *
+	 * @param parameters the description of all parameters the output
+	 *        depends on
+	 * @param target the target sequence of the combination
+	 * @param query the query sequence of the combination
+	 * @return the key of the entry
+	 */
+	static
+	std::string
+	getKey( const std::string & parameters
+			, const RnaSequence & target
+			, const RnaSequence & query );
+
+	/**
+	 * Reads the output of an entry if available.
+	 *
+	 * @param key the key of the entry
+	 * @param output OUT the stored output
+	 * @return true if the entry was found and read; false otherwise, where
+	 *         output is not altered
+	 */
+	bool
+	read( const std::string & key, std::string & output ) const;
+
+	/**
+	 * Stores the output of an entry. Write failures are logged but
+	 * otherwise ignored, since the store is not mandatory for computation.
+	 *
+	 * @param key the key of the entry
+	 * @param output the output to store
+	 */
+	void
+	write( const std::string & key, const std::string & output ) const;
+
+	/**
+	 * Provides the name of the file that holds an entry.
+	 * @param key the key of the entry
+	 * @return the full file name of the entry
+	 */
+	std::string
+	getFileName( const std::string & key ) const;
+
+protected:
+
+	//! the store of the entries
+	const KeyedFileStore store;
+
+	//! identifier at the beginning of each entry file
+	static const std::string fileHeader;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+std::string
+ResultStore::
+getFileName( const std::string & key ) const
+{
+	return store.getFileName( key );
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_RESULTSTORE_H_ */
@@ -11,6 +11,32 @@ namespace IntaRNA {
 
 ////////////////////////////////////////////////////////////////////////////
 
+ReverseAccessibility::
+ReverseAccessibility( Accessibility & origAcc
+					, const bool materialize )
+ :
+	Accessibility( origAcc.getSequence(), origAcc.getMaxLength(), &origAcc.getAccConstraint() )
+	, origAcc(origAcc)
+	, seqReversed( seq.getId(), getReversedString(seq) )
+	, accConstrReversed( origAcc.getAccConstraint(), true )
+	, materialized( materialize )
+	, edReversed()
+{
+	if (materialized) {
+		const size_t seqLength = origAcc.getSequence().size();
+		const size_t maxLength = origAcc.getMaxLength();
+		edReversed.resize( seqLength, maxLength );
+		// copy reversed ED values row-wise for each region start
+		for (size_t from=0; from<seqLength; from++) {
+			for (size_t to=from; to<seqLength && to-from<maxLength; to++) {
+				edReversed.set( from, to, origAcc.getED( seqLength-to-1, seqLength-from-1 ) );
+			}
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 std::string
 ReverseAccessibility::
 getReversedString( const RnaSequence & seq )
@@ -3,12 +3,20 @@
 #define INTARNA_REVERSEACCESSIBILITY_H_
 
 #include "IntaRNA/Accessibility.h"
+#include "IntaRNA/EdBandMatrix.h"
 
 namespace IntaRNA {
 
 /**
  * Defines an accessibility meta object with reversed index access to sequence
  * and accessibility.
+ *
+ * Optionally, the reversed ED values are materialized once within an own
+ * contiguous storage on construction, such that each ED access is a direct
+ * lookup instead of an index transformation and a (virtual) call of the
+ * original accessibility object. This is beneficial if the object is
+ * reused, e.g. for a query that is screened against many targets. Regions
+ * exceeding the maximal length are still accessed via the original object.
  */
 class ReverseAccessibility: public Accessibility {
 public:
@@ -17,8 +25,11 @@ public:
 	 * Construction based on a given accessibility object to represent reversed
 	 *
 	 * @param origAcc Access to the accessibility object to reverse
+	 * @param materialize whether or not all reversed ED values are to be
+	 *        copied from origAcc into an own storage for direct access
 	 */
-	ReverseAccessibility( Accessibility & origAcc );
+	ReverseAccessibility( Accessibility & origAcc
+						, const bool materialize = false );
 
 	/**
 	 * destruction
@@ -83,6 +94,14 @@ public:
 	IndexRange
 	getReversedIndexRange( const IndexRange & r ) const;
 
+	/**
+	 * Whether or not the reversed ED values are materialized.
+	 * @return true if ED values are accessed from an own storage; false if
+	 *         they are accessed from the original accessibility object
+	 */
+	bool
+	isMaterialized() const;
+
 
 protected:
 
@@ -96,6 +115,12 @@ protected:
 	//! reversed accessibility constraint object
 	AccessibilityConstraint accConstrReversed;
 
+	//! whether or not the reversed ED values are stored in edReversed
+	const bool materialized;
+
+	//! the materialized reversed ED values (if materialized)
+	EdBandMatrix edReversed;
+
 
 	/**
 	 * Computes a reversed string representation of a sequence
@@ -123,17 +148,6 @@ protected:
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
-inline
-ReverseAccessibility::ReverseAccessibility( Accessibility & origAcc )
- :
-	Accessibility( origAcc.getSequence(), origAcc.getMaxLength(), &origAcc.getAccConstraint() )
-	, origAcc(origAcc)
-	, seqReversed( seq.getId(), getReversedString(seq) )
-	, accConstrReversed( origAcc.getAccConstraint(), true )
-{
-}
-
-////////////////////////////////////////////////////////////////////////////
 
 inline
 ReverseAccessibility::~ReverseAccessibility() {
@@ -173,6 +187,10 @@ getED( const size_t from, const size_t to ) const
 {
 	// check indices
 	checkIndices(from,to);
+	// direct access of materialized values
+	if (materialized && (to-from+1) <= edReversed.getMaxLength()) {
+		return edReversed.get( from, to );
+	}
 	// reversed ED access
 	return origAcc.getED( seq.size()-to-1, seq.size()-from-1 );
 }
@@ -213,6 +231,16 @@ getReversedIndexRange( const IndexRange & r ) const
 
 ////////////////////////////////////////////////////////////////////////////
 
+inline
+bool
+ReverseAccessibility::
+isMaterialized() const
+{
+	return materialized;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 } // namespace
 
 #endif /* REVERSEACCESSIBILITY_H_ */
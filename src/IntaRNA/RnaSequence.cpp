@@ -23,6 +23,107 @@ const std::string RnaSequence::SequenceAlphabetIUPAC	= "aAuUcCgGtTrRyYsSwWkKmMbB
 
 const size_t RnaSequence::lastPos = std::string::npos;
 
+const size_t RnaSequence::nucleotidesPerPackedWord = sizeof(RnaSequence::PackedWord_type)*4;
+
+// odd base such that the hash is a bijection per position modulo 2^64
+const RnaSequence::Hash_type RnaSequence::hashBase = 1099511628211ULL;
+
+/////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/**
+ * Lookup table that maps each character to the index of its normalized
+ * nucleotide within "ACGUN", i.e. lower case letters are upper-cased, T is
+ * mapped to U and all other characters to N.
+ */
+class NucleotideIndexTable {
+public:
+	//! the nucleotide index for each character
+	unsigned char index[256];
+	//! construction of the table
+	NucleotideIndexTable()
+	{
+		for (size_t c=0; c<256; c++) {
+			index[c] = 4;
+		}
+		index[(unsigned char)'A'] = index[(unsigned char)'a'] = 0;
+		index[(unsigned char)'C'] = index[(unsigned char)'c'] = 1;
+		index[(unsigned char)'G'] = index[(unsigned char)'g'] = 2;
+		index[(unsigned char)'U'] = index[(unsigned char)'u'] = 3;
+		index[(unsigned char)'T'] = index[(unsigned char)'t'] = 3;
+	}
+};
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////////////////
+
+void
+RnaSequence::
+initEncoding( const std::string & rawString )
+{
+	// thread-safe one-time initialization
+	static const NucleotideIndexTable table;
+
+	// normalized characters and their codes in index order
+	const char normChar[5] = {'A','C','G','U','N'};
+	Code_type normCode[5];
+	for (size_t k=0; k<5; k++) {
+		normCode[k] = getCodeForChar( normChar[k] );
+	}
+
+	seqString.resize( rawString.size() );
+	seqCode.resize( rawString.size() );
+	seqPacked.assign( (rawString.size()+nucleotidesPerPackedWord-1)/nucleotidesPerPackedWord, 0 );
+	ambiguousPos.clear();
+	for (size_t i=0; i<rawString.size(); i++) {
+		const unsigned char k = table.index[ (unsigned char)rawString[i] ];
+		seqString[i] = normChar[k];
+		seqCode[i] = normCode[k];
+		if (k < 4) {
+			seqPacked[i/nucleotidesPerPackedWord] |= ((PackedWord_type)k) << (2*(i%nucleotidesPerPackedWord));
+		} else {
+			ambiguousPos.push_back(i);
+		}
+	}
+	ambiguous = !ambiguousPos.empty();
+	// hash of the whole sequence
+	hash = getWindowHashes( seqString.size() ).at(0);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+std::vector<RnaSequence::Hash_type>
+RnaSequence::
+getWindowHashes( const size_t windowLength ) const
+{
+	std::vector<Hash_type> hashes;
+	if (windowLength == 0 || windowLength > size()) {
+		return hashes;
+	}
+	hashes.resize( size()-windowLength+1 );
+
+	// hashBase^(windowLength-1) to remove the leading nucleotide
+	Hash_type leadingFactor = 1;
+	for (size_t k=1; k<windowLength; k++) {
+		leadingFactor *= hashBase;
+	}
+
+	// hash of the first window
+	Hash_type curHash = 0;
+	for (size_t i=0; i<windowLength; i++) {
+		curHash = curHash*hashBase + getHashValue(i);
+	}
+	hashes[0] = curHash;
+	// roll over all remaining windows
+	for (size_t i=1; i<hashes.size(); i++) {
+		curHash = (curHash - getHashValue(i-1)*leadingFactor)*hashBase + getHashValue(i+windowLength-1);
+		hashes[i] = curHash;
+	}
+	return hashes;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 
 
@@ -2,6 +2,7 @@
 #ifndef INTARNA_RNASEQUENCE_H_
 #define INTARNA_RNASEQUENCE_H_
 
+#include <cstdint>
 #include <locale>
 #include <string>
 #include <vector>
@@ -34,12 +35,24 @@ public:
 	typedef std::string String_type;
 
 	//! type for integer encoding of a single sequence letter
-	//! (currently same as in Vienna package)
-	typedef short Code_type;
+	//! (values same as in Vienna package)
+	typedef signed char Code_type;
 
 	//! type for sequence integer encoded representation
 	typedef std::vector<Code_type> CodeSeq_type;
 
+	//! type of the machine words of the 2-bit packed sequence encoding
+	typedef uint64_t PackedWord_type;
+
+	//! type for sequence 2-bit packed representation
+	typedef std::vector<PackedWord_type> PackedSeq_type;
+
+	//! type of sequence hash values
+	typedef uint64_t Hash_type;
+
+	//! number of nucleotides per word of the packed sequence encoding
+	static const size_t nucleotidesPerPackedWord;
+
 
 	/**
 	 * Allowed nucleotide single letter character alphabet according to IUPAC
@@ -104,6 +117,51 @@ public:
 	const CodeSeq_type&
 	asCodes() const;
 
+	/**
+	 * Access to the sequence in 2-bit packed encoding, where A,C,G,U are
+	 * encoded by 0,1,2,3 and nucleotidesPerPackedWord nucleotides are stored
+	 * (starting with the least significant bits) within each word.
+	 * Ambiguous positions are encoded by 0 (see getAmbiguousPositions()).
+	 * @return the 2-bit packed encoding of the sequence
+	 */
+	const PackedSeq_type&
+	asPackedCodes() const;
+
+	/**
+	 * Access to the 2-bit code of a sequence position (see asPackedCodes()).
+	 * @param i the sequence position of interest
+	 * @return the 2-bit code of position i (0 for ambiguous positions)
+	 */
+	size_t
+	getPackedCode( const size_t i ) const;
+
+	/**
+	 * Access to all positions with an ambiguous nucleotide encoding
+	 * @return the positions in ascending order
+	 */
+	const std::vector<size_t>&
+	getAmbiguousPositions() const;
+
+	/**
+	 * Access to the hash value of the sequence (ignoring the ID), which is
+	 * equal to the rolling hash of the window covering the whole sequence
+	 * (see getWindowHashes()).
+	 * @return the hash value of the sequence
+	 */
+	Hash_type
+	getHash() const;
+
+	/**
+	 * Computes the rolling hash values of all subsequences of a given length
+	 * based on the packed sequence encoding.
+	 * @param windowLength the length of the subsequences (> 0)
+	 * @return the hash value of the subsequence starting at i for each
+	 *         i in [0,size()-windowLength]; empty if the sequence is shorter
+	 *         than windowLength
+	 */
+	std::vector<Hash_type>
+	getWindowHashes( const size_t windowLength ) const;
+
 	/**
 	 * Whether or not the sequence contains ambiguous nucleotide encodings.
 	 * @return true if the sequence contains ambiguous nucleotide encodings;
@@ -238,6 +296,38 @@ protected:
 	//! Whether or not the sequence contains ambiguous nucleotide encodings
 	bool ambiguous;
 
+	//! 2-bit packed encoding of the sequence
+	PackedSeq_type seqPacked;
+
+	//! the positions of ambiguous nucleotides in ascending order
+	std::vector<size_t> ambiguousPos;
+
+	//! hash value of the sequence
+	Hash_type hash;
+
+	//! the base of the polynomial rolling hash
+	static const Hash_type hashBase;
+
+	/**
+	 * Provides the value of a sequence position used for hashing, which
+	 * distinguishes ambiguous from unambiguous nucleotides.
+	 * @param i the sequence position of interest
+	 * @return the hash value of the nucleotide at position i
+	 */
+	Hash_type
+	getHashValue( const size_t i ) const;
+
+	/**
+	 * Fills seqString, seqCode, ambiguous, seqPacked, ambiguousPos and hash
+	 * from the given raw sequence in a single pass, i.e. upper-casing,
+	 * T-to-U conversion, N-masking and encoding are done at once via
+	 * lookup tables.
+	 *
+	 * @param rawString the sequence as provided by the user
+	 */
+	void
+	initEncoding( const std::string & rawString );
+
 };
 
 
@@ -252,9 +342,12 @@ RnaSequence::RnaSequence(
 		, const std::string & seqString )
  :
 	id(id)
-	, seqString(getUpperCase(seqString))
-	, seqCode(getCodeForString(this->seqString))
-	, ambiguous(this->seqString.find('N')!=std::string::npos)
+	, seqString(seqString.size(),'N')
+	, seqCode(seqString.size())
+	, ambiguous(false)
+	, seqPacked()
+	, ambiguousPos()
+	, hash(0)
 {
 #if INTARNA_IN_DEBUG_MODE
 	if (id.size() == 0) {
@@ -263,8 +356,12 @@ RnaSequence::RnaSequence(
 	if (seqString.size() == 0) {
 		throw std::runtime_error("RnaSequence::RnaSequence : seqString empty");
 	}
+	if (!isValidSequenceIUPAC(seqString)) {
+		throw std::runtime_error("RnaSequence::RnaSequence() : the given sequence contains non-IUPAC codes : '"+seqString+"'");
+	}
 #endif
-
+	// setup all encodings
+	initEncoding( seqString );
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -320,6 +417,61 @@ asCodes() const
 
 /////////////////////////////////////////////////////////////////////////////
 
+inline
+const
+RnaSequence::
+PackedSeq_type&
+RnaSequence::
+asPackedCodes() const
+{
+	return seqPacked;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+RnaSequence::
+getPackedCode( const size_t i ) const
+{
+	return (size_t)(seqPacked.at(i/nucleotidesPerPackedWord) >> (2*(i%nucleotidesPerPackedWord))) & 3;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+inline
+const std::vector<size_t>&
+RnaSequence::
+getAmbiguousPositions() const
+{
+	return ambiguousPos;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+inline
+RnaSequence::
+Hash_type
+RnaSequence::
+getHash() const
+{
+	return hash;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+inline
+RnaSequence::
+Hash_type
+RnaSequence::
+getHashValue( const size_t i ) const
+{
+	// unambiguous nucleotides : 1..4, ambiguous : 5
+	return seqString[i] == 'N' ? 5 : (Hash_type)getPackedCode(i)+1;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 inline
 bool
 RnaSequence::
@@ -478,6 +630,8 @@ operator == ( const RnaSequence &rna2 ) const
 				this->size() == rna2.size()
 				// ids are identical (most likely shorter, i.e. faster check)
 				&& this->id == rna2.id
+				// hash values identical (fast reject)
+				&& this->hash == rna2.hash
 				// sequences identical
 				&& this->seqString == rna2.seqString
 			);
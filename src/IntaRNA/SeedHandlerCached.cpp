@@ -0,0 +1,72 @@
+
+#include "IntaRNA/SeedHandlerCached.h"
+
+namespace IntaRNA {
+
+//////////////////////////////////////////////////////////////////////////
+
+size_t
+SeedHandlerCached::
+fillSeed( const size_t i1min, const size_t i1max, const size_t i2min, const size_t i2max)
+{
+
+#if INTARNA_IN_DEBUG_MODE
+	if ( i1min > i1max ) throw std::runtime_error("SeedHandlerCached::fillSeed: i1min("+toString(i1min)+") > i1max("+toString(i1max)+")");
+	if ( i2min > i2max ) throw std::runtime_error("SeedHandlerCached::fillSeed: i2min("+toString(i2min)+") > i2max("+toString(i2max)+")");
+#endif
+
+	// seeds starting in these rows/columns might exceed the window
+	const size_t maxLength1 = seedConstraint.getMaxLength1();
+	const size_t maxLength2 = seedConstraint.getMaxLength2();
+	strip1from = (i1max+2 > i1min+maxLength1) ? i1max+2-maxLength1 : i1min;
+	strip2from = (i2max+2 > i2min+maxLength2) ? i2max+2-maxLength2 : i2min;
+
+	// compute seeds of the boundary rows
+	size_t seedCount = seedsStrip1.fillSeed( strip1from, i1max, i2min, i2max );
+
+	// check if there are rows left
+	if (strip1from == i1min) {
+		return seedCount;
+	}
+
+	// compute seeds of the boundary columns (all rows needed for recursion)
+	seedsStrip2.fillSeed( i1min, i1max, strip2from, i2max );
+
+	// count seeds of the remaining rows
+	for (size_t i1=i1min; i1<strip1from; i1++) {
+		for (size_t i2=i2min; i2<=i2max; i2++) {
+			if (E_isNotINF( getSeedE(i1,i2) )) {
+				seedCount++;
+			}
+		}
+	}
+
+	return seedCount;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void
+SeedHandlerCached::
+traceBackSeed( Interaction & interaction
+		, const size_t i1
+		, const size_t i2
+		)
+{
+	if (i1 >= strip1from) {
+		seedsStrip1.traceBackSeed( interaction, i1, i2 );
+	} else
+	if (i2 >= strip2from) {
+		seedsStrip2.traceBackSeed( interaction, i1, i2 );
+	} else {
+		// recompute the shared seed for its boundaries only, which yields the
+		// same mfe seed since it is within these boundaries
+		seedsTrace.fillSeed( i1, i1+seedCache.getSeedLength1(i1,i2)-1
+							, i2, i2+seedCache.getSeedLength2(i1,i2)-1 );
+		seedsTrace.traceBackSeed( interaction, i1, i2 );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
@@ -0,0 +1,220 @@
+
+#ifndef INTARNA_SEEDHANDLERCACHED_H_
+#define INTARNA_SEEDHANDLERCACHED_H_
+
+#include "IntaRNA/SeedHandler.h"
+#include "IntaRNA/SeedHandlerMfe.h"
+
+namespace IntaRNA {
+
+/**
+ * Seed handler that provides the mfe seed information of a window from a
+ * seed table precomputed for a range covering all windows (e.g. of all
+ * window combinations of a target-query pair), such that seeds within the
+ * overlap of windows are not recomputed for each window.
+ *
+ * Seeds starting at (i1,i2) with i1+maxLength1-1 and i2+maxLength2-1 within
+ * the window are independent of the window's right ends and thus taken from
+ * the shared table. Only the seeds of the remaining boundary strips are
+ * computed for the window (since they might be restricted by the window's
+ * right ends).
+ *
+ * The shared table is not altered, i.e. it can be used by multiple
+ * handlers (and threads) concurrently.
+ *
+ */
+class SeedHandlerCached : public SeedHandler
+{
+public:
+
+	/**
+	 * Construction
+	 * @param energy the energy function to be used for seed prediction
+	 * @param seedConstraint the seed constraint to be applied
+	 * @param seedCache the seed table computed for a range covering all
+	 *        windows to be filled, using the same energy function and
+	 *        seed constraint (not deleted by this handler)
+	 */
+	SeedHandlerCached(
+			const InteractionEnergy & energy
+			, const SeedConstraint & seedConstraint
+			, const SeedHandlerMfe & seedCache
+			);
+
+	/**
+	 * destruction
+	 */
+	virtual ~SeedHandlerCached();
+
+	/**
+	 * Computes the seeds of the boundary strips of the given window and
+	 * counts all seeds of the window.
+	 *
+	 * @param i1 the first index of seq1 that might interact
+	 * @param j1 the last index of seq1 that might interact
+	 * @param i2 the first index of seq2 that might interact
+	 * @param j2 the last index of seq2 that might interact
+	 * @return the number of potential seed interactions
+	 */
+	virtual
+	size_t
+	fillSeed(const size_t i1, const size_t j1, const size_t i2, const size_t j2);
+
+	/**
+	 * Identifies the base pairs of the mfe seed interaction starting at i1,i2
+	 * and writes them to the provided container
+	 *
+	 * NOTE: the right most base pair is excluded!
+	 *
+	 * @param interaction the container to add the base pairs too
+	 * @param i1 the start of the seed in seq1
+	 * @param i2 the start of the seed in seq2
+	 */
+	virtual
+	void
+	traceBackSeed( Interaction & interaction, const size_t i1, const size_t i2);
+
+	/**
+	 * Access to the mfe of any seed with left-most base pair (i1,i2)
+	 * @param i1 the left most interacting base of seq1
+	 * @param i2 the left most interacting base of seq2
+	 * @return the mfe of any seed starting at (i1,i2) or E_INF if none possible
+	 */
+	virtual
+	E_type
+	getSeedE( const size_t i1, const size_t i2 ) const;
+
+	/**
+	 * Access to the length in seq1 of the mfe seed with left-most base pair (i1,i2)
+	 * @param i1 the left most interacting base of seq1
+	 * @param i2 the left most interacting base of seq2
+	 * @return the length in seq1 of the mfe seed starting at (i1,i2) or 0 if none possible
+	 */
+	virtual
+	size_t
+	getSeedLength1( const size_t i1, const size_t i2 ) const;
+
+	/**
+	 * Access to the length in seq2 of the mfe seed with left-most base pair (i1,i2)
+	 * @param i1 the left most interacting base of seq1
+	 * @param i2 the left most interacting base of seq2
+	 * @return the length in seq2 of the mfe seed starting at (i1,i2) or 0 if none possible
+	 */
+	virtual
+	size_t
+	getSeedLength2( const size_t i1, const size_t i2 ) const;
+
+protected:
+
+	//! the shared seed table covering the current window
+	const SeedHandlerMfe & seedCache;
+
+	//! the seeds starting in rows [strip1from,j1] of the current window
+	SeedHandlerMfe seedsStrip1;
+
+	//! the seeds starting in columns [strip2from,j2] of the current window
+	//! (only used for rows < strip1from)
+	SeedHandlerMfe seedsStrip2;
+
+	//! handler to recompute shared seeds for traceback
+	SeedHandlerMfe seedsTrace;
+
+	//! the first row of the current window whose seeds are in seedsStrip1
+	size_t strip1from;
+
+	//! the first column of the current window whose seeds are in seedsStrip2
+	size_t strip2from;
+
+	/**
+	 * Provides the handler that holds the seed information for (i1,i2)
+	 * of the current window
+	 * @param i1 the left most interacting base of seq1
+	 * @param i2 the left most interacting base of seq2
+	 * @return the according handler
+	 */
+	const SeedHandler &
+	getHandler( const size_t i1, const size_t i2 ) const;
+
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+
+inline
+SeedHandlerCached::SeedHandlerCached(
+		const InteractionEnergy & energy
+		, const SeedConstraint & seedConstraint
+		, const SeedHandlerMfe & seedCache
+		)
+	:
+		SeedHandler(energy,seedConstraint)
+		, seedCache(seedCache)
+		, seedsStrip1(energy,seedConstraint)
+		, seedsStrip2(energy,seedConstraint)
+		, seedsTrace(energy,seedConstraint)
+		, strip1from(0)
+		, strip2from(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+SeedHandlerCached::~SeedHandlerCached()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+const SeedHandler &
+SeedHandlerCached::
+getHandler( const size_t i1, const size_t i2 ) const
+{
+	if (i1 >= strip1from) {
+		return seedsStrip1;
+	}
+	if (i2 >= strip2from) {
+		return seedsStrip2;
+	}
+	return seedCache;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+E_type
+SeedHandlerCached::
+getSeedE( const size_t i1, const size_t i2 ) const
+{
+	return getHandler(i1,i2).getSeedE(i1,i2);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+SeedHandlerCached::
+getSeedLength1( const size_t i1, const size_t i2 ) const
+{
+	return getHandler(i1,i2).getSeedLength1(i1,i2);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+SeedHandlerCached::
+getSeedLength2( const size_t i1, const size_t i2 ) const
+{
+	return getHandler(i1,i2).getSeedLength2(i1,i2);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_SEEDHANDLERCACHED_H_ */
@@ -1,6 +1,8 @@
 
 #include "SeedHandlerExplicit.h"
 
+#include <algorithm>
+
 #include <boost/lexical_cast.hpp>
 #include <boost/regex.hpp>
 
@@ -17,6 +19,9 @@ SeedHandlerExplicit(
 		)
  :	SeedHandler(energy,seedConstraint)
 	, seedForLeftEnd()
+	, isSeedStart1( energy.size1(), false )
+	, isSeedStart2( energy.size2(), false )
+	, seedsByStart1()
 {
 #if INTARNA_IN_DEBUG_MODE
 	if (seedConstraint.getExplicitSeeds().empty()) throw std::runtime_error("SeedHandlerExplicit() : explicit seed encoding is empty");
@@ -68,6 +73,15 @@ SeedHandlerExplicit(
 	if (seedForLeftEnd.empty()) {
 		throw std::runtime_error("SeedHandlerExplicit() : no valid explicit seed encodings found");
 	}
+
+	// index seeds by their left end
+	seedsByStart1.reserve( seedForLeftEnd.size() );
+	for (auto it = seedForLeftEnd.begin(); it != seedForLeftEnd.end(); it++) {
+		isSeedStart1[ it->first.first ] = true;
+		isSeedStart2[ it->first.second ] = true;
+		seedsByStart1.push_back( std::make_pair( it->first.first, &(it->second) ) );
+	}
+	std::sort( seedsByStart1.begin(), seedsByStart1.end() );
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -140,10 +154,13 @@ fillSeed( const size_t i1min, const size_t i1max, const size_t i2min, const size
 {
 	// check how many seeds are within the interval
 	size_t withinIntervals = 0;
-	for (auto it = seedForLeftEnd.begin(); it != seedForLeftEnd.end(); it++) {
-		const SeedData & s = it->second;
-		if (	s.start1 >= i1min
-				&& s.start1+s.dotBar1.size()-1 <= i1max
+	// only screen seeds starting within [i1min,i1max]
+	for (auto it = std::lower_bound( seedsByStart1.begin(), seedsByStart1.end()
+							, std::make_pair( i1min, (const SeedData*)NULL ) );
+			it != seedsByStart1.end() && it->first <= i1max; it++)
+	{
+		const SeedData & s = *(it->second);
+		if (	s.start1+s.dotBar1.size()-1 <= i1max
 				&& s.start2 >= i2min
 				&& s.start2+s.dotBar2.size()-1 <= i2max
 				)
@@ -167,12 +184,12 @@ traceBackSeed( Interaction & interaction
 {
 	// copy according seed data if any
 	// try to access seed information
-	auto seed = seedForLeftEnd.find( Interaction::BasePair(i1,i2) );
+	const SeedData * seed = getSeedData( i1, i2 );
 #if INTARNA_IN_DEBUG_MODE
-	if (seed == seedForLeftEnd.end()) throw std::runtime_error("SeedHandlerExplicit::traceBackSeed("+toString(i1)+","+toString(i2)+") : no explicit seed available");
+	if (seed == NULL) throw std::runtime_error("SeedHandlerExplicit::traceBackSeed("+toString(i1)+","+toString(i2)+") : no explicit seed available");
 #endif
 	// fill data structure for current seed
-	const SeedData & s = seed->second;
+	const SeedData & s = *seed;
 	// check if seed can not contain at least three base pairs
 	if (s.dotBar1.size() < 3 && s.dotBar2.size() < 3) {
 		return;
@@ -199,12 +216,12 @@ SeedHandlerExplicit::
 getSeedE( const size_t i1, const size_t i2 ) const
 {
 	// try to access seed information
-	auto seed = seedForLeftEnd.find( Interaction::BasePair(i1,i2) );
+	const SeedData * seed = getSeedData( i1, i2 );
 
 	// check if found
-	if ( seed != seedForLeftEnd.end() ) {
+	if ( seed != NULL ) {
 		// return according energy
-		return seed->second.energy;
+		return seed->energy;
 	}
 	// not found -> mark as invalid seed position
 	return E_INF;
@@ -218,12 +235,12 @@ SeedHandlerExplicit::
 getSeedLength1( const size_t i1, const size_t i2 ) const
 {
 	// try to access seed information
-	auto seed = seedForLeftEnd.find( Interaction::BasePair(i1,i2) );
+	const SeedData * seed = getSeedData( i1, i2 );
 
 	// check if found
-	if ( seed != seedForLeftEnd.end() ) {
+	if ( seed != NULL ) {
 		// return according energy
-		return seed->second.dotBar1.size();
+		return seed->dotBar1.size();
 	}
 	// not found -> mark as invalid seed position
 	return 0;
@@ -237,12 +254,12 @@ SeedHandlerExplicit::
 getSeedLength2( const size_t i1, const size_t i2 ) const
 {
 	// try to access seed information
-	auto seed = seedForLeftEnd.find( Interaction::BasePair(i1,i2) );
+	const SeedData * seed = getSeedData( i1, i2 );
 
 	// check if found
-	if ( seed != seedForLeftEnd.end() ) {
+	if ( seed != NULL ) {
 		// return according energy
-		return seed->second.dotBar2.size();
+		return seed->dotBar2.size();
 	}
 	// not found -> mark as invalid seed position
 	return 0;
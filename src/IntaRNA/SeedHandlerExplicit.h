@@ -7,6 +7,8 @@
 
 #include <boost/unordered_map.hpp>
 
+#include <vector>
+
 namespace IntaRNA
 {
 
@@ -153,8 +155,49 @@ protected:
 	//! container to store
 	boost::unordered_map< Interaction::BasePair, SeedData > seedForLeftEnd;
 
+	//! whether or not a seed starts at the according index of seq1
+	//! (enables fast rejection of cells without seed before hashing)
+	std::vector<bool> isSeedStart1;
+
+	//! whether or not a seed starts at the according index of seq2
+	std::vector<bool> isSeedStart2;
+
+	//! all seeds sorted by their start in seq1
+	std::vector< std::pair< size_t, const SeedData* > > seedsByStart1;
+
+	/**
+	 * Access to the seed with left-most base pair (i1,i2)
+	 * @param i1 the left most interacting base of seq1
+	 * @param i2 the left most interacting base of seq2
+	 * @return the according seed data or NULL if none available
+	 */
+	const SeedData *
+	getSeedData( const size_t i1, const size_t i2 ) const;
+
 };
 
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+
+inline
+const SeedHandlerExplicit::SeedData *
+SeedHandlerExplicit::
+getSeedData( const size_t i1, const size_t i2 ) const
+{
+	// check if any seed starts in row and column
+	if ( i1 >= isSeedStart1.size() || !isSeedStart1[i1]
+		|| i2 >= isSeedStart2.size() || !isSeedStart2[i2] )
+	{
+		return NULL;
+	}
+	// try to access seed information
+	auto seed = seedForLeftEnd.find( Interaction::BasePair(i1,i2) );
+	return seed == seedForLeftEnd.end() ? NULL : &(seed->second);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 } /* namespace IntaRNA */
 
 #endif /* INTARNA_SEEDHANDLEREXPLICIT_H_ */
@@ -1,10 +1,20 @@
 
 #include "IntaRNA/SeedHandlerMfe.h"
+#include "IntaRNA/Telemetry.h"
+
+#include <algorithm>
+#include <limits>
 
 namespace IntaRNA {
 
 //////////////////////////////////////////////////////////////////////////
 
+const size_t SeedHandlerMfe::minCandidateStretch;
+
+const size_t SeedHandlerMfe::seedRowBlockSize = 64;
+
+//////////////////////////////////////////////////////////////////////////
+
 size_t
 SeedHandlerMfe::
 fillSeed( const size_t i1min, const size_t i1max, const size_t i2min, const size_t i2max)
@@ -17,82 +27,501 @@ fillSeed( const size_t i1min, const size_t i1max, const size_t i2min, const size
 	if ( i2max > energy.size2() ) throw std::runtime_error("SeedHandlerMfe::fillSeed: i2max("+toString(i2max)+") > energy.size2("+toString(energy.size2())+")");
 #endif
 
+	// measure seed computation
+	Telemetry::Timer telemetryTimer( Telemetry::SEED, (i1max-i1min+1)*(i2max-i2min+1) );
+
+	// use rolling stacking energies for gap-free seeds
+	if (isStackedSeed()) {
+		return fillSeedStacked( i1min, i1max, i2min, i2max );
+	}
+
 	// TODO : if (umax==0) apply local alignment/exact match search based on sequence only
 
 	// resize matrizes
-	seed.resize( i1max-i1min+1, i2max-i2min+1 );
-	seedE_rec.resize( SeedIndex({{ // setup ring-list data for seed computation
-					  (SeedRecMatrix::index)(seed.size1())
-					, (SeedRecMatrix::index)(seed.size2())
-					, (SeedRecMatrix::index)(seedConstraint.getBasePairs()+1-2) // +1 for size and -2 to encode at least 2 bps or more
-					, (SeedRecMatrix::index)(seedConstraint.getMaxUnpaired1()+1) // +1 for size
-					, (SeedRecMatrix::index)(seedConstraint.getMaxUnpaired2()+1) // +1 for size
-				}}));
+	seed.resize( i1max-i1min+1, i2max-i2min+1, false );
+	// setup ring-list data for seed computation
+	seedE_recShape[0] = std::min( seed.size1(), seedConstraint.getMaxLength1() ); // rows needed for recursion and traceback
+	seedE_recShape[1] = seed.size2();
+	seedE_recShape[2] = seedConstraint.getBasePairs()+1-2; // +1 for size and -2 to encode at least 2 bps or more
+	seedE_recShape[3] = seedConstraint.getMaxUnpaired1()+1; // +1 for size
+	seedE_recShape[4] = seedConstraint.getMaxUnpaired2()+1; // +1 for size
+	seedE_rec.resize( seedE_recShape[0]*seedE_recShape[1]*seedE_recShape[2]*seedE_recShape[3]*seedE_recShape[4] );
 
 	// store index offset due to restricted matrix size generation
 	offset1 = i1min;
 	offset2 = i2min;
+	// setup constant time seed range checks
+	setupSeedRangeEnds( i1min, i1max, i2min, i2max );
 
 	// temporary variables
-	size_t i1, i2, bpIn, u1, u2, j1, j2, u1p, u2p, k1,k2, u1best, u2best;
+	size_t i1, i2, bpIn, u1, u2, j1, j2, u1best, u2best;
 	E_type curE, bestE;
 
-	size_t seedCountNotInf = 0, seedCount = 0;
+	size_t seedCountNotInf = 0, seedCount = seed.size1()*seed.size2();
+
+	// identify all complementary positions within the matrix ranges
+	pairingMask.setup( energy, IndexRange(i1min,i1max), IndexRange(i2min,i2max), false );
+
+	// identify left ends within the reach of base pair stretches
+	setupCandidates( i1min, i1max, i2min, i2max );
+
+	// init according to no seed interaction
+	std::fill( seed.data().begin(), seed.data().end(), SeedMatrix::value_type( E_INF, 0 ) );
+
+	// number of base pairs enclosed by the seed's boundary base pairs
+	bpIn = seedE_recShape[2]-1;
 
-	// fill for all start indices
+	// fill for all complementary start indices
 	// in decreasing index order
 	for (i1=i1max+1; i1-- > i1min;) {
-	for (i2=i2max+1; i2-- > i2min;) {
 
-		// count seed possibility
-		seedCount++;
+		// fill recursion data of this row
+		fillSeedRec( i1, i2min, i2max, i1max, i2max );
 
-		// init according to no seed interaction
-		seed(i1-offset1,i2-offset2) = SeedMatrix::value_type( E_INF, 0 );
+		// check if full base pair number possible
+		if (i1+bpIn+1 > i1max) {
+			continue;
+		}
 
-		// skip non-complementary left seed boundaries
-		if (!energy.areComplementary(i1,i2)) {
-			continue; // go to next seedE index
+	for (i2=pairingMask.getPrevPairing(i1,i2max+1); i2 != RnaSequence::lastPos; i2=pairingMask.getPrevPairing(i1,i2)) {
+		INTARNA_COUNT_WORK( workCounters.complementaryCells++ );
+		// check if full base pair number possible
+		if (i2+bpIn+1 > i2max) {
+			continue;
+		}
+		// skip left ends that cannot cover a base pair stretch
+		if (!candidateStart.empty() && candidateStart[(i1-offset1)*(seed.size2()+1)+(i2-offset2)] <= 0) {
+			continue;
 		}
 		// skip left seed boundaries excluded from search
-		if (!(seedConstraint.getRanges1().empty() || seedConstraint.getRanges1().covers(i1))) {
+		if (!isSeedRange1(i1,i1)) {
 			continue; // go to next seedE index
 		}
-		if (!(seedConstraint.getRanges2().empty() || seedConstraint.getRanges2().covers(i2))) {
+		if (!isSeedRange2(i2,i2)) {
+			continue; // go to next seedE index
+		}
+
+		INTARNA_COUNT_WORK( workCounters.filledCells++ );
+
+		// find best unpaired combination in seed seed for i1,i2,bp
+		u1best = 0;
+		u2best = 0;
+		bestE = E_INF;
+
+		// for feasible unpaired in seq1 in increasing order
+		for (u1=0; u1<seedE_recShape[3] && (i1+bpIn+1+u1) <= i1max; u1++) {
+		// for feasible unpaired in seq2 in increasing order
+		for (u2=0; u2<seedE_recShape[4] && (u1+u2)<=seedConstraint.getMaxUnpairedOverall() && (i2+bpIn+1+u2) <= i2max; u2++) {
+
+			// get right seed boundaries
+			j1 = i1+bpIn+1+u1;
+			j2 = i2+bpIn+1+u2;
+
+			// skip if ED boundary exceeded
+			if (energy.getED1(i1,j1) > seedConstraint.getMaxED()
+					|| energy.getED2(i2,j2) > seedConstraint.getMaxED() )
+			{
+				continue;
+			}
+
+			// get overall interaction energy
+			curE = energy.getE( i1, j1, i2, j2, E_fromFixed( getSeedE( i1-offset1, i2-offset2, bpIn, u1, u2 ) ) ) + energy.getE_init();
+
+			// check if better than what is known so far
+			if ( curE < bestE ) {
+				bestE = curE;
+				u1best = u1;
+				u2best = u2;
+			}
+		} // u2
+		} // u1
+
+		// reduce bestE to hybridization energy only (init+loops)
+		if (E_isNotINF( bestE )) {
+			// overwrite all seeds with too high energy -> infeasible start interactions
+			if (bestE > seedConstraint.getMaxE()) {
+				bestE = E_INF;
+			} else {
+				// get seed's hybridization loop energies only
+				bestE = E_fromFixed( getSeedE( i1-offset1, i2-offset2, bpIn, u1best, u2best ) );
+				// count true seed
+				seedCountNotInf++;
+				INTARNA_COUNT_WORK( workCounters.optimaUpdates++ );
+			}
+		}
+
+		// store best (mfe) seed for all u1/u2
+		seed(i1-offset1,i2-offset2) = SeedMatrix::value_type( bestE
+				, (uint32_t)(E_isINF(bestE)?0:encodeSeedLength(bpIn+2+u1best,bpIn+2+u2best)) );
+
+	} // i2
+	} // i1
+
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_logOutput)
+#endif
+	{ VLOG(2) <<"valid seeds = "<<seedCountNotInf <<" ("<<(seedCountNotInf/seedCount)<<"% of start index combinations)"; }
+
+	reportWork();
+
+	return seedCountNotInf;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+size_t
+SeedHandlerMfe::
+fillSeedStacked( const size_t i1min, const size_t i1max, const size_t i2min, const size_t i2max )
+{
+	// resize matrix
+	seed.resize( i1max-i1min+1, i2max-i2min+1, false );
+
+	// store index offset due to restricted matrix size generation
+	offset1 = i1min;
+	offset2 = i2min;
+	// setup constant time seed range checks
+	setupSeedRangeEnds( i1min, i1max, i2min, i2max );
+
+	// identify all complementary positions within the matrix ranges
+	pairingMask.setup( energy, IndexRange(i1min,i1max), IndexRange(i2min,i2max), false );
+
+	// init according to no seed interaction
+	std::fill( seed.data().begin(), seed.data().end(), SeedMatrix::value_type( E_INF, 0 ) );
+
+	size_t seedCountNotInf = 0, seedCount = seed.size1()*seed.size2();
+
+	// number of stackings within a seed
+	const size_t stacks = seedConstraint.getBasePairs()-1;
+	// check if any seed fits into the window
+	if (i1min+stacks > i1max || i2min+stacks > i2max) {
+		return 0;
+	}
+	// ring buffer of the fixed-point stacking energies of the current seed
+	std::vector<E_fixed_type> stackE( stacks, E_fixed_INF );
+
+	size_t i1, i2, j1, j2, d, t, infStacks;
+	E_fixed_type sumE;
+	E_type curE;
+
+	// number of diagonals starting in the first column and the first row
+	const size_t diags1 = i1max-stacks-i1min+1;
+	const size_t diags2 = i2max-stacks-i2min+1;
+
+	// for all diagonals starting at (i1min+d,i2min) or (i1min,i2min+d-diags1+1)
+	for (d = 0; d+1 < diags1+diags2; d++) {
+		// get diagonal start
+		if (d < diags1) {
+			i1 = i1min+d;
+			i2 = i2min;
+		} else {
+			i1 = i1min;
+			i2 = i2min+d-diags1+1;
+		}
+
+		// rolling sum of the stackings (t,t+1) for t within the seed
+		sumE = 0;
+		infStacks = 0;
+		for (t=0; i1+t+1 <= i1max && i2+t+1 <= i2max; t++) {
+			// remove stacking that leaves the seed
+			if (t >= stacks) {
+				if (stackE[t%stacks] < E_fixed_INF) {
+					sumE -= stackE[t%stacks];
+				} else {
+					infStacks--;
+				}
+			}
+			// add stacking (t,t+1)
+			stackE[t%stacks] = (pairingMask.isPairing(i1+t,i2+t) && pairingMask.isPairing(i1+t+1,i2+t+1))
+					? E_toFixed( energy.getE_interLeft(i1+t,i1+t+1,i2+t,i2+t+1) )
+					: E_fixed_INF;
+			if (stackE[t%stacks] < E_fixed_INF) {
+				sumE += stackE[t%stacks];
+				INTARNA_COUNT_WORK( workCounters.loopEvaluations++ );
+			} else {
+				infStacks++;
+			}
+
+			// check if a full seed ends here
+			if (t+1 < stacks || infStacks > 0) {
+				continue;
+			}
+
+			// get seed boundaries
+			j1 = i1+t+1;
+			j2 = i2+t+1;
+			const size_t s1 = j1-stacks;
+			const size_t s2 = j2-stacks;
+
+			// check if this index range is to be considered for seed search
+			if (!(isSeedRange1(s1,j1)
+					&& isSeedRange2(s2,j2)))
+			{
+				continue;
+			}
+
+			// skip if ED boundary exceeded
+			if (energy.getED1(s1,j1) > seedConstraint.getMaxED()
+					|| energy.getED2(s2,j2) > seedConstraint.getMaxED() )
+			{
+				continue;
+			}
+
+			// get overall interaction energy and check if seed is feasible
+			INTARNA_COUNT_WORK( workCounters.filledCells++ );
+			curE = energy.getE( s1, j1, s2, j2, E_fromFixed( sumE ) ) + energy.getE_init();
+			if (E_isINF(curE) || curE > seedConstraint.getMaxE()) {
+				continue;
+			}
+
+			// store seed's hybridization loop energies only
+			seed(s1-offset1,s2-offset2) = SeedMatrix::value_type( E_fromFixed( sumE )
+					, (uint32_t)encodeSeedLength(stacks+1,stacks+1) );
+			seedCountNotInf++;
+			INTARNA_COUNT_WORK( workCounters.optimaUpdates++ );
+		}
+	}
+
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_logOutput)
+#endif
+	{ VLOG(2) <<"valid seeds = "<<seedCountNotInf <<" ("<<(seedCountNotInf/seedCount)<<"% of start index combinations)"; }
+
+	reportWork();
+
+	return seedCountNotInf;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void
+SeedHandlerMfe::
+reportWork()
+{
+#if INTARNA_WORK_COUNTERS
+	if (workCounters.empty()) {
+		return;
+	}
+	Telemetry::addWork( workCounters );
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_logOutput)
+#endif
+	{ VLOG(1) <<"seed work : "<<workCounters; }
+	workCounters.clear();
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void
+SeedHandlerMfe::
+setupCandidates( const size_t i1min, const size_t i1max, const size_t i2min, const size_t i2max )
+{
+	// minimal length of a stretch of consecutive base pairs within any seed,
+	// since the unpaired positions split the seed into at most
+	// (maxUnpaired+1) stretches
+	const size_t maxUnpaired = std::min( seedConstraint.getMaxUnpairedOverall()
+			, seedConstraint.getMaxUnpaired1()+seedConstraint.getMaxUnpaired2() );
+	const size_t stretch = std::min( SeedKmerIndex::maxK
+			, (seedConstraint.getBasePairs()+maxUnpaired) / (maxUnpaired+1) );
+
+	// check if stretches are selective enough
+	if (stretch < minCandidateStretch) {
+		candidateRec.clear();
+		candidateStart.clear();
+		return;
+	}
+
+	// build index of seq1 if not available
+	if (kmerIndex == NULL || kmerIndex->getK() != stretch) {
+		INTARNA_CLEANUP(kmerIndex);
+		kmerIndex = new SeedKmerIndex( energy.getAccessibility1().getSequence(), stretch );
+	}
+
+	const size_t size1 = i1max-i1min+1;
+	const size_t size2 = i2max-i2min+1;
+	const size_t cols = size2+1;
+	const size_t maxLength1 = seedConstraint.getMaxLength1();
+	const size_t maxLength2 = seedConstraint.getMaxLength2();
+
+	// 2D difference arrays of the rectangles covered by each stretch
+	candidateRec.assign( (size1+1)*cols, 0 );
+	candidateStart.assign( (size1+1)*cols, 0 );
+
+	size_t p1, p2, from1, from2, to1, to2;
+	std::vector<size_t> hits;
+	// look up all stretches for each start in seq2
+	for (p2=i2min; p2+stretch <= i2max+1; p2++) {
+		hits.clear();
+		kmerIndex->getComplementaryPositions( energy.getAccessibility2().getSequence(), p2, hits );
+		for (size_t h=0; h<hits.size(); h++) {
+			// check if stretch is within the current matrices
+			if (hits[h] < i1min || hits[h]+stretch > i1max+1) {
+				continue;
+			}
+			// relative indices
+			p1 = hits[h]-i1min;
+			from1 = p1 > maxLength1-stretch ? p1-(maxLength1-stretch) : 0;
+			from2 = (p2-i2min) > maxLength2-stretch ? (p2-i2min)-(maxLength2-stretch) : 0;
+			// seeds covering the stretch start within [from,p]
+			to1 = p1+1;
+			to2 = (p2-i2min)+1;
+			candidateStart[from1*cols+from2]++;
+			candidateStart[from1*cols+to2]--;
+			candidateStart[to1*cols+from2]--;
+			candidateStart[to1*cols+to2]++;
+			// their sub-seeds start within [from,p+maxLength-1)
+			to1 = std::min( size1, p1+maxLength1 );
+			to2 = std::min( size2, (p2-i2min)+maxLength2 );
+			candidateRec[from1*cols+from2]++;
+			candidateRec[from1*cols+to2]--;
+			candidateRec[to1*cols+from2]--;
+			candidateRec[to1*cols+to2]++;
+		}
+	}
+
+	// prefix sums to get the number of covering rectangles
+	for (p1=0; p1<size1; p1++) {
+	for (p2=0; p2<size2; p2++) {
+		if (p1 > 0) {
+			candidateRec[p1*cols+p2] += candidateRec[(p1-1)*cols+p2];
+			candidateStart[p1*cols+p2] += candidateStart[(p1-1)*cols+p2];
+		}
+		if (p2 > 0) {
+			candidateRec[p1*cols+p2] += candidateRec[p1*cols+p2-1];
+			candidateStart[p1*cols+p2] += candidateStart[p1*cols+p2-1];
+		}
+		if (p1 > 0 && p2 > 0) {
+			candidateRec[p1*cols+p2] -= candidateRec[(p1-1)*cols+p2-1];
+			candidateStart[p1*cols+p2] -= candidateStart[(p1-1)*cols+p2-1];
+		}
+	}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void
+SeedHandlerMfe::
+setupSeedRangeEnds( const size_t i1min, const size_t i1max, const size_t i2min, const size_t i2max )
+{
+	setupSeedRangeEnd( seedRangeEnd1, seedConstraint.getRanges1(), i1min, i1max );
+	setupSeedRangeEnd( seedRangeEnd2, seedConstraint.getRanges2(), i2min, i2max );
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void
+SeedHandlerMfe::
+setupSeedRangeEnd( std::vector<size_t> & rangeEnd
+				, const IndexRangeList & ranges
+				, const size_t iMin, const size_t iMax )
+{
+	// no ranges = everything covered
+	if (ranges.empty()) {
+		rangeEnd.assign( iMax-iMin+1, std::numeric_limits<size_t>::max() );
+		return;
+	}
+	rangeEnd.assign( iMax-iMin+1, 0 );
+	for (IndexRangeList::const_iterator r = ranges.begin(); r != ranges.end() && r->from <= iMax; r++) {
+		// skip ranges before the interval
+		if (r->to < iMin) {
+			continue;
+		}
+		// right seed ends are at most iMax
+		const size_t end = std::min(iMax,r->to)+1;
+		for (size_t i = std::max(iMin,r->from); i < end; i++) {
+			rangeEnd[i-iMin] = end;
+		}
+	}
+}
+
+void
+SeedHandlerMfe::
+fillSeedRec( const size_t i1, const size_t i2min, const size_t i2max
+			, const size_t j1max, const size_t j2max )
+{
+	// skip left seed boundaries excluded from search
+	if (!isSeedRange1(i1,i1)) {
+		return;
+	}
+
+	// collect all complementary start indices to compute
+	// in decreasing index order
+	std::vector<size_t> rowI2;
+	for (size_t i2=pairingMask.getPrevPairing(i1,i2max+1); i2 != RnaSequence::lastPos && i2 >= i2min; i2=pairingMask.getPrevPairing(i1,i2)) {
+		// skip left seed boundaries excluded from search
+		if (!isSeedRange2(i2,i2)) {
 			continue; // go to next seedE index
 		}
+		// skip left ends not needed for any seed candidate
+		if (!candidateRec.empty() && candidateRec[(i1-offset1)*(seed.size2()+1)+(i2-offset2)] <= 0) {
+			continue;
+		}
+		rowI2.push_back(i2);
+	}
+
+	// the entries of a row only depend on subsequent rows
+	// -> compute blocks of the row in parallel if worthwhile
+	for (size_t b=0; b<rowI2.size(); b+=seedRowBlockSize) {
+#if INTARNA_MULITHREADING
+		#pragma omp task shared(rowI2) firstprivate(b) if(rowI2.size() > seedRowBlockSize)
+#endif
+		fillSeedRec( i1, rowI2, b, std::min(b+seedRowBlockSize,rowI2.size()), j1max, j2max );
+	}
+#if INTARNA_MULITHREADING
+	#pragma omp taskwait
+#endif
+
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void
+SeedHandlerMfe::
+fillSeedRec( const size_t i1
+			, const std::vector<size_t> & rowI2
+			, const size_t from, const size_t to
+			, const size_t j1max, const size_t j2max )
+{
+	// temporary variables
+	size_t i2, bpIn, u1, u2, j1, j2, u1p, u2p, k1,k2;
+	E_fixed_type curEfixed;
+	// DP work of this block
+	INTARNA_COUNT_WORK( WorkCounters work; )
+
+	// fill for the given complementary start indices
+	for (size_t b=from; b<to; b++) {
+		i2 = rowI2[b];
 
 		// for feasible number of base pairs (bp+1) in increasing order
 		// bp=0 encodes 2 base pairs
-		for (bpIn=0; bpIn<seedE_rec.shape()[2] && (i1+bpIn+1-offset1)<seed.size1() && (i2+bpIn+1-offset2)<seed.size2(); bpIn++) {
+		for (bpIn=0; bpIn<seedE_recShape[2] && (i1+bpIn+1)<=j1max && (i2+bpIn+1)<=j2max; bpIn++) {
 
 			// for feasible unpaired in seq1 in increasing order
-			for (u1=0; u1<seedE_rec.shape()[3] && (i1+bpIn+1+u1-offset1) < seed.size1(); u1++) {
-
-				// get right seed boundaries
-				// check if this index range is to be considered for seed search
+			for (u1=0; u1<seedE_recShape[3] && (i1+bpIn+1+u1) <= j1max; u1++) {
 
 			// for feasible unpaired in seq2 in increasing order
-			for (u2=0; u2<seedE_rec.shape()[4] && (u1+u2)<=seedConstraint.getMaxUnpairedOverall() && (i2+bpIn+1+u2-offset2) < seed.size2(); u2++) {
+			for (u2=0; u2<seedE_recShape[4] && (u1+u2)<=seedConstraint.getMaxUnpairedOverall() && (i2+bpIn+1+u2) <= j2max; u2++) {
 
 				// get right seed boundaries
 				j1 = i1+bpIn+1+u1;
 				j2 = i2+bpIn+1+u2;
 				// check if this index range is to be considered for seed search
 				bool validSeedSite =
-						(seedConstraint.getRanges1().empty() || seedConstraint.getRanges1().covers(i1,j1))
-						&& (seedConstraint.getRanges2().empty() || seedConstraint.getRanges2().covers(i2,j2));
+						isSeedRange1(i1,j1)
+						&& isSeedRange2(i2,j2);
 
 				// init current seed energy
-				curE = E_INF;
+				curEfixed = E_fixed_INF;
 
 				// check if right boundary is complementary
-				if (validSeedSite && energy.areComplementary(j1,j2)) {
+				if (validSeedSite && pairingMask.isPairing(j1,j2)) {
 
 					// base case: only left and right base pair present
 					if (bpIn==0) {
 						// energy for stacking/bulge/interior depending on u1/u2
-						curE = energy.getE_interLeft(i1,j1,i2,j2);
+						curEfixed = E_toFixed( energy.getE_interLeft(i1,j1,i2,j2) );
+						INTARNA_COUNT_WORK( work.loopEvaluations++ );
 
 					} else {
 						// split seed recursively into all possible leading interior loops
@@ -105,15 +534,16 @@ fillSeed( const size_t i1min, const size_t i1max, const size_t i2min, const size
 							k2 = i2+u2p+1;
 							// check if split pair is complementary
 							// and recursed entry is < E_INF
-							if (! (energy.areComplementary(k1,k2) && E_isNotINF( getSeedE( k1-offset1, k2-offset2, bpIn-1, u1-u1p, u2-u2p ) ) ) ) {
+							if (! (pairingMask.isPairing(k1,k2) && getSeedE( k1-offset1, k2-offset2, bpIn-1, u1-u1p, u2-u2p ) < E_fixed_INF ) ) {
 								continue; // not complementary -> skip
 							}
 
 							// update mfe for split at k1,k2
-							curE = std::min( curE,
-									energy.getE_interLeft(i1,k1,i2,k2)
-									+ getSeedE( k1-offset1, k2-offset2, bpIn-1, u1-u1p, u2-u2p )
+							curEfixed = std::min( curEfixed,
+									E_fixed_add( E_toFixed( energy.getE_interLeft(i1,k1,i2,k2) )
+											, getSeedE( k1-offset1, k2-offset2, bpIn-1, u1-u1p, u2-u2p ) )
 									);
+							INTARNA_COUNT_WORK( work.loopEvaluations++ );
 						} // u2p
 						} // u1p
 					} // more than two base pairs
@@ -121,76 +551,16 @@ fillSeed( const size_t i1min, const size_t i1max, const size_t i2min, const size
 				} // (j1,j2) complementary
 
 				// store seed energy
-				setSeedE( i1-offset1, i2-offset2, bpIn, u1, u2, curE );
+				setSeedE( i1-offset1, i2-offset2, bpIn, u1, u2, curEfixed );
 
 			} // u2
 			} // u1
 
-			// check if full base pair number reached
-			if (bpIn+1==seedE_rec.shape()[2]) {
-
-				// find best unpaired combination in seed seed for i1,i2,bp
-				u1best = 0;
-				u2best = 0;
-				bestE = E_INF;
-
-				// for feasible unpaired in seq1 in increasing order
-				for (u1=0; u1<seedE_rec.shape()[3] && (i1+bpIn+1+u1-offset1) < seed.size1(); u1++) {
-				// for feasible unpaired in seq2 in increasing order
-				for (u2=0; u2<seedE_rec.shape()[4] && (u1+u2)<=seedConstraint.getMaxUnpairedOverall() && (i2+bpIn+1+u2-offset2) < seed.size2(); u2++) {
-
-					// get right seed boundaries
-					j1 = i1+bpIn+1+u1;
-					j2 = i2+bpIn+1+u2;
-
-					// skip if ED boundary exceeded
-					if (energy.getED1(i1,j1) > seedConstraint.getMaxED()
-							|| energy.getED2(i2,j2) > seedConstraint.getMaxED() )
-					{
-						continue;
-					}
-
-					// get overall interaction energy
-					curE = energy.getE( i1, j1, i2, j2, getSeedE( i1-offset1, i2-offset2, bpIn, u1, u2 ) ) + energy.getE_init();
-
-					// check if better than what is known so far
-					if ( curE < bestE ) {
-						bestE = curE;
-						u1best = u1;
-						u2best = u2;
-					}
-				} // u2
-				} // u1
-
-				// reduce bestE to hybridization energy only (init+loops)
-				if (E_isNotINF( bestE )) {
-					// overwrite all seeds with too high energy -> infeasible start interactions
-					if (bestE > seedConstraint.getMaxE()) {
-						bestE = E_INF;
-					} else {
-						// get seed's hybridization loop energies only
-						bestE = getSeedE( i1-offset1, i2-offset2, bpIn, u1best, u2best );
-						// count true seed
-						seedCountNotInf++;
-					}
-				}
-
-				// store best (mfe) seed for all u1/u2
-				seed(i1-offset1,i2-offset2) = SeedMatrix::value_type( bestE
-						, E_isINF(bestE)?0:encodeSeedLength(bpIn+2+u1best,bpIn+2+u2best) );
-
-			} // store best seed
-
 		} // bp
 	} // i2
-	} // i1
 
-#if INTARNA_MULITHREADING
-	#pragma omp critical(intarna_omp_logOutput)
-#endif
-	{ VLOG(2) <<"valid seeds = "<<seedCountNotInf <<" ("<<(seedCountNotInf/seedCount)<<"% of start index combinations)"; }
-
-	return seedCountNotInf;
+	// update work statistics (thread-safe)
+	INTARNA_COUNT_WORK( workCounters.add( work ); )
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -219,7 +589,7 @@ traceBackSeed( Interaction & interaction
 	   ;
 
 	// get energy of provided seed
-	E_type curE = getSeedE(i1_,i2_,bpInbetween,u1_,u2_);
+	E_fixed_type curE = getSeedE(i1_,i2_,bpInbetween,u1_,u2_);
 
 	// TODO: if (umax==0) just add remaining base pairs (no trace needed)
 
@@ -250,11 +620,11 @@ traceBackSeed( Interaction & interaction
 				k2 = i2+u2+1;
 
 				// check if valid trace
-				if ( E_isNotINF( getSeedE( k1, k2, bpIn-1, u1max-u1, u2max-u2 ) ) ) {
+				if ( getSeedE( k1, k2, bpIn-1, u1max-u1, u2max-u2 ) < E_fixed_INF ) {
 
-					// check if correct trace
-					if ( E_equal( curE, energy.getE_interLeft(i1+offset1,k1+offset1,i2+offset2,k2+offset2)
-										+ getSeedE( k1, k2, bpIn-1, u1max-u1, u2max-u2 )) )
+					// check if correct trace (exact due to fixed-point energies)
+					if ( curE == E_fixed_add( E_toFixed( energy.getE_interLeft(i1+offset1,k1+offset1,i2+offset2,k2+offset2) )
+										, getSeedE( k1, k2, bpIn-1, u1max-u1, u2max-u2 )) )
 					{
 						// store left base pair if not left seed boundary
 						if (i1 != i1_) {
@@ -285,4 +655,23 @@ traceBackSeed( Interaction & interaction
 
 ////////////////////////////////////////////////////////////////////////////
 
+size_t
+SeedHandlerMfe::
+getMemoryEstimate( const size_t size1
+				, const size_t size2
+				, const size_t basePairs
+				, const size_t maxUnpaired1
+				, const size_t maxUnpaired2 )
+{
+	// seed and seedE_rec (same dimensions as in fillSeed())
+	return size1*size2*sizeof(SeedMatrix::value_type)
+			+ std::min( size1, basePairs+maxUnpaired1 ) * size2
+				* (basePairs+1-2)
+				* (maxUnpaired1+1)
+				* (maxUnpaired2+1)
+				* sizeof(SeedRecMatrix::value_type);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 } // namespace
@@ -3,10 +3,17 @@
 #define INTARNA_SEEDHANDLERMFE_H_
 
 #include "IntaRNA/InteractionEnergy.h"
+#include "IntaRNA/HugePageAllocator.h"
+#include "IntaRNA/PairingMask.h"
 #include "IntaRNA/SeedConstraint.h"
 #include "IntaRNA/SeedHandler.h"
+#include "IntaRNA/SeedKmerIndex.h"
+#include "IntaRNA/WorkCounters.h"
 
-#include <boost/multi_array.hpp>
+#include <cstdint>
+#include <vector>
+
+#include <boost/array.hpp>
 
 #include <boost/numeric/ublas/matrix.hpp>
 
@@ -16,30 +23,40 @@ namespace IntaRNA {
  * Handler to provide mfe seed interaction information for each intermolecular
  * index combination (= left end of seed).
  *
+ * Each seed contains a stretch of at least ceil(bp/(maxUnpairedOverall+1))
+ * consecutive base pairs. If this stretch is long enough, its occurrences
+ * are looked up via a k-mer index of seq1 (see SeedKmerIndex) and the seed
+ * recursion is done only for left ends within the reach of a stretch.
+ *
  */
 class SeedHandlerMfe : public SeedHandler
 {
 public:
 
-	// TODO replace with 2D array on sparse matrices since most entries not used
+	//! minimal length of the base pair stretches within seeds to apply the
+	//! k-mer based seed candidate filtering
+	static const size_t minCandidateStretch = 4;
 
-	//! 5D matrix type to hold the mfe energies for seed interactions
+	//! ring buffer to hold the mfe energies for seed interactions
 	//! of the ranges i1..(i1+bp+u1-1) with i2..(i2+bp+u2-1), with
 	//! i1,i2 = the start index of the seed in seq1/2
 	//! bp = the number of base pairs within the seed
 	//! bpInbetween = the number of base pairs enclosed by left and right base pair, ie. == (bp-2)
 	//! u1/u2 = the number of unpaired positions within the seed,
-	//! using the index [i1][i2][bpInbetween][u1][u2] or a SeedIndex object
-	typedef boost::multi_array<E_type,5> SeedRecMatrix;
+	//! for the most recent seedConstraint.getMaxLength1() rows i1 only,
+	//! using the flat index [i1 % rows][i2][bpInbetween][u1][u2] (see getSeedE());
+	//! energies are stored in fixed-point representation (see E_toFixed())
+	//! to enable exact integer minimization and tie detection
+	typedef HugePageAllocator<E_fixed_type>::vector SeedRecMatrix;
 
-	//! defines the seed data {{ i1, i2, bpInbetween, u1, u2 }} to access elements of
-	//! the SeedRecMatrix
-	typedef boost::array<SeedRecMatrix::index, 5> SeedIndex;
+	//! dimensions {{ rows, i2, bpInbetween, u1, u2 }} of the SeedRecMatrix
+	typedef boost::array<size_t, 5> SeedRecShape;
 
 	//! matrix to store the seed information for each seed left side (i1,i2);
 	//! it holds both the energy (first) as well as the length of the seed using
-	//! the length combination using encodeSeedLength()
-	typedef boost::numeric::ublas::matrix< std::pair<E_type, size_t> > SeedMatrix;
+	//! the length combination using encodeSeedLength() (32 bit to get 8 byte
+	//! cells); vector storage keeps its capacity when resized for smaller windows
+	typedef boost::numeric::ublas::matrix< std::pair<E_type, uint32_t>, boost::numeric::ublas::row_major, HugePageAllocator< std::pair<E_type, uint32_t> >::vector > SeedMatrix;
 
 
 public:
@@ -116,25 +133,210 @@ public:
 	size_t
 	getSeedLength2( const size_t i1, const size_t i2 ) const;
 
+	/**
+	 * Computes the memory needed for the seed matrices of a fillSeed() call.
+	 *
+	 * @param size1 the length of the first sequence (window)
+	 * @param size2 the length of the second sequence (window)
+	 * @param basePairs the number of base pairs within a seed
+	 * @param maxUnpaired1 the maximal number of unpaired bases within seq1
+	 * @param maxUnpaired2 the maximal number of unpaired bases within seq2
+	 *
+	 * @return the estimated number of bytes
+	 */
+	static
+	size_t
+	getMemoryEstimate( const size_t size1
+					, const size_t size2
+					, const size_t basePairs
+					, const size_t maxUnpaired1
+					, const size_t maxUnpaired2 );
+
+
 
 
 protected:
 
 	//! the recursion data for the computation of a seed interaction
 	//! i1..(i1+bpInbetween+u1-1) with i2..(i2+bpInbetween+u2-1)
-	//! using the indexing [i1][i2][bpInbetween][u1][u2]
+	//! for the rows i1 still needed (see SeedRecMatrix)
 	SeedRecMatrix seedE_rec;
 
+	//! the dimensions of seedE_rec
+	SeedRecShape seedE_recShape;
+
 	//! the seed mfe information for seeds starting at (i1,i2)
 	//! TODO replace with sparse data structure
 	SeedMatrix seed;
 
+	//! the complementary positions (i1,i2) for the current (restricted) matrices
+	PairingMask pairingMask;
+
+	//! k-mer index of seq1 to identify seed candidates (built on demand) or
+	//! NULL if no candidate filtering is applied
+	SeedKmerIndex * kmerIndex;
+
+	//! number of stretches within reach for each left end (i1,i2) of the
+	//! current (restricted) matrices for which the seed recursion is needed;
+	//! row-major with row length seed.size2()+1; empty if no filtering applied
+	std::vector<int> candidateRec;
+
+	//! number of stretches covered by seeds starting at each left end (i1,i2)
+	//! (same layout as candidateRec)
+	std::vector<int> candidateStart;
+
 	//! offset for seq1 indices for the current (restricted) matrices
 	size_t offset1;
 
 	//! offset for seq2 indices for the current (restricted) matrices
 	size_t offset2;
 
+	//! for each seq1 index of the current (restricted) matrices (without
+	//! offset) the index after the end of the seed range covering it or 0
+	//! if it is not covered by any seed range (see isSeedRange1())
+	std::vector<size_t> seedRangeEnd1;
+
+	//! for each seq2 index of the current (restricted) matrices (without
+	//! offset) the index after the end of the seed range covering it or 0
+	//! if it is not covered by any seed range (see isSeedRange2())
+	std::vector<size_t> seedRangeEnd2;
+
+	//! DP work of the current fillSeed() call (see INTARNA_COUNT_WORK())
+	WorkCounters workCounters;
+
+	/**
+	 * Logs the DP work of the current fillSeed() call, adds it to the
+	 * telemetry summary and resets the counters (only if work counters are
+	 * enabled at build time).
+	 */
+	void
+	reportWork();
+
+	/**
+	 * Sets up seedRangeEnd1 and seedRangeEnd2 for the current (restricted)
+	 * matrices.
+	 *
+	 * @param i1min the first index of seq1 that might interact
+	 * @param i1max the last index of seq1 that might interact
+	 * @param i2min the first index of seq2 that might interact
+	 * @param i2max the last index of seq2 that might interact
+	 */
+	void
+	setupSeedRangeEnds( const size_t i1min, const size_t i1max, const size_t i2min, const size_t i2max );
+
+	/**
+	 * Fills the seed range ends for the given range list and index interval.
+	 *
+	 * @param rangeEnd the container to fill
+	 * @param ranges the seed ranges (all indices covered if empty)
+	 * @param iMin the first index of the interval
+	 * @param iMax the last index of the interval
+	 */
+	static
+	void
+	setupSeedRangeEnd( std::vector<size_t> & rangeEnd
+					, const IndexRangeList & ranges
+					, const size_t iMin, const size_t iMax );
+
+	/**
+	 * Checks in constant time whether or not the seq1 index range [i1,j1] is
+	 * covered by one of the seed ranges of seq1 (or no ranges are given).
+	 * @param i1 the first index (including offset)
+	 * @param j1 the last index (including offset)
+	 * @return true if [i1,j1] is within a seed range
+	 */
+	bool
+	isSeedRange1( const size_t i1, const size_t j1 ) const;
+
+	/**
+	 * Checks in constant time whether or not the seq2 index range [i2,j2] is
+	 * covered by one of the seed ranges of seq2 (or no ranges are given).
+	 * @param i2 the first index (including offset)
+	 * @param j2 the last index (including offset)
+	 * @return true if [i2,j2] is within a seed range
+	 */
+	bool
+	isSeedRange2( const size_t i2, const size_t j2 ) const;
+
+	/**
+	 * Whether or not seeds are gap-free, i.e. stacked helices without
+	 * unpaired positions
+	 * @return true if no unpaired positions are allowed within seeds
+	 */
+	bool
+	isStackedSeed() const;
+
+	/**
+	 * Computes the seed matrix for the given interval boundaries for
+	 * gap-free seeds (see isStackedSeed()). Since such seeds are fully
+	 * determined by their left end, the seed energies are computed via
+	 * a rolling sum of the stacking energies along each diagonal, i.e.
+	 * each stacking energy is computed only once and no recursion data
+	 * is needed.
+	 *
+	 * @param i1min the first index of seq1 that might interact
+	 * @param i1max the last index of seq1 that might interact
+	 * @param i2min the first index of seq2 that might interact
+	 * @param i2max the last index of seq2 that might interact
+	 * @return the number of potential seed interactions
+	 */
+	size_t
+	fillSeedStacked( const size_t i1min, const size_t i1max, const size_t i2min, const size_t i2max );
+
+	/**
+	 * Identifies all stretches of consecutive base pairs within the current
+	 * (restricted) matrices via the k-mer index and sets up candidateRec and
+	 * candidateStart accordingly. If the stretches are too short to be
+	 * selective, no filtering is applied, i.e. both containers are cleared.
+	 *
+	 * @param i1min the first index of seq1 that might interact
+	 * @param i1max the last index of seq1 that might interact
+	 * @param i2min the first index of seq2 that might interact
+	 * @param i2max the last index of seq2 that might interact
+	 */
+	void
+	setupCandidates( const size_t i1min, const size_t i1max, const size_t i2min, const size_t i2max );
+
+	/**
+	 * Computes the recursion data seedE_rec of all seeds starting in row i1
+	 * for the left ends i2min..i2max that end within j1max and j2max.
+	 * All rows (i1,i1+seedConstraint.getMaxLength1()) have to be computed
+	 * (for the same or larger right end bounds) before. Since the entries of
+	 * a row depend on subsequent rows only, blocks of the row are computed
+	 * in parallel (if multi-threading is enabled).
+	 *
+	 * @param i1 the seed left end in seq 1 (index including offset)
+	 * @param i2min the smallest seed left end in seq 2 (index including offset)
+	 * @param i2max the largest seed left end in seq 2 (index including offset)
+	 * @param j1max the largest seed right end in seq 1 (index including offset)
+	 * @param j2max the largest seed right end in seq 2 (index including offset)
+	 */
+	void
+	fillSeedRec( const size_t i1, const size_t i2min, const size_t i2max
+				, const size_t j1max, const size_t j2max );
+
+	/**
+	 * Computes the recursion data seedE_rec of the seeds starting in (i1,i2)
+	 * for a block of the given pairing positions i2 of row i1.
+	 *
+	 * @param i1 the seed left end in seq 1 (index including offset)
+	 * @param rowI2 the seed left ends in seq 2 of row i1 to be computed
+	 *        (index including offset)
+	 * @param from the first index within rowI2 to compute
+	 * @param to the index within rowI2 after the last one to compute
+	 * @param j1max the largest seed right end in seq 1 (index including offset)
+	 * @param j2max the largest seed right end in seq 2 (index including offset)
+	 */
+	void
+	fillSeedRec( const size_t i1
+				, const std::vector<size_t> & rowI2
+				, const size_t from, const size_t to
+				, const size_t j1max, const size_t j2max );
+
+	//! number of pairing positions within a row of seedE_rec that are
+	//! computed within one parallel task
+	static const size_t seedRowBlockSize;
+
 	/**
 	 * Provides the seed energy during recursion.
 	 *
@@ -145,16 +347,17 @@ protected:
 	 * @param u1 the number of unpaired bases within seq 1
 	 * @param u2 the number of unpaired bases within seq 2
 	 *
-	 * @return the energy of the according (sub)seed
+	 * @return the fixed-point energy of the according (sub)seed
 	 */
-	E_type
+	E_fixed_type
 	getSeedE( const size_t i1, const size_t i2, const size_t bpInbetween, const size_t u1, const size_t u2 );
 
 	/**
 	 * Fills the seed energy during recursion.
 	 *
 	 * NOTE: internally a ring-list data structure is used which reuses memory
-	 * instead of allocating mem for all possible parameter combinations. Thus,
+	 * instead of allocating mem for all possible parameter combinations, i.e.
+	 * only the last seedConstraint.getMaxLength1() rows i1 are stored. Thus,
 	 * you have to call the method in appropriate order depending on your seed
 	 * recursion.
 	 *
@@ -164,10 +367,10 @@ protected:
 	 *        and right-most base pair, ie. bpSeed-2
 	 * @param u1 the number of unpaired bases within seq 1
 	 * @param u2 the number of unpaired bases within seq 2
-	 * @param E the energy value to be set
+	 * @param E the fixed-point energy value to be set
 	 */
 	void
-	setSeedE( const size_t i1, const size_t i2, const size_t bpInbetween, const size_t u1, const size_t u2, const E_type E );
+	setSeedE( const size_t i1, const size_t i2, const size_t bpInbetween, const size_t u1, const size_t u2, const E_fixed_type E );
 
 	/**
 	 * Encodes the seed lengths into one number
@@ -228,10 +431,17 @@ SeedHandlerMfe::SeedHandlerMfe(
 		)
 	:
 		SeedHandler(energy,seedConstraint)
-		, seedE_rec( SeedIndex({{ 0,0,0,0,0 }}))
+		, seedE_rec()
+		, seedE_recShape()
 		, seed()
+		, kmerIndex(NULL)
+		, candidateRec()
+		, candidateStart()
 		, offset1(0)
 		, offset2(0)
+		, seedRangeEnd1()
+		, seedRangeEnd2()
+		, workCounters()
 {
 #if INTARNA_IN_DEBUG_MODE
 	if ( ! seedConstraint.getExplicitSeeds().empty()) {
@@ -245,6 +455,7 @@ SeedHandlerMfe::SeedHandlerMfe(
 inline
 SeedHandlerMfe::~SeedHandlerMfe()
 {
+	INTARNA_CLEANUP(kmerIndex);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -270,6 +481,21 @@ traceBackSeed( Interaction & interaction
 	// get number of base pairs within the seed
 	const size_t seedBps = getConstraint().getBasePairs();
 
+	// gap-free seeds : add all inner base pairs
+	if (isStackedSeed()) {
+		for (size_t bp=1; bp+1<seedBps; bp++) {
+			interaction.basePairs.push_back( energy.getBasePair(i1+bp,i2+bp) );
+		}
+		return;
+	}
+
+	// recompute the recursion data of the seed (overwritten in the ring buffer)
+	const size_t j1 = i1+getSeedLength1(i1,i2)-1;
+	const size_t j2 = i2+getSeedLength2(i1,i2)-1;
+	for (size_t k1=j1+1; k1-- > i1; ) {
+		fillSeedRec( k1, i2, j2, j1, j2 );
+	}
+
 	// trace back the according seed
 	traceBackSeed( interaction, i1-offset1, i2-offset2
 			, seedBps-2
@@ -310,17 +536,14 @@ getSeedLength2( const size_t i1, const size_t i2 ) const
 //////////////////////////////////////////////////////////////////////////
 
 inline
-E_type
+E_fixed_type
 SeedHandlerMfe::
 getSeedE( const size_t i1, const size_t i2, const size_t bpInbetween, const size_t u1, const size_t u2 )
 {
-//	return seedE_rec[i1][i2][bpInbetween][u1][u2];
-	return seedE_rec( SeedIndex({{
-		  (SeedRecMatrix::index) i1
-		, (SeedRecMatrix::index) i2
-		, (SeedRecMatrix::index) bpInbetween
-		, (SeedRecMatrix::index) u1
-		, (SeedRecMatrix::index) u2 }}) );
+	return seedE_rec[ ((( (i1 % seedE_recShape[0]) * seedE_recShape[1] + i2)
+							* seedE_recShape[2] + bpInbetween)
+							* seedE_recShape[3] + u1)
+							* seedE_recShape[4] + u2 ];
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -328,15 +551,23 @@ getSeedE( const size_t i1, const size_t i2, const size_t bpInbetween, const size
 inline
 void
 SeedHandlerMfe::
-setSeedE( const size_t i1, const size_t i2, const size_t bpInbetween, const size_t u1, const size_t u2, const E_type E )
+setSeedE( const size_t i1, const size_t i2, const size_t bpInbetween, const size_t u1, const size_t u2, const E_fixed_type E )
 {
-//	seedE_rec[i1][i2][bpInbetween][u1][u2] = E;
-	seedE_rec( SeedIndex({{
-		  (SeedRecMatrix::index) i1
-		, (SeedRecMatrix::index) i2
-		, (SeedRecMatrix::index) bpInbetween
-		, (SeedRecMatrix::index) u1
-		, (SeedRecMatrix::index) u2 }}) ) = E;
+	seedE_rec[ ((( (i1 % seedE_recShape[0]) * seedE_recShape[1] + i2)
+							* seedE_recShape[2] + bpInbetween)
+							* seedE_recShape[3] + u1)
+							* seedE_recShape[4] + u2 ] = E;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+SeedHandlerMfe::
+isStackedSeed() const
+{
+	return seedConstraint.getMaxUnpairedOverall() == 0
+			|| (seedConstraint.getMaxUnpaired1() == 0 && seedConstraint.getMaxUnpaired2() == 0);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -371,6 +602,26 @@ decodeSeedLength2( const size_t code ) const
 
 //////////////////////////////////////////////////////////////////////////
 
+inline
+bool
+SeedHandlerMfe::
+isSeedRange1( const size_t i1, const size_t j1 ) const
+{
+	return j1 < seedRangeEnd1[i1-offset1];
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+SeedHandlerMfe::
+isSeedRange2( const size_t i2, const size_t j2 ) const
+{
+	return j2 < seedRangeEnd2[i2-offset2];
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 } // namespace
 
 #endif /* SEEDHANDLERMFE_H_ */
@@ -0,0 +1,113 @@
+
+#include "IntaRNA/SeedKmerIndex.h"
+
+#include <stdexcept>
+
+namespace IntaRNA {
+
+/////////////////////////////////////////////////////////////////////////////
+
+const size_t SeedKmerIndex::maxK;
+
+/////////////////////////////////////////////////////////////////////////////
+
+SeedKmerIndex::
+SeedKmerIndex( const RnaSequence & seq, const size_t k )
+ :	seq(seq)
+	, k(k)
+	, kmerStart( (((size_t)1) << (2*std::min(k,maxK))) + 1, 0 )
+	, kmerPos()
+{
+	if (k == 0 || k > maxK) {
+		throw std::runtime_error("SeedKmerIndex("+toString(k)+") : k has to be in [1,"+toString(maxK)+"]");
+	}
+
+	// code of the k-mer starting at each position or kmerStart.size() if none
+	const size_t noKmer = kmerStart.size();
+	std::vector<size_t> posCode( seq.size() < k ? 0 : seq.size()-k+1, noKmer );
+
+	// rolling k-mer code (first nucleotide in least significant bits)
+	size_t code = 0;
+	// the number of consecutive unambiguous positions up to the current one
+	size_t unambiguous = 0;
+	for (size_t i=0; i<seq.size(); i++) {
+		code = (code >> 2) | (seq.getPackedCode(i) << (2*(k-1)));
+		unambiguous = seq.isAmbiguous(i) ? 0 : unambiguous+1;
+		if (unambiguous >= k) {
+			posCode[i+1-k] = code;
+			// count occurrence
+			kmerStart[code+1]++;
+		}
+	}
+
+	// prefix sums = start of each k-mer's position list
+	for (size_t c=1; c<kmerStart.size(); c++) {
+		kmerStart[c] += kmerStart[c-1];
+	}
+
+	// store positions in ascending order for each k-mer
+	kmerPos.resize( kmerStart.back() );
+	std::vector<size_t> nextPos( kmerStart.begin(), kmerStart.end()-1 );
+	for (size_t p=0; p<posCode.size(); p++) {
+		if (posCode[p] != noKmer) {
+			kmerPos[ nextPos[posCode[p]]++ ] = p;
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void
+SeedKmerIndex::
+getComplementaryPositions( const RnaSequence & seq2
+						, const size_t i2
+						, std::vector<size_t> & positions ) const
+{
+	// check if stretch is within seq2
+	if (i2+k > seq2.size()) {
+		return;
+	}
+
+	// all k-mer codes complementary to seq2[i2..i2+k-1]
+	std::vector<size_t> codes(1,0);
+	for (size_t t=0; t<k; t++) {
+		// ambiguous nucleotides do not pair
+		if (seq2.isAmbiguous(i2+t)) {
+			return;
+		}
+		const size_t shift = 2*t;
+		// 2-bit codes : A=0, C=1, G=2, U=3
+		switch( seq2.getPackedCode(i2+t) ) {
+		case 0 : // A-U
+			for (size_t c=0; c<codes.size(); c++) { codes[c] |= (((size_t)3) << shift); }
+			break;
+		case 1 : // C-G
+			for (size_t c=0; c<codes.size(); c++) { codes[c] |= (((size_t)2) << shift); }
+			break;
+		case 2 : { // G-C and G-U
+			const size_t curSize = codes.size();
+			for (size_t c=0; c<curSize; c++) {
+				codes.push_back( codes[c] | (((size_t)3) << shift) );
+				codes[c] |= (((size_t)1) << shift);
+			}
+			} break;
+		case 3 : { // U-A and U-G
+			const size_t curSize = codes.size();
+			for (size_t c=0; c<curSize; c++) {
+				codes.push_back( codes[c] | (((size_t)2) << shift) );
+			}
+			} break;
+		}
+	}
+
+	// collect all positions of the complementary k-mers
+	for (size_t c=0; c<codes.size(); c++) {
+		positions.insert( positions.end()
+				, kmerPos.begin()+kmerStart[codes[c]]
+				, kmerPos.begin()+kmerStart[codes[c]+1] );
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+} // namespace
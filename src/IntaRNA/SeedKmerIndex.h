@@ -0,0 +1,131 @@
+
+#ifndef INTARNA_SEEDKMERINDEX_H_
+#define INTARNA_SEEDKMERINDEX_H_
+
+#include "IntaRNA/general.h"
+#include "IntaRNA/RnaSequence.h"
+
+#include <vector>
+
+namespace IntaRNA {
+
+/**
+ * Index of all k-mers of a sequence (e.g. a target), i.e. for each k-mer
+ * the ascending list of positions where it starts. K-mers covering
+ * ambiguous nucleotides are not indexed.
+ *
+ * The index enables the lookup of all stretches of k consecutive
+ * intermolecular base pairs (including GU wobble pairs) with a subsequence
+ * of another sequence without screening all position combinations.
+ *
+ * K-mers are encoded by the 2-bit nucleotide codes (A,C,G,U = 0,1,2,3, see
+ * RnaSequence::getPackedCode()) with the first nucleotide in the least
+ * significant bits. The positions are stored in a compressed row format
+ * over all 4^k codes, thus k is limited to maxK.
+ *
+ */
+class SeedKmerIndex {
+
+public:
+
+	//! the maximal k-mer length supported
+	static const size_t maxK = 8;
+
+public:
+
+	/**
+	 * Builds the index of all k-mers of the given sequence
+	 *
+	 * @param seq the sequence to index
+	 * @param k the k-mer length (in [1,maxK])
+	 *
+	 * @throw std::runtime_error if k is out of range
+	 */
+	SeedKmerIndex( const RnaSequence & seq, const size_t k );
+
+	/**
+	 * destruction
+	 */
+	virtual ~SeedKmerIndex();
+
+	/**
+	 * Access to the k-mer length of the index
+	 * @return the k-mer length
+	 */
+	size_t
+	getK() const;
+
+	/**
+	 * Access to the indexed sequence
+	 * @return the indexed sequence
+	 */
+	const RnaSequence &
+	getSequence() const;
+
+	/**
+	 * Provides all start positions p of the indexed sequence such that
+	 * seq[p+t] is complementary to seq2[i2+t] for all t in [0,k-1], i.e. all
+	 * stretches of k consecutive base pairs (p+t,i2+t) where seq2 is
+	 * indexed in the reversed order of the interaction (as within
+	 * InteractionEnergy).
+	 *
+	 * @param seq2 the sequence to pair with
+	 * @param i2 the first position of the stretch in seq2
+	 * @param positions IN/OUT the container to append the positions to
+	 *        (not sorted if GU wobble pairs are possible)
+	 */
+	void
+	getComplementaryPositions( const RnaSequence & seq2
+							, const size_t i2
+							, std::vector<size_t> & positions ) const;
+
+protected:
+
+	//! the indexed sequence
+	const RnaSequence & seq;
+
+	//! the k-mer length
+	const size_t k;
+
+	//! kmerPos[kmerStart[c]..kmerStart[c+1]-1] are the positions of k-mer c
+	std::vector<size_t> kmerStart;
+
+	//! the start positions of all k-mers grouped by k-mer code
+	std::vector<size_t> kmerPos;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+
+inline
+SeedKmerIndex::~SeedKmerIndex()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+SeedKmerIndex::
+getK() const
+{
+	return k;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+const RnaSequence &
+SeedKmerIndex::
+getSequence() const
+{
+	return seq;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_SEEDKMERINDEX_H_ */
@@ -0,0 +1,494 @@
+
+#include "IntaRNA/Telemetry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+#if INTARNA_MULITHREADING
+	#include <omp.h>
+#endif
+#if INTARNA_HAVE_GETRUSAGE
+	#include <sys/resource.h>
+#endif
+
+namespace IntaRNA {
+
+////////////////////////////////////////////////////////////////////////////
+
+bool Telemetry::enabled = false;
+
+bool Telemetry::traceEnabled = false;
+
+size_t Telemetry::traceBufferSize = 65536;
+
+std::deque< Telemetry::TraceBuffer > Telemetry::traceBuffers;
+
+std::vector< std::vector< std::vector< Telemetry::Sample > > > Telemetry::samples;
+
+std::chrono::steady_clock::time_point Telemetry::startTime = std::chrono::steady_clock::now();
+
+WorkCounters Telemetry::work;
+
+//! the innermost active timer of the current thread
+static thread_local Telemetry::Timer * currentTimer = NULL;
+
+//! the trace buffer of the current thread or NULL if not registered yet
+static thread_local void * currentTraceBuffer = NULL;
+
+//! the names of the stages (see Telemetry::Stage)
+static const char * const stageNames[Telemetry::STAGE_NUMBER] =
+	{ "accessibility", "es", "seed", "hybrid", "traceback", "output" };
+
+////////////////////////////////////////////////////////////////////////////
+
+Telemetry::Timer::
+Timer( const Stage stage, const size_t cells )
+ :	stage(stage)
+	, active(Telemetry::isEnabled() || Telemetry::isTraceEnabled())
+	, cells(cells)
+	, start()
+	, nestedTime(0)
+	, parent(NULL)
+{
+	if (active) {
+		// register as innermost timer
+		parent = currentTimer;
+		currentTimer = this;
+		start = std::chrono::steady_clock::now();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+Telemetry::Timer::
+~Timer()
+{
+	if (active) {
+		const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+		const double seconds = std::chrono::duration<double>( end - start ).count();
+		// exclude time of the enclosing timer
+		if (parent != NULL) {
+			parent->nestedTime += seconds;
+		}
+		currentTimer = parent;
+		// record time spent exclusively for this stage
+		if (Telemetry::isEnabled()) {
+			Telemetry::add( stage, std::max( 0.0, seconds - nestedTime ), cells );
+		}
+		// record the whole scope (nesting is resolved by trace viewers)
+		if (Telemetry::isTraceEnabled()) {
+			Telemetry::addTraceEvent( stageNames[stage], "stage", std::string(), start, end );
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+Telemetry::Span::
+Span( const char * name, const std::string & label )
+ :	name(name)
+	, label(label)
+	, active(Telemetry::isTraceEnabled())
+	, start()
+{
+	if (active) {
+		start = std::chrono::steady_clock::now();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+Telemetry::Span::
+~Span()
+{
+	if (active) {
+		Telemetry::addTraceEvent( name, "pipeline", label, start, std::chrono::steady_clock::now() );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+Telemetry::
+setEnabled( const bool enabled )
+{
+	Telemetry::enabled = enabled;
+	if (enabled) {
+		startTime = std::chrono::steady_clock::now();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+Telemetry::
+setTraceEnabled( const bool enabled, const size_t eventsPerThread )
+{
+	if (enabled) {
+#if INTARNA_MULITHREADING
+		#pragma omp critical(intarna_omp_telemetryUpdate)
+#endif
+		{
+			traceBufferSize = std::max( (size_t)1, eventsPerThread );
+			// start a new trace
+			for (auto b = traceBuffers.begin(); b != traceBuffers.end(); b++) {
+				b->events.clear();
+				b->recorded = 0;
+			}
+		} // omp critical(intarna_omp_telemetryUpdate)
+		startTime = std::chrono::steady_clock::now();
+	}
+	Telemetry::traceEnabled = enabled;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+size_t
+Telemetry::
+getThreadNumber()
+{
+#if INTARNA_MULITHREADING
+	return (size_t)omp_get_thread_num();
+#else
+	return 0;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+Telemetry::
+add( const Stage stage, const double seconds, const size_t cells )
+{
+	const size_t thread = getThreadNumber();
+	const Sample sample = { seconds, cells };
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_telemetryUpdate)
+#endif
+	{
+		// ensure storage for this thread
+		if (samples.size() <= thread) {
+			samples.resize( thread+1, std::vector< std::vector< Sample > >( STAGE_NUMBER ) );
+		}
+		samples[thread][stage].push_back( sample );
+	} // omp critical(intarna_omp_telemetryUpdate)
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+Telemetry::
+clear()
+{
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_telemetryUpdate)
+#endif
+	{
+		samples.clear();
+		work.clear();
+		// buffers are kept since they are referenced by their threads
+		for (auto b = traceBuffers.begin(); b != traceBuffers.end(); b++) {
+			b->events.clear();
+			b->recorded = 0;
+		}
+	} // omp critical(intarna_omp_telemetryUpdate)
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+Telemetry::
+addWork( const WorkCounters & work )
+{
+	// thread-safe
+	Telemetry::work.add( work );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+Telemetry::
+addTraceEvent( const char * name
+			, const char * category
+			, const std::string & label
+			, const std::chrono::steady_clock::time_point & start
+			, const std::chrono::steady_clock::time_point & end )
+{
+	// register a buffer for this thread on first use
+	if (currentTraceBuffer == NULL) {
+#if INTARNA_MULITHREADING
+		#pragma omp critical(intarna_omp_telemetryUpdate)
+#endif
+		{
+			traceBuffers.push_back( TraceBuffer() );
+			traceBuffers.back().thread = getThreadNumber();
+			traceBuffers.back().recorded = 0;
+			currentTraceBuffer = &(traceBuffers.back());
+		} // omp critical(intarna_omp_telemetryUpdate)
+	}
+	// no locking needed since only this thread writes to its buffer
+	TraceBuffer & buffer = *(static_cast< TraceBuffer * >( currentTraceBuffer ));
+	const TraceEvent event = { name, category, label
+			, std::chrono::duration<double,std::micro>( start - startTime ).count()
+			, std::chrono::duration<double,std::micro>( end - start ).count() };
+	if (buffer.events.size() < traceBufferSize) {
+		buffer.events.push_back( event );
+	} else {
+		// overwrite oldest event
+		buffer.events[ buffer.recorded % traceBufferSize ] = event;
+	}
+	buffer.recorded++;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+std::string
+Telemetry::
+getStageName( const Stage stage )
+{
+	if (stage < 0 || stage >= STAGE_NUMBER) {
+		throw std::runtime_error("Telemetry::getStageName() : unknown stage "+toString(stage));
+	}
+	return std::string(stageNames[stage]);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+std::vector< Telemetry::Sample >
+Telemetry::
+getSamples( const Stage stage )
+{
+	std::vector< Sample > stageSamples;
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_telemetryUpdate)
+#endif
+	{
+		for (size_t t=0; t<samples.size(); t++) {
+			stageSamples.insert( stageSamples.end(), samples[t][stage].begin(), samples[t][stage].end() );
+		}
+	} // omp critical(intarna_omp_telemetryUpdate)
+	return stageSamples;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+Telemetry::Summary
+Telemetry::
+getSummary( const std::vector< Sample > & samples )
+{
+	Summary sum = { samples.size(), 0, 0, 0, 0, 0, 0, 0, 0 };
+	if (samples.empty()) {
+		return sum;
+	}
+	// collect times
+	std::vector< double > times;
+	times.reserve( samples.size() );
+	for (auto s = samples.begin(); s != samples.end(); s++) {
+		times.push_back( s->seconds );
+		sum.total += s->seconds;
+		sum.cells += s->cells;
+	}
+	std::sort( times.begin(), times.end() );
+	// percentiles via nearest rank
+	sum.mean = sum.total / (double)times.size();
+	sum.p50 = times.at( (size_t)std::ceil( 0.50*times.size() ) -1 );
+	sum.p90 = times.at( (size_t)std::ceil( 0.90*times.size() ) -1 );
+	sum.p99 = times.at( (size_t)std::ceil( 0.99*times.size() ) -1 );
+	sum.max = *(times.rbegin());
+	sum.cellsPerSecond = sum.total > 0 ? ((double)sum.cells / sum.total) : 0;
+	return sum;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+size_t
+Telemetry::
+getPeakMemory()
+{
+#if INTARNA_HAVE_GETRUSAGE
+	struct rusage usage;
+	if (getrusage( RUSAGE_SELF, &usage ) == 0) {
+#if defined(__APPLE__)
+		// reported in bytes
+		return (size_t)usage.ru_maxrss / 1024;
+#else
+		// reported in kilobytes
+		return (size_t)usage.ru_maxrss;
+#endif
+	}
+#endif
+	return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+Telemetry::
+writeJson( std::ostream & out )
+{
+	const double runtime = std::chrono::duration<double>( std::chrono::steady_clock::now() - startTime ).count();
+	out <<"{\n"
+		<<"  \"runtime\": " <<runtime <<",\n"
+		<<"  \"peakMemoryKb\": " <<getPeakMemory() <<",\n";
+#if INTARNA_WORK_COUNTERS
+	out <<"  \"work\": {"
+		<<" \"complementaryCells\": " <<work.complementaryCells
+		<<", \"filledCells\": " <<work.filledCells
+		<<", \"loopEvaluations\": " <<work.loopEvaluations
+		<<", \"optimaUpdates\": " <<work.optimaUpdates
+		<<" },\n";
+#endif
+	out <<"  \"stages\": {\n";
+	for (int s = 0; s < STAGE_NUMBER; s++) {
+		const Summary sum = getSummary( getSamples( (Stage)s ) );
+		out <<"    \"" <<getStageName((Stage)s) <<"\": {"
+			<<" \"calls\": " <<sum.calls
+			<<", \"total\": " <<sum.total
+			<<", \"mean\": " <<sum.mean
+			<<", \"p50\": " <<sum.p50
+			<<", \"p90\": " <<sum.p90
+			<<", \"p99\": " <<sum.p99
+			<<", \"max\": " <<sum.max
+			<<", \"cells\": " <<sum.cells
+			<<", \"cellsPerSecond\": " <<sum.cellsPerSecond
+			<<" }" <<(s+1 < STAGE_NUMBER ? "," : "") <<'\n';
+	}
+	out <<"  },\n"
+		<<"  \"threads\": [\n";
+	// copy of samples for thread-wise output
+	std::vector< std::vector< std::vector< Sample > > > threadSamples;
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_telemetryUpdate)
+#endif
+	{
+		threadSamples = samples;
+	} // omp critical(intarna_omp_telemetryUpdate)
+	for (size_t t = 0; t < threadSamples.size(); t++) {
+		out <<"    { \"thread\": " <<t;
+		for (int s = 0; s < STAGE_NUMBER; s++) {
+			out <<", \"" <<getStageName((Stage)s) <<"\": " <<getSummary( threadSamples[t][s] ).total;
+		}
+		out <<" }" <<(t+1 < threadSamples.size() ? "," : "") <<'\n';
+	}
+	out <<"  ]\n"
+		<<"}\n";
+	out.flush();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+Telemetry::
+writeCsv( std::ostream & out )
+{
+	// copy of samples for thread-wise output
+	std::vector< std::vector< std::vector< Sample > > > threadSamples;
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_telemetryUpdate)
+#endif
+	{
+		threadSamples = samples;
+	} // omp critical(intarna_omp_telemetryUpdate)
+
+	out <<"stage;thread;calls;total;mean;p50;p90;p99;max;cells;cellsPerSecond\n";
+	for (int s = 0; s < STAGE_NUMBER; s++) {
+		// overall summary followed by the summary of each thread
+		for (size_t t = 0; t <= threadSamples.size(); t++) {
+			const Summary sum = getSummary( t == 0 ? getSamples( (Stage)s ) : threadSamples[t-1][s] );
+			out <<getStageName((Stage)s)
+				<<';' <<(t == 0 ? std::string("all") : toString(t-1))
+				<<';' <<sum.calls
+				<<';' <<sum.total
+				<<';' <<sum.mean
+				<<';' <<sum.p50
+				<<';' <<sum.p90
+				<<';' <<sum.p99
+				<<';' <<sum.max
+				<<';' <<sum.cells
+				<<';' <<sum.cellsPerSecond
+				<<'\n';
+		}
+	}
+	out.flush();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+Telemetry::
+writeJsonString( std::ostream & out, const std::string & str )
+{
+	out <<'"';
+	for (auto c = str.begin(); c != str.end(); c++) {
+		switch(*c) {
+		case '"' : out <<"\\\""; break;
+		case '\\' : out <<"\\\\"; break;
+		case '\n' : out <<"\\n"; break;
+		case '\t' : out <<"\\t"; break;
+		default :
+			if ((unsigned char)*c >= 0x20) {
+				out <<*c;
+			}
+		}
+	}
+	out <<'"';
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+Telemetry::
+writeTrace( std::ostream & out )
+{
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_telemetryUpdate)
+#endif
+	{
+		// microsecond precision of the time stamps
+		const std::ios_base::fmtflags flags = out.flags();
+		const std::streamsize precision = out.precision();
+		out <<std::fixed <<std::setprecision(3);
+		size_t dropped = 0;
+		bool first = true;
+		out <<"{\n"
+			<<"  \"traceEvents\": [\n";
+		for (auto b = traceBuffers.begin(); b != traceBuffers.end(); b++) {
+			// thread name
+			out <<(first ? "" : ",\n")
+				<<"    { \"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " <<b->thread
+				<<", \"args\": { \"name\": \"thread " <<b->thread <<"\" } }";
+			first = false;
+			dropped += b->recorded - b->events.size();
+			// events in recording order (oldest first if overwritten)
+			const size_t offset = b->recorded > b->events.size() ? (b->recorded % b->events.size()) : 0;
+			for (size_t i = 0; i < b->events.size(); i++) {
+				const TraceEvent & e = b->events.at( (offset+i) % b->events.size() );
+				out <<",\n    { \"name\": \"" <<e.name <<"\""
+					<<", \"cat\": \"" <<e.category <<"\""
+					<<", \"ph\": \"X\""
+					<<", \"ts\": " <<e.begin
+					<<", \"dur\": " <<e.duration
+					<<", \"pid\": 1"
+					<<", \"tid\": " <<b->thread;
+				if (!e.label.empty()) {
+					out <<", \"args\": { \"label\": ";
+					writeJsonString( out, e.label );
+					out <<" }";
+				}
+				out <<" }";
+			}
+		}
+		out <<(first ? "" : "\n") <<"  ],\n"
+			<<"  \"displayTimeUnit\": \"ms\",\n"
+			<<"  \"otherData\": { \"droppedEvents\": " <<dropped <<" }\n"
+			<<"}\n";
+		out.flags( flags );
+		out.precision( precision );
+	} // omp critical(intarna_omp_telemetryUpdate)
+	out.flush();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
@@ -0,0 +1,407 @@
+
+#ifndef INTARNA_TELEMETRY_H_
+#define INTARNA_TELEMETRY_H_
+
+#include "IntaRNA/general.h"
+#include "IntaRNA/WorkCounters.h"
+
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace IntaRNA {
+
+/**
+ * Collects runtime measurements for the computation stages of a run (e.g.
+ * accessibility computation or the hybridization matrix fill) and provides
+ * an aggregated summary in JSON or CSV format.
+ *
+ * Measurements are taken via Telemetry::Timer objects that measure the time
+ * of their scope. Nested timers (within the same thread) are subtracted from
+ * the enclosing timer, i.e. each stage gets the time spent exclusively for
+ * it. Each timer gives one sample that is recorded for the current thread.
+ *
+ * Furthermore, an execution trace can be recorded (see setTraceEnabled()),
+ * where each timer and each Span gives a begin/end event for the current
+ * thread. Events are stored in a ring buffer per thread without locking and
+ * written at the end of the run in the Chrome trace JSON format (see
+ * writeTrace()), which can be inspected via chrome://tracing or Perfetto.
+ *
+ * Telemetry is disabled by default, such that timers come without overhead.
+ *
+ * All static member functions are thread-safe.
+ *
+ */
+class Telemetry {
+
+public:
+
+	//! the measured computation stages
+	enum Stage {
+		ACCESSIBILITY = 0,	//!< accessibility computation
+		ES,					//!< ES value computation for the energy handling
+		SEED,				//!< seed matrix fill
+		HYBRID,				//!< hybridization matrix fill
+		TRACEBACK,			//!< traceback and reporting of interactions
+		OUTPUT,				//!< output formatting
+		STAGE_NUMBER		//!< number of stages (not a stage)
+	};
+
+	/**
+	 * Measures the time of its scope for a given stage. The time of nested
+	 * timers is excluded.
+	 */
+	class Timer {
+
+	public:
+
+		/**
+		 * Starts the measurement if telemetry is enabled.
+		 * @param stage the stage to be measured
+		 * @param cells the number of (matrix) cells computed within the stage
+		 */
+		Timer( const Stage stage, const size_t cells = 0 );
+
+		/**
+		 * Stops the measurement and records the sample.
+		 */
+		~Timer();
+
+		/**
+		 * Increases the number of cells computed within the stage.
+		 * @param cells the additional number of cells computed
+		 */
+		void
+		addCells( const size_t cells );
+
+	protected:
+
+		//! the measured stage
+		const Stage stage;
+		//! whether or not the timer is measuring
+		const bool active;
+		//! the number of cells computed
+		size_t cells;
+		//! the start of the measurement
+		std::chrono::steady_clock::time_point start;
+		//! the time spent within nested timers (in seconds)
+		double nestedTime;
+		//! the enclosing timer of the same thread or NULL
+		Timer * parent;
+
+	};
+
+	/**
+	 * Records a trace event for its scope, e.g. the processing of a
+	 * window combination, if tracing is enabled. In contrast to Timer, no
+	 * runtime sample is recorded.
+	 */
+	class Span {
+
+	public:
+
+		/**
+		 * Starts the event if tracing is enabled.
+		 * @param name the name of the event (has to be a string literal)
+		 * @param label additional information shown for the event
+		 *        (should only be generated if isTraceEnabled())
+		 */
+		Span( const char * name, const std::string & label = std::string() );
+
+		/**
+		 * Records the event.
+		 */
+		~Span();
+
+	protected:
+
+		//! the name of the event
+		const char * name;
+		//! the additional information for the event
+		const std::string label;
+		//! whether or not the event is recorded
+		const bool active;
+		//! the start of the event
+		std::chrono::steady_clock::time_point start;
+
+	};
+
+	/**
+	 * Enables or disables the collection of measurements.
+	 * @param enabled whether or not measurements are to be collected
+	 */
+	static
+	void
+	setEnabled( const bool enabled );
+
+	/**
+	 * Whether or not measurements are collected.
+	 * @return true if enabled; false otherwise
+	 */
+	static
+	bool
+	isEnabled();
+
+	/**
+	 * Enables or disables the recording of trace events.
+	 * @param enabled whether or not trace events are to be recorded
+	 * @param eventsPerThread the maximal number of events stored per thread;
+	 *        if exceeded, the oldest events are overwritten
+	 */
+	static
+	void
+	setTraceEnabled( const bool enabled, const size_t eventsPerThread = 65536 );
+
+	/**
+	 * Whether or not trace events are recorded.
+	 * @return true if enabled; false otherwise
+	 */
+	static
+	bool
+	isTraceEnabled();
+
+	/**
+	 * Records a sample for the current thread.
+	 * @param stage the measured stage
+	 * @param seconds the time spent within the stage
+	 * @param cells the number of cells computed within the stage
+	 */
+	static
+	void
+	add( const Stage stage, const double seconds, const size_t cells );
+
+	/**
+	 * Adds the DP work of a prediction or seed computation to the summary.
+	 * @param work the work counters to add
+	 */
+	static
+	void
+	addWork( const WorkCounters & work );
+
+	/**
+	 * Removes all recorded samples, work counts and trace events.
+	 */
+	static
+	void
+	clear();
+
+	/**
+	 * Provides the name of a stage.
+	 * @param stage the stage of interest
+	 * @return the name of the stage
+	 */
+	static
+	std::string
+	getStageName( const Stage stage );
+
+	/**
+	 * Provides the peak resident set size (memory) of the process so far.
+	 * @return the peak memory in kilobytes or 0 if not available
+	 */
+	static
+	size_t
+	getPeakMemory();
+
+	/**
+	 * Writes a JSON summary of all recorded samples, i.e. the overall
+	 * runtime and peak memory (see getPeakMemory()), for each stage the
+	 * number of samples, the total, mean, median, 90th and 99th percentile
+	 * and maximal time, the number of computed cells and cells per second,
+	 * as well as the total time of each stage for each thread. If work
+	 * counters are enabled at build time, the overall DP work is given too.
+	 * @param out the stream to write to
+	 */
+	static
+	void
+	writeJson( std::ostream & out );
+
+	/**
+	 * Writes a CSV summary (';'-separated) of all recorded samples, i.e. one
+	 * line for each stage over all threads (thread = 'all') and for each
+	 * stage and thread, with the same values as writeJson().
+	 * @param out the stream to write to
+	 */
+	static
+	void
+	writeCsv( std::ostream & out );
+
+	/**
+	 * Writes all recorded trace events in the Chrome trace JSON format, i.e.
+	 * one complete event (begin and duration in microseconds) per timer or
+	 * span with the thread number as thread id, the number of events that
+	 * were overwritten (droppedEvents) and the thread names.
+	 * @param out the stream to write to
+	 */
+	static
+	void
+	writeTrace( std::ostream & out );
+
+protected:
+
+	//! a single measurement
+	struct Sample {
+		//! the measured time in seconds
+		double seconds;
+		//! the number of computed cells
+		size_t cells;
+	};
+
+	//! aggregated values of a list of samples
+	struct Summary {
+		//! number of samples
+		size_t calls;
+		//! total time
+		double total;
+		//! mean time
+		double mean;
+		//! median time
+		double p50;
+		//! 90th percentile of the time
+		double p90;
+		//! 99th percentile of the time
+		double p99;
+		//! maximal time
+		double max;
+		//! total number of cells
+		size_t cells;
+		//! cells per second
+		double cellsPerSecond;
+	};
+
+	//! a trace event
+	struct TraceEvent {
+		//! the name of the event
+		const char * name;
+		//! the category of the event
+		const char * category;
+		//! the additional information of the event
+		std::string label;
+		//! the begin (in microseconds since the start of the measurements)
+		double begin;
+		//! the duration in microseconds
+		double duration;
+	};
+
+	//! the ring buffer of trace events of a thread
+	struct TraceBuffer {
+		//! the number of the thread
+		size_t thread;
+		//! the stored events
+		std::vector< TraceEvent > events;
+		//! the number of events recorded so far
+		size_t recorded;
+	};
+
+	//! whether or not measurements are collected
+	static bool enabled;
+
+	//! whether or not trace events are recorded
+	static bool traceEnabled;
+
+	//! the maximal number of trace events stored per thread
+	static size_t traceBufferSize;
+
+	//! the trace buffers of all threads (deque to keep the buffers in place)
+	static std::deque< TraceBuffer > traceBuffers;
+
+	//! the recorded samples for each thread and stage
+	static std::vector< std::vector< std::vector< Sample > > > samples;
+
+	//! the start of the measurements
+	static std::chrono::steady_clock::time_point startTime;
+
+	//! the overall DP work (see addWork())
+	static WorkCounters work;
+
+	/**
+	 * Aggregates a list of samples.
+	 * @param samples the samples to aggregate
+	 * @return the summary of the samples
+	 */
+	static
+	Summary
+	getSummary( const std::vector< Sample > & samples );
+
+	/**
+	 * Provides the samples of a stage for all threads.
+	 * @param stage the stage of interest
+	 * @return the samples of all threads
+	 */
+	static
+	std::vector< Sample >
+	getSamples( const Stage stage );
+
+	/**
+	 * Provides the current thread's number.
+	 * @return the thread number (0 if no multi-threading)
+	 */
+	static
+	size_t
+	getThreadNumber();
+
+	/**
+	 * Records a trace event in the buffer of the current thread.
+	 * @param name the name of the event
+	 * @param category the category of the event
+	 * @param label the additional information of the event
+	 * @param start the begin of the event
+	 * @param end the end of the event
+	 */
+	static
+	void
+	addTraceEvent( const char * name
+				, const char * category
+				, const std::string & label
+				, const std::chrono::steady_clock::time_point & start
+				, const std::chrono::steady_clock::time_point & end );
+
+	/**
+	 * Writes a string with JSON escaping.
+	 * @param out the stream to write to
+	 * @param str the string to write
+	 */
+	static
+	void
+	writeJsonString( std::ostream & out, const std::string & str );
+
+};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+Telemetry::
+isEnabled()
+{
+	return enabled;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+Telemetry::
+isTraceEnabled()
+{
+	return traceEnabled;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+void
+Telemetry::Timer::
+addCells( const size_t cells )
+{
+	this->cells += cells;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_TELEMETRY_H_ */
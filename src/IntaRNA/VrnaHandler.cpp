@@ -8,28 +8,57 @@
 #include "IntaRNA/VrnaHandler.h"
 #include "IntaRNA/general.h"
 
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 
 extern "C" {
 	#include <ViennaRNA/energy_const.h>
 	#include <ViennaRNA/read_epars.h>
+	#include <ViennaRNA/vrna_config.h>
 }
 
+#define _STRINGIFY(s) #s
+#define STRINGIFY(s) _STRINGIFY(s)
+
 namespace IntaRNA {
 
 ////////////////////////////////////////////////////////////////////////////
 
+//! identifier at the beginning of each parameter cache entry file
+static const std::string vrnaParamCacheHeader = "IntaRNA-VRNA-param-cache-1\n";
+
+////////////////////////////////////////////////////////////////////////////
+
 VrnaHandler::
-VrnaHandler( double temperature, const std::string * const vrnaParamFile )
+VrnaHandler( double temperature
+		, const std::string * const vrnaParamFile
+		, const std::string * const vrnaParamCacheDir )
 	:
 	model()
 	, RT(getRT(temperature))
+	, paramFile( vrnaParamFile == NULL ? "" : *vrnaParamFile )
+	, paramCacheDir( vrnaParamCacheDir == NULL ? "" : *vrnaParamCacheDir )
+	, paramFileContent("")
+	, paramCache( paramCacheDir, vrnaParamCacheHeader, ".vrna", "VRNA parameter cache" )
+	, paramsRegistry()
+	, expParamsRegistry()
 {
 
 	// init parameters from file if needed
 	if (vrnaParamFile != NULL) {
 		// read parameters from file
 		read_parameter_file( vrnaParamFile->c_str() );
+		// the cached parameter sets depend on the file's content
+		if (!paramCacheDir.empty()) {
+			try {
+				paramFileContent = KeyedFileStore::getFileContent( paramFile );
+			} catch (std::runtime_error & e) {
+				throw std::runtime_error("VrnaHandler : could not read parameter file '"+paramFile+"'");
+			}
+		}
 	}
 
 
@@ -115,6 +144,163 @@ getModel( int max_bp_span, int window_size ) const
 
 ////////////////////////////////////////////////////////////////////////////
 
+std::string
+VrnaHandler::
+getModelKey( const vrna_md_t & model )
+{
+	std::stringstream key;
+	key <<std::setprecision(10)
+		<<"temperature=" <<model.temperature
+		<<" betaScale=" <<model.betaScale
+		<<" dangles=" <<model.dangles
+		<<" special_hp=" <<model.special_hp
+		<<" noLP=" <<model.noLP
+		<<" noGU=" <<model.noGU
+		<<" noGUclosure=" <<model.noGUclosure
+		<<" logML=" <<model.logML
+		<<" circ=" <<model.circ
+		<<" gquad=" <<model.gquad
+		<<" energy_set=" <<model.energy_set
+		<<" max_bp_span=" <<model.max_bp_span
+		<<" min_loop_size=" <<model.min_loop_size
+		<<" window_size=" <<model.window_size
+		<<" sfact=" <<model.sfact;
+	return key.str();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+std::shared_ptr<vrna_param_t>
+VrnaHandler::
+getParams( int max_bp_span, int window_size ) const
+{
+	vrna_md_t subModel = getModel( max_bp_span, window_size );
+	const std::string key = getModelKey( subModel );
+
+	std::shared_ptr<vrna_param_t> params;
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_vrnaParams)
+#endif
+	{
+		std::shared_ptr<vrna_param_t> & registered = paramsRegistry[key];
+		// generate parameters if not available yet
+		if (!registered) {
+			// check on-disk cache first
+			const std::string cacheKey = paramCacheDir.empty() ? "" : getParamCacheKey( "params " + key, sizeof(vrna_param_t) );
+			if (!cacheKey.empty()) {
+				registered.reset( static_cast<vrna_param_t*>(readParamCache( cacheKey, sizeof(vrna_param_t) )), std::free );
+			}
+			if (!registered) {
+				registered.reset( vrna_params( &subModel ), std::free );
+				if (!cacheKey.empty()) {
+					writeParamCache( cacheKey, registered.get(), sizeof(vrna_param_t) );
+				}
+			}
+		}
+		params = registered;
+	}
+	return params;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+std::shared_ptr<vrna_exp_param_t>
+VrnaHandler::
+getExpParams( int max_bp_span, int window_size, double pfScale ) const
+{
+	vrna_md_t subModel = getModel( max_bp_span, window_size );
+	std::stringstream key;
+	key <<getModelKey( subModel ) <<" pfScale=" <<std::setprecision(17) <<pfScale;
+
+	std::shared_ptr<vrna_exp_param_t> params;
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_vrnaParams)
+#endif
+	{
+		std::shared_ptr<vrna_exp_param_t> & registered = expParamsRegistry[key.str()];
+		// generate parameters if not available yet
+		if (!registered) {
+			// check on-disk cache first
+			const std::string cacheKey = paramCacheDir.empty() ? "" : getParamCacheKey( "expParams " + key.str(), sizeof(vrna_exp_param_t) );
+			if (!cacheKey.empty()) {
+				registered.reset( static_cast<vrna_exp_param_t*>(readParamCache( cacheKey, sizeof(vrna_exp_param_t) )), std::free );
+			}
+			if (!registered) {
+				registered.reset( get_boltzmann_factors( subModel.temperature, subModel.betaScale, subModel, pfScale ), std::free );
+				if (!cacheKey.empty()) {
+					writeParamCache( cacheKey, registered.get(), sizeof(vrna_exp_param_t) );
+				}
+			}
+		}
+		params = registered;
+	}
+	return params;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+std::string
+VrnaHandler::
+getParamCacheKey( const std::string & setupKey, const size_t paramSize ) const
+{
+	std::stringstream key;
+	key <<"vrna=" <<STRINGIFY(VRNA_VERSION)
+		<<"\nsetup=" <<setupKey
+		<<"\nsize=" <<paramSize
+		<<"\nparameters=" <<paramFileContent
+		<<'\n';
+	return key.str();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void *
+VrnaHandler::
+readParamCache( const std::string & cacheKey, const size_t paramSize ) const
+{
+	std::ifstream in;
+	if (!paramCache.open( cacheKey, in )) {
+		return NULL;
+	}
+	const std::string fileName = paramCache.getFileName( cacheKey );
+
+	// read raw parameter set in one go
+	void * params = std::malloc( paramSize );
+	if (params == NULL) {
+		return NULL;
+	}
+	in.read( static_cast<char*>(params), paramSize );
+	if ((size_t)in.gcount() != paramSize) {
+		std::free( params );
+#if INTARNA_MULITHREADING
+			#pragma omp critical(intarna_omp_logOutput)
+#endif
+		{ VLOG(2) <<"VRNA parameter cache : ignoring incomplete entry "<<fileName; }
+		return NULL;
+	}
+
+#if INTARNA_MULITHREADING
+		#pragma omp critical(intarna_omp_logOutput)
+#endif
+	{ VLOG(2) <<"VRNA parameter cache : read parameters from "<<fileName; }
+	return params;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+VrnaHandler::
+writeParamCache( const std::string & cacheKey, const void * params, const size_t paramSize ) const
+{
+	if (params == NULL) {
+		return;
+	}
+	// raw parameter set
+	paramCache.write( cacheKey, KeyedFileStore::DataBlocks( 1, std::make_pair( static_cast<const char*>(params), paramSize ) ) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 double
 VrnaHandler::
 getRT( const double temperature )
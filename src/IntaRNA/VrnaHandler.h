@@ -2,6 +2,10 @@
 #define VIENNAHANDLER_H_
 
 #include "IntaRNA/general.h"
+#include "IntaRNA/KeyedFileStore.h"
+
+#include <map>
+#include <memory>
 #include <string>
 
 extern "C" {
@@ -27,6 +31,69 @@ protected:
 	//! the RT constant used for the current setup
 	E_type RT;
 
+	//! the VRNA parameter file used for the setup or empty for defaults
+	std::string paramFile;
+
+	//! the directory of the on-disk parameter cache or empty if not used
+	std::string paramCacheDir;
+
+	//! the content of the VRNA parameter file (part of the cache keys)
+	std::string paramFileContent;
+
+	//! the on-disk parameter cache (used only if paramCacheDir is not empty)
+	KeyedFileStore paramCache;
+
+	//! the energy parameter sets generated so far, indexed by model setup
+	mutable std::map< std::string, std::shared_ptr<vrna_param_t> > paramsRegistry;
+
+	//! the Boltzmann factor sets generated so far, indexed by model setup
+	//! and partition function scaling
+	mutable std::map< std::string, std::shared_ptr<vrna_exp_param_t> > expParamsRegistry;
+
+	/**
+	 * Provides a description of all model details that affect the VRNA
+	 * parameter sets, to be used as registry index.
+	 * @param model the model to describe
+	 * @return the model description
+	 */
+	static
+	std::string
+	getModelKey( const vrna_md_t & model );
+
+	/**
+	 * Generates the key of a parameter cache entry, i.e. a description of
+	 * the VRNA version, the parameter file content, the model setup and the
+	 * memory layout of the parameter set.
+	 *
+	 * @param setupKey the registry index of the parameter set
+	 * @param paramSize the size of the parameter set structure
+	 * @return the key of the cache entry
+	 */
+	std::string
+	getParamCacheKey( const std::string & setupKey, const size_t paramSize ) const;
+
+	/**
+	 * Reads a parameter set from the on-disk parameter cache if available.
+	 *
+	 * @param cacheKey the key of the cache entry (see getParamCacheKey())
+	 * @param paramSize the size of the parameter set structure
+	 * @return the parameter set allocated via std::malloc() or NULL if no
+	 *         valid entry is available
+	 */
+	void *
+	readParamCache( const std::string & cacheKey, const size_t paramSize ) const;
+
+	/**
+	 * Stores a parameter set in the on-disk parameter cache. Write failures
+	 * are logged but otherwise ignored, since the cache is not mandatory.
+	 *
+	 * @param cacheKey the key of the cache entry (see getParamCacheKey())
+	 * @param params the parameter set to store
+	 * @param paramSize the size of the parameter set structure
+	 */
+	void
+	writeParamCache( const std::string & cacheKey, const void * params, const size_t paramSize ) const;
+
 public:
 
 	/**
@@ -35,10 +102,18 @@ public:
 	 * @param temperature Folding temperature in Celsius
 	 * @param vrnaParamFile name of a VRNA parameter file to be used for
 	 *        parameter setup or NULL if defaults are to be used
+	 * @param vrnaParamCacheDir name of an (existing) directory where the
+	 *        generated energy parameters and Boltzmann factors are stored in
+	 *        binary format to be reused by later runs, or NULL if no caching
+	 *        is to be done
+	 *
+	 * @throw std::runtime_error if the parameter file can not be read for
+	 *        caching
 	 */
 	VrnaHandler(
 			double temperature = 37.0,
-			const std::string * const vrnaParamFile = NULL );
+			const std::string * const vrnaParamFile = NULL,
+			const std::string * const vrnaParamCacheDir = NULL );
 
 	/**
 	 * destruction
@@ -60,6 +135,42 @@ public:
 	vrna_md_t
 	getModel( int max_bp_span = -1, int window_size = -1 ) const;
 
+	/**
+	 * Provides the VRNA energy parameters for the model according to the
+	 * global and local settings (see getModel()). The parameter set is
+	 * generated only once per setup and shared among all callers, such that
+	 * it must not be altered. Access is thread-safe. If a parameter cache
+	 * is used, the set is read from the cache if available and stored
+	 * otherwise.
+	 *
+	 * @param max_bp_span Maximal distance between base pair partners within one RNA
+	 * 				or -1 if no constraint needed
+	 * @param window_size Size of the sliding window for locally folding within one RNA
+	 * 				or -1 if no constraint needed
+	 * @return the (shared) energy parameters
+	 */
+	std::shared_ptr<vrna_param_t>
+	getParams( int max_bp_span = -1, int window_size = -1 ) const;
+
+	/**
+	 * Provides the VRNA Boltzmann factors for the model according to the
+	 * global and local settings (see getModel()). The parameter set is
+	 * generated only once per setup and shared among all callers, such that
+	 * it must not be altered. Access is thread-safe. If a parameter cache
+	 * is used, the set is read from the cache if available and stored
+	 * otherwise.
+	 *
+	 * @param max_bp_span Maximal distance between base pair partners within one RNA
+	 * 				or -1 if no constraint needed
+	 * @param window_size Size of the sliding window for locally folding within one RNA
+	 * 				or -1 if no constraint needed
+	 * @param pfScale the scaling factor to avoid overflows in partition
+	 *              function computations
+	 * @return the (shared) Boltzmann factors
+	 */
+	std::shared_ptr<vrna_exp_param_t>
+	getExpParams( int max_bp_span, int window_size, double pfScale ) const;
+
 	/**
 	 * Provides RT for the current setup
 	 * @return R*temperature
@@ -75,6 +186,26 @@ public:
 	double
 	getRT( const double temperature );
 
+	/**
+	 * Provides the folding temperature of the current setup
+	 * @return the temperature in Celsius
+	 */
+	double
+	getTemperature() const;
+
+	/**
+	 * Provides the VRNA parameter file used for the current setup
+	 * @return the file name or an empty string if defaults are used
+	 */
+	const std::string &
+	getParamFile() const;
+
+	/**
+	 * Provides the directory of the on-disk parameter cache
+	 * @return the directory or an empty string if no caching is done
+	 */
+	const std::string &
+	getParamCacheDir() const;
 
 
 };
@@ -93,6 +224,36 @@ getRT() const
 
 ////////////////////////////////////////////////////////////////////////////
 
+inline
+double
+VrnaHandler::
+getTemperature() const
+{
+	return model.temperature;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+const std::string &
+VrnaHandler::
+getParamFile() const
+{
+	return paramFile;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+const std::string &
+VrnaHandler::
+getParamCacheDir() const
+{
+	return paramCacheDir;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 } // namespace
 
 #endif /* VIENNAHANDLER_H_ */
@@ -0,0 +1,156 @@
+
+#ifndef INTARNA_WORKCOUNTERS_H_
+#define INTARNA_WORKCOUNTERS_H_
+
+#include "IntaRNA/general.h"
+
+#include <iostream>
+
+/**
+ * Executes the given (counting) statement only if work counters are enabled
+ * at build time (configure --enable-work-counters), i.e. all counting is
+ * removed at compile time otherwise.
+ */
+#if INTARNA_WORK_COUNTERS
+	#define INTARNA_COUNT_WORK( statement ) statement
+#else
+	#define INTARNA_COUNT_WORK( statement )
+#endif
+
+namespace IntaRNA {
+
+/**
+ * Counters of the dynamic programming work done by a prediction or seed
+ * computation, to compare prediction modes and loop length restrictions.
+ *
+ * Counting is done via INTARNA_COUNT_WORK() only, such that the counters
+ * stay zero if not enabled at build time.
+ */
+class WorkCounters {
+
+public:
+
+	//! number of DP cells with complementary left boundary
+	size_t complementaryCells;
+	//! number of DP cells computed via the recursion (not pruned)
+	size_t filledCells;
+	//! number of loop energy evaluations (getE_interLeft() calls)
+	size_t loopEvaluations;
+	//! number of updates of the stored (sub)optimal results
+	size_t optimaUpdates;
+
+	/**
+	 * Construction with all counters zero
+	 */
+	WorkCounters();
+
+	/**
+	 * Sets all counters to zero
+	 */
+	void
+	clear();
+
+	/**
+	 * Whether or not all counters are zero
+	 * @return true if nothing was counted; false otherwise
+	 */
+	bool
+	empty() const;
+
+	/**
+	 * Adds the counters of another object (thread-safe).
+	 * @param other the counters to add
+	 */
+	void
+	add( const WorkCounters & other );
+
+	/**
+	 * Prints the counters to stream
+	 * @param out the ostream to write to
+	 * @param c the counters to add
+	 * @return the altered stream out
+	 */
+	friend std::ostream& operator<<(std::ostream& out, const WorkCounters& c);
+
+};
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+inline
+WorkCounters::
+WorkCounters()
+ :	complementaryCells(0)
+	, filledCells(0)
+	, loopEvaluations(0)
+	, optimaUpdates(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+void
+WorkCounters::
+clear()
+{
+	complementaryCells = 0;
+	filledCells = 0;
+	loopEvaluations = 0;
+	optimaUpdates = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+WorkCounters::
+empty() const
+{
+	return complementaryCells == 0 && filledCells == 0 && loopEvaluations == 0 && optimaUpdates == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+void
+WorkCounters::
+add( const WorkCounters & other )
+{
+#if INTARNA_MULITHREADING
+	#pragma omp atomic
+#endif
+	complementaryCells += other.complementaryCells;
+#if INTARNA_MULITHREADING
+	#pragma omp atomic
+#endif
+	filledCells += other.filledCells;
+#if INTARNA_MULITHREADING
+	#pragma omp atomic
+#endif
+	loopEvaluations += other.loopEvaluations;
+#if INTARNA_MULITHREADING
+	#pragma omp atomic
+#endif
+	optimaUpdates += other.optimaUpdates;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+std::ostream&
+operator<<(std::ostream& out, const WorkCounters& c)
+{
+	out <<"complementaryCells="<<c.complementaryCells
+		<<" filledCells="<<c.filledCells
+		<<" loopEvaluations="<<c.loopEvaluations
+		<<" optimaUpdates="<<c.optimaUpdates;
+	return out;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_WORKCOUNTERS_H_ */
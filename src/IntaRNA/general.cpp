@@ -1,5 +1,7 @@
 
 #include "IntaRNA/general.h"
+#include "IntaRNA/AsyncOutputStream.h"
+#include "IntaRNA/CompressedOutputStream.h"
 
 #include <fstream>
 
@@ -25,6 +27,19 @@ newOutputStream( const std::string & out )
 	if (boost::iequals(out,"STDERR")) {
 		return & std::cerr;
 	} else {
+		// check for compressed output
+		CompressedOutputBuffer::Format format;
+		if (CompressedOutputBuffer::getFormat( out, format )) {
+			if (!CompressedOutputBuffer::isSupported( format )) {
+				return NULL;
+			}
+			CompressedOutputStream * outCompressed = new CompressedOutputStream( out, format );
+			if (!outCompressed->is_open()) {
+				delete outCompressed;
+				return NULL;
+			}
+			return outCompressed;
+		}
 		// open file stream
 		std::fstream * outFileStream = new std::fstream();
 		outFileStream->open( out.c_str(), std::ios_base::out );
@@ -47,6 +62,21 @@ deleteOutputStream( std::ostream * outStream )
 	if (outStream == NULL) {
 		return;
 	}
+
+	// asynchronous streams write pending output and delete their sink
+	AsyncOutputStream * asyncOut = dynamic_cast<AsyncOutputStream *>(outStream);
+	if (asyncOut != NULL) {
+		INTARNA_CLEANUP(asyncOut);
+		return;
+	}
+
+	// compressed streams finish compression and close their file
+	CompressedOutputStream * compressedOut = dynamic_cast<CompressedOutputStream *>(outStream);
+	if (compressedOut != NULL) {
+		INTARNA_CLEANUP(compressedOut);
+		return;
+	}
+
 	// flush content
 	outStream->flush();
 
@@ -66,12 +66,18 @@
 ////////////////  GLOBAL TYPEDEFS  //////////////////////
 
 #include <cmath>
+#include <cstdint>
 
 namespace IntaRNA {
 
 	//! type for energy values (energy + accessibility [ED])
 	typedef float E_type;
 
+	//! integer type for fixed-point energy values in units of
+	//! 1/E_fixed_scale kcal/mol, i.e. the dcal/mol resolution of the VRNA
+	//! energy parameters
+	typedef int32_t E_fixed_type;
+
 	//! type for temperature values
 	typedef E_type T_type;
 
@@ -114,12 +120,64 @@ namespace IntaRNA {
 
 ////////////////  GLOBAL CONSTANTS  /////////////////////
 
+#include <algorithm>
 #include <limits>
 
 namespace IntaRNA {
 
 	const E_type E_INF = std::numeric_limits<E_type>::infinity();
 
+	//! number of fixed-point energy units per kcal/mol
+	const E_fixed_type E_fixed_scale = 100;
+
+	//! fixed-point representation of E_INF; chosen such that the sum of two
+	//! non-infinite fixed-point energies can not overflow
+	const E_fixed_type E_fixed_INF = std::numeric_limits<E_fixed_type>::max() / 2;
+
+	/**
+	 * Converts an energy into its fixed-point representation, i.e. rounds it
+	 * to the resolution of E_fixed_scale.
+	 * @param e the energy to convert
+	 * @return the (rounded) fixed-point energy or E_fixed_INF if e exceeds
+	 *         the fixed-point range
+	 */
+	inline
+	E_fixed_type
+	E_toFixed( const E_type e )
+	{
+		const double scaled = std::floor( (double)e * (double)E_fixed_scale + 0.5 );
+		return scaled < (double)E_fixed_INF
+				? ( scaled > -(double)E_fixed_INF ? (E_fixed_type)scaled : -E_fixed_INF )
+				: E_fixed_INF;
+	}
+
+	/**
+	 * Converts a fixed-point energy into the according energy.
+	 * @param e the fixed-point energy to convert
+	 * @return the according energy or E_INF if e is E_fixed_INF
+	 */
+	inline
+	E_type
+	E_fromFixed( const E_fixed_type e )
+	{
+		return e < E_fixed_INF ? (E_type)e / (E_type)E_fixed_scale : E_INF;
+	}
+
+	/**
+	 * Sums two fixed-point energies, saturating at E_fixed_INF.
+	 * @param e1 the first fixed-point energy
+	 * @param e2 the second fixed-point energy
+	 * @return the sum or E_fixed_INF if any summand or the sum is E_fixed_INF
+	 */
+	inline
+	E_fixed_type
+	E_fixed_add( const E_fixed_type e1, const E_fixed_type e2 )
+	{
+		return (e1 < E_fixed_INF && e2 < E_fixed_INF)
+				? std::min( e1+e2, E_fixed_INF )
+				: E_fixed_INF;
+	}
+
 } // namespace
 
 
@@ -135,6 +193,8 @@ namespace IntaRNA {
  *
  * - & std::cout : if outName == STDOUT
  * - & std::cerr : if outName == STDERR
+ * - new CompressedOutputStream( outName ) : if outName ends with '.gz'
+ *   or '.zst' (NULL if the format is not supported by this build)
  * - new std::fstream( outName ) : else if outName non-empty
  *
  * @param outName the name of the output to open. use STDOUT/STDERR for the
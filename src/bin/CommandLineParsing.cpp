@@ -3,9 +3,14 @@
 
 #include "IntaRNA/general.h"
 
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
 #include <fstream>
+#include <functional>
+#include <map>
+#include <set>
+#include <sstream>
 
 #if INTARNA_MULITHREADING
 	#include <omp.h>
@@ -33,6 +38,9 @@ extern "C" {
 #include "IntaRNA/AccessibilityFromStream.h"
 #include "IntaRNA/AccessibilityVrna.h"
 #include "IntaRNA/AccessibilityBasePair.h"
+#include "IntaRNA/AsyncOutputStream.h"
+#include "IntaRNA/EdBandMatrix.h"
+#include "IntaRNA/FastaReader.h"
 
 #include "IntaRNA/InteractionEnergyBasePair.h"
 #include "IntaRNA/InteractionEnergyVrna.h"
@@ -41,10 +49,13 @@ extern "C" {
 #include "IntaRNA/PredictorMfe2d.h"
 #include "IntaRNA/PredictorMfe4d.h"
 #include "IntaRNA/PredictorMaxProb.h"
+#include "IntaRNA/PredictorMaxProbSeed.h"
 
 #include "IntaRNA/PredictorMfe2dHeuristicSeed.h"
+#include "IntaRNA/PredictorMfe2dHeuristicSeedSparse.h"
 #include "IntaRNA/PredictorMfe2dSeed.h"
 #include "IntaRNA/PredictorMfe4dSeed.h"
+#include "IntaRNA/PredictorTransposed.h"
 
 #include "IntaRNA/PredictionTracker.h"
 #include "IntaRNA/PredictionTrackerHub.h"
@@ -54,9 +65,13 @@ extern "C" {
 #include "IntaRNA/PredictionTrackerProfileSpotProb.h"
 
 #include "IntaRNA/SeedHandlerMfe.h"
+#include "IntaRNA/SeedHandlerCached.h"
+#include "IntaRNA/Telemetry.h"
 
+#include "IntaRNA/OutputHandlerBinary.h"
 #include "IntaRNA/OutputHandlerCsv.h"
 #include "IntaRNA/OutputHandlerIntaRNA1.h"
+#include "IntaRNA/OutputHandlerInteractionList.h"
 #include "IntaRNA/OutputHandlerText.h"
 
 
@@ -88,7 +103,7 @@ CommandLineParsing::CommandLineParsing()
 	query(),
 	qSet(),
 	qSetString(""),
-	qAcc("NCPE",'C'),
+	qAcc("NCPEB",'C'),
 	qAccW( 0, 99999, 150),
 	qAccL( 0, 99999, 100),
 	qAccConstr(""),
@@ -106,7 +121,14 @@ CommandLineParsing::CommandLineParsing()
 	target(),
 	tSet(),
 	tSetString(""),
-	tAcc("NCPE",'C'),
+	tBatchSize( 0, 999999, 0),
+	targetStream(NULL),
+	targetStreamRecords(0),
+	targetBatchOffset(0),
+	tShardCount( 1, 99999, 1),
+	tShardIndex( 1, 99999, 1),
+	tShardTargets(),
+	tAcc("NCPEB",'C'),
 	tAccW( 0, 99999, 150),
 	tAccL( 0, 99999, 100),
 	tAccConstr(""),
@@ -115,6 +137,7 @@ CommandLineParsing::CommandLineParsing()
 	tIntLoopMax( 0, 30, 16),
 	tRegionString(""),
 	tRegion(),
+	tVariantsString(""),
 	tRegionLenMax( 0, 99999, 0),
 	tShape(""),
 	tShapeMethod("Zb0.89"),
@@ -130,25 +153,40 @@ CommandLineParsing::CommandLineParsing()
 	seedMinPu(0,1,0),
 	seedQRange(""),
 	seedTRange(""),
+	seedPrefilter(false),
 	seedConstraint(NULL),
 
 	temperature(0,100,37),
 
 	pred( "SP", 'S'),
-	predMode( "HME", 'H'),
+	predMode( "HMEA", 'H'),
+	pruning(false),
+	storeTrace(false),
 #if INTARNA_MULITHREADING
 	threads( 0, omp_get_max_threads(), 1),
+	tAccBuffer( 0, 99999, 0),
+	outOrderBuffer( 0, 999999, 1000),
 #endif
 	windowWidth(0,99999,0),
 	windowOverlap(0,99999,0),
+	memLimit(0,9999999,0),
+	timeBudget(0.0,999999.0,0.0),
+	windowSliding(false),
+	windowAuto(false),
+	bestFirst(false),
+	selfInteraction(false),
+	fuseSites(false),
+	cascadeRatio(0.0,1.0,1.0),
+	cascadeDeltaE(0.0,100.0,100.0),
 
 	energy("BV",'V'),
 	energyFile(""),
+	energyCacheDir(""),
 
 	out(),
 	outPrefix2streamName(),
 	outStream(&(std::cout)),
-	outMode( "NDC1O", 'N' ),
+	outMode( "NDCB1O", 'N' ),
 	outNumber( 0, 1000, 1),
 	outOverlap( "NTQB", 'Q' ),
 	outDeltaE( 0.0, 100.0, 100.0),
@@ -156,10 +194,32 @@ CommandLineParsing::CommandLineParsing()
 	outMinPu( 0.0, 1.0, 0.0),
 	outCsvCols(outCsvCols_default),
 	outPerRegion(false),
+	outPartial(false),
+	outTopK( 0, 9999999, 0),
 	outSpotProbSpots(""),
 
 	logFileName(""),
 
+	serverMode(false),
+	serverCache( 0, 99999, 100),
+	requestNumber(0),
+	sweepFile(""),
+	sweepSets(),
+	sweepBase(""),
+
+	checkpointFile(""),
+	resume(false),
+	checkpoint(NULL),
+
+	accCacheDir(""),
+	accCache(NULL),
+	accCacheMap(false),
+	resultStoreDir(""),
+	resultStore(NULL),
+	resultParameters(""),
+	accLowMem(false),
+	dryRun(false),
+
 	vrnaHandler()
 
 {
@@ -179,7 +239,6 @@ CommandLineParsing::CommandLineParsing()
 	opts_query.add_options()
 		("query,q"
 			, value<std::string>(&queryArg)
-				->required()
 				->notifier(boost::bind(&CommandLineParsing::validate_query,this,_1))
 			, "either an RNA sequence or the stream/file name from where to read the query sequences (should be the shorter sequences to increase efficiency); use 'STDIN' to read from standard input stream; sequences have to use IUPAC nucleotide encoding")
 		("qAcc"
@@ -191,6 +250,7 @@ CommandLineParsing::CommandLineParsing()
 					"\n 'C' computation of accessibilities"
 					"\n 'P' unpaired probabilities in RNAplfold format from --qAccFile"
 					"\n 'E' ED values in RNAplfold Pu-like format from --qAccFile"
+					"\n 'B' ED values in binary format (see --out=qAccBin:) from --qAccFile"
 					).c_str())
 		("qAccW"
 			, value<int>(&(qAccW.val))
@@ -274,7 +334,6 @@ CommandLineParsing::CommandLineParsing()
 	opts_target.add_options()
 		("target,t"
 			, value<std::string>(&targetArg)
-				->required()
 				->notifier(boost::bind(&CommandLineParsing::validate_target,this,_1))
 				, "either an RNA sequence or the stream/file name from where to read the target sequences (should be the longer sequences to increase efficiency); use 'STDIN' to read from standard input stream; sequences have to use IUPAC nucleotide encoding")
 		("tAcc"
@@ -286,6 +345,7 @@ CommandLineParsing::CommandLineParsing()
 					"\n 'C' computation of accessibilities"
 					"\n 'P' unpaired probabilities in RNAplfold format from --tAccFile"
 					"\n 'E' ED values in RNAplfold Pu-like format from --tAccFile"
+					"\n 'B' ED values in binary format (see --out=tAccBin:) from --tAccFile"
 					).c_str())
 		("tAccW"
 			, value<int>(&(tAccW.val))
@@ -309,6 +369,28 @@ CommandLineParsing::CommandLineParsing()
 			, value<std::string>(&(tSetString))
 				->notifier(boost::bind(&CommandLineParsing::validate_tSet,this,_1))
 			, std::string("target subset : List of sequence indices to consider for prediction in the format 'from1-to1,from2-to2,..' assuming indexing starts with 1").c_str())
+		("tBatchSize"
+			, value<int>(&(tBatchSize.val))
+				->default_value(tBatchSize.def)
+				->notifier(boost::bind(&CommandLineParsing::validate_tBatchSize,this,_1))
+			, std::string("target input : maximal number of target sequences read (and held in memory) at once from FASTA input."
+					" Targets are read and processed batch-wise, which enables the screening of huge target sets with bounded memory."
+					" If 0, all targets are read at once."
+					" (arg in range ["+toString(tBatchSize.min)+","+toString(tBatchSize.max)+"])").c_str())
+		("tShardCount"
+			, value<int>(&(tShardCount.val))
+				->default_value(tShardCount.def)
+				->notifier(boost::bind(&CommandLineParsing::validate_tShardCount,this,_1))
+			, std::string("target input : number of shards the target sequences are distributed to, e.g. for distributed computation on multiple nodes."
+					" Targets are assigned to the shards such that the estimated computational cost (sequence length product) is balanced."
+					" Only the targets of shard --tShardIndex are processed."
+					" (arg in range ["+toString(tShardCount.min)+","+toString(tShardCount.max)+"])").c_str())
+		("tShardIndex"
+			, value<int>(&(tShardIndex.val))
+				->default_value(tShardIndex.def)
+				->notifier(boost::bind(&CommandLineParsing::validate_tShardIndex,this,_1))
+			, std::string("target input : index of the shard of target sequences to be processed (see --tShardCount)."
+					" (arg in range ["+toString(tShardIndex.min)+","+toString(tShardIndex.max)+"])").c_str())
 		("tAccConstr"
 			, value<std::string>(&(tAccConstr))
 				->notifier(boost::bind(&CommandLineParsing::validate_tAccConstr,this,_1))
@@ -362,6 +444,16 @@ CommandLineParsing::CommandLineParsing()
 					" (arg in range ["+toString(tRegionLenMax.min)+","+toString(tRegionLenMax.max)+"];"
 					" 0 defaults to no automatic range detection)"
 					).c_str())
+		("tVariants"
+			, value<std::string>(&(tVariantsString))
+			, std::string("variant scanning : comma-separated list of point mutations"
+					" of the (single) target, each given as"
+					" <nucleotide><position><nucleotide> assuming indexing starts with 1,"
+					" e.g. 'A23G,C40U'. Each mutation is predicted as an additional"
+					" target '<targetId>_<mutation>', which reuses ED values and"
+					" predictions of the target outside of the region affected by"
+					" the mutation (see --tAccW and --windowWidth)."
+					).c_str())
 		;
 
 	////  SEED OPTIONS  ////////////////////////////////////
@@ -421,6 +513,7 @@ CommandLineParsing::CommandLineParsing()
 			, value<std::string>(&(seedTRange))
 				->notifier(boost::bind(&CommandLineParsing::validate_seedTRange,this,_1))
 			, std::string("interval(s) in the target to search for seeds in format 'from1-to1,from2-to2,...' (Note, only for single target)").c_str())
+	    ("seedPrefilter", "if present, targets are checked for feasible seeds (ignoring their accessibility) before their accessibility is computed; targets without seed are skipped and the ED computation is restricted to the regions around seeds")
 		;
 
 	////  SHAPE OPTIONS  ////////////////////////
@@ -490,7 +583,8 @@ CommandLineParsing::CommandLineParsing()
 			, std::string("prediction mode : "
 					"\n 'H' = heuristic (fast and low memory), "
 					"\n 'M' = exact and low memory, "
-					"\n 'E' = exact (high memory)"
+					"\n 'E' = exact (high memory), "
+					"\n 'A' = heuristic restricted to seed anchor neighborhoods (long targets; requires seed)"
 					).c_str())
 		;
 	opts_cmdline_short.add(opts_inter);
@@ -503,6 +597,12 @@ CommandLineParsing::CommandLineParsing()
 					"\n 'S' = single-site minimum-free-energy interaction (interior loops only), "
 					"\n 'P' = single-site maximum-probability interaction (interior loops only)"
 					).c_str())
+		("pruning", "if present, DP cells that cannot yield an interaction better than the"
+				" currently worst reported one (or --outMaxE) are skipped using energy lower bounds"
+				" (--mode=H|M with --noSeed and --pred=S only; the number of evaluated and pruned cells is logged with --v=1)")
+		("storeTrace", "if present, the heuristic prediction (--mode=H) stores traceback pointers (2 bytes per DP cell)"
+				" such that the traceback of each reported interaction is a linear walk; speeds up the output of many"
+				" (suboptimal) interactions (--outNumber)")
 		("energy,e"
 			, value<char>(&(energy.val))
 				->default_value(energy.def)
@@ -514,6 +614,11 @@ CommandLineParsing::CommandLineParsing()
 			, value<std::string>(&energyFile)
 				->notifier(boost::bind(&CommandLineParsing::validate_energyFile,this,_1))
 			, std::string("energy parameter file of VRNA package to be used. If not provided, the default parameter set of the linked Vienna RNA package is used.").c_str())
+		("energyVRNAcache"
+			, value<std::string>(&energyCacheDir)
+			, std::string("name of a directory where the VRNA energy parameters and Boltzmann factors generated"
+					" for the parameter file (--energyVRNA), temperature and model setup are stored in binary format"
+					" to be directly loaded by later calls instead of being regenerated.").c_str())
 		("temperature"
 			, value<T_type>(&(temperature.val))
 				->default_value(temperature.def)
@@ -533,6 +638,61 @@ CommandLineParsing::CommandLineParsing()
 			, std::string("Window-based computation: overlap of the window to be used."
 					" Has to be smaller than --windowWidth and greater or equal than the maximal interaction length (see --q|tIntMaxLen)."
 					" (arg in range ["+toString(windowOverlap.min)+","+toString(windowOverlap.max)+"])").c_str())
+		("memLimit"
+			, value<int>(&(memLimit.val))
+				->default_value(memLimit.def)
+				->notifier(boost::bind(&CommandLineParsing::validate_memLimit,this,_1))
+			, std::string("Maximal memory (in MB) of all concurrent predictions, estimated from the accessibility, DP, seed"
+					" and pair-wise output (--out=pMinE) data of the longest sequences."
+					" If a single prediction exceeds the limit, --mode=E is replaced by --mode=M (same results),"
+					" window-based computation is enabled (if not set and interaction lengths are restricted)"
+					" or the run is refused. Otherwise, the number of threads is reduced to fit into the limit;"
+					" 0 disables the check"
+					" (arg in range ["+toString(memLimit.min)+","+toString(memLimit.max)+"])").c_str())
+		("timeBudget"
+			, value<double>(&(timeBudget.val))
+				->default_value(timeBudget.def)
+				->notifier(boost::bind(&CommandLineParsing::validate_timeBudget,this,_1))
+			, std::string("Maximal time (in seconds) the exact prediction (--mode=M or E with --pred=S) of a query-target"
+					" combination may take. If exceeded, the prediction is aborted and the combination is predicted"
+					" heuristically (--mode=H), which is flagged in the output by a preceding line"
+					" '#DEGRADED <targetId> <queryId>'; 0 disables the budget"
+					" (arg in range ["+toString(timeBudget.min)+","+toString(timeBudget.max)+"])").c_str())
+		("windowAuto", "Window-based computation: if present, the window width is chosen by a cost model of the"
+				" predictions, such that the estimated parallel runtime (including the redundant computation"
+				" of window overlaps) is minimal for the given sequences, i.e. expensive target-query combinations"
+				" are split into window tasks. The choice is independent of the number of threads (see --threads)."
+				" The window overlap is set to the maximal interaction length."
+				" Requires restricted interaction lengths (see --q|tIntLenMax) and no --windowWidth")
+		("windowSliding", "Window-based computation: if present, the target windows are processed"
+				" consecutively by one predictor, which reuses the results of the window overlaps"
+				" if possible (--mode=H with --noSeed); otherwise all window combinations are computed independently")
+		("bestFirst", "Window-based computation: if present, the window and region combinations of each query-target"
+				" combination are predicted in the order of their lower energy bound (from the minimal ED values of"
+				" the regions), where target regions without feasible seed (see --seedPrefilter) are predicted last."
+				" If only the mfe interaction (--outNumber=1) or the global top-k (--outTopK) is reported, the"
+				" remaining combinations are skipped as soon as none of them can yield an interaction as good as"
+				" the best (k-th best) interaction found so far")
+		("selfInteraction", "if present, targets and queries with identical sequence (e.g. homodimers) share the query's"
+				" accessibility and only one of two symmetric interactions (with swapped roles of target and query) is"
+				" predicted and reported (requires identical target and query settings for accessibility, interaction lengths,"
+				" loops, seed and regions; symmetric right ends are skipped for --mode=M, --pred=S only)")
+		("cascadeRatio"
+			, value<double>(&(cascadeRatio.val))
+				->default_value(cascadeRatio.def)
+				->notifier(boost::bind(&CommandLineParsing::validate_cascadeRatio,this,_1))
+			, std::string("Two-stage screening: all combinations of a target batch are first predicted with a fast coarse model"
+					" (heuristic prediction without target accessibility); only the given fraction of combinations with"
+					" lowest coarse energy is passed to the full prediction, where the target accessibility is computed"
+					" only around the coarse interaction sites; 1 disables the filter"
+					" (arg in range ["+toString(cascadeRatio.min)+","+toString(cascadeRatio.max)+"])").c_str())
+		("cascadeDeltaE"
+			, value<double>(&(cascadeDeltaE.val))
+				->default_value(cascadeDeltaE.def)
+				->notifier(boost::bind(&CommandLineParsing::validate_cascadeDeltaE,this,_1))
+			, std::string("Two-stage screening: only combinations with a coarse energy within this margin of the best coarse"
+					" energy of the target batch are passed to the full prediction (see --cascadeRatio); "+toString(cascadeDeltaE.max)+" disables the filter"
+					" (arg in range ["+toString(cascadeDeltaE.min)+","+toString(cascadeDeltaE.max)+"])").c_str())
 		;
 
 
@@ -546,18 +706,24 @@ CommandLineParsing::CommandLineParsing()
 				->notifier(boost::bind(&CommandLineParsing::validate_out,this,_1))
 			, std::string("output (multi-arg) : provide a file name for output (will be overwritten)"
 					" or 'STDOUT/STDERR' to write to the according stream (according to --outMode)."
+					" File names ending with '.gz' or '.zst' are written gzip or zstd compressed (if supported by the build)."
 					"\nUse one of the following PREFIXES (colon-separated) to generate"
 					" ADDITIONAL output:"
 					"\n 'qMinE:' (query) for each position the minimal energy of any interaction covering the position (CSV format)"
 					"\n 'qSpotProb:' (query) for each position the probability that is is covered by an interaction covering (CSV format)"
 					"\n 'qAcc:' (query) ED accessibility values ('qPu'-like format)."
 					"\n 'qPu:' (query) unpaired probabilities values (RNAplfold format)."
+					"\n 'qAccBin:' (query) ED accessibility values (binary format, to be read via --qAcc=B)."
 					"\n 'tMinE:' (target) for each position the minimal energy of any interaction covering the position (CSV format)"
 					"\n 'tSpotProb:' (target) for each position the probability that is is covered by an interaction covering (CSV format)"
 					"\n 'tAcc:' (target) ED accessibility values ('tPu'-like format)."
 					"\n 'tPu:' (target) unpaired probabilities values (RNAplfold format)."
+					"\n 'tAccBin:' (target) ED accessibility values (binary format, to be read via --tAcc=B)."
 					"\n 'pMinE:' (query+target) for each index pair the minimal energy of any interaction covering the pair (CSV format)"
 					"\n 'spotProb:' (query+target) tracks for a given set of interaction spots their probability to be covered by an interaction. Spots are encoded by comma-separated 'idx1&idx2' pairs. For each spot a probability is provided in concert with the probability that none of the spots (encoded by '0&0') is covered (CSV format). The spot encoding is followed colon-separated by the output stream/file name, eg. '--out=\"spotProb:3&76,59&2:STDERR\"'. NOTE: value has to be quoted due to '&' symbol!"
+					"\n 'telemetry:' runtime summary of the computation stages (accessibility, ES, seed, hybridization, traceback, output) with totals, percentiles and cells computed per second (JSON format)"
+					"\n 'telemetryCsv:' runtime summary as for 'telemetry:' (CSV format)"
+					"\n 'trace:' execution trace with begin and end of the computation stages and window predictions for each thread (Chrome trace JSON format, e.g. for chrome://tracing or Perfetto)"
 					"\nFor each, provide a file name or STDOUT/STDERR to write to the respective output stream."
 					).c_str())
 		("outMode"
@@ -568,6 +734,7 @@ CommandLineParsing::CommandLineParsing()
 					"\n 'N' normal output (ASCII char + energy),"
 					"\n 'D' detailed output (ASCII char + energy/position details),"
 					"\n 'C' CSV output (see --outCsvCols),"
+					"\n 'B' binary columnar output of the --outCsvCols columns (see README),"
 					"\n '1' backward compatible IntaRNA v1.* normal output,"
 					"\n 'O' backward compatible IntaRNA v1.* detailed output (former -o)"
 					).c_str())
@@ -611,13 +778,32 @@ CommandLineParsing::CommandLineParsing()
 			, value<std::string>(&(outCsvCols))
 				->default_value(outCsvCols,"see text")
 				->notifier(boost::bind(&CommandLineParsing::validate_outCsvCols,this,_1))
-			, std::string("output : comma separated list of CSV column IDs to print if outMode=CSV."
+			, std::string("output : comma separated list of CSV column IDs to print if outMode=CSV (or to store if outMode=B)."
 					" An empty argument (using '') prints all possible columns from the following available ID list: "
 					+ boost::replace_all_copy(OutputHandlerCsv::list2string(OutputHandlerCsv::string2list("")), ",", ", ")+"."
 					+ "\nDefault = '"+outCsvCols+"'."
 					).c_str())
 	    ("outPerRegion", "output : if given, best interactions are reported independently"
 	    		" for all region combinations; otherwise only the best for each query-target combination")
+	    ("outPartial", "output : if given, the interactions of each window are written as soon as the window is predicted,"
+	    		" each preceded by a line '#PARTIAL <targetId> <queryId> <targetWindow> <queryWindow>'."
+	    		" The final output of each query-target combination is preceded by a line '#FINAL <targetId> <queryId>'."
+	    		" Not supported for IntaRNA v1 output, --outTopK and --checkpoint")
+	    ("outTopK"
+			, value<int>(&(outTopK.val))
+				->default_value(outTopK.def)
+				->notifier(boost::bind(&CommandLineParsing::validate_outTopK,this,_1))
+			, std::string("output : if > 0, only the outTopK best interactions over all query-target combinations"
+					" are reported, sorted by energy once all predictions are done."
+					" Predictions are pruned using the energy of the currently k-th best interaction."
+					" A value of 0 reports the interactions of each query-target combination"
+					" (arg in range ["+toString(outTopK.min)+","+toString(outTopK.max)+"])").c_str())
+	    ("fuseSites", "output : if given, each suboptimal interaction site is blocked and the mfe interaction"
+	    		" of the remaining sequences is predicted. If the latter overlaps the mfe interaction in both sequences,"
+	    		" the fused interaction of both sites is reported by a line"
+	    		" '#FUSED <targetId> <queryId> <site1> <site2> <E> <ED1> <ED2>' following the interactions."
+	    		" Use with -n and --outOverlap=N. Requires --pred=S and --q|tAcc=C|N (C only for --energy=V);"
+	    		" not supported for IntaRNA v1 output, --outTopK and --tVariants")
 	    ("verbose,v", "verbose output") // handled via easylogging++
 	    ("default-log-file", value<std::string>(&(logFileName)), "name of file to be used for log output (INFO, WARNING, VERBOSE, DEBUG)")
 	    ;
@@ -634,7 +820,75 @@ CommandLineParsing::CommandLineParsing()
 					" A value of 0 requests all available CPUs."
 					" Note, the number of threads multiplies the required memory used for computation!"
 					" (arg in range ["+toString(threads.min)+","+toString(threads.max)+"])").c_str())
+	    ("tAccBuffer"
+			, value<int>(&(tAccBuffer.val))
+				->default_value(tAccBuffer.def)
+				->notifier(boost::bind(&CommandLineParsing::validate_tAccBuffer,this,_1))
+			, std::string("maximal number of target accessibilities that are computed ahead and held in memory at once"
+					" while other threads run the predictions for already available targets."
+					" A value of 0 sets it to the number of threads."
+					" (arg in range ["+toString(tAccBuffer.min)+","+toString(tAccBuffer.max)+"])").c_str())
+	    ("outOrderBuffer"
+			, value<int>(&(outOrderBuffer.val))
+				->default_value(outOrderBuffer.def)
+				->notifier(boost::bind(&CommandLineParsing::validate_outOrderBuffer,this,_1))
+			, std::string("maximal number of query-target combinations whose output is buffered"
+					" to write the output in input order when using multiple threads."
+					" If exceeded, the oldest buffered output is written, i.e. the order is relaxed."
+					" A value of 0 writes the output in order of completion."
+					" (arg in range ["+toString(outOrderBuffer.min)+","+toString(outOrderBuffer.max)+"])").c_str())
 #endif
+	    ("server", "server mode : if present, prediction requests are read line-wise from STDIN"
+	    		" instead of using --query and --target, each line holding a query and a target sequence separated by whitespace."
+	    		" The output of each request is terminated by a line '#END'."
+	    		" Energy parameters and query accessibilities are reused over the requests.")
+	    ("serverCache"
+			, value<int>(&(serverCache.val))
+				->default_value(serverCache.def)
+				->notifier(boost::bind(&CommandLineParsing::validate_serverCache,this,_1))
+			, std::string("server mode : maximal number of query accessibilities cached to be reused over the requests."
+					" If exceeded, the cache is cleared."
+					" (arg in range ["+toString(serverCache.min)+","+toString(serverCache.max)+"])").c_str())
+	    ("sweep"
+			, value<std::string>(&(sweepFile))
+			, "sweep mode : name of a file with one parameter set per line, each holding arguments that overwrite"
+				" the command line values of --seedBP, --seedMaxUP, --seedMaxE, --qIntLoopMax, --tIntLoopMax,"
+				" --outNumber, --outMaxE or --outDeltaE (empty lines and lines starting with '#' are ignored)."
+				" The prediction is done for each parameter set, while the accessibilities are computed only once."
+				" The output of each parameter set is preceded by a line '#SWEEP <number> : <arguments>'"
+				" and terminated by a line '#END'.")
+	    ("checkpoint"
+			, value<std::string>(&(checkpointFile))
+			, "name of the checkpoint file where the query-target combinations are recorded"
+				" whose output has been written. Requires the output (--out) to be written to a file.")
+	    ("resume", "checkpoint : if present, the run recorded in the --checkpoint file is resumed,"
+	    		" i.e. the output is continued and recorded query-target combinations are skipped."
+	    		" The same arguments as for the interrupted run have to be used."
+	    		" Accessibility files written for targets (--out=tAcc:..) are reused.")
+	    ("accCache"
+			, value<std::string>(&(accCacheDir))
+			, "name of a directory where computed accessibility (ED) values are stored in binary format"
+				" to be reused by later calls for the same sequence and accessibility setup"
+				" (constraint, window and span length, temperature, energy parameters)."
+				" Only used for VRNA-based accessibility computation (--qAcc=C and --tAcc=C with --energy=V).")
+	    ("resultStore"
+			, value<std::string>(&(resultStoreDir))
+			, "name of a directory where the output of each query-target combination is stored"
+				" to be reused by later calls for the same sequences (including their IDs) and arguments."
+				" For stored combinations, the accessibility computation and prediction is skipped."
+				" Not supported for IntaRNA v1 output, --outTopK, two-stage screening, prediction-specific"
+				" output (e.g. --out=pMinE:..), target accessibility output (--out=tAcc:..) or input"
+				" files read from STDIN.")
+	    ("accCacheMap", "accCache : if present, cached accessibility (ED) values are memory mapped read-only"
+	    		" instead of read, such that processes running on the same machine share their memory"
+	    		" (e.g. using a cache directory within /dev/shm).")
+	    ("accLowMem", "if present, accessibility (ED) values are stored in a 16-bit fixed-point encoding"
+	    		" (resolution 0.01 kcal/mol) instead of full precision, which halves their memory consumption."
+	    		" Furthermore, query accessibilities are not copied in reversed order for faster access.")
+	    ("dryRun", "if present, only the estimated costs of the run are reported without computing anything:"
+	    		" the accessibility computation cost and memory of each sequence and the number of window combinations,"
+	    		" DP matrix cells, prediction cost and memory of each target-query combination"
+	    		" (based on the given sequences and parameters)")
 	    ("version", "print version")
 	    ("help,h", "show the help page for basic parameters")
 	    ("fullhelp", "show the extended help page for all available parameters")
@@ -645,6 +899,20 @@ CommandLineParsing::CommandLineParsing()
 
 	opts_cmdline_all.add(opts_query).add(opts_target).add(opts_seed).add(opts_shape).add(opts_inter).add(opts_output).add(opts_general);
 
+	////  SWEEP OPTIONS  ////////////////////////////////////
+
+	// parameters that affect neither the accessibilities nor the sequence input
+	opts_sweep.add_options()
+		("seedBP", value<int>(&(seedBP.val))->notifier(boost::bind(&CommandLineParsing::validate_seedBP,this,_1)))
+		("seedMaxUP", value<int>(&(seedMaxUP.val))->notifier(boost::bind(&CommandLineParsing::validate_seedMaxUP,this,_1)))
+		("seedMaxE", value<E_type>(&(seedMaxE.val))->notifier(boost::bind(&CommandLineParsing::validate_seedMaxE,this,_1)))
+		("qIntLoopMax", value<int>(&(qIntLoopMax.val))->notifier(boost::bind(&CommandLineParsing::validate_qIntLoopMax,this,_1)))
+		("tIntLoopMax", value<int>(&(tIntLoopMax.val))->notifier(boost::bind(&CommandLineParsing::validate_tIntLoopMax,this,_1)))
+		("outNumber", value<int>(&(outNumber.val))->notifier(boost::bind(&CommandLineParsing::validate_outNumber,this,_1)))
+		("outMaxE", value<double>(&(outMaxE.val))->notifier(boost::bind(&CommandLineParsing::validate_outMaxE,this,_1)))
+		("outDeltaE", value<double>(&(outDeltaE.val))->notifier(boost::bind(&CommandLineParsing::validate_outDeltaE,this,_1)))
+		;
+
 
 }
 
@@ -653,6 +921,14 @@ CommandLineParsing::CommandLineParsing()
 CommandLineParsing::~CommandLineParsing() {
 
 	 INTARNA_CLEANUP(seedConstraint);
+	 INTARNA_CLEANUP(checkpoint);
+	 INTARNA_CLEANUP(accCache);
+	 INTARNA_CLEANUP(resultStore);
+
+	// close batch-wise target input if still open
+	if (targetStream != NULL && targetStream != &(std::cin)) {
+		 INTARNA_CLEANUP(targetStream);
+	}
 
 	// reset output stream
 	deleteOutputStream( outStream );
@@ -683,7 +959,23 @@ parse(int argc, char** argv)
 				| command_line_style::style_t::short_allow_next
 				| command_line_style::style_t::case_insensitive
 				;
-		store( parse_command_line(argc, argv, opts_cmdline_all, parseStyle), vm);
+		const parsed_options parsedArgs = parse_command_line(argc, argv, opts_cmdline_all, parseStyle);
+		store( parsedArgs, vm);
+		// arguments the output depends on (sorted) for the result store,
+		// where the sequence input is covered by the result keys
+		const std::set< std::string > resultIndependentArgs = { "query", "target", "qSet", "tSet", "tBatchSize", "tShardCount", "tShardIndex"
+				, "out", "verbose", "default-log-file", "threads", "tAccBuffer", "outOrderBuffer", "server", "serverCache", "sweep"
+				, "checkpoint", "resume", "accCache", "accCacheMap", "resultStore", "energyVRNAcache" };
+		std::set< std::string > resultArgs;
+		BOOST_FOREACH( const option & arg, parsedArgs.options ) {
+			if (resultIndependentArgs.find( arg.string_key ) == resultIndependentArgs.end()) {
+				resultArgs.insert( arg.string_key + "=" + boost::join( arg.value, "," ) );
+			}
+		}
+		resultParameters = "version=" INTARNA_VERSION;
+		BOOST_FOREACH( const std::string & arg, resultArgs ) {
+			resultParameters += " --" + arg;
+		}
 		// parsing fine so far
 		parsingCode = ReturnCode::KEEP_GOING;
 	} catch (error& e) {
@@ -734,6 +1026,20 @@ parse(int argc, char** argv)
 		try {
 			// run all notifier checks
 			notify(vm);
+			// check sequence input (provided by the requests in server mode)
+			serverMode = vm.count("server") > 0;
+			if (serverMode) {
+				if (vm.count("query") > 0) throw error("--query not supported in server mode (--server)");
+				if (vm.count("target") > 0) throw error("--target not supported in server mode (--server)");
+			} else {
+				if (vm.count("query") == 0) {
+					LOG(ERROR) <<"mandatory option '--query' not provided";
+					updateParsingCode(ReturnCode::STOP_PARSING_ERROR);
+				} else if (vm.count("target") == 0) {
+					LOG(ERROR) <<"mandatory option '--target' not provided";
+					updateParsingCode(ReturnCode::STOP_PARSING_ERROR);
+				}
+			}
 		} catch (required_option& e) {
 			LOG(ERROR) <<"mandatory option '"<<e.get_option_name() << "' not provided";
 			updateParsingCode(ReturnCode::STOP_PARSING_ERROR);
@@ -747,20 +1053,229 @@ parse(int argc, char** argv)
 	if (parsingCode == ReturnCode::KEEP_GOING) {
 		try {
 
+			// setup checkpointing
+			resume = vm.count("resume") > 0;
+			accLowMem = vm.count("accLowMem") > 0;
+			dryRun = vm.count("dryRun") > 0;
+			if (dryRun && serverMode) {
+				throw error("--dryRun not supported in server mode");
+			}
+			accCacheMap = vm.count("accCacheMap") > 0;
+			if (accCacheMap && accCacheDir.empty()) {
+				throw error("--accCacheMap requires an --accCache directory");
+			}
+			if (resume && checkpointFile.empty()) {
+				throw error("--resume requires a --checkpoint file");
+			}
+			if (!checkpointFile.empty()) {
+				const std::string & outFile = outPrefix2streamName.at(OutPrefixCode::OP_EMPTY);
+				if (serverMode) throw error("--checkpoint not supported in server mode (--server)");
+				if (outMode.val == '1' || outMode.val == 'O') throw error("--checkpoint not supported for IntaRNA v1 output");
+				if (boost::iequals(outFile,"STDOUT") || boost::iequals(outFile,"STDERR")) {
+					throw error("--checkpoint requires the output to be written to a file (--out)");
+				}
+				CompressedOutputBuffer::Format format;
+				if (CompressedOutputBuffer::getFormat( outFile, format )) {
+					throw error("--checkpoint not supported for compressed output (--out)");
+				}
+				checkpoint = new CheckpointJournal( checkpointFile, resume );
+				// discard output not covered by the checkpoint
+				if (resume && boost::filesystem::exists( outFile )) {
+					if (boost::filesystem::file_size( outFile ) < checkpoint->getOutputSize()) {
+						throw error("--resume : output file '"+outFile+"' is shorter than recorded in the checkpoint file '"+checkpointFile+"'");
+					}
+					boost::filesystem::resize_file( outFile, checkpoint->getOutputSize() );
+				} else if (resume && checkpoint->getOutputSize() > 0) {
+					throw error("--resume : output file '"+outFile+"' recorded in the checkpoint file '"+checkpointFile+"' not found");
+				}
+			}
+
+			// setup accessibility cache
+			if (!accCacheDir.empty()) {
+				boost::system::error_code ec;
+				boost::filesystem::create_directories( accCacheDir, ec );
+				if (ec || !boost::filesystem::is_directory( accCacheDir )) {
+					throw error("--accCache : could not create directory '"+accCacheDir+"'");
+				}
+				accCache = new AccessibilityCache( accCacheDir, accCacheMap );
+			}
+
+			// setup result store
+			if (!resultStoreDir.empty()) {
+				if (outMode.val == '1' || outMode.val == 'O') throw error("--resultStore not supported for IntaRNA v1 output");
+				if (outTopK.val > 0) throw error("--resultStore not supported for global top-k output (--outTopK)");
+				if (useCascade()) throw error("--resultStore not supported for two-stage screening (--cascadeRatio, --cascadeDeltaE)");
+				if (isPredictionTracked()) throw error("--resultStore not supported for prediction-specific output (--out)");
+				if (!outPrefix2streamName.at(OutPrefixCode::OP_tAcc).empty()
+					|| !outPrefix2streamName.at(OutPrefixCode::OP_tPu).empty()
+					|| !outPrefix2streamName.at(OutPrefixCode::OP_tAccBin).empty())
+				{
+					throw error("--resultStore not supported for target accessibility output (--out)");
+				}
+				// the output depends on the content of referenced input files
+				const std::pair< std::string, std::string > resultInputFiles[] = { {"energyVRNA",energyFile}
+						, {"qAccFile",qAccFile}, {"tAccFile",tAccFile}, {"qShape",qShape}, {"tShape",tShape} };
+				for (const auto & inputFile : resultInputFiles) {
+					if (inputFile.second.empty()) {
+						continue;
+					}
+					if (boost::iequals(inputFile.second,"STDIN")) throw error("--resultStore not supported for input from STDIN (--"+inputFile.first+")");
+					try {
+						resultParameters += " #"+inputFile.first+"="+KeyedFileStore::getHash( KeyedFileStore::getFileContent( inputFile.second ) );
+					} catch (std::runtime_error & e) {
+						throw error("--resultStore : could not read file '"+inputFile.second+"' (--"+inputFile.first+")");
+					}
+				}
+				boost::system::error_code ec;
+				boost::filesystem::create_directories( resultStoreDir, ec );
+				if (ec || !boost::filesystem::is_directory( resultStoreDir )) {
+					throw error("--resultStore : could not create directory '"+resultStoreDir+"'");
+				}
+				resultStore = new ResultStore( resultStoreDir );
+			}
+
+			// setup parameter sweep
+			if (!sweepFile.empty()) {
+				if (serverMode) throw error("--sweep not supported in server mode (--server)");
+				if (tBatchSize.val > 0) throw error("--sweep not supported for batch-wise target input (--tBatchSize)");
+				if (!checkpointFile.empty()) throw error("--sweep not supported with checkpointing (--checkpoint)");
+				std::ifstream sweepStream( sweepFile.c_str() );
+				if (!sweepStream.good()) {
+					throw error("--sweep : could not open file '"+sweepFile+"'");
+				}
+				std::string sweepSet;
+				while( std::getline( sweepStream, sweepSet ) ) {
+					boost::trim(sweepSet);
+					// skip empty and comment lines
+					if (!sweepSet.empty() && sweepSet.at(0) != '#') {
+						sweepSets.push_back( sweepSet );
+					}
+				}
+				if (sweepSets.empty()) {
+					throw error("--sweep : no parameter set given in file '"+sweepFile+"'");
+				}
+				// command line values to reset to for each parameter set
+				sweepBase = "--seedBP="+toString(seedBP.val)
+						+" --seedMaxUP="+toString(seedMaxUP.val)
+						+" --seedMaxE="+toString(seedMaxE.val)
+						+" --qIntLoopMax="+toString(qIntLoopMax.val)
+						+" --tIntLoopMax="+toString(tIntLoopMax.val)
+						+" --outNumber="+toString(outNumber.val)
+						+" --outMaxE="+toString(outMaxE.val)
+						+" --outDeltaE="+toString(outDeltaE.val);
+			}
+
 			// open output stream
-			{
+			if (resume) {
+				// continue output of the resumed run
+				std::fstream * outFileStream = new std::fstream();
+				outFileStream->open( outPrefix2streamName.at(OutPrefixCode::OP_EMPTY).c_str(), std::ios_base::out | std::ios_base::app );
+				if (!outFileStream->is_open()) {
+					 INTARNA_CLEANUP(outFileStream);
+					throw error("could not open output file --out='"+toString(outPrefix2streamName.at(OutPrefixCode::OP_EMPTY))+ "' for appending");
+				}
+				outStream = outFileStream;
+			} else {
 				// open according stream
 				outStream = newOutputStream( outPrefix2streamName.at(OutPrefixCode::OP_EMPTY) );
 				// check success
 				if (outStream == NULL) {
 					throw error("could not open output file --out='"+toString(outPrefix2streamName.at(OutPrefixCode::OP_EMPTY))+ "' for writing");
 				}
+				// write file output via a dedicated writer thread such that
+				// computing threads do not block on file I/O or compression
+				// (not for checkpointing, which requires the output to be written)
+				if (checkpoint == NULL
+					&& (dynamic_cast<std::fstream*>(outStream) != NULL
+						|| dynamic_cast<CompressedOutputStream*>(outStream) != NULL))
+				{
+					outStream = new AsyncOutputStream( outStream, true );
+				}
 			}
 			outPerRegion = vm.count("outPerRegion") > 0;
 
+			// check partial output of windows
+			outPartial = vm.count("outPartial") > 0;
+			if (outPartial) {
+				if (outMode.val == '1' || outMode.val == 'O') throw error("--outPartial not supported for IntaRNA v1 output");
+				if (outTopK.val > 0) throw error("--outPartial not supported for global top-k output (--outTopK)");
+				if (!checkpointFile.empty()) throw error("--outPartial not supported with --checkpoint");
+			}
+
+			// check global top-k output
+			if (outTopK.val > 0) {
+				if (outMode.val == '1' || outMode.val == 'O') throw error("--outTopK not supported for IntaRNA v1 output");
+				if (!checkpointFile.empty()) throw error("--outTopK not supported with --checkpoint");
+			}
+
+			// enable runtime measurements if needed
+			Telemetry::setEnabled( !outPrefix2streamName.at(OutPrefixCode::OP_telemetry).empty()
+								|| !outPrefix2streamName.at(OutPrefixCode::OP_telemetryCsv).empty() );
+			Telemetry::setTraceEnabled( !outPrefix2streamName.at(OutPrefixCode::OP_trace).empty() );
+
 			// parse the sequences
-			parseSequences("query",queryArg,query,qSet);
-			parseSequences("target",targetArg,target,tSet);
+			if (serverMode) {
+				// sequences are provided by the requests :
+				// ensure no sequence specific setup is given
+				if (tBatchSize.val > 0) throw error("--tBatchSize not supported in server mode (--server)");
+				if (vm.count("qAccConstr") > 0) throw error("--qAccConstr not supported in server mode (--server)");
+				if (vm.count("tAccConstr") > 0) throw error("--tAccConstr not supported in server mode (--server)");
+				if (!qRegionString.empty()) throw error("--qRegion not supported in server mode (--server)");
+				if (!tRegionString.empty()) throw error("--tRegion not supported in server mode (--server)");
+				if (!qShape.empty()) throw error("--qShape not supported in server mode (--server)");
+				if (!tShape.empty()) throw error("--tShape not supported in server mode (--server)");
+				if (!seedQRange.empty()) throw error("--seedQRange not supported in server mode (--server)");
+				if (!seedTRange.empty()) throw error("--seedTRange not supported in server mode (--server)");
+				if (!seedTQ.empty()) throw error("--seedTQ not supported in server mode (--server)");
+				if (outMode.val == 'B') throw error("--outMode=B not supported in server mode (--server)");
+				if (qAcc.val == 'P' || qAcc.val == 'E' || qAcc.val == 'B') throw error("--qAcc="+toString(qAcc.val)+" not supported in server mode (--server)");
+				if (tAcc.val == 'P' || tAcc.val == 'E' || tAcc.val == 'B') throw error("--tAcc="+toString(tAcc.val)+" not supported in server mode (--server)");
+				// requests are read from STDIN
+				if (!setStdinUsed()) throw error("server mode (--server) requires STDIN for reading the requests");
+			} else {
+				parseSequences("query",queryArg,query,qSet);
+				if (tBatchSize.val > 0 && !RnaSequence::isValidSequenceIUPAC(targetArg)) {
+					// batch-wise target input : setup input stream
+					if (boost::iequals(targetArg,"STDIN")) {
+						targetStream = &(std::cin);
+					} else {
+						targetStream = new std::ifstream(targetArg);
+						if (!targetStream->good()) {
+							 INTARNA_CLEANUP(targetStream);
+							throw error("FASTA parsing of target : could not open FASTA file  '"+targetArg+"'");
+						}
+					}
+					// ensure no single-sequence specific target setup is given
+					if (vm.count("tAccConstr") > 0) throw error("--tAccConstr not supported for batch-wise target input (--tBatchSize)");
+					if (!tRegionString.empty()) throw error("--tRegion not supported for batch-wise target input (--tBatchSize)");
+					if (!tShape.empty()) throw error("--tShape not supported for batch-wise target input (--tBatchSize)");
+					if (!seedTRange.empty()) throw error("--seedTRange not supported for batch-wise target input (--tBatchSize)");
+					if (!seedTQ.empty()) throw error("--seedTQ not supported for batch-wise target input (--tBatchSize)");
+					if (boost::iequals(tAccFile,"STDIN")) throw error("--tAccFile=STDIN not supported for batch-wise target input (--tBatchSize)");
+					// read first batch of targets
+					readTargetBatch();
+				} else {
+					parseSequences("target",targetArg,target,tSet);
+				}
+			}
+
+			// check target sharding
+			if (tShardIndex.val > tShardCount.val) {
+				throw error("--tShardIndex ("+toString(tShardIndex.val)+") exceeds --tShardCount ("+toString(tShardCount.val)+")");
+			}
+			if (tShardCount.val > 1) {
+				// ensure no single-sequence specific target setup is given
+				if (serverMode) throw error("--tShardCount not supported in server mode (--server)");
+				if (tBatchSize.val > 0) throw error("--tShardCount not supported for batch-wise target input (--tBatchSize)");
+				if (vm.count("tAccConstr") > 0) throw error("--tAccConstr not supported for sharded target input (--tShardCount)");
+				if (!tRegionString.empty()) throw error("--tRegion not supported for sharded target input (--tShardCount)");
+				if (!tShape.empty()) throw error("--tShape not supported for sharded target input (--tShardCount)");
+				if (!seedTRange.empty()) throw error("--seedTRange not supported for sharded target input (--tShardCount)");
+				if (!seedTQ.empty()) throw error("--seedTQ not supported for sharded target input (--tShardCount)");
+				if (boost::iequals(tAccFile,"STDIN")) throw error("--tAccFile=STDIN not supported for sharded target input (--tShardCount)");
+				// reduce targets to the ones of this shard
+				selectTargetShard();
+			}
 
 			// valide accessibility input from file (requires parsed sequences)
 			validate_qAccFile( qAccFile );
@@ -768,6 +1283,22 @@ parse(int argc, char** argv)
 
 			// check seed setup
 			noSeedRequired = vm.count("noSeed") > 0;
+
+			// check pruning setup
+			pruning = vm.count("pruning") > 0;
+			if (pruning && (!noSeedRequired || pred.val != 'S' || (predMode.val != 'H' && predMode.val != 'M'))) {
+				LOG(INFO) <<"pruning is only supported for --mode=H|M with --noSeed and --pred=S (will be ignored)";
+				pruning = false;
+			}
+			// check traceback pointer setup
+			storeTrace = vm.count("storeTrace") > 0;
+			if (storeTrace && (pred.val != 'S' || predMode.val != 'H')) {
+				LOG(INFO) <<"storeTrace is only supported for --mode=H and --pred=S (will be ignored)";
+				storeTrace = false;
+			}
+			if (timeBudget.val > 0 && (pred.val != 'S' || (predMode.val != 'M' && predMode.val != 'E'))) {
+				LOG(INFO) <<"timeBudget is only supported for --mode=M or E and --pred=S (will be ignored)";
+			}
 			if (noSeedRequired) {
 				// input sanity check : maybe seed constraints defined -> warn
 				if (!seedTQ.empty()) LOG(INFO) <<"no seed constraint wanted, but explicit seedTQ provided (will be ignored)";
@@ -779,6 +1310,7 @@ parse(int argc, char** argv)
 				if (seedMinPu.val != seedMinPu.def) LOG(INFO) <<"no seed constraint wanted, but seedMinPu provided (will be ignored)";
 				if (!seedQRange.empty()) LOG(INFO) <<"no seed constraint wanted, but seedQRange provided (will be ignored)";
 				if (!seedTRange.empty()) LOG(INFO) <<"no seed constraint wanted, but seedTRange provided (will be ignored)";
+				if (vm.count("seedPrefilter") > 0) LOG(INFO) <<"no seed constraint wanted, but seedPrefilter provided (will be ignored)";
 			} else {
 				// check query search ranges
 				if (!seedQRange.empty()) {
@@ -797,18 +1329,6 @@ parse(int argc, char** argv)
 					}
 				}
 
-				// check for minimal sequence length (>=seedBP)
-				for( size_t i=0; i<query.size(); i++) {
-					if (query.at(i).size() < seedBP.val) {
-						throw error("length of query sequence "+toString(i+1)+" is below minimal number of seed base pairs (seedBP="+toString(seedBP.val)+")");
-					}
-				}
-				for( size_t i=0; i<target.size(); i++) {
-					if (target.at(i).size() < seedBP.val) {
-						throw error("length of target sequence "+toString(i+1)+" is below minimal number of seed base pairs (seedBP="+toString(seedBP.val)+")");
-					}
-				}
-
 				// check for explicit seed constraints
 				if (!seedTQ.empty()) {
 					if (target.size()>1 || query.size() > 1) {
@@ -823,6 +1343,17 @@ parse(int argc, char** argv)
 					if (seedMinPu.val != seedMinPu.def) LOG(INFO) <<"explicit seeds defined, but seedMinPu provided (will be ignored)";
 					if (!seedQRange.empty()) LOG(INFO) <<"explicit seeds defined, but seedQRange provided (will be ignored)";
 					if (!seedTRange.empty()) LOG(INFO) <<"explicit seeds defined, but seedTRange provided (will be ignored)";
+					if (vm.count("seedPrefilter") > 0) LOG(INFO) <<"explicit seeds defined, but seedPrefilter provided (will be ignored)";
+				} else {
+					// check seed prefilter setup
+					seedPrefilter = vm.count("seedPrefilter") > 0;
+					if (seedPrefilter && !( outPrefix2streamName.at(OutPrefixCode::OP_tAcc).empty()
+											&& outPrefix2streamName.at(OutPrefixCode::OP_tPu).empty()
+											&& outPrefix2streamName.at(OutPrefixCode::OP_tAccBin).empty() ))
+					{
+						LOG(INFO) <<"target accessibility output requested, but seedPrefilter provided (will be ignored)";
+						seedPrefilter = false;
+					}
 				}
 			}
 
@@ -844,50 +1375,142 @@ parse(int argc, char** argv)
 			// parse region string if available
 			parseRegion( "qRegion", qRegionString, query, qRegion );
 			parseRegion( "tRegion", tRegionString, target, tRegion );
+			// region-dependent target setup (only if regions are valid)
+			if (parsingCode == ReturnCode::KEEP_GOING) {
+				removeAmbiguousRuns( target, tRegion );
+				parseTargetVariants();
+				updateTargetDuplicates();
+			}
 
 
 			//////////////// WINDOW-BASED COMPUTATION ///////////////////
 
-			// check if window-based computation enabled
-			if (windowWidth.val > 0) {
-				// minimal window width
-				if (windowWidth.val < 10) {
-					throw error("window-based computation: --windowWidth should be at least 10 but is "+toString(windowWidth.val));
+			windowSliding = vm.count("windowSliding") > 0;
+			windowAuto = vm.count("windowAuto") > 0;
+			bestFirst = vm.count("bestFirst") > 0;
+
+			//////////////// SELF-INTERACTION ///////////////////
+
+			selfInteraction = vm.count("selfInteraction") > 0;
+			// restrictions are checked by validateParameterCombinations()
+
+			//////////////// FUSED SUBOPTIMAL SITES ///////////////////
+
+			fuseSites = vm.count("fuseSites") > 0;
+			if (fuseSites) {
+				if (pred.val != 'S') throw error("--fuseSites requires mfe prediction (--pred=S)");
+				if ((tAcc.val != 'C' && tAcc.val != 'N') || (qAcc.val != 'C' && qAcc.val != 'N')) {
+					throw error("--fuseSites requires computed accessibilities (--tAcc=C|N and --qAcc=C|N)");
 				}
-				// ensure interaction length is restricted
-				size_t maxIntLength = 0;
-				if (qAcc.val != 'N') { // check if accessibility computation enabled
-					if (qIntLenMax.val == 0 && qAccW.val == 0) {
-						throw error("window-based computation: maximal query interaction length has to be restricted either via --qAccW or --qIntLenMax");
-					} else { // update maximum
-						maxIntLength = std::max(qIntLenMax.val, qAccW.val);
-					}
-				} else { // max interaction length of query
-					if (qIntLenMax.val == 0) {
-						throw error("window-based computation: maximal query interaction length has to be restricted via --qIntLenMax");
-					} else {
-						maxIntLength = qIntLenMax.val;
-					}
+				if ((tAcc.val == 'C' || qAcc.val == 'C') && energy.val != 'V') {
+					throw error("--fuseSites requires VRNA-based accessibilities (--energy=V) for --q|tAcc=C");
 				}
-				if (tAcc.val != 'N') {
-					if (tIntLenMax.val == 0 && tAccW.val == 0) {
-						throw error("window-based computation: maximal target interaction length has to be restricted either via --tAccW or --tIntLenMax");
-					} else { // update maximum
-						maxIntLength = maxIntLength < std::max(tAccW.val,tIntLenMax.val) ? std::max(tAccW.val,tIntLenMax.val) : maxIntLength;
-					}
+				if (outMode.val == '1' || outMode.val == 'O') throw error("--fuseSites not supported for IntaRNA v1 output");
+				if (outTopK.val > 0) throw error("--fuseSites not supported for global top-k output (--outTopK)");
+				if (!tVariantsString.empty()) throw error("--fuseSites not supported for target variants (--tVariants)");
+				if (outNumber.val < 2) LOG(INFO) <<"no suboptimal interactions reported (--outNumber), but fuseSites provided (will be ignored)";
+			}
+
+			//////////////// TWO-STAGE SCREENING ///////////////////
+
+			if ((cascadeRatio.val < 1.0 || cascadeDeltaE.val < cascadeDeltaE.max)
+				&& !( outPrefix2streamName.at(OutPrefixCode::OP_tAcc).empty()
+					&& outPrefix2streamName.at(OutPrefixCode::OP_tPu).empty()
+					&& outPrefix2streamName.at(OutPrefixCode::OP_tAccBin).empty() ))
+			{
+				LOG(INFO) <<"target accessibility output requested, but cascadeRatio/cascadeDeltaE provided (will be ignored)";
+				cascadeRatio.val = cascadeRatio.def;
+				cascadeDeltaE.val = cascadeDeltaE.def;
+			}
+
+			// choose the window width via the cost model
+			if (windowAuto) {
+				if (windowWidth.val > 0) {
+					throw error("--windowAuto : not applicable in combination with --windowWidth");
+				}
+				// maximal interaction lengths (see window-based computation)
+				const size_t intLenQ = qAcc.val != 'N' ? std::max(qIntLenMax.val,qAccW.val) : qIntLenMax.val;
+				const size_t intLenT = tAcc.val != 'N' ? std::max(tIntLenMax.val,tAccW.val) : tIntLenMax.val;
+				if (intLenQ == 0 || intLenT == 0) {
+					throw error("--windowAuto : maximal query and target interaction lengths have to be restricted (--q|tIntLenMax or --q|tAccW)");
+				}
+				const size_t overlap = std::max( (size_t)windowOverlap.val, std::max(intLenQ,intLenT) );
+				const size_t autoWidth = getAutoWindowWidth( overlap );
+				if (autoWidth > 0) {
+					windowWidth.val = (int)autoWidth;
+					windowOverlap.val = (int)overlap;
+					VLOG(1) <<"--windowAuto : using --windowWidth="<<windowWidth.val<<" --windowOverlap="<<windowOverlap.val;
 				} else {
-					if (tIntLenMax.val == 0) {
-						throw error("window-based computation: maximal target interaction length has to be restricted via --tIntLenMax");
-					} else { // update maximum
-						maxIntLength = maxIntLength < tIntLenMax.val ? tIntLenMax.val : maxIntLength;
-					}
+					VLOG(1) <<"--windowAuto : no window-based computation";
+				}
+			}
+
+			// check the parameter combinations that are also affected by sweeps
+			validateParameterCombinations();
+
+			//////////////// MEMORY LIMIT ///////////////////
+
+			// check estimated memory of a single target-query prediction
+			if (memLimit.val > 0) {
+				// maximal sequence lengths
+				size_t maxLengthQ = 0, maxLengthT = 0;
+				for (RnaSequenceVec::const_iterator s = query.begin(); s != query.end(); s++) {
+					maxLengthQ = std::max( maxLengthQ, s->size() );
+				}
+				for (RnaSequenceVec::const_iterator s = target.begin(); s != target.end(); s++) {
+					maxLengthT = std::max( maxLengthT, s->size() );
+				}
+				// maximal interaction lengths (0 = unrestricted)
+				const size_t intLenQ = (qAcc.val == 'N' || qAccW.val == 0) ? qIntLenMax.val
+						: (qIntLenMax.val == 0 ? qAccW.val : std::min(qIntLenMax.val,qAccW.val));
+				const size_t intLenT = (tAcc.val == 'N' || tAccW.val == 0) ? tIntLenMax.val
+						: (tIntLenMax.val == 0 ? tAccW.val : std::min(tIntLenMax.val,tAccW.val));
+				const size_t limit = (size_t)memLimit.val * 1024 * 1024;
+				// memory estimate for the current setup
+				size_t winW = (windowWidth.val == 0 ? std::max(maxLengthQ,maxLengthT) : windowWidth.val);
+				size_t memEstimate = getMemoryEstimate( maxLengthT, maxLengthQ, winW, winW, predMode.val );
+				// exact predictions in 4D-space are identical in 2D-space
+				if (memEstimate > limit && predMode.val == 'E' && pred.val == 'S'
+					&& getMemoryEstimate( maxLengthT, maxLengthQ, winW, winW, 'M' ) <= limit)
+				{
+					predMode.val = 'M';
+					memEstimate = getMemoryEstimate( maxLengthT, maxLengthQ, winW, winW, predMode.val );
+					LOG(WARNING) <<"--memLimit="<<memLimit.val<<" : switching to --mode=M with the same results but less memory";
 				}
-				if (windowOverlap.val < maxIntLength) {
-					throw error("window-based computation: --windowOverlap ("+toString(windowOverlap.val)+") has to be at least as large as the maximum of --q|tAccW or --q|tIntLenMax ("+toString(maxIntLength)+")");
+				if (memEstimate > limit) {
+					// check if window-based computation can be enabled
+					if (windowWidth.val == 0 && intLenQ > 0 && intLenT > 0) {
+						const size_t overlap = std::max( (size_t)windowOverlap.val, std::max(intLenQ,intLenT) );
+						// binary search for the largest window width within the limit
+						size_t minW = std::max( (size_t)10, overlap+1 ), maxW = winW;
+						while (minW < maxW) {
+							winW = (minW+maxW+1) / 2;
+							memEstimate = getMemoryEstimate( maxLengthT, maxLengthQ, winW, winW, predMode.val );
+							if (memEstimate > limit) {
+								maxW = winW-1;
+							} else {
+								minW = winW;
+							}
+						}
+						memEstimate = getMemoryEstimate( maxLengthT, maxLengthQ, minW, minW, predMode.val );
+						if (memEstimate > limit || (int)minW > windowWidth.max) {
+							throw error("--memLimit="+toString(memLimit.val)+" : even window-based computation (--windowWidth="+toString(minW)+") needs an estimated "+toString(memEstimate/(1024*1024)+1)+" MB");
+						}
+						windowWidth.val = (int)minW;
+						windowOverlap.val = (int)overlap;
+						LOG(WARNING) <<"--memLimit="<<memLimit.val<<" : enabling window-based computation with --windowWidth="<<windowWidth.val<<" --windowOverlap="<<windowOverlap.val;
+					} else {
+						throw error("--memLimit="+toString(memLimit.val)+" : prediction needs an estimated "+toString(memEstimate/(1024*1024)+1)+" MB; restrict the interaction length (--q|tIntLenMax) or the window size (--windowWidth)");
+					}
 				}
-				if (windowWidth.val <= windowOverlap.val) {
-					throw error("window-based computation: --windowWidth ("+toString(windowWidth.val)+") has to exceed --windowOverlap ("+toString(windowOverlap.val)+")");
+#if INTARNA_MULITHREADING
+				// restrict the number of concurrent predictions to the limit
+				const size_t maxThreads = std::max( (size_t)1, limit / std::max( (size_t)1, memEstimate ) );
+				if (getThreads() > maxThreads) {
+					threads.val = (int)maxThreads;
+					LOG(WARNING) <<"--memLimit="<<memLimit.val<<" : reducing the number of threads to --threads="<<threads.val;
 				}
+#endif
 			}
 
 			//////////////// ACCESSIBILITY CONSTRAINTS ///////////////////
@@ -901,7 +1524,7 @@ parse(int argc, char** argv)
 				}
 			} else {
 				// generate empty constraint
-				qAccConstr = std::string(query.at(0).size(),'.');
+				qAccConstr = std::string(query.empty() ? 0 : query.at(0).size(),'.');
 			}
 			// check tAccConstr - target sequence compatibility
 			if (vm.count("tAccConstr") > 0) {
@@ -912,7 +1535,7 @@ parse(int argc, char** argv)
 				}
 			} else {
 				// generate empty constraint
-				tAccConstr = std::string(target.at(0).size(),'.');
+				tAccConstr = std::string(target.empty() ? 0 : target.at(0).size(),'.');
 			}
 
 			// check sanity of accessibility setup
@@ -921,6 +1544,7 @@ parse(int argc, char** argv)
 				if (!qAccFile.empty()) LOG(INFO) <<"qAcc = "<<qAcc.val<<" : ignoring --qAccFile";
 				break;
 			}
+			case 'B' : // drop to next handling
 			case 'E' : // drop to next handling
 			case 'P' : {
 				if (qAccFile.empty()) LOG(INFO) <<"qAcc = "<<qAcc.val<<" but no --qAccFile given";
@@ -939,6 +1563,7 @@ parse(int argc, char** argv)
 				if (!tAccFile.empty()) LOG(INFO) <<"tAcc = "<<tAcc.val<<" : ignoring --tAccFile";
 				break;
 			}
+			case 'B' : // drop to next handling
 			case 'E' : // drop to next handling
 			case 'P' : {
 				if (tAccFile.empty()) LOG(INFO) <<"tAcc = "<<tAcc.val<<" but no --tAccFile given";
@@ -957,6 +1582,16 @@ parse(int argc, char** argv)
 			if (vm.count("energyVRNA") > 0 && energy.val != 'V') {
 				throw error("--energyVRNA provided but no VRNA energy computation (V) requested (--energy = "+toString(energy.val)+")");
 			}
+			if (!energyCacheDir.empty()) {
+				if (energy.val != 'V') {
+					throw error("--energyVRNAcache provided but no VRNA energy computation (V) requested (--energy = "+toString(energy.val)+")");
+				}
+				boost::system::error_code ec;
+				boost::filesystem::create_directories( energyCacheDir, ec );
+				if (ec || !boost::filesystem::is_directory( energyCacheDir )) {
+					throw error("--energyVRNAcache : could not create directory '"+energyCacheDir+"'");
+				}
+			}
 
 			// check qAcc upper bound
 			if (qAccL.val > qAccW.val && qAccW.val != 0) {
@@ -969,8 +1604,8 @@ parse(int argc, char** argv)
 			}
 
 			// check CSV stuff
-			if (outCsvCols != outCsvCols_default && outMode.val != 'C') {
-				throw error("outCsvCols set but outMode != C ("+toString(outMode.val)+")");
+			if (outCsvCols != outCsvCols_default && outMode.val != 'C' && outMode.val != 'B') {
+				throw error("outCsvCols set but outMode != C or B ("+toString(outMode.val)+")");
 			}
 
 			// check output sanity
@@ -990,7 +1625,7 @@ parse(int argc, char** argv)
 
 #if INTARNA_MULITHREADING
 			// check if multi-threading
-			if (threads.val != 1 && getTargetSequences().size() > 1) {
+			if (threads.val != 1 && (getTargetSequences().size() > 1 || targetStream != NULL)) {
 				// warn if >= 4D space prediction enabled
 				if (pred.val != 'S' || predMode.val == 'E') {
 					LOG(WARNING) <<"Multi-threading enabled in high-mem-prediction mode : ensure you have enough memory available!";
@@ -1001,8 +1636,20 @@ parse(int argc, char** argv)
 			}
 #endif
 
-			// trigger initial output handler output
-			initOutputHandler();
+			// dry run : report the estimated costs instead of any computation
+			if (dryRun) {
+				if (targetStream != NULL) {
+					throw error("--dryRun not supported for target batches (--tBatchSize)");
+				}
+				writeDryRun( std::cout );
+				parsingCode = ReturnCode::STOP_ALL_FINE;
+				return parsingCode;
+			}
+
+			// trigger initial output handler output (if not already done by the resumed run)
+			if (parsingCode == ReturnCode::KEEP_GOING && (checkpoint == NULL || checkpoint->getOutputSize() == 0)) {
+				initOutputHandler();
+			}
 
 		} catch (error& e) {
 			LOG(ERROR) <<e.what();
@@ -1015,7 +1662,7 @@ parse(int argc, char** argv)
 
 	// setup new VRNA handler with the given arguments
 	if ( energy.val == 'V') {
-		vrnaHandler = VrnaHandler( temperature.val, (energyFile.size() > 0 ? & energyFile : NULL) );
+		vrnaHandler = VrnaHandler( temperature.val, (energyFile.size() > 0 ? & energyFile : NULL), (energyCacheDir.size() > 0 ? & energyCacheDir : NULL) );
 	}
 
 
@@ -1227,6 +1874,167 @@ parseRegion( const std::string & argName, const std::string & value, const RnaSe
 
 ////////////////////////////////////////////////////////////////////////////
 
+void
+CommandLineParsing::
+removeAmbiguousRuns( const RnaSequenceVec & sequences, IndexRangeListVec & rangeList ) const
+{
+	// automatically detected regions are computed for the whole sequence
+	if (tRegionLenMax.val > 0) {
+		return;
+	}
+	// sequences are handled independently of each other
+#if INTARNA_MULITHREADING
+	# pragma omp parallel for schedule(dynamic) num_threads( getThreads() ) shared(sequences,rangeList) if(sequences.size() > 1)
+#endif
+	for (size_t s=0; s<sequences.size(); s++) {
+		const RnaSequence & seq = sequences.at(s);
+		if (!seq.isAmbiguous()) {
+			continue;
+		}
+		// maximal stretches with non-ambiguous ends that do not contain an
+		// ambiguous run exceeding the maximal interior loop length
+		IndexRangeList feasible;
+		for (size_t i=0; i<seq.size(); i++) {
+			if (seq.isAmbiguous(i)) {
+				continue;
+			}
+			if (!feasible.empty() && i-feasible.rbegin()->to-1 <= (size_t)tIntLoopMax.val) {
+				feasible.rbegin()->to = i;
+			} else {
+				feasible.push_back( IndexRange(i,i) );
+			}
+		}
+		const IndexRangeList ranges = rangeList.at(s).intersect( feasible );
+		if (ranges != rangeList.at(s)) {
+#if INTARNA_MULITHREADING
+			#pragma omp critical(intarna_omp_logOutput)
+#endif
+			{ VLOG(2) <<"skipping ambiguous positions of '"<<seq.getId()<<"' : regions "<<ranges; }
+			rangeList[s] = ranges;
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+CommandLineParsing::
+updateTargetDuplicates()
+{
+	tOrigin.resize( target.size() );
+	tDuplicates.assign( target.size(), std::vector< size_t >() );
+	for (size_t i=0; i<target.size(); i++) {
+		tOrigin[i] = i;
+	}
+
+	// check if results can be reused, i.e. accessibilities are not read from
+	// sequence-specific input and no sequence-specific profiles are written
+	if ( (tAcc.val != 'C' && tAcc.val != 'N') || isPredictionTracked() ) {
+		return;
+	}
+
+	// identify targets with identical sequence and regions
+	// (candidates are indexed by sequence hash and checked for identity)
+	typedef std::multimap< std::pair< RnaSequence::Hash_type, std::string >, size_t > FirstTargetMap;
+	FirstTargetMap firstTarget;
+	for (size_t i=0; i<target.size(); i++) {
+		const FirstTargetMap::key_type key( target.at(i).getHash(), toString(tRegion.at(i)) );
+		std::pair< FirstTargetMap::const_iterator, FirstTargetMap::const_iterator > candidates = firstTarget.equal_range( key );
+		FirstTargetMap::const_iterator first = firstTarget.end();
+		for (FirstTargetMap::const_iterator c = candidates.first; first == firstTarget.end() && c != candidates.second; c++) {
+			if (target.at(c->second).asString() == target.at(i).asString()) {
+				first = c;
+			}
+		}
+		if (first == firstTarget.end()) {
+			firstTarget.insert( FirstTargetMap::value_type( key, i ) );
+		} else {
+			tOrigin[i] = first->second;
+			tDuplicates[first->second].push_back( i );
+			VLOG(1) <<"target '"<<target.at(i).getId()<<"' is identical to target '"<<target.at(first->second).getId()<<"' : reusing its results";
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+CommandLineParsing::
+parseTargetVariants()
+{
+	tReference.resize( target.size() );
+	tVariantPosition.assign( target.size(), std::string::npos );
+	tVariants.assign( target.size(), std::vector< size_t >() );
+	for (size_t i=0; i<target.size(); i++) {
+		tReference[i] = i;
+	}
+
+	// check if nothing given
+	if (tVariantsString.empty()) {
+		return;
+	}
+
+	// ensure single target sequence with computed accessibility
+	if (serverMode) throw std::runtime_error("--tVariants not supported in server mode (--server)");
+	if (tBatchSize.val > 0) throw std::runtime_error("--tVariants not supported for batch-wise target input (--tBatchSize)");
+	if (tShardCount.val > 1) throw std::runtime_error("--tVariants not supported for sharded target input (--tShardCount)");
+	if (target.size() != 1) throw std::runtime_error("--tVariants requires exactly one target sequence but "+toString(target.size())+" are given");
+	if (tAcc.val != 'C' && tAcc.val != 'N') throw std::runtime_error("--tVariants requires computed target accessibilities (--tAcc=C or --tAcc=N)");
+
+	// single point mutation encoding
+	static const boost::regex mutationRegex("^([ACGU])(\\d+)([ACGU])$");
+
+	// copy reference data (target is extended below)
+	const std::string refId = target.at(0).getId();
+	const std::string refSeq = target.at(0).asString();
+	const IndexRangeList refRegion = tRegion.at(0);
+
+	// parse all comma-separated mutations
+	std::set< size_t > mutatedPositions;
+	size_t startPos = 0;
+	while (startPos <= tVariantsString.size()) {
+		size_t splitPos = tVariantsString.find(',',startPos);
+		if (splitPos == std::string::npos) {
+			splitPos = tVariantsString.size();
+		}
+		// convert to upper case RNA encoding
+		std::string mutation = boost::to_upper_copy( tVariantsString.substr( startPos, splitPos-startPos ) );
+		std::replace( mutation.begin(), mutation.end(), 'T', 'U' );
+		boost::smatch match;
+		if (!boost::regex_match( mutation, match, mutationRegex, boost::match_perl )) {
+			throw std::runtime_error("--tVariants : '"+tVariantsString.substr( startPos, splitPos-startPos )+"' is no point mutation encoding like 'A23G'");
+		}
+		const size_t pos = boost::lexical_cast<size_t>( match[2].str() );
+		if (pos < 1 || pos > refSeq.size()) {
+			throw std::runtime_error("--tVariants : position of mutation '"+mutation+"' is out of the target's range [1,"+toString(refSeq.size())+"]");
+		}
+		if (refSeq.at(pos-1) != match[1].str().at(0)) {
+			throw std::runtime_error("--tVariants : mutation '"+mutation+"' does not match the target's nucleotide '"+toString(refSeq.at(pos-1))+"' at position "+toString(pos));
+		}
+		if (match[1].str() == match[3].str()) {
+			throw std::runtime_error("--tVariants : mutation '"+mutation+"' does not alter the target");
+		}
+		if (!mutatedPositions.insert( pos ).second) {
+			throw std::runtime_error("--tVariants : more than one mutation given for position "+toString(pos));
+		}
+
+		// append the variant target
+		std::string varSeq = refSeq;
+		varSeq[pos-1] = match[3].str().at(0);
+		tVariants[0].push_back( target.size() );
+		tReference.push_back( 0 );
+		tVariantPosition.push_back( pos-1 );
+		tVariants.push_back( std::vector< size_t >() );
+		tRegion.push_back( refRegion );
+		target.push_back( RnaSequence( refId+"_"+mutation, varSeq ) );
+
+		startPos = splitPos+1;
+	}
+	VLOG(1) <<"screening "<<tVariants.at(0).size()<<" point mutation variants of target '"<<refId<<"'";
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 const CommandLineParsing::RnaSequenceVec &
 CommandLineParsing::
 getQuerySequences() const
@@ -1275,7 +2083,16 @@ getQueryAccessibility( const size_t sequenceNumber ) const
 	if (sequenceNumber >= getQuerySequences().size()) {
 		throw std::runtime_error("CommandLineParsing::getQueryAccessibility : sequence number "+toString(sequenceNumber)+" is out of range (<"+toString(getQuerySequences().size())+")");
 	}
-	const RnaSequence& seq = getQuerySequences().at(sequenceNumber);
+	return getQueryAccessibility( getQuerySequences().at(sequenceNumber) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+Accessibility*
+CommandLineParsing::
+getQueryAccessibility( const RnaSequence & seq ) const
+{
+	checkIfParsed();
 
 	// create temporary constraint object (will be copied)
 	AccessibilityConstraint accConstraint(seq.size(),0,"","","");
@@ -1293,6 +2110,7 @@ getQueryAccessibility( const size_t sequenceNumber ) const
 										, qIntLenMax.val
 										, &accConstraint );
 
+	case 'B' : // drop to next handling
 	case 'E' : // drop to next handling
 	case 'P' : { // VRNA RNAplfold unpaired probability file output
 		std::istream * accStream = NULL;
@@ -1301,7 +2119,8 @@ getQueryAccessibility( const size_t sequenceNumber ) const
 			accStream = &(std::cin);
 		} else {
 			// file support : add sequence-specific prefix (for multi-sequence input)
-			accFileStream = new std::ifstream( getFullFilename(qAccFile, NULL, &(seq)) );
+			accFileStream = new std::ifstream( getFullFilename(qAccFile, NULL, &(seq)).c_str()
+					, (qAcc.val == 'B' ? std::ios_base::in | std::ios_base::binary : std::ios_base::in) );
 			try {
 				if(!accFileStream->good()){
 					accFileStream->close();
@@ -1320,8 +2139,10 @@ getQueryAccessibility( const size_t sequenceNumber ) const
 										, qIntLenMax.val
 										, &accConstraint
 										, *accStream
-										, (qAcc.val == 'P' ? AccessibilityFromStream::Pu_RNAplfold_Text : AccessibilityFromStream::ED_RNAplfold_Text)
-										, vrnaHandler.getRT() );
+										, (qAcc.val == 'P' ? AccessibilityFromStream::Pu_RNAplfold_Text
+												: (qAcc.val == 'B' ? AccessibilityFromStream::ED_IntaRNA_Binary : AccessibilityFromStream::ED_RNAplfold_Text))
+										, vrnaHandler.getRT()
+										, accLowMem );
 		// cleanup
 		if ( accFileStream != NULL ) {
 			accFileStream->close();
@@ -1349,6 +2170,8 @@ getQueryAccessibility( const size_t sequenceNumber ) const
 							, &accConstraint
 							, vrnaHandler
 							, qAccW.val
+							, accCache
+							, accLowMem
 							);
 		default :
 			INTARNA_NOT_IMPLEMENTED("query accessibility computation not implemented for energy = '"+toString(energy.val)+"'. Disable via --qAcc=N.");
@@ -1363,7 +2186,8 @@ getQueryAccessibility( const size_t sequenceNumber ) const
 
 Accessibility*
 CommandLineParsing::
-getTargetAccessibility( const size_t sequenceNumber ) const
+getTargetAccessibility( const size_t sequenceNumber
+		, const IndexRangeList * const computeRanges ) const
 {
 	checkIfParsed();
 	// input check
@@ -1379,6 +2203,27 @@ getTargetAccessibility( const size_t sequenceNumber ) const
 		throw std::runtime_error(toString("target accessibility constraint : ")+ex.what());
 	}
 
+	// resume : reuse ED values written by the resumed run
+	if (resume && tAcc.val == 'C' && !outPrefix2streamName.at(OutPrefixCode::OP_tAcc).empty()) {
+		const std::string accFile = getFullFilename(outPrefix2streamName.at(OutPrefixCode::OP_tAcc), &(seq), NULL);
+		if ( !boost::iequals(accFile,"STDOUT") && !boost::iequals(accFile,"STDERR") && boost::filesystem::exists( accFile ) ) {
+			VLOG(2) <<"reading ED values for target '"<<seq.getId()<<"' from "<<accFile;
+			std::ifstream accFileStream( accFile.c_str() );
+			if(!accFileStream.good()){
+				throw std::runtime_error("accessibility parsing for --resume : could not open file '"+accFile+"'");
+			}
+			Accessibility * acc = new AccessibilityFromStream( seq
+											, tIntLenMax.val
+											, &accConstraint
+											, accFileStream
+											, AccessibilityFromStream::ED_RNAplfold_Text
+											, vrnaHandler.getRT()
+											, accLowMem );
+			accFileStream.close();
+			return acc;
+		}
+	}
+
 	switch(tAcc.val) {
 
 	case 'N' : // no accessibility
@@ -1386,6 +2231,7 @@ getTargetAccessibility( const size_t sequenceNumber ) const
 										, tIntLenMax.val
 										, &accConstraint );
 
+	case 'B' : // drop to next handling
 	case 'E' : // drop to next handling
 	case 'P' : { // VRNA RNAplfold unpaired probability file output
 		std::istream * accStream = NULL;
@@ -1395,7 +2241,8 @@ getTargetAccessibility( const size_t sequenceNumber ) const
 			accStream = &(std::cin);
 		} else {
 			// file support : add sequence-specific prefix (for multi-sequence input)
-			accFileStream = new std::ifstream( getFullFilename(tAccFile, &(seq), NULL) );
+			accFileStream = new std::ifstream( getFullFilename(tAccFile, &(seq), NULL).c_str()
+					, (tAcc.val == 'B' ? std::ios_base::in | std::ios_base::binary : std::ios_base::in) );
 			try {
 				if(!accFileStream->good()){
 					accFileStream->close();
@@ -1415,8 +2262,10 @@ getTargetAccessibility( const size_t sequenceNumber ) const
 										, tIntLenMax.val
 										, &accConstraint
 										, *accStream
-										, ( tAcc.val == 'P' ? AccessibilityFromStream::Pu_RNAplfold_Text : AccessibilityFromStream::ED_RNAplfold_Text )
-										, vrnaHandler.getRT() );
+										, ( tAcc.val == 'P' ? AccessibilityFromStream::Pu_RNAplfold_Text
+												: ( tAcc.val == 'B' ? AccessibilityFromStream::ED_IntaRNA_Binary : AccessibilityFromStream::ED_RNAplfold_Text ) )
+										, vrnaHandler.getRT()
+										, accLowMem );
 		// cleanup
 		if ( accFileStream != NULL ) {
 			accFileStream->close();
@@ -1424,7 +2273,16 @@ getTargetAccessibility( const size_t sequenceNumber ) const
 		}
 		return acc;
 	}
-	case 'C' : // compute accessibilities
+	case 'C' : { // compute accessibilities
+		// target regions restricted explicitly or to skip ambiguous stretches
+		const bool regionRestricted = !( tRegion.at(sequenceNumber).size() == 1
+											&& tRegion.at(sequenceNumber).begin()->from == 0
+											&& tRegion.at(sequenceNumber).begin()->to+1 >= seq.size() )
+									&& outPrefix2streamName.at(OutPrefixCode::OP_tAcc).empty()
+									&& outPrefix2streamName.at(OutPrefixCode::OP_tPu).empty()
+									&& outPrefix2streamName.at(OutPrefixCode::OP_tAccBin).empty();
+		const IndexRangeList accRanges = (regionRestricted && computeRanges != NULL)
+				? tRegion.at(sequenceNumber).intersect( *computeRanges ) : IndexRangeList();
 		switch( energy.val ) {
 
 		case 'B' : // base-pair based accessibility
@@ -1443,9 +2301,18 @@ getTargetAccessibility( const size_t sequenceNumber ) const
 								, &accConstraint
 								, vrnaHandler
 								, tAccW.val
+								, accCache
+								, accLowMem
+								// restrict computation to the target regions
+								// if no ED values are to be written for the whole sequence
+								// and to the given ranges (e.g. around feasible seeds)
+								, regionRestricted
+									? (computeRanges != NULL ? &accRanges : &(tRegion.at(sequenceNumber)))
+									: computeRanges
 								);
 		default :
 			INTARNA_NOT_IMPLEMENTED("target accessibility computation not implemented for energy = '"+toString(energy.val)+"'. Disable via --tAcc=N.");
+		}
 		} break;
 	default :
 		INTARNA_NOT_IMPLEMENTED("CommandLineParsing::getTargetAccessibility : tAcc = '"+toString(tAcc.val)+"' is not supported");
@@ -1455,67 +2322,478 @@ getTargetAccessibility( const size_t sequenceNumber ) const
 
 ////////////////////////////////////////////////////////////////////////////
 
-InteractionEnergy*
+bool
 CommandLineParsing::
-getEnergyHandler( const Accessibility& accTarget, const ReverseAccessibility& accQuery ) const
+useSeedPrefilter() const
 {
 	checkIfParsed();
+	return seedPrefilter;
+}
 
-	// check whether to compute ES values (for multi-site predictions)
-	const bool initES = std::string("M").find(pred.val) != std::string::npos;
+////////////////////////////////////////////////////////////////////////////
 
-	switch( energy.val ) {
-	case 'B' : return new InteractionEnergyBasePair( accTarget, accQuery, tIntLoopMax.val, qIntLoopMax.val, initES );
-	case 'V' : return new InteractionEnergyVrna( accTarget, accQuery, vrnaHandler, tIntLoopMax.val, qIntLoopMax.val, initES );
-	default :
-		INTARNA_NOT_IMPLEMENTED("CommandLineParsing::getEnergyHandler : energy = '"+toString(energy.val)+"' is not supported");
+IndexRangeList
+CommandLineParsing::
+getTargetSeedRanges( const size_t sequenceNumber
+		, const std::vector< ReverseAccessibility * > & queryAcc ) const
+{
+	checkIfParsed();
+	// input check
+	if (sequenceNumber >= getTargetSequences().size()) {
+		throw std::runtime_error("CommandLineParsing::getTargetSeedRanges : sequence number "+toString(sequenceNumber)+" is out of range (<"+toString(getTargetSequences().size())+")");
+	}
+	const RnaSequence& seq = getTargetSequences().at(sequenceNumber);
+	// maximal interaction length within the target (see getTargetAccessibility())
+	const size_t maxLength = std::min( tIntLenMax.val == 0 ? seq.size() : tIntLenMax.val
+									, tAccW.val == 0 ? seq.size() : tAccW.val );
+
+	// hybridization only : no target accessibility but blocked positions
+	AccessibilityConstraint accConstraint(seq.size(), 0, "","","");
+	try {
+		accConstraint = AccessibilityConstraint(seq.size(), tAccConstr, tAccL.val, "", tShapeMethod, tShapeConversion);
+	} catch (std::exception & ex) {
+		throw std::runtime_error(toString("target accessibility constraint : ")+ex.what());
+	}
+	AccessibilityDisabled targetAcc( seq, maxLength, &accConstraint );
+
+	// number of seed-containing interaction neighborhoods covering each position
+	// (start +1 and end+1 -1)
+	std::vector<int> coverage( seq.size()+1, 0 );
+	size_t anchors = 0;
+	for (size_t q=0; q<queryAcc.size(); q++) {
+		InteractionEnergy * energy = getEnergyHandler( targetAcc, *(queryAcc.at(q)) );
+		INTARNA_CHECK_NOT_NULL(energy,"energy initialization failed");
+		SeedHandler * seedHandler = getSeedHandler( *energy );
+		INTARNA_CHECK_NOT_NULL(seedHandler,"seed handler initialization failed");
+		// compute all seeds
+		if (seedHandler->fillSeed( 0, energy->size1()-1, 0, energy->size2()-1 ) > 0) {
+			const size_t seedBP = seedHandler->getConstraint().getBasePairs();
+			for (size_t i1=0; i1<energy->size1(); i1++) {
+				for (size_t i2=0; i2<energy->size2(); i2++) {
+					if (E_isNotINF( seedHandler->getSeedE( i1, i2 ) )) {
+						// all interactions containing a seed starting in i1
+						coverage[ i1+seedBP > maxLength ? i1+seedBP-maxLength : 0 ]++;
+						coverage[ std::min( seq.size(), i1+maxLength ) ]--;
+						anchors++;
+						break;
+					}
+				}
+			}
+		}
+		INTARNA_CLEANUP( seedHandler );
+		INTARNA_CLEANUP( energy );
+	}
+
+	// collect all covered ranges
+	IndexRangeList seedRanges;
+	int covered = 0;
+	for (size_t i=0; i<seq.size(); i++) {
+		const bool wasCovered = covered > 0;
+		covered += coverage[i];
+		if (covered > 0) {
+			if (wasCovered) {
+				seedRanges.rbegin()->to = i;
+			} else {
+				seedRanges.push_back( IndexRange(i,i) );
+			}
+		}
 	}
-	return NULL;
 
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_logOutput)
+#endif
+	{ VLOG(2) <<"seed prefilter for target '"<<seq.getId()<<"' : "<<anchors<<" seed anchors within "<<seedRanges; }
+
+	return seedRanges;
 }
 
 ////////////////////////////////////////////////////////////////////////////
 
-OutputConstraint
+bool
 CommandLineParsing::
-getOutputConstraint()  const
+useCascade() const
 {
 	checkIfParsed();
-	OutputConstraint::ReportOverlap overlap = OutputConstraint::ReportOverlap::OVERLAP_BOTH;
-	switch(outOverlap.val) {
-	case 'N' : overlap = OutputConstraint::ReportOverlap::OVERLAP_NONE; break;
-	case 'T' : overlap = OutputConstraint::ReportOverlap::OVERLAP_SEQ1; break;
-	case 'Q' : overlap = OutputConstraint::ReportOverlap::OVERLAP_SEQ2; break;
-	case 'B' : overlap = OutputConstraint::ReportOverlap::OVERLAP_BOTH; break;
-	default : throw std::runtime_error("CommandLineParsing::getOutputConstraint() : unsupported outOverlap value "+toString(outOverlap.val));
-	}
-	return OutputConstraint(
-			  outNumber.val
-			, overlap
-			, static_cast<E_type>(outMaxE.val)
-			, static_cast<E_type>(outDeltaE.val)
-			);
+	return cascadeRatio.val < 1.0 || cascadeDeltaE.val < cascadeDeltaE.max;
 }
 
 ////////////////////////////////////////////////////////////////////////////
 
 void
 CommandLineParsing::
-parseSequences(const std::string & paramName,
-					const std::string& paramArg,
-					RnaSequenceVec& sequences,
-					const IndexRangeList & seqSubset )
+getTargetCascadeSites( const size_t sequenceNumber
+		, const std::vector< ReverseAccessibility * > & queryAcc
+		, const std::vector< InteractionEnergyVrna::SequenceData * > & queryData
+		, std::vector< E_type > & coarseE
+		, std::vector< IndexRange > & sites ) const
 {
+	checkIfParsed();
+	// input check
+	if (sequenceNumber >= getTargetSequences().size()) {
+		throw std::runtime_error("CommandLineParsing::getTargetCascadeSites : sequence number "+toString(sequenceNumber)+" is out of range (<"+toString(getTargetSequences().size())+")");
+	}
+	const RnaSequence& seq = getTargetSequences().at(sequenceNumber);
+	// maximal interaction length within the target (see getTargetAccessibility())
+	const size_t maxLength = std::min( tIntLenMax.val == 0 ? seq.size() : tIntLenMax.val
+									, tAccW.val == 0 ? seq.size() : tAccW.val );
 
-	// clear sequence container
-	sequences.clear();
+	// hybridization only : no target accessibility but blocked positions
+	AccessibilityConstraint accConstraint(seq.size(), 0, "","","");
+	try {
+		accConstraint = AccessibilityConstraint(seq.size(), tAccConstr, tAccL.val, "", tShapeMethod, tShapeConversion);
+	} catch (std::exception & ex) {
+		throw std::runtime_error(toString("target accessibility constraint : ")+ex.what());
+	}
+	AccessibilityDisabled targetAcc( seq, maxLength, &accConstraint );
+
+	coarseE.assign( queryAcc.size(), E_INF );
+	sites.assign( queryAcc.size(), IndexRange() );
+	for (size_t q=0; q<queryAcc.size(); q++) {
+		InteractionEnergy * energy = getEnergyHandler( targetAcc, *(queryAcc.at(q)), queryData.at(q) );
+		INTARNA_CHECK_NOT_NULL(energy,"energy initialization failed");
+		// heuristic mfe prediction
+		OutputHandlerInteractionList mfe( 1 );
+		Predictor * predictor = noSeedRequired
+				? static_cast<Predictor*>(new PredictorMfe2dHeuristic( *energy, mfe, NULL ))
+				: static_cast<Predictor*>(new PredictorMfe2dHeuristicSeed( *energy, mfe, NULL, getSeedHandler( *energy ) ));
+		predictor->predict( IndexRange(0,RnaSequence::lastPos)
+						, IndexRange(0,RnaSequence::lastPos)
+						, OutputConstraint( 1, OutputConstraint::OVERLAP_BOTH, static_cast<E_type>(outMaxE.val) ) );
+		INTARNA_CLEANUP( predictor );
+		if (!mfe.empty() && !(*mfe.begin())->basePairs.empty()) {
+			const Interaction & interaction = **mfe.begin();
+			coarseE[q] = interaction.energy;
+			// all interactions of maximal length covering the coarse site
+			const size_t from = interaction.basePairs.begin()->first;
+			const size_t to = interaction.basePairs.rbegin()->first;
+			sites[q] = IndexRange( to+1 > maxLength ? to+1-maxLength : 0
+								, std::min( seq.size(), from+maxLength )-1 );
+		}
+		INTARNA_CLEANUP( energy );
+	}
+}
 
-	// read FASTA from STDIN stream
-	if (boost::iequals(paramArg,"STDIN")) {
-		parseSequencesFasta(paramName, std::cin, sequences, seqSubset);
-	} else
-	if (RnaSequence::isValidSequenceIUPAC(paramArg)) {
-		// check if sequence is to be stored
+////////////////////////////////////////////////////////////////////////////
+
+E_type
+CommandLineParsing::
+getCascadeMaxE( const std::vector< E_type > & coarseE ) const
+{
+	checkIfParsed();
+	// all combinations with a coarse interaction
+	std::vector< E_type > sortedE;
+	sortedE.reserve( coarseE.size() );
+	for (size_t i=0; i<coarseE.size(); i++) {
+		if (E_isNotINF( coarseE.at(i) )) {
+			sortedE.push_back( coarseE.at(i) );
+		}
+	}
+	if (sortedE.empty()) {
+		return E_INF;
+	}
+	std::sort( sortedE.begin(), sortedE.end() );
+	// energy of the last combination within the best cascadeRatio fraction
+	const size_t passed = std::max<size_t>( 1, (size_t)std::ceil( cascadeRatio.val * (double)coarseE.size() ) );
+	const E_type ratioE = sortedE.at( std::min( passed, sortedE.size() )-1 );
+	// restricted to the energy margin of the best combination
+	if (cascadeDeltaE.val < cascadeDeltaE.max) {
+		return std::min( ratioE, sortedE.at(0) + static_cast<E_type>(cascadeDeltaE.val) );
+	}
+	return ratioE;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+AccessibilityVariant*
+CommandLineParsing::
+getTargetVariantAccessibility( const size_t sequenceNumber, const Accessibility & referenceAcc ) const
+{
+	checkIfParsed();
+	// input check
+	if (sequenceNumber >= getTargetSequences().size() || !isTargetVariant(sequenceNumber)) {
+		throw std::runtime_error("CommandLineParsing::getTargetVariantAccessibility : sequence number "+toString(sequenceNumber)+" is no variant target");
+	}
+	const RnaSequence& seq = getTargetSequences().at(sequenceNumber);
+	const size_t pos = tVariantPosition.at(sequenceNumber);
+
+	// without accessibility, only interactions adjacent to the mutation are altered
+	IndexRange affected( (pos==0 ? 0 : pos-1), std::min( pos+1, seq.size()-1 ) );
+	Accessibility * variantAcc = NULL;
+
+	if (tAcc.val == 'C' && energy.val == 'V') {
+		// RNAplfold-like ED values are only altered for regions within windows covering the mutation
+		const size_t windowSize = (tAccW.val == 0 ? seq.size() : std::min<size_t>( tAccW.val, seq.size() ));
+		affected.from = (pos+1 < windowSize) ? 0 : pos+1-windowSize;
+		affected.to = std::min( pos+windowSize-1, seq.size()-1 );
+		IndexRangeList computeRanges;
+		computeRanges.push_back( affected );
+		// create temporary constraint object (will be copied)
+		AccessibilityConstraint accConstraint(seq.size(), 0, "","","");
+		try {
+			accConstraint = AccessibilityConstraint(seq.size(), tAccConstr, tAccL.val, tShape, tShapeMethod, tShapeConversion);
+		} catch (std::exception & ex) {
+			throw std::runtime_error(toString("target accessibility constraint : ")+ex.what());
+		}
+		// compute ED values for the affected range only
+		variantAcc = new AccessibilityVrna(
+							seq
+							, std::min( tIntLenMax.val == 0 ? seq.size() : tIntLenMax.val
+									, tAccW.val == 0 ? seq.size() : tAccW.val )
+							, &accConstraint
+							, vrnaHandler
+							, tAccW.val
+							, NULL
+							, accLowMem
+							, &computeRanges
+							);
+	} else {
+		// full recomputation
+		variantAcc = getTargetAccessibility( sequenceNumber );
+		if (tAcc.val != 'N') {
+			affected = IndexRange( 0, seq.size()-1 );
+		}
+	}
+	INTARNA_CHECK_NOT_NULL(variantAcc,"variant target initialization failed");
+
+	return new AccessibilityVariant( referenceAcc, variantAcc, affected );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+Accessibility*
+CommandLineParsing::
+getTargetBlockedAccessibility( const size_t sequenceNumber, const Accessibility & referenceAcc, const IndexRange & blocked ) const
+{
+	checkIfParsed();
+	// input check
+	if (sequenceNumber >= getTargetSequences().size()) {
+		throw std::runtime_error("CommandLineParsing::getTargetBlockedAccessibility : sequence number "+toString(sequenceNumber)+" is out of range (<"+toString(getTargetSequences().size())+")");
+	}
+	return getBlockedAccessibility( getTargetSequences().at(sequenceNumber), referenceAcc, blocked
+			, tAcc.val, tAccW.val, tAccL.val, tIntLenMax.val
+			, tAccConstr, tShape, tShapeMethod, tShapeConversion );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+Accessibility*
+CommandLineParsing::
+getQueryBlockedAccessibility( const size_t sequenceNumber, const Accessibility & referenceAcc, const IndexRange & blocked ) const
+{
+	checkIfParsed();
+	// input check
+	if (sequenceNumber >= getQuerySequences().size()) {
+		throw std::runtime_error("CommandLineParsing::getQueryBlockedAccessibility : sequence number "+toString(sequenceNumber)+" is out of range (<"+toString(getQuerySequences().size())+")");
+	}
+	return getBlockedAccessibility( getQuerySequences().at(sequenceNumber), referenceAcc, blocked
+			, qAcc.val, qAccW.val, qAccL.val, qIntLenMax.val
+			, qAccConstr, qShape, qShapeMethod, qShapeConversion );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+Accessibility*
+CommandLineParsing::
+getBlockedAccessibility( const RnaSequence & seq
+				, const Accessibility & referenceAcc
+				, const IndexRange & blocked
+				, const char acc
+				, const size_t accW
+				, const size_t accL
+				, const size_t intLenMax
+				, const std::string & accConstr
+				, const std::string & shape
+				, const std::string & shapeMethod
+				, const std::string & shapeConversion ) const
+{
+	// input check
+	if (!blocked.isAscending() || blocked.to >= seq.size()) {
+		throw std::runtime_error("CommandLineParsing::getBlockedAccessibility : blocked range "+toString(blocked)+" is out of the range of sequence '"+seq.getId()+"'");
+	}
+	// create temporary constraint object (will be copied)
+	AccessibilityConstraint accConstraint(seq.size(), 0, "","","");
+	try {
+		accConstraint = AccessibilityConstraint(seq.size(), accConstr, accL, shape, shapeMethod, shapeConversion);
+	} catch (std::exception & ex) {
+		throw std::runtime_error(toString("accessibility constraint : ")+ex.what());
+	}
+	accConstraint.addBlocked( blocked );
+	// maximal interaction length (see getTargetAccessibility())
+	const size_t maxLength = std::min( intLenMax == 0 ? seq.size() : intLenMax
+									, accW == 0 ? seq.size() : accW );
+
+	switch(acc) {
+
+	case 'N' : // no accessibility
+		return new AccessibilityDisabled( seq, intLenMax, &accConstraint );
+
+	case 'C' : // compute accessibilities
+		switch( energy.val ) {
+
+		case 'V' : { // VRNA-based accessibilities
+			if (accW == 0 || accW >= seq.size()) {
+				// global folding : all ED values are altered
+				return new AccessibilityVrna( seq, maxLength, &accConstraint, vrnaHandler, accW, NULL, accLowMem );
+			}
+			// RNAplfold-like ED values are only altered for regions within windows covering the blocked range
+			IndexRangeList computeRanges;
+			computeRanges.push_back( IndexRange( (blocked.from+1 < accW) ? 0 : blocked.from+1-accW
+												, std::min( blocked.to+accW-1, seq.size()-1 ) ) );
+			// compute ED values for the affected range only
+			Accessibility * blockedAcc = new AccessibilityVrna( seq, maxLength, &accConstraint, vrnaHandler, accW, NULL, accLowMem, &computeRanges );
+			return new AccessibilityVariant( referenceAcc, blockedAcc, *(computeRanges.begin()) );
+		}
+		default :
+			INTARNA_NOT_IMPLEMENTED("accessibility computation not implemented for energy = '"+toString(energy.val)+"'");
+		} break;
+	default :
+		INTARNA_NOT_IMPLEMENTED("CommandLineParsing::getBlockedAccessibility : accessibility mode '"+toString(acc)+"' is not supported");
+	}
+	return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+InteractionEnergy*
+CommandLineParsing::
+getEnergyHandler( const Accessibility& accTarget
+				, const ReverseAccessibility& accQuery
+				, const InteractionEnergyVrna::SequenceData * queryData ) const
+{
+	checkIfParsed();
+
+	// check whether to compute ES values (for multi-site predictions)
+	const bool initES = std::string("M").find(pred.val) != std::string::npos;
+
+	switch( energy.val ) {
+	case 'B' : return new InteractionEnergyBasePair( accTarget, accQuery, tIntLoopMax.val, qIntLoopMax.val, initES );
+	case 'V' : return new InteractionEnergyVrna( accTarget, accQuery, vrnaHandler, tIntLoopMax.val, qIntLoopMax.val, initES, queryData );
+	default :
+		INTARNA_NOT_IMPLEMENTED("CommandLineParsing::getEnergyHandler : energy = '"+toString(energy.val)+"' is not supported");
+	}
+	return NULL;
+
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+InteractionEnergyVrna::SequenceData*
+CommandLineParsing::
+getQueryEnergyData( const ReverseAccessibility& accQuery ) const
+{
+	checkIfParsed();
+
+	// check whether to compute ES values (for multi-site predictions)
+	const bool initES = std::string("M").find(pred.val) != std::string::npos;
+
+	switch( energy.val ) {
+	case 'V' : return new InteractionEnergyVrna::SequenceData( accQuery, vrnaHandler, initES );
+	default : return NULL;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+OutputConstraint
+CommandLineParsing::
+getOutputConstraint()  const
+{
+	checkIfParsed();
+	OutputConstraint::ReportOverlap overlap = OutputConstraint::ReportOverlap::OVERLAP_BOTH;
+	switch(outOverlap.val) {
+	case 'N' : overlap = OutputConstraint::ReportOverlap::OVERLAP_NONE; break;
+	case 'T' : overlap = OutputConstraint::ReportOverlap::OVERLAP_SEQ1; break;
+	case 'Q' : overlap = OutputConstraint::ReportOverlap::OVERLAP_SEQ2; break;
+	case 'B' : overlap = OutputConstraint::ReportOverlap::OVERLAP_BOTH; break;
+	default : throw std::runtime_error("CommandLineParsing::getOutputConstraint() : unsupported outOverlap value "+toString(outOverlap.val));
+	}
+	return OutputConstraint(
+			  outNumber.val
+			, overlap
+			, static_cast<E_type>(outMaxE.val)
+			, static_cast<E_type>(outDeltaE.val)
+			);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+OutputConstraint
+CommandLineParsing::
+getOutputConstraint( const E_type bestE, const bool symmetric )  const
+{
+	const OutputConstraint outConstraint = getOutputConstraint();
+	// trackers have to be informed about all interactions
+	const bool reportSymmetric = symmetric && !isPredictionTracked();
+	// heuristic predictions are not restricted
+	if (predMode.val == 'H' || predMode.val == 'A' || E_isINF(bestE)) {
+		return OutputConstraint(
+				  outConstraint.reportMax
+				, outConstraint.reportOverlap
+				, outConstraint.maxE
+				, outConstraint.deltaE
+				, reportSymmetric
+				);
+	}
+	// restrict to interactions with energy lower or equal to bestE
+	return OutputConstraint(
+			  outConstraint.reportMax
+			, outConstraint.reportOverlap
+			, std::min( outConstraint.maxE, std::nextafter( bestE, E_INF ) )
+			, outConstraint.deltaE
+			, reportSymmetric
+			);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+size_t
+CommandLineParsing::
+getSelfInteractionQuery( const size_t sequenceNumber ) const
+{
+	checkIfParsed();
+	if (selfInteraction) {
+		for (size_t q=0; q<query.size(); q++) {
+			if (isSelfInteraction( sequenceNumber, q )) {
+				return q;
+			}
+		}
+	}
+	return query.size();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+CommandLineParsing::
+isSelfInteraction( const size_t targetNumber, const size_t queryNumber ) const
+{
+	checkIfParsed();
+	return selfInteraction
+			&& target.at(targetNumber).asString() == query.at(queryNumber).asString();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+CommandLineParsing::
+parseSequences(const std::string & paramName,
+					const std::string& paramArg,
+					RnaSequenceVec& sequences,
+					const IndexRangeList & seqSubset )
+{
+
+	// clear sequence container
+	sequences.clear();
+
+	// number of FASTA records read
+	size_t seqNumber = 0;
+
+	// read FASTA from STDIN stream
+	if (boost::iequals(paramArg,"STDIN")) {
+		parseSequencesFasta(paramName, std::cin, sequences, seqSubset, seqNumber);
+	} else
+	if (RnaSequence::isValidSequenceIUPAC(paramArg)) {
+		// check if sequence is to be stored
 		if (seqSubset.empty() || seqSubset.covers(1)) {
 			// direct sequence input
 			sequences.push_back(RnaSequence(paramName,paramArg));
@@ -1535,21 +2813,67 @@ parseSequences(const std::string & paramName,
 
 	} else
 	{
-		// open file handle
-		std::ifstream infile(paramArg);
 		try {
-			if(!infile.good()){
-				LOG(ERROR) <<"FASTA parsing of "<<paramName<<" : could not open FASTA file  '"<<paramArg<<"'";
-				updateParsingCode( ReturnCode::STOP_PARSING_ERROR );
-			} else {
-				parseSequencesFasta(paramName, infile, sequences, seqSubset);
+			// random access to the records of the mapped FASTA file
+			FastaReader fasta( paramArg );
+			seqNumber = fasta.size();
+			// the records within the subset (others are not read at all)
+			std::vector< size_t > records;
+			for (size_t i=0; i<fasta.size(); i++) {
+				// check if no further sequence is within the subset
+				if (!seqSubset.empty() && seqSubset.rbegin()->to < i+1) {
+					break;
+				}
+				if (seqSubset.empty() || seqSubset.covers(i+1)) {
+					records.push_back( i );
+				}
+			}
+			// read and encode the records independently of each other
+			sequences.resize( records.size(), RnaSequence( paramName, "N" ) );
+			// the errors of the records (reported in input order)
+			std::vector< std::string > failed( records.size() );
+#if INTARNA_MULITHREADING
+			# pragma omp parallel for schedule(dynamic) num_threads( getThreads() ) shared(fasta,records,sequences,failed) if(records.size() > 1)
+#endif
+			for (size_t r=0; r<records.size(); r++) {
+				try {
+					std::string sequence;
+					fasta.getSequence( records.at(r), sequence );
+					if (sequence.empty()) {
+						failed[r] = "FASTA parsing of "+paramName+" : no sequence for ID '"+fasta.getId(records.at(r))+"'";
+					} else {
+						sequences[r] = RnaSequence( fasta.getId(records.at(r)), sequence );
+					}
+				} catch (std::exception & ex) {
+					failed[r] = "error while FASTA parsing of "+paramName+" : "+ex.what();
+				}
+			}
+			// report errors and remove the according records
+			size_t stored = 0;
+			for (size_t r=0; r<records.size(); r++) {
+				if (failed.at(r).empty()) {
+					if (stored < r) {
+						sequences[stored] = sequences.at(r);
+					}
+					stored++;
+				} else {
+					LOG(ERROR) <<failed.at(r);
+					updateParsingCode( ReturnCode::STOP_PARSING_ERROR );
+				}
+			}
+			sequences.resize( stored, RnaSequence( paramName, "N" ) );
+			// check if sequence index range is within number of sequences
+			if (!seqSubset.empty()
+					&& seqSubset.rbegin()->to < IndexRange::LAST_INDEX
+					&& seqSubset.rbegin()->to > seqNumber)
+			{
+				// provide user warning of maybe wrongly defined sequence subset
+				LOG(WARNING) <<"Sequence subset definition "<<seqSubset<<" exceeds sequence number "<<seqNumber<<" for parameter "<<paramName;
 			}
 		} catch (std::exception & ex) {
 			LOG(ERROR) <<"error while FASTA parsing of "<<paramName<<" : "<<ex.what();
 			updateParsingCode( ReturnCode::STOP_PARSING_ERROR );
 		}
-		// close stream
-		infile.close();
 	}
 
 	// holds current validation status to supress checks once a validation failed
@@ -1565,20 +2889,41 @@ parseSequences(const std::string & paramName,
 
 ////////////////////////////////////////////////////////////////////////////
 
-void
+bool
 CommandLineParsing::
 parseSequencesFasta( const std::string & paramName,
 					std::istream& input,
 					RnaSequenceVec& sequences,
-					const IndexRangeList & seqSubset)
+					const IndexRangeList & seqSubset,
+					size_t & seqNumber,
+					const size_t maxToStore )
 {
 	// temporary variables
 	std::string line, name, sequence;
 	int trimStart = 0;
-	size_t seqNumber = 0;
+	// maximal size of the container when parsing is to be stopped
+	const size_t maxSize = maxToStore == 0 ? std::numeric_limits<size_t>::max() : sequences.size()+maxToStore;
+	// whether or not all relevant data was read
+	bool inputComplete = true;
 
 	// read linewise
-	while( std::getline( input, line ) ) {
+	while( true ) {
+		// check if a new record starts after the current one
+		if ( !name.empty() && input.peek() == '>' ) {
+			// check if no further sequence is within the subset
+			if (!seqSubset.empty() && seqSubset.rbegin()->to <= seqNumber+1) {
+				break;
+			}
+			// check if the current record completes the container
+			if ( sequences.size()+1 >= maxSize && (seqSubset.empty() || seqSubset.covers(seqNumber+1)) ) {
+				inputComplete = false;
+				break;
+			}
+		}
+		// read next line
+		if (!std::getline( input, line )) {
+			break;
+		}
 		// ignore empty lines
 		if( line.empty() ) {
 			continue;
@@ -1648,13 +2993,397 @@ parseSequencesFasta( const std::string & paramName,
 		}
 	}
 
-	// check if sequence index range is within number of sequences
-	if (!seqSubset.empty()
-			&& seqSubset.rbegin()->to < IndexRange::LAST_INDEX
-			&& seqSubset.rbegin()->to > seqNumber)
-	{
-		// provide user warning of maybe wrongly defined sequence subset
-		LOG(WARNING) <<"Sequence subset definition "<<seqSubset<<" exceeds sequence number "<<seqNumber<<" for parameter "<<paramName;
+	// check if sequence index range is within number of sequences
+	if (inputComplete
+			&& !seqSubset.empty()
+			&& seqSubset.rbegin()->to < IndexRange::LAST_INDEX
+			&& seqSubset.rbegin()->to > seqNumber)
+	{
+		// provide user warning of maybe wrongly defined sequence subset
+		LOG(WARNING) <<"Sequence subset definition "<<seqSubset<<" exceeds sequence number "<<seqNumber<<" for parameter "<<paramName;
+	}
+
+	return inputComplete;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+CommandLineParsing::
+readTargetBatch()
+{
+	// remove old data
+	target.clear();
+
+	if (targetStream == NULL) {
+		return;
+	}
+
+	// read next batch
+	const bool inputComplete = parseSequencesFasta("target", *targetStream, target, tSet, targetStreamRecords, tBatchSize.val );
+	if (parsingCode == ReturnCode::STOP_PARSING_ERROR) {
+		throw std::runtime_error("FASTA parsing of target sequences failed");
+	}
+
+	// close input if all read
+	if (inputComplete) {
+		if (targetStream != &(std::cin)) {
+			 INTARNA_CLEANUP(targetStream);
+		}
+		targetStream = NULL;
+	}
+
+	// ensure at least one sequence was parsed for the first batch
+	if (targetBatchOffset == 0 && !validateSequenceNumber("target", target, 1, 999999)) {
+		throw std::runtime_error("no target sequence found");
+	}
+	// validate alphabet
+	if (!validateSequenceAlphabet("target", target)) {
+		throw std::runtime_error("invalid target sequence alphabet");
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+CommandLineParsing::
+selectTargetShard()
+{
+	// cost of all queries (query length sum)
+	size_t queryCost = 0;
+	for (auto q = query.begin(); q != query.end(); q++) {
+		queryCost += q->size();
+	}
+
+	// sort targets by decreasing cost : (length, index) pairs
+	std::vector< std::pair<size_t,size_t> > byCost( target.size() );
+	for (size_t t=0; t<target.size(); t++) {
+		byCost[t] = std::make_pair( target.at(t).size(), t );
+	}
+	std::sort( byCost.begin(), byCost.end(), std::greater< std::pair<size_t,size_t> >() );
+
+	// assign each target to the shard with lowest cost so far
+	// (longest processing time first scheduling)
+	std::vector<size_t> shardCost( tShardCount.val, 0 );
+	std::vector<size_t> targetShard( target.size(), 0 );
+	for (auto t = byCost.begin(); t != byCost.end(); t++) {
+		const size_t shard = std::min_element( shardCost.begin(), shardCost.end() ) - shardCost.begin();
+		targetShard[t->second] = shard;
+		shardCost[shard] += t->first * queryCost;
+	}
+
+	// keep only the targets of this shard in input order
+	RnaSequenceVec allTargets;
+	allTargets.swap( target );
+	tShardTargets.clear();
+	for (size_t t=0; t<allTargets.size(); t++) {
+		if (targetShard.at(t)+1 == (size_t)tShardIndex.val) {
+			target.push_back( allTargets.at(t) );
+			tShardTargets.push_back( t );
+		}
+	}
+
+	if (target.empty()) {
+		LOG(WARNING) <<"no target sequence assigned to shard "<<tShardIndex.val<<" of "<<tShardCount.val;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+CommandLineParsing::
+parseNextTargetBatch()
+{
+	checkIfParsed();
+
+	// check if further data is available
+	if (targetStream == NULL) {
+		return false;
+	}
+
+	// update index offset
+	targetBatchOffset += target.size();
+
+	// read next batch
+	readTargetBatch();
+
+	// check if nothing left
+	if (target.empty()) {
+		return false;
+	}
+
+	// check for minimal sequence length (>=seedBP)
+	if (!noSeedRequired) {
+		for( size_t i=0; i<target.size(); i++) {
+			if (target.at(i).size() < (size_t)seedBP.val) {
+				throw std::runtime_error("length of target sequence "+toString(targetBatchOffset+i+1)+" is below minimal number of seed base pairs (seedBP="+toString(seedBP.val)+")");
+			}
+		}
+	}
+
+	// validate accessibility input from file
+	validate_tAccFile( tAccFile );
+	if (parsingCode == ReturnCode::STOP_PARSING_ERROR) {
+		throw std::runtime_error("target accessibility file validation failed");
+	}
+
+	// setup full ranges for all targets of the batch
+	parseRegion( "tRegion", tRegionString, target, tRegion );
+	removeAmbiguousRuns( target, tRegion );
+	parseTargetVariants();
+	updateTargetDuplicates();
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+CommandLineParsing::
+parseNextRequest()
+{
+	checkIfParsed();
+
+	// sweep mode : command line input for each valid parameter set
+	if (!sweepSets.empty()) {
+		while( requestNumber < sweepSets.size() ) {
+			const std::string & sweepSet = sweepSets.at(requestNumber);
+			requestNumber++;
+			try {
+				parseSweepSet( sweepSet );
+				getOutputStream() <<"#SWEEP "<<requestNumber<<" : "<<sweepSet <<"\n";
+				return true;
+			} catch (std::exception & e) {
+				// report error and continue with next parameter set
+				getOutputStream() <<"#ERROR : parameter set '"<<sweepSet<<"' : "<<e.what() <<"\n";
+				finishRequest();
+			}
+		}
+		// no further parameter set available
+		return false;
+	}
+
+	// without server mode : command line input is the only request
+	if (!serverMode) {
+		requestNumber++;
+		return requestNumber == 1;
+	}
+
+	// read requests until a valid one is found
+	std::string request;
+	while( std::getline( std::cin, request ) ) {
+		boost::trim(request);
+		// skip empty and comment lines
+		if (request.empty() || request.at(0) == '#') {
+			continue;
+		}
+		try {
+			parseRequest( request );
+			requestNumber++;
+			return true;
+		} catch (std::exception & e) {
+			// report error and continue with next request
+			getOutputStream() <<"#ERROR : request '"<<request<<"' : "<<e.what() <<"\n";
+			finishRequest();
+		}
+	}
+
+	// no further request available
+	return false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+CommandLineParsing::
+parseRequest( const std::string & request )
+{
+	// split request into query and target sequence
+	std::istringstream requestStream( request );
+	std::string querySeq, targetSeq, tail;
+	requestStream >>querySeq >>targetSeq >>tail;
+	if (targetSeq.empty() || !tail.empty()) {
+		throw std::runtime_error("has to provide a query and a target sequence separated by whitespace");
+	}
+	if (!RnaSequence::isValidSequenceIUPAC(querySeq)) {
+		throw std::runtime_error("query is no valid RNA sequence using IUPAC nucleotide encoding");
+	}
+	if (!RnaSequence::isValidSequenceIUPAC(targetSeq)) {
+		throw std::runtime_error("target is no valid RNA sequence using IUPAC nucleotide encoding");
+	}
+
+	// check for minimal sequence length (>=seedBP)
+	if (!noSeedRequired) {
+		if (querySeq.size() < (size_t)seedBP.val) {
+			throw std::runtime_error("length of query sequence is below minimal number of seed base pairs (seedBP="+toString(seedBP.val)+")");
+		}
+		if (targetSeq.size() < (size_t)seedBP.val) {
+			throw std::runtime_error("length of target sequence is below minimal number of seed base pairs (seedBP="+toString(seedBP.val)+")");
+		}
+	}
+
+	// replace current sequences
+	query.clear();
+	query.push_back( RnaSequence("query", querySeq) );
+	target.clear();
+	target.push_back( RnaSequence("target", targetSeq) );
+
+	// generate empty accessibility constraints for the new sequences
+	qAccConstr = std::string(querySeq.size(),'.');
+	tAccConstr = std::string(targetSeq.size(),'.');
+
+	// setup full ranges for the new sequences
+	parseRegion( "qRegion", qRegionString, query, qRegion );
+	parseRegion( "tRegion", tRegionString, target, tRegion );
+	removeAmbiguousRuns( target, tRegion );
+	parseTargetVariants();
+	updateTargetDuplicates();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+CommandLineParsing::
+validateParameterCombinations() const
+{
+	using namespace boost::program_options;
+
+	// check for minimal sequence length (>=seedBP)
+	if (!noSeedRequired) {
+		for( size_t i=0; i<query.size(); i++) {
+			if (query.at(i).size() < seedBP.val) {
+				throw error("length of query sequence "+toString(i+1)+" is below minimal number of seed base pairs (seedBP="+toString(seedBP.val)+")");
+			}
+		}
+		for( size_t i=0; i<target.size(); i++) {
+			if (target.at(i).size() < seedBP.val) {
+				throw error("length of target sequence "+toString(i+1)+" is below minimal number of seed base pairs (seedBP="+toString(seedBP.val)+")");
+			}
+		}
+	}
+
+	if (selfInteraction) {
+		// symmetric interactions have to be subject to the same constraints
+		if (tIntLenMax.val != qIntLenMax.val || tIntLoopMax.val != qIntLoopMax.val) {
+			throw error("--selfInteraction requires identical target and query interaction length and loop restrictions (--tIntLenMax/--qIntLenMax, --tIntLoopMax/--qIntLoopMax)");
+		}
+		if ((seedTMaxUP.val<0 ? seedMaxUP.val : seedTMaxUP.val) != (seedQMaxUP.val<0 ? seedMaxUP.val : seedQMaxUP.val)
+			|| !seedTRange.empty() || !seedQRange.empty() || !seedTQ.empty())
+		{
+			throw error("--selfInteraction requires identical target and query seed constraints (--seedTMaxUP/--seedQMaxUP, no --seedTRange/--seedQRange/--seedTQ)");
+		}
+		if (!tRegionString.empty() || !qRegionString.empty()) {
+			throw error("--selfInteraction does not support --tRegion or --qRegion");
+		}
+		// the target accessibility is replaced by the query's, such that
+		// differing target settings would be ignored
+		if (tAcc.val != qAcc.val || tAccW.val != qAccW.val || tAccL.val != qAccL.val
+			|| tAccConstr != qAccConstr || tAccFile != qAccFile
+			|| tShape != qShape || tShapeMethod != qShapeMethod || tShapeConversion != qShapeConversion)
+		{
+			throw error("--selfInteraction requires identical target and query accessibility settings (--tAcc/--qAcc, --tAccW/--qAccW, --tAccL/--qAccL, --tAccConstr/--qAccConstr, --tAccFile/--qAccFile, --tShape/--qShape, --tShapeMethod/--qShapeMethod, --tShapeConversion/--qShapeConversion)");
+		}
+	}
+
+	// check if window-based computation enabled
+	if (windowWidth.val > 0) {
+		// minimal window width
+		if (windowWidth.val < 10) {
+			throw error("window-based computation: --windowWidth should be at least 10 but is "+toString(windowWidth.val));
+		}
+		// ensure interaction length is restricted
+		size_t maxIntLength = 0;
+		if (qAcc.val != 'N') { // check if accessibility computation enabled
+			if (qIntLenMax.val == 0 && qAccW.val == 0) {
+				throw error("window-based computation: maximal query interaction length has to be restricted either via --qAccW or --qIntLenMax");
+			} else { // update maximum
+				maxIntLength = std::max(qIntLenMax.val, qAccW.val);
+			}
+		} else { // max interaction length of query
+			if (qIntLenMax.val == 0) {
+				throw error("window-based computation: maximal query interaction length has to be restricted via --qIntLenMax");
+			} else {
+				maxIntLength = qIntLenMax.val;
+			}
+		}
+		if (tAcc.val != 'N') {
+			if (tIntLenMax.val == 0 && tAccW.val == 0) {
+				throw error("window-based computation: maximal target interaction length has to be restricted either via --tAccW or --tIntLenMax");
+			} else { // update maximum
+				maxIntLength = maxIntLength < std::max(tAccW.val,tIntLenMax.val) ? std::max(tAccW.val,tIntLenMax.val) : maxIntLength;
+			}
+		} else {
+			if (tIntLenMax.val == 0) {
+				throw error("window-based computation: maximal target interaction length has to be restricted via --tIntLenMax");
+			} else { // update maximum
+				maxIntLength = maxIntLength < tIntLenMax.val ? tIntLenMax.val : maxIntLength;
+			}
+		}
+		if (windowOverlap.val < maxIntLength) {
+			throw error("window-based computation: --windowOverlap ("+toString(windowOverlap.val)+") has to be at least as large as the maximum of --q|tAccW or --q|tIntLenMax ("+toString(maxIntLength)+")");
+		}
+		if (windowWidth.val <= windowOverlap.val) {
+			throw error("window-based computation: --windowWidth ("+toString(windowWidth.val)+") has to exceed --windowOverlap ("+toString(windowOverlap.val)+")");
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+CommandLineParsing::
+parseSweepSet( const std::string & sweepSet )
+{
+	using namespace boost::program_options;
+
+	// validation errors are reported via the parsing code
+	const ReturnCode lastParsingCode = parsingCode;
+	try {
+		// the set's arguments are stored first and thus take precedence
+		variables_map vm;
+		store( command_line_parser( split_unix( sweepSet ) ).options( opts_sweep ).run(), vm );
+		store( command_line_parser( split_unix( sweepBase ) ).options( opts_sweep ).run(), vm );
+		notify( vm );
+	} catch (error & e) {
+		throw std::runtime_error( e.what() );
+	}
+	if (parsingCode != lastParsingCode) {
+		parsingCode = lastParsingCode;
+		throw std::runtime_error("invalid parameter value");
+	}
+
+	// seed constraint has to be recreated for the new parameters
+	INTARNA_CLEANUP(seedConstraint);
+
+	// check the same parameter combinations as parse()
+	try {
+		validateParameterCombinations();
+	} catch (error & e) {
+		throw std::runtime_error( e.what() );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+std::string
+CommandLineParsing::
+getResultKey( const size_t targetNumber, const size_t queryNumber ) const
+{
+	checkIfParsed();
+	// sweep mode : the parameter set of the current request applies too
+	return ResultStore::getKey( sweepSets.empty() ? resultParameters : resultParameters+" #sweep "+sweepSets.at(requestNumber-1)
+			, getTargetSequences().at(targetNumber)
+			, getQuerySequences().at(queryNumber) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+CommandLineParsing::
+finishRequest() const
+{
+	if (serverMode || !sweepSets.empty()) {
+		getOutputStream() <<"#END" <<std::endl;
 	}
 }
 
@@ -1690,10 +3419,18 @@ validateSequenceAlphabet( const std::string& paramName,
 				const RnaSequenceVec& sequences)
 {
 	bool allValid = true;
-	// check each sequence
-	for (int i=0; i<sequences.size(); i++) {
+	// check each sequence (independently of each other)
+	std::vector< char > valid( sequences.size(), 1 );
+#if INTARNA_MULITHREADING
+	# pragma omp parallel for schedule(dynamic) num_threads( getThreads() ) shared(sequences,valid) if(sequences.size() > 1)
+#endif
+	for (size_t i=0; i<sequences.size(); i++) {
+		valid[i] = RnaSequence::isValidSequenceIUPAC(sequences.at(i).asString()) ? 1 : 0;
+	}
+	// report in input order
+	for (size_t i=0; i<sequences.size(); i++) {
 		// check if valid
-		if (! RnaSequence::isValidSequenceIUPAC(sequences.at(i).asString())) {
+		if (! valid.at(i)) {
 			LOG(ERROR) <<"sequence " <<(i+1)<<" for parameter "<<paramName<<" is not valid!";
 			updateParsingCode(ReturnCode::STOP_PARSING_ERROR);
 			allValid = false;
@@ -1716,16 +3453,401 @@ getTemperature() const {
 
 ////////////////////////////////////////////////////////////////////////////
 
-Predictor*
+void
+CommandLineParsing::
+writeTelemetry() const
+{
+	// JSON summary
+	if (!outPrefix2streamName.at(OutPrefixCode::OP_telemetry).empty()) {
+		VLOG(2) <<"writing telemetry summary to "<<outPrefix2streamName.at(OutPrefixCode::OP_telemetry);
+		std::ostream * out = newOutputStream( outPrefix2streamName.at(OutPrefixCode::OP_telemetry) );
+		if (out == NULL) {
+			throw std::runtime_error("could not open output file '"+outPrefix2streamName.at(OutPrefixCode::OP_telemetry)+"' for telemetry output");
+		}
+		Telemetry::writeJson( *out );
+		deleteOutputStream( out );
+	}
+	// CSV summary
+	if (!outPrefix2streamName.at(OutPrefixCode::OP_telemetryCsv).empty()) {
+		VLOG(2) <<"writing telemetry summary to "<<outPrefix2streamName.at(OutPrefixCode::OP_telemetryCsv);
+		std::ostream * out = newOutputStream( outPrefix2streamName.at(OutPrefixCode::OP_telemetryCsv) );
+		if (out == NULL) {
+			throw std::runtime_error("could not open output file '"+outPrefix2streamName.at(OutPrefixCode::OP_telemetryCsv)+"' for telemetry output");
+		}
+		Telemetry::writeCsv( *out );
+		deleteOutputStream( out );
+	}
+	// execution trace
+	if (!outPrefix2streamName.at(OutPrefixCode::OP_trace).empty()) {
+		VLOG(2) <<"writing execution trace to "<<outPrefix2streamName.at(OutPrefixCode::OP_trace);
+		std::ostream * out = newOutputStream( outPrefix2streamName.at(OutPrefixCode::OP_trace) );
+		if (out == NULL) {
+			throw std::runtime_error("could not open output file '"+outPrefix2streamName.at(OutPrefixCode::OP_trace)+"' for trace output");
+		}
+		Telemetry::writeTrace( *out );
+		deleteOutputStream( out );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+CommandLineParsing::
+allowWindowPruning() const
+{
+	checkIfParsed();
+	return pred.val == 'S'
+			&& outNumber.val == 1
+			&& !outPerRegion
+			&& !isPredictionTracked()
+			;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+CommandLineParsing::
+isPredictionTracked() const
+{
+	checkIfParsed();
+	// see getPredictor()
+	return !outPrefix2streamName.at(OutPrefixCode::OP_tMinE).empty()
+			|| !outPrefix2streamName.at(OutPrefixCode::OP_qMinE).empty()
+			|| !outPrefix2streamName.at(OutPrefixCode::OP_tSpotProb).empty()
+			|| !outPrefix2streamName.at(OutPrefixCode::OP_qSpotProb).empty()
+			|| !outPrefix2streamName.at(OutPrefixCode::OP_pMinE).empty()
+			|| !outPrefix2streamName.at(OutPrefixCode::OP_spotProb).empty()
+			;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+size_t
+CommandLineParsing::
+getMemoryEstimate( const size_t lengthT
+				, const size_t lengthQ
+				, const size_t windowT
+				, const size_t windowQ ) const
+{
+	checkIfParsed();
+	return getMemoryEstimate( lengthT, lengthQ, windowT, windowQ, predMode.val );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+size_t
+CommandLineParsing::
+getMemoryEstimate( const size_t lengthT
+				, const size_t lengthQ
+				, const size_t windowT
+				, const size_t windowQ
+				, const char mode ) const
+{
+	// maximal interaction lengths (0 = unrestricted)
+	const size_t intLenQ = (qAcc.val == 'N' || qAccW.val == 0) ? qIntLenMax.val
+			: (qIntLenMax.val == 0 ? qAccW.val : std::min(qIntLenMax.val,qAccW.val));
+	const size_t intLenT = (tAcc.val == 'N' || tAccW.val == 0) ? tIntLenMax.val
+			: (tIntLenMax.val == 0 ? tAccW.val : std::min(tIntLenMax.val,tAccW.val));
+	const size_t sizeT = std::min( lengthT, windowT );
+	const size_t sizeQ = std::min( lengthQ, windowQ );
+
+	size_t memEstimate = 0;
+
+	// accessibility data of the whole sequences
+	if (tAcc.val != 'N') {
+		memEstimate += EdBandMatrix::getMemoryEstimate( lengthT, intLenT == 0 ? lengthT : intLenT, accLowMem );
+	}
+	if (qAcc.val != 'N') {
+		// the reversed query accessibility holds a copy unless accLowMem
+		memEstimate += (accLowMem ? 1 : 2) * EdBandMatrix::getMemoryEstimate( lengthQ, intLenQ == 0 ? lengthQ : intLenQ, accLowMem );
+	}
+
+	// predictor matrices for one window combination (see getPredictor())
+	switch ( mode ) {
+	case 'E' :
+		// seed-based exact prediction needs a second 4D matrix
+		memEstimate += ((pred.val == 'S' && !noSeedRequired) ? 2 : 1)
+				* PredictorMfe4d::getMemoryEstimate( sizeT, sizeQ, intLenT, intLenQ, tIntLoopMax.val, qIntLoopMax.val );
+		break;
+	case 'M' :
+		memEstimate += noSeedRequired
+				? PredictorMfe2d::getMemoryEstimate( sizeT, sizeQ )
+				: PredictorMfe2dSeed::getMemoryEstimate( sizeT, sizeQ );
+		break;
+	default :
+		// heuristic predictors (upper bound for the sparse seed handling)
+		memEstimate += noSeedRequired
+				? PredictorMfe2dHeuristic::getMemoryEstimate( sizeT, sizeQ )
+				: PredictorMfe2dHeuristicSeed::getMemoryEstimate( sizeT, sizeQ );
+		break;
+	}
+
+	// seed matrices (see getSeedConstraint())
+	if (!noSeedRequired) {
+		memEstimate += SeedHandlerMfe::getMemoryEstimate( sizeT, sizeQ
+						, seedBP.val
+						, seedTMaxUP.val<0 ? seedMaxUP.val : seedTMaxUP.val
+						, seedQMaxUP.val<0 ? seedMaxUP.val : seedQMaxUP.val );
+	}
+
+	// pair-wise minimal energy output of the whole sequences
+	if (!outPrefix2streamName.at(OutPrefixCode::OP_pMinE).empty()) {
+		memEstimate += PredictionTrackerPairMinE::getMemoryEstimate( lengthT, lengthQ );
+	}
+
+	return memEstimate;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+double
+CommandLineParsing::
+getPredictionCost( const size_t windowT
+				, const size_t windowQ ) const
+{
+	// maximal interaction lengths within the windows
+	const size_t intLenQ = std::min( windowQ, (size_t)(qIntLenMax.val == 0 ? windowQ : qIntLenMax.val) );
+	const size_t intLenT = std::min( windowT, (size_t)(tIntLenMax.val == 0 ? windowT : tIntLenMax.val) );
+	// number of loop energy evaluations per cell
+	const double loops = (double)std::min( intLenT, (size_t)tIntLoopMax.val+1 )
+						* (double)std::min( intLenQ, (size_t)qIntLoopMax.val+1 );
+
+	switch ( predMode.val ) {
+	case 'M' : // drop to next handling
+	case 'E' :
+		// exact predictions fill a matrix of all right ends for each left end
+		return (double)windowT * (double)windowQ * (double)intLenT * (double)intLenQ * loops;
+	default :
+		// heuristic predictions fill one cell per left end
+		return (double)windowT * (double)windowQ * loops;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+double
+CommandLineParsing::
+getPredictionCost( const size_t lengthT
+				, const size_t lengthQ
+				, const size_t windowWidth
+				, const size_t windowOverlap ) const
+{
+	if (lengthT == 0 || lengthQ == 0) {
+		return 0;
+	}
+	const size_t width = windowWidth == 0 ? std::numeric_limits<size_t>::max() : windowWidth;
+	const std::vector<IndexRange> windowsT = IndexRange(0,lengthT-1).overlappingWindows( width, windowOverlap );
+	const std::vector<IndexRange> windowsQ = IndexRange(0,lengthQ-1).overlappingWindows( width, windowOverlap );
+	// sum of the costs of all window combinations
+	double cost = 0;
+	for (size_t t=0; t<windowsT.size(); t++) {
+	for (size_t q=0; q<windowsQ.size(); q++) {
+		cost += getPredictionCost( std::min( windowsT.at(t).to, lengthT-1 ) - windowsT.at(t).from + 1
+								, std::min( windowsQ.at(q).to, lengthQ-1 ) - windowsQ.at(q).from + 1 );
+	}}
+	return cost;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+size_t
+CommandLineParsing::
+getAutoWindowWidth( const size_t windowOverlap ) const
+{
+	// number of target-query combinations for each pair of sequence lengths
+	std::map< std::pair<size_t,size_t>, size_t > lengths;
+	size_t maxLength = 0;
+	for (RnaSequenceVec::const_iterator t = target.begin(); t != target.end(); t++) {
+	for (RnaSequenceVec::const_iterator q = query.begin(); q != query.end(); q++) {
+		lengths[ std::make_pair( t->size(), q->size() ) ]++;
+		maxLength = std::max( maxLength, std::max( t->size(), q->size() ) );
+	}}
+
+	// candidate widths : no windows (0) and geometrically increasing widths
+	// that exceed the overlap and are shorter than the longest sequence
+	std::vector< size_t > widths( 1, 0 );
+	for (size_t width = std::max( (size_t)10, 2*windowOverlap ); width < maxLength && (int)width <= windowWidth.max; width += width/4) {
+		widths.push_back( width );
+	}
+
+	// estimated parallel runtime of each candidate, i.e. the maximum of the
+	// total cost (including redundant overlap computations) distributed
+	// among a fixed number of parallel tasks and the cost of the most
+	// expensive window task; the actual number of threads is not used to
+	// ensure that the results are independent of --threads
+	const double parallelTasks = 8;
+	std::vector< double > runtime( widths.size(), 0 );
+	double minRuntime = std::numeric_limits<double>::max();
+	for (size_t w=0; w<widths.size(); w++) {
+		double totalCost = 0, maxTaskCost = 0;
+		for (std::map< std::pair<size_t,size_t>, size_t >::const_iterator l = lengths.begin(); l != lengths.end(); l++) {
+			totalCost += (double)l->second * getPredictionCost( l->first.first, l->first.second, widths.at(w), windowOverlap );
+			maxTaskCost = std::max( maxTaskCost, widths.at(w) == 0
+					? getPredictionCost( l->first.first, l->first.second )
+					: getPredictionCost( std::min( widths.at(w), l->first.first ), std::min( widths.at(w), l->first.second ) ) );
+		}
+		runtime[w] = std::max( totalCost / parallelTasks, maxTaskCost );
+		minRuntime = std::min( minRuntime, runtime[w] );
+	}
+
+	// fewest windows (no windows or the largest width) within 1% of the
+	// minimal runtime, since each window task has some setup overhead
+	if (runtime.at(0) <= minRuntime * 1.01) {
+		return 0;
+	}
+	for (size_t w=widths.size(); w-- > 1; ) {
+		if (runtime.at(w) <= minRuntime * 1.01) {
+			return widths.at(w);
+		}
+	}
+	return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+CommandLineParsing::
+writeDryRun( std::ostream & out ) const
+{
+	// maximal interaction lengths (0 = unrestricted, see getMemoryEstimate())
+	const size_t intLenQ = (qAcc.val == 'N' || qAccW.val == 0) ? qIntLenMax.val
+			: (qIntLenMax.val == 0 ? qAccW.val : std::min(qIntLenMax.val,qAccW.val));
+	const size_t intLenT = (tAcc.val == 'N' || tAccW.val == 0) ? tIntLenMax.val
+			: (tIntLenMax.val == 0 ? tAccW.val : std::min(tIntLenMax.val,tAccW.val));
+#if INTARNA_MULITHREADING
+	const size_t threadNumber = std::max( (size_t)1, getThreads() );
+#else
+	const size_t threadNumber = 1;
+#endif
+	const size_t MB = 1024*1024;
+
+	out <<"# dry run : estimated costs (cost = arbitrary unit, memory in MB)\n"
+		<<"# mode="<<predMode.val
+		<<" windowWidth="<<windowWidth.val
+		<<" windowOverlap="<<windowOverlap.val
+		<<" threads="<<threadNumber
+		<<'\n';
+
+	// accessibility computation of each sequence, i.e. the folding of all
+	// windows of length accW (cost) and the stored ED values (memory)
+	double totalAccCost = 0;
+	out <<"sequence;id;length;accCost;accMemory\n";
+	for (RnaSequenceVec::const_iterator q = query.begin(); q != query.end(); q++) {
+		const size_t accW = qAccW.val == 0 ? q->size() : std::min( (size_t)qAccW.val, q->size() );
+		const double accCost = qAcc.val == 'C' ? (double)q->size() * (double)accW * (double)accW : 0;
+		// the reversed query accessibility holds a copy unless accLowMem
+		const size_t accMem = qAcc.val == 'N' ? 0
+				: (accLowMem ? 1 : 2) * EdBandMatrix::getMemoryEstimate( q->size(), intLenQ == 0 ? q->size() : intLenQ, accLowMem );
+		totalAccCost += accCost;
+		out <<"query;"<<q->getId()<<';'<<q->size()<<';'<<accCost<<';'<<(accMem/MB+1)<<'\n';
+	}
+	for (RnaSequenceVec::const_iterator t = target.begin(); t != target.end(); t++) {
+		const size_t accW = tAccW.val == 0 ? t->size() : std::min( (size_t)tAccW.val, t->size() );
+		const double accCost = tAcc.val == 'C' ? (double)t->size() * (double)accW * (double)accW : 0;
+		const size_t accMem = tAcc.val == 'N' ? 0
+				: EdBandMatrix::getMemoryEstimate( t->size(), intLenT == 0 ? t->size() : intLenT, accLowMem );
+		totalAccCost += accCost;
+		out <<"target;"<<t->getId()<<';'<<t->size()<<';'<<accCost<<';'<<(accMem/MB+1)<<'\n';
+	}
+
+	// prediction of each target-query combination
+	const size_t width = windowWidth.val == 0 ? std::numeric_limits<size_t>::max() : (size_t)windowWidth.val;
+	double totalCells = 0, totalCost = 0;
+	size_t totalWindows = 0, maxMem = 0;
+	out <<"target;query;windows;dpCells;cost;memory\n";
+	for (RnaSequenceVec::const_iterator t = target.begin(); t != target.end(); t++) {
+	for (RnaSequenceVec::const_iterator q = query.begin(); q != query.end(); q++) {
+		size_t windows = 0, windowT = 0, windowQ = 0;
+		double cells = 0;
+		if (t->size() > 0 && q->size() > 0) {
+			const std::vector<IndexRange> windowsT = IndexRange(0,t->size()-1).overlappingWindows( width, windowOverlap.val );
+			const std::vector<IndexRange> windowsQ = IndexRange(0,q->size()-1).overlappingWindows( width, windowOverlap.val );
+			windows = windowsT.size() * windowsQ.size();
+			for (size_t wt=0; wt<windowsT.size(); wt++) {
+			for (size_t wq=0; wq<windowsQ.size(); wq++) {
+				const size_t sizeT = std::min( windowsT.at(wt).to, t->size()-1 ) - windowsT.at(wt).from + 1;
+				const size_t sizeQ = std::min( windowsQ.at(wq).to, q->size()-1 ) - windowsQ.at(wq).from + 1;
+				windowT = std::max( windowT, sizeT );
+				windowQ = std::max( windowQ, sizeQ );
+				// exact prediction in 4D-space holds a matrix of right ends for each left end
+				cells += (double)sizeT * (double)sizeQ
+						* (predMode.val != 'E' ? 1.0
+							: (double)std::min( sizeT, intLenT == 0 ? sizeT : intLenT )
+							* (double)std::min( sizeQ, intLenQ == 0 ? sizeQ : intLenQ ) );
+			}}
+		}
+		const double cost = getPredictionCost( t->size(), q->size(), windowWidth.val, windowOverlap.val );
+		const size_t mem = windows == 0 ? 0 : getMemoryEstimate( t->size(), q->size(), windowT, windowQ, predMode.val );
+		totalWindows += windows;
+		totalCells += cells;
+		totalCost += cost;
+		maxMem = std::max( maxMem, mem );
+		out <<t->getId()<<';'<<q->getId()<<';'<<windows<<';'<<cells<<';'<<cost<<';'<<(mem/MB+1)<<'\n';
+	}}
+
+	// totals of the run, where the peak memory assumes the most expensive
+	// combination to be predicted by all threads concurrently
+	out <<"# total : accCost="<<totalAccCost
+		<<" windows="<<totalWindows
+		<<" dpCells="<<totalCells
+		<<" cost="<<totalCost
+		<<" peakMemory="<<(std::min( threadNumber, target.size()*query.size() ) * maxMem / MB + 1)
+		<<'\n';
+	out.flush();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+std::vector< size_t >
+CommandLineParsing::
+getTargetOrder() const
+{
+	checkIfParsed();
+	const RnaSequenceVec & targets = getTargetSequences();
+	const RnaSequenceVec & queries = getQuerySequences();
+
+	// cost of each target with all queries (negated to sort in decreasing
+	// order, where equal costs keep the input order)
+	std::vector< std::pair< double, size_t > > targetCost( targets.size() );
+	for (size_t t=0; t<targets.size(); t++) {
+		double cost = 0;
+		for (size_t q=0; q<queries.size(); q++) {
+			cost += getPredictionCost( targets.at(t).size(), queries.at(q).size(), windowWidth.val, windowOverlap.val );
+		}
+		targetCost[t] = std::make_pair( -cost, t );
+	}
+
+	// size of the blocks to be sorted, such that the output of a block
+	// fits into the output order buffer
+	size_t blockSize = targets.size();
+#if INTARNA_MULITHREADING
+	if (getOutputOrderBuffer() > 0) {
+		blockSize = std::max( (size_t)1, getOutputOrderBuffer() / std::max( (size_t)1, queries.size() ) );
+	}
+#endif
+	for (size_t from = 0; from < targetCost.size(); from += blockSize) {
+		std::sort( targetCost.begin()+from, targetCost.begin()+std::min( from+blockSize, targetCost.size() ) );
+	}
+
+	std::vector< size_t > order( targets.size() );
+	for (size_t t=0; t<targetCost.size(); t++) {
+		order[t] = targetCost.at(t).second;
+	}
+	return order;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+PredictionTracker*
 CommandLineParsing::
-getPredictor( const InteractionEnergy & energy, OutputHandler & output ) const
+getPredictionTracker( const InteractionEnergy & energy ) const
 {
-	// set up hub for prediction tracking (if needed)
-	PredictionTrackerHub * predTracker = new PredictionTrackerHub();
+	// collect the prediction trackers needed
+	std::vector< PredictionTracker * > trackers;
 
 	// check if minE-profile is to be generated
 	if (!outPrefix2streamName.at(OutPrefixCode::OP_tMinE).empty() || !outPrefix2streamName.at(OutPrefixCode::OP_qMinE).empty()) {
-		predTracker->addPredictionTracker(
+		trackers.push_back(
 				new PredictionTrackerProfileMinE( energy
 						// add sequence-specific prefix for output file
 						, getFullFilename( outPrefix2streamName.at(OutPrefixCode::OP_tMinE)
@@ -1740,7 +3862,7 @@ getPredictor( const InteractionEnergy & energy, OutputHandler & output ) const
 
 	// check if spotProb-profile is to be generated
 	if (!outPrefix2streamName.at(OutPrefixCode::OP_tSpotProb).empty() || !outPrefix2streamName.at(OutPrefixCode::OP_qSpotProb).empty()) {
-		predTracker->addPredictionTracker(
+		trackers.push_back(
 				new PredictionTrackerProfileSpotProb( energy
 						// add sequence-specific prefix for output file
 						, getFullFilename( outPrefix2streamName.at(OutPrefixCode::OP_tSpotProb)
@@ -1755,7 +3877,7 @@ getPredictor( const InteractionEnergy & energy, OutputHandler & output ) const
 
 	// check if minE-pairs are to be generated
 	if (!outPrefix2streamName.at(OutPrefixCode::OP_pMinE).empty()) {
-		predTracker->addPredictionTracker(
+		trackers.push_back(
 				new PredictionTrackerPairMinE( energy
 						// add sequence-specific prefix for output file
 						, getFullFilename( outPrefix2streamName.at(OutPrefixCode::OP_pMinE)
@@ -1766,7 +3888,7 @@ getPredictor( const InteractionEnergy & energy, OutputHandler & output ) const
 
 	// check if spotProbs are to be tracked
 	if (!outPrefix2streamName.at(OutPrefixCode::OP_spotProb).empty()) {
-		predTracker->addPredictionTracker(
+		trackers.push_back(
 				new PredictionTrackerSpotProb( energy
 								// get encoding
 								, outSpotProbSpots
@@ -1774,21 +3896,59 @@ getPredictor( const InteractionEnergy & energy, OutputHandler & output ) const
 							);
 	}
 
-	// check if any tracker registered
-	if (predTracker->empty()) {
-		// cleanup to avoid overhead
-		 INTARNA_CLEANUP(predTracker);
-		predTracker == NULL;
+	// predictors skip tracking if no tracker is registered and call a single
+	// tracker directly; only multiple trackers are forwarded via a hub
+	PredictionTracker * predTracker = NULL;
+	if (trackers.size() == 1) {
+		predTracker = trackers.front();
+	} else if (trackers.size() > 1) {
+		PredictionTrackerHub * predTrackerHub = new PredictionTrackerHub();
+		for (auto tracker = trackers.begin(); tracker != trackers.end(); tracker++) {
+			predTrackerHub->addPredictionTracker( *tracker );
+		}
+		predTracker = predTrackerHub;
+	}
+	return predTracker;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+Predictor*
+CommandLineParsing::
+getPredictor( const InteractionEnergy & energy, OutputHandler & output, const SeedHandlerMfe * seedCache, PredictionTracker * predTracker ) const
+{
+	// predict transposed problem for targets much longer than the query
+	Predictor * predictorTransposed = getTransposedPredictor( energy, output, seedCache, predTracker );
+	if (predictorTransposed != NULL) {
+		return predictorTransposed;
 	}
 
+	return getDirectPredictor( energy, output, seedCache, predTracker );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+Predictor*
+CommandLineParsing::
+getDirectPredictor( const InteractionEnergy & energy, OutputHandler & output, const SeedHandlerMfe * seedCache, PredictionTracker * predTracker ) const
+{
 	if (noSeedRequired) {
 		// predictors without seed constraint
 		switch( pred.val ) {
 		// single-site mfe interactions (contain only interior loops)
 		case 'S' : {
 			switch ( predMode.val ) {
-			case 'H' :  return new PredictorMfe2dHeuristic( energy, output, predTracker );
-			case 'M' :  return new PredictorMfe2d( energy, output, predTracker );
+			case 'H' :  {
+				PredictorMfe2dHeuristic * predictor = new PredictorMfe2dHeuristic( energy, output, predTracker );
+				predictor->setPruning( pruning );
+				predictor->setTraceStorage( storeTrace );
+				return predictor;
+			}
+			case 'M' :  {
+				PredictorMfe2d * predictor = new PredictorMfe2d( energy, output, predTracker );
+				predictor->setPruning( pruning );
+				return predictor;
+			}
 			case 'E' :  return new PredictorMfe4d( energy, output, predTracker );
 			default :  INTARNA_NOT_IMPLEMENTED("mode "+toString(predMode.val)+" not implemented for prediction target "+toString(pred.val));
 			}
@@ -1814,15 +3974,20 @@ getPredictor( const InteractionEnergy & energy, OutputHandler & output ) const
 		// single-site mfe interactions (contain only interior loops)
 		case 'S' : {
 			switch ( predMode.val ) {
-			case 'H' :  return new PredictorMfe2dHeuristicSeed( energy, output, predTracker, getSeedHandler( energy ) );
-			case 'M' :  return new PredictorMfe2dSeed( energy, output, predTracker, getSeedHandler( energy ) );
-			case 'E' :  return new PredictorMfe4dSeed( energy, output, predTracker, getSeedHandler( energy ) );
+			case 'H' :  {
+				PredictorMfe2dHeuristicSeed * predictor = new PredictorMfe2dHeuristicSeed( energy, output, predTracker, getSeedHandler( energy, seedCache ) );
+				predictor->setTraceStorage( storeTrace );
+				return predictor;
+			}
+			case 'M' :  return new PredictorMfe2dSeed( energy, output, predTracker, getSeedHandler( energy, seedCache ) );
+			case 'E' :  return new PredictorMfe4dSeed( energy, output, predTracker, getSeedHandler( energy, seedCache ) );
+			case 'A' :  return new PredictorMfe2dHeuristicSeedSparse( energy, output, predTracker, getSeedHandler( energy, seedCache ) );
 			}
 		} break;
 		// single-site max-prob interactions (contain only interior loops)
 		case 'P' : {
 			switch ( predMode.val ) {
-			case 'E' :  INTARNA_NOT_IMPLEMENTED("mode "+toString(predMode.val)+" not implemented for seed constraint (try --noSeed)"); return NULL;
+			case 'E' :  return new PredictorMaxProbSeed( energy, output, predTracker, getSeedHandler( energy, seedCache ) );
 			default :  INTARNA_NOT_IMPLEMENTED("mode "+toString(predMode.val)+" not implemented for prediction target "+toString(pred.val));
 			}
 		} break;
@@ -1839,6 +4004,88 @@ getPredictor( const InteractionEnergy & energy, OutputHandler & output ) const
 
 ////////////////////////////////////////////////////////////////////////////
 
+Predictor*
+CommandLineParsing::
+getTransposedPredictor( const InteractionEnergy & energy, OutputHandler & output, const SeedHandlerMfe * seedCache, const PredictionTracker * predTracker ) const
+{
+	// only beneficial if the target windows are much longer than the query
+	// windows (the final decision is done for each predicted range)
+	const size_t maxWidth = windowWidth.val == 0 ? std::numeric_limits<size_t>::max() : (size_t)windowWidth.val;
+	if (!PredictorTransposed::isTransposable( std::min( energy.size1(), maxWidth ), std::min( energy.size2(), maxWidth ) )) {
+		return NULL;
+	}
+	// only for exact single-site predictions without tracking or shared seeds
+	if (pred.val != 'S' || (predMode.val != 'M' && predMode.val != 'E')
+		|| predTracker != NULL || seedCache != NULL)
+	{
+		return NULL;
+	}
+	// only for identical target and query seed constraints
+	if (!noSeedRequired
+		&& ((seedTMaxUP.val<0 ? seedMaxUP.val : seedTMaxUP.val) != (seedQMaxUP.val<0 ? seedMaxUP.val : seedQMaxUP.val)
+			|| !seedTRange.empty() || !seedQRange.empty() || !seedTQ.empty()))
+	{
+		return NULL;
+	}
+
+	// setup transposed problem : query as first and reversed target as second sequence
+	// (the reversed target is not materialized to avoid a copy of its ED values)
+	ReverseAccessibility * targetAccRev = new ReverseAccessibility( const_cast<Accessibility&>(energy.getAccessibility1()) );
+	PredictorTransposed * predictor = new PredictorTransposed( energy, output, targetAccRev
+			, getTransposedEnergyHandler( energy.getAccessibility2().getAccessibilityOrigin(), *targetAccRev ) );
+	predictor->setTransposedPredictor( getDirectPredictor( predictor->getTransposedEnergy(), predictor->getTransposedOutput(), NULL, NULL ) );
+	// ranges without a long target range are predicted directly
+	predictor->setDirectPredictor( getDirectPredictor( energy, output, NULL, NULL ) );
+	return predictor;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+InteractionEnergy*
+CommandLineParsing::
+getTransposedEnergyHandler( const Accessibility& accQuery
+				, const ReverseAccessibility& accTarget ) const
+{
+	checkIfParsed();
+
+	// exchange target and query specific loop restrictions
+	switch( energy.val ) {
+	case 'B' : return new InteractionEnergyBasePair( accQuery, accTarget, qIntLoopMax.val, tIntLoopMax.val, false );
+	case 'V' : return new InteractionEnergyVrna( accQuery, accTarget, vrnaHandler, qIntLoopMax.val, tIntLoopMax.val, false );
+	default :
+		INTARNA_NOT_IMPLEMENTED("CommandLineParsing::getTransposedEnergyHandler : energy = '"+toString(energy.val)+"' is not supported");
+	}
+	return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+double
+CommandLineParsing::
+getTimeBudget() const
+{
+	checkIfParsed();
+	// only exact single-site mfe prediction has a faster fallback
+	return (pred.val == 'S' && (predMode.val == 'M' || predMode.val == 'E')) ? timeBudget.val : 0.0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+Predictor*
+CommandLineParsing::
+getFallbackPredictor( const InteractionEnergy & energy, OutputHandler & output, const SeedHandlerMfe * seedCache, PredictionTracker * predTracker ) const
+{
+	// heuristic single-site mfe prediction (see getPredictor())
+	if (noSeedRequired) {
+		PredictorMfe2dHeuristic * predictor = new PredictorMfe2dHeuristic( energy, output, predTracker );
+		predictor->setPruning( pruning );
+		return predictor;
+	}
+	return new PredictorMfe2dHeuristicSeed( energy, output, predTracker, getSeedHandler( energy, seedCache ) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 std::ostream &
 CommandLineParsing::
 getOutputStream() const
@@ -1872,7 +4119,7 @@ initOutputHandler()
 		<<"weight for ED values of binding RNA in energy                 : 1" <<"\n"
 		<<"temperature                                                   : "<<temperature.val <<" Celsius" <<"\n"
 		<<"max. number of subopt. results                                : "<<(getOutputConstraint().reportMax-1) <<"\n"
-		<<"Heuristic for hybridization end used                          : "<<(predMode.val=='H'?"true":"false") <<"\n"
+		<<"Heuristic for hybridization end used                          : "<<((predMode.val=='H'||predMode.val=='A')?"true":"false") <<"\n"
 		<<"\n"
 		<<"-------------------------" <<"\n"
 		<<"OUTPUT" <<"\n"
@@ -1882,6 +4129,10 @@ initOutputHandler()
 		getOutputStream()
 		<<OutputHandlerCsv::getHeader( OutputHandlerCsv::string2list( outCsvCols ) )
 		; break;
+	case 'B' :
+		getOutputStream()
+		<<OutputHandlerBinary::getHeader( OutputHandlerCsv::string2list( outCsvCols ) )
+		; break;
 	}
 
 }
@@ -1891,18 +4142,29 @@ initOutputHandler()
 OutputHandler*
 CommandLineParsing::
 getOutputHandler( const InteractionEnergy & energy ) const
+{
+	return getOutputHandler( energy, getOutputStream() );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+OutputHandler*
+CommandLineParsing::
+getOutputHandler( const InteractionEnergy & energy, std::ostream & out ) const
 {
 	switch (outMode.val) {
 	case 'N' :
-		return new OutputHandlerText( getOutputStream(), energy, 10, false );
+		return new OutputHandlerText( out, energy, 10, false );
 	case 'D' :
-		return new OutputHandlerText( getOutputStream(), energy, 10, true );
+		return new OutputHandlerText( out, energy, 10, true );
 	case 'C' :
-		return new OutputHandlerCsv( getOutputStream(), energy, OutputHandlerCsv::string2list( outCsvCols ));
+		return new OutputHandlerCsv( out, energy, OutputHandlerCsv::string2list( outCsvCols ));
+	case 'B' :
+		return new OutputHandlerBinary( out, energy, OutputHandlerCsv::string2list( outCsvCols ));
 	case '1' :
-		return new OutputHandlerIntaRNA1( getOutputStream(), energy, false );
+		return new OutputHandlerIntaRNA1( out, energy, false );
 	case 'O' :
-		return new OutputHandlerIntaRNA1( getOutputStream(), energy, true );
+		return new OutputHandlerIntaRNA1( out, energy, true );
 	default :
 		INTARNA_NOT_IMPLEMENTED("Output mode "+toString(outMode.val)+" not implemented yet");
 	}
@@ -1945,7 +4207,7 @@ getSeedConstraint( const InteractionEnergy & energy ) const
 
 SeedHandler *
 CommandLineParsing::
-getSeedHandler( const InteractionEnergy & energy ) const
+getSeedHandler( const InteractionEnergy & energy, const SeedHandlerMfe * seedCache ) const
 {
 	// get seed constraint
 	const SeedConstraint & seedConstr = getSeedConstraint( energy );
@@ -1953,6 +4215,10 @@ getSeedHandler( const InteractionEnergy & energy ) const
 	if (!seedTQ.empty()) {
 		// create new seed handler for explicit seed definitions
 		return new SeedHandlerExplicit( energy, seedConstr );
+	} else
+	if (seedCache != NULL) {
+		// create new seed handler using the seeds shared among windows
+		return new SeedHandlerCached( energy, seedConstr, *seedCache );
 	} else {
 		// create new seed handler using mfe computation
 		return new SeedHandlerMfe( energy, seedConstr );
@@ -1961,6 +4227,33 @@ getSeedHandler( const InteractionEnergy & energy ) const
 
 ////////////////////////////////////////////////////////////////////////////
 
+const size_t CommandLineParsing::maxSeedCacheCells = 1 << 24;
+
+////////////////////////////////////////////////////////////////////////////
+
+SeedHandlerMfe *
+CommandLineParsing::
+getSeedCache( const InteractionEnergy & energy
+		, const IndexRange & r1
+		, const IndexRange & r2 ) const
+{
+	// check if mfe seeds are computed
+	if (noSeedRequired || !seedTQ.empty()) {
+		return NULL;
+	}
+	// limit the memory consumption of the shared table
+	if ((r1.to-r1.from+1)*(r2.to-r2.from+1) > maxSeedCacheCells) {
+		return NULL;
+	}
+
+	// compute seeds for the whole range
+	SeedHandlerMfe * seedCache = new SeedHandlerMfe( energy, getSeedConstraint( energy ) );
+	seedCache->fillSeed( r1.from, r1.to, r2.from, r2.to );
+	return seedCache;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 const IndexRangeList&
 CommandLineParsing::
 getQueryRanges( const InteractionEnergy & energy, const size_t sequenceNumber ) const
@@ -1973,20 +4266,36 @@ getQueryRanges( const InteractionEnergy & energy, const size_t sequenceNumber )
 		throw std::runtime_error("CommandLineParsing::getQueryRanges("+toString(sequenceNumber)+") is empty");
 #endif
 
-	// check if ranges are to be computed
-	if (qRegionLenMax.val > 0) {
-		// check if computation is needed
-		if (qRegion.at(sequenceNumber).begin()->to - qRegion.at(sequenceNumber).begin()->from +1 > qRegionLenMax.val) {
-			// compute highly accessible regions using ED-window-size = seedBP and minRangeLength = seedBP
-			qRegion.at(sequenceNumber) = getQueryAccessibility( sequenceNumber )->decomposeByMaxED( qRegionLenMax.val, seedBP.val, seedBP.val);
-			// inform user
-			VLOG(1) <<"detected accessible regions for query '"<<getQuerySequences().at(sequenceNumber).getId()<<"' : "<<qRegion.at(sequenceNumber);
+	// the query accessibility already computed for the energy handler
+	const Accessibility & queryAcc = energy.getAccessibility2().getAccessibilityOrigin();
+
+	// decomposition is done once and shared by all concurrent callers;
+	// since it is idempotent, later calls do not alter the ranges
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_regionDecomposition)
+#endif
+	{
+		IndexRangeList ranges = qRegion.at(sequenceNumber);
+		// check if ranges are to be computed
+		if (qRegionLenMax.val > 0) {
+			// check if computation is needed
+			if (ranges.begin()->to - ranges.begin()->from +1 > (size_t)qRegionLenMax.val) {
+				// compute highly accessible regions using ED-window-size = seedBP and minRangeLength = seedBP
+				ranges = queryAcc.decomposeByMaxED( qRegionLenMax.val, seedBP.val, seedBP.val);
+				// inform user
+				VLOG(1) <<"detected accessible regions for query '"<<getQuerySequences().at(sequenceNumber).getId()<<"' : "<<ranges;
+			}
 		}
-	}
 
-	// decompose ranges based in minimal unpaired probability value per position
-	// since all ranges covering a position will have a lower unpaired probability
-	getQueryAccessibility( sequenceNumber )->decomposeByMinPu( qRegion.at(sequenceNumber), outMinPu.val, energy.getRT() );
+		// decompose ranges based in minimal unpaired probability value per position
+		// since all ranges covering a position will have a lower unpaired probability
+		queryAcc.decomposeByMinPu( ranges, outMinPu.val, energy.getRT() );
+
+		// update only if changed to not alter ranges in use by other threads
+		if (ranges != qRegion.at(sequenceNumber)) {
+			qRegion.at(sequenceNumber) = ranges;
+		}
+	} // omp critical(intarna_omp_regionDecomposition)
 
 	return qRegion.at(sequenceNumber);
 }
@@ -2001,25 +4310,38 @@ getTargetRanges( const InteractionEnergy & energy, const size_t sequenceNumber )
 #if INTARNA_IN_DEBUG_MODE
 	if (sequenceNumber>=tRegion.size())
 		throw std::runtime_error("CommandLineParsing::getTargetRanges("+toString(sequenceNumber)+") out of bounds");
-	if (tRegion.at(sequenceNumber).empty())
-		throw std::runtime_error("CommandLineParsing::getTargetRanges("+toString(sequenceNumber)+") is empty");
 #endif
 
-	// check if to be computed
-	if (tRegionLenMax.val > 0) {
-		// check if computation is needed
-		if (tRegion.at(sequenceNumber).begin()->to - tRegion.at(sequenceNumber).begin()->from +1 > tRegionLenMax.val) {
-			// compute highly accessible regions using ED-window-size = seedBP and minRangeLength = seedBP
-			tRegion.at(sequenceNumber) = getTargetAccessibility( sequenceNumber )->decomposeByMaxED( tRegionLenMax.val, seedBP.val, seedBP.val);
-			// inform user
-			VLOG(1) <<"detected accessible regions for target '"<<getTargetSequences().at(sequenceNumber).getId()<<"' : "<<tRegion.at(sequenceNumber);
+	// the target accessibility already computed for the energy handler
+	const Accessibility & targetAcc = energy.getAccessibility1();
+
+	// decomposition is done once and shared by all concurrent callers;
+	// since it is idempotent, later calls do not alter the ranges
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_regionDecomposition)
+#endif
+	{
+		IndexRangeList ranges = tRegion.at(sequenceNumber);
+		// check if to be computed
+		if (tRegionLenMax.val > 0) {
+			// check if computation is needed
+			if (ranges.begin()->to - ranges.begin()->from +1 > (size_t)tRegionLenMax.val) {
+				// compute highly accessible regions using ED-window-size = seedBP and minRangeLength = seedBP
+				ranges = targetAcc.decomposeByMaxED( tRegionLenMax.val, seedBP.val, seedBP.val);
+				// inform user
+				VLOG(1) <<"detected accessible regions for target '"<<getTargetSequences().at(sequenceNumber).getId()<<"' : "<<ranges;
+			}
 		}
-	}
 
-	// decompose ranges based in minimal unpaired probability value per position
-	// since all ranges covering a position will have a lower unpaired probability
-	getTargetAccessibility( sequenceNumber )->decomposeByMinPu( tRegion.at(sequenceNumber), outMinPu.val, energy.getRT() );
+		// decompose ranges based in minimal unpaired probability value per position
+		// since all ranges covering a position will have a lower unpaired probability
+		targetAcc.decomposeByMinPu( ranges, outMinPu.val, energy.getRT() );
 
+		// update only if changed to not alter ranges in use by other threads
+		if (ranges != tRegion.at(sequenceNumber)) {
+			tRegion.at(sequenceNumber) = ranges;
+		}
+	} // omp critical(intarna_omp_regionDecomposition)
 
 	return tRegion.at(sequenceNumber);
 }
@@ -2028,26 +4350,42 @@ getTargetRanges( const InteractionEnergy & energy, const size_t sequenceNumber )
 
 void
 CommandLineParsing::
-writeAccessibility( const Accessibility& acc, const std::string & fileOrStream, const bool writeED ) const
+writeAccessibility( const Accessibility& acc, const std::string & fileOrStream, const AccessibilityFromStream::InStreamType format ) const
 {
 	if (fileOrStream.empty())
 		return;
 
+	// checkpointing : write to a temporary file first to ensure that only
+	// complete files are reused when resuming
+	const bool useTmpFile = checkpoint != NULL
+			&& !boost::iequals(fileOrStream,"STDOUT") && !boost::iequals(fileOrStream,"STDERR");
+
 	// setup output stream
-	std::ostream * out = newOutputStream( fileOrStream );
+	std::ostream * out = newOutputStream( useTmpFile ? fileOrStream+".tmp" : fileOrStream );
 	if (out == NULL) {
-		throw std::runtime_error("could not open output file '"+fileOrStream +"' for "+(writeED?"accessibility":"unpaired probability")+" output");
+		throw std::runtime_error("could not open output file '"+fileOrStream +"' for "+(format==AccessibilityFromStream::Pu_RNAplfold_Text?"unpaired probability":"accessibility")+" output");
 	}
 
 	// write data to stream
-	if (writeED) {
+	switch (format) {
+	case AccessibilityFromStream::ED_RNAplfold_Text :
 		acc.writeRNAplfold_ED_text( *out );
-	} else {
+		break;
+	case AccessibilityFromStream::Pu_RNAplfold_Text :
 		acc.writeRNAplfold_Pu_text( *out, vrnaHandler.getRT() );
+		break;
+	case AccessibilityFromStream::ED_IntaRNA_Binary :
+		acc.writeED_binary( *out, vrnaHandler.getRT() );
+		break;
 	}
 
 	// clean up
 	deleteOutputStream( out );
+
+	// move complete file to final destination
+	if (useTmpFile) {
+		boost::filesystem::rename( fileOrStream+".tmp", fileOrStream );
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -3,6 +3,7 @@
 #define COMMANDLINEPARSING_H_
 
 #include "IntaRNA/general.h"
+#include "IntaRNA/CompressedOutputStream.h"
 #include "IntaRNA/RnaSequence.h"
 
 #include <boost/regex.hpp>
@@ -14,12 +15,19 @@
 #include <cstdarg>
 
 #include "IntaRNA/Accessibility.h"
+#include "IntaRNA/AccessibilityFromStream.h"
+#include "IntaRNA/AccessibilityVariant.h"
+#include "IntaRNA/CheckpointJournal.h"
+#include "IntaRNA/AccessibilityCache.h"
+#include "IntaRNA/ResultStore.h"
 #include "IntaRNA/InteractionEnergy.h"
+#include "IntaRNA/InteractionEnergyVrna.h"
 #include "IntaRNA/OutputHandler.h"
 #include "IntaRNA/Predictor.h"
 #include "IntaRNA/SeedConstraint.h"
 #include "IntaRNA/SeedHandler.h"
 #include "IntaRNA/SeedHandlerExplicit.h"
+#include "IntaRNA/SeedHandlerMfe.h"
 #include "IntaRNA/PredictionTrackerSpotProb.h"
 #include "IntaRNA/VrnaHandler.h"
 
@@ -79,10 +87,96 @@ public:
 
 	/**
 	 * Parses the target parameter and returns all parsed sequences.
+	 * If batch-wise target input is enabled (--tBatchSize), only the targets
+	 * of the current batch are provided (see parseNextTargetBatch()).
 	 * @return the set of parsed target sequences
 	 */
 	const RnaSequenceVec& getTargetSequences() const;
 
+	/**
+	 * If batch-wise target input is enabled (--tBatchSize), the current
+	 * set of target sequences is released and replaced by the next batch
+	 * of target sequences read from the target FASTA input.
+	 *
+	 * @return true if a new batch of target sequences is available via
+	 *         getTargetSequences(); false if all target sequences have been
+	 *         read already or batch-wise input is disabled
+	 */
+	bool parseNextTargetBatch();
+
+	/**
+	 * Provides the next prediction request. If server mode is disabled, the
+	 * query and target sequences given on the command line form the only
+	 * request, i.e. true is returned on the first call only.
+	 *
+	 * In server mode (--server), the next request is read from STDIN, which
+	 * is a line holding a query and a target sequence separated by
+	 * whitespace. The current query and target sequences are replaced by the
+	 * ones of the request. Invalid requests are answered with an error
+	 * message and skipped. Empty lines and lines starting with '#' are
+	 * ignored.
+	 *
+	 * In sweep mode (--sweep), each request is a parameter set of the sweep
+	 * applied to the command line input.
+	 *
+	 * @return true if a new request is available via getQuerySequences() and
+	 *         getTargetSequences(); false if no further request is available
+	 */
+	bool parseNextRequest();
+
+	/**
+	 * Finalizes the output for the current request. In server and sweep
+	 * mode, the request's output is terminated by a line '#END' and the
+	 * output stream is flushed.
+	 */
+	void finishRequest() const;
+
+	/**
+	 * Whether or not prediction requests are read from STDIN.
+	 * @return true if in server mode; false otherwise
+	 */
+	bool isServerMode() const;
+
+	/**
+	 * Maximal number of query accessibilities to be cached and reused over
+	 * the requests handled in server or sweep mode.
+	 * @return the number of query accessibilities to cache (0 if not in
+	 *         server or sweep mode)
+	 */
+	size_t getServerCache() const;
+
+	/**
+	 * Whether or not accessibility data is to be stored with reduced memory
+	 * consumption.
+	 * @return true if --accLowMem was given; false otherwise
+	 */
+	bool isAccLowMem() const;
+
+	/**
+	 * Access to the checkpoint journal that records the finished
+	 * query-target combinations. If a previous run is resumed, it provides
+	 * the combinations that are already finished.
+	 * @return the checkpoint journal or NULL if no checkpointing is done
+	 */
+	CheckpointJournal * getCheckpointJournal() const;
+
+	/**
+	 * Access to the store of the output of query-target combinations
+	 * computed by previous runs.
+	 * @return the result store or NULL if no results are stored
+	 */
+	const ResultStore * getResultStore() const;
+
+	/**
+	 * Provides the result store key of a query-target combination of the
+	 * current request, which covers the sequences and all arguments the
+	 * combination's output depends on.
+	 * @param targetNumber the index of the target sequence
+	 * @param queryNumber the index of the query sequence
+	 * @return the key of the combination within the result store
+	 */
+	std::string getResultKey( const size_t targetNumber, const size_t queryNumber ) const;
+
 	/**
 	 * Returns a newly allocated Accessibility object for the given query
 	 * sequence according to the user defined parameters.
@@ -92,19 +186,101 @@ public:
 	 */
 	Accessibility* getQueryAccessibility( const size_t sequenceNumber ) const;
 
+	/**
+	 * Returns a newly allocated Accessibility object for the given query
+	 * sequence according to the user defined parameters.
+	 * @param seq the query sequence, which has to exist until the returned
+	 *         Accessibility object is destroyed
+	 * @return a newly allocated Accessibility object or NULL in error case
+	 */
+	Accessibility* getQueryAccessibility( const RnaSequence & seq ) const;
+
 	/**
 	 * Returns a newly allocated Accessibility object for the given target
 	 * sequence according to the user defined parameters.
 	 * @param sequenceNumber the number of the sequence within the vector
 	 *         returned by getTargetSequences()
+	 * @param computeRanges if not NULL, the ED computation is restricted to
+	 *         these ranges if supported (see getTargetSeedRanges())
 	 * @return a newly allocated Accessibility object or NULL in error case
 	 */
-	Accessibility* getTargetAccessibility( const size_t sequenceNumber ) const;
+	Accessibility* getTargetAccessibility( const size_t sequenceNumber
+			, const IndexRangeList * const computeRanges = NULL ) const;
+
+	/**
+	 * Whether or not targets are to be checked for feasible seeds before
+	 * their accessibility is computed (see getTargetSeedRanges()).
+	 * @return true if the seed prefilter is to be applied
+	 */
+	bool
+	useSeedPrefilter() const;
+
+	/**
+	 * Identifies the ranges of the given target that can host an interaction
+	 * containing a seed with any of the given queries. To this end, seeds are
+	 * computed using hybridization energies and the query accessibilities
+	 * only, i.e. all target EDs are 0. Since EDs are non-negative, positions
+	 * not covered cannot be part of any seed-containing interaction.
+	 *
+	 * @param sequenceNumber the number of the sequence within the vector
+	 *         returned by getTargetSequences()
+	 * @param queryAcc the accessibilities of all queries
+	 * @return the sorted and non-overlapping ranges of the target that can
+	 *         host a seed-containing interaction; empty if no seed is feasible
+	 */
+	IndexRangeList
+	getTargetSeedRanges( const size_t sequenceNumber
+			, const std::vector< ReverseAccessibility * > & queryAcc ) const;
+
+	/**
+	 * Whether or not the combinations are screened in two stages (see
+	 * --cascadeRatio and --cascadeDeltaE), i.e. all combinations of a target
+	 * batch are predicted with a coarse model first (see
+	 * getTargetCascadeSites()) and only the best are passed to the full
+	 * prediction (see getCascadeMaxE()).
+	 * @return true if the two-stage screening is to be applied
+	 */
+	bool
+	useCascade() const;
+
+	/**
+	 * Coarse stage of the two-stage screening : predicts the mfe interaction
+	 * of the given target with each query heuristically using hybridization
+	 * energies and the query accessibilities only, i.e. all target EDs are 0.
+	 *
+	 * @param sequenceNumber the number of the sequence within the vector
+	 *         returned by getTargetSequences()
+	 * @param queryAcc the accessibilities of all queries
+	 * @param queryData the energy data of all queries (entries can be NULL)
+	 * @param coarseE OUT the coarse mfe per query (E_INF if no interaction)
+	 * @param sites OUT per query the target range covering all interactions
+	 *        of maximal length that contain the coarse mfe interaction
+	 *        (only set for queries with finite coarse mfe)
+	 */
+	void
+	getTargetCascadeSites( const size_t sequenceNumber
+			, const std::vector< ReverseAccessibility * > & queryAcc
+			, const std::vector< InteractionEnergyVrna::SequenceData * > & queryData
+			, std::vector< E_type > & coarseE
+			, std::vector< IndexRange > & sites ) const;
+
+	/**
+	 * Provides the maximal coarse energy of a combination to be passed to the
+	 * full prediction within the two-stage screening, i.e. the coarse energy
+	 * of the best --cascadeRatio fraction of all combinations restricted to
+	 * the --cascadeDeltaE margin of the best coarse energy.
+	 *
+	 * @param coarseE the coarse energies of all combinations of the batch
+	 * @return the maximal coarse energy to pass or E_INF if no combination
+	 *         has a coarse interaction
+	 */
+	E_type
+	getCascadeMaxE( const std::vector< E_type > & coarseE ) const;
 
 	/**
 	 * Access to the ranges to screen for interactions for the query with the
 	 * according sequence number.
-	 * @param energy the energy handler later used for prediction (needed for region postprocessing)
+	 * @param energy the energy handler later used for prediction (its query accessibility is used for region postprocessing)
 	 * @param sequenceNumber the number of the sequence within the vector
 	 *         returned by getQuerySequences()
 	 * @return the range list for the according sequence.
@@ -114,13 +290,125 @@ public:
 	/**
 	 * Access to the ranges to screen for interactions for the target with the
 	 * according sequence number.
-	 * @param energy the energy handler later used for prediction (needed for region postprocessing)
+	 * @param energy the energy handler later used for prediction (its target accessibility is used for region postprocessing)
 	 * @param sequenceNumber the number of the sequence within the vector
 	 *        returned by getTargetSequences()
 	 * @return the range list for the according sequence.
 	 */
 	const IndexRangeList& getTargetRanges( const InteractionEnergy & energy, const size_t sequenceNumber ) const;
 
+	/**
+	 * Access to the later targets (of the current batch) that are identical
+	 * to the target with the according sequence number, i.e. that have
+	 * the same sequence and regions. Their accessibility and prediction
+	 * results are reused from the given target.
+	 * @param sequenceNumber the number of the sequence within the vector
+	 *        returned by getTargetSequences()
+	 * @return the sequence numbers of the identical later targets
+	 */
+	const std::vector< size_t > & getTargetDuplicates( const size_t sequenceNumber ) const;
+
+	/**
+	 * Whether or not the target with the according sequence number is
+	 * identical to an earlier target (of the current batch) and thus handled
+	 * together with it (see getTargetDuplicates()).
+	 * @param sequenceNumber the number of the sequence within the vector
+	 *        returned by getTargetSequences()
+	 * @return true if the target's results are reused from an earlier target
+	 */
+	bool isTargetDuplicate( const size_t sequenceNumber ) const;
+
+	/**
+	 * Identifies the query whose accessibility is reused for the target with
+	 * the according sequence number in self-interaction mode (see
+	 * --selfInteraction), i.e. the first query with the same sequence.
+	 * @param sequenceNumber the number of the sequence within the vector
+	 *        returned by getTargetSequences()
+	 * @return the number of the first query with the same sequence or the
+	 *        number of queries if there is none or the mode is disabled
+	 */
+	size_t getSelfInteractionQuery( const size_t sequenceNumber ) const;
+
+	/**
+	 * Whether or not the combination of a target and a query is a
+	 * self-interaction (see --selfInteraction), i.e. both have the same
+	 * sequence and only one of two symmetric interactions is predicted.
+	 * @param targetNumber the number of the target sequence
+	 * @param queryNumber the number of the query sequence
+	 * @return true if self-interaction mode is enabled and both sequences
+	 *        are identical; false otherwise
+	 */
+	bool isSelfInteraction( const size_t targetNumber, const size_t queryNumber ) const;
+
+	/**
+	 * Access to the later targets (of the current batch) that are point
+	 * mutation variants of the target with the according sequence number
+	 * (see --tVariants). They are handled together with the given target to
+	 * reuse its accessibility and prediction results outside of the regions
+	 * affected by the mutation.
+	 * @param sequenceNumber the number of the sequence within the vector
+	 *        returned by getTargetSequences()
+	 * @return the sequence numbers of the variant targets
+	 */
+	const std::vector< size_t > & getTargetVariants( const size_t sequenceNumber ) const;
+
+	/**
+	 * Whether or not the target with the according sequence number is a
+	 * point mutation variant of an earlier target and thus handled together
+	 * with it (see getTargetVariants()).
+	 * @param sequenceNumber the number of the sequence within the vector
+	 *        returned by getTargetSequences()
+	 * @return true if the target is a variant of an earlier target
+	 */
+	bool isTargetVariant( const size_t sequenceNumber ) const;
+
+	/**
+	 * Provides the accessibility of a variant target, where ED values are
+	 * only recomputed for the range affected by the mutation and taken from
+	 * the accessibility of its reference target otherwise.
+	 * @param sequenceNumber the number of the variant sequence within the
+	 *        vector returned by getTargetSequences()
+	 * @param referenceAcc the accessibility of the variant's reference target
+	 * @return the newly allocated accessibility object of the variant
+	 */
+	AccessibilityVariant* getTargetVariantAccessibility( const size_t sequenceNumber, const Accessibility & referenceAcc ) const;
+
+	/**
+	 * Whether or not suboptimal interaction sites are to be checked for
+	 * their compatibility with the mfe interaction (see --fuseSites and
+	 * getTargetBlockedAccessibility()).
+	 * @return true if fused sites are to be reported; false otherwise
+	 */
+	bool
+	reportFusedSites() const;
+
+	/**
+	 * Provides the accessibility of a target, where the given range is
+	 * blocked in addition to the user-defined accessibility constraints.
+	 * For RNAplfold-based ED values, only the ED values of regions within
+	 * windows covering the blocked range are recomputed and all others are
+	 * taken from the reference accessibility.
+	 * @param sequenceNumber the number of the sequence within the vector
+	 *        returned by getTargetSequences()
+	 * @param referenceAcc the accessibility of the target without blocking
+	 * @param blocked the range of the target to be blocked
+	 * @return the newly allocated accessibility object
+	 */
+	Accessibility* getTargetBlockedAccessibility( const size_t sequenceNumber, const Accessibility & referenceAcc, const IndexRange & blocked ) const;
+
+	/**
+	 * Provides the accessibility of a query, where the given range is
+	 * blocked in addition to the user-defined accessibility constraints
+	 * (see getTargetBlockedAccessibility()).
+	 * @param sequenceNumber the number of the sequence within the vector
+	 *        returned by getQuerySequences()
+	 * @param referenceAcc the (not reversed) accessibility of the query
+	 *        without blocking
+	 * @param blocked the range of the query to be blocked
+	 * @return the newly allocated accessibility object
+	 */
+	Accessibility* getQueryBlockedAccessibility( const size_t sequenceNumber, const Accessibility & referenceAcc, const IndexRange & blocked ) const;
+
 	/**
 	 * Access to the maximal window width of a query/target sequence range to
 	 * be used for prediction using overlapping windows to save memory.
@@ -138,15 +426,49 @@ public:
 	 */
 	const size_t getWindowOverlap() const;
 
+	/**
+	 * Whether or not the target windows of window-based computations are to
+	 * be processed by a single Predictor::predictWindows() call that can
+	 * reuse the results of the window overlaps, instead of independent
+	 * predictions for each window combination.
+	 *
+	 * @return true if sliding windows are to be used
+	 */
+	bool useSlidingWindows() const;
+
+	/**
+	 * Whether or not the window combinations of a query-target combination
+	 * are to be predicted in ascending order of their lower energy bound,
+	 * such that the remaining combinations can be skipped once none of them
+	 * can improve the interactions found so far (anytime prediction).
+	 *
+	 * @return true if best-first window ordering is to be used
+	 */
+	bool isBestFirst() const;
+
 	/**
 	 * Returns a newly allocated Energy object according to the user defined
 	 * parameters.
 	 * @param accTarget the accessibility object of the target sequence
 	 * @param accQuery the (reversed) accessibility object of the query sequence
+	 * @param queryData if not NULL, the precomputed energy data of the query
+	 *        (see getQueryEnergyData()) that is reused
 	 * @return the newly allocated Energy object to be deleted by the calling
 	 * function or NULL in error case
 	 */
-	InteractionEnergy* getEnergyHandler( const Accessibility& accTarget, const ReverseAccessibility& accQuery ) const;
+	InteractionEnergy* getEnergyHandler( const Accessibility& accTarget
+								, const ReverseAccessibility& accQuery
+								, const InteractionEnergyVrna::SequenceData * queryData = NULL ) const;
+
+	/**
+	 * Returns the newly allocated energy data of a query that is independent
+	 * of the target, such that it is computed only once for all targets
+	 * (see getEnergyHandler()).
+	 * @param accQuery the (reversed) accessibility object of the query sequence
+	 * @return the newly allocated data to be deleted by the calling function
+	 *         or NULL if not supported by the energy model
+	 */
+	InteractionEnergyVrna::SequenceData* getQueryEnergyData( const ReverseAccessibility& accQuery ) const;
 
 	/**
 	 * Provides a newly allocated output handler according to the user request.
@@ -158,16 +480,69 @@ public:
 	 */
 	OutputHandler* getOutputHandler(const InteractionEnergy & energy) const;
 
+	/**
+	 * Provides a newly allocated output handler according to the user request
+	 * that writes to the given stream instead of getOutputStream(). This
+	 * enables the formatting of the output into a local buffer that is later
+	 * pushed to the final output stream in a single write.
+	 *
+	 * @param energy the energy handler used for interaction computation
+	 * @param out the stream to write the output to
+	 *
+	 * @return the newly allocated OutputHandler object to be deleted by the
+	 * calling function
+	 */
+	OutputHandler* getOutputHandler(const InteractionEnergy & energy, std::ostream & out) const;
+
+	/**
+	 * Provides a newly allocated prediction tracker according to the user
+	 * defined output, which collects the data of all predictions for the
+	 * given energy handler and writes it on destruction. Predictors are to
+	 * be provided with partial trackers of it
+	 * (see PredictionTracker::newPartialTracker()).
+	 * @param energy the interaction energy handler to be used
+	 * @return the newly allocated tracker to be deleted by the calling
+	 * function after all predictors using it or NULL if no tracking is needed
+	 */
+	PredictionTracker* getPredictionTracker( const InteractionEnergy & energy ) const;
+
 	/**
 	 * Provides a newly allocated predictor according to the user defined
 	 * parameters
 	 * @param energy the interaction energy handler to be used
 	 * @param output the output handler to be used
+	 * @param seedCache if non-NULL, the seed table shared by all windows of
+	 *        energy to be used by seed-constrained predictors
+	 *        (see getSeedCache())
+	 * @param predTracker the prediction tracker to be used (deleted by the
+	 *        predictor) or NULL if no tracking is needed
+	 *        (see getPredictionTracker())
 	 * @return the newly allocated Predictor object to be deleted by the calling
 	 * function
 	 */
 	Predictor* getPredictor( const InteractionEnergy & energy
-			, OutputHandler & output ) const;
+			, OutputHandler & output
+			, const SeedHandlerMfe * seedCache = NULL
+			, PredictionTracker * predTracker = NULL ) const;
+
+	/**
+	 * The maximal time the exact prediction of a query-target combination is
+	 * allowed to take (see getFallbackPredictor()).
+	 * @return the time budget in seconds or 0 if no budget applies
+	 */
+	double getTimeBudget() const;
+
+	/**
+	 * Provides a newly allocated heuristic predictor to be used instead of
+	 * the exact predictor if a combination exceeds the time budget
+	 * (see getTimeBudget()). The parameters are the same as for getPredictor().
+	 * @return the newly allocated Predictor object to be deleted by the
+	 *         calling function
+	 */
+	Predictor* getFallbackPredictor( const InteractionEnergy & energy
+			, OutputHandler & output
+			, const SeedHandlerMfe * seedCache = NULL
+			, PredictionTracker * predTracker = NULL ) const;
 
 
 	/**
@@ -183,9 +558,34 @@ public:
 	 * NOTE: the calling function has to remove the returned object!
 	 *
 	 * @param energy the interaction energy handler to be used
+	 * @param seedCache if non-NULL, the seed table shared by all windows of
+	 *        energy to be used (see getSeedCache())
 	 * @return a newly allocated seed handler respective the user defined seed constraints
 	 */
-	SeedHandler * getSeedHandler( const InteractionEnergy & energy ) const;
+	SeedHandler * getSeedHandler( const InteractionEnergy & energy
+			, const SeedHandlerMfe * seedCache = NULL ) const;
+
+	/**
+	 * Provides a newly allocated seed table for the given ranges that can be
+	 * shared by the seed handlers of all windows within these ranges (see
+	 * getSeedHandler()) to avoid the recomputation of seeds within window
+	 * overlaps.
+	 *
+	 * NOTE: the calling function has to remove the returned object!
+	 *
+	 * @param energy the interaction energy handler to be used
+	 * @param r1 the range of seq1 covering all windows
+	 * @param r2 the range of seq2 covering all windows
+	 * @return the filled seed table or NULL if no seed constraint or explicit
+	 *         seeds are used or if the ranges exceed maxSeedCacheCells
+	 */
+	SeedHandlerMfe * getSeedCache( const InteractionEnergy & energy
+			, const IndexRange & r1
+			, const IndexRange & r2 ) const;
+
+	//! maximal number of left seed ends covered by a seed table shared among
+	//! windows (see getSeedCache())
+	static const size_t maxSeedCacheCells;
 
 	/**
 	 * Access to the set folding temperature in Celsius.
@@ -199,6 +599,21 @@ public:
 	 */
 	OutputConstraint getOutputConstraint() const;
 
+	/**
+	 * The constraints to be applied to the interaction output generation of
+	 * a prediction that only has to report interactions that are at least as
+	 * good as a given energy (see allowWindowPruning()). The maximal energy
+	 * is restricted accordingly, if the prediction mode is not heuristic,
+	 * since heuristic predictions might otherwise report different but
+	 * equally good interactions.
+	 * @param bestE the energy of the best interaction known so far
+	 * @param symmetric whether or not both sequences are identical, such
+	 *        that only one of two symmetric interactions is to be reported
+	 *        (not applied if predictions are tracked)
+	 * @return the output constraints to be applied
+	 */
+	OutputConstraint getOutputConstraint( const E_type bestE, const bool symmetric = false ) const;
+
 	/**
 	 * The stream to write the interaction output to
 	 * @return the output stream to write interaction output to
@@ -211,6 +626,13 @@ public:
 	void
 	writeQueryAccessibility( const Accessibility & acc ) const;
 
+	/**
+	 * Writes the telemetry summary and execution trace of the run to
+	 * file/stream if requested
+	 */
+	void
+	writeTelemetry() const;
+
 	/**
 	 * Writes the query accessibility to file/stream if requested
 	 */
@@ -225,6 +647,92 @@ public:
 	bool
 	reportBestPerRegion() const;
 
+	/**
+	 * Whether or not the interactions of each window are to be written as
+	 * soon as the window is predicted (in addition to the final output of
+	 * the query-target combination)
+	 * @return true if partial output is to be written; false otherwise
+	 */
+	bool
+	reportPartial() const;
+
+	/**
+	 * Number of best interactions to be reported over all query-target
+	 * combinations (sorted by energy once all predictions are done).
+	 * @return the number of interactions to report globally (0 = report
+	 *         the interactions of each query-target combination)
+	 */
+	size_t
+	getOutputTopK() const;
+
+	/**
+	 * Whether or not the predictions for the window combinations of a
+	 * query-target combination can be pruned using the energy of the best
+	 * interaction found so far. This holds if only the mfe interaction of
+	 * each query-target combination is reported and no further prediction
+	 * tracking output is requested.
+	 * @return true if pruning based on the best energy so far is possible
+	 */
+	bool
+	allowWindowPruning() const;
+
+	/**
+	 * Whether or not prediction trackers are used to generate sequence-
+	 * specific output (e.g. minimal energy or spot probability profiles),
+	 * which requires the prediction of each sequence combination on its own.
+	 * @return true if prediction trackers are used (see getPredictionTracker())
+	 */
+	bool
+	isPredictionTracked() const;
+
+	/**
+	 * Estimates the memory needed for the prediction of a target-query
+	 * combination, i.e. the accessibility data of both sequences, the
+	 * matrices of the predictor and seed handler for one window combination
+	 * as well as the data of the pair-wise minimal energy output (if any).
+	 *
+	 * @param lengthT the length of the target sequence
+	 * @param lengthQ the length of the query sequence
+	 * @param windowT the length of the largest target window
+	 * @param windowQ the length of the largest query window
+	 * @return the estimated number of bytes
+	 */
+	size_t
+	getMemoryEstimate( const size_t lengthT
+					, const size_t lengthQ
+					, const size_t windowT
+					, const size_t windowQ ) const;
+
+	/**
+	 * Estimates the computational cost of the prediction for one window
+	 * combination, i.e. the number of matrix cells times the number of loop
+	 * energy evaluations per cell for the prediction mode and the interaction
+	 * length and loop restrictions. The value is only meaningful relative to
+	 * other costs of the same setup, e.g. to schedule expensive computations
+	 * first.
+	 *
+	 * @param windowT the length of the target window
+	 * @param windowQ the length of the query window
+	 * @return the estimated cost (arbitrary unit)
+	 */
+	double
+	getPredictionCost( const size_t windowT
+					, const size_t windowQ ) const;
+
+	/**
+	 * Provides the order in which the current target sequences are to be
+	 * processed when using multiple threads, i.e. in decreasing order of
+	 * their estimated prediction cost with all queries (longest job first),
+	 * such that no expensive target is started last and processed by a
+	 * single thread at the end of the run. To limit the reordering of the
+	 * output, targets are only reordered within blocks whose output fits
+	 * into the output order buffer (see getOutputOrderBuffer()).
+	 *
+	 * @return the indices of getTargetSequences() in processing order
+	 */
+	std::vector< size_t >
+	getTargetOrder() const;
+
 #if INTARNA_MULITHREADING
 	/**
 	 * Number of threads to be used for parallel processing of
@@ -233,6 +741,23 @@ public:
 	 */
 	size_t
 	getThreads() const;
+
+	/**
+	 * Maximal number of target accessibility objects to be held in memory
+	 * at the same time, i.e. the number of targets that are processed
+	 * concurrently.
+	 * @return the number of target accessibilities to be held at once (>0)
+	 */
+	size_t
+	getTargetAccessibilityBuffer() const;
+
+	/**
+	 * Maximal number of (target,query) combinations whose output is buffered
+	 * to write the output in input order.
+	 * @return the number of combinations to buffer (0 = no reordering)
+	 */
+	size_t
+	getOutputOrderBuffer() const;
 #endif
 
 protected:
@@ -253,7 +778,12 @@ protected:
 		OP_tAcc,
 		OP_qPu,
 		OP_tPu,
+		OP_qAccBin,
+		OP_tAccBin,
 		OP_spotProb,
+		OP_telemetry,
+		OP_telemetryCsv,
+		OP_trace,
 		OP_UNKNOWN
 	};
 
@@ -280,7 +810,12 @@ protected:
 		if (prefLC == "tacc")	{ return OutPrefixCode::OP_tAcc; } else
 		if (prefLC == "qpu")	{ return OutPrefixCode::OP_qPu; } else
 		if (prefLC == "tpu")	{ return OutPrefixCode::OP_tPu; } else
+		if (prefLC == "qaccbin")	{ return OutPrefixCode::OP_qAccBin; } else
+		if (prefLC == "taccbin")	{ return OutPrefixCode::OP_tAccBin; } else
 		if (prefLC == "spotprob")	{ return OutPrefixCode::OP_spotProb; } else
+		if (prefLC == "telemetry")	{ return OutPrefixCode::OP_telemetry; } else
+		if (prefLC == "telemetrycsv")	{ return OutPrefixCode::OP_telemetryCsv; } else
+		if (prefLC == "trace")	{ return OutPrefixCode::OP_trace; } else
 		// not known
 		return OutPrefixCode::OP_UNKNOWN;
 	}
@@ -383,6 +918,9 @@ protected:
 	//! short option list
 	boost::program_options::options_description opts_cmdline_short;
 
+	//! options that can be overwritten by the parameter sets of a sweep
+	boost::program_options::options_description opts_sweep;
+
 	//! central result code to be set by validate_* functions in error case
 	ReturnCode parsingCode;
 
@@ -433,6 +971,22 @@ protected:
 	IndexRangeList tSet;
 	//! string encoding of tSet
 	std::string tSetString;
+	//! maximal number of target sequences to be held in memory at once
+	//! (0 = read all target sequences at once)
+	NumberParameter<int> tBatchSize;
+	//! the stream to read the next target batch from (NULL if all read)
+	std::istream * targetStream;
+	//! number of FASTA records read from targetStream so far
+	size_t targetStreamRecords;
+	//! number of target sequences of all batches preceding the current one
+	size_t targetBatchOffset;
+	//! number of shards the target sequences are distributed to
+	NumberParameter<int> tShardCount;
+	//! index of the shard of target sequences to be processed (starting with 1)
+	NumberParameter<int> tShardIndex;
+	//! for sharded input : the index of each target of this shard within
+	//! the full target input (empty if sharding is disabled)
+	std::vector<size_t> tShardTargets;
 	//! accessibility computation mode for target sequences
 	CharParameter tAcc;
 	//! window length for target accessibility computation (plFold)
@@ -451,6 +1005,18 @@ protected:
 	std::string tRegionString;
 	//! the list of interaction intervals for each target sequence
 	mutable IndexRangeListVec tRegion;
+	//! for each target sequence the number of the first identical target
+	std::vector< size_t > tOrigin;
+	//! for each target sequence the numbers of later identical targets
+	std::vector< std::vector< size_t > > tDuplicates;
+	//! the string encoding of the point mutations of the target to screen
+	std::string tVariantsString;
+	//! for each target sequence the number of the target it is a variant of
+	std::vector< size_t > tReference;
+	//! for each target sequence the mutated position (if it is a variant)
+	std::vector< size_t > tVariantPosition;
+	//! for each target sequence the numbers of its variant targets
+	std::vector< std::vector< size_t > > tVariants;
 	//! maximal length of automatically detected highly accessible regions for
 	//! for target sequences; if 0, no automatic detection is done
 	NumberParameter<int> tRegionLenMax;
@@ -484,6 +1050,9 @@ protected:
 	std::string seedQRange;
 	//! intervals in target for seed search
 	std::string seedTRange;
+	//! whether or not targets are checked for feasible seeds before
+	//! their accessibility computation
+	bool seedPrefilter;
 	//! the final seed constraint to be used
 	mutable SeedConstraint * seedConstraint;
 
@@ -494,19 +1063,53 @@ protected:
 	CharParameter pred;
 	//! the prediction mode (heuristic, space-efficient, exact)
 	CharParameter predMode;
+	//! whether or not DP cells are to be pruned via energy lower bounds
+	bool pruning;
+	//! whether or not traceback pointers are to be stored by heuristic predictors
+	bool storeTrace;
 #if INTARNA_MULITHREADING
 	//! number of threads = number of parallel predictors running
 	NumberParameter<int> threads;
+	//! maximal number of target accessibilities held in memory at once
+	NumberParameter<int> tAccBuffer;
+	//! maximal number of combinations buffered to write output in input order
+	NumberParameter<int> outOrderBuffer;
 #endif
 	//! the window width to be used for window-based computations
 	NumberParameter<int> windowWidth;
 	//! the window overlap to be used for window-based computations
 	NumberParameter<int> windowOverlap;
+	//! the maximal memory (in MB) a 4D-space prediction (--mode=E) is allowed to use
+	NumberParameter<int> memLimit;
+	//! the maximal time (in seconds) the exact prediction of a query-target
+	//! combination is allowed to take before falling back to the heuristic
+	NumberParameter<double> timeBudget;
+	//! whether or not the target windows are processed by a single predictor
+	//! that reuses the results of the window overlaps
+	bool windowSliding;
+	//! whether or not the window width is chosen via the cost model
+	bool windowAuto;
+	//! whether or not window combinations are predicted best-first
+	bool bestFirst;
+	//! whether or not identical targets and queries share their accessibility
+	//! and only one of two symmetric interactions is predicted
+	bool selfInteraction;
+	//! whether or not suboptimal sites are checked for their compatibility
+	//! with the mfe interaction via predictions with blocked sites
+	bool fuseSites;
+	//! fraction of the combinations of a target batch passed from the coarse
+	//! to the full prediction (two-stage screening)
+	NumberParameter<double> cascadeRatio;
+	//! maximal difference of the coarse energy of a combination passed to the
+	//! full prediction to the best coarse energy of the target batch
+	NumberParameter<double> cascadeDeltaE;
 
 	//! the selected energy model
 	CharParameter energy;
 	//! the provided energy parameter file of the VRNA package
 	std::string energyFile;
+	//! (optional) directory of the on-disk VRNA parameter cache
+	std::string energyCacheDir;
 
 	//! where to write the output to and for each in what format
 //	std::string out;
@@ -535,17 +1138,221 @@ protected:
 	//! for all region combinations or only the best for each query-target
 	//! combination
 	bool outPerRegion;
+	//! whether or not the interactions of each window are written as soon as
+	//! the window is predicted
+	bool outPartial;
+	//! number of best interactions to report over all combinations (0=off)
+	NumberParameter<int> outTopK;
 	//! for SpotProb output : spots to be tracked
 	std::string outSpotProbSpots;
 
 	//! (optional) file name for log output
 	std::string logFileName;
 
+	//! whether or not prediction requests are read from STDIN (server mode)
+	bool serverMode;
+	//! maximal number of query accessibilities cached in server mode
+	NumberParameter<int> serverCache;
+	//! number of prediction requests parsed so far
+	size_t requestNumber;
+
+	//! (optional) file name of the parameter sets to sweep over
+	std::string sweepFile;
+	//! the parameter sets to sweep over (arguments overwriting opts_sweep)
+	std::vector< std::string > sweepSets;
+	//! the command line values of opts_sweep (arguments)
+	std::string sweepBase;
+
+	//! (optional) file name of the checkpoint journal
+	std::string checkpointFile;
+	//! whether or not the run recorded in the checkpoint journal is resumed
+	bool resume;
+	//! the checkpoint journal or NULL if no checkpointing is done
+	CheckpointJournal * checkpoint;
+
+	//! (optional) directory of the on-disk accessibility cache
+	std::string accCacheDir;
+	//! the accessibility cache or NULL if no caching is done
+	AccessibilityCache * accCache;
+	//! whether or not cached accessibility values are memory mapped
+	bool accCacheMap;
+
+	//! (optional) directory of the on-disk result store
+	std::string resultStoreDir;
+	//! the result store or NULL if no results are stored
+	ResultStore * resultStore;
+	//! the arguments the output depends on including the content hashes of
+	//! referenced input files (for the result store keys)
+	std::string resultParameters;
+
+	//! whether or not ED values are stored in reduced precision
+	bool accLowMem;
+
+	//! whether or not only the estimated costs are reported (no computation)
+	bool dryRun;
+
 	//! the vienna energy parameter handler initialized by #parse()
 	mutable VrnaHandler vrnaHandler;
 
 protected:
 
+	/**
+	 * Estimates the memory needed for the prediction of a target-query
+	 * combination for the given prediction mode (see public variant).
+	 *
+	 * @param lengthT the length of the target sequence
+	 * @param lengthQ the length of the query sequence
+	 * @param windowT the length of the largest target window
+	 * @param windowQ the length of the largest query window
+	 * @param mode the prediction mode to be used (see predMode)
+	 * @return the estimated number of bytes
+	 */
+	size_t
+	getMemoryEstimate( const size_t lengthT
+					, const size_t lengthQ
+					, const size_t windowT
+					, const size_t windowQ
+					, const char mode ) const;
+
+	/**
+	 * Estimates the computational cost of the prediction of a target-query
+	 * combination, i.e. the sum of the costs of all window combinations
+	 * (see getPredictionCost()).
+	 *
+	 * @param lengthT the length of the target sequence
+	 * @param lengthQ the length of the query sequence
+	 * @param windowWidth the window width (0 = no windows)
+	 * @param windowOverlap the overlap of successive windows
+	 * @return the estimated cost (arbitrary unit)
+	 */
+	double
+	getPredictionCost( const size_t lengthT
+					, const size_t lengthQ
+					, const size_t windowWidth
+					, const size_t windowOverlap ) const;
+
+	/**
+	 * Chooses the window width with the minimal estimated parallel runtime
+	 * of all target-query combinations (see getPredictionCost()), i.e. the
+	 * maximum of the total cost distributed among a fixed number of parallel
+	 * tasks and the cost of the most expensive window combination. Smaller
+	 * windows balance the work but increase the redundant computation of the
+	 * window overlaps. Among almost equal estimates, the fewest windows are
+	 * preferred. The number of threads is not considered, such that the
+	 * results do not depend on it.
+	 *
+	 * @param windowOverlap the overlap of successive windows
+	 * @return the window width to be used (0 = no windows)
+	 */
+	size_t
+	getAutoWindowWidth( const size_t windowOverlap ) const;
+
+	/**
+	 * Provides the accessibility of a sequence, where the given range is
+	 * blocked in addition to the user-defined accessibility constraints
+	 * (see getTargetBlockedAccessibility()).
+	 *
+	 * @param seq the sequence of interest
+	 * @param referenceAcc the accessibility of the sequence without blocking
+	 * @param blocked the range of the sequence to be blocked
+	 * @param acc the accessibility computation mode of the sequence
+	 * @param accW the RNAplfold window width of the sequence
+	 * @param accL the RNAplfold maximal base pair span of the sequence
+	 * @param intLenMax the maximal interaction length of the sequence
+	 * @param accConstr the user-defined accessibility constraint
+	 * @param shape the SHAPE reactivity data file of the sequence
+	 * @param shapeMethod the SHAPE method to be used
+	 * @param shapeConversion the SHAPE conversion to be used
+	 * @return the newly allocated accessibility object
+	 */
+	Accessibility*
+	getBlockedAccessibility( const RnaSequence & seq
+					, const Accessibility & referenceAcc
+					, const IndexRange & blocked
+					, const char acc
+					, const size_t accW
+					, const size_t accL
+					, const size_t intLenMax
+					, const std::string & accConstr
+					, const std::string & shape
+					, const std::string & shapeMethod
+					, const std::string & shapeConversion ) const;
+
+	/**
+	 * Provides a newly allocated predictor according to the user defined
+	 * parameters that works on the given energy handler without transposition
+	 * (see getPredictor() and getTransposedPredictor()).
+	 * @param energy the interaction energy handler to be used
+	 * @param output the output handler to be used
+	 * @param seedCache the seed table shared by all windows of energy or NULL
+	 * @param predTracker the prediction tracker to be used or NULL
+	 * @return the newly allocated Predictor object to be deleted by the calling
+	 * function
+	 */
+	Predictor*
+	getDirectPredictor( const InteractionEnergy & energy
+					, OutputHandler & output
+					, const SeedHandlerMfe * seedCache
+					, PredictionTracker * predTracker ) const;
+
+	/**
+	 * Provides a newly allocated predictor that computes the exact prediction
+	 * for the transposed problem, i.e. with the query as first and the
+	 * (reversed) target as second sequence, if the target is much longer than
+	 * the query (see PredictorTransposed::isTransposable()). Since the second
+	 * sequence is the contiguous dimension of all DP matrices, this yields
+	 * longer inner loops and a better memory locality. Transposition is only
+	 * done if the prediction is independent of the orientation, i.e. for
+	 * exact single-site predictions with identical target and query seed
+	 * constraints.
+	 *
+	 * The decision is based on the lengths of the predicted ranges, which are
+	 * bounded by the window width (see --windowWidth). Ranges not worth a
+	 * transposition are predicted by a direct predictor
+	 * (see getDirectPredictor()). The reversed target accessibility is not
+	 * materialized, such that no copy of its ED values is needed.
+	 *
+	 * @param energy the interaction energy handler to be used
+	 * @param output the output handler to be used
+	 * @param seedCache the seed table shared by all windows of energy or
+	 *        NULL (no transposition if non-NULL)
+	 * @param predTracker the prediction tracker to be used or NULL
+	 *        (no transposition if non-NULL)
+	 * @return the newly allocated PredictorTransposed object to be deleted by
+	 * the calling function or NULL if no transposition is to be done
+	 */
+	Predictor*
+	getTransposedPredictor( const InteractionEnergy & energy
+					, OutputHandler & output
+					, const SeedHandlerMfe * seedCache
+					, const PredictionTracker * predTracker ) const;
+
+	/**
+	 * Returns a newly allocated energy object for the transposed problem
+	 * (see getTransposedPredictor()), i.e. the target and query specific
+	 * parameters are exchanged.
+	 * @param accQuery the accessibility object of the query sequence
+	 * @param accTarget the (reversed) accessibility object of the target
+	 *        sequence
+	 * @return the newly allocated Energy object to be deleted by the calling
+	 * function
+	 */
+	InteractionEnergy*
+	getTransposedEnergyHandler( const Accessibility& accQuery
+					, const ReverseAccessibility& accTarget ) const;
+
+	/**
+	 * Writes the estimated costs of the run without computing anything, i.e.
+	 * the accessibility computation cost and memory of each sequence as well
+	 * as the number of window combinations, DP matrix cells, prediction cost
+	 * (see getPredictionCost()) and peak memory (see getMemoryEstimate())
+	 * of each target-query combination, followed by the totals of the run.
+	 *
+	 * @param out the stream to write to
+	 */
+	void
+	writeDryRun( std::ostream & out ) const;
+
 	/**
 	 * sets the stdinUsed member to true if so far false or raises an exception
 	 * if it is already true.
@@ -652,6 +1459,40 @@ protected:
 	 */
 	void validate_tSet(const std::string & value);
 
+	/**
+	 * Validates the target batch size argument.
+	 * @param value the argument value to validate
+	 */
+	void validate_tBatchSize(const int & value);
+
+	/**
+	 * Validates the target shard count argument.
+	 * @param value the argument value to validate
+	 */
+	void validate_tShardCount(const int & value);
+
+	/**
+	 * Validates the target shard index argument.
+	 * @param value the argument value to validate
+	 */
+	void validate_tShardIndex(const int & value);
+
+	/**
+	 * Distributes the target sequences among tShardCount shards such that
+	 * the estimated computational cost (sequence length product) is balanced
+	 * and removes all targets not assigned to shard tShardIndex.
+	 * Within the shard, the input order of the targets is preserved.
+	 */
+	void selectTargetShard();
+
+	/**
+	 * Provides the index of a target sequence within the full target input,
+	 * i.e. respecting batch-wise input and sharding.
+	 * @param sequenceNumber the index within getTargetSequences()
+	 * @return the index within the full target input (starting with 0)
+	 */
+	size_t getTargetInputNumber( const size_t sequenceNumber ) const;
+
 	/**
 	 * Validates the target accessibility argument.
 	 * @param value the argument value to validate
@@ -830,6 +1671,12 @@ protected:
 	 */
 	void validate_outNumber(const int & value);
 
+	/**
+	 * Validates the outTopK argument.
+	 * @param value the argument value to validate
+	 */
+	void validate_outTopK(const int & value);
+
 	/**
 	 * Validates the outOverlap argument.
 	 * @param value the argument value to validate
@@ -866,8 +1713,26 @@ protected:
 	 * @param value the argument value to validate
 	 */
 	void validate_threads( const int & value);
+
+	/**
+	 * Validates the tAccBuffer argument.
+	 * @param value the argument value to validate
+	 */
+	void validate_tAccBuffer( const int & value);
+
+	/**
+	 * Validates the outOrderBuffer argument.
+	 * @param value the argument value to validate
+	 */
+	void validate_outOrderBuffer( const int & value);
 #endif
 
+	/**
+	 * Validates the serverCache argument.
+	 * @param value the argument value to validate
+	 */
+	void validate_serverCache( const int & value);
+
 	/**
 	 * Validates the windowWidth argument.
 	 * @param value the argument value to validate
@@ -875,10 +1740,34 @@ protected:
 	void validate_windowWidth( const int & value);
 
 	/**
-	 * Validates the windowOverlap argument.
+	 * Validates the windowOverlap argument.
+	 * @param value the argument value to validate
+	 */
+	void validate_windowOverlap( const int & value);
+
+	/**
+	 * Validates the memLimit argument.
+	 * @param value the argument value to validate
+	 */
+	void validate_memLimit( const int & value);
+
+	/**
+	 * Validates the timeBudget argument.
+	 * @param value the argument value to validate
+	 */
+	void validate_timeBudget( const double & value);
+
+	/**
+	 * Validates the cascadeRatio argument.
+	 * @param value the argument value to validate
+	 */
+	void validate_cascadeRatio( const double & value);
+
+	/**
+	 * Validates the cascadeDeltaE argument.
 	 * @param value the argument value to validate
 	 */
-	void validate_windowOverlap( const int & value);
+	void validate_cascadeDeltaE( const double & value);
 
 	////////////  GENERIC TESTS  /////////////////
 
@@ -958,11 +1847,56 @@ protected:
 	 * @param sequences the container to fill
 	 * @param seqSubset the indices of the input sequences to store (all other
 	 *                  ignored)
-	 */
-	void parseSequencesFasta( const std::string & paramName,
+	 * @param seqNumber IN/OUT the number of FASTA records read from input so
+	 *                  far, needed to apply seqSubset when reading in batches
+	 * @param maxToStore the maximal number of sequences to be added to the
+	 *                  container; parsing stops before the next record if
+	 *                  reached; if 0, all sequences are read
+	 * @return true if all (relevant) data was read from input; false if
+	 *         parsing stopped since maxToStore sequences were added
+	 */
+	bool parseSequencesFasta( const std::string & paramName,
 					std::istream& input,
 					RnaSequenceVec& sequences,
-					const IndexRangeList & seqSubset );
+					const IndexRangeList & seqSubset,
+					size_t & seqNumber,
+					const size_t maxToStore = 0 );
+
+	/**
+	 * Reads the next batch of target sequences from targetStream into
+	 * target and validates the sequences.
+	 * If all data is read, targetStream is closed and set to NULL.
+	 *
+	 * @throws std::runtime_error if a target sequence is not valid
+	 */
+	void readTargetBatch();
+
+	/**
+	 * Parses a server mode request and replaces the current query and target
+	 * sequences accordingly.
+	 * @param request the request line to parse
+	 * @throws std::runtime_error if the request is invalid
+	 */
+	void parseRequest( const std::string & request );
+
+	/**
+	 * Checks the consistency of parameter combinations that depend on
+	 * parameters that are subject to sweeps (e.g. the minimal sequence
+	 * length for seedBP, identical target and query restrictions for
+	 * --selfInteraction, window and interaction length restrictions).
+	 * Called by parse() and for each parameter set by parseSweepSet().
+	 * @throws boost::program_options::error if a combination is invalid
+	 */
+	void validateParameterCombinations() const;
+
+	/**
+	 * Parses a parameter set of a sweep and overwrites the according
+	 * parameters. Parameters not given by the set are reset to their
+	 * command line values.
+	 * @param sweepSet the arguments of the parameter set to parse
+	 * @throws std::runtime_error if the parameter set is invalid
+	 */
+	void parseSweepSet( const std::string & sweepSet );
 
 	/**
 	 * Checks whether or not a sequence container holds a specific number of
@@ -1031,6 +1965,38 @@ protected:
 				, const RnaSequenceVec & sequences
 				, IndexRangeListVec & rangeList );
 
+	/**
+	 * Removes all ambiguous stretches (e.g. runs of N) that cannot be part of
+	 * any interaction from the given regions, i.e. region ends and runs longer
+	 * than the maximal interior loop length (--tIntLoopMax). Thus, neither the
+	 * accessibility nor the interactions are computed for these stretches.
+	 * Not applied if regions are identified automatically (--tRegionLenMax).
+	 * @param sequences the parsed target sequences the regions are for
+	 * @param rangeList IN/OUT the regions per sequence
+	 */
+	void
+	removeAmbiguousRuns( const RnaSequenceVec & sequences
+				, IndexRangeListVec & rangeList ) const;
+
+	/**
+	 * Identifies identical targets, i.e. targets with the same sequence and
+	 * regions, to compute accessibility and prediction only once for them.
+	 * Identification is disabled if accessibilities are read from
+	 * (sequence-specific) files or sequence-specific prediction profiles
+	 * are written.
+	 */
+	void
+	updateTargetDuplicates();
+
+	/**
+	 * Parses the point mutations of tVariantsString and appends a variant
+	 * target for each mutation to the target sequences (see --tVariants).
+	 * The regions of the variants are copied from the reference target.
+	 * If no mutations are given, no target is a variant.
+	 */
+	void
+	parseTargetVariants();
+
 	/**
 	 * Checks whether or not any command line argument were parsed. Throws a
 	 * std::runtime_error if not.
@@ -1052,9 +2018,10 @@ protected:
 	 * Writes the accessibility to file or stream if requested by the user
 	 * @param acc the accessibility data assigned
 	 * @param fileOrStream the name of file/stream to write to
-	 * @param (true) writes ED values, (false) writes Pu values
+	 * @param format the format to write, i.e. ED values or Pu values in
+	 *        RNAplfold text format or ED values in binary format
 	 */
-	void writeAccessibility( const Accessibility& acc, const std::string & fileOrStream, const bool writeED ) const;
+	void writeAccessibility( const Accessibility& acc, const std::string & fileOrStream, const AccessibilityFromStream::InStreamType format ) const;
 
 	/**
 	 * Adds a generic file prefix for input/output files for the given query
@@ -1367,6 +2334,43 @@ void CommandLineParsing::validate_tAccConstr(const std::string & value)
 
 ////////////////////////////////////////////////////////////////////////////
 
+inline
+void CommandLineParsing::validate_tBatchSize(const int & value)
+{
+	// forward check to general method
+	validate_numberArgument("tBatchSize", tBatchSize, value);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+void CommandLineParsing::validate_tShardCount(const int & value)
+{
+	// forward check to general method
+	validate_numberArgument("tShardCount", tShardCount, value);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+void CommandLineParsing::validate_tShardIndex(const int & value)
+{
+	// forward check to general method
+	validate_numberArgument("tShardIndex", tShardIndex, value);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+CommandLineParsing::
+getTargetInputNumber( const size_t sequenceNumber ) const
+{
+	return tShardTargets.empty() ? targetBatchOffset+sequenceNumber : tShardTargets.at(sequenceNumber);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 inline
 void CommandLineParsing::validate_tAccFile(const std::string & value)
 {
@@ -1626,6 +2630,16 @@ void CommandLineParsing::validate_outputTarget(
 		return;
 	}
 
+	// check if compression is supported
+	CompressedOutputBuffer::Format format;
+	if ( CompressedOutputBuffer::getFormat( value, format )
+		&& ! CompressedOutputBuffer::isSupported( format ) )
+	{
+		LOG(ERROR) <<argName<<" : compressed output of '"<<value<<"' not supported by this build (missing "<<(format == CompressedOutputBuffer::GZIP ? "zlib" : "zstd")<<" library)";
+		updateParsingCode(ReturnCode::STOP_PARSING_ERROR);
+		return;
+	}
+
 	// check if parent directory exists
 	boost::filesystem::path p(value);
 	if ( !p.parent_path().empty() && ! boost::filesystem::exists(p.parent_path()) ) {
@@ -1640,7 +2654,8 @@ void CommandLineParsing::validate_outputTarget(
 		bool fileCanNotBeOverwritten = false;
 		try {
 			// open dummy file stream to check if writeable
-			std::ofstream file(value);
+			// (append to keep the content, e.g. for --resume)
+			std::ofstream file(value, std::ios_base::app);
 			if (!file) {
 				fileCanNotBeOverwritten = true;
 			}
@@ -1740,6 +2755,14 @@ void CommandLineParsing::validate_outNumber(const int & value) {
 
 ////////////////////////////////////////////////////////////////////////////
 
+inline
+void CommandLineParsing::validate_outTopK(const int & value) {
+	// forward check to general method
+	validate_numberArgument("outTopK", outTopK, value);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 inline
 void CommandLineParsing::validate_outOverlap(const char & value) {
 	// forward check to general method
@@ -1783,6 +2806,37 @@ void CommandLineParsing::validate_threads(const int & value)
 
 ////////////////////////////////////////////////////////////////////////////
 
+#if INTARNA_MULITHREADING
+inline
+void CommandLineParsing::validate_tAccBuffer(const int & value)
+{
+	// forward check to general method
+	validate_numberArgument("tAccBuffer", tAccBuffer, value);
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+
+#if INTARNA_MULITHREADING
+inline
+void CommandLineParsing::validate_outOrderBuffer(const int & value)
+{
+	// forward check to general method
+	validate_numberArgument("outOrderBuffer", outOrderBuffer, value);
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+void CommandLineParsing::validate_serverCache(const int & value)
+{
+	// forward check to general method
+	validate_numberArgument("serverCache", serverCache, value);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 inline
 void CommandLineParsing::validate_windowWidth(const int & value)
 {
@@ -1801,6 +2855,42 @@ void CommandLineParsing::validate_windowOverlap(const int & value)
 
 ////////////////////////////////////////////////////////////////////////////
 
+inline
+void CommandLineParsing::validate_memLimit(const int & value)
+{
+	// forward check to general method
+	validate_numberArgument("memLimit", memLimit, value);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+void CommandLineParsing::validate_timeBudget(const double & value)
+{
+	// forward check to general method
+	validate_numberArgument("timeBudget", timeBudget, value);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+void CommandLineParsing::validate_cascadeRatio(const double & value)
+{
+	// forward check to general method
+	validate_numberArgument("cascadeRatio", cascadeRatio, value);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+void CommandLineParsing::validate_cascadeDeltaE(const double & value)
+{
+	// forward check to general method
+	validate_numberArgument("cascadeDeltaE", cascadeDeltaE, value);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 inline
 void
 CommandLineParsing::
@@ -1812,14 +2902,21 @@ writeQueryAccessibility( const Accessibility & acc ) const
 		writeAccessibility( acc
 				// get file name prefixed with sequence number if needed
 				, getFullFilename(outPrefix2streamName.at(OutPrefixCode::OP_qAcc), NULL, &(acc.getSequence()))
-				, true );
+				, AccessibilityFromStream::ED_RNAplfold_Text );
 	}
 	if (!outPrefix2streamName.at(OutPrefixCode::OP_qPu).empty()) {
 		VLOG(2) <<"writing unpaired probabilities for query '"<<acc.getSequence().getId()<<"' to "<<outPrefix2streamName.at(OutPrefixCode::OP_qPu);
 		writeAccessibility( acc
 				// get file name prefixed with sequence number if needed
 				, getFullFilename(outPrefix2streamName.at(OutPrefixCode::OP_qPu), NULL, &(acc.getSequence()))
-				, false );
+				, AccessibilityFromStream::Pu_RNAplfold_Text );
+	}
+	if (!outPrefix2streamName.at(OutPrefixCode::OP_qAccBin).empty()) {
+		VLOG(2) <<"writing binary ED values for query '"<<acc.getSequence().getId()<<"' to "<<outPrefix2streamName.at(OutPrefixCode::OP_qAccBin);
+		writeAccessibility( acc
+				// get file name prefixed with sequence number if needed
+				, getFullFilename(outPrefix2streamName.at(OutPrefixCode::OP_qAccBin), NULL, &(acc.getSequence()))
+				, AccessibilityFromStream::ED_IntaRNA_Binary );
 	}
 }
 
@@ -1836,14 +2933,21 @@ writeTargetAccessibility( const Accessibility & acc ) const
 		writeAccessibility( acc
 				// get file name prefixed with sequence number if needed
 				, getFullFilename(outPrefix2streamName.at(OutPrefixCode::OP_tAcc), &(acc.getSequence()), NULL)
-				, true );
+				, AccessibilityFromStream::ED_RNAplfold_Text );
 	}
 	if (!outPrefix2streamName.at(OutPrefixCode::OP_tPu).empty()) {
 		VLOG(2) <<"writing unpaired probabilities for target '"<<acc.getSequence().getId()<<"' to "<<outPrefix2streamName.at(OutPrefixCode::OP_tPu);
 		writeAccessibility( acc
 				// get file name prefixed with sequence number if needed
 				, getFullFilename(outPrefix2streamName.at(OutPrefixCode::OP_tPu), &(acc.getSequence()), NULL)
-				, false );
+				, AccessibilityFromStream::Pu_RNAplfold_Text );
+	}
+	if (!outPrefix2streamName.at(OutPrefixCode::OP_tAccBin).empty()) {
+		VLOG(2) <<"writing binary ED values for target '"<<acc.getSequence().getId()<<"' to "<<outPrefix2streamName.at(OutPrefixCode::OP_tAccBin);
+		writeAccessibility( acc
+				// get file name prefixed with sequence number if needed
+				, getFullFilename(outPrefix2streamName.at(OutPrefixCode::OP_tAccBin), &(acc.getSequence()), NULL)
+				, AccessibilityFromStream::ED_IntaRNA_Binary );
 	}
 }
 
@@ -1861,6 +2965,125 @@ getThreads() const
 
 ////////////////////////////////////////////////////////////////////////////
 
+#if INTARNA_MULITHREADING
+inline
+size_t
+CommandLineParsing::
+getTargetAccessibilityBuffer() const
+{
+	return tAccBuffer.val == 0 ? getThreads() : tAccBuffer.val;
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+
+#if INTARNA_MULITHREADING
+inline
+size_t
+CommandLineParsing::
+getOutputOrderBuffer() const
+{
+	return outOrderBuffer.val;
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+CommandLineParsing::
+isServerMode() const
+{
+	return serverMode;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+CommandLineParsing::
+getServerCache() const
+{
+	// sweep mode : all query accessibilities are reused over the parameter sets
+	return serverMode ? serverCache.val : (sweepSets.size() > 1 ? query.size() : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+CommandLineParsing::
+isAccLowMem() const
+{
+	return accLowMem;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+const std::vector< size_t > &
+CommandLineParsing::
+getTargetDuplicates( const size_t sequenceNumber ) const
+{
+	checkIfParsed();
+	return tDuplicates.at(sequenceNumber);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+CommandLineParsing::
+isTargetDuplicate( const size_t sequenceNumber ) const
+{
+	checkIfParsed();
+	return tOrigin.at(sequenceNumber) != sequenceNumber;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+const std::vector< size_t > &
+CommandLineParsing::
+getTargetVariants( const size_t sequenceNumber ) const
+{
+	checkIfParsed();
+	return tVariants.at(sequenceNumber);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+CommandLineParsing::
+isTargetVariant( const size_t sequenceNumber ) const
+{
+	checkIfParsed();
+	return tReference.at(sequenceNumber) != sequenceNumber;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+CheckpointJournal *
+CommandLineParsing::
+getCheckpointJournal() const
+{
+	return checkpoint;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+const ResultStore *
+CommandLineParsing::
+getResultStore() const
+{
+	return resultStore;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 inline
 std::string
 CommandLineParsing::
@@ -1880,14 +3103,14 @@ getFullFilename( const std::string & fileNamePath, const RnaSequence * target, c
 
 	// generate target only
 	if (target != NULL && query == NULL) {
-		if (getTargetSequences().size() > 1) {
+		if (getTargetSequences().size() > 1 || targetBatchOffset > 0 || targetStream != NULL || !tShardTargets.empty()) {
 			fileID += "s";
 //			prefix += "t";
 			// search for index of the target sequence
 			for (size_t t = 0; t < getTargetSequences().size(); t++) {
 				if (getTargetSequences().at(t) == *target) {
 					// indexing starts with 1
-					fileID += toString(t+1);
+					fileID += toString(getTargetInputNumber(t)+1);
 					break;
 				}
 			}
@@ -1910,13 +3133,13 @@ getFullFilename( const std::string & fileNamePath, const RnaSequence * target, c
 	} else
 	// generate combined part
 	{
-		if (getQuerySequences().size() > 1 || getTargetSequences().size() > 1) {
+		if (getQuerySequences().size() > 1 || getTargetSequences().size() > 1 || targetBatchOffset > 0 || targetStream != NULL || !tShardTargets.empty()) {
 			fileID += "t";
 			// search for index of the target sequence
 			for (size_t t = 0; t < getTargetSequences().size(); t++) {
 				if (getTargetSequences().at(t) == *target) {
 					// indexing starts with 1
-					fileID += toString(t+1);
+					fileID += toString(getTargetInputNumber(t)+1);
 					break;
 				}
 			}
@@ -1959,6 +3182,56 @@ reportBestPerRegion() const
 
 ////////////////////////////////////////////////////////////////////////////
 
+inline
+bool
+CommandLineParsing::
+reportPartial() const
+{
+	return outPartial;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+CommandLineParsing::
+getOutputTopK() const
+{
+	return outTopK.val;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+CommandLineParsing::
+useSlidingWindows() const
+{
+	return windowSliding && windowWidth.val > 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+CommandLineParsing::
+isBestFirst() const
+{
+	return bestFirst;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+CommandLineParsing::
+reportFusedSites() const
+{
+	return fuseSites;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 
 
 
@@ -1,8 +1,13 @@
 
 #include "IntaRNA/general.h"
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <sstream>
 #include <exception>
+#include <map>
+#include <vector>
 
 #if INTARNA_MULITHREADING
 	#include <omp.h>
@@ -14,17 +19,476 @@
 
 #include "IntaRNA/RnaSequence.h"
 #include "IntaRNA/Accessibility.h"
+#include "IntaRNA/AccessibilityAlias.h"
+#include "IntaRNA/AccessibilityDisabled.h"
+#include "IntaRNA/AccessibilityVariant.h"
+#include "IntaRNA/AsyncLog.h"
+#include "IntaRNA/CheckpointJournal.h"
 #include "IntaRNA/InteractionEnergy.h"
+#include "IntaRNA/NumaTopology.h"
 #include "IntaRNA/Predictor.h"
 #include "IntaRNA/OutputHandler.h"
 #include "IntaRNA/OutputHandlerIntaRNA1.h"
 #include "IntaRNA/OutputHandlerInteractionList.h"
+#include "IntaRNA/OutputReorderBuffer.h"
+#include "IntaRNA/OutputTopK.h"
+#include "IntaRNA/Telemetry.h"
 
 // initialize logging for binary
 INITIALIZE_EASYLOGGINGPP
 
 using namespace IntaRNA;
 
+/////////////////////////////////////////////////////////////////////
+/**
+ * Destroys all cached accessibility objects including the sequence objects
+ * they are based on and clears the cache.
+ *
+ * @param cache the accessibility cache to clear
+ */
+void
+clearAccessibilityCache( std::map< std::string, ReverseAccessibility * > & cache )
+{
+	for (auto entry = cache.begin(); entry != cache.end(); entry++) {
+		// this is a hack to cleanup the original accessibility object and
+		// the sequence copy it is based on
+		Accessibility* accOrig = &(const_cast<Accessibility&>(entry->second->getAccessibilityOrigin()) );
+		RnaSequence* seq = &(const_cast<RnaSequence&>(accOrig->getSequence()));
+		 INTARNA_CLEANUP( accOrig );
+		 INTARNA_CLEANUP( seq );
+		// cleanup (now broken) reverse accessibility object
+		 INTARNA_CLEANUP( entry->second );
+	}
+	cache.clear();
+}
+
+/////////////////////////////////////////////////////////////////////
+/**
+ * Formats the interactions predicted for a target-query combination.
+ *
+ * @param parameters the parsed program parameters
+ * @param energy the energy handler of the target-query combination to report
+ * @param interactions the interactions to report
+ * @param target if not NULL, the interactions are reported for this target
+ *        sequence (identical to the predicted one) instead
+ * @param addSeparator whether or not a separator has to be added for
+ *        IntaRNA v1 output
+ * @param out the stream to write the output to
+ * @param topK if not NULL, each interaction is formatted on its own and
+ *        forwarded to this global top-k output (if competitive) instead of
+ *        writing it to out
+ * @param index the index of the target-query combination (output order)
+ * @return the number of reported interactions
+ */
+size_t
+reportInteractions( const CommandLineParsing & parameters
+					, const InteractionEnergy & energy
+					, const OutputHandlerInteractionList & interactions
+					, const RnaSequence * const target
+					, const bool addSeparator
+					, std::ostream & out
+					, OutputTopK * const topK = NULL
+					, const size_t index = 0 )
+{
+	// measure output formatting
+	Telemetry::Timer telemetryTimer( Telemetry::OUTPUT );
+
+	// global top-k output : format competitive interactions one by one
+	if (topK != NULL) {
+		size_t reported = 0;
+		// copy for the identical target sequence (storage reused for all)
+		Interaction interForTarget( energy.getAccessibility1().getSequence(), energy.getAccessibility2().getAccessibilityOrigin().getSequence() );
+		std::stringstream interOut;
+		BOOST_FOREACH( const Interaction * inter, interactions) {
+			// interactions are sorted by energy, i.e. all others are worse
+			if (!topK->isCompetitive( inter->energy )) {
+				break;
+			}
+			// format the interaction on its own
+			interOut.str("");
+			OutputHandler * output = parameters.getOutputHandler( energy, interOut );
+			INTARNA_CHECK_NOT_NULL(output,"output handler initialization failed");
+			if (target == NULL) {
+				output->add(*inter);
+			} else {
+				interForTarget = *inter;
+				interForTarget.s1 = target;
+				output->add(interForTarget);
+			}
+			// garbage collection (might trigger final output)
+			 INTARNA_CLEANUP(output);
+			if (topK->add( inter->energy, index, interOut.str() )) {
+				reported++;
+			}
+		}
+		telemetryTimer.addCells( reported );
+		return reported;
+	}
+
+	// get output/storage handler writing to the given stream
+	OutputHandler * output = parameters.getOutputHandler( energy, out );
+	INTARNA_CHECK_NOT_NULL(output,"output handler initialization failed");
+
+	// check if we have to add separator for IntaRNA v1 output
+	if (addSeparator && dynamic_cast<OutputHandlerIntaRNA1*>(output) != NULL) {
+		dynamic_cast<OutputHandlerIntaRNA1*>(output)->addSeparator( true );
+	}
+
+	// copy for the identical target sequence (storage reused for all)
+	Interaction interForTarget( energy.getAccessibility1().getSequence(), energy.getAccessibility2().getAccessibilityOrigin().getSequence() );
+	// forward all reported interactions for all regions to output handler
+	BOOST_FOREACH( const Interaction * inter, interactions) {
+		if (target == NULL) {
+			output->add(*inter);
+		} else {
+			// report copy for the identical target sequence
+			interForTarget = *inter;
+			interForTarget.s1 = target;
+			output->add(interForTarget);
+		}
+	}
+
+	const size_t reported = output->reported();
+	telemetryTimer.addCells( reported );
+
+	// garbage collection (might trigger final output)
+	 INTARNA_CLEANUP(output);
+
+	return reported;
+}
+
+/////////////////////////////////////////////////////////////////////
+//! per-thread pool of predictors, i.e. for each thread a mapping of
+//! (energy handler, output handler) to the predictor to be reused for all
+//! window combinations of a target-query combination
+typedef std::vector< std::map< std::pair< const InteractionEnergy *, OutputHandler * >, Predictor * > > PredictorPool;
+
+/////////////////////////////////////////////////////////////////////
+/**
+ * Provides the predictor of the calling thread for the given energy and
+ * output handler from the pool. If not available, a new predictor is
+ * created and added to the pool. Since the DP matrices of a predictor only
+ * grow, subsequent predict() calls for other windows reuse their memory.
+ *
+ * @param parameters the parsed program parameters
+ * @param pool the predictor pool to use
+ * @param energy the energy handler the predictor has to use
+ * @param output the output handler the predictor has to report to
+ * @param seedCache the seed table shared by all windows of energy or NULL
+ * @param predTracker the tracker the predictor has to report to via a
+ *        partial tracker or NULL
+ * @return the predictor to use (owned by the pool)
+ */
+Predictor *
+getPooledPredictor( const CommandLineParsing & parameters
+					, PredictorPool & pool
+					, const InteractionEnergy & energy
+					, OutputHandler & output
+					, const SeedHandlerMfe * seedCache
+					, PredictionTracker * predTracker )
+{
+#if INTARNA_MULITHREADING
+	const size_t thread = (size_t)omp_get_thread_num();
+#else
+	const size_t thread = 0;
+#endif
+	Predictor * & predictor = pool.at(thread)[ std::make_pair( &energy, &output ) ];
+	if (predictor == NULL) {
+		predictor = parameters.getPredictor( energy, output, seedCache
+						, predTracker == NULL ? NULL : predTracker->newPartialTracker() );
+	}
+	return predictor;
+}
+
+/////////////////////////////////////////////////////////////////////
+/**
+ * Destroys all predictors within the pool and clears it.
+ *
+ * @param pool the predictor pool to clear
+ */
+void
+clearPredictorPool( PredictorPool & pool )
+{
+	for (size_t thread = 0; thread < pool.size(); thread++) {
+		for (auto entry = pool.at(thread).begin(); entry != pool.at(thread).end(); entry++) {
+			 INTARNA_CLEANUP( entry->second );
+		}
+		pool.at(thread).clear();
+	}
+}
+
+/////////////////////////////////////////////////////////////////////
+/**
+ * Provides the copy of a query accessibility within the memory of the NUMA
+ * node of the calling thread. If not available, the copy is created by the
+ * calling thread, such that its memory is allocated on the local node.
+ * The precomputed energy data of the query is valid for all copies.
+ *
+ * @param queryNumber the index of the query
+ * @param queryAcc the query accessibilities
+ * @param queryAccNuma the copies of the query accessibilities per NUMA node
+ *        (NULL if not created yet); if less than two nodes are given,
+ *        the query accessibility itself is used
+ * @return the query accessibility to use
+ */
+const ReverseAccessibility &
+getLocalQueryAccessibility( const size_t queryNumber
+					, const std::vector< ReverseAccessibility * > & queryAcc
+					, std::vector< std::vector< ReverseAccessibility * > > & queryAccNuma )
+{
+	if (queryAccNuma.size() < 2) {
+		return *(queryAcc.at(queryNumber));
+	}
+	const size_t node = std::min( NumaTopology::getCurrentNode(), queryAccNuma.size()-1 );
+	ReverseAccessibility * local = NULL;
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_queryAccNuma)
+#endif
+	{ local = queryAccNuma.at(node).at(queryNumber); }
+	if (local != NULL) {
+		return *local;
+	}
+	// copy the reversed ED values outside of the critical section
+	local = new ReverseAccessibility( const_cast<Accessibility&>(queryAcc.at(queryNumber)->getAccessibilityOrigin()), true );
+	bool created = false;
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_queryAccNuma)
+#endif
+	{
+		// check if created by another thread of the node in the meantime
+		if (queryAccNuma.at(node).at(queryNumber) == NULL) {
+			queryAccNuma.at(node).at(queryNumber) = local;
+			created = true;
+		}
+	}
+	if (!created) {
+		INTARNA_CLEANUP( local );
+#if INTARNA_MULITHREADING
+		#pragma omp critical(intarna_omp_queryAccNuma)
+#endif
+		{ local = queryAccNuma.at(node).at(queryNumber); }
+	}
+	return *local;
+}
+
+/////////////////////////////////////////////////////////////////////
+/**
+ * Runs the prediction for a window combination.
+ *
+ * @param parameters the setup
+ * @param predictor the predictor to use
+ * @param tWindow the target window
+ * @param qWindowRev the (reversed) query window
+ * @param bestE the energy an interaction has to improve (or E_INF)
+ * @param symmetric whether or not only one of two symmetric interactions
+ *        is to be predicted
+ */
+void
+predictWindow( const CommandLineParsing & parameters
+				, Predictor & predictor
+				, const IndexRange & tWindow
+				, const IndexRange & qWindowRev
+				, const E_type bestE
+				, const bool symmetric )
+{
+	if (parameters.useSlidingWindows()) {
+		predictor.predictWindows( tWindow
+						, qWindowRev
+						, parameters.getWindowWidth()
+						, parameters.getWindowOverlap()
+						, parameters.getOutputConstraint( bestE, symmetric )
+						);
+	} else {
+		predictor.predict( tWindow
+						, qWindowRev
+						, parameters.getOutputConstraint( bestE, symmetric )
+						);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////
+/**
+ * Checks whether a suboptimal interaction site can be formed together with
+ * the mfe interaction (see --fuseSites). To this end, the site is blocked
+ * within both sequences and the mfe interaction of the remaining sequences
+ * is predicted. If the latter overlaps the mfe interaction within both
+ * sequences, both sites are compatible. Since the ED values of the blocked
+ * sequences are computed with the blocked site unpaired, the energy (and ED
+ * values) of the fused interaction are the sums of both sites' values.
+ *
+ * @param parameters the parsed program parameters
+ * @param targetNumber the index of the target
+ * @param targetAcc the accessibility of the target
+ * @param queryNumber the index of the query
+ * @param queryAcc the (reversed) accessibility of the query
+ * @param energy the energy handler the interactions were predicted with
+ * @param mfe the mfe interaction
+ * @param site the suboptimal interaction to check
+ * @return the description of the fused interaction or an empty string if
+ *         the site is not compatible with the mfe interaction
+ */
+std::string
+getFusedSite( const CommandLineParsing & parameters
+			, const size_t targetNumber
+			, const Accessibility & targetAcc
+			, const size_t queryNumber
+			, const ReverseAccessibility & queryAcc
+			, const InteractionEnergy & energy
+			, const Interaction & mfe
+			, const Interaction & site )
+{
+	// site ranges (query in original indexing)
+	const IndexRange site1( site.basePairs.begin()->first, site.basePairs.rbegin()->first );
+	const IndexRange site2( site.basePairs.rbegin()->second, site.basePairs.begin()->second );
+
+	// block the site within both sequences
+	Accessibility * blockedTarget = parameters.getTargetBlockedAccessibility( targetNumber, targetAcc, site1 );
+	INTARNA_CHECK_NOT_NULL(blockedTarget,"blocked target initialization failed");
+	Accessibility * blockedQuery = parameters.getQueryBlockedAccessibility( queryNumber, queryAcc.getAccessibilityOrigin(), site2 );
+	INTARNA_CHECK_NOT_NULL(blockedQuery,"blocked query initialization failed");
+	ReverseAccessibility * blockedQueryRev = new ReverseAccessibility( *blockedQuery );
+	InteractionEnergy * blockedEnergy = parameters.getEnergyHandler( *blockedTarget, *blockedQueryRev );
+	INTARNA_CHECK_NOT_NULL(blockedEnergy,"energy initialization failed");
+
+	// predict the mfe interaction of the remaining sequences
+	OutputHandlerInteractionList constrainedMfe( 1 );
+	Predictor * predictor = parameters.getPredictor( *blockedEnergy, constrainedMfe );
+	INTARNA_CHECK_NOT_NULL(predictor,"predictor initialization failed");
+	// (ranges of the unblocked sequences, since the decomposition is shared,
+	//  where query ranges are mapped to the reversed query as done in main())
+	BOOST_FOREACH(const IndexRange & tRange, parameters.getTargetRanges(energy, targetNumber)) {
+	BOOST_FOREACH(const IndexRange & qRange, parameters.getQueryRanges(energy, queryNumber)) {
+		predictor->predict( tRange, blockedQueryRev->getReversedIndexRange(qRange)
+				, OutputConstraint( 1, OutputConstraint::OVERLAP_BOTH, parameters.getOutputConstraint().maxE ) );
+	}}
+	INTARNA_CLEANUP(predictor);
+
+	std::stringstream fused;
+	if (!constrainedMfe.empty() && !(*constrainedMfe.begin())->basePairs.empty()) {
+		const Interaction & constrained = **constrainedMfe.begin();
+		const IndexRange constrained1( constrained.basePairs.begin()->first, constrained.basePairs.rbegin()->first );
+		const IndexRange constrained2( constrained.basePairs.rbegin()->second, constrained.basePairs.begin()->second );
+		// check overlap with the mfe interaction within both sequences
+		if ( std::min( constrained1.to, mfe.basePairs.rbegin()->first ) > std::max( constrained1.from, mfe.basePairs.begin()->first )
+			&& std::min( constrained2.to, mfe.basePairs.begin()->second ) > std::max( constrained2.from, mfe.basePairs.rbegin()->second ) )
+		{
+			const InteractionEnergy::EnergyContributions siteED = energy.getED_contributions( site );
+			const InteractionEnergy::EnergyContributions constrainedED = blockedEnergy->getED_contributions( constrained );
+			fused <<(site1.from+1)<<'-'<<(site1.to+1)<<':'<<(constrained1.from+1)<<'-'<<(constrained1.to+1)
+				<<' '<<(site2.from+1)<<'-'<<(site2.to+1)<<':'<<(constrained2.from+1)<<'-'<<(constrained2.to+1)
+				<<' '<<(site.energy + constrained.energy)
+				<<' '<<(siteED.ED1 + constrainedED.ED1)
+				<<' '<<(siteED.ED2 + constrainedED.ED2);
+		}
+	}
+
+	// garbage collection
+	INTARNA_CLEANUP(blockedEnergy);
+	INTARNA_CLEANUP(blockedQueryRev);
+	INTARNA_CLEANUP(blockedQuery);
+	INTARNA_CLEANUP(blockedTarget);
+
+	return fused.str();
+}
+
+/////////////////////////////////////////////////////////////////////
+/**
+ * Fused suboptimal-site analysis (see --fuseSites), i.e. checks all
+ * suboptimal interactions for their compatibility with the mfe interaction
+ * (see getFusedSite()). The constrained predictions are done in parallel.
+ *
+ * @param parameters the parsed program parameters
+ * @param targetNumber the index of the target
+ * @param targetAcc the accessibility of the target
+ * @param queryNumber the index of the query
+ * @param queryAcc the (reversed) accessibility of the query
+ * @param energy the energy handler the interactions were predicted with
+ * @param interactions the predicted interactions sorted by energy
+ * @return the descriptions of all fused interactions in the order of the
+ *         suboptimal interactions
+ */
+std::vector< std::string >
+getFusedSites( const CommandLineParsing & parameters
+			, const size_t targetNumber
+			, const Accessibility & targetAcc
+			, const size_t queryNumber
+			, const ReverseAccessibility & queryAcc
+			, const InteractionEnergy & energy
+			, const OutputHandlerInteractionList & interactions )
+{
+	std::vector< const Interaction * > sites;
+	BOOST_FOREACH( const Interaction * inter, interactions ) {
+		if (!inter->basePairs.empty()) {
+			sites.push_back( inter );
+		}
+	}
+	std::vector< std::string > fused( sites.size() );
+	// exceptions of the constrained predictions (forwarded after all are done)
+	std::vector< std::exception_ptr > failed( sites.size(), NULL );
+	for (size_t s = 1; s < sites.size(); s++) {
+#if INTARNA_MULITHREADING
+		# pragma omp task firstprivate(s) shared(parameters,targetAcc,queryAcc,energy,sites,fused,failed)
+#endif
+		{
+			try {
+				fused[s] = getFusedSite( parameters, targetNumber, targetAcc, queryNumber, queryAcc, energy, *(sites.at(0)), *(sites.at(s)) );
+			} catch (...) {
+				failed[s] = std::current_exception();
+			}
+		}
+	}
+#if INTARNA_MULITHREADING
+	#pragma omp taskwait
+#endif
+	for (size_t s = 1; s < sites.size(); s++) {
+		if (failed.at(s) != NULL) {
+			std::rethrow_exception( failed.at(s) );
+		}
+	}
+	// only compatible sites
+	fused.erase( std::remove( fused.begin(), fused.end(), std::string() ), fused.end() );
+	return fused;
+}
+
+/////////////////////////////////////////////////////////////////////
+/**
+ * Reports the output of a query with a target and all targets handled
+ * together with it from the result store, if all combinations are stored.
+ *
+ * @param parameters the setup providing the result store
+ * @param outputOrdered the output to add the stored output to
+ * @param finished the combinations finished by a resumed run (or NULL),
+ *        whose output is not reported again
+ * @param targetBatchOffset the number of targets of previous batches
+ * @param targetNumber the index of the target
+ * @param dependentTargets the targets handled together with the target
+ * @param queryNumber the index of the query
+ * @return true if all combinations were stored and reported; false
+ *         otherwise, where nothing is reported
+ */
+bool
+reportStoredOutput( const CommandLineParsing & parameters
+					, OutputReorderBuffer & outputOrdered
+					, const CheckpointJournal * finished
+					, const size_t targetBatchOffset
+					, const size_t targetNumber
+					, const std::vector< size_t > & dependentTargets
+					, const size_t queryNumber )
+{
+	// the target (index 0) and each dependent target
+	std::vector< std::string > output( 1+dependentTargets.size() );
+	for (size_t d=0; d<output.size(); d++) {
+		if (!parameters.getResultStore()->read( parameters.getResultKey( d==0 ? targetNumber : dependentTargets.at(d-1), queryNumber ), output[d] )) {
+			return false;
+		}
+	}
+	for (size_t d=0; d<output.size(); d++) {
+		const size_t index = (targetBatchOffset + (d==0 ? targetNumber : dependentTargets.at(d-1))) * parameters.getQuerySequences().size() + queryNumber;
+		outputOrdered.add( index, (finished != NULL && finished->isFinished( index )) ? std::string() : output.at(d) );
+	}
+	return true;
+}
+
 /////////////////////////////////////////////////////////////////////
 /**
  * program main entry
@@ -74,6 +538,16 @@ int main(int argc, char **argv){
 			}
 		}
 
+#if INTARNA_MULITHREADING
+		// limit parallel computations within the library to the number of threads
+		omp_set_num_threads( parameters.getThreads() );
+		// buffer log messages of parallel computations per thread and write them
+		// via a background thread
+		if (parameters.getThreads() != 1) {
+			AsyncLog::start();
+		}
+#endif
+
 #if INTARNA_MULITHREADING
 		// OMP shared variables to enable exception forwarding from within OMP parallelized for loop
 		bool threadAborted = false;
@@ -81,42 +555,141 @@ int main(int argc, char **argv){
 		std::stringstream exceptionInfoDuringOmp;
 #endif
 
+		// server mode : query accessibilities reused over all requests
+		// (sequence string -> accessibility of an according sequence copy)
+		std::map< std::string, ReverseAccessibility * > queryAccCache;
+		const size_t queryAccCacheSize = parameters.getServerCache();
+
+		// process all prediction requests (only one if not in server mode)
+#if INTARNA_MULITHREADING
+		while ( !threadAborted && parameters.parseNextRequest() )
+#else
+		while ( parameters.parseNextRequest() )
+#endif
+		{
 
 		// number of already reported interactions to enable IntaRNA v1 separator output
 		size_t reportedInteractions = 0;
 
 		// storage to avoid accessibility recomputation (init NULL)
 		std::vector< ReverseAccessibility * > queryAcc(parameters.getQuerySequences().size(), NULL);
+		// energy data of each query reused for all targets (NULL if not available)
+		std::vector< InteractionEnergyVrna::SequenceData * > queryEnergyData(queryAcc.size(), NULL);
+#if INTARNA_MULITHREADING
+		// NUMA systems : the query accessibilities are read by all threads,
+		// such that each node gets its own copy if threads are bound to CPUs
+		// (otherwise the node of a thread changes) and ED values are materialized
+		const size_t numaNodes = parameters.getThreads() > 1 && !parameters.isAccLowMem() && omp_get_proc_bind() != omp_proc_bind_false
+				? NumaTopology::getNodeNumber() : 1;
+#else
+		const size_t numaNodes = 1;
+#endif
+		// the query accessibilities per NUMA node (NULL if not created yet)
+		std::vector< std::vector< ReverseAccessibility * > > queryAccNuma( numaNodes, std::vector< ReverseAccessibility * >( queryAcc.size(), NULL ) );
+		if (numaNodes > 1) {
+			ASYNC_VLOG(1) <<"using query accessibility copies for "<<numaNodes<<" NUMA nodes";
+		}
 
-		// compute all query accessibilities to enable parallelization
+		// reuse cached query accessibilities
+		if (queryAccCacheSize > 0) {
+			for (size_t qi=0; qi<queryAcc.size(); qi++) {
+				auto cached = queryAccCache.find( parameters.getQuerySequences().at(qi).asString() );
+				if (cached != queryAccCache.end()) {
+					queryAcc[qi] = cached->second;
+				}
+			}
+		}
+
+		// target accessibilities of the first target batch computed together
+		// with the query accessibilities (NULL if not prefetched or already
+		// used by the target processing)
+		std::vector< Accessibility * > prefetchedTargetAcc;
+		// targets whose accessibility is prefetched
+		std::vector< size_t > prefetchTargets;
 #if INTARNA_MULITHREADING
-		// parallelize this loop if possible; if not -> parallelize the query-loop
-		# pragma omp parallel for schedule(dynamic) num_threads( parameters.getThreads() ) shared(queryAcc,reportedInteractions,exceptionPtrDuringOmp,exceptionInfoDuringOmp)
+		// threads not needed for the query accessibilities compute the
+		// accessibilities of the first targets to be processed, such that all
+		// threads are busy independently of the number of queries
+		// (not if the target accessibility depends on the query accessibilities)
+		if (!parameters.useSeedPrefilter() && !parameters.useCascade()) {
+			size_t pendingQueries = 0;
+			for (size_t qi=0; qi<queryAcc.size(); qi++) {
+				if (queryAcc[qi] == NULL) {
+					pendingQueries++;
+				}
+			}
+			const size_t maxPrefetch = std::min( parameters.getTargetAccessibilityBuffer()
+					, parameters.getThreads() > pendingQueries ? parameters.getThreads() - pendingQueries : 0 );
+			const std::vector< size_t > targetOrder = parameters.getTargetOrder();
+			for (size_t t=0; t<targetOrder.size() && prefetchTargets.size() < maxPrefetch; t++) {
+				// identical targets and variants are handled together with their first occurrence
+				// and self-interaction targets reuse a query accessibility
+				if (!parameters.isTargetDuplicate( targetOrder.at(t) ) && !parameters.isTargetVariant( targetOrder.at(t) )
+					&& parameters.getSelfInteractionQuery( targetOrder.at(t) ) >= queryAcc.size())
+				{
+					prefetchTargets.push_back( targetOrder.at(t) );
+				}
+			}
+			prefetchedTargetAcc.resize( parameters.getTargetSequences().size(), NULL );
+		}
 #endif
-		for (size_t qi=0; qi<queryAcc.size(); qi++) {
+
+		// compute all query accessibilities (and prefetched target accessibilities)
+		// to enable parallelization
+#if INTARNA_MULITHREADING
+		# pragma omp parallel for schedule(dynamic) num_threads( parameters.getThreads() ) shared(queryAcc,queryAccNuma,queryEnergyData,prefetchTargets,prefetchedTargetAcc,reportedInteractions,exceptionPtrDuringOmp,exceptionInfoDuringOmp)
+#endif
+		for (size_t job=0; job<prefetchTargets.size()+queryAcc.size(); job++) {
+			// targets first, since usually longer
+			const bool isTargetJob = job < prefetchTargets.size();
+			const size_t qi = isTargetJob ? 0 : job - prefetchTargets.size();
+			// skip cached accessibilities
+			if (!isTargetJob && queryAcc[qi] != NULL) {
+				continue;
+			}
 			// get accessibility handler
 #if INTARNA_MULITHREADING
 			#pragma omp flush (threadAborted)
 			// explicit try-catch-block due to missing OMP exception forwarding
 			if (!threadAborted) {
 				try {
-					// get query accessibility handler
-					#pragma omp critical(intarna_omp_logOutput)
 #endif
-					VLOG(1) <<"computing accessibility for query '"<<parameters.getQuerySequences().at(qi).getId()<<"'...";
-					Accessibility * queryAccOrig = parameters.getQueryAccessibility(qi);
+				if (isTargetJob) {
+					const size_t targetNumber = prefetchTargets.at(job);
+					ASYNC_VLOG(1) <<"computing accessibility for target '"<<parameters.getTargetSequences().at(targetNumber).getId()<<"'...";
+					// measure accessibility computation
+					Telemetry::Timer telemetryTimer( Telemetry::ACCESSIBILITY );
+					prefetchedTargetAcc[targetNumber] = parameters.getTargetAccessibility( targetNumber, NULL );
+					INTARNA_CHECK_NOT_NULL(prefetchedTargetAcc[targetNumber],"target initialization failed");
+					telemetryTimer.addCells( prefetchedTargetAcc[targetNumber]->getSequence().size() * prefetchedTargetAcc[targetNumber]->getMaxLength() );
+				} else {
+					// get query accessibility handler
+					ASYNC_VLOG(1) <<"computing accessibility for query '"<<parameters.getQuerySequences().at(qi).getId()<<"'...";
+					// measure accessibility computation
+					Telemetry::Timer telemetryTimer( Telemetry::ACCESSIBILITY );
+					// if cached, the accessibility is based on a sequence copy
+					// that outlives the current request
+					Accessibility * queryAccOrig = queryAccCacheSize > 0
+							? parameters.getQueryAccessibility( *(new RnaSequence(parameters.getQuerySequences().at(qi))) )
+							: parameters.getQueryAccessibility(qi);
 					INTARNA_CHECK_NOT_NULL(queryAccOrig,"query initialization failed");
+					telemetryTimer.addCells( queryAccOrig->getSequence().size() * queryAccOrig->getMaxLength() );
 					// reverse indexing of target sequence for the computation
-					queryAcc[qi] = new ReverseAccessibility(*queryAccOrig);
+					// (reversed ED values are copied for direct access unless memory is to be saved)
+					queryAcc[qi] = new ReverseAccessibility(*queryAccOrig, !parameters.isAccLowMem());
+					// the materialized ED values are local to the node of this thread
+					if (numaNodes > 1) {
+						queryAccNuma.at( std::min( NumaTopology::getCurrentNode(), numaNodes-1 ) ).at(qi) = queryAcc[qi];
+					}
+					// target-independent energy data
+					queryEnergyData[qi] = parameters.getQueryEnergyData( *(queryAcc[qi]) );
 
 					// check if we have to warn about ambiguity
 					if (queryAccOrig->getSequence().isAmbiguous()) {
-#if INTARNA_MULITHREADING
-						#pragma omp critical(intarna_omp_logOutput)
-#endif
-						LOG(INFO) <<"Sequence '"<<queryAccOrig->getSequence().getId()
+						ASYNC_LOG(INFO) <<"Sequence '"<<queryAccOrig->getSequence().getId()
 								<<"' contains ambiguous nucleotide encodings. These positions are ignored for interaction computation.";
 					}
+				}
 #if INTARNA_MULITHREADING
 				////////////////////// exception handling ///////////////////////////
 				} catch (std::exception & e) {
@@ -126,7 +699,7 @@ int main(int argc, char **argv){
 						if (!threadAborted) {
 							// store exception information
 							exceptionPtrDuringOmp = std::make_exception_ptr(e);
-							exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #query "<<qi <<" : "<<e.what();
+							exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<(isTargetJob ? " #target " : " #query ")<<(isTargetJob ? prefetchTargets.at(job) : qi) <<" : "<<e.what();
 							// trigger abortion of all threads
 							threadAborted = true;
 							#pragma omp flush (threadAborted)
@@ -139,7 +712,7 @@ int main(int argc, char **argv){
 						if (!threadAborted) {
 							// store exception information
 							exceptionPtrDuringOmp = std::current_exception();
-							exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #query "<<qi;
+							exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<(isTargetJob ? " #target " : " #query ")<<(isTargetJob ? prefetchTargets.at(job) : qi);
 							// trigger abortion of all threads
 							threadAborted = true;
 							#pragma omp flush (threadAborted)
@@ -150,50 +723,311 @@ int main(int argc, char **argv){
 #endif
 		}
 
-		// check which loop to parallelize
-		const bool parallelizeTargetLoop = parameters.getTargetSequences().size() > 1;
-		const bool parallelizeQueryLoop = !parallelizeTargetLoop && parameters.getQuerySequences().size() > 1;
-		const bool parallelizeWindowsLoop = !parallelizeTargetLoop && !parallelizeQueryLoop;
+		// run prediction for all pairs of sequences
+		// each (target, query, target window, query window) combination is
+		// processed by its own task, such that the thread pool can pick up work
+		// at every level independently of the number of targets/queries/windows
+		// the targets are processed by a limited number of target tasks that
+		// handle one target after another; this bounds the number of target
+		// accessibilities held in memory while the accessibility computation of
+		// upcoming targets overlaps with the predictions for the current ones
+#if INTARNA_MULITHREADING
+		// defer tasks only if multiple threads are available; otherwise tasks
+		// are run immediately and thus in input order
+		const bool deferTasks = parameters.getThreads() > 1;
+#endif
 
+		// the output of each (target,query) combination is written in input
+		// order, the window bounds the number of combinations buffered
+		// until all preceding combinations are finished
+#if INTARNA_MULITHREADING
+		OutputReorderBuffer outputOrdered( parameters.getOutputStream(), parameters.getOutputOrderBuffer(), 0, parameters.getCheckpointJournal() );
+#else
+		OutputReorderBuffer outputOrdered( parameters.getOutputStream(), 0, 0, parameters.getCheckpointJournal() );
+#endif
+		// combinations finished by a resumed run (or NULL)
+		const CheckpointJournal * finished = parameters.getCheckpointJournal();
+		// global top-k output collecting the best interactions of all
+		// combinations to be written once all are done (or NULL)
+		OutputTopK * outputTopK = parameters.getOutputTopK() > 0
+				? new OutputTopK( parameters.getOutputStream(), parameters.getOutputTopK() )
+				: NULL;
+		// interactions not better than the currently k-th best can be pruned
+		// (not if predictions are tracked, which have to see all windows)
+		const bool topKPruning = outputTopK != NULL && !parameters.isPredictionTracked();
+		// number of targets of previous batches (for the output order)
+		size_t targetBatchOffset = 0;
 
-		// run prediction for all pairs of sequences
-		// first: iterate over all target sequences
+		// process all (batches of) target sequences
+		do {
+
+		// two-stage screening : coarse prediction of all combinations of the
+		// batch, where only the best are passed to the full prediction
+		// (not for variants and self-interactions, see seed prefilter)
+		std::vector< std::vector< E_type > > cascadeE( parameters.useCascade() ? parameters.getTargetSequences().size() : 0 );
+		std::vector< std::vector< IndexRange > > cascadeSites( cascadeE.size() );
+		E_type cascadeMaxE = E_INF;
+		if (!cascadeE.empty()) {
+#if INTARNA_MULITHREADING
+			# pragma omp parallel for schedule(dynamic) num_threads( parameters.getThreads() ) shared(queryAcc,queryEnergyData,cascadeE,cascadeSites,exceptionPtrDuringOmp,exceptionInfoDuringOmp)
+#endif
+			for (size_t targetNumber=0; targetNumber<cascadeE.size(); targetNumber++) {
+				if (parameters.isTargetDuplicate( targetNumber ) || parameters.isTargetVariant( targetNumber )
+					|| !parameters.getTargetVariants( targetNumber ).empty()
+					|| parameters.getSelfInteractionQuery( targetNumber ) < queryAcc.size())
+				{
+					continue;
+				}
+#if INTARNA_MULITHREADING
+				#pragma omp flush (threadAborted)
+				// explicit try-catch-block due to missing OMP exception forwarding
+				if (!threadAborted) {
+					try {
+#endif
+						parameters.getTargetCascadeSites( targetNumber, queryAcc, queryEnergyData, cascadeE[targetNumber], cascadeSites[targetNumber] );
+#if INTARNA_MULITHREADING
+					} catch (std::exception & e) {
+						// ensure exception handling for first failed thread only
+						#pragma omp critical(intarna_omp_exception)
+						{
+							if (!threadAborted) {
+								// store exception information
+								exceptionPtrDuringOmp = std::make_exception_ptr(e);
+								exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #target "<<targetNumber <<" : "<<e.what();
+								// trigger abortion of all threads
+								threadAborted = true;
+								#pragma omp flush (threadAborted)
+							}
+						} // omp critical(intarna_omp_exception)
+					} catch (...) {
+						// ensure exception handling for first failed thread only
+						#pragma omp critical(intarna_omp_exception)
+						{
+							if (!threadAborted) {
+								// store exception information
+								exceptionPtrDuringOmp = std::current_exception();
+								exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #target "<<targetNumber;
+								// trigger abortion of all threads
+								threadAborted = true;
+								#pragma omp flush (threadAborted)
+							}
+						} // omp critical(intarna_omp_exception)
+					}
+				} // if not threadAborted
+#endif
+			}
+			// coarse energy threshold of the combinations passed
+			std::vector< E_type > coarseE;
+			for (size_t targetNumber=0; targetNumber<cascadeE.size(); targetNumber++) {
+				coarseE.insert( coarseE.end(), cascadeE.at(targetNumber).begin(), cascadeE.at(targetNumber).end() );
+			}
+			cascadeMaxE = parameters.getCascadeMaxE( coarseE );
+			size_t passed = 0;
+			for (size_t i=0; i<coarseE.size(); i++) {
+				if (E_isNotINF( coarseE.at(i) ) && coarseE.at(i) <= cascadeMaxE) {
+					passed++;
+				}
+			}
+			ASYNC_VLOG(1) <<"two-stage screening : "<<passed<<" of "<<coarseE.size()<<" combinations passed to the full prediction";
+		}
+
+		// index (within targetOrder) of the next target to be processed by a target task
+		size_t nextTargetNumber = 0;
+		// processing order of the targets, i.e. expensive targets first if
+		// run in parallel (empty = input order)
 #if INTARNA_MULITHREADING
-		// parallelize this loop if possible; if not -> parallelize the query-loop
-		# pragma omp parallel for schedule(dynamic) num_threads( parameters.getThreads() ) shared(queryAcc,reportedInteractions,exceptionPtrDuringOmp,exceptionInfoDuringOmp) if(parallelizeTargetLoop)
+		const std::vector< size_t > targetOrder = deferTasks ? parameters.getTargetOrder() : std::vector< size_t >();
+#else
+		const std::vector< size_t > targetOrder;
 #endif
-		for ( size_t targetNumber = 0; targetNumber < parameters.getTargetSequences().size(); ++targetNumber )
+#if INTARNA_MULITHREADING
+		// number of targets processed concurrently
+		const size_t targetTasks = std::min( parameters.getTargetAccessibilityBuffer(), parameters.getTargetSequences().size() );
+		# pragma omp parallel num_threads( parameters.getThreads() ) shared(queryAcc,queryAccNuma,queryEnergyData,cascadeE,cascadeSites,cascadeMaxE,reportedInteractions,exceptionPtrDuringOmp,exceptionInfoDuringOmp,nextTargetNumber,outputOrdered,outputTopK,targetBatchOffset,finished)
+		# pragma omp single
+#else
+		const size_t targetTasks = 1;
+#endif
+		{
+		for ( size_t targetTask = 0; targetTask < targetTasks; ++targetTask )
 		{
+#if INTARNA_MULITHREADING
+			# pragma omp task shared(queryAcc,queryAccNuma,queryEnergyData,cascadeE,cascadeSites,cascadeMaxE,reportedInteractions,exceptionPtrDuringOmp,exceptionInfoDuringOmp,nextTargetNumber,outputOrdered,outputTopK,targetBatchOffset,finished) if(deferTasks)
+#endif
+			{
+			// first: iterate over all target sequences not handled by another target task
+			while (true)
+			{
+			size_t targetIndex;
+#if INTARNA_MULITHREADING
+			#pragma omp atomic capture
+#endif
+			targetIndex = nextTargetNumber++;
+			// check if all targets have been processed
+			if (targetIndex >= parameters.getTargetSequences().size()) {
+				break;
+			}
+			const size_t targetNumber = targetOrder.empty() ? targetIndex : targetOrder.at(targetIndex);
+			// identical targets and variants are handled together with their first occurrence
+			if (parameters.isTargetDuplicate( targetNumber ) || parameters.isTargetVariant( targetNumber )) {
+				continue;
+			}
+			// identical later targets that reuse the results of this target
+			const std::vector< size_t > targetDuplicates = parameters.getTargetDuplicates( targetNumber );
+			// point mutation variants that partially reuse the results of this target
+			const std::vector< size_t > targetVariants = parameters.getTargetVariants( targetNumber );
+			// all later targets handled together with this target (output order)
+			std::vector< size_t > dependentTargets( targetDuplicates );
+			dependentTargets.insert( dependentTargets.end(), targetVariants.begin(), targetVariants.end() );
+			// index of the first combination of this target (output order)
+			const size_t firstIndex = (targetBatchOffset+targetNumber) * parameters.getQuerySequences().size();
+			// resume : skip targets whose combinations are all finished
+			bool allFinished = finished != NULL && finished->isFinished( firstIndex, firstIndex + parameters.getQuerySequences().size() );
+			for (size_t d=0; allFinished && d<dependentTargets.size(); d++) {
+				const size_t dependentIndex = (targetBatchOffset+dependentTargets.at(d)) * parameters.getQuerySequences().size();
+				allFinished = finished->isFinished( dependentIndex, dependentIndex + parameters.getQuerySequences().size() );
+			}
+			if (allFinished) {
+				// complete the output order
+				for ( size_t queryNumber = 0; queryNumber < parameters.getQuerySequences().size(); ++queryNumber ) {
+					outputOrdered.add( firstIndex + queryNumber, "" );
+					for (size_t d=0; d<dependentTargets.size(); d++) {
+						outputOrdered.add( (targetBatchOffset+dependentTargets.at(d)) * parameters.getQuerySequences().size() + queryNumber, "" );
+					}
+				}
+				continue;
+			}
+			// result store : report the combinations computed by previous runs
+			// and skip the target if all are stored
+			std::vector< bool > stored( parameters.getQuerySequences().size(), false );
+			if (parameters.getResultStore() != NULL) {
+				bool allStored = true;
+				for ( size_t queryNumber = 0; queryNumber < stored.size(); ++queryNumber ) {
+					stored[queryNumber] = reportStoredOutput( parameters, outputOrdered, finished, targetBatchOffset, targetNumber, dependentTargets, queryNumber );
+					allStored = allStored && stored.at(queryNumber);
+				}
+				if (allStored) {
+					ASYNC_VLOG(1) <<"reusing stored output for target '"<<parameters.getTargetSequences().at(targetNumber).getId()<<"' : skipping accessibility computation and prediction";
+					continue;
+				}
+			}
 #if INTARNA_MULITHREADING
 			#pragma omp flush (threadAborted)
 			// explicit try-catch-block due to missing OMP exception forwarding
 			if (!threadAborted) {
 				try {
-					// get target accessibility handler
-					#pragma omp critical(intarna_omp_logOutput)
 #endif
-					{ VLOG(1) <<"computing accessibility for target '"<<parameters.getTargetSequences().at(targetNumber).getId()<<"'..."; }
+					// self-interaction : the target reuses the accessibility of the
+					// first query with identical sequence (if available)
+					const size_t selfQuery = parameters.getSelfInteractionQuery( targetNumber );
+					const bool targetIsSelf = selfQuery < queryAcc.size() && queryAcc.at(selfQuery) != NULL;
+
+					// two-stage screening : the accessibility is computed only around
+					// the coarse interaction sites of the combinations passed
+					const bool cascade = targetNumber < cascadeE.size() && !cascadeE.at(targetNumber).empty();
+					IndexRangeList cascadeRanges;
+					if (cascade) {
+						std::vector< IndexRange > passedSites;
+						for (size_t q=0; q<cascadeE.at(targetNumber).size(); q++) {
+							if (E_isNotINF( cascadeE.at(targetNumber).at(q) ) && cascadeE.at(targetNumber).at(q) <= cascadeMaxE) {
+								passedSites.push_back( cascadeSites.at(targetNumber).at(q) );
+							}
+						}
+						// merge overlapping sites
+						std::sort( passedSites.begin(), passedSites.end() );
+						for (size_t i=0; i<passedSites.size(); i++) {
+							if (!cascadeRanges.empty() && passedSites.at(i).from <= cascadeRanges.rbegin()->to+1) {
+								cascadeRanges.rbegin()->to = std::max( cascadeRanges.rbegin()->to, passedSites.at(i).to );
+							} else {
+								cascadeRanges.push_back( passedSites.at(i) );
+							}
+						}
+					}
 
-					// VRNA not completely threadsafe ...
-					Accessibility * targetAcc = parameters.getTargetAccessibility(targetNumber);
-					INTARNA_CHECK_NOT_NULL(targetAcc,"target initialization failed");
+					// seed prefilter : identify the target regions that can form
+					// a seed with any query ignoring the target's accessibility
+					// (not for variants, whose mutations might enable seeds,
+					// and not if already screened by the coarse prediction)
+					const bool seedPrefilter = parameters.useSeedPrefilter() && targetVariants.empty() && !targetIsSelf && !cascade;
+					IndexRangeList seedRanges;
+					if (seedPrefilter) {
+						seedRanges = parameters.getTargetSeedRanges( targetNumber, queryAcc );
+					}
+					// targets without any feasible seed or combination passed cannot interact
+					const bool seedFeasible = (!seedPrefilter || !seedRanges.empty()) && (!cascade || !cascadeRanges.empty());
+
+					Accessibility * targetAcc = NULL;
+					if (targetNumber < prefetchedTargetAcc.size() && prefetchedTargetAcc.at(targetNumber) != NULL) {
+						// take over the accessibility computed together with the queries
+						targetAcc = prefetchedTargetAcc.at(targetNumber);
+						prefetchedTargetAcc[targetNumber] = NULL;
+					} else
+					if (targetIsSelf) {
+						ASYNC_VLOG(1) <<"reusing accessibility of query '"<<parameters.getQuerySequences().at(selfQuery).getId()<<"' for target '"<<parameters.getTargetSequences().at(targetNumber).getId()<<"'";
+						targetAcc = new AccessibilityAlias( parameters.getTargetSequences().at(targetNumber), queryAcc.at(selfQuery)->getAccessibilityOrigin() );
+					} else
+					if (seedFeasible) {
+						// get target accessibility handler
+						ASYNC_VLOG(1) <<"computing accessibility for target '"<<parameters.getTargetSequences().at(targetNumber).getId()<<"'...";
+
+						// VRNA not completely threadsafe ...
+						// measure accessibility computation
+						Telemetry::Timer telemetryTimer( Telemetry::ACCESSIBILITY );
+						targetAcc = parameters.getTargetAccessibility( targetNumber, seedPrefilter ? &seedRanges : (cascade ? &cascadeRanges : NULL) );
+						INTARNA_CHECK_NOT_NULL(targetAcc,"target initialization failed");
+						telemetryTimer.addCells( targetAcc->getSequence().size() * targetAcc->getMaxLength() );
+					} else {
+						ASYNC_VLOG(1) <<(cascade ? "no combination passed the coarse screening" : "no seed possible")<<" for target '"<<parameters.getTargetSequences().at(targetNumber).getId()<<"' : skipping accessibility computation and prediction";
+						// placeholder to report the empty result
+						targetAcc = new AccessibilityDisabled( parameters.getTargetSequences().at(targetNumber), 0, NULL );
+					}
 
 					// check if we have to warn about ambiguity
 					if (targetAcc->getSequence().isAmbiguous()) {
-#if INTARNA_MULITHREADING
-						#pragma omp critical(intarna_omp_logOutput)
-#endif
-						{ LOG(INFO) <<"Sequence '"<<targetAcc->getSequence().getId()
-								<<"' contains ambiguous IUPAC nucleotide encodings. These positions are ignored for interaction computation and replaced by 'N'.";}
+						ASYNC_LOG(INFO) <<"Sequence '"<<targetAcc->getSequence().getId()
+								<<"' contains ambiguous IUPAC nucleotide encodings. These positions are ignored for interaction computation and replaced by 'N'.";
+					}
+
+					// identical targets reuse the computed accessibility
+					std::vector< Accessibility * > duplicateAcc( targetDuplicates.size(), NULL );
+					for (size_t d=0; d<targetDuplicates.size(); d++) {
+						duplicateAcc[d] = new AccessibilityAlias( parameters.getTargetSequences().at(targetDuplicates.at(d)), *targetAcc );
+					}
+
+					// variants recompute the accessibility only where affected by their mutation
+					std::vector< AccessibilityVariant * > variantAcc( targetVariants.size(), NULL );
+					for (size_t v=0; v<targetVariants.size(); v++) {
+						ASYNC_VLOG(1) <<"computing accessibility for variant target '"<<parameters.getTargetSequences().at(targetVariants.at(v)).getId()<<"'...";
+						// measure accessibility computation
+						Telemetry::Timer telemetryTimer( Telemetry::ACCESSIBILITY );
+						variantAcc[v] = parameters.getTargetVariantAccessibility( targetVariants.at(v), *targetAcc );
+						INTARNA_CHECK_NOT_NULL(variantAcc[v],"variant target initialization failed");
+						telemetryTimer.addCells( variantAcc[v]->getAffectedRange().to+1-variantAcc[v]->getAffectedRange().from );
 					}
 
 					// second: iterate over all query sequences
-#if INTARNA_MULITHREADING
-					// this parallelization should only be enabled if the outer target-loop is not parallelized
-					# pragma omp parallel for schedule(dynamic) num_threads( parameters.getThreads() ) shared(queryAcc,reportedInteractions,exceptionPtrDuringOmp,exceptionInfoDuringOmp,targetAcc,targetNumber) if(parallelizeQueryLoop)
-#endif
 					for ( size_t queryNumber = 0; queryNumber < parameters.getQuerySequences().size(); ++queryNumber )
 					{
+						// resume : skip finished combinations (also for identical targets and variants)
+						bool allFinished = finished != NULL && finished->isFinished( firstIndex + queryNumber );
+						for (size_t d=0; allFinished && d<dependentTargets.size(); d++) {
+							allFinished = finished->isFinished( (targetBatchOffset+dependentTargets.at(d)) * parameters.getQuerySequences().size() + queryNumber );
+						}
+						if (allFinished) {
+							outputOrdered.add( firstIndex + queryNumber, "" );
+							for (size_t d=0; d<dependentTargets.size(); d++) {
+								outputOrdered.add( (targetBatchOffset+dependentTargets.at(d)) * parameters.getQuerySequences().size() + queryNumber, "" );
+							}
+							continue;
+						}
+						// result store : output already reported
+						if (stored.at(queryNumber)) {
+							continue;
+						}
+#if INTARNA_MULITHREADING
+						# pragma omp task firstprivate(targetNumber,queryNumber,targetAcc,targetIsSelf,cascade,seedFeasible,seedRanges,firstIndex,targetDuplicates,duplicateAcc,targetVariants,variantAcc) shared(queryAcc,queryAccNuma,queryEnergyData,cascadeE,cascadeMaxE,reportedInteractions,exceptionPtrDuringOmp,exceptionInfoDuringOmp,outputOrdered,outputTopK,targetBatchOffset) if(deferTasks)
+#endif
+						{
 #if INTARNA_MULITHREADING
 						#pragma omp flush (threadAborted)
 						// explicit try-catch-block due to missing OMP exception forwarding
@@ -202,19 +1036,20 @@ int main(int argc, char **argv){
 #endif
 								// sanity check
 								assert( queryAcc.at(queryNumber) != NULL );
+								// the query accessibility within the memory of this thread's NUMA node
+								const ReverseAccessibility & localQueryAcc = getLocalQueryAccessibility( queryNumber, queryAcc, queryAccNuma );
 
 								// get energy computation handler for both sequences
-								InteractionEnergy* energy = parameters.getEnergyHandler( *targetAcc, *(queryAcc.at(queryNumber)) );
+								InteractionEnergy* energy = parameters.getEnergyHandler( *targetAcc, localQueryAcc, queryEnergyData.at(queryNumber) );
 								INTARNA_CHECK_NOT_NULL(energy,"energy initialization failed");
-
-								// get output/storage handler
-								OutputHandler * output = parameters.getOutputHandler( *energy );
-								INTARNA_CHECK_NOT_NULL(output,"output handler initialization failed");
-
-								// check if we have to add separator for IntaRNA v1 output
-								if (reportedInteractions > 0 && dynamic_cast<OutputHandlerIntaRNA1*>(output) != NULL) {
-									dynamic_cast<OutputHandlerIntaRNA1*>(output)->addSeparator( true );
+								// and for all variant targets
+								std::vector< InteractionEnergy* > variantEnergy( variantAcc.size(), NULL );
+								for (size_t v=0; v<variantAcc.size(); v++) {
+									variantEnergy[v] = parameters.getEnergyHandler( *(variantAcc.at(v)), localQueryAcc, queryEnergyData.at(queryNumber) );
+									INTARNA_CHECK_NOT_NULL(variantEnergy[v],"energy initialization failed");
 								}
+								// self-interaction : only one of two symmetric interactions is predicted
+								const bool symmetric = targetIsSelf && parameters.isSelfInteraction( targetNumber, queryNumber );
 
 								// setup collecting output handler to ensure
 								// k-best output per query-target combination
@@ -223,110 +1058,501 @@ int main(int argc, char **argv){
 										(parameters.reportBestPerRegion() ? std::numeric_limits<size_t>::max() : 1 )
 											* parameters.getOutputConstraint().reportMax );
 
-								// run prediction for all range combinations
-								BOOST_FOREACH(const IndexRange & tRange, parameters.getTargetRanges(*energy, targetNumber)) {
-								BOOST_FOREACH(const IndexRange & qRange, parameters.getQueryRanges(*energy, queryNumber)) {
+								// two-stage screening : only combinations passed are predicted
+								const bool cascadePassed = !cascade
+										|| (E_isNotINF( cascadeE.at(targetNumber).at(queryNumber) ) && cascadeE.at(targetNumber).at(queryNumber) <= cascadeMaxE);
+
+								// collect all window combinations for all range combinations
+								// (none if the target cannot form any seed or the
+								// combination did not pass the coarse screening)
+								std::vector< std::pair< IndexRange, IndexRange > > windowPairs;
+								if (seedFeasible && cascadePassed) {
+									BOOST_FOREACH(const IndexRange & tRange, parameters.getTargetRanges(*energy, targetNumber)) {
+									BOOST_FOREACH(const IndexRange & qRange, parameters.getQueryRanges(*energy, queryNumber)) {
 
-									// get windows for both ranges
-									std::vector<IndexRange> queryWindows = qRange.overlappingWindows(parameters.getWindowWidth(), parameters.getWindowOverlap());
-									std::vector<IndexRange> targetWindows = tRange.overlappingWindows(parameters.getWindowWidth(), parameters.getWindowOverlap());
+										// get windows for both ranges
+										std::vector<IndexRange> queryWindows = qRange.overlappingWindows(parameters.getWindowWidth(), parameters.getWindowOverlap());
+										// (sliding target windows are handled by the predictor)
+										std::vector<IndexRange> targetWindows = parameters.useSlidingWindows()
+												? std::vector<IndexRange>(1,tRange)
+												: tRange.overlappingWindows(parameters.getWindowWidth(), parameters.getWindowOverlap());
 
-									// iterate over all window combinations
+										// store all window combinations
+										for (size_t qNumWindow = 0; qNumWindow < queryWindows.size(); ++qNumWindow) {
+										for (size_t tNumWindow = 0; tNumWindow < targetWindows.size(); ++tNumWindow) {
+											windowPairs.push_back( std::make_pair( targetWindows.at(tNumWindow), queryWindows.at(qNumWindow) ) );
+										}} // window combinations
+									} // target ranges
+									} // query ranges
+								}
+
+								// best-first : lower energy bound of each window combination
+								std::vector< E_type > windowBestE;
+								if (parameters.isBestFirst() && windowPairs.size() > 1) {
+									// order by bound, where target windows without feasible seed are last
+									std::vector< std::pair< std::pair< bool, E_type >, size_t > > windowOrder( windowPairs.size() );
+									for (size_t windowPair = 0; windowPair < windowPairs.size(); ++windowPair) {
+										const E_type windowE = energy->getBestE( windowPairs.at(windowPair).first
+												, queryAcc.at(queryNumber)->getReversedIndexRange(windowPairs.at(windowPair).second) );
+										windowOrder[windowPair] = std::make_pair( std::make_pair(
+												!seedRanges.empty() && !seedRanges.overlaps( windowPairs.at(windowPair).first ), windowE )
+											, windowPair );
+									}
+									std::sort( windowOrder.begin(), windowOrder.end() );
+									std::vector< std::pair< IndexRange, IndexRange > > sortedWindowPairs;
+									sortedWindowPairs.reserve( windowPairs.size() );
+									windowBestE.reserve( windowPairs.size() );
+									for (size_t windowPair = 0; windowPair < windowOrder.size(); ++windowPair) {
+										sortedWindowPairs.push_back( windowPairs.at( windowOrder.at(windowPair).second ) );
+										windowBestE.push_back( windowOrder.at(windowPair).first.second );
+									}
+									windowPairs.swap( sortedWindowPairs );
+								}
 #if INTARNA_MULITHREADING
-									// this parallelization should only be enabled if neither the outer target-loop nor the inner query-loop are parallelized
-									# pragma omp parallel for schedule(dynamic) collapse(2) num_threads( parameters.getThreads() ) shared(queryAcc,reportedInteractions,exceptionPtrDuringOmp,exceptionInfoDuringOmp,targetAcc,targetNumber,queryNumber,queryWindows,targetWindows, bestInteractions, energy) if(parallelizeWindowsLoop)
-#endif									
-									for (int qNumWindow = 0; qNumWindow < queryWindows.size(); ++qNumWindow) {
-									for (int tNumWindow = 0; tNumWindow < targetWindows.size(); ++tNumWindow) {									
+								// start expensive window combinations first, such that
+								// no large window is computed alone at the end
+								// (unless ordered best-first)
+								if (deferTasks && windowPairs.size() > 1 && windowBestE.empty()) {
+									std::vector< std::pair< double, size_t > > windowCost( windowPairs.size() );
+									for (size_t windowPair = 0; windowPair < windowPairs.size(); ++windowPair) {
+										windowCost[windowPair] = std::make_pair( -parameters.getPredictionCost(
+												std::min( windowPairs.at(windowPair).first.to, energy->size1()-1 ) - windowPairs.at(windowPair).first.from + 1
+												, std::min( windowPairs.at(windowPair).second.to, energy->size2()-1 ) - windowPairs.at(windowPair).second.from + 1 )
+											, windowPair );
+									}
+									std::sort( windowCost.begin(), windowCost.end() );
+									std::vector< std::pair< IndexRange, IndexRange > > sortedWindowPairs;
+									sortedWindowPairs.reserve( windowPairs.size() );
+									for (size_t windowPair = 0; windowPair < windowCost.size(); ++windowPair) {
+										sortedWindowPairs.push_back( windowPairs.at( windowCost.at(windowPair).second ) );
+									}
+									windowPairs.swap( sortedWindowPairs );
+								}
+#endif
+
+								// report the estimated peak memory of the prediction
+								if (!windowPairs.empty() && VLOG_IS_ON(1)) {
+									size_t windowT = 0, windowQ = 0;
+									for (size_t windowPair = 0; windowPair < windowPairs.size(); ++windowPair) {
+										windowT = std::max( windowT, std::min( windowPairs.at(windowPair).first.to, energy->size1()-1 ) - windowPairs.at(windowPair).first.from + 1 );
+										windowQ = std::max( windowQ, std::min( windowPairs.at(windowPair).second.to, energy->size2()-1 ) - windowPairs.at(windowPair).second.from + 1 );
+									}
+									ASYNC_VLOG(1) <<"estimated peak memory for target '"<<parameters.getTargetSequences().at(targetNumber).getId()
+											<<"' and query '"<<parameters.getQuerySequences().at(queryNumber).getId()<<"' : "
+											<<(parameters.getMemoryEstimate( energy->size1(), energy->size2(), windowT, windowQ )/(1024*1024)+1)<<" MB";
+								}
+
+								// if only the mfe interaction is of interest, windows
+								// that cannot improve the best interaction found so
+								// far for this combination are skipped
+								// (not applicable if window results are reused by variants)
+								const bool windowPruning = windowPairs.size() > 1 && parameters.allowWindowPruning() && variantAcc.empty();
+
+								// prediction jobs, i.e. (energy handler, window combination) pairs,
+								// where energy handler 0 is the target's and v+1 the one of variant v
+								std::vector< std::pair< size_t, size_t > > predictionJobs;
+								for (size_t windowPair = 0; windowPair < windowPairs.size(); ++windowPair) {
+									predictionJobs.push_back( std::make_pair( 0, windowPair ) );
+								}
+								for (size_t v=0; v<variantAcc.size(); v++) {
+									const IndexRange & affected = variantAcc.at(v)->getAffectedRange();
+									for (size_t windowPair = 0; windowPair < windowPairs.size(); ++windowPair) {
+										// only windows overlapping the affected range have to be recomputed
+										// (all windows if profiles are to be tracked for each variant)
+										if ( parameters.isPredictionTracked()
+											|| (windowPairs.at(windowPair).first.from <= affected.to && affected.from <= windowPairs.at(windowPair).first.to) )
+										{
+											predictionJobs.push_back( std::make_pair( v+1, windowPair ) );
+										}
+									}
+								}
+								// without variants, all jobs report to bestInteractions; otherwise
+								// each job reports to its own list such that the results of
+								// the target's windows can be reused for the variants
+								std::vector< OutputHandlerInteractionList * > jobInteractions( variantAcc.empty() ? 0 : predictionJobs.size(), NULL );
+								for (size_t job = 0; job < jobInteractions.size(); ++job) {
+									jobInteractions[job] = new OutputHandlerInteractionList(
+											(parameters.reportBestPerRegion() ? std::numeric_limits<size_t>::max() : 1 )
+												* parameters.getOutputConstraint().reportMax );
+								}
+
+								// trackers collecting the prediction data of all jobs of the
+								// target (index 0) and of each variant (index v+1), where
+								// each predictor reports to its own partial tracker that is
+								// merged on predictor destruction (NULL if not tracked)
+								std::vector< PredictionTracker * > predTrackers( 1+variantAcc.size(), NULL );
+								if (!windowPairs.empty()) {
+									predTrackers[0] = parameters.getPredictionTracker( *energy );
+									for (size_t v=0; v<variantAcc.size(); v++) {
+										predTrackers[v+1] = parameters.getPredictionTracker( *(variantEnergy.at(v)) );
+									}
+								}
+
+								// predictors reused by all jobs of the same thread
+								// (not done if each job or window has its own output handler)
+								const bool poolPredictors = jobInteractions.empty() && !parameters.reportPartial();
 #if INTARNA_MULITHREADING
-										#pragma omp flush (threadAborted)
-										// explicit try-catch-block due to missing OMP exception forwarding
-										if (!threadAborted) {
-											try {
-#endif										
-										
-												IndexRange qWindow = queryWindows.at(qNumWindow);
-												IndexRange tWindow = targetWindows.at(tNumWindow);
-#if INTARNA_MULITHREADING
-												#pragma omp critical(intarna_omp_logOutput)
-#endif
-												{ VLOG(1) <<"predicting interactions for"
-														<<" target "<<targetAcc->getSequence().getId()
-														<<" (range " <<(tWindow+1)<<")"
-														<<" and"
-														<<" query "<<queryAcc.at(queryNumber)->getSequence().getId()
-														<<" (range " <<(qWindow+1)<<")"
+								PredictorPool predictorPool( poolPredictors ? parameters.getThreads() : 0 );
+#else
+								PredictorPool predictorPool( poolPredictors ? 1 : 0 );
+#endif
+
+								// seeds shared by the predictors of all windows of the target
+								// (only if windows overlap or are handled by the predictor)
+								SeedHandlerMfe * seedCache = NULL;
+								if (windowPairs.size() > 1 || (parameters.useSlidingWindows() && !windowPairs.empty())) {
+									// get range covering all windows
+									IndexRange tCover( energy->size1()-1, 0 ), qCover( energy->size2()-1, 0 );
+									for (size_t windowPair = 0; windowPair < windowPairs.size(); ++windowPair) {
+										const IndexRange tWindow = windowPairs.at(windowPair).first;
+										const IndexRange qWindowRev = queryAcc.at(queryNumber)->getReversedIndexRange(windowPairs.at(windowPair).second);
+										tCover.from = std::min( tCover.from, tWindow.from );
+										tCover.to = std::max( tCover.to, std::min( tWindow.to, energy->size1()-1 ) );
+										qCover.from = std::min( qCover.from, qWindowRev.from );
+										qCover.to = std::max( qCover.to, std::min( qWindowRev.to, energy->size2()-1 ) );
+									}
+									if (tCover.isAscending() && qCover.isAscending()) {
+										seedCache = parameters.getSeedCache( *energy, tCover, qCover );
+									}
+								}
+
+								// time budget : if the exact prediction of this combination
+								// exceeds the budget, all remaining windows are predicted
+								// heuristically and the output is flagged as degraded
+								const double timeBudget = parameters.getTimeBudget();
+								const Predictor::Clock::time_point deadline = Predictor::Clock::now()
+										+ std::chrono::duration_cast< Predictor::Clock::duration >( std::chrono::duration< double >( timeBudget ) );
+								bool degraded = false;
+
+								// run prediction for all jobs
+								size_t skippedWindows = 0;
+								for (size_t job = 0; job < predictionJobs.size(); ++job) {
+
+									// best-first : skip target windows that cannot yield an equal or
+									// better interaction than found so far, i.e. stop the prediction
+									// of the combination once all remaining bounds are exceeded
+									const bool jobBoundKnown = !windowBestE.empty() && predictionJobs.at(job).first == 0;
+									const E_type jobBound = jobBoundKnown ? windowBestE.at(predictionJobs.at(job).second) : E_INF;
+									if (jobBoundKnown && (windowPruning || topKPruning)) {
+										const E_type bestE = std::min( windowPruning ? bestInteractions.getBestE() : E_INF
+																	, topKPruning ? outputTopK->getWorstE() : E_INF );
+										if (E_isNotINF(bestE) && jobBound > bestE) {
+											skippedWindows++;
+											continue;
+										}
+									}
+
+									const IndexRange tWindow = windowPairs.at(predictionJobs.at(job).second).first;
+									const IndexRange qWindow = windowPairs.at(predictionJobs.at(job).second).second;
+									const InteractionEnergy * jobEnergy = predictionJobs.at(job).first == 0 ? energy : variantEnergy.at(predictionJobs.at(job).first-1);
+									OutputHandlerInteractionList * jobOutput = jobInteractions.empty() ? &bestInteractions : jobInteractions.at(job);
+									const SeedHandlerMfe * jobSeedCache = predictionJobs.at(job).first == 0 ? seedCache : NULL;
+									PredictionTracker * jobTracker = predTrackers.at(predictionJobs.at(job).first);
+									// variants are no self-interactions
+									const bool jobSymmetric = symmetric && predictionJobs.at(job).first == 0;
+
+#if INTARNA_MULITHREADING
+									# pragma omp task firstprivate(targetNumber,queryNumber,jobEnergy,jobOutput,jobSeedCache,jobTracker,jobSymmetric,jobBoundKnown,jobBound,qWindow,tWindow,windowPruning,topKPruning) shared(queryAcc,exceptionPtrDuringOmp,exceptionInfoDuringOmp,bestInteractions,predictorPool,outputTopK,degraded,outputOrdered) if(deferTasks)
+#endif
+									{
+#if INTARNA_MULITHREADING
+									#pragma omp flush (threadAborted)
+									// explicit try-catch-block due to missing OMP exception forwarding
+									if (!threadAborted) {
+										try {
+#endif
+											{ ASYNC_VLOG(1) <<"predicting interactions for"
+													<<" target "<<jobEnergy->getAccessibility1().getSequence().getId()
+													<<" (range " <<(tWindow+1)<<")"
+													<<" and"
+													<<" query "<<queryAcc.at(queryNumber)->getSequence().getId()
+													<<" (range " <<(qWindow+1)<<")"
 #if INTARNA_MULITHREADING
 #if INTARNA_IN_DEBUG_MODE
 
-														<<" #thread "<<omp_get_thread_num()
-#endif
-#endif
-														<<" ..."; }
-		
-												// get interaction prediction handler
-												Predictor * predictor = parameters.getPredictor( *energy, bestInteractions );
-												INTARNA_CHECK_NOT_NULL(predictor,"predictor initialization failed");
-		
-												// run prediction for this window combination
-												predictor->predict(	  tWindow
-																	, queryAcc.at(queryNumber)->getReversedIndexRange(qWindow)
-																	, parameters.getOutputConstraint()
-																	);
-												// garbage collection
-												INTARNA_CLEANUP(predictor);
-#if INTARNA_MULITHREADING
-											////////////////////// exception handling ///////////////////////////
-											} catch (std::exception & e) {
-												// ensure exception handling for first failed thread only
-												#pragma omp critical(intarna_omp_exception)
-												{
-													if (!threadAborted) {
-														// store exception information
-														exceptionPtrDuringOmp = std::make_exception_ptr(e);
-														exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #target "<<targetNumber <<" #query " <<queryNumber <<" : "<<e.what();
-														// trigger abortion of all threads
-														threadAborted = true;
-														#pragma omp flush (threadAborted)
+													<<" #thread "<<omp_get_thread_num()
+#endif
+#endif
+													<<" ..."; }
+
+											// best energy found so far by other windows
+											// or the k-th best energy of the global top-k output
+											const E_type bestE = std::min( windowPruning ? bestInteractions.getBestE() : E_INF
+																		, topKPruning ? outputTopK->getWorstE() : E_INF );
+											// skip window if it cannot yield an equal or better interaction
+											// or if all its interactions are covered by the symmetric window
+											// (target window right of the query window)
+											const bool skipWindow = (E_isNotINF(bestE)
+													&& (jobBoundKnown ? jobBound : jobEnergy->getBestE( tWindow, queryAcc.at(queryNumber)->getReversedIndexRange(qWindow) )) > bestE)
+												|| (jobSymmetric && tWindow.from > qWindow.to);
+
+											if (!skipWindow) {
+												// trace the processing of the window combination
+												Telemetry::Span traceSpan( "window", !Telemetry::isTraceEnabled() ? std::string()
+														: ("target "+jobEnergy->getAccessibility1().getSequence().getId()+" "+toString(tWindow+1)
+															+" query "+queryAcc.at(queryNumber)->getSequence().getId()+" "+toString(qWindow+1)) );
+
+												// measure prediction (seed and traceback are measured separately)
+												const IndexRange qWindowRev = queryAcc.at(queryNumber)->getReversedIndexRange(qWindow);
+												Telemetry::Timer telemetryTimer( Telemetry::HYBRID
+														, (std::min(tWindow.to,jobEnergy->size1()-1)+1-std::min(tWindow.from,jobEnergy->size1()))
+														* (std::min(qWindowRev.to,jobEnergy->size2()-1)+1-std::min(qWindowRev.from,jobEnergy->size2())) );
+
+												// the part of the target window still to be predicted heuristically
+												// if the time budget is exceeded
+												IndexRange fallbackWindow = tWindow;
+
+												// whether or not the time budget was exceeded by another window
+												bool budgetExceeded;
+#if INTARNA_MULITHREADING
+												#pragma omp atomic read
+#endif
+												budgetExceeded = degraded;
+
+												// partial output : the window reports to its own list that is
+												// written once the window is predicted
+												OutputHandlerInteractionList windowInteractions( !parameters.reportPartial() ? 0
+														: (parameters.reportBestPerRegion() ? std::numeric_limits<size_t>::max() : 1 )
+															* parameters.getOutputConstraint().reportMax );
+												OutputHandler & windowOutput = parameters.reportPartial() ? windowInteractions : *jobOutput;
+
+												if (!budgetExceeded) {
+													// get interaction prediction handler
+													Predictor * predictor = predictorPool.empty()
+															? parameters.getPredictor( *jobEnergy, windowOutput, jobSeedCache
+																	, jobTracker == NULL ? NULL : jobTracker->newPartialTracker() )
+															: getPooledPredictor( parameters, predictorPool, *jobEnergy, windowOutput, jobSeedCache, jobTracker );
+													INTARNA_CHECK_NOT_NULL(predictor,"predictor initialization failed");
+													if (timeBudget > 0) {
+														predictor->setDeadline( deadline );
 													}
-												} // omp critical(intarna_omp_exception)
-											} catch (...) {
-												// ensure exception handling for first failed thread only
-												#pragma omp critical(intarna_omp_exception)
-												{
-													if (!threadAborted) {
-														// store exception information
-														exceptionPtrDuringOmp = std::current_exception();
-														exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #target "<<targetNumber <<" #query " <<queryNumber;
-														// trigger abortion of all threads
-														threadAborted = true;
-														#pragma omp flush (threadAborted)
+
+													// run prediction for this window combination
+													try {
+														predictWindow( parameters, *predictor, tWindow, qWindowRev, bestE, jobSymmetric );
+													} catch (Predictor::Timeout & e) {
+														// the sub-windows reported before the timeout are not predicted again
+														fallbackWindow.from = std::max( tWindow.from, e.remaining1.from );
+														budgetExceeded = true;
+#if INTARNA_MULITHREADING
+														#pragma omp atomic write
+#endif
+														degraded = true;
+													}
+													// garbage collection (if not pooled)
+													if (predictorPool.empty()) {
+														INTARNA_CLEANUP(predictor);
+													}
+												}
+
+												// time budget exceeded : heuristic prediction instead
+												if (budgetExceeded) {
+													Predictor * predictor = parameters.getFallbackPredictor( *jobEnergy, windowOutput, jobSeedCache
+															, jobTracker == NULL ? NULL : jobTracker->newPartialTracker() );
+													INTARNA_CHECK_NOT_NULL(predictor,"predictor initialization failed");
+													predictWindow( parameters, *predictor, fallbackWindow, qWindowRev, bestE, jobSymmetric );
+													INTARNA_CLEANUP(predictor);
+												}
+
+												// partial output : forward to the combination's interactions
+												// and write the window's interactions directly
+												if (parameters.reportPartial()) {
+													BOOST_FOREACH( const Interaction * inter, windowInteractions ) {
+														jobOutput->add( *inter );
 													}
-												} // omp critical(intarna_omp_exception)
+													if (!windowInteractions.empty()) {
+														std::stringstream windowBuffer;
+														windowBuffer <<"#PARTIAL "<<jobEnergy->getAccessibility1().getSequence().getId()
+																<<" "<<queryAcc.at(queryNumber)->getSequence().getId()
+																<<" "<<(tWindow+1)<<" "<<(qWindow+1)<<"\n";
+														reportInteractions( parameters, *jobEnergy, windowInteractions, NULL, false, windowBuffer );
+														outputOrdered.addUnordered( windowBuffer.str() );
+													}
+												}
 											}
-										} // if not threadAborted
-#endif		
-									}} // window combinations
-								} // target ranges
-								} // query ranges
 #if INTARNA_MULITHREADING
-								#pragma omp critical(intarna_omp_outputHandlerUpdate)
+										////////////////////// exception handling ///////////////////////////
+										} catch (std::exception & e) {
+											// ensure exception handling for first failed thread only
+											#pragma omp critical(intarna_omp_exception)
+											{
+												if (!threadAborted) {
+													// store exception information
+													exceptionPtrDuringOmp = std::make_exception_ptr(e);
+													exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #target "<<targetNumber <<" #query " <<queryNumber <<" : "<<e.what();
+													// trigger abortion of all threads
+													threadAborted = true;
+													#pragma omp flush (threadAborted)
+												}
+											} // omp critical(intarna_omp_exception)
+										} catch (...) {
+											// ensure exception handling for first failed thread only
+											#pragma omp critical(intarna_omp_exception)
+											{
+												if (!threadAborted) {
+													// store exception information
+													exceptionPtrDuringOmp = std::current_exception();
+													exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #target "<<targetNumber <<" #query " <<queryNumber;
+													// trigger abortion of all threads
+													threadAborted = true;
+													#pragma omp flush (threadAborted)
+												}
+											} // omp critical(intarna_omp_exception)
+										}
+									} // if not threadAborted
 #endif
-								{// update final output handler
-								BOOST_FOREACH( const Interaction * inter, bestInteractions) {
-									// forward all reported interactions for all regions to final output handler
-									output->add(*inter);
-								}}
+									} // window task
+								} // prediction jobs
+								if (skippedWindows > 0) {
+									ASYNC_VLOG(1) <<"best-first : skipped "<<skippedWindows<<" of "<<windowPairs.size()<<" window combinations for target '"
+											<<parameters.getTargetSequences().at(targetNumber).getId()<<"' and query '"
+											<<parameters.getQuerySequences().at(queryNumber).getId()<<"'";
+								}
 
 #if INTARNA_MULITHREADING
-								#pragma omp atomic update
+								// wait for all window tasks of this target-query combination
+								#pragma omp taskwait
+								// result store : keep the output for later runs (if complete)
+								#pragma omp flush (threadAborted)
+								const bool storeOutput = parameters.getResultStore() != NULL && !threadAborted && !degraded;
+#else
+								// result store : keep the output for later runs (if not degraded)
+								const bool storeOutput = parameters.getResultStore() != NULL && !degraded;
 #endif
-								reportedInteractions += output->reported();
+								if (degraded) {
+									ASYNC_LOG(WARNING) <<"time budget exceeded for target '"<<parameters.getTargetSequences().at(targetNumber).getId()
+											<<"' and query '"<<parameters.getQuerySequences().at(queryNumber).getId()<<"' : using heuristic prediction (--mode=H)";
+								}
+								// garbage collection of all pooled predictors
+								clearPredictorPool( predictorPool );
+								// write the tracked data merged from all predictors
+								for (size_t t=0; t<predTrackers.size(); t++) {
+									 INTARNA_CLEANUP( predTrackers.at(t) );
+								}
+								// and of the shared seeds (after all predictors using them)
+								INTARNA_CLEANUP(seedCache);
 
-								// garbage collection
-								 INTARNA_CLEANUP(output);
+								// collect the window results of the target
+								// and remember them for reuse by the variants
+								std::vector< const OutputHandlerInteractionList * > windowInteractions( windowPairs.size(), NULL );
+								for (size_t job = 0; job < jobInteractions.size() && predictionJobs.at(job).first == 0; ++job) {
+									windowInteractions[predictionJobs.at(job).second] = jobInteractions.at(job);
+									BOOST_FOREACH( const Interaction * inter, *(jobInteractions.at(job)) ) {
+										bestInteractions.add( *inter );
+									}
+								}
+
+								// fused suboptimal sites (reported for all identical targets)
+								const std::vector< std::string > fusedSites = parameters.reportFusedSites()
+										? getFusedSites( parameters, targetNumber, *targetAcc, queryNumber, localQueryAcc, *energy, bestInteractions )
+										: std::vector< std::string >();
+
+								// local buffer the output for this combination is
+								// formatted to without blocking other threads
+								// (empty if finished by a resumed run)
+								std::stringstream outputBuffer;
+								if (finished == NULL || !finished->isFinished( firstIndex + queryNumber )) {
+									if (parameters.reportPartial()) {
+										outputBuffer <<"#FINAL "<<parameters.getTargetSequences().at(targetNumber).getId()<<" "<<parameters.getQuerySequences().at(queryNumber).getId()<<"\n";
+									}
+									if (degraded) {
+										outputBuffer <<"#DEGRADED "<<parameters.getTargetSequences().at(targetNumber).getId()<<" "<<parameters.getQuerySequences().at(queryNumber).getId()<<"\n";
+									}
+									const size_t reported = reportInteractions( parameters, *energy, bestInteractions, NULL, reportedInteractions > 0, outputBuffer, outputTopK, firstIndex + queryNumber );
+									for (size_t f=0; f<fusedSites.size(); f++) {
+										outputBuffer <<"#FUSED "<<parameters.getTargetSequences().at(targetNumber).getId()<<" "<<parameters.getQuerySequences().at(queryNumber).getId()<<" "<<fusedSites.at(f)<<"\n";
+									}
+#if INTARNA_MULITHREADING
+									#pragma omp atomic update
+#endif
+									reportedInteractions += reported;
+								}
 								 INTARNA_CLEANUP(energy);
 
+								// push buffered output to the final output stream
+								// (empty output is added too to complete the order)
+								outputOrdered.add( firstIndex + queryNumber, outputBuffer.str() );
+								if (storeOutput && (finished == NULL || !finished->isFinished( firstIndex + queryNumber ))) {
+									parameters.getResultStore()->write( parameters.getResultKey( targetNumber, queryNumber ), outputBuffer.str() );
+								}
+
+								// report the same interactions for all identical targets
+								for (size_t d=0; d<targetDuplicates.size(); d++) {
+									const size_t duplicateIndex = (targetBatchOffset+targetDuplicates.at(d)) * parameters.getQuerySequences().size() + queryNumber;
+									std::stringstream duplicateBuffer;
+									if (finished == NULL || !finished->isFinished( duplicateIndex )) {
+										if (parameters.reportPartial()) {
+											duplicateBuffer <<"#FINAL "<<parameters.getTargetSequences().at(targetDuplicates.at(d)).getId()<<" "<<parameters.getQuerySequences().at(queryNumber).getId()<<"\n";
+										}
+										if (degraded) {
+											duplicateBuffer <<"#DEGRADED "<<parameters.getTargetSequences().at(targetDuplicates.at(d)).getId()<<" "<<parameters.getQuerySequences().at(queryNumber).getId()<<"\n";
+										}
+										InteractionEnergy* duplicateEnergy = parameters.getEnergyHandler( *(duplicateAcc.at(d)), localQueryAcc, queryEnergyData.at(queryNumber) );
+										INTARNA_CHECK_NOT_NULL(duplicateEnergy,"energy initialization failed");
+										const size_t reported = reportInteractions( parameters, *duplicateEnergy, bestInteractions, &(duplicateAcc.at(d)->getSequence()), reportedInteractions > 0, duplicateBuffer, outputTopK, duplicateIndex );
+										for (size_t f=0; f<fusedSites.size(); f++) {
+											duplicateBuffer <<"#FUSED "<<parameters.getTargetSequences().at(targetDuplicates.at(d)).getId()<<" "<<parameters.getQuerySequences().at(queryNumber).getId()<<" "<<fusedSites.at(f)<<"\n";
+										}
+#if INTARNA_MULITHREADING
+										#pragma omp atomic update
+#endif
+										reportedInteractions += reported;
+										 INTARNA_CLEANUP(duplicateEnergy);
+									}
+									outputOrdered.add( duplicateIndex, duplicateBuffer.str() );
+									if (storeOutput && (finished == NULL || !finished->isFinished( duplicateIndex ))) {
+										parameters.getResultStore()->write( parameters.getResultKey( targetDuplicates.at(d), queryNumber ), duplicateBuffer.str() );
+									}
+								}
+
+								// report the interactions of all variant targets
+								for (size_t v=0; v<variantAcc.size(); v++) {
+									const size_t variantIndex = (targetBatchOffset+targetVariants.at(v)) * parameters.getQuerySequences().size() + queryNumber;
+									std::stringstream variantBuffer;
+									if (finished == NULL || !finished->isFinished( variantIndex )) {
+										if (parameters.reportPartial()) {
+											variantBuffer <<"#FINAL "<<parameters.getTargetSequences().at(targetVariants.at(v)).getId()<<" "<<parameters.getQuerySequences().at(queryNumber).getId()<<"\n";
+										}
+										if (degraded) {
+											variantBuffer <<"#DEGRADED "<<parameters.getTargetSequences().at(targetVariants.at(v)).getId()<<" "<<parameters.getQuerySequences().at(queryNumber).getId()<<"\n";
+										}
+										OutputHandlerInteractionList variantInteractions(
+												(parameters.reportBestPerRegion() ? std::numeric_limits<size_t>::max() : 1 )
+													* parameters.getOutputConstraint().reportMax );
+										// results of the recomputed windows
+										std::vector< bool > recomputed( windowPairs.size(), false );
+										for (size_t job = 0; job < predictionJobs.size(); ++job) {
+											if (predictionJobs.at(job).first == v+1) {
+												recomputed[predictionJobs.at(job).second] = true;
+												BOOST_FOREACH( const Interaction * inter, *(jobInteractions.at(job)) ) {
+													variantInteractions.add( *inter );
+												}
+											}
+										}
+										// reuse the results of all other windows from the target
+										for (size_t windowPair = 0; windowPair < windowPairs.size(); ++windowPair) {
+											if (!recomputed.at(windowPair)) {
+												BOOST_FOREACH( const Interaction * inter, *(windowInteractions.at(windowPair)) ) {
+													variantInteractions.add( *inter );
+												}
+											}
+										}
+										const size_t reported = reportInteractions( parameters, *(variantEnergy.at(v)), variantInteractions, &(variantAcc.at(v)->getSequence()), reportedInteractions > 0, variantBuffer, outputTopK, variantIndex );
+#if INTARNA_MULITHREADING
+										#pragma omp atomic update
+#endif
+										reportedInteractions += reported;
+									}
+									outputOrdered.add( variantIndex, variantBuffer.str() );
+									if (storeOutput && (finished == NULL || !finished->isFinished( variantIndex ))) {
+										parameters.getResultStore()->write( parameters.getResultKey( targetVariants.at(v), queryNumber ), variantBuffer.str() );
+									}
+									 INTARNA_CLEANUP( variantEnergy.at(v) );
+								}
+								for (size_t job = 0; job < jobInteractions.size(); ++job) {
+									 INTARNA_CLEANUP( jobInteractions.at(job) );
+								}
+
 #if INTARNA_MULITHREADING
 							////////////////////// exception handling ///////////////////////////
 							} catch (std::exception & e) {
@@ -358,13 +1584,72 @@ int main(int argc, char **argv){
 							}
 						} // if not threadAborted
 #endif
+						} // query task
 					} // for queries
 
-					// write accessibility to file if needed
-					parameters.writeTargetAccessibility( *targetAcc );
+#if INTARNA_MULITHREADING
+					// wait for all query tasks of this target
+					#pragma omp taskwait
+#endif
 
-					// garbage collection
-					 INTARNA_CLEANUP(targetAcc);
+					// write accessibility to file if needed and release it;
+					// done by a separate task such that the (text) output
+					// does not delay the next target of this thread
+#if INTARNA_MULITHREADING
+					# pragma omp task firstprivate(targetNumber,targetAcc,duplicateAcc,variantAcc) shared(exceptionPtrDuringOmp,exceptionInfoDuringOmp) if(deferTasks)
+#endif
+					{
+#if INTARNA_MULITHREADING
+					// explicit try-catch-block due to missing OMP exception forwarding
+					try {
+#endif
+						parameters.writeTargetAccessibility( *targetAcc );
+						for (size_t d=0; d<duplicateAcc.size(); d++) {
+							parameters.writeTargetAccessibility( *(duplicateAcc.at(d)) );
+						}
+						for (size_t v=0; v<variantAcc.size(); v++) {
+							parameters.writeTargetAccessibility( *(variantAcc.at(v)) );
+						}
+#if INTARNA_MULITHREADING
+					////////////////////// exception handling ///////////////////////////
+					} catch (std::exception & e) {
+						// ensure exception handling for first failed thread only
+						#pragma omp critical(intarna_omp_exception)
+						{
+							if (!threadAborted) {
+								// store exception information
+								exceptionPtrDuringOmp = std::make_exception_ptr(e);
+								exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #target "<<targetNumber <<" : "<<e.what();
+								// trigger abortion of all threads
+								threadAborted = true;
+								#pragma omp flush (threadAborted)
+							}
+						} // omp critical(intarna_omp_exception)
+					} catch (...) {
+						// ensure exception handling for first failed thread only
+						#pragma omp critical(intarna_omp_exception)
+						{
+							if (!threadAborted) {
+								// store exception information
+								exceptionPtrDuringOmp = std::current_exception();
+								exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #target "<<targetNumber;
+								// trigger abortion of all threads
+								threadAborted = true;
+								#pragma omp flush (threadAborted)
+							}
+						} // omp critical(intarna_omp_exception)
+					}
+#endif
+
+						// garbage collection
+						for (size_t d=0; d<duplicateAcc.size(); d++) {
+							 INTARNA_CLEANUP( duplicateAcc.at(d) );
+						}
+						for (size_t v=0; v<variantAcc.size(); v++) {
+							 INTARNA_CLEANUP( variantAcc.at(v) );
+						}
+						 INTARNA_CLEANUP(targetAcc);
+					} // accessibility output task
 
 #if INTARNA_MULITHREADING
 				////////////////////// exception handling ///////////////////////////
@@ -397,10 +1682,50 @@ int main(int argc, char **argv){
 				}
 			} // if not threadAborted
 #endif
-		} // for targets
+			} // for targets
+			} // target task
+		} // for target tasks
+		} // omp single
+
+		// cleanup prefetched target accessibilities not used (e.g. finished or aborted)
+		for (size_t t=0; t<prefetchedTargetAcc.size(); t++) {
+			 INTARNA_CLEANUP( prefetchedTargetAcc[t] );
+		}
+		prefetchedTargetAcc.clear();
+
+		// update offset for the next batch
+		targetBatchOffset += parameters.getTargetSequences().size();
+
+		} // target batches
+#if INTARNA_MULITHREADING
+		while ( !threadAborted && parameters.parseNextTargetBatch() );
+#else
+		while ( parameters.parseNextTargetBatch() );
+#endif
+
+		// write output of combinations still buffered (e.g. due to abortion)
+		outputOrdered.flush();
+		// write the global top-k output
+		 INTARNA_CLEANUP(outputTopK);
 
 		// garbage collection
 		for (size_t queryNumber=0; queryNumber < queryAcc.size(); queryNumber++) {
+			 INTARNA_CLEANUP( queryEnergyData[queryNumber] );
+			// node-local copies (besides the query accessibility itself)
+			for (size_t node=0; node < queryAccNuma.size(); node++) {
+				if (queryAccNuma[node][queryNumber] != queryAcc[queryNumber]) {
+					 INTARNA_CLEANUP( queryAccNuma[node][queryNumber] );
+				}
+			}
+			// not computed (e.g. due to abortion)
+			if (queryAcc[queryNumber] == NULL) {
+				continue;
+			}
+			// server mode : keep for upcoming requests (if not cached already)
+			if (queryAccCacheSize > 0) {
+				queryAccCache.insert( std::make_pair( parameters.getQuerySequences().at(queryNumber).asString(), queryAcc[queryNumber] ) );
+				continue;
+			}
 			// this is a hack to cleanup the original accessibility object
 			Accessibility* queryAccOrig = &(const_cast<Accessibility&>(queryAcc[queryNumber]->getAccessibilityOrigin()) );
 			// write accessibility to file if needed
@@ -409,6 +1734,24 @@ int main(int argc, char **argv){
 			// cleanup (now broken) reverse accessibility object
 			 INTARNA_CLEANUP(queryAcc[queryNumber]);
 		}
+		// limit cache size
+		if (queryAccCache.size() > queryAccCacheSize) {
+			clearAccessibilityCache( queryAccCache );
+		}
+
+		// finalize request output
+		parameters.finishRequest();
+
+		} // requests
+
+		// write all buffered log messages
+		AsyncLog::stop();
+
+		// garbage collection
+		clearAccessibilityCache( queryAccCache );
+
+		// write runtime summary if requested
+		parameters.writeTelemetry();
 
 #if INTARNA_MULITHREADING
 		if (threadAborted) {
@@ -423,12 +1766,14 @@ int main(int argc, char **argv){
 
 	////////////////////// exception handling ///////////////////////////
 	} catch (std::exception & e) {
+		AsyncLog::stop();
 		LOG(WARNING) <<"Exception raised : " <<e.what() <<"\n\n"
 			<<"  ==> Please report to the IntaRNA development team! Thanks!\n";
 		el::Loggers::flushAll();
 		return -1;
 	} catch (...) {
 		std::exception_ptr eptr = std::current_exception();
+		AsyncLog::stop();
 		LOG(WARNING) <<"Unknown exception raised \n\n"
 			<<"  ==> Please report to the IntaRNA development team! Thanks!\n";
 		el::Loggers::flushAll();
@@ -0,0 +1,36 @@
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/AccessibilityAlias.h"
+#include "IntaRNA/AccessibilityBasePair.h"
+
+using namespace IntaRNA;
+
+TEST_CASE( "AccessibilityAlias", "[AccessibilityAlias]" ) {
+
+	// setup easylogging++ stuff if not already done
+	#include "testEasyLoggingSetup.icc"
+
+	RnaSequence rna("test","gguccacguccaa");
+	RnaSequence rnaCopy("copy","gguccacguccaa");
+	AccessibilityBasePair acc(rna, 5, NULL);
+
+	SECTION("forwarding of ED values") {
+		AccessibilityAlias alias( rnaCopy, acc );
+		REQUIRE( alias.getSequence().getId() == "copy" );
+		REQUIRE( alias.getMaxLength() == acc.getMaxLength() );
+		REQUIRE( &(alias.getAccessibilityOrigin()) == &acc );
+		for (size_t i=0; i<rna.size(); i++) {
+			for (size_t j=i; j<rna.size(); j++) {
+				REQUIRE( alias.getED(i,j) == acc.getED(i,j) );
+			}
+		}
+	}
+
+	SECTION("different sequences") {
+		RnaSequence other("other","gguccacguccau");
+		REQUIRE_THROWS( AccessibilityAlias( other, acc ) );
+	}
+
+}
@@ -19,7 +19,7 @@ TEST_CASE("AccessibilityBasePair", "[AccessibilityBasePair]") {
   RnaSequence rna("test", seq);
 
   SECTION("Basepair Energy difference") {
-    AccessibilityBasePair acc(rna, 10, NULL);
+    AccessibilityBasePair acc(rna, 0, NULL);
 
 //    std::cout <<"\n\n########\n";
 //    for (int i =0; i<acc.getSequence().size(); i++) {
@@ -49,4 +49,19 @@ TEST_CASE("AccessibilityBasePair", "[AccessibilityBasePair]") {
     REQUIRE( std::abs( acc.getED(11, 12) - 0.191058 ) < 1e-4 );
 
   }
+
+  SECTION("Restriction to maximal region length") {
+    AccessibilityBasePair acc(rna, 0, NULL);
+    AccessibilityBasePair accBand(rna, 5, NULL);
+    REQUIRE( accBand.getMaxLength() == 5 );
+    for (size_t i = 0; i < rna.size(); i++) {
+      for (size_t j = i; j < rna.size(); j++) {
+        if (j - i < 5) {
+          REQUIRE( accBand.getED(i, j) == acc.getED(i, j) );
+        } else {
+          REQUIRE( accBand.getED(i, j) == Accessibility::ED_UPPER_BOUND );
+        }
+      }
+    }
+  }
 }
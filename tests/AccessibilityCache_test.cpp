@@ -0,0 +1,100 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/AccessibilityCache.h"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace IntaRNA;
+
+TEST_CASE( "AccessibilityCache", "[AccessibilityCache]" ) {
+
+#include "testEasyLoggingSetup.icc"
+
+	const AccessibilityCache cache( "." );
+
+	// ED values to cache
+	AccessibilityCache::EdMatrix ed( 5, 3 );
+	for (size_t i=0; i<ed.getSeqLength(); i++) {
+		for (size_t j=i; j<ed.getSeqLength() && j<i+3; j++) {
+			ed.set(i,j, (E_type)(10*i+j));
+		}
+	}
+
+	const std::string key = "AccessibilityCache_test\n";
+	std::remove( cache.getFileName( key ).c_str() );
+
+	SECTION("keys") {
+		RnaSequence rna("test","ACGUACGU");
+		AccessibilityConstraint accConstr( rna.size(), 0, "", "", "" );
+		VrnaHandler vrna;
+		const std::string key1 = AccessibilityCache::getKey( rna, accConstr, 4, 8, vrna );
+		REQUIRE( key1 == AccessibilityCache::getKey( rna, accConstr, 4, 8, vrna ) );
+		REQUIRE( key1 != AccessibilityCache::getKey( rna, accConstr, 4, 6, vrna ) );
+		REQUIRE( key1 != AccessibilityCache::getKey( rna, accConstr, 3, 8, vrna ) );
+		AccessibilityConstraint accConstr2( rna.size(), "b:1-2", 0, "", "", "" );
+		REQUIRE( key1 != AccessibilityCache::getKey( rna, accConstr2, 4, 8, vrna ) );
+		REQUIRE( cache.getFileName( key1 ) != cache.getFileName( key ) );
+	}
+
+	SECTION("missing entry") {
+		AccessibilityCache::EdMatrix ed2( 5, 3 );
+		REQUIRE_FALSE( cache.read( key, ed2 ) );
+	}
+
+	SECTION("write and read") {
+		cache.write( key, ed );
+		AccessibilityCache::EdMatrix ed2( 5, 3 );
+		REQUIRE( cache.read( key, ed2 ) );
+		for (size_t i=0; i<ed.getSeqLength(); i++) {
+			for (size_t j=i; j<ed.getSeqLength() && j<i+3; j++) {
+				REQUIRE( ed2.get(i,j) == ed.get(i,j) );
+			}
+		}
+		// different dimensions
+		AccessibilityCache::EdMatrix ed3( 5, 2 );
+		REQUIRE_FALSE( cache.read( key, ed3 ) );
+		// different precision
+		AccessibilityCache::EdMatrix ed4( 5, 3, true );
+		REQUIRE_FALSE( cache.read( key, ed4 ) );
+	}
+
+	SECTION("write and map") {
+		cache.write( key, ed );
+		const AccessibilityCache mapCache( ".", true );
+		AccessibilityCache::EdMatrix ed2( 5, 3 );
+		REQUIRE( mapCache.read( key, ed2 ) );
+		REQUIRE( ed2.isReadOnly() == mapCache.isMappingEntries() );
+		// copies share the mapped storage
+		const AccessibilityCache::EdMatrix ed3( ed2 );
+		for (size_t i=0; i<ed.getSeqLength(); i++) {
+			for (size_t j=i; j<ed.getSeqLength() && j<i+3; j++) {
+				REQUIRE( ed2.get(i,j) == ed.get(i,j) );
+				REQUIRE( ed3.get(i,j) == ed.get(i,j) );
+			}
+		}
+		// own storage after resize
+		ed2.resize( 5, 3 );
+		REQUIRE_FALSE( ed2.isReadOnly() );
+		REQUIRE( ed2.get(1,2) == 0 );
+		REQUIRE( ed3.get(1,2) == ed.get(1,2) );
+	}
+
+	SECTION("corrupt entry") {
+		{
+			std::ofstream out( cache.getFileName( key ).c_str() );
+			out <<"no cache entry";
+		}
+		AccessibilityCache::EdMatrix ed2( 5, 3 );
+		REQUIRE_FALSE( cache.read( key, ed2 ) );
+		// colliding key
+		cache.write( key+"x", ed );
+		std::rename( cache.getFileName( key+"x" ).c_str(), cache.getFileName( key ).c_str() );
+		REQUIRE_FALSE( cache.read( key, ed2 ) );
+	}
+
+	std::remove( cache.getFileName( key ).c_str() );
+}
@@ -130,6 +130,21 @@ TEST_CASE( "AccessibilityConstraint", "[AccessibilityConstraint]" ) {
 		REQUIRE( vrnaStyle == "..xx..xx|.xx");
 	}
 
+	SECTION("reversed copy") {
+
+		const size_t seqLength = 6;
+		AccessibilityConstraint c(seqLength, "bb.x.p", 0, "", "", "");
+		AccessibilityConstraint r(c, true);
+
+		REQUIRE( r.isMarkedPaired(0) );
+		REQUIRE( r.isUnconstrained(1) );
+		REQUIRE( r.isMarkedAccessible(2) );
+		REQUIRE( r.isAccessible(2) );
+		REQUIRE( r.isMarkedBlocked(4) );
+		REQUIRE( r.isMarkedBlocked(5) );
+		REQUIRE_FALSE( r.isAccessible(5) );
+		// positions beyond the sequence are not constrained
+		REQUIRE_FALSE( r.isMarkedBlocked(seqLength) );
+	}
 
 }
-
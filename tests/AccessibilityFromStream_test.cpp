@@ -130,6 +130,70 @@ TEST_CASE( "AccessibilityFromStream", "[AccessibilityFromStream]" ) {
 
 	}
 
+	SECTION("parsing errors") {
+
+		const std::string header = "#unpaired probabilities\n #i$	l=1	2	\n";
+		RnaSequence rna3("test","acg");
+
+		// valid input with empty lines
+		std::istringstream accStream( header+"1	1	NA\n\n2	0.5	0.25\n3	1	1\n" );
+		AccessibilityFromStream acc( rna3, 2, NULL, accStream, AccessibilityFromStream::Pu_RNAplfold_Text, 1.0 );
+		REQUIRE( acc.getED(0,0) == 0 );
+		REQUIRE( std::abs( acc.getED(0,1) + std::log(0.25) ) < 1e-5 );
+		REQUIRE( std::abs( acc.getED(1,1) + std::log(0.5) ) < 1e-5 );
+
+		// non-consecutive lines
+		std::istringstream accStream2( header+"1	1	NA\n3	0.5	0.25\n2	1	1\n" );
+		REQUIRE_THROWS( AccessibilityFromStream( rna3, 2, NULL, accStream2, AccessibilityFromStream::Pu_RNAplfold_Text, 1.0 ) );
+		// no probability
+		std::istringstream accStream3( header+"1	1	NA\n2	0.5	1.25\n3	1	1\n" );
+		REQUIRE_THROWS( AccessibilityFromStream( rna3, 2, NULL, accStream3, AccessibilityFromStream::Pu_RNAplfold_Text, 1.0 ) );
+		// missing value
+		std::istringstream accStream4( header+"1	1	NA\n2	0.5\n3	1	1\n" );
+		REQUIRE_THROWS( AccessibilityFromStream( rna3, 2, NULL, accStream4, AccessibilityFromStream::Pu_RNAplfold_Text, 1.0 ) );
+		// missing line
+		std::istringstream accStream5( header+"1	1	NA\n2	0.5	0.25\n" );
+		REQUIRE_THROWS( AccessibilityFromStream( rna3, 2, NULL, accStream5, AccessibilityFromStream::Pu_RNAplfold_Text, 1.0 ) );
+	}
+
+	SECTION("ED binary output reparsed") {
+
+		// prepare stream to read from
+		std::istringstream  accStream(accString);
+
+		// trigger parsing
+		AccessibilityFromStream acc( rna, 10, NULL, accStream, AccessibilityFromStream::Pu_RNAplfold_Text, 1.0 );
+
+		std::stringstream accStream2;
+		acc.writeED_binary( accStream2, 1.0 );
+
+		// trigger parsing
+		AccessibilityFromStream acc2( rna, 10, NULL, accStream2, AccessibilityFromStream::ED_IntaRNA_Binary, 1.0 );
+
+		// check elements
+		REQUIRE( acc2.getMaxLength() == 10 );
+		for (size_t j=0; j<rna.size(); j++) {
+			for (size_t i=(j<10?0:j-9); i<=j; i++) {
+				REQUIRE( acc2.getED(i,j) == acc.getED(i,j) );
+			}
+		}
+
+		// reduced maximal length
+		std::stringstream accStream3( accStream2.str() );
+		AccessibilityFromStream acc3( rna, 5, NULL, accStream3, AccessibilityFromStream::ED_IntaRNA_Binary, 1.0 );
+		REQUIRE( acc3.getMaxLength() == 5 );
+		REQUIRE( acc3.getED(25,29) == acc.getED(25,29) );
+		REQUIRE( acc3.getED(20,29) == Accessibility::ED_UPPER_BOUND );
+
+		// incomplete data
+		std::stringstream accStream4( accStream2.str().substr(0, accStream2.str().size()-1) );
+		REQUIRE_THROWS( AccessibilityFromStream( rna, 10, NULL, accStream4, AccessibilityFromStream::ED_IntaRNA_Binary, 1.0 ) );
+
+		// text input
+		std::istringstream accStream5(accString);
+		REQUIRE_THROWS( AccessibilityFromStream( rna, 10, NULL, accStream5, AccessibilityFromStream::ED_IntaRNA_Binary, 1.0 ) );
+	}
+
 	SECTION("sequence too long") {
 		// prepare stream to read from
 		std::istringstream  accStream(accString);
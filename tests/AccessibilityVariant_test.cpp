@@ -0,0 +1,47 @@
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/AccessibilityVariant.h"
+#include "IntaRNA/AccessibilityBasePair.h"
+
+using namespace IntaRNA;
+
+TEST_CASE( "AccessibilityVariant", "[AccessibilityVariant]" ) {
+
+	// setup easylogging++ stuff if not already done
+	#include "testEasyLoggingSetup.icc"
+
+	RnaSequence rna("test","gguccacguccaa");
+	RnaSequence rnaVar("test_var","ggucggcguccaa");
+	AccessibilityBasePair acc(rna, 5, NULL);
+
+	SECTION("ED values within and outside of the affected range") {
+		const IndexRange affected(3,7);
+		AccessibilityVariant accVar( acc, new AccessibilityBasePair(rnaVar, 5, NULL), affected );
+		AccessibilityBasePair accVarFull(rnaVar, 5, NULL);
+		REQUIRE( accVar.getSequence().getId() == "test_var" );
+		REQUIRE( accVar.getMaxLength() == acc.getMaxLength() );
+		REQUIRE( accVar.getAffectedRange() == affected );
+		REQUIRE( &(accVar.getAccessibilityReference()) == &acc );
+		for (size_t i=0; i<rna.size(); i++) {
+			for (size_t j=i; j<rna.size(); j++) {
+				if (affected.from <= i && j <= affected.to) {
+					REQUIRE( accVar.getED(i,j) == accVarFull.getED(i,j) );
+				} else {
+					REQUIRE( accVar.getED(i,j) == acc.getED(i,j) );
+				}
+			}
+		}
+	}
+
+	SECTION("mutation outside of the affected range") {
+		REQUIRE_THROWS( AccessibilityVariant( acc, new AccessibilityBasePair(rnaVar, 5, NULL), IndexRange(6,10) ) );
+	}
+
+	SECTION("different sequence lengths") {
+		RnaSequence rnaShort("short","gguccacgu");
+		REQUIRE_THROWS( AccessibilityVariant( acc, new AccessibilityBasePair(rnaShort, 5, NULL), IndexRange(0,8) ) );
+	}
+
+}
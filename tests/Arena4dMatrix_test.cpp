@@ -0,0 +1,67 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/Arena4dMatrix.h"
+
+using namespace IntaRNA;
+
+TEST_CASE( "Arena4dMatrix", "[Arena4dMatrix]" ) {
+
+	// setup easylogging++ stuff if not already done
+	#include "testEasyLoggingSetup.icc"
+
+	SECTION("empty") {
+		Arena4dMatrix<int> m;
+		REQUIRE( m.size1() == 0 );
+		REQUIRE( m.size2() == 0 );
+		REQUIRE( m.getBlockCells() == 0 );
+	}
+
+	SECTION("reserve and allocate") {
+		Arena4dMatrix<int> m;
+		m.resize(3,4);
+		REQUIRE( m.size1() == 3 );
+		REQUIRE( m.size2() == 4 );
+		m.reserveBlock(0,0,2,3);
+		m.reserveBlock(2,1,1,1);
+		REQUIRE_THROWS( m.reserveBlock(0,0,1,1) );
+		REQUIRE( m.getBlockCells() == 7 );
+		// not accessible before allocation
+		REQUIRE( m(0,0) == NULL );
+		m.allocate();
+		REQUIRE_THROWS( m.reserveBlock(1,1,1,1) );
+		REQUIRE( m(0,0) != NULL );
+		REQUIRE( m(2,1) != NULL );
+		REQUIRE( m(1,1) == NULL );
+		REQUIRE( m(0,0)->size1() == 2 );
+		REQUIRE( m(0,0)->size2() == 3 );
+		// blocks do not overlap
+		for (size_t w1=0; w1<2; w1++) {
+			for (size_t w2=0; w2<3; w2++) {
+				(*m(0,0))(w1,w2) = (int)(w1*3+w2);
+			}
+		}
+		(*m(2,1))(0,0) = -1;
+		REQUIRE( (*m(0,0))(1,2) == 5 );
+		REQUIRE( (*m(2,1))(0,0) == -1 );
+	}
+
+	SECTION("reuse") {
+		Arena4dMatrix<int> m;
+		m.resize(2,2);
+		m.reserveBlock(1,1,3,3);
+		m.allocate();
+		const int * data = &((*m(1,1))(0,0));
+		// smaller second use is served from the same arena
+		m.clear();
+		REQUIRE( m.size1() == 0 );
+		m.resize(2,2);
+		REQUIRE( m(1,1) == NULL );
+		m.reserveBlock(0,1,2,2);
+		m.allocate();
+		REQUIRE( &((*m(0,1))(0,0)) == data );
+	}
+
+}
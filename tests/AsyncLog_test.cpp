@@ -0,0 +1,46 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/AsyncLog.h"
+
+#if INTARNA_MULITHREADING
+	#include <omp.h>
+#endif
+
+using namespace IntaRNA;
+
+TEST_CASE( "AsyncLog", "[AsyncLog]" ) {
+
+	// setup easylogging++ stuff if not already done
+	#include "testEasyLoggingSetup.icc"
+
+	SECTION("direct output") {
+		REQUIRE_FALSE( AsyncLog::isRunning() );
+		const size_t written = AsyncLog::getWritten();
+		// verbose level not enabled : message is not shown
+		AsyncLog::log( el::Level::Verbose, 99, "direct" );
+		REQUIRE( AsyncLog::getWritten() == written+1 );
+	}
+
+	SECTION("buffered output") {
+		const size_t written = AsyncLog::getWritten();
+		AsyncLog::start( 1 );
+#if INTARNA_MULITHREADING
+		REQUIRE( AsyncLog::isRunning() );
+		#pragma omp parallel for num_threads(4)
+#endif
+		for (int i=0; i<1000; i++) {
+			AsyncLog::log( el::Level::Verbose, 99, "buffered" );
+		}
+		AsyncLog::stop();
+		REQUIRE_FALSE( AsyncLog::isRunning() );
+		// all messages written after stop
+		REQUIRE( AsyncLog::getWritten() == written+1000 );
+		// stopping again has no effect
+		AsyncLog::stop();
+		REQUIRE( AsyncLog::getWritten() == written+1000 );
+	}
+
+}
@@ -0,0 +1,63 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/AsyncOutputStream.h"
+
+#include <sstream>
+
+using namespace IntaRNA;
+
+TEST_CASE( "AsyncOutputStream", "[AsyncOutputStream]" ) {
+
+	// setup easylogging++ stuff if not already done
+	#include "testEasyLoggingSetup.icc"
+
+	SECTION("write in small chunks") {
+		std::ostringstream sink, expected;
+		{
+			AsyncOutputStream out( &sink, false, 7, 2 );
+			for (size_t i=0; i<1000; i++) {
+				out <<"line " <<i <<'\n';
+				expected <<"line " <<i <<'\n';
+				if (i % 100 == 0) {
+					out.flush();
+				}
+			}
+			REQUIRE( out.good() );
+			REQUIRE( (size_t)out.tellp() == expected.str().size() );
+			REQUIRE( &(out.getSink()) == &sink );
+		}
+		REQUIRE( sink.str() == expected.str() );
+	}
+
+	SECTION("write large blocks") {
+		std::ostringstream sink;
+		const std::string block( 100, 'x' );
+		{
+			AsyncOutputStream out( &sink, false, 16, 1 );
+			for (size_t i=0; i<50; i++) {
+				out <<block;
+			}
+		}
+		REQUIRE( sink.str().size() == 50*block.size() );
+		REQUIRE( sink.str().find_first_not_of('x') == std::string::npos );
+	}
+
+	SECTION("nothing written") {
+		std::ostringstream sink;
+		{
+			AsyncOutputStream out( &sink, false );
+		}
+		REQUIRE( sink.str().empty() );
+	}
+
+	SECTION("delete sink") {
+		std::ostream * out = new AsyncOutputStream( new std::ostringstream(), true );
+		*out <<"test";
+		// has to delete the wrapped stream too
+		deleteOutputStream( out );
+	}
+
+}
@@ -0,0 +1,105 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/BatchPredictor.h"
+
+#include <map>
+
+using namespace IntaRNA;
+
+/**
+ * Result handler storing the best energy of each target-query combination
+ */
+class BatchPredictorTestHandler : public BatchPredictor::ResultHandler {
+public:
+	//! best energy per (target,query) combination
+	std::map< std::pair<size_t,size_t>, E_type > bestE;
+	void handle( const size_t targetNumber
+				, const size_t queryNumber
+				, const InteractionEnergy & energy
+				, const OutputHandlerInteractionList & interactions )
+	{
+		bestE[ std::make_pair(targetNumber,queryNumber) ] = interactions.empty() ? E_INF : (*interactions.begin())->energy;
+	}
+};
+
+/**
+ * Sequence producer providing the sequences of a vector
+ */
+class BatchPredictorTestProducer : public BatchPredictor::SequenceProducer {
+public:
+	const std::vector< RnaSequence > & seqs;
+	size_t nextSeq;
+	BatchPredictorTestProducer( const std::vector< RnaSequence > & seqs )
+		: seqs(seqs), nextSeq(0)
+	{}
+	RnaSequence * next() {
+		return nextSeq < seqs.size() ? new RnaSequence( seqs.at(nextSeq++) ) : NULL;
+	}
+};
+
+TEST_CASE( "BatchPredictor", "[BatchPredictor]" ) {
+
+	// setup easylogging++ stuff if not already done
+	#include "testEasyLoggingSetup.icc"
+
+	BatchPredictor::Parameters params;
+	params.energy = 'B';
+	params.tAcc = 'N';
+	params.qAcc = 'N';
+	params.seedBP = 3;
+	params.threads = 2;
+	params.targetBatchSize = 2;
+
+	std::vector< RnaSequence > targets;
+	targets.push_back( RnaSequence("t1","AAAGGGGAAA") );
+	targets.push_back( RnaSequence("t2","AAAAAAAAAA") );
+	targets.push_back( RnaSequence("t3","GGGG") );
+	std::vector< RnaSequence > queries;
+	queries.push_back( RnaSequence("q1","CCCC") );
+	queries.push_back( RnaSequence("q2","UUUCCUUU") );
+
+	SECTION("sequence vectors") {
+		BatchPredictor batch( params );
+		BatchPredictorTestHandler handler;
+		batch.predict( targets, queries, handler );
+		// all combinations reported
+		REQUIRE( handler.bestE.size() == 6 );
+		// 4 GC base pairs
+		REQUIRE( handler.bestE[std::make_pair(0,0)] == -4 );
+		REQUIRE( handler.bestE[std::make_pair(2,0)] == -4 );
+		// no seed possible
+		REQUIRE( E_isINF( handler.bestE[std::make_pair(1,0)] ) );
+	}
+
+	SECTION("sequence producer") {
+		BatchPredictor batch( params );
+		BatchPredictorTestHandler handler, handlerVec;
+		BatchPredictorTestProducer producer( targets );
+		batch.predict( producer, queries, handler );
+		batch.predict( targets, queries, handlerVec );
+		// same results with same target numbering
+		REQUIRE( handler.bestE == handlerVec.bestE );
+	}
+
+	SECTION("query packs") {
+		BatchPredictorTestHandler handlerAuto, handlerSingle, handlerAll;
+		BatchPredictor( params ).predict( targets, queries, handlerAuto );
+		params.queryPackSize = 1;
+		BatchPredictor( params ).predict( targets, queries, handlerSingle );
+		params.queryPackSize = 5;
+		BatchPredictor( params ).predict( targets, queries, handlerAll );
+		// same results independent of the packing of the queries
+		REQUIRE( handlerSingle.bestE.size() == 6 );
+		REQUIRE( handlerAuto.bestE == handlerSingle.bestE );
+		REQUIRE( handlerAll.bestE == handlerSingle.bestE );
+	}
+
+	SECTION("unsupported setup") {
+		params.predMode = 'X';
+		REQUIRE_THROWS( BatchPredictor batch( params ) );
+	}
+
+}
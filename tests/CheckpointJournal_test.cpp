@@ -0,0 +1,109 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/CheckpointJournal.h"
+#include "IntaRNA/OutputReorderBuffer.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace IntaRNA;
+
+TEST_CASE( "CheckpointJournal", "[CheckpointJournal]" ) {
+
+#include "testEasyLoggingSetup.icc"
+
+	const std::string fileName = "CheckpointJournal_test.tmp";
+	std::remove( fileName.c_str() );
+
+	SECTION("new journal") {
+		{
+			CheckpointJournal journal( fileName, false );
+			REQUIRE( journal.getFinished() == 0 );
+			REQUIRE( journal.getOutputSize() == 0 );
+			journal.add( 0, 10 );
+			journal.add( 2, 15 );
+			// not recorded by a resumed run
+			REQUIRE_FALSE( journal.isFinished(0) );
+		}
+		// restart without resume
+		CheckpointJournal journal( fileName, false );
+		REQUIRE( journal.getFinished() == 0 );
+		REQUIRE( journal.getOutputSize() == 0 );
+	}
+
+	SECTION("resume") {
+		{
+			CheckpointJournal journal( fileName, true );
+			REQUIRE( journal.getFinished() == 0 );
+			journal.add( 1, 10 );
+			journal.add( 0, 20 );
+			journal.add( 3, 25 );
+		}
+		{
+			CheckpointJournal journal( fileName, true );
+			REQUIRE( journal.getFinished() == 3 );
+			REQUIRE( journal.getOutputSize() == 25 );
+			REQUIRE( journal.isFinished(0) );
+			REQUIRE( journal.isFinished(1) );
+			REQUIRE_FALSE( journal.isFinished(2) );
+			REQUIRE( journal.isFinished(0,2) );
+			REQUIRE_FALSE( journal.isFinished(0,4) );
+			REQUIRE( journal.isFinished(3,3) );
+			// already finished
+			journal.add( 1, 30 );
+			journal.add( 2, 35 );
+		}
+		CheckpointJournal journal( fileName, true );
+		REQUIRE( journal.getFinished() == 4 );
+		REQUIRE( journal.getOutputSize() == 35 );
+		REQUIRE( journal.isFinished(0,4) );
+	}
+
+	SECTION("incomplete line") {
+		{
+			std::ofstream out( fileName.c_str() );
+			out <<"# comment\n"
+				<<"0\t10\n"
+				<<"1\t2";
+		}
+		{
+			CheckpointJournal journal( fileName, true );
+			REQUIRE( journal.getFinished() == 1 );
+			REQUIRE( journal.getOutputSize() == 10 );
+			REQUIRE( journal.isFinished(0) );
+			REQUIRE_FALSE( journal.isFinished(1) );
+		}
+		// incomplete line removed
+		CheckpointJournal journal( fileName, true );
+		REQUIRE( journal.getFinished() == 1 );
+	}
+
+	SECTION("corrupt journal") {
+		{
+			std::ofstream out( fileName.c_str() );
+			out <<"0\tabc\n";
+		}
+		REQUIRE_THROWS( CheckpointJournal( fileName, true ) );
+	}
+
+	SECTION("output recording") {
+		{
+			CheckpointJournal journal( fileName, false );
+			std::stringstream out;
+			OutputReorderBuffer buf( out, 10, 0, &journal );
+			buf.add(1,"bb");
+			buf.add(0,"a");
+			buf.add(2,"");
+			REQUIRE( out.str() == "abb" );
+		}
+		CheckpointJournal journal( fileName, true );
+		REQUIRE( journal.getFinished() == 3 );
+		REQUIRE( journal.getOutputSize() == 3 );
+	}
+
+	std::remove( fileName.c_str() );
+}
@@ -0,0 +1,63 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/CompressedOutputStream.h"
+
+#include <cstdio>
+#include <sstream>
+
+#if INTARNA_HAVE_ZLIB
+	#include <zlib.h>
+#endif
+
+using namespace IntaRNA;
+
+TEST_CASE( "CompressedOutputStream", "[CompressedOutputStream]" ) {
+
+	// setup easylogging++ stuff if not already done
+	#include "testEasyLoggingSetup.icc"
+
+	SECTION("format from file name") {
+		CompressedOutputBuffer::Format format = CompressedOutputBuffer::ZSTD;
+		REQUIRE( CompressedOutputBuffer::getFormat( "out.csv.gz", format ) );
+		REQUIRE( format == CompressedOutputBuffer::GZIP );
+		REQUIRE( CompressedOutputBuffer::getFormat( "out.ZST", format ) );
+		REQUIRE( format == CompressedOutputBuffer::ZSTD );
+		REQUIRE_FALSE( CompressedOutputBuffer::getFormat( "out.gz.csv", format ) );
+		REQUIRE( format == CompressedOutputBuffer::ZSTD );
+	}
+
+#if INTARNA_HAVE_ZLIB
+	SECTION("gzip output") {
+		const std::string fileName = "CompressedOutputStream_test.tmp.gz";
+		std::ostringstream expected;
+		{
+			CompressedOutputStream out( fileName, CompressedOutputBuffer::GZIP );
+			REQUIRE( out.is_open() );
+			for (size_t i=0; i<100000; i++) {
+				out <<"line;" <<i <<";ACGUACGUACGU\n";
+				expected <<"line;" <<i <<";ACGUACGUACGU\n";
+				if (i % 10000 == 0) {
+					out.flush();
+				}
+			}
+			REQUIRE( out.good() );
+		}
+		// decompress
+		std::string decompressed;
+		gzFile in = gzopen( fileName.c_str(), "rb" );
+		REQUIRE( in != NULL );
+		char buf[4096];
+		int read = 0;
+		while ((read = gzread( in, buf, sizeof(buf) )) > 0) {
+			decompressed.append( buf, read );
+		}
+		gzclose( in );
+		std::remove( fileName.c_str() );
+		REQUIRE( decompressed == expected.str() );
+	}
+#endif
+
+}
@@ -0,0 +1,48 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/EdBandMatrix.h"
+
+using namespace IntaRNA;
+
+TEST_CASE( "EdBandMatrix", "[EdBandMatrix]" ) {
+
+	SECTION("full precision") {
+		EdBandMatrix ed( 5, 3 );
+		REQUIRE( ed.getSeqLength() == 5 );
+		REQUIRE( ed.getMaxLength() == 3 );
+		REQUIRE_FALSE( ed.isReducedPrecision() );
+		REQUIRE( ed.getDataSize() == 15*sizeof(E_type) );
+		REQUIRE( ed.get(1,3) == 0 );
+		ed.set( 1, 3, (E_type)1.234 );
+		ed.set( 4, 4, E_INF );
+		REQUIRE( ed.get(1,3) == (E_type)1.234 );
+		REQUIRE( E_isINF( ed.get(4,4) ) );
+		REQUIRE( ed.get(1,2) == 0 );
+	}
+
+	SECTION("reduced precision") {
+		EdBandMatrix ed( 5, 3, true );
+		REQUIRE( ed.isReducedPrecision() );
+		REQUIRE( ed.getDataSize() == 15*sizeof(uint16_t) );
+		ed.set( 1, 3, (E_type)1.234 );
+		ed.set( 2, 2, E_INF );
+		ed.set( 0, 0, (E_type)1000 );
+		REQUIRE( std::abs( ed.get(1,3) - (E_type)1.234 ) <= EdBandMatrix::fixedPointResolution/2 );
+		REQUIRE( E_isINF( ed.get(2,2) ) );
+		REQUIRE( E_isNotINF( ed.get(0,0) ) );
+		REQUIRE( ed.get(0,0) > 600 );
+	}
+
+	SECTION("resize") {
+		EdBandMatrix ed( 5, 3, true );
+		ed.set( 1, 3, 2 );
+		ed.resize( 4, 2 );
+		REQUIRE_FALSE( ed.isReducedPrecision() );
+		REQUIRE( ed.getDataSize() == 8*sizeof(E_type) );
+		REQUIRE( ed.get(1,2) == 0 );
+	}
+
+}
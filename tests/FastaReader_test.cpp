@@ -0,0 +1,103 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/FastaReader.h"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+using namespace IntaRNA;
+
+TEST_CASE( "FastaReader", "[FastaReader]" ) {
+
+	// setup easylogging++ stuff if not already done
+	#include "testEasyLoggingSetup.icc"
+
+	const std::string fileName = "FastaReader_test.tmp.fa";
+	{
+		std::ofstream out( fileName.c_str() );
+		out <<"\n"
+			<<">seq1 first\n"
+			<<"ACGU\n"
+			<<"AC\n"
+			<<"> seq2 \r\n"
+			<<"  acguacgu \r\n"
+			<<"\n"
+			<<">seq3\n"
+			<<"GGGG\n"
+			<<"GG\n";
+	}
+
+	SECTION("scanned index") {
+		FastaReader fasta( fileName );
+		REQUIRE_FALSE( fasta.isFaiIndexed() );
+		REQUIRE( fasta.size() == 3 );
+		REQUIRE( fasta.getId(0) == "seq1 first" );
+		REQUIRE( fasta.getId(1) == "seq2" );
+		REQUIRE( fasta.getId(2) == "seq3" );
+		std::string sequence;
+		fasta.getSequence( 0, sequence );
+		REQUIRE( sequence == "ACGUAC" );
+		fasta.getSequence( 1, sequence );
+		REQUIRE( sequence == "acguacgu" );
+		fasta.getSequence( 2, sequence );
+		REQUIRE( sequence == "GGGGGG" );
+	}
+
+	SECTION("piecewise sequence access") {
+		FastaReader fasta( fileName );
+		std::string sequence;
+		size_t filePos = 0;
+		REQUIRE( fasta.appendSequence( 1, filePos, 3, sequence ) == 3 );
+		REQUIRE( fasta.appendSequence( 1, filePos, 3, sequence ) == 3 );
+		REQUIRE( fasta.appendSequence( 1, filePos, 3, sequence ) == 2 );
+		REQUIRE( fasta.appendSequence( 1, filePos, 3, sequence ) == 0 );
+		REQUIRE( sequence == "acguacgu" );
+		sequence.clear();
+		filePos = 0;
+		REQUIRE( fasta.appendSequence( 0, filePos, 5, sequence ) == 5 );
+		REQUIRE( fasta.appendSequence( 0, filePos, 5, sequence ) == 1 );
+		REQUIRE( sequence == "ACGUAC" );
+	}
+
+	SECTION("fai index") {
+		const std::string faiName = fileName+".fai";
+		{
+			// name, length, offset, line bases, line width
+			std::ofstream out( faiName.c_str() );
+			out <<"seq1\t6\t13\t4\t5\n"
+				<<"seq3\t6\t50\t4\t5\n";
+		}
+		FastaReader fasta( fileName );
+		REQUIRE( fasta.isFaiIndexed() );
+		REQUIRE( fasta.size() == 2 );
+		REQUIRE( fasta.getId(0) == "seq1 first" );
+		REQUIRE( fasta.getId(1) == "seq3" );
+		std::string sequence;
+		fasta.getSequence( 1, sequence );
+		REQUIRE( sequence == "GGGGGG" );
+		std::remove( faiName.c_str() );
+	}
+
+	SECTION("inconsistent fai index is ignored") {
+		const std::string faiName = fileName+".fai";
+		{
+			std::ofstream out( faiName.c_str() );
+			out <<"seqX\t6\t13\t4\t5\n";
+		}
+		FastaReader fasta( fileName );
+		REQUIRE_FALSE( fasta.isFaiIndexed() );
+		REQUIRE( fasta.size() == 3 );
+		std::remove( faiName.c_str() );
+	}
+
+	std::remove( fileName.c_str() );
+
+	SECTION("missing file") {
+		REQUIRE_THROWS_AS( FastaReader( "FastaReader_test.missing.fa" ), std::runtime_error );
+	}
+
+}
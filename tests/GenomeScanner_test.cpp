@@ -0,0 +1,110 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/GenomeScanner.h"
+
+#include <cstdio>
+#include <fstream>
+#include <set>
+
+using namespace IntaRNA;
+
+/**
+ * Hit handler storing (query, genome boundaries, energy) of each hit
+ */
+class GenomeScannerTestHandler : public GenomeScanner::HitHandler {
+public:
+	//! (query, first target position, last target position) and energy
+	std::vector< std::pair< std::pair< size_t, IndexRange >, E_type > > hits;
+	void handle( const size_t queryNumber
+				, const size_t targetOffset
+				, const InteractionEnergy & energy
+				, const Interaction & interaction )
+	{
+		hits.push_back( std::make_pair( std::make_pair( queryNumber
+				, IndexRange( interaction.basePairs.begin()->first + targetOffset, interaction.basePairs.rbegin()->first + targetOffset ) )
+				, interaction.energy ) );
+	}
+};
+
+/**
+ * Sequence stream providing a string in pieces of at most 3 bases
+ */
+class GenomeScannerTestStream : public GenomeScanner::SequenceStream {
+public:
+	const std::string seq;
+	size_t pos;
+	GenomeScannerTestStream( const std::string & seq )
+		: seq(seq), pos(0)
+	{}
+	size_t read( const size_t length, std::string & sequence ) {
+		const size_t n = std::min( std::min<size_t>( length, 3 ), seq.size()-pos );
+		sequence.append( seq, pos, n );
+		pos += n;
+		return n;
+	}
+};
+
+TEST_CASE( "GenomeScanner", "[GenomeScanner]" ) {
+
+	// setup easylogging++ stuff if not already done
+	#include "testEasyLoggingSetup.icc"
+
+	GenomeScanner::Parameters params;
+	params.energy = 'B';
+	params.tAcc = 'N';
+	params.qAcc = 'N';
+	params.seedBP = 3;
+	params.threads = 2;
+	params.tIntLenMax = 6;
+
+	// sites at positions 8-11 (overlap of chunks 1 and 2) and 28-31
+	const std::string target = "AAAAAAAAGGGGAAAAAAAAAAAAAAAAGGGGAAAAA";
+	std::vector< RnaSequence > queries;
+	queries.push_back( RnaSequence("q1","CCCC") );
+
+	SECTION("sequence stream") {
+		GenomeScanner scanner( params, 10 );
+		GenomeScannerTestHandler handler;
+		GenomeScannerTestStream stream( target );
+		scanner.scan( "genome", stream, queries, handler );
+		// site within the chunk overlap reported once
+		REQUIRE( handler.hits.size() == 2 );
+		REQUIRE( handler.hits.at(0).first.first == 0 );
+		REQUIRE( handler.hits.at(0).first.second == IndexRange(8,11) );
+		REQUIRE( handler.hits.at(0).second == -4 );
+		REQUIRE( handler.hits.at(1).first.second == IndexRange(28,31) );
+		REQUIRE( handler.hits.at(1).second == -4 );
+	}
+
+	SECTION("FASTA file") {
+		const std::string fileName = "GenomeScanner_test.tmp.fa";
+		{
+			std::ofstream out( fileName.c_str() );
+			out <<">genome\n";
+			for (size_t i=0; i<target.size(); i+=5) {
+				out <<target.substr(i,5) <<"\n";
+			}
+		}
+		GenomeScanner scanner( params, 10 );
+		GenomeScannerTestHandler handler, handlerStream;
+		FastaReader fasta( fileName );
+		scanner.scan( fasta, 0, queries, handler );
+		std::remove( fileName.c_str() );
+		GenomeScannerTestStream stream( target );
+		scanner.scan( "genome", stream, queries, handlerStream );
+		REQUIRE( handler.hits == handlerStream.hits );
+	}
+
+	SECTION("unsupported setup") {
+		// interaction length has to be bounded
+		params.tIntLenMax = 0;
+		REQUIRE_THROWS( GenomeScanner( params, 10 ) );
+		// chunks have to be longer than interactions
+		params.tIntLenMax = 10;
+		REQUIRE_THROWS( GenomeScanner( params, 10 ) );
+	}
+
+}
@@ -0,0 +1,63 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/HugePageAllocator.h"
+
+#include <cstdint>
+
+using namespace IntaRNA;
+
+TEST_CASE( "HugePageAllocator", "[HugePageAllocator]" ) {
+
+	// setup easylogging++ stuff if not already done
+	#include "testEasyLoggingSetup.icc"
+
+	const size_t largeBytes = HugePageMemory::hugePageSize + 100;
+
+	SECTION("alignment") {
+		void * small = HugePageMemory::allocate( 3 );
+		void * large = HugePageMemory::allocate( largeBytes );
+		REQUIRE( reinterpret_cast<uintptr_t>(small) % HugePageMemory::alignment == 0 );
+		REQUIRE( reinterpret_cast<uintptr_t>(large) % HugePageMemory::alignment == 0 );
+		HugePageMemory::deallocate( small, 3 );
+		HugePageMemory::deallocate( large, largeBytes );
+		HugePageMemory::clearCache();
+		REQUIRE( HugePageMemory::getCacheSize() == 0 );
+	}
+
+	SECTION("vector") {
+		HugePageAllocator<int>::vector v( 1000, 1 );
+		REQUIRE( reinterpret_cast<uintptr_t>(v.data()) % HugePageMemory::alignment == 0 );
+		v.resize( 100000, 2 );
+		REQUIRE( v.at(999) == 1 );
+		REQUIRE( v.at(1000) == 2 );
+		REQUIRE( reinterpret_cast<uintptr_t>(v.data()) % HugePageMemory::alignment == 0 );
+	}
+
+	SECTION("reuse of large blocks") {
+		HugePageMemory::clearCache();
+		// small blocks are not cached
+		HugePageMemory::deallocate( HugePageMemory::allocate( 100 ), 100 );
+		REQUIRE( HugePageMemory::getCacheSize() == 0 );
+#if INTARNA_HAVE_MMAP
+		void * large = HugePageMemory::allocate( largeBytes );
+		HugePageMemory::deallocate( large, largeBytes );
+		REQUIRE( HugePageMemory::getCacheSize() >= largeBytes );
+		// similar size reuses the cached block
+		REQUIRE( HugePageMemory::allocate( largeBytes - 50 ) == large );
+		REQUIRE( HugePageMemory::getCacheSize() == 0 );
+		HugePageMemory::deallocate( large, largeBytes - 50 );
+		// no caching without cache
+		const size_t cacheLimit = HugePageMemory::getCacheLimit();
+		HugePageMemory::setCacheLimit( 0 );
+		REQUIRE( HugePageMemory::getCacheSize() >= largeBytes );
+		HugePageMemory::clearCache();
+		HugePageMemory::deallocate( HugePageMemory::allocate( largeBytes ), largeBytes );
+		REQUIRE( HugePageMemory::getCacheSize() == 0 );
+		HugePageMemory::setCacheLimit( cacheLimit );
+#endif
+	}
+
+}
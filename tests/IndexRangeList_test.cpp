@@ -194,5 +194,21 @@ TEST_CASE( "IndexRangeList", "[IndexRangeList]" ) {
 
 	}
 
-}
+	SECTION("check intersect") {
+
+		// create lists
+		rangeList.insert(IndexRange(1,2));
+		rangeList.insert(IndexRange(4,8));
+		rangeList.insert(IndexRange(10,10));
+		IndexRangeList other;
+		other.insert(IndexRange(0,4));
+		other.insert(IndexRange(6,6));
+		other.insert(IndexRange(8,12));
 
+		REQUIRE( toString(rangeList.intersect(other)) == "1-2,4-4,6-6,8-8,10-10" );
+		REQUIRE( rangeList.intersect(other) == other.intersect(rangeList) );
+		REQUIRE( rangeList.intersect(IndexRangeList()).empty() );
+
+	}
+
+}
@@ -0,0 +1,101 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/InteractionCompact.h"
+
+#include <algorithm>
+
+using namespace IntaRNA;
+
+TEST_CASE( "InteractionCompact", "[InteractionCompact]" ) {
+
+	// setup easylogging++ stuff if not already done
+	#include "testEasyLoggingSetup.icc"
+
+	RnaSequence r1("r1", "GGGGGAAGGGGG");
+	RnaSequence r2("r2", "CCCCCACCCCC");
+
+	// interaction with two helices of 3 base pairs and an interior loop
+	Interaction i(r1,r2);
+	i.basePairs.push_back( Interaction::BasePair(0,10) );
+	i.basePairs.push_back( Interaction::BasePair(1,9) );
+	i.basePairs.push_back( Interaction::BasePair(2,8) );
+	i.basePairs.push_back( Interaction::BasePair(5,6) );
+	i.basePairs.push_back( Interaction::BasePair(6,5) );
+	i.basePairs.push_back( Interaction::BasePair(7,4) );
+	i.energy = -5;
+	i.setSeedRange( i.basePairs.at(0), i.basePairs.at(2), -3 );
+
+	SECTION("helix run encoding") {
+		InteractionCompact c(i);
+		REQUIRE( c.getS1() == &r1 );
+		REQUIRE( c.getS2() == &r2 );
+		REQUIRE( c.getEnergy() == i.energy );
+		REQUIRE( c.size() == 6 );
+		REQUIRE_FALSE( c.isExplicit() );
+		REQUIRE( c.getFirstBasePair() == Interaction::BasePair(0,10) );
+		REQUIRE( c.getLastBasePair() == Interaction::BasePair(7,4) );
+		// stack of 2 and loop (2,1) followed by a stack of 3
+		REQUIRE( c.getRuns().size() == 2 );
+		REQUIRE( c.getRuns().at(0).stack == 2 );
+		REQUIRE( c.getRuns().at(1).u1 == 2 );
+		REQUIRE( c.getRuns().at(1).u2 == 1 );
+		REQUIRE( c.getRuns().at(1).stack == 3 );
+		// iteration without expansion
+		REQUIRE( std::equal( c.begin(), c.end(), i.basePairs.begin() ) );
+	}
+
+	SECTION("expansion") {
+		InteractionCompact c(i);
+		Interaction e(r2,r1);
+		e.basePairs.push_back( Interaction::BasePair(3,3) );
+		c.expand( e );
+		REQUIRE( e.s1 == &r1 );
+		REQUIRE( e.s2 == &r2 );
+		REQUIRE( e.energy == i.energy );
+		REQUIRE( e.basePairs == i.basePairs );
+		REQUIRE( e.seed != NULL );
+		REQUIRE( e.seed->bp_i == i.seed->bp_i );
+		REQUIRE( e.seed->bp_j == i.seed->bp_j );
+		REQUIRE( e.seed->energy == i.seed->energy );
+		// seed is removed if not present
+		Interaction single(r1,r2);
+		single.basePairs.push_back( Interaction::BasePair(4,4) );
+		single.energy = -1;
+		InteractionCompact(single).expand( e );
+		REQUIRE( e.basePairs == single.basePairs );
+		REQUIRE( e.seed == NULL );
+	}
+
+	SECTION("explicit storage if not encodable") {
+		Interaction unsorted(i);
+		std::swap( unsorted.basePairs.at(1), unsorted.basePairs.at(2) );
+		InteractionCompact c(unsorted);
+		REQUIRE( c.isExplicit() );
+		REQUIRE( c.size() == 6 );
+		REQUIRE( std::equal( c.begin(), c.end(), unsorted.basePairs.begin() ) );
+		REQUIRE_FALSE( c.hasSameBasePairs( InteractionCompact(i) ) );
+		Interaction e(r1,r2);
+		c.expand( e );
+		REQUIRE( e.basePairs == unsorted.basePairs );
+	}
+
+	SECTION("comparison") {
+		InteractionCompact c(i);
+		Interaction shorter(i);
+		shorter.basePairs.erase( shorter.basePairs.begin()+4 );
+		InteractionCompact s(shorter);
+		REQUIRE( c.hasSameBasePairs( InteractionCompact(i) ) );
+		REQUIRE_FALSE( c.hasSameBasePairs( s ) );
+		// same ordering as for interactions
+		REQUIRE( (c < s) == (i < shorter) );
+		REQUIRE( (s < c) == (shorter < i) );
+		REQUIRE( InteractionCompact::isLess( i, s ) == (i < shorter) );
+		shorter.energy = -6;
+		REQUIRE( InteractionCompact::isLess( shorter, c ) );
+		REQUIRE_FALSE( InteractionCompact::isLess( i, c ) );
+	}
+
+}
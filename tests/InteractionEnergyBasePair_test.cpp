@@ -80,4 +80,50 @@ TEST_CASE( "InteractionEnergyBasePair", "[InteractionEnergyBasePair]" ) {
     REQUIRE( std::isinf(energy.getES2(1, 2)) );
   }
 
+	SECTION("best energy bound") {
+		// one base pair each
+		REQUIRE( energy.getBestE( IndexRange(0,0), IndexRange(0,3) ) == -1.0 );
+		REQUIRE( energy.getBestE( IndexRange(0,3), IndexRange(2,2) ) == -1.0 );
+		// at most two base pairs
+		REQUIRE( energy.getBestE( IndexRange(0,1), IndexRange(0,3) ) == -2.0 );
+		// at most four base pairs
+		REQUIRE( energy.getBestE( IndexRange(0,3), IndexRange(0,3) ) == -4.0 );
+		// range exceeds sequence
+		REQUIRE( energy.getBestE( IndexRange(0,10), IndexRange(0,10) ) == -4.0 );
+		REQUIRE( E_isINF( energy.getBestE( IndexRange(4,5), IndexRange(0,3) ) ) );
+	}
+
+	SECTION("Boltzmann weights") {
+		// tabulated energies
+		REQUIRE( std::abs( energy.getBoltzmannWeight( 0.0 ) - 1.0 ) < 1e-6 );
+		REQUIRE( std::abs( energy.getBoltzmannWeight( -1.0 ) - std::exp(1.0) ) < 1e-5 );
+		REQUIRE( std::abs( energy.getBoltzmannWeight( 2.37 ) - std::exp(-2.37) ) < 1e-6 );
+		// energies not at table resolution
+		REQUIRE( std::abs( energy.getBoltzmannWeight( 0.12345 ) - std::exp(-0.12345) ) < 1e-6 );
+		// energies out of table range
+		REQUIRE( std::abs( energy.getBoltzmannWeight( 150.0 ) - std::exp(-150.0) ) < 1e-6 );
+		REQUIRE( energy.getBoltzmannWeight( E_INF ) == 0.0 );
+	}
+
+	SECTION("disabled accessibility") {
+		REQUIRE( energy.isAccessibilityDisabled() );
+		// restricted length to get ED_UPPER_BOUND values too
+		AccessibilityDisabled accShort(rna,2,NULL);
+		ReverseAccessibility rAccShort(accShort);
+		InteractionEnergyBasePair energyShort( accShort, rAccShort, maxLoop1, maxLoop2, true, 1, -1, 1);
+		REQUIRE( energyShort.isAccessibilityDisabled() );
+		// same energies with and without accessibility lookups
+		for (size_t i1=0; i1<rna.size(); i1++) {
+		for (size_t j1=i1; j1<rna.size(); j1++) {
+		for (size_t i2=0; i2<rna.size(); i2++) {
+		for (size_t j2=i2; j2<rna.size(); j2++) {
+			const E_type e = InteractionEnergy::getE< InteractionEnergyBasePair, false >( energyShort, i1, j1, i2, j2, -1.0 );
+			const E_type eDisabled = InteractionEnergy::getE< InteractionEnergyBasePair, true >( energyShort, i1, j1, i2, j2, -1.0 );
+			REQUIRE( (e == eDisabled || (std::isnan(e) && std::isnan(eDisabled))) );
+		}
+		}
+		}
+		}
+	}
+
 }
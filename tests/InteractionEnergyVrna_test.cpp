@@ -0,0 +1,155 @@
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/InteractionEnergyVrna.h"
+#include "IntaRNA/AccessibilityDisabled.h"
+
+using namespace IntaRNA;
+
+TEST_CASE( "InteractionEnergyVrna", "[InteractionEnergyVrna]" ) {
+
+	// setup easylogging++ stuff if not already done
+	#include "testEasyLoggingSetup.icc"
+
+	RnaSequence rna1("test1","GGACUUAGCNAUCCGUAAGCUGA");
+	RnaSequence rna2("test2","UCAGCUUACGGNAUGCUAAGUCCAG");
+
+	AccessibilityDisabled acc1(rna1,0,NULL);
+	AccessibilityDisabled acc2(rna2,0,NULL);
+	ReverseAccessibility rAcc2(acc2);
+
+	VrnaHandler vrnaHandler;
+
+	SECTION("tabulated interior loop energies") {
+
+		for (size_t maxLoop = 0; maxLoop <= 30; maxLoop+=6) {
+
+			// the largest setup exceeds the table size and is computed directly
+			InteractionEnergyVrna energy( acc1, rAcc2, vrnaHandler, maxLoop, (maxLoop == 30 ? maxLoop : maxLoop/2) );
+
+			const RnaSequence::CodeSeq_type & c1 = energy.getAccessibility1().getSequence().asCodes();
+			const RnaSequence::CodeSeq_type & c2 = energy.getAccessibility2().getSequence().asCodes();
+			vrna_md_t foldModel = vrnaHandler.getModel();
+			vrna_param_t * foldParams = vrna_params( &foldModel );
+
+			bool allEqual = true;
+			for (size_t i1=0; i1<energy.size1(); i1++) {
+			for (size_t i2=0; i2<energy.size2(); i2++) {
+			for (size_t j1=i1+1; j1<energy.size1() && j1-i1-1 <= energy.getMaxInternalLoopSize1(); j1++) {
+			for (size_t j2=i2+1; j2<energy.size2() && j2-i2-1 <= energy.getMaxInternalLoopSize2(); j2++) {
+				if (energy.areComplementary(i1,i2) && energy.areComplementary(j1,j2)) {
+					// compare with direct VRNA call
+					allEqual = allEqual && energy.getE_interLeft(i1,j1,i2,j2) ==
+							(E_type)E_IntLoop( (int)(j1-i1-1), (int)(j2-i2-1)
+									, BP_pair[c1.at(i1)][c2.at(i2)], BP_pair[c2.at(j2)][c1.at(j1)]
+									, c1.at(i1+1), c2.at(i2+1), c1.at(j1-1), c2.at(j2-1)
+									, foldParams) / (E_type)100.0;
+				} else {
+					allEqual = allEqual && E_isINF( energy.getE_interLeft(i1,j1,i2,j2) );
+				}
+			}
+			}
+			}
+			}
+			REQUIRE( allEqual );
+
+			free(foldParams);
+		}
+	}
+
+	SECTION("tabulated boundary energies") {
+
+		InteractionEnergyVrna energy( acc1, rAcc2, vrnaHandler, 4, 4 );
+
+		const RnaSequence::CodeSeq_type & c1 = energy.getAccessibility1().getSequence().asCodes();
+		const RnaSequence::CodeSeq_type & c2 = energy.getAccessibility2().getSequence().asCodes();
+		vrna_md_t foldModel = vrnaHandler.getModel();
+		vrna_param_t * foldParams = vrna_params( &foldModel );
+
+		bool allEqual = true;
+		for (size_t i1=0; i1<energy.size1(); i1++) {
+		for (size_t i2=0; i2<energy.size2(); i2++) {
+			if (!energy.areComplementary(i1,i2)) {
+				continue;
+			}
+			const int bpType = BP_pair[c1.at(i1)][c2.at(i2)];
+			const E_type end = (bpType > 2) ? (E_type)foldParams->TerminalAU/(E_type)100.0 : 0.0;
+			// compare with direct VRNA calls
+			allEqual = allEqual
+					&& energy.getE_endLeft(i1,i2) == end
+					&& energy.getE_endRight(i1,i2) == end
+					&& energy.getE_danglingLeft(i1,i2) ==
+						(E_type)E_Stem( bpType, (i1==0 ? -1 : c1.at(i1-1)), (i2==0 ? -1 : c2.at(i2-1)), 1, foldParams )
+							/ (E_type)100.0 - end
+					&& energy.getE_danglingRight(i1,i2) ==
+						(E_type)E_Stem( BP_pair[c2.at(i2)][c1.at(i1)]
+								, (i2+1>=energy.size2() ? -1 : c2.at(i2+1)), (i1+1>=energy.size1() ? -1 : c1.at(i1+1)), 1, foldParams )
+							/ (E_type)100.0 - end;
+		}
+		}
+		REQUIRE( allEqual );
+
+		free(foldParams);
+	}
+
+	SECTION("shared ES values") {
+
+		InteractionEnergyVrna energyA( acc1, rAcc2, vrnaHandler, 4, 4, true );
+		InteractionEnergyVrna energyB( acc1, rAcc2, vrnaHandler, 2, 2, true );
+
+		bool allEqual = true;
+		for (size_t i1=0; i1<energyA.size1(); i1++) {
+		for (size_t j1=i1; j1<energyA.size1(); j1++) {
+			allEqual = allEqual && (energyA.getES1(i1,j1) == energyB.getES1(i1,j1)
+					|| (E_isINF(energyA.getES1(i1,j1)) && E_isINF(energyB.getES1(i1,j1))));
+		}
+		}
+		for (size_t i2=0; i2<energyA.size2(); i2++) {
+		for (size_t j2=i2; j2<energyA.size2(); j2++) {
+			allEqual = allEqual && (energyA.getES2(i2,j2) == energyB.getES2(i2,j2)
+					|| (E_isINF(energyA.getES2(i2,j2)) && E_isINF(energyB.getES2(i2,j2))));
+		}
+		}
+		REQUIRE( allEqual );
+	}
+
+	SECTION("precomputed sequence data") {
+
+		InteractionEnergyVrna::SequenceData data2( rAcc2, vrnaHandler, true );
+		REQUIRE( data2.esValues );
+		REQUIRE_FALSE( data2.dinucleotides.empty() );
+
+		InteractionEnergyVrna energy( acc1, rAcc2, vrnaHandler, 4, 4, true );
+		InteractionEnergyVrna energyData( acc1, rAcc2, vrnaHandler, 4, 4, true, &data2 );
+
+		bool allEqual = true;
+		for (size_t i1=0; i1<energy.size1(); i1++) {
+		for (size_t i2=0; i2<energy.size2(); i2++) {
+		for (size_t j1=i1+1; j1<energy.size1() && j1-i1-1 <= energy.getMaxInternalLoopSize1(); j1++) {
+		for (size_t j2=i2+1; j2<energy.size2() && j2-i2-1 <= energy.getMaxInternalLoopSize2(); j2++) {
+			allEqual = allEqual && (energy.getE_interLeft(i1,j1,i2,j2) == energyData.getE_interLeft(i1,j1,i2,j2)
+					|| (E_isINF(energy.getE_interLeft(i1,j1,i2,j2)) && E_isINF(energyData.getE_interLeft(i1,j1,i2,j2))));
+		}
+		}
+		}
+		}
+		for (size_t i2=0; i2<energy.size2(); i2++) {
+		for (size_t j2=i2; j2<energy.size2(); j2++) {
+			allEqual = allEqual && (energy.getES2(i2,j2) == energyData.getES2(i2,j2)
+					|| (E_isINF(energy.getES2(i2,j2)) && E_isINF(energyData.getES2(i2,j2))));
+		}
+		}
+		REQUIRE( allEqual );
+
+		// data is valid for a copy of the accessibility (as created per NUMA node)
+		ReverseAccessibility rAcc2copy( const_cast<Accessibility&>(rAcc2.getAccessibilityOrigin()), true );
+		REQUIRE( &(rAcc2copy.getSequence()) != &(rAcc2.getSequence()) );
+		InteractionEnergyVrna energyCopy( acc1, rAcc2copy, vrnaHandler, 4, 4, true, &data2 );
+		REQUIRE( energyCopy.getES2(0,energyCopy.size2()-1) == energyData.getES2(0,energyData.size2()-1) );
+
+		// data of another sequence is rejected
+		REQUIRE_THROWS( InteractionEnergyVrna( acc1, ReverseAccessibility(acc1), vrnaHandler, 4, 4, true, &data2 ) );
+	}
+
+}
@@ -90,4 +90,34 @@ TEST_CASE( "Interaction", "[Interaction]" ) {
 
 	}
 
+	SECTION("move construction and assignment") {
+
+		Interaction inter( r, r );
+		inter.basePairs.push_back( Interaction::BasePair( 0, 7 ) );
+		inter.basePairs.push_back( Interaction::BasePair( 1, 6 ) );
+		inter.energy = -2;
+		inter.setSeedRange( inter.basePairs.at(0), inter.basePairs.at(1), -1 );
+		const Interaction::BasePair * bpStorage = inter.basePairs.data();
+
+		// move construction takes over storage
+		Interaction moved( std::move(inter) );
+		REQUIRE( inter.isEmpty() );
+		REQUIRE( inter.seed == NULL );
+		REQUIRE( moved.basePairs.size() == 2 );
+		REQUIRE( moved.basePairs.data() == bpStorage );
+		REQUIRE( moved.energy == -2 );
+		REQUIRE( moved.seed != NULL );
+		REQUIRE( moved.seed->energy == -1 );
+
+		// move assignment takes over storage
+		Interaction assigned( r, r );
+		assigned = std::move(moved);
+		REQUIRE( moved.isEmpty() );
+		REQUIRE( moved.seed == NULL );
+		REQUIRE( assigned.basePairs.data() == bpStorage );
+		REQUIRE( Interaction::dotBracket(assigned) == "((&))");
+		REQUIRE( assigned.seed != NULL );
+
+	}
+
 }
@@ -0,0 +1,65 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/KeyedFileStore.h"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace IntaRNA;
+
+TEST_CASE( "KeyedFileStore", "[KeyedFileStore]" ) {
+
+#include "testEasyLoggingSetup.icc"
+
+	const KeyedFileStore store( ".", "KeyedFileStore-test-1\n", ".test", "test store" );
+
+	const std::string key = "KeyedFileStore_test\n";
+	std::remove( store.getFileName( key ).c_str() );
+
+	SECTION("file names") {
+		REQUIRE( store.getFileName( key ) == "./"+KeyedFileStore::getHash( key )+".test" );
+		REQUIRE( KeyedFileStore::getHash( key ).size() == 16 );
+		REQUIRE( KeyedFileStore::getHash( key ) != KeyedFileStore::getHash( key+"2" ) );
+		// FNV-1a offset basis
+		REQUIRE( KeyedFileStore::getHash( "" ) == "cbf29ce484222325" );
+	}
+
+	SECTION("missing entry") {
+		std::ifstream in;
+		REQUIRE_FALSE( store.open( key, in ) );
+	}
+
+	SECTION("write and read") {
+		const std::string data1 = "some", data2 = " data";
+		KeyedFileStore::DataBlocks data;
+		data.push_back( std::make_pair( data1.c_str(), data1.size() ) );
+		data.push_back( std::make_pair( data2.c_str(), data2.size() ) );
+		store.write( key, data );
+
+		std::ifstream in;
+		REQUIRE( store.open( key, in ) );
+		REQUIRE( (size_t)in.tellg() == store.getDataOffset( key ) );
+		std::string entryData( data1.size()+data2.size(), '\0' );
+		in.read( &(entryData[0]), entryData.size() );
+		REQUIRE( in.good() );
+		REQUIRE( entryData == "some data" );
+		in.close();
+
+		// the file content is available as a whole
+		REQUIRE( KeyedFileStore::getFileContent( store.getFileName( key ) ).substr( store.getDataOffset( key ) ) == "some data" );
+
+		// entries of other stores are rejected
+		const KeyedFileStore store2( ".", "KeyedFileStore-test-2\n", ".test", "test store" );
+		std::ifstream in2;
+		REQUIRE_FALSE( store2.open( key, in2 ) );
+		std::remove( store.getFileName( key ).c_str() );
+	}
+
+	SECTION("missing file content") {
+		REQUIRE_THROWS( KeyedFileStore::getFileContent( store.getFileName( key ) ) );
+	}
+
+}
@@ -0,0 +1,33 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/NumaTopology.h"
+
+using namespace IntaRNA;
+
+TEST_CASE( "NumaTopology", "[NumaTopology]" ) {
+
+	// setup easylogging++ stuff if not already done
+	#include "testEasyLoggingSetup.icc"
+
+	SECTION("parse CPU list") {
+		std::vector<size_t> cpus = NumaTopology::parseCpuList( "0-2,5,7-8\n" );
+		REQUIRE( cpus.size() == 6 );
+		REQUIRE( cpus.at(0) == 0 );
+		REQUIRE( cpus.at(2) == 2 );
+		REQUIRE( cpus.at(3) == 5 );
+		REQUIRE( cpus.at(5) == 8 );
+		REQUIRE( NumaTopology::parseCpuList( "" ).empty() );
+		REQUIRE( NumaTopology::parseCpuList( "3-1" ).empty() );
+		REQUIRE( NumaTopology::parseCpuList( "1,x" ).empty() );
+	}
+
+	SECTION("node access") {
+		REQUIRE( NumaTopology::getNodeNumber() >= 1 );
+		REQUIRE( NumaTopology::getCurrentNode() < NumaTopology::getNodeNumber() );
+		REQUIRE( NumaTopology::getNode( 1000000 ) == 0 );
+	}
+
+}
@@ -68,4 +68,28 @@ TEST_CASE("NussinovHandler", "[NussinovHandler]") {
     REQUIRE(nuss == 3u);
 
   }
+
+  SECTION("Bottom-up unpaired probabilities") {
+    RnaSequence rna("test", "gguccacguccaagguc");
+    const size_t N = rna.size(), maxLength = 7, minLoopLen = 3;
+    const E_type bpWeight = std::exp(1.0);
+    // memoized recursion tables
+    NussinovHandler::E2dMatrix Q(N, N), Qb(N, N);
+    NussinovHandler::P2dMatrix Pbp(N, N), Pu(N, N);
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t j = i; j < N; ++j) {
+        Q(i, j) = Qb(i, j) = -1.0;
+        Pbp(i, j) = Pu(i, j) = -1.0;
+      }
+    }
+    std::vector<NussinovHandler::P_type> PuBand;
+    NussinovHandler::getPuBand(rna, bpWeight, minLoopLen, maxLength, PuBand);
+    REQUIRE(PuBand.size() == N * maxLength);
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t j = i; j < N && j - i < maxLength; ++j) {
+        const NussinovHandler::P_type pu = NussinovHandler::getPu(i, j, rna, bpWeight, minLoopLen, Q, Qb, Pbp, Pu);
+        REQUIRE( std::abs( PuBand[i * maxLength + (j - i)] - pu ) < 1e-5 );
+      }
+    }
+  }
 }
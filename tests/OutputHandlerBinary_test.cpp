@@ -0,0 +1,101 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/OutputHandlerBinary.h"
+#include "IntaRNA/InteractionEnergyBasePair.h"
+#include "IntaRNA/AccessibilityDisabled.h"
+
+#include <cstring>
+#include <sstream>
+
+using namespace IntaRNA;
+
+/**
+ * reads a value from the given position of the binary data and moves the
+ * position behind the value
+ */
+template <typename T>
+T readBinary( const std::string & data, size_t & pos ) {
+	T value;
+	std::memcpy( &value, data.c_str()+pos, sizeof(T) );
+	pos += sizeof(T);
+	return value;
+}
+
+TEST_CASE( "OutputHandlerBinary", "[OutputHandlerBinary]" ) {
+
+	// setup easylogging++ stuff if not already done
+	#include "testEasyLoggingSetup.icc"
+
+	RnaSequence rna("test","ACGU");
+	AccessibilityDisabled acc(rna,rna.size(),NULL);
+	ReverseAccessibility rAcc(acc);
+	InteractionEnergyBasePair energy( acc, rAcc, 1, 1, true, 1, -1, 1 );
+
+	const OutputHandlerCsv::ColTypeList cols = OutputHandlerCsv::string2list("id1,start1,E,hybridDB");
+
+	SECTION("value types") {
+		REQUIRE( OutputHandlerBinary::getValueType( OutputHandlerCsv::id1 ) == OutputHandlerBinary::DICT_STRING );
+		REQUIRE( OutputHandlerBinary::getValueType( OutputHandlerCsv::seedEnd2 ) == OutputHandlerBinary::INT32 );
+		REQUIRE( OutputHandlerBinary::getValueType( OutputHandlerCsv::E_hybrid ) == OutputHandlerBinary::FLOAT32 );
+	}
+
+	SECTION("header") {
+		const std::string header = OutputHandlerBinary::getHeader( cols );
+		REQUIRE( header.substr(0,8) == "IntaRNAB" );
+		size_t pos = 8;
+		REQUIRE( readBinary<uint32_t>( header, pos ) == OutputHandlerBinary::byteOrderMark );
+		REQUIRE( readBinary<uint32_t>( header, pos ) == OutputHandlerBinary::formatVersion );
+		REQUIRE( readBinary<uint32_t>( header, pos ) == 4 );
+		REQUIRE( readBinary<uint8_t>( header, pos ) == OutputHandlerBinary::DICT_STRING );
+		REQUIRE( readBinary<uint32_t>( header, pos ) == 3 );
+		REQUIRE( header.substr(pos,3) == "id1" );
+	}
+
+	SECTION("record batches") {
+		Interaction interaction( rna, rna );
+		interaction.basePairs.push_back( energy.getBasePair(0,0) );
+		interaction.basePairs.push_back( energy.getBasePair(1,1) );
+		interaction.energy = -2.5;
+
+		std::stringstream out;
+		{
+			// batches of at most 2 rows
+			OutputHandlerBinary handler( out, energy, cols, 2 );
+			handler.add( interaction );
+			handler.add( interaction );
+			handler.add( interaction );
+			REQUIRE( handler.reported() == 3 );
+		}
+		const std::string data = out.str();
+		size_t pos = 0;
+		// first batch
+		REQUIRE( readBinary<uint32_t>( data, pos ) == OutputHandlerBinary::batchMarker );
+		REQUIRE( readBinary<uint32_t>( data, pos ) == 2 );
+		// id1 : one dictionary entry
+		REQUIRE( readBinary<uint32_t>( data, pos ) == 1 );
+		REQUIRE( readBinary<uint32_t>( data, pos ) == 4 );
+		REQUIRE( data.substr(pos,4) == "test" );
+		pos += 4;
+		REQUIRE( readBinary<uint32_t>( data, pos ) == 0 );
+		REQUIRE( readBinary<uint32_t>( data, pos ) == 0 );
+		// start1
+		REQUIRE( readBinary<int32_t>( data, pos ) == 1 );
+		REQUIRE( readBinary<int32_t>( data, pos ) == 1 );
+		// E
+		REQUIRE( readBinary<float>( data, pos ) == -2.5 );
+		REQUIRE( readBinary<float>( data, pos ) == -2.5 );
+		// hybridDB
+		REQUIRE( readBinary<uint32_t>( data, pos ) == 1 );
+		const uint32_t hybridLength = readBinary<uint32_t>( data, pos );
+		REQUIRE( data.substr(pos,hybridLength) == Interaction::dotBar(interaction) );
+		pos += hybridLength;
+		pos += 2*sizeof(uint32_t);
+		// second batch
+		REQUIRE( readBinary<uint32_t>( data, pos ) == OutputHandlerBinary::batchMarker );
+		REQUIRE( readBinary<uint32_t>( data, pos ) == 1 );
+	}
+
+}
@@ -0,0 +1,59 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/OutputHandlerInteractionList.h"
+
+using namespace IntaRNA;
+
+TEST_CASE( "OutputHandlerInteractionList", "[OutputHandlerInteractionList]" ) {
+
+	// setup easylogging++ stuff if not already done
+	#include "testEasyLoggingSetup.icc"
+
+	RnaSequence r1("r1", "GGGGG");
+	RnaSequence r2("r2", "CCCCC");
+
+	// interaction (0,4)(1,3) with energy -2
+	Interaction i1(r1,r2);
+	i1.basePairs.push_back( Interaction::BasePair(0,4) );
+	i1.basePairs.push_back( Interaction::BasePair(1,3) );
+	i1.energy = -2;
+	// interaction (2,2)(3,1) with energy -3
+	Interaction i2(r1,r2);
+	i2.basePairs.push_back( Interaction::BasePair(2,2) );
+	i2.basePairs.push_back( Interaction::BasePair(3,1) );
+	i2.energy = -3;
+	// interaction (0,4) with energy -1
+	Interaction i3(r1,r2);
+	i3.basePairs.push_back( Interaction::BasePair(0,4) );
+	i3.energy = -1;
+
+	SECTION("duplicates are ignored") {
+		OutputHandlerInteractionList list(2);
+		list.add( i1 );
+		list.add( i1 );
+		list.add( i2 );
+		list.add( i2 );
+		list.add( i1 );
+		REQUIRE( list.reported() == 5 );
+		REQUIRE( list.end() - list.begin() == 2 );
+		REQUIRE( (*list.begin())->basePairs == i2.basePairs );
+		REQUIRE( (*(list.begin()+1))->basePairs == i1.basePairs );
+	}
+
+	SECTION("only the best distinct interactions are kept") {
+		OutputHandlerInteractionList list(1);
+		list.add( i3 );
+		list.add( i1 );
+		REQUIRE( list.end() - list.begin() == 1 );
+		REQUIRE( (*list.begin())->basePairs == i1.basePairs );
+		list.add( i2 );
+		list.add( i1 );
+		REQUIRE( list.end() - list.begin() == 1 );
+		REQUIRE( (*list.begin())->basePairs == i2.basePairs );
+		REQUIRE( list.getBestE() == -3 );
+	}
+
+}
@@ -0,0 +1,104 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/OutputReorderBuffer.h"
+
+#include <sstream>
+
+using namespace IntaRNA;
+
+TEST_CASE( "OutputReorderBuffer", "[OutputReorderBuffer]" ) {
+
+#include "testEasyLoggingSetup.icc"
+
+	SECTION("in order") {
+		std::stringstream out;
+		OutputReorderBuffer buf(out, 10);
+		buf.add(0,"a");
+		buf.add(1,"b");
+		buf.add(2,"");
+		buf.add(3,"c");
+		REQUIRE( out.str() == "abc" );
+		REQUIRE( buf.getPending() == 0 );
+		REQUIRE( buf.getNextIndex() == 4 );
+	}
+
+	SECTION("reordering") {
+		std::stringstream out;
+		OutputReorderBuffer buf(out, 10);
+		buf.add(2,"c");
+		buf.add(1,"b");
+		REQUIRE( out.str().empty() );
+		REQUIRE( buf.getPending() == 2 );
+		buf.add(0,"a");
+		REQUIRE( out.str() == "abc" );
+		REQUIRE( buf.getPending() == 0 );
+		buf.add(4,"e");
+		buf.add(3,"d");
+		REQUIRE( out.str() == "abcde" );
+	}
+
+	SECTION("first index") {
+		std::stringstream out;
+		OutputReorderBuffer buf(out, 10, 5);
+		buf.add(6,"b");
+		buf.add(5,"a");
+		REQUIRE( out.str() == "ab" );
+	}
+
+	SECTION("unordered") {
+		std::stringstream out;
+		OutputReorderBuffer buf(out, 10);
+		buf.add(1,"b");
+		buf.addUnordered("x");
+		REQUIRE( out.str() == "x" );
+		buf.add(0,"a");
+		REQUIRE( out.str() == "xab" );
+		REQUIRE( buf.getNextIndex() == 2 );
+	}
+
+	SECTION("no buffering") {
+		std::stringstream out;
+		OutputReorderBuffer buf(out, 0);
+		buf.add(2,"c");
+		buf.add(0,"a");
+		buf.add(1,"b");
+		REQUIRE( out.str() == "cab" );
+		REQUIRE( buf.getPending() == 0 );
+	}
+
+	SECTION("bounded buffer") {
+		std::stringstream out;
+		OutputReorderBuffer buf(out, 2);
+		buf.add(1,"b");
+		buf.add(2,"c");
+		REQUIRE( out.str().empty() );
+		// exceeding the limit writes the oldest pending output
+		// and all output in order afterwards
+		buf.add(3,"d");
+		REQUIRE( out.str() == "bcd" );
+		REQUIRE( buf.getPending() == 0 );
+		// late output is written directly
+		buf.add(0,"a");
+		REQUIRE( out.str() == "bcda" );
+		REQUIRE( buf.getPending() == 0 );
+	}
+
+	SECTION("flush") {
+		std::stringstream out;
+		{
+			OutputReorderBuffer buf(out, 10);
+			buf.add(3,"d");
+			buf.add(1,"b");
+			buf.flush();
+			REQUIRE( out.str() == "bd" );
+			REQUIRE( buf.getNextIndex() == 4 );
+			buf.add(5,"f");
+		}
+		// destruction flushes the remaining output
+		REQUIRE( out.str() == "bdf" );
+	}
+
+}
@@ -0,0 +1,59 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/OutputTopK.h"
+
+#include <sstream>
+
+using namespace IntaRNA;
+
+TEST_CASE( "OutputTopK", "[OutputTopK]" ) {
+
+#include "testEasyLoggingSetup.icc"
+
+	SECTION("best outputs sorted by energy") {
+		std::stringstream out;
+		OutputTopK topK(out, 3);
+		REQUIRE( topK.getWorstE() == E_INF );
+		REQUIRE( topK.add( -1, 0, "a" ) );
+		REQUIRE( topK.add( -5, 1, "b" ) );
+		REQUIRE( topK.getWorstE() == E_INF );
+		REQUIRE( topK.add( -3, 2, "c" ) );
+		// full now
+		REQUIRE( topK.getWorstE() == -1 );
+		REQUIRE_FALSE( topK.isCompetitive( 0 ) );
+		REQUIRE( topK.isCompetitive( -1 ) );
+		REQUIRE_FALSE( topK.add( 0, 3, "d" ) );
+		REQUIRE( topK.add( -4, 4, "e" ) );
+		REQUIRE( topK.getWorstE() == -3 );
+		REQUIRE( topK.size() == 3 );
+		REQUIRE( out.str().empty() );
+		topK.flush();
+		REQUIRE( out.str() == "bec" );
+		REQUIRE( topK.size() == 0 );
+	}
+
+	SECTION("equal energies ordered by index") {
+		std::stringstream out;
+		{
+			OutputTopK topK(out, 2);
+			REQUIRE( topK.add( -2, 5, "a" ) );
+			REQUIRE( topK.add( -2, 3, "b" ) );
+			REQUIRE( topK.add( -2, 3, "c" ) );
+			REQUIRE_FALSE( topK.add( -2, 4, "d" ) );
+		}
+		REQUIRE( out.str() == "bc" );
+	}
+
+	SECTION("nothing to store") {
+		std::stringstream out;
+		OutputTopK topK(out, 0);
+		REQUIRE_FALSE( topK.isCompetitive( -10 ) );
+		REQUIRE_FALSE( topK.add( -10, 0, "a" ) );
+		topK.flush();
+		REQUIRE( out.str().empty() );
+	}
+
+}
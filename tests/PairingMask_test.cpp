@@ -0,0 +1,77 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/PairingMask.h"
+#include "IntaRNA/InteractionEnergyBasePair.h"
+#include "IntaRNA/AccessibilityDisabled.h"
+
+using namespace IntaRNA;
+
+TEST_CASE( "PairingMask", "[PairingMask]" ) {
+
+	// setup easylogging++ stuff if not already done
+	#include "testEasyLoggingSetup.icc"
+
+	// sequences exceeding a machine word
+	RnaSequence rna1("test1","GGACUUAGCNAUCCGUAAGCUGAGGACUUAGCNAUCCGUAAGCUGAGGACUUAGCNAUCCGUAAGCUGA");
+	RnaSequence rna2("test2","UCAGCUUACGGNAUGCUAAGUCCAGUCAGCUUACGGNAUGCUAAGUCCAGUCAGCUUACGGNAUGCUAAGUCCAG");
+
+	// block some positions of seq1
+	AccessibilityConstraint accC1(rna1.size(),"...bbb.....................................................xxxxbbbb..",0,"","","");
+	AccessibilityDisabled acc1(rna1,0,&accC1);
+	AccessibilityDisabled acc2(rna2,0,NULL);
+	ReverseAccessibility rAcc2(acc2);
+
+	InteractionEnergyBasePair energy( acc1, rAcc2, 2, 2 );
+
+	SECTION("empty") {
+		PairingMask mask;
+		REQUIRE_FALSE( mask.isPairing(0,0) );
+		REQUIRE( mask.getNextPairing(0,0) == 1 );
+		REQUIRE( mask.getPrevPairing(0,1) == RnaSequence::lastPos );
+	}
+
+	SECTION("setup sanity") {
+		PairingMask mask;
+		REQUIRE_THROWS( mask.setup( energy, IndexRange(0,energy.size1()), IndexRange(0,3), true ) );
+		REQUIRE_THROWS( mask.setup( energy, IndexRange(3,2), IndexRange(0,3), true ) );
+	}
+
+	for (int checkAcc = 0; checkAcc < 2; checkAcc++) {
+
+		const IndexRange r1(1,energy.size1()-1), r2(2,energy.size2()-2);
+		PairingMask mask;
+		mask.setup( energy, r1, r2, checkAcc==1 );
+		REQUIRE( mask.getRange1() == r1 );
+		REQUIRE( mask.getRange2() == r2 );
+
+		bool allEqual = true;
+		for (size_t i1=r1.from; i1<=r1.to; i1++) {
+			// compare with direct calls
+			size_t next = r2.to+1;
+			for (size_t i2=r2.to+1; i2-- > r2.from; ) {
+				const bool isPairing = energy.areComplementary(i1,i2)
+						&& (checkAcc==0 || (energy.isAccessible1(i1) && energy.isAccessible2(i2)));
+				allEqual = allEqual && mask.isPairing(i1,i2) == isPairing;
+				if (isPairing) { next = i2; }
+				allEqual = allEqual && mask.getNextPairing(i1,i2) == next;
+			}
+			// check reverse enumeration
+			size_t prev = RnaSequence::lastPos;
+			for (size_t i2=r2.from; i2<=r2.to+1; i2++) {
+				allEqual = allEqual && mask.getPrevPairing(i1,i2) == prev;
+				if (i2 <= r2.to && mask.isPairing(i1,i2)) { prev = i2; }
+			}
+		}
+		REQUIRE( allEqual );
+
+		// blocked positions
+		if (checkAcc==1) {
+			REQUIRE( mask.getNextPairing(3,r2.from) == r2.to+1 );
+			REQUIRE( mask.getPrevPairing(64,r2.to+1) == RnaSequence::lastPos );
+		}
+	}
+
+}
@@ -0,0 +1,103 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/PredictionTrackerPairMinE.h"
+#include "IntaRNA/AccessibilityDisabled.h"
+#include "IntaRNA/ReverseAccessibility.h"
+#include "IntaRNA/InteractionEnergyBasePair.h"
+
+#include <sstream>
+
+using namespace IntaRNA;
+
+
+TEST_CASE( "PredictionTrackerPairMinE", "[PredictionTrackerPairMinE]" ) {
+
+	// setup easylogging++ stuff if not already done
+	#include "testEasyLoggingSetup.icc"
+
+	// setup dummy data spanning several tiles
+	RnaSequence r1("r1",std::string(150,'A'));
+	RnaSequence r2("r2",std::string(100,'U'));
+	AccessibilityDisabled acc1(r1, 0, NULL);
+	AccessibilityDisabled acc2(r2, 0, NULL);
+	ReverseAccessibility racc( acc2 );
+	InteractionEnergyBasePair energy( acc1, racc );
+
+	SECTION("empty output") {
+		std::stringstream out;
+		PredictionTrackerPairMinE * tracker = new PredictionTrackerPairMinE( energy, &out, "X" );
+		REQUIRE( tracker->getTileNumber() == 0 );
+		REQUIRE( E_isINF( tracker->getMinE( 149, 99 ) ) );
+		// destroy to flush output
+		delete tracker; tracker = NULL;
+
+		// expected row content
+		std::string rowData = "";
+		for (size_t j=0; j<r2.size(); j++) {
+			rowData += ";X";
+		}
+		// header + one line per position of r1
+		std::string line;
+		std::getline( out, line );
+		REQUIRE( line.substr(0,8) == "minE;U_1" );
+		for (size_t i=0; i<r1.size(); i++) {
+			REQUIRE( std::getline( out, line ) );
+			REQUIRE( line == "A_"+toString(i+1)+rowData );
+		}
+		REQUIRE_FALSE( std::getline( out, line ) );
+	}
+
+	SECTION("ranges across tiles") {
+		std::stringstream out;
+		PredictionTrackerPairMinE * tracker = new PredictionTrackerPairMinE( energy, &out, "X" );
+		tracker->updateOptimumCalled( 60,70, 60,65, -2.0 );
+		tracker->updateOptimumCalled( 70,130, 10,20, -1.0 );
+		// only touched tiles are allocated
+		REQUIRE( tracker->getTileNumber() == 2+3 );
+		REQUIRE( tracker->getMinE( 60, 60 ) == -2.0 );
+		REQUIRE( tracker->getMinE( 70, 65 ) == -2.0 );
+		REQUIRE( tracker->getMinE( 70, 20 ) == -1.0 );
+		REQUIRE( tracker->getMinE( 130, 10 ) == -1.0 );
+		REQUIRE( E_isINF( tracker->getMinE( 59, 60 ) ) );
+		REQUIRE( E_isINF( tracker->getMinE( 71, 65 ) ) );
+		REQUIRE( E_isINF( tracker->getMinE( 131, 10 ) ) );
+		REQUIRE( E_isINF( tracker->getMinE( 100, 21 ) ) );
+
+		// partial tracker merges by minimum
+		PredictionTracker * partial = tracker->newPartialTracker();
+		partial->updateOptimumCalled( 70,70, 20,20, -3.0 );
+		partial->updateOptimumCalled( 140,149, 90,99, 1.0 );
+		delete partial; partial = NULL;
+		REQUIRE( tracker->getTileNumber() == 2+3+1 );
+		REQUIRE( tracker->getMinE( 70, 20 ) == -3.0 );
+		REQUIRE( tracker->getMinE( 70, 19 ) == -1.0 );
+		REQUIRE( tracker->getMinE( 149, 99 ) == 1.0 );
+
+		// destroy to flush output
+		delete tracker; tracker = NULL;
+
+		// check single row (reversed order of r2)
+		std::string line;
+		for (size_t i=0; i<=71; i++) {
+			REQUIRE( std::getline( out, line ) );
+		}
+		std::string rowData = "";
+		for (size_t j=r2.size(); j-- > 0; ) {
+			rowData += ";";
+			if (j >= 60 && j <= 65) {
+				rowData += "-2";
+			} else if (j == 20) {
+				rowData += "-3";
+			} else if (j >= 10 && j < 20) {
+				rowData += "-1";
+			} else {
+				rowData += "X";
+			}
+		}
+		REQUIRE( line == "A_71"+rowData );
+	}
+
+}
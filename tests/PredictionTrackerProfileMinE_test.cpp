@@ -83,5 +83,26 @@ TEST_CASE( "PredictionTrackerProfileMinE", "[PredictionTrackerProfileMinE]" ) {
 		REQUIRE( boost::regex_match(s2out.str(),boost::regex("^idx;"+r2.getId()+";minE(\\s+\\d;\\w;X){"+toString(r2.size()-3-4)+"}(\\s+\\d;\\w;1){2}(\\s+\\d;\\w;2)(\\s+\\d;\\w;X){4}\\s*$"), boost::match_perl) );
 	}
 
+	SECTION("merge partial trackers") {
+		// output streams
+		std::stringstream s1out, s2out;
+
+		// create
+		PredictionTrackerProfileMinE * tracker = new PredictionTrackerProfileMinE( energy, &s1out, &s2out, "X");
+		// add ranges via partial trackers
+		PredictionTracker * partial1 = tracker->newPartialTracker();
+		PredictionTracker * partial2 = tracker->newPartialTracker();
+		partial1->updateOptimumCalled( 0,1, 4,5, 2.0 );
+		partial2->updateOptimumCalled( 1,2, 5,6, 1.0 );
+		delete partial1; partial1 = NULL;
+		delete partial2; partial2 = NULL;
+		// destroy to flush output
+		delete tracker; tracker = NULL;
+
+		// check output (identical to direct updates)
+		REQUIRE( boost::regex_match(s1out.str(),boost::regex("^idx;"+r1.getId()+";minE(\\s+\\d;\\w;2)(\\s+\\d;\\w;1){2}(\\s+\\d;\\w;X){"+toString(r1.size()-3)+"}\\s*$"), boost::match_perl) );
+		REQUIRE( boost::regex_match(s2out.str(),boost::regex("^idx;"+r2.getId()+";minE(\\s+\\d;\\w;X){"+toString(r2.size()-3-4)+"}(\\s+\\d;\\w;1){2}(\\s+\\d;\\w;2)(\\s+\\d;\\w;X){4}\\s*$"), boost::match_perl) );
+	}
+
 
 }
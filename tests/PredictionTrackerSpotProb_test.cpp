@@ -9,6 +9,7 @@
 #include "IntaRNA/InteractionEnergyBasePair.h"
 
 #include <stdexcept>
+#include <string>
 
 using namespace IntaRNA;
 
@@ -131,4 +132,71 @@ TEST_CASE( "PredictionTrackerSpotProb", "[PredictionTrackerSpotProb]" ) {
 		REQUIRE( out.str() == "spot;probability\n0&0;0.5\n1&3;0.5\n5&4;0\n" );
 	}
 
+	SECTION("single update - unsorted spots") {
+		// output streams
+		std::stringstream out;
+
+		// create
+		PredictionTrackerSpotProb * tracker = new PredictionTrackerSpotProb( energy, "5&4,2&2,1&4,2&3,1&3", out);
+		// add range
+		//		AACCG
+		//		01234567 01234567
+		//		NNNNUUGA.AGUUNNNN
+		tracker->updateOptimumCalled( 0,1, 4,5, 2.0 ); // 1&4,2&3,1&3
+		// destroy to flush output
+		delete tracker; tracker = NULL;
+
+		// check output (in input order)
+		REQUIRE( out.str() == "spot;probability\n0&0;0\n5&4;0\n2&2;0\n1&4;1\n2&3;1\n1&3;1\n" );
+	}
+
+	SECTION("boundary partition functions") {
+		// output streams
+		std::stringstream outCalls, outZ;
+		const std::string spots = "1&3,5&4,2&2,3&8,2&7";
+
+		// energies of all interaction boundaries
+		PredictionTracker::BoundaryZ Z;
+		Z.resize( r1.size(), r2.size() );
+		for (size_t i1=0; i1<r1.size(); i1++) {
+		for (size_t i2=0; i2<r2.size(); i2++) {
+			Z.reserveBlock( i1, i2, r1.size()-i1, r2.size()-i2 );
+		}
+		}
+		Z.allocate();
+
+		// track each boundary individually
+		PredictionTrackerSpotProb * tracker = new PredictionTrackerSpotProb( energy, spots, outCalls );
+		REQUIRE( tracker->isBoundaryZTracker() );
+		for (size_t i1=0; i1<r1.size(); i1++) {
+		for (size_t i2=0; i2<r2.size(); i2++) {
+			for (size_t w1=0; i1+w1<r1.size(); w1++) {
+			for (size_t w2=0; i2+w2<r2.size(); w2++) {
+				const E_type e = (E_type)((i1+3*w1+2*i2+w2)%5) - 2;
+				tracker->updateOptimumCalled( i1, i1+w1, i2, i2+w2, e );
+				(*Z(i1,i2))(w1,w2) = energy.getBoltzmannWeight( e );
+			}
+			}
+		}
+		}
+		delete tracker; tracker = NULL;
+
+		// track all boundaries at once
+		tracker = new PredictionTrackerSpotProb( energy, spots, outZ );
+		tracker->updateBoundaryZ( Z, 0, 0 );
+		delete tracker; tracker = NULL;
+
+		// check output (equal up to summation order)
+		std::string lineCalls, lineZ;
+		while (std::getline( outCalls, lineCalls )) {
+			REQUIRE( std::getline( outZ, lineZ ) );
+			const size_t sep = lineCalls.find(';');
+			REQUIRE( lineZ.substr(0,sep+1) == lineCalls.substr(0,sep+1) );
+			if (lineCalls.find('&') != std::string::npos) {
+				REQUIRE( std::stod(lineZ.substr(sep+1)) == Approx( std::stod(lineCalls.substr(sep+1)) ).epsilon(0.0001) );
+			}
+		}
+		REQUIRE_FALSE( std::getline( outZ, lineZ ) );
+	}
+
 }
@@ -0,0 +1,154 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/PredictorMaxProbSeed.h"
+#include "IntaRNA/SeedHandlerMfe.h"
+#include "IntaRNA/InteractionEnergyBasePair.h"
+#include "IntaRNA/AccessibilityDisabled.h"
+#include "IntaRNA/OutputHandler.h"
+
+#include <map>
+
+using namespace IntaRNA;
+
+/**
+ * Provides access to the partition functions of the predictor
+ */
+class PredictorMaxProbSeedTest : public PredictorMaxProbSeed {
+public:
+	PredictorMaxProbSeedTest( const InteractionEnergy & energy
+					, OutputHandler & output
+					, SeedHandler * seedHandler )
+	 : PredictorMaxProbSeed(energy,output,NULL,seedHandler)
+	{}
+	using PredictorMaxProbSeed::hybridZ;
+	using PredictorMaxProbSeed::hybridZ_seed;
+	using PredictorMaxProbSeed::getScale;
+};
+
+/**
+ * Ignores all reported interactions
+ */
+class OutputHandlerIgnore : public OutputHandler {
+public:
+	virtual void add( const Interaction & interaction ) {}
+	virtual void add( const InteractionRange & range ) {}
+};
+
+/**
+ * Enumerates all interactions starting with the given base pairs and sums
+ * the Boltzmann weights of all and of the seed-containing interactions
+ * for each right end
+ */
+void
+enumerateInteractions( const InteractionEnergy & energy
+		, const SeedConstraint & seedConstraint
+		, std::vector< std::pair<size_t,size_t> > & bps
+		, const double weight
+		, std::map< std::pair<size_t,size_t>, std::pair<double,double> > & Z )
+{
+	const size_t B = seedConstraint.getBasePairs();
+	// check if any B consecutive base pairs form a seed
+	bool hasSeed = false;
+	for (size_t t=0; !hasSeed && t+B <= bps.size(); t++) {
+		const size_t u1 = bps[t+B-1].first-bps[t].first-(B-1);
+		const size_t u2 = bps[t+B-1].second-bps[t].second-(B-1);
+		hasSeed = u1 <= seedConstraint.getMaxUnpaired1()
+				&& u2 <= seedConstraint.getMaxUnpaired2()
+				&& u1+u2 <= seedConstraint.getMaxUnpairedOverall();
+	}
+	// store weight
+	std::pair<double,double> & curZ = Z[ bps.back() ];
+	curZ.first += weight;
+	if (hasSeed) {
+		curZ.second += weight;
+	}
+	// extend by all possible base pairs
+	const size_t p1 = bps.back().first, p2 = bps.back().second;
+	for (size_t k1=p1+1; k1<energy.size1(); k1++) {
+	for (size_t k2=p2+1; k2<energy.size2(); k2++) {
+		const E_type loopE = energy.getE_interLeft(p1,k1,p2,k2);
+		if (E_isINF(loopE)) {
+			continue;
+		}
+		bps.push_back( std::make_pair(k1,k2) );
+		enumerateInteractions( energy, seedConstraint, bps
+				, weight * (double)energy.getBoltzmannWeight(loopE), Z );
+		bps.pop_back();
+	}
+	}
+}
+
+/**
+ * Compares the partition functions of the predictor with a brute-force
+ * enumeration of all interactions
+ */
+void
+checkPartitionFunctions( const InteractionEnergy & energy
+		, const SeedConstraint & seedConstraint )
+{
+	OutputHandlerIgnore out;
+	PredictorMaxProbSeedTest predictor( energy, out, new SeedHandlerMfe( energy, seedConstraint ) );
+	predictor.predict();
+
+	size_t checkedSeedZ = 0;
+	for (size_t i1=0; i1<energy.size1(); i1++) {
+	for (size_t i2=0; i2<energy.size2(); i2++) {
+		if (!energy.areComplementary(i1,i2)) {
+			continue;
+		}
+		std::map< std::pair<size_t,size_t>, std::pair<double,double> > Z;
+		std::vector< std::pair<size_t,size_t> > bps( 1, std::make_pair(i1,i2) );
+		enumerateInteractions( energy, seedConstraint, bps
+				, (double)energy.getBoltzmannWeight(energy.getE_init()), Z );
+		for (auto z = Z.begin(); z != Z.end(); z++) {
+			const size_t w1 = z->first.first-i1, w2 = z->first.second-i2;
+			const double scale = predictor.getScale(w1+w2+2);
+			if (predictor.hybridZ(i1,i2) != NULL) {
+				REQUIRE( (double)(*predictor.hybridZ(i1,i2))(w1,w2) == Approx( z->second.first * scale ) );
+			}
+			if (predictor.hybridZ_seed(i1,i2) != NULL) {
+				REQUIRE( (double)(*predictor.hybridZ_seed(i1,i2))(w1,w2) == Approx( z->second.second * scale ) );
+				if (z->second.second > 0) {
+					checkedSeedZ++;
+				}
+			}
+		}
+	}
+	}
+	REQUIRE( checkedSeedZ > 0 );
+}
+
+TEST_CASE( "PredictorMaxProbSeed", "[PredictorMaxProbSeed]" ) {
+
+	// setup easylogging++ stuff if not already done
+	#include "testEasyLoggingSetup.icc"
+
+	RnaSequence r1("r1", "GGGAGGGG");
+	RnaSequence r2("r2", "CCCCACCC");
+	AccessibilityDisabled acc1(r1,r1.size(),NULL);
+	AccessibilityDisabled acc2(r2,r2.size(),NULL);
+	ReverseAccessibility rAcc2(acc2);
+	InteractionEnergyBasePair energy( acc1, rAcc2 );
+
+	SECTION("seed-containing interactions : stacked seeds") {
+		SeedConstraint seedConstraint( 3, 0, 0, 0, 999, 999
+				, IndexRangeList(""), IndexRangeList(""), "" );
+		checkPartitionFunctions( energy, seedConstraint );
+	}
+
+	SECTION("seed-containing interactions : seeds with unpaired bases") {
+		SeedConstraint seedConstraint( 3, 1, 1, 1, 999, 999
+				, IndexRangeList(""), IndexRangeList(""), "" );
+		checkPartitionFunctions( energy, seedConstraint );
+	}
+
+	SECTION("seed-containing interactions : two base pair seeds") {
+		SeedConstraint seedConstraint( 2, 2, 1, 1, 999, 999
+				, IndexRangeList(""), IndexRangeList(""), "" );
+		checkPartitionFunctions( energy, seedConstraint );
+	}
+
+}
@@ -0,0 +1,82 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/PredictorMfe4d.h"
+#include "IntaRNA/PredictorMfe2d.h"
+#include "IntaRNA/InteractionEnergyBasePair.h"
+#include "IntaRNA/AccessibilityDisabled.h"
+#include "IntaRNA/OutputHandlerInteractionList.h"
+
+using namespace IntaRNA;
+
+/**
+ * Predicts the mfe interaction energy of the given ranges
+ */
+E_type
+getMfe( Predictor & predictor, OutputHandlerInteractionList & out
+		, const IndexRange & r1 = IndexRange(0,RnaSequence::lastPos) )
+{
+	predictor.predict( r1 );
+	return out.empty() ? E_INF : (*out.begin())->energy;
+}
+
+TEST_CASE( "PredictorMfe4d", "[PredictorMfe4d]" ) {
+
+	// setup easylogging++ stuff if not already done
+	#include "testEasyLoggingSetup.icc"
+
+	std::vector< RnaSequence > targets;
+	targets.push_back( RnaSequence("t0", "GUCAGCUAGGCUACGAUCGGAUCCGAUGCA") );
+	targets.push_back( RnaSequence("t1", "AGCUUAGCCGAUAGGCUAACGUCG") );
+	std::vector< RnaSequence > queries;
+	queries.push_back( RnaSequence("q0", "CGAUCCGAUCGUAGCC") );
+	queries.push_back( RnaSequence("q1", "UAGCCUAUCGGCUAAGCUGA") );
+
+	SECTION("optima of several sequence pairs") {
+		// predict all pairs consecutively as done for multi-sequence input
+		for (size_t t=0; t<targets.size(); t++) {
+		for (size_t q=0; q<queries.size(); q++) {
+			AccessibilityDisabled acc1( targets.at(t), 0, NULL );
+			AccessibilityDisabled acc2( queries.at(q), 0, NULL );
+			ReverseAccessibility rAcc2( acc2 );
+			InteractionEnergyBasePair energy( acc1, rAcc2 );
+
+			// same mfe as the 2D prediction
+			OutputHandlerInteractionList out2d(1);
+			PredictorMfe2d predictor2d( energy, out2d, NULL );
+			OutputHandlerInteractionList out4d(1);
+			PredictorMfe4d predictor4d( energy, out4d, NULL );
+			const E_type mfe = getMfe( predictor2d, out2d );
+			REQUIRE( E_isNotINF( mfe ) );
+			REQUIRE( getMfe( predictor4d, out4d ) == Approx( mfe ) );
+		}
+		}
+	}
+
+	SECTION("reused predictor") {
+		AccessibilityDisabled acc1( targets.at(0), 0, NULL );
+		AccessibilityDisabled acc2( queries.at(1), 0, NULL );
+		ReverseAccessibility rAcc2( acc2 );
+		InteractionEnergyBasePair energy( acc1, rAcc2 );
+
+		// subsequent predict() calls of the same predictor are independent
+		OutputHandlerInteractionList out4d(1);
+		PredictorMfe4d predictor4d( energy, out4d, NULL );
+		const IndexRange ranges[] = { IndexRange(12,29), IndexRange(5,20), IndexRange(0,RnaSequence::lastPos), IndexRange(12,29) };
+		// the output of the reused predictor holds the best of all calls
+		E_type minMfe = E_INF;
+		for (size_t r=0; r<4; r++) {
+			OutputHandlerInteractionList out2d(1);
+			PredictorMfe2d predictor2d( energy, out2d, NULL );
+			const E_type mfe = getMfe( predictor2d, out2d, ranges[r] );
+			minMfe = std::min( minMfe, mfe );
+			OutputHandlerInteractionList out4dNew(1);
+			PredictorMfe4d predictor4dNew( energy, out4dNew, NULL );
+			REQUIRE( getMfe( predictor4dNew, out4dNew, ranges[r] ) == Approx( mfe ) );
+			REQUIRE( getMfe( predictor4d, out4d, ranges[r] ) == Approx( minMfe ) );
+		}
+	}
+
+}
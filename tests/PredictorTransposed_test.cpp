@@ -0,0 +1,115 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/PredictorTransposed.h"
+#include "IntaRNA/PredictorMfe2d.h"
+#include "IntaRNA/InteractionEnergyBasePair.h"
+#include "IntaRNA/AccessibilityDisabled.h"
+#include "IntaRNA/OutputHandlerInteractionList.h"
+
+using namespace IntaRNA;
+
+TEST_CASE( "PredictorTransposed", "[PredictorTransposed]" ) {
+
+	// setup easylogging++ stuff if not already done
+	#include "testEasyLoggingSetup.icc"
+
+	RnaSequence r1("r1", "AAAAAAAAGCCGAAAAAAAAAAAA");
+	RnaSequence r2("r2", "ACGGCA");
+
+	SECTION("interaction transposition") {
+		// interaction (4,5)(6,3) with seed (4,5)-(6,3)
+		Interaction i(r1,r2);
+		i.basePairs.push_back( Interaction::BasePair(4,5) );
+		i.basePairs.push_back( Interaction::BasePair(6,3) );
+		i.energy = -2;
+		i.setSeedRange( i.basePairs.front(), i.basePairs.back(), -1 );
+
+		Interaction t = PredictorTransposed::getTransposed( i );
+		REQUIRE( t.s1 == &r2 );
+		REQUIRE( t.s2 == &r1 );
+		REQUIRE( t.energy == i.energy );
+		REQUIRE( t.basePairs.size() == 2 );
+		REQUIRE( t.basePairs.front() == Interaction::BasePair(3,6) );
+		REQUIRE( t.basePairs.back() == Interaction::BasePair(5,4) );
+		REQUIRE( t.isValid() );
+		REQUIRE( t.seed != NULL );
+		REQUIRE( t.seed->bp_i == Interaction::BasePair(3,6) );
+		REQUIRE( t.seed->bp_j == Interaction::BasePair(5,4) );
+
+		// transposing twice yields the original
+		Interaction tt = PredictorTransposed::getTransposed( t );
+		REQUIRE( tt.s1 == &r1 );
+		REQUIRE( tt.basePairs == i.basePairs );
+		REQUIRE( tt.seed->bp_i == i.seed->bp_i );
+		REQUIRE( tt.seed->bp_j == i.seed->bp_j );
+
+		InteractionRange range( i );
+		InteractionRange rt = PredictorTransposed::getTransposed( range );
+		REQUIRE( rt.s1 == &r2 );
+		REQUIRE( rt.r1 == IndexRange(3,5) );
+		REQUIRE( rt.r2 == IndexRange(6,4) );
+		REQUIRE( PredictorTransposed::getTransposed( rt ).r1 == range.r1 );
+		REQUIRE( PredictorTransposed::getTransposed( rt ).r2 == range.r2 );
+	}
+
+	SECTION("transposed prediction") {
+		AccessibilityDisabled acc1(r1,r1.size(),NULL);
+		AccessibilityDisabled acc2(r2,r2.size(),NULL);
+		ReverseAccessibility rAcc2(acc2);
+		InteractionEnergyBasePair energy( acc1, rAcc2, 2, 3 );
+
+		// direct prediction
+		OutputHandlerInteractionList out(1);
+		PredictorMfe2d predictor( energy, out, NULL );
+		predictor.predict();
+		REQUIRE( out.end() - out.begin() == 1 );
+
+		// transposed prediction
+		OutputHandlerInteractionList outT(1);
+		ReverseAccessibility * rAcc1 = new ReverseAccessibility(acc1);
+		PredictorTransposed predictorT( energy, outT, rAcc1
+				, new InteractionEnergyBasePair( acc2, *rAcc1, 3, 2 ) );
+		predictorT.setTransposedPredictor(
+				new PredictorMfe2d( predictorT.getTransposedEnergy(), predictorT.getTransposedOutput(), NULL ) );
+		predictorT.predict();
+		REQUIRE( outT.end() - outT.begin() == 1 );
+
+		// same optimum reported for the original orientation
+		REQUIRE( (*outT.begin())->s1 == &r1 );
+		REQUIRE( (*outT.begin())->s2 == &r2 );
+		REQUIRE( (*outT.begin())->energy == (*out.begin())->energy );
+		REQUIRE( (*outT.begin())->basePairs == (*out.begin())->basePairs );
+	}
+
+	SECTION("direct prediction of short ranges") {
+		AccessibilityDisabled acc1(r1,r1.size(),NULL);
+		AccessibilityDisabled acc2(r2,r2.size(),NULL);
+		ReverseAccessibility rAcc2(acc2);
+		InteractionEnergyBasePair energy( acc1, rAcc2, 2, 3 );
+
+		REQUIRE( PredictorTransposed::isTransposable( r1.size(), r2.size() ) );
+		REQUIRE_FALSE( PredictorTransposed::isTransposable( 12, r2.size() ) );
+
+		// direct prediction of a target range not much longer than the query
+		OutputHandlerInteractionList out(1);
+		PredictorMfe2d predictor( energy, out, NULL );
+		predictor.predict( IndexRange(2,13) );
+		REQUIRE( out.end() - out.begin() == 1 );
+
+		// such ranges are predicted by the direct predictor
+		// (no transposed predictor needed)
+		OutputHandlerInteractionList outT(1);
+		ReverseAccessibility * rAcc1 = new ReverseAccessibility(acc1);
+		PredictorTransposed predictorT( energy, outT, rAcc1
+				, new InteractionEnergyBasePair( acc2, *rAcc1, 3, 2 ) );
+		predictorT.setDirectPredictor( new PredictorMfe2d( energy, outT, NULL ) );
+		predictorT.predict( IndexRange(2,13) );
+		REQUIRE( outT.end() - outT.begin() == 1 );
+		REQUIRE( (*outT.begin())->energy == (*out.begin())->energy );
+		REQUIRE( (*outT.begin())->basePairs == (*out.begin())->basePairs );
+	}
+
+}
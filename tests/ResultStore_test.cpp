@@ -0,0 +1,51 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/ResultStore.h"
+
+#include <cstdio>
+
+using namespace IntaRNA;
+
+TEST_CASE( "ResultStore", "[ResultStore]" ) {
+
+#include "testEasyLoggingSetup.icc"
+
+	const ResultStore store( "." );
+
+	const std::string key = "ResultStore_test\n";
+	std::remove( store.getFileName( key ).c_str() );
+
+	SECTION("keys") {
+		RnaSequence target("t","ACGUACGU");
+		RnaSequence query("q","ACGUACGU");
+		const std::string key1 = ResultStore::getKey( "seedBP=7", target, query );
+		REQUIRE( key1 == ResultStore::getKey( "seedBP=7", target, query ) );
+		REQUIRE( key1 != ResultStore::getKey( "seedBP=6", target, query ) );
+		REQUIRE( key1 != ResultStore::getKey( "seedBP=7", query, target ) );
+		REQUIRE( key1 != ResultStore::getKey( "seedBP=7", RnaSequence("t","ACGUACGA"), query ) );
+		REQUIRE( store.getFileName( key1 ) != store.getFileName( key ) );
+	}
+
+	SECTION("missing entry") {
+		std::string output = "unchanged";
+		REQUIRE_FALSE( store.read( key, output ) );
+		REQUIRE( output == "unchanged" );
+	}
+
+	SECTION("write and read") {
+		const std::string output = "t;1;8;q;1;8;||||||||;-5.2\n";
+		store.write( key, output );
+		std::string output2;
+		REQUIRE( store.read( key, output2 ) );
+		REQUIRE( output2 == output );
+		// empty output is stored too
+		store.write( key, "" );
+		REQUIRE( store.read( key, output2 ) );
+		REQUIRE( output2.empty() );
+		std::remove( store.getFileName( key ).c_str() );
+	}
+
+}
@@ -0,0 +1,67 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/ReverseAccessibility.h"
+#include "IntaRNA/AccessibilityBasePair.h"
+#include "IntaRNA/AccessibilityDisabled.h"
+#include "IntaRNA/InteractionEnergyBasePair.h"
+#include "IntaRNA/OutputHandlerInteractionList.h"
+#include "IntaRNA/PredictorMfe2d.h"
+
+using namespace IntaRNA;
+
+TEST_CASE( "ReverseAccessibility", "[ReverseAccessibility]" ) {
+
+	// setup easylogging++ stuff if not already done
+	#include "testEasyLoggingSetup.icc"
+
+	RnaSequence rna("test","gguccacguccaa");
+	AccessibilityBasePair acc(rna, 5, NULL);
+
+	ReverseAccessibility rAcc( acc );
+	ReverseAccessibility rAccCopy( acc, true );
+
+	SECTION("materialized ED values") {
+		REQUIRE_FALSE( rAcc.isMaterialized() );
+		REQUIRE( rAccCopy.isMaterialized() );
+		REQUIRE( rAccCopy.getSequence().asString() == rAcc.getSequence().asString() );
+		REQUIRE( rAccCopy.getMaxLength() == rAcc.getMaxLength() );
+		const size_t n = rna.size();
+		for (size_t i=0; i<n; i++) {
+			for (size_t j=i; j<n; j++) {
+				REQUIRE( rAcc.getED(i,j) == acc.getED( n-j-1, n-i-1 ) );
+				REQUIRE( rAccCopy.getED(i,j) == rAcc.getED(i,j) );
+			}
+		}
+	}
+
+	SECTION("prediction within a query region") {
+		// only target 4-7 and query 0-3 can interact
+		RnaSequence target("t","AAAAGGGGAAAA");
+		RnaSequence query("q","CCCCAAAAAAAAAAAA");
+		AccessibilityDisabled accT( target, target.size(), NULL );
+		AccessibilityDisabled accQ( query, query.size(), NULL );
+		ReverseAccessibility rAccQ( accQ );
+		InteractionEnergyBasePair energy( accT, rAccQ, 2, 2 );
+		// query region 1-6 (original indexing)
+		const IndexRange qRegion(0,5);
+
+		// the region has to be mapped to the reversed query (as done for --qRegion)
+		OutputHandlerInteractionList out(1);
+		PredictorMfe2d predictor( energy, out, NULL );
+		predictor.predict( IndexRange(0,target.size()-1), rAccQ.getReversedIndexRange(qRegion) );
+		REQUIRE( out.end() - out.begin() == 1 );
+		REQUIRE( (*out.begin())->basePairs.size() == 4 );
+		REQUIRE( (*out.begin())->basePairs.front() == Interaction::BasePair(4,3) );
+		REQUIRE( (*out.begin())->basePairs.back() == Interaction::BasePair(7,0) );
+
+		// the unmapped region covers query 11-16, which can not interact
+		OutputHandlerInteractionList outUnmapped(1);
+		PredictorMfe2d predictorUnmapped( energy, outUnmapped, NULL );
+		predictorUnmapped.predict( IndexRange(0,target.size()-1), qRegion );
+		REQUIRE( (outUnmapped.end() == outUnmapped.begin() || (*outUnmapped.begin())->basePairs.empty()) );
+	}
+
+}
@@ -66,4 +66,49 @@ TEST_CASE( "RnaSequence", "[RNAsequence]" ) {
 		REQUIRE_FALSE( RnaSequence(id+"2",seq+"A") == rna );
 	}
 
+	SECTION( "packed encoding" ) {
+
+		// sequence exceeding a packed word
+		std::string seq = "ACGUNACGUUGCANNAGCUACGAUCGAUCGAUGCAUGGCGN";
+		RnaSequence rna("test", seq);
+
+		REQUIRE( rna.asPackedCodes().size() == 2 );
+		bool allEqual = true;
+		for (size_t i=0; i<seq.size(); i++) {
+			allEqual = allEqual && rna.getPackedCode(i) == (seq.at(i)=='N' ? 0 : std::string("ACGU").find(seq.at(i)));
+		}
+		REQUIRE( allEqual );
+		REQUIRE( rna.getAmbiguousPositions().size() == 4 );
+		REQUIRE( rna.getAmbiguousPositions().at(0) == 4 );
+		REQUIRE( rna.getAmbiguousPositions().at(3) == seq.size()-1 );
+		REQUIRE( RnaSequence("test","ACGU").getAmbiguousPositions().empty() );
+	}
+
+	SECTION( "hashing" ) {
+
+		std::string seq = "ACGUNACGUUGCANNAGCUACGA";
+		RnaSequence rna("test", seq);
+
+		// id independent
+		REQUIRE( rna.getHash() == RnaSequence("test2",seq).getHash() );
+		// sequence dependent
+		REQUIRE( rna.getHash() != RnaSequence("test",seq+"A").getHash() );
+		REQUIRE( RnaSequence("test","AAAN").getHash() != RnaSequence("test","AAAA").getHash() );
+
+		// rolling window hashes equal hashes of the according subsequences
+		const size_t w = 5;
+		std::vector<RnaSequence::Hash_type> hashes = rna.getWindowHashes(w);
+		REQUIRE( hashes.size() == seq.size()-w+1 );
+		bool allEqual = true;
+		for (size_t i=0; i<hashes.size(); i++) {
+			allEqual = allEqual && hashes.at(i) == RnaSequence("sub",seq.substr(i,w)).getHash();
+		}
+		REQUIRE( allEqual );
+		// identical windows
+		REQUIRE( hashes.at(0) != hashes.at(1) );
+		REQUIRE( rna.getWindowHashes(4).at(0) == rna.getWindowHashes(4).at(5) );
+		REQUIRE( rna.getWindowHashes(seq.size()+1).empty() );
+		REQUIRE( rna.getWindowHashes(seq.size()).at(0) == rna.getHash() );
+	}
+
 }
@@ -0,0 +1,62 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/SeedKmerIndex.h"
+
+#include <algorithm>
+
+using namespace IntaRNA;
+
+TEST_CASE( "SeedKmerIndex", "[SeedKmerIndex]" ) {
+
+	// setup easylogging++ stuff if not already done
+	#include "testEasyLoggingSetup.icc"
+
+	RnaSequence rna1("test1","GGACUUAGCNAUCCGUAAGCUGAGGACUUAGCNAUCCGU");
+	RnaSequence rna2("test2","UCAGCUUACGGNAUGCUAAGUCCAGUGU");
+
+	SECTION("k sanity") {
+		REQUIRE_THROWS( SeedKmerIndex( rna1, 0 ) );
+		REQUIRE_THROWS( SeedKmerIndex( rna1, SeedKmerIndex::maxK+1 ) );
+		SeedKmerIndex index( rna1, 3 );
+		REQUIRE( index.getK() == 3 );
+		REQUIRE( &(index.getSequence()) == &rna1 );
+	}
+
+	SECTION("sequence shorter than k") {
+		RnaSequence rnaShort("short","GGA");
+		SeedKmerIndex index( rnaShort, 4 );
+		std::vector<size_t> pos;
+		index.getComplementaryPositions( rna2, 0, pos );
+		REQUIRE( pos.empty() );
+	}
+
+	for (size_t k=1; k<=5; k++) {
+
+		SeedKmerIndex index( rna1, k );
+
+		bool allEqual = true;
+		for (size_t i2=0; i2<rna2.size(); i2++) {
+			std::vector<size_t> pos;
+			index.getComplementaryPositions( rna2, i2, pos );
+			std::sort( pos.begin(), pos.end() );
+
+			// compare with direct complementarity checks
+			std::vector<size_t> expected;
+			for (size_t p=0; i2+k <= rna2.size() && p+k <= rna1.size(); p++) {
+				bool isStretch = true;
+				for (size_t t=0; isStretch && t<k; t++) {
+					isStretch = RnaSequence::areComplementary( rna1, rna2, p+t, i2+t );
+				}
+				if (isStretch) {
+					expected.push_back( p );
+				}
+			}
+			allEqual = allEqual && pos == expected;
+		}
+		REQUIRE( allEqual );
+	}
+
+}
@@ -0,0 +1,103 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/Telemetry.h"
+
+#include <sstream>
+
+using namespace IntaRNA;
+
+TEST_CASE( "Telemetry", "[Telemetry]" ) {
+
+#include "testEasyLoggingSetup.icc"
+
+	Telemetry::clear();
+
+	SECTION("disabled") {
+		Telemetry::setEnabled(false);
+		{
+			Telemetry::Timer timer( Telemetry::HYBRID, 10 );
+		}
+		std::stringstream out;
+		Telemetry::writeCsv( out );
+		REQUIRE( out.str().find("hybrid;all;0;") != std::string::npos );
+	}
+
+	SECTION("nested timers") {
+		Telemetry::setEnabled(true);
+		{
+			Telemetry::Timer timer( Telemetry::HYBRID, 10 );
+			{
+				Telemetry::Timer nested( Telemetry::SEED );
+				nested.addCells( 5 );
+			}
+			{
+				Telemetry::Timer nested( Telemetry::SEED, 2 );
+			}
+		}
+		Telemetry::setEnabled(false);
+
+		std::stringstream csv;
+		Telemetry::writeCsv( csv );
+		// header + (overall + single thread) for each stage
+		size_t lines = 0;
+		std::string line;
+		while (std::getline( csv, line )) {
+			lines++;
+		}
+		REQUIRE( lines == 1 + 2*Telemetry::STAGE_NUMBER );
+		REQUIRE( csv.str().find("hybrid;all;1;") != std::string::npos );
+		REQUIRE( csv.str().find("seed;all;2;") != std::string::npos );
+		REQUIRE( csv.str().find("seed;0;2;") != std::string::npos );
+
+		std::stringstream json;
+		Telemetry::writeJson( json );
+		REQUIRE( json.str().find("\"seed\": { \"calls\": 2,") != std::string::npos );
+		REQUIRE( json.str().find("\"cells\": 7,") != std::string::npos );
+		REQUIRE( json.str().find("\"cells\": 10,") != std::string::npos );
+		REQUIRE( json.str().find("\"threads\": [") != std::string::npos );
+		REQUIRE( json.str().find("\"peakMemoryKb\": ") != std::string::npos );
+	}
+
+	SECTION("trace") {
+		Telemetry::setTraceEnabled(true, 2);
+		{
+			Telemetry::Span span( "window", "target \"t1\"" );
+			Telemetry::Timer timer( Telemetry::HYBRID, 10 );
+		}
+		Telemetry::setTraceEnabled(false);
+		{
+			Telemetry::Span span( "window", "not recorded" );
+		}
+		std::stringstream json;
+		Telemetry::writeTrace( json );
+		REQUIRE( json.str().find("\"traceEvents\": [") != std::string::npos );
+		REQUIRE( json.str().find("\"name\": \"hybrid\", \"cat\": \"stage\", \"ph\": \"X\"") != std::string::npos );
+		REQUIRE( json.str().find("\"label\": \"target \\\"t1\\\"\"") != std::string::npos );
+		REQUIRE( json.str().find("not recorded") == std::string::npos );
+		REQUIRE( json.str().find("\"droppedEvents\": 0") != std::string::npos );
+
+		// ring buffer keeps the latest events only
+		Telemetry::setTraceEnabled(true, 2);
+		for (int i=0; i<3; i++) {
+			Telemetry::Span span( "window", toString(i) );
+		}
+		Telemetry::setTraceEnabled(false);
+		std::stringstream json2;
+		Telemetry::writeTrace( json2 );
+		REQUIRE( json2.str().find("\"label\": \"0\"") == std::string::npos );
+		REQUIRE( json2.str().find("\"label\": \"2\"") != std::string::npos );
+		REQUIRE( json2.str().find("\"droppedEvents\": 1") != std::string::npos );
+	}
+
+	SECTION("stage names") {
+		REQUIRE( Telemetry::getStageName( Telemetry::ACCESSIBILITY ) == "accessibility" );
+		REQUIRE( Telemetry::getStageName( Telemetry::OUTPUT ) == "output" );
+		REQUIRE_THROWS( Telemetry::getStageName( Telemetry::STAGE_NUMBER ) );
+	}
+
+	Telemetry::setEnabled(false);
+	Telemetry::clear();
+}
@@ -0,0 +1,60 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/VrnaHandler.h"
+
+#include <cstring>
+
+#include <boost/filesystem.hpp>
+
+using namespace IntaRNA;
+
+TEST_CASE( "VrnaHandler", "[VrnaHandler]" ) {
+
+	SECTION("shared parameters") {
+
+		VrnaHandler vrnaHandler;
+
+		// same setup -> same parameter set
+		REQUIRE( vrnaHandler.getParams().get() == vrnaHandler.getParams().get() );
+		REQUIRE( vrnaHandler.getParams(10,20).get() == vrnaHandler.getParams(10,20).get() );
+		REQUIRE( vrnaHandler.getExpParams(10,20,1.5).get() == vrnaHandler.getExpParams(10,20,1.5).get() );
+
+		// different setup -> different parameter set
+		REQUIRE( vrnaHandler.getParams().get() != vrnaHandler.getParams(10,20).get() );
+		REQUIRE( vrnaHandler.getExpParams(10,20,1.5).get() != vrnaHandler.getExpParams(10,20,1.0).get() );
+
+		// model details are set
+		REQUIRE( vrnaHandler.getParams(10,20)->model_details.max_bp_span == 10 );
+		REQUIRE( vrnaHandler.getParams(10,20)->model_details.window_size == 20 );
+		REQUIRE( vrnaHandler.getParams()->model_details.temperature == vrnaHandler.getTemperature() );
+	}
+
+	SECTION("parameter cache") {
+
+		const std::string cacheDir = "VrnaHandler_test.cache";
+		boost::filesystem::remove_all( cacheDir );
+		boost::filesystem::create_directories( cacheDir );
+
+		// first handler generates and stores the parameter sets
+		VrnaHandler vrnaStore( 37.0, NULL, &cacheDir );
+		REQUIRE( vrnaStore.getParamCacheDir() == cacheDir );
+		std::shared_ptr<vrna_param_t> params = vrnaStore.getParams(10,20);
+		std::shared_ptr<vrna_exp_param_t> expParams = vrnaStore.getExpParams(10,20,1.5);
+
+		// second handler reads the identical sets
+		VrnaHandler vrnaRead( 37.0, NULL, &cacheDir );
+		REQUIRE( vrnaRead.getParams(10,20).get() != params.get() );
+		REQUIRE( std::memcmp( vrnaRead.getParams(10,20).get(), params.get(), sizeof(vrna_param_t) ) == 0 );
+		REQUIRE( std::memcmp( vrnaRead.getExpParams(10,20,1.5).get(), expParams.get(), sizeof(vrna_exp_param_t) ) == 0 );
+
+		// different setup is not read from the cache
+		VrnaHandler vrnaOther( 20.0, NULL, &cacheDir );
+		REQUIRE( vrnaOther.getParams(10,20)->model_details.temperature == 20.0 );
+
+		boost::filesystem::remove_all( cacheDir );
+	}
+
+}
@@ -0,0 +1,43 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/WorkCounters.h"
+
+#include <sstream>
+
+using namespace IntaRNA;
+
+TEST_CASE( "WorkCounters", "[WorkCounters]" ) {
+
+	// setup easylogging++ stuff if not already done
+	#include "testEasyLoggingSetup.icc"
+
+	WorkCounters work;
+
+	SECTION("construction") {
+		REQUIRE( work.empty() );
+	}
+
+	SECTION("add and clear") {
+		WorkCounters other;
+		other.complementaryCells = 4;
+		other.filledCells = 3;
+		other.loopEvaluations = 2;
+		other.optimaUpdates = 1;
+		work.add( other );
+		work.add( other );
+		REQUIRE_FALSE( work.empty() );
+		REQUIRE( work.complementaryCells == 8 );
+		REQUIRE( work.filledCells == 6 );
+		REQUIRE( work.loopEvaluations == 4 );
+		REQUIRE( work.optimaUpdates == 2 );
+		std::stringstream out;
+		out <<work;
+		REQUIRE( out.str() == "complementaryCells=8 filledCells=6 loopEvaluations=4 optimaUpdates=2" );
+		work.clear();
+		REQUIRE( work.empty() );
+	}
+
+}
@@ -0,0 +1,40 @@
+#!/bin/sh
+
+# tests the processing of several prediction requests in server mode (--server)
+# via the IntaRNA binary given by INTARNA_BIN
+
+INTARNA_BIN=${INTARNA_BIN:-../src/bin/IntaRNA}
+
+# three requests, the third reuses the cached query accessibility of the first
+OUT=`printf 'GGGAGGGGAAACC CCCCACCCUUUGG\nGGGAGGAAGG CCUUCCUCCC\n# comment\nGGGAGGGGAAACC CCCCACCCUUUGG\n' \
+	| $INTARNA_BIN --server --energy=B --qAcc=N --tAcc=N --noSeed --outMode=C --outCsvCols=start1,end1,start2,end2,E`
+if [ $? -ne 0 ]; then
+	echo "server mode : IntaRNA failed"
+	exit 1
+fi
+
+# each request is finalized
+if [ `echo "$OUT" | grep -c '^#END'` -ne 3 ]; then
+	echo "server mode : expected 3 processed requests but got"
+	echo "$OUT"
+	exit 1
+fi
+
+# no request failed
+if echo "$OUT" | grep -q '^#ERROR'; then
+	echo "server mode : unexpected request error"
+	echo "$OUT"
+	exit 1
+fi
+
+# identical requests give identical results
+RESULTS=`echo "$OUT" | grep -v '^#' | grep -v '^start1;'`
+if [ `echo "$RESULTS" | wc -l` -ne 3 ] \
+	|| [ "`echo "$RESULTS" | sed -n 1p`" != "`echo "$RESULTS" | sed -n 3p`" ] \
+	|| [ "`echo "$RESULTS" | sed -n 1p`" = "`echo "$RESULTS" | sed -n 2p`" ]; then
+	echo "server mode : unexpected results"
+	echo "$OUT"
+	exit 1
+fi
+
+exit 0